@@ -0,0 +1,428 @@
+#include "OrderLifecycleManager.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pinnacle {
+namespace execution {
+
+namespace {
+
+// Tolerance for treating a cumulative fill as complete
+constexpr double FILL_EPSILON = 1e-9;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Holds a slot's spinlock for the guard's lifetime
+ */
+class OrderLifecycleManager::SlotGuard {
+public:
+  explicit SlotGuard(Slot& slot) : m_slot(slot) {
+    while (m_slot.locked.exchange(true, std::memory_order_acquire)) {
+      while (m_slot.locked.load(std::memory_order_relaxed)) {
+        cpuRelax();
+      }
+    }
+  }
+
+  ~SlotGuard() { m_slot.locked.store(false, std::memory_order_release); }
+
+  SlotGuard(const SlotGuard&) = delete;
+  SlotGuard& operator=(const SlotGuard&) = delete;
+
+private:
+  Slot& m_slot;
+};
+
+OrderLifecycleManager::OrderLifecycleManager(size_t capacity)
+    : m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2))),
+      m_mask(m_capacity - 1), m_slots(new Slot[m_capacity]),
+      m_venueStats(new VenueStats[MAX_LIFECYCLE_VENUES]) {}
+
+OrderLifecycleManager& OrderLifecycleManager::getInstance() {
+  static OrderLifecycleManager instance;
+  return instance;
+}
+
+VenueId OrderLifecycleManager::registerVenue(const std::string& name) {
+  std::lock_guard<std::mutex> lock(m_venueMutex);
+
+  size_t count = m_venueCount.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    if (m_venueNames[i] == name) {
+      return static_cast<VenueId>(i);
+    }
+  }
+
+  if (count == MAX_LIFECYCLE_VENUES) {
+    return static_cast<VenueId>(MAX_LIFECYCLE_VENUES - 1);
+  }
+
+  m_venueNames[count] = name;
+  m_venueCount.store(count + 1, std::memory_order_release);
+  return static_cast<VenueId>(count);
+}
+
+// ============================================================================
+// Table
+// ============================================================================
+
+OrderHandle OrderLifecycleManager::onNew(VenueId venue, OrderSide side,
+                                         double price, double quantity,
+                                         uint64_t timestamp) {
+  OrderHandle handle = m_nextHandle.fetch_add(1, std::memory_order_relaxed);
+
+  // Handles are sequential, so the home slot only collides once the table
+  // has wrapped; the probe then reclaims the first closed record it finds
+  for (size_t distance = 0; distance < m_capacity; ++distance) {
+    Slot& slot = m_slots[(handle + distance) & m_mask];
+    SlotGuard guard(slot);
+
+    if (slot.key.load(std::memory_order_relaxed) != INVALID_ORDER_HANDLE &&
+        slot.record.isOpen()) {
+      continue;
+    }
+
+    OrderRecord& record = slot.record;
+    record = OrderRecord{};
+    record.handle = handle;
+    record.venue = std::min<VenueId>(venue, MAX_LIFECYCLE_VENUES - 1);
+    record.side = side;
+    record.price = price;
+    record.quantity = quantity;
+    record.createdAt = timestamp;
+    slot.key.store(handle, std::memory_order_release);
+
+    size_t maxProbe = m_maxProbe.load(std::memory_order_relaxed);
+    while (distance > maxProbe &&
+           !m_maxProbe.compare_exchange_weak(maxProbe, distance,
+                                             std::memory_order_relaxed)) {
+    }
+
+    m_openOrders.fetch_add(1, std::memory_order_relaxed);
+    return handle;
+  }
+
+  return INVALID_ORDER_HANDLE;
+}
+
+OrderLifecycleManager::Slot*
+OrderLifecycleManager::find(OrderHandle handle) const {
+  if (handle == INVALID_ORDER_HANDLE) {
+    return nullptr;
+  }
+
+  size_t maxProbe = m_maxProbe.load(std::memory_order_relaxed);
+  for (size_t distance = 0; distance <= maxProbe; ++distance) {
+    Slot& slot = m_slots[(handle + distance) & m_mask];
+    OrderHandle key = slot.key.load(std::memory_order_acquire);
+    if (key == handle) {
+      return &slot;
+    }
+    if (key == INVALID_ORDER_HANDLE) {
+      return nullptr; // Slots are never emptied, so the chain ends here
+    }
+  }
+  return nullptr;
+}
+
+template <typename Fn>
+bool OrderLifecycleManager::transition(OrderHandle handle, Fn&& fn,
+                                       OrderRecord* after) {
+  Slot* slot = find(handle);
+  if (!slot) {
+    return false;
+  }
+
+  SlotGuard guard(*slot);
+  // The slot may have been reclaimed between the probe and the lock
+  if (slot->key.load(std::memory_order_relaxed) != handle) {
+    return false;
+  }
+
+  bool applied = fn(slot->record);
+  if (after) {
+    *after = slot->record;
+  }
+  return applied;
+}
+
+// ============================================================================
+// Transitions
+// ============================================================================
+
+void OrderLifecycleManager::close(OrderRecord& record, OrderState state,
+                                  uint64_t timestamp) {
+  record.state = state;
+  record.closedAt = timestamp;
+  m_openOrders.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void OrderLifecycleManager::recordAck(OrderRecord& record,
+                                      uint64_t timestamp) {
+  record.ackedAt = timestamp;
+  m_venueStats[record.venue].ack.record(
+      timestamp > record.createdAt ? timestamp - record.createdAt : 0);
+}
+
+void OrderLifecycleManager::recordFill(OrderRecord& record, double quantity,
+                                       double price, uint64_t timestamp) {
+  if (record.ackedAt == 0) {
+    recordAck(record, timestamp);
+  }
+  if (record.state == OrderState::PENDING_NEW) {
+    record.state = OrderState::LIVE;
+  }
+
+  if (record.firstFillAt == 0) {
+    record.firstFillAt = timestamp;
+    m_venueStats[record.venue].fill.record(
+        timestamp > record.createdAt ? timestamp - record.createdAt : 0);
+  }
+
+  double filled = record.filledQuantity + quantity;
+  record.avgFillPrice =
+      (record.avgFillPrice * record.filledQuantity + price * quantity) /
+      filled;
+  record.filledQuantity = filled;
+  record.lastFillQuantity = quantity;
+  record.lastFillAt = timestamp;
+
+  if (filled + FILL_EPSILON >= record.quantity) {
+    close(record, OrderState::FILLED, timestamp);
+  }
+}
+
+bool OrderLifecycleManager::onAck(OrderHandle handle, uint64_t timestamp) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (record.ackedAt != 0 || !record.isOpen()) {
+      return false;
+    }
+    recordAck(record, timestamp);
+    // A cancel sent before the ack stays pending
+    if (record.state == OrderState::PENDING_NEW) {
+      record.state = OrderState::LIVE;
+    }
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::onReject(OrderHandle handle, uint64_t timestamp) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (record.state != OrderState::PENDING_NEW) {
+      return false;
+    }
+    close(record, OrderState::REJECTED, timestamp);
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::onFill(OrderHandle handle, double quantity,
+                                   double price, uint64_t timestamp) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (!record.isOpen() || quantity <= 0.0) {
+      return false;
+    }
+    recordFill(record, quantity, price, timestamp);
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::onCancelRequest(OrderHandle handle,
+                                            uint64_t timestamp) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (record.state != OrderState::PENDING_NEW &&
+        record.state != OrderState::LIVE) {
+      return false;
+    }
+    record.state = OrderState::PENDING_CANCEL;
+    record.cancelRequestedAt = timestamp;
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::onCanceled(OrderHandle handle,
+                                       uint64_t timestamp) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (!record.isOpen()) {
+      return false;
+    }
+    close(record, OrderState::CANCELED, timestamp);
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::onCancelRejected(OrderHandle handle,
+                                             uint64_t) {
+  return transition(handle, [&](OrderRecord& record) {
+    if (record.state != OrderState::PENDING_CANCEL) {
+      return false;
+    }
+    record.state =
+        record.ackedAt != 0 ? OrderState::LIVE : OrderState::PENDING_NEW;
+    return true;
+  });
+}
+
+bool OrderLifecycleManager::applyStatus(OrderHandle handle,
+                                        OrderStatus status,
+                                        double cumulativeFilled,
+                                        uint64_t timestamp,
+                                        OrderRecord* after) {
+  return transition(
+      handle,
+      [&](OrderRecord& record) {
+        record.lastFillQuantity = 0.0;
+        if (!record.isOpen()) {
+          return false;
+        }
+
+        double delta = cumulativeFilled - record.filledQuantity;
+        if (delta > FILL_EPSILON) {
+          recordFill(record, delta, record.price, timestamp);
+        }
+        if (!record.isOpen()) {
+          return true; // Fully filled by this report
+        }
+
+        switch (status) {
+        case OrderStatus::NEW:
+          if (record.ackedAt == 0) {
+            recordAck(record, timestamp);
+          }
+          if (record.state == OrderState::PENDING_NEW) {
+            record.state = OrderState::LIVE;
+          }
+          break;
+        case OrderStatus::PARTIALLY_FILLED:
+          break;
+        case OrderStatus::FILLED:
+          close(record, OrderState::FILLED, timestamp);
+          break;
+        case OrderStatus::CANCELED:
+        case OrderStatus::EXPIRED:
+          close(record, OrderState::CANCELED, timestamp);
+          break;
+        case OrderStatus::REJECTED:
+          // As for onReject(), only before the acknowledgement
+          if (record.state != OrderState::PENDING_NEW) {
+            return false;
+          }
+          close(record, OrderState::REJECTED, timestamp);
+          break;
+        }
+        return true;
+      },
+      after);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool OrderLifecycleManager::get(OrderHandle handle, OrderRecord& out) const {
+  return const_cast<OrderLifecycleManager*>(this)->transition(
+      handle, [](OrderRecord&) { return true; }, &out);
+}
+
+std::vector<OrderHandle> OrderLifecycleManager::openOrders() const {
+  std::vector<OrderHandle> handles;
+  handles.reserve(openOrderCount());
+
+  for (size_t i = 0; i < m_capacity; ++i) {
+    Slot& slot = m_slots[i];
+    if (slot.key.load(std::memory_order_acquire) == INVALID_ORDER_HANDLE) {
+      continue;
+    }
+    SlotGuard guard(slot);
+    if (slot.record.isOpen()) {
+      handles.push_back(slot.record.handle);
+    }
+  }
+
+  std::sort(handles.begin(), handles.end());
+  return handles;
+}
+
+const utils::LatencyHistogram&
+OrderLifecycleManager::ackLatency(VenueId venue) const {
+  return m_venueStats[std::min<size_t>(venue, MAX_LIFECYCLE_VENUES - 1)].ack;
+}
+
+const utils::LatencyHistogram&
+OrderLifecycleManager::fillLatency(VenueId venue) const {
+  return m_venueStats[std::min<size_t>(venue, MAX_LIFECYCLE_VENUES - 1)].fill;
+}
+
+std::vector<VenueLatencyReport>
+OrderLifecycleManager::getLatencyReport() const {
+  std::lock_guard<std::mutex> lock(m_venueMutex);
+
+  size_t count = m_venueCount.load(std::memory_order_relaxed);
+  std::vector<VenueLatencyReport> report(count);
+  for (size_t i = 0; i < count; ++i) {
+    const VenueStats& stats = m_venueStats[i];
+    VenueLatencyReport& entry = report[i];
+    entry.venue = m_venueNames[i];
+    entry.ackCount = stats.ack.count();
+    entry.ackP50 = stats.ack.percentile(0.5);
+    entry.ackP99 = stats.ack.percentile(0.99);
+    entry.ackMax = stats.ack.max();
+    entry.fillCount = stats.fill.count();
+    entry.fillP50 = stats.fill.percentile(0.5);
+    entry.fillP99 = stats.fill.percentile(0.99);
+    entry.fillMax = stats.fill.max();
+  }
+  return report;
+}
+
+void OrderLifecycleManager::reset() {
+  for (size_t i = 0; i < m_capacity; ++i) {
+    Slot& slot = m_slots[i];
+    SlotGuard guard(slot);
+    slot.key.store(INVALID_ORDER_HANDLE, std::memory_order_relaxed);
+    slot.record = OrderRecord{};
+  }
+  m_openOrders.store(0, std::memory_order_relaxed);
+  m_maxProbe.store(0, std::memory_order_relaxed);
+
+  for (size_t i = 0; i < MAX_LIFECYCLE_VENUES; ++i) {
+    m_venueStats[i].ack.reset();
+    m_venueStats[i].fill.reset();
+  }
+}
+
+const char* orderStateToString(OrderState state) {
+  switch (state) {
+  case OrderState::PENDING_NEW:
+    return "PENDING_NEW";
+  case OrderState::LIVE:
+    return "LIVE";
+  case OrderState::PENDING_CANCEL:
+    return "PENDING_CANCEL";
+  case OrderState::FILLED:
+    return "FILLED";
+  case OrderState::CANCELED:
+    return "CANCELED";
+  case OrderState::REJECTED:
+    return "REJECTED";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+} // namespace execution
+} // namespace pinnacle
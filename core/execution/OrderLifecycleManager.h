@@ -0,0 +1,242 @@
+#pragma once
+
+#include "../orderbook/Order.h"
+#include "../utils/LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pinnacle {
+namespace execution {
+
+/**
+ * @brief Integer handle identifying an order for its whole lifetime
+ *
+ * Handles are allocated sequentially by the manager and are never reused.
+ */
+using OrderHandle = uint64_t;
+
+constexpr OrderHandle INVALID_ORDER_HANDLE = 0;
+
+/**
+ * @brief Venue identifier assigned by OrderLifecycleManager::registerVenue
+ */
+using VenueId = uint16_t;
+
+constexpr size_t MAX_LIFECYCLE_VENUES = 32;
+
+/**
+ * @brief Lifecycle states
+ *
+ * PENDING_NEW -> LIVE -> PENDING_CANCEL -> CANCELED, with FILLED reachable
+ * from any open state and REJECTED only before the order is acknowledged.
+ * A rejected cancel returns the order to the state it was in before.
+ */
+enum class OrderState : uint8_t {
+  PENDING_NEW,
+  LIVE,
+  PENDING_CANCEL,
+  FILLED,
+  CANCELED,
+  REJECTED
+};
+
+/**
+ * @brief Compact per-order record
+ *
+ * Timestamps are TimeUtils::getCurrentNanos() values, 0 until the
+ * corresponding transition happens.
+ */
+struct OrderRecord {
+  OrderHandle handle{INVALID_ORDER_HANDLE};
+  VenueId venue{0};
+  OrderSide side{OrderSide::BUY};
+  OrderState state{OrderState::PENDING_NEW};
+  double price{0.0};
+  double quantity{0.0};
+  double filledQuantity{0.0};
+  double avgFillPrice{0.0};
+  double lastFillQuantity{0.0}; // Size of the most recent fill
+  uint64_t createdAt{0};
+  uint64_t ackedAt{0};
+  uint64_t firstFillAt{0};
+  uint64_t lastFillAt{0};
+  uint64_t cancelRequestedAt{0};
+  uint64_t closedAt{0};
+
+  bool isOpen() const {
+    return state == OrderState::PENDING_NEW || state == OrderState::LIVE ||
+           state == OrderState::PENDING_CANCEL;
+  }
+};
+
+/**
+ * @brief Latency summary for one venue, in nanoseconds
+ */
+struct VenueLatencyReport {
+  std::string venue;
+  uint64_t ackCount{0};
+  uint64_t ackP50{0};
+  uint64_t ackP99{0};
+  uint64_t ackMax{0};
+  uint64_t fillCount{0};
+  uint64_t fillP50{0};
+  uint64_t fillP99{0};
+  uint64_t fillMax{0};
+};
+
+/**
+ * @class OrderLifecycleManager
+ * @brief Shared order state machine for strategies, the router and risk
+ *
+ * Records live in a fixed-capacity open-addressing table indexed by
+ * handle, so lookups and transitions never allocate. Each slot carries its
+ * own spinlock; transitions on different orders never contend. Slots of
+ * closed orders are reclaimed by later inserts, so a closed record stays
+ * queryable until the table wraps around to it.
+ *
+ * Every acknowledgement and first fill records its latency from order
+ * creation into the owning venue's histograms.
+ */
+class OrderLifecycleManager {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+  /**
+   * @param capacity Rounded up to a power of two
+   */
+  explicit OrderLifecycleManager(size_t capacity = DEFAULT_CAPACITY);
+
+  OrderLifecycleManager(const OrderLifecycleManager&) = delete;
+  OrderLifecycleManager& operator=(const OrderLifecycleManager&) = delete;
+
+  /**
+   * @brief Process-wide instance
+   */
+  static OrderLifecycleManager& getInstance();
+
+  /**
+   * @brief Register a venue for latency tracking
+   *
+   * @return Existing id if already registered; ids past
+   * MAX_LIFECYCLE_VENUES share the last slot
+   */
+  VenueId registerVenue(const std::string& name);
+
+  /**
+   * @brief Track a new order in PENDING_NEW
+   *
+   * @return INVALID_ORDER_HANDLE if every slot holds an open order
+   */
+  OrderHandle onNew(VenueId venue, OrderSide side, double price,
+                    double quantity, uint64_t timestamp);
+
+  bool onAck(OrderHandle handle, uint64_t timestamp);
+  bool onReject(OrderHandle handle, uint64_t timestamp);
+
+  /**
+   * @brief Apply an incremental fill
+   *
+   * An unacknowledged order is implicitly acknowledged. The order moves to
+   * FILLED once the filled quantity reaches the order quantity.
+   */
+  bool onFill(OrderHandle handle, double quantity, double price,
+              uint64_t timestamp);
+
+  bool onCancelRequest(OrderHandle handle, uint64_t timestamp);
+  bool onCanceled(OrderHandle handle, uint64_t timestamp);
+  bool onCancelRejected(OrderHandle handle, uint64_t timestamp);
+
+  /**
+   * @brief Apply an exchange status report carrying a cumulative fill
+   *
+   * Any increase in cumulativeFilled is applied as a fill at the order's
+   * limit price before the status itself.
+   *
+   * @param after Receives the record after the update, if not null
+   * @return false if the handle is unknown or the report is not a valid
+   * transition from the current state
+   */
+  bool applyStatus(OrderHandle handle, OrderStatus status,
+                   double cumulativeFilled, uint64_t timestamp,
+                   OrderRecord* after = nullptr);
+
+  /**
+   * @brief Copy an order's record
+   *
+   * @return false if the handle is unknown or its slot has been reclaimed
+   */
+  bool get(OrderHandle handle, OrderRecord& out) const;
+
+  /**
+   * @brief Handles of all open orders
+   */
+  std::vector<OrderHandle> openOrders() const;
+
+  size_t openOrderCount() const {
+    return m_openOrders.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return m_capacity; }
+
+  const utils::LatencyHistogram& ackLatency(VenueId venue) const;
+  const utils::LatencyHistogram& fillLatency(VenueId venue) const;
+
+  std::vector<VenueLatencyReport> getLatencyReport() const;
+
+  /**
+   * @brief Drop all records and latency samples; venues stay registered
+   */
+  void reset();
+
+private:
+  struct alignas(64) Slot {
+    std::atomic<bool> locked{false};
+    std::atomic<OrderHandle> key{INVALID_ORDER_HANDLE};
+    OrderRecord record;
+  };
+
+  struct VenueStats {
+    utils::LatencyHistogram ack;
+    utils::LatencyHistogram fill;
+  };
+
+  class SlotGuard;
+
+  Slot* find(OrderHandle handle) const;
+
+  template <typename Fn>
+  bool transition(OrderHandle handle, Fn&& fn, OrderRecord* after = nullptr);
+
+  void close(OrderRecord& record, OrderState state, uint64_t timestamp);
+  void recordFill(OrderRecord& record, double quantity, double price,
+                  uint64_t timestamp);
+  void recordAck(OrderRecord& record, uint64_t timestamp);
+
+  size_t m_capacity;
+  size_t m_mask;
+  std::unique_ptr<Slot[]> m_slots;
+
+  std::atomic<OrderHandle> m_nextHandle{1};
+  std::atomic<size_t> m_openOrders{0};
+  std::atomic<size_t> m_maxProbe{0};
+
+  std::array<std::string, MAX_LIFECYCLE_VENUES> m_venueNames;
+  std::atomic<size_t> m_venueCount{0};
+  mutable std::mutex m_venueMutex;
+  std::unique_ptr<VenueStats[]> m_venueStats;
+};
+
+/**
+ * @brief Human-readable state name
+ */
+const char* orderStateToString(OrderState state);
+
+} // namespace execution
+} // namespace pinnacle
@@ -84,6 +84,11 @@ public:
   double getSpread() const;
   size_t getOrderCount() const;
 
+  // Number of changes so far, to tell whether the book moved since a query
+  uint64_t getUpdateCount() const {
+    return m_updateCount.load(std::memory_order_relaxed);
+  }
+
   // Level queries
   size_t getBidLevels() const;
   size_t getAskLevels() const;
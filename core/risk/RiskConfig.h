@@ -34,6 +34,7 @@ struct RiskLimits {
 
   // Rate limiting
   uint32_t maxOrdersPerSecond{100};
+  uint32_t maxOpenOrders{0}; // 0 = unlimited
 };
 
 /**
@@ -142,6 +143,8 @@ struct RiskConfig {
             lim.value("max_daily_volume", config.limits.maxDailyVolume);
         config.limits.maxOrdersPerSecond = lim.value(
             "max_orders_per_second", config.limits.maxOrdersPerSecond);
+        config.limits.maxOpenOrders =
+            lim.value("max_open_orders", config.limits.maxOpenOrders);
       }
 
       if (rm.contains("circuit_breaker")) {
@@ -237,7 +240,8 @@ struct RiskConfig {
             {"max_order_size", limits.maxOrderSize},
             {"max_order_value", limits.maxOrderValue},
             {"max_daily_volume", limits.maxDailyVolume},
-            {"max_orders_per_second", limits.maxOrdersPerSecond}}},
+            {"max_orders_per_second", limits.maxOrdersPerSecond},
+            {"max_open_orders", limits.maxOpenOrders}}},
           {"circuit_breaker",
            {{"price_move_1min_pct", circuitBreaker.priceMove1minPct},
             {"price_move_5min_pct", circuitBreaker.priceMove5minPct},
@@ -1,4 +1,5 @@
 #include "RiskManager.h"
+#include "../execution/OrderLifecycleManager.h"
 #include "../utils/AuditLogger.h"
 
 #include <cmath>
@@ -114,7 +115,16 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_RATE_LIMIT;
   }
 
-  // 3. Order size / value check
+  // 3. Open order check against the shared lifecycle table (0 disables)
+  uint32_t maxOpenOrders = m_limits.maxOpenOrders;
+  if (maxOpenOrders > 0 &&
+      execution::OrderLifecycleManager::getInstance().openOrderCount() >=
+          maxOpenOrders) {
+    AUDIT_ORDER_ACTIVITY("system", "", "rejected_open_orders", symbol, false);
+    return RiskCheckResult::REJECTED_OPEN_ORDER_LIMIT;
+  }
+
+  // 4. Order size / value check
   double maxOrderSize = m_limits.maxOrderSize;
   double maxOrderValue = m_limits.maxOrderValue;
   if (quantity > maxOrderSize || (price * quantity) > maxOrderValue) {
@@ -122,7 +132,7 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_ORDER_SIZE_LIMIT;
   }
 
-  // 4. Position limit check (per-symbol if registered, else global)
+  // 5. Position limit check (per-symbol if registered, else global)
   double currentPos = m_position.load(std::memory_order_relaxed);
   double projectedPos = (side == OrderSide::BUY) ? (currentPos + quantity)
                                                  : (currentPos - quantity);
@@ -152,7 +162,7 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_POSITION_LIMIT;
   }
 
-  // 5. Daily volume check
+  // 6. Daily volume check
   double currentVol = m_dailyVolume.load(std::memory_order_relaxed);
   double maxDailyVol = m_limits.maxDailyVolume;
   if ((currentVol + quantity) > maxDailyVol) {
@@ -160,7 +170,7 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_VOLUME_LIMIT;
   }
 
-  // 6. Daily loss limit check
+  // 7. Daily loss limit check
   double dailyPnL = m_dailyPnL.load(std::memory_order_relaxed);
   double dailyLossLimit = m_limits.dailyLossLimit;
   if (dailyPnL < 0.0 && std::abs(dailyPnL) >= dailyLossLimit) {
@@ -168,7 +178,7 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_DAILY_LOSS_LIMIT;
   }
 
-  // 7. Drawdown check
+  // 8. Drawdown check
   double peakPnL = m_peakPnL.load(std::memory_order_relaxed);
   double totalPnL = m_totalPnL.load(std::memory_order_relaxed);
   double drawdownPct = 0.0;
@@ -181,7 +191,7 @@ RiskCheckResult RiskManager::checkOrder(OrderSide side, double price,
     return RiskCheckResult::REJECTED_DRAWDOWN_LIMIT;
   }
 
-  // 8. Exposure check
+  // 9. Exposure check
   double notional = price * quantity;
   double gross = m_grossExposure.load(std::memory_order_relaxed);
   double net = m_netExposure.load(std::memory_order_relaxed);
@@ -696,6 +706,8 @@ std::string RiskManager::resultToString(RiskCheckResult result) {
     return "REJECTED_VOLUME_LIMIT";
   case RiskCheckResult::REJECTED_HALTED:
     return "REJECTED_HALTED";
+  case RiskCheckResult::REJECTED_OPEN_ORDER_LIMIT:
+    return "REJECTED_OPEN_ORDER_LIMIT";
   default:
     return "UNKNOWN";
   }
@@ -31,7 +31,8 @@ enum class RiskCheckResult {
   REJECTED_RATE_LIMIT,
   REJECTED_CIRCUIT_BREAKER,
   REJECTED_VOLUME_LIMIT,
-  REJECTED_HALTED
+  REJECTED_HALTED,
+  REJECTED_OPEN_ORDER_LIMIT
 };
 
 /**
@@ -0,0 +1,133 @@
+#include "DepthSplitter.h"
+
+#include <algorithm>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+namespace {
+
+/**
+ * @brief Position in one venue's ladder; key is the effective unit cost
+ * (negated proceeds for sells) so the heap is always a min-heap
+ */
+struct Cursor {
+  double key;
+  uint32_t venue;
+  uint32_t level;
+};
+
+struct Ladder {
+  const double* price{nullptr};
+  const double* size{nullptr};
+  size_t levels{0};
+};
+
+inline bool heapAfter(const Cursor& a, const Cursor& b) {
+  // std heap algorithms build a max-heap; invert for cheapest-first, with
+  // the lower venue row winning ties so results are deterministic
+  return a.key > b.key || (a.key == b.key && a.venue > b.venue);
+}
+
+} // namespace
+
+DepthSplit splitByDepth(pinnacle::OrderSide side, double quantity,
+                        const VenueQuoteView& quotes,
+                        const DepthCostModel& model) {
+  DepthSplit split;
+  split.venues = std::min(quotes.size(), MAX_ROUTING_VENUES);
+
+  bool isBuy = side == pinnacle::OrderSide::BUY;
+  size_t maxLevels = std::min(model.maxLevels, MAX_DEPTH_LEVELS);
+
+  std::array<Ladder, MAX_ROUTING_VENUES> ladders;
+  std::array<double, MAX_ROUTING_VENUES> costFactor;
+  std::array<Cursor, MAX_ROUTING_VENUES> heap;
+  size_t heapSize = 0;
+
+  auto crossesLimit = [&](double price) {
+    return model.limitPrice > 0.0 &&
+           (isBuy ? price > model.limitPrice : price < model.limitPrice);
+  };
+
+  // Advance a cursor to the next usable level; false once the venue is
+  // exhausted or its remaining levels are all beyond the limit
+  auto seek = [&](Cursor& cursor) {
+    const Ladder& ladder = ladders[cursor.venue];
+    for (; cursor.level < ladder.levels; ++cursor.level) {
+      double price = ladder.price[cursor.level];
+      if (price <= 0.0 || ladder.size[cursor.level] <= 0.0) {
+        continue;
+      }
+      if (crossesLimit(price)) {
+        return false; // Deeper levels are only worse
+      }
+      double effective = price * costFactor[cursor.venue];
+      cursor.key = isBuy ? effective : -effective;
+      return true;
+    }
+    return false;
+  };
+
+  for (size_t v = 0; v < split.venues; ++v) {
+    Ladder& ladder = ladders[v];
+    const DepthLadder* depth = nullptr;
+    if (quotes.depth) {
+      depth = isBuy ? &quotes.depth->asks[v] : &quotes.depth->bids[v];
+    }
+
+    if (depth && depth->levels > 0) {
+      ladder.price = depth->price.data();
+      ladder.size = depth->size.data();
+      ladder.levels = std::min(depth->levels, maxLevels);
+    } else {
+      // No book for this venue: its top of book is a one-level ladder
+      ladder.price = isBuy ? &quotes.askPrice[v] : &quotes.bidPrice[v];
+      ladder.size = isBuy ? &quotes.askSize[v] : &quotes.bidSize[v];
+      ladder.levels = 1;
+    }
+
+    double penalty =
+        quotes.fees[v] + model.latencyPenaltyPerMicro * quotes.delayMicros(v);
+    costFactor[v] = isBuy ? 1.0 + penalty : 1.0 - penalty;
+
+    Cursor cursor{0.0, static_cast<uint32_t>(v), 0};
+    if (seek(cursor)) {
+      heap[heapSize++] = cursor;
+    }
+  }
+
+  std::make_heap(heap.begin(), heap.begin() + heapSize, heapAfter);
+
+  double remaining = quantity;
+  while (remaining > 0.0 && heapSize > 0) {
+    std::pop_heap(heap.begin(), heap.begin() + heapSize, heapAfter);
+    Cursor& cursor = heap[heapSize - 1];
+    const Ladder& ladder = ladders[cursor.venue];
+
+    double take = std::min(remaining, ladder.size[cursor.level]);
+    double price = ladder.price[cursor.level];
+    size_t v = cursor.venue;
+
+    split.quantity[v] += take;
+    split.worstPrice[v] = price;
+    split.levelsUsed[v] = cursor.level + 1;
+    split.totalCost += take * price * costFactor[v];
+    split.filledQuantity += take;
+    remaining -= take;
+
+    ++cursor.level;
+    if (seek(cursor)) {
+      std::push_heap(heap.begin(), heap.begin() + heapSize, heapAfter);
+    } else {
+      --heapSize;
+    }
+  }
+
+  return split;
+}
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
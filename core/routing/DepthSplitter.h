@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../orderbook/Order.h"
+#include "VenueDepthTable.h"
+#include "VenueQuoteTable.h"
+
+#include <array>
+#include <cstddef>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+/**
+ * @brief Cost model for splitting an order across venue books
+ *
+ * A level's effective unit price is its raw price adjusted by the venue fee
+ * rate (MarketData::fees, a fraction of notional) and by a latency penalty
+ * of latencyPenaltyPerMicro per microsecond of VenueQuoteView::delayMicros
+ * (order latency plus quote staleness), standing in for the adverse move
+ * expected before the order reaches the book it was priced against.
+ */
+struct DepthCostModel {
+  double latencyPenaltyPerMicro{0.0};
+  double limitPrice{0.0}; // 0 for no limit; buys never lift above it, sells
+                          // never hit below it
+  size_t maxLevels{MAX_DEPTH_LEVELS};
+};
+
+/**
+ * @brief Per-row allocation produced by splitByDepth
+ */
+struct DepthSplit {
+  size_t venues{0}; // Rows considered
+  double filledQuantity{0.0};
+  double totalCost{0.0}; // Effective notional (fees and penalties included)
+  std::array<double, MAX_ROUTING_VENUES> quantity{};
+  std::array<double, MAX_ROUTING_VENUES> worstPrice{}; // Raw limit to sweep
+  std::array<size_t, MAX_ROUTING_VENUES> levelsUsed{};
+};
+
+/**
+ * @brief Cost-minimizing allocation of an order across venue L2 books
+ *
+ * Each venue's levels form a non-decreasing marginal cost curve, so taking
+ * the cheapest remaining level across all venues until the quantity is
+ * filled is optimal. The walk is a k-way merge over the level arrays with a
+ * fixed-size heap holding one cursor per venue: O(L log V) for L consumed
+ * levels across V venues, with no allocation.
+ *
+ * Venues without depth in quotes.depth fall back to a single level at their
+ * top of book.
+ */
+DepthSplit splitByDepth(pinnacle::OrderSide side, double quantity,
+                        const VenueQuoteView& quotes,
+                        const DepthCostModel& model);
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
@@ -1,4 +1,5 @@
 #include "OrderRouter.h"
+#include "QuoteRanking.h"
 
 #include <algorithm>
 #include <cmath>
@@ -11,43 +12,68 @@ namespace pinnacle {
 namespace core {
 namespace routing {
 
+namespace {
+
+// Spacing of slices released at `firstSlot` to `firstSlot + slices - 1`
+// intervals after planning, compressed so the last release still leaves an
+// interval before the parent's timeout; slices released later are dropped
+std::chrono::nanoseconds sliceSpacing(std::chrono::seconds interval,
+                                      int slices, int firstSlot,
+                                      std::chrono::seconds maxExecutionTime) {
+  std::chrono::nanoseconds spacing = interval;
+  auto lastSlot = static_cast<int64_t>(firstSlot) + slices;
+  if (lastSlot > 0 && spacing * lastSlot > maxExecutionTime) {
+    spacing = std::chrono::nanoseconds(maxExecutionTime) / lastSlot;
+  }
+  return spacing;
+}
+
+} // namespace
+
+// =============================================================================
+// RoutingStrategy Implementation
+// =============================================================================
+
+std::vector<ExecutionRequest>
+RoutingStrategy::planExecution(const ExecutionRequest& originalRequest,
+                               const std::vector<MarketData>& marketData) {
+  VenueQuoteSnapshot snapshot;
+  snapshot.assign(marketData);
+  return planExecution(originalRequest, snapshot.view());
+}
+
 // =============================================================================
 // BestPriceStrategy Implementation
 // =============================================================================
 
 std::vector<ExecutionRequest>
 BestPriceStrategy::planExecution(const ExecutionRequest& originalRequest,
-                                 const std::vector<MarketData>& marketData) {
+                                 const VenueQuoteView& quotes) {
 
-  if (marketData.empty()) {
+  if (quotes.empty()) {
     return {}; // No venues available
   }
 
-  // Find venue with best price
-  const MarketData* bestVenue = nullptr;
-  double bestPrice =
-      (originalRequest.order.getSide() == pinnacle::OrderSide::BUY)
-          ? std::numeric_limits<double>::max()
-          : 0.0;
-
-  for (const auto& venue : marketData) {
-    double price = (originalRequest.order.getSide() == pinnacle::OrderSide::BUY)
-                       ? venue.askPrice
-                       : venue.bidPrice;
-    double totalCost = price + venue.fees;
-
-    bool isBetter =
-        (originalRequest.order.getSide() == pinnacle::OrderSide::BUY)
-            ? (totalCost < bestPrice)
-            : (totalCost > bestPrice);
-
-    if (isBetter && venue.askPrice > 0 && venue.bidPrice > 0) {
-      bestPrice = totalCost;
-      bestVenue = &venue;
-    }
+  bool isBuy = originalRequest.order.getSide() == pinnacle::OrderSide::BUY;
+  std::span<const double> prices = isBuy ? quotes.askPrice : quotes.bidPrice;
+
+  // All-in price per venue, worsened in proportion to the venue's order
+  // latency and quote staleness; venues without a two-sided quote are
+  // excluded with an infinity that can never win the reduction
+  double excluded = isBuy ? std::numeric_limits<double>::infinity()
+                          : -std::numeric_limits<double>::infinity();
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> totalCost;
+  for (size_t i = 0; i < quotes.size(); ++i) {
+    bool valid = quotes.askPrice[i] > 0 && quotes.bidPrice[i] > 0;
+    double penalty = m_latencyPenaltyPerMicro * quotes.delayMicros(i);
+    double factor = isBuy ? 1.0 + penalty : 1.0 - penalty;
+    totalCost[i] = valid ? (prices[i] + quotes.fees[i]) * factor : excluded;
   }
 
-  if (!bestVenue) {
+  std::span<const double> costs(totalCost.data(), quotes.size());
+  size_t best = isBuy ? argMinVenue(costs) : argMaxVenue(costs);
+
+  if (best == NO_VENUE) {
     return {}; // No suitable venue found
   }
 
@@ -59,7 +85,7 @@ BestPriceStrategy::planExecution(const ExecutionRequest& originalRequest,
       originalRequest.order.getSide(), originalRequest.order.getType(),
       originalRequest.order.getPrice(), originalRequest.order.getQuantity(),
       originalRequest.order.getTimestamp());
-  request.targetVenue = bestVenue->venue;
+  request.targetVenue = std::string(quotes.venue[best]);
   request.maxExecutionTime = originalRequest.maxExecutionTime;
   request.maxSlippage = originalRequest.maxSlippage;
   request.allowPartialFills = originalRequest.allowPartialFills;
@@ -76,46 +102,47 @@ BestPriceStrategy::planExecution(const ExecutionRequest& originalRequest,
 
 std::vector<ExecutionRequest>
 TWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
-                            const std::vector<MarketData>& marketData) {
+                            const VenueQuoteView& quotes) {
 
   std::vector<ExecutionRequest> requests;
 
-  if (marketData.empty()) {
+  if (quotes.empty()) {
     return requests;
   }
 
-  // Find best venue for TWAP execution
-  const MarketData* bestVenue = nullptr;
-  double bestScore = -1.0;
-
-  for (const auto& venue : marketData) {
-    // Score based on liquidity and impact
-    double liquidityScore = venue.bidSize + venue.askSize;
-    double impactScore = 1.0 / (1.0 + venue.impactCost);
-    double feeScore = 1.0 / (1.0 + venue.fees);
-    double totalScore = liquidityScore * impactScore * feeScore;
-
-    if (totalScore > bestScore && venue.askPrice > 0 && venue.bidPrice > 0) {
-      bestScore = totalScore;
-      bestVenue = &venue;
-    }
+  // Score venues on liquidity, impact, fees and delay
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> scores;
+  for (size_t i = 0; i < quotes.size(); ++i) {
+    double liquidityScore = quotes.bidSize[i] + quotes.askSize[i];
+    double impactScore = 1.0 / (1.0 + quotes.impactCost[i]);
+    double feeScore = 1.0 / (1.0 + quotes.fees[i]);
+    double delayScore =
+        1.0 / (1.0 + m_latencyPenaltyPerMicro * quotes.delayMicros(i));
+    bool valid = quotes.askPrice[i] > 0 && quotes.bidPrice[i] > 0;
+    scores[i] = valid ? liquidityScore * impactScore * feeScore * delayScore
+                      : -std::numeric_limits<double>::infinity();
   }
 
-  if (!bestVenue) {
+  size_t best =
+      argMaxVenue(std::span<const double>(scores.data(), quotes.size()));
+  if (best == NO_VENUE) {
     return requests;
   }
+  std::string bestVenue(quotes.venue[best]);
 
   // Split order into time slices
   double totalQuantity = originalRequest.order.getQuantity();
   double sliceQuantity = totalQuantity / m_numSlices;
 
-  // Split order into time slices
+  auto spacing = sliceSpacing(m_sliceInterval, m_numSlices, 0,
+                              originalRequest.maxExecutionTime);
 
+  requests.reserve(m_numSlices);
   for (int i = 0; i < m_numSlices; ++i) {
     ExecutionRequest sliceRequest;
     sliceRequest.requestId =
         originalRequest.requestId + "_SLICE_" + std::to_string(i);
-    sliceRequest.targetVenue = bestVenue->venue;
+    sliceRequest.targetVenue = bestVenue;
     sliceRequest.maxExecutionTime = originalRequest.maxExecutionTime;
     sliceRequest.maxSlippage = originalRequest.maxSlippage;
     sliceRequest.allowPartialFills = originalRequest.allowPartialFills;
@@ -133,8 +160,8 @@ TWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
         originalRequest.order.getPrice(), sliceQuantity,
         utils::TimeUtils::getCurrentNanos());
 
-    // Time-based execution scheduling handled by router
-    sliceRequest.maxExecutionTime = originalRequest.maxExecutionTime;
+    // Released by the router's scheduler one interval apart
+    sliceRequest.releaseDelay = i * spacing;
 
     requests.emplace_back(std::move(sliceRequest));
   }
@@ -148,24 +175,24 @@ TWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
 
 std::vector<ExecutionRequest>
 VWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
-                            const std::vector<MarketData>& marketData) {
+                            const VenueQuoteView& quotes) {
 
   std::vector<ExecutionRequest> requests;
 
-  if (marketData.empty()) {
+  if (quotes.empty()) {
     return requests;
   }
 
   // Calculate total market volume
   double totalMarketVolume = 0.0;
-  for (const auto& venue : marketData) {
-    totalMarketVolume += venue.recentVolume;
+  for (double volume : quotes.recentVolume) {
+    totalMarketVolume += volume;
   }
 
   if (totalMarketVolume <= 0) {
     // Fallback to equal distribution
-    return TWAPStrategy(10, std::chrono::seconds(60))
-        .planExecution(originalRequest, marketData);
+    return TWAPStrategy(10, m_sliceInterval)
+        .planExecution(originalRequest, quotes);
   }
 
   double totalQuantity = originalRequest.order.getQuantity();
@@ -175,6 +202,8 @@ VWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
   if (totalQuantity > maxParticipation) {
     int numTimeSlices = std::ceil(totalQuantity / maxParticipation);
     double sliceQuantity = totalQuantity / numTimeSlices;
+    auto spacing = sliceSpacing(m_sliceInterval, numTimeSlices, 1,
+                                originalRequest.maxExecutionTime);
 
     for (int i = 0; i < numTimeSlices; ++i) {
       // For each time slice, distribute across venues by volume
@@ -183,20 +212,21 @@ VWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
               ? totalQuantity - (sliceQuantity * (numTimeSlices - 1))
               : sliceQuantity;
 
-      for (const auto& venue : marketData) {
-        if (venue.recentVolume <= 0)
+      for (size_t v = 0; v < quotes.size(); ++v) {
+        if (quotes.recentVolume[v] <= 0)
           continue;
 
-        double venueWeight = venue.recentVolume / totalMarketVolume;
+        double venueWeight = quotes.recentVolume[v] / totalMarketVolume;
         double venueQuantity = remainingSliceQty * venueWeight;
 
         if (venueQuantity < 1.0)
           continue; // Skip very small orders
 
+        std::string venue(quotes.venue[v]);
         ExecutionRequest venueRequest;
         venueRequest.requestId = originalRequest.requestId + "_VWAP_" +
-                                 std::to_string(i) + "_" + venue.venue;
-        venueRequest.targetVenue = venue.venue;
+                                 std::to_string(i) + "_" + venue;
+        venueRequest.targetVenue = venue;
         venueRequest.maxExecutionTime = originalRequest.maxExecutionTime;
         venueRequest.maxSlippage = originalRequest.maxSlippage;
         venueRequest.allowPartialFills = originalRequest.allowPartialFills;
@@ -207,25 +237,30 @@ VWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
             originalRequest.order.getSide(), originalRequest.order.getType(),
             originalRequest.order.getPrice(), venueQuantity,
             utils::TimeUtils::getCurrentNanos());
+
+        // Each slice waits an interval so there is traded volume to
+        // participate in; the scheduler resizes it from that volume
+        venueRequest.releaseDelay = (i + 1) * spacing;
+        venueRequest.participationRate = m_participationRate;
         requests.emplace_back(std::move(venueRequest));
       }
     }
   } else {
     // Single slice, distribute by volume across venues
-    for (const auto& venue : marketData) {
-      if (venue.recentVolume <= 0)
+    for (size_t v = 0; v < quotes.size(); ++v) {
+      if (quotes.recentVolume[v] <= 0)
         continue;
 
-      double venueWeight = venue.recentVolume / totalMarketVolume;
+      double venueWeight = quotes.recentVolume[v] / totalMarketVolume;
       double venueQuantity = totalQuantity * venueWeight;
 
       if (venueQuantity < 1.0)
         continue;
 
+      std::string venue(quotes.venue[v]);
       ExecutionRequest venueRequest;
-      venueRequest.requestId =
-          originalRequest.requestId + "_VWAP_" + venue.venue;
-      venueRequest.targetVenue = venue.venue;
+      venueRequest.requestId = originalRequest.requestId + "_VWAP_" + venue;
+      venueRequest.targetVenue = venue;
       venueRequest.maxExecutionTime = originalRequest.maxExecutionTime;
       venueRequest.maxSlippage = originalRequest.maxSlippage;
       venueRequest.allowPartialFills = originalRequest.allowPartialFills;
@@ -249,30 +284,32 @@ VWAPStrategy::planExecution(const ExecutionRequest& originalRequest,
 
 std::vector<ExecutionRequest>
 MarketImpactStrategy::planExecution(const ExecutionRequest& originalRequest,
-                                    const std::vector<MarketData>& marketData) {
+                                    const VenueQuoteView& quotes) {
 
   std::vector<ExecutionRequest> requests;
 
-  // Sort venues by market impact (ascending)
-  std::vector<MarketData> sortedVenues = marketData;
-  std::sort(sortedVenues.begin(), sortedVenues.end(),
-            [](const MarketData& a, const MarketData& b) {
-              return a.impactCost < b.impactCost;
+  // Rank venue indices by market impact (ascending) without copying quotes
+  std::array<uint8_t, MAX_ROUTING_VENUES> order;
+  for (size_t i = 0; i < quotes.size(); ++i) {
+    order[i] = static_cast<uint8_t>(i);
+  }
+  std::sort(order.begin(), order.begin() + quotes.size(),
+            [&quotes](uint8_t a, uint8_t b) {
+              return quotes.impactCost[a] < quotes.impactCost[b];
             });
 
+  bool isBuy = originalRequest.order.getSide() == pinnacle::OrderSide::BUY;
   double remainingQuantity = originalRequest.order.getQuantity();
 
-  for (const auto& venue : sortedVenues) {
+  for (size_t rank = 0; rank < quotes.size(); ++rank) {
+    size_t v = order[rank];
     if (remainingQuantity <= 0)
       break;
-    if (venue.impactCost > m_maxImpactThreshold)
+    if (quotes.impactCost[v] > m_maxImpactThreshold)
       break;
 
     // Calculate max quantity for this venue without exceeding impact threshold
-    double availableSize =
-        (originalRequest.order.getSide() == pinnacle::OrderSide::BUY)
-            ? venue.askSize
-            : venue.bidSize;
+    double availableSize = isBuy ? quotes.askSize[v] : quotes.bidSize[v];
 
     // Use conservative fraction of available liquidity
     double maxVenueQty = std::min(availableSize * 0.3, remainingQuantity);
@@ -280,10 +317,10 @@ MarketImpactStrategy::planExecution(const ExecutionRequest& originalRequest,
     if (maxVenueQty < 1.0)
       continue;
 
+    std::string venue(quotes.venue[v]);
     ExecutionRequest venueRequest;
-    venueRequest.requestId =
-        originalRequest.requestId + "_IMPACT_" + venue.venue;
-    venueRequest.targetVenue = venue.venue;
+    venueRequest.requestId = originalRequest.requestId + "_IMPACT_" + venue;
+    venueRequest.targetVenue = venue;
     venueRequest.maxExecutionTime = originalRequest.maxExecutionTime;
     venueRequest.maxSlippage = originalRequest.maxSlippage;
     venueRequest.allowPartialFills = originalRequest.allowPartialFills;
@@ -302,13 +339,177 @@ MarketImpactStrategy::planExecution(const ExecutionRequest& originalRequest,
   return requests;
 }
 
+// =============================================================================
+// DepthAwareStrategy Implementation
+// =============================================================================
+
+std::vector<ExecutionRequest>
+DepthAwareStrategy::planExecution(const ExecutionRequest& originalRequest,
+                                  const VenueQuoteView& quotes) {
+
+  std::vector<ExecutionRequest> requests;
+
+  if (quotes.empty()) {
+    return requests;
+  }
+
+  DepthCostModel model;
+  model.latencyPenaltyPerMicro = m_latencyPenaltyPerMicro;
+  model.maxLevels = m_maxLevels;
+  if (originalRequest.order.getType() == pinnacle::OrderType::LIMIT) {
+    model.limitPrice = originalRequest.order.getPrice();
+  }
+
+  DepthSplit split =
+      splitByDepth(originalRequest.order.getSide(),
+                   originalRequest.order.getQuantity(), quotes, model);
+
+  for (size_t v = 0; v < split.venues; ++v) {
+    if (split.quantity[v] <= 0.0)
+      continue;
+
+    std::string venue(quotes.venue[v]);
+    ExecutionRequest venueRequest;
+    venueRequest.requestId = originalRequest.requestId + "_SOR_" + venue;
+    venueRequest.targetVenue = venue;
+    venueRequest.maxExecutionTime = originalRequest.maxExecutionTime;
+    venueRequest.maxSlippage = originalRequest.maxSlippage;
+    venueRequest.allowPartialFills = originalRequest.allowPartialFills;
+    venueRequest.routingStrategy = originalRequest.routingStrategy;
+
+    // Limit each child at the deepest level it was allocated
+    venueRequest.order = pinnacle::Order(
+        venueRequest.requestId, originalRequest.order.getSymbol(),
+        originalRequest.order.getSide(), pinnacle::OrderType::LIMIT,
+        split.worstPrice[v], split.quantity[v],
+        utils::TimeUtils::getCurrentNanos());
+    requests.emplace_back(std::move(venueRequest));
+  }
+
+  return requests;
+}
+
+// =============================================================================
+// ExecutionScheduler Implementation
+// =============================================================================
+
+ExecutionScheduler::ExecutionScheduler(uint64_t tickNanos, uint64_t startNanos)
+    : m_wheel(tickNanos, startNanos) {}
+
+void ExecutionScheduler::setVolumeSource(VolumeSource source) {
+  m_volumeSource = std::move(source);
+}
+
+void ExecutionScheduler::schedule(ExecutionRequest&& child,
+                                  uint64_t planTimeNanos) {
+  if (child.participationRate > 0.0) {
+    auto [it, inserted] = m_lanes.try_emplace(laneKey(child));
+    auto& lane = it->second;
+    if (inserted) {
+      lane.volumeBaseline = currentVolume(child);
+    }
+    lane.remainingQuantity += child.order.getQuantity();
+    lane.pendingSlices++;
+  }
+
+  uint64_t releaseTime =
+      planTimeNanos +
+      static_cast<uint64_t>(
+          std::max<int64_t>(0, child.releaseDelay.count()));
+  m_wheel.schedule(releaseTime, std::move(child));
+}
+
+size_t ExecutionScheduler::advance(uint64_t nowNanos,
+                                   const ReleaseCallback& onRelease,
+                                   const DropCallback& onDrop) {
+  return m_wheel.advance(nowNanos, [&](ExecutionRequest&& child) {
+    release(std::move(child), nowNanos, onRelease, onDrop);
+  });
+}
+
+std::string ExecutionScheduler::laneKey(const ExecutionRequest& child) {
+  return child.parentRequestId + "/" + child.targetVenue;
+}
+
+double ExecutionScheduler::currentVolume(const ExecutionRequest& child) const {
+  return m_volumeSource
+             ? m_volumeSource(child.targetVenue, child.order.getSymbol())
+             : 0.0;
+}
+
+void ExecutionScheduler::release(ExecutionRequest&& child, uint64_t nowNanos,
+                                 const ReleaseCallback& onRelease,
+                                 const DropCallback& onDrop) {
+  if (child.participationRate <= 0.0) {
+    onRelease(std::move(child));
+    return;
+  }
+
+  auto it = m_lanes.find(laneKey(child));
+  if (it == m_lanes.end()) {
+    onRelease(std::move(child));
+    return;
+  }
+
+  auto& lane = it->second;
+  lane.pendingSlices--;
+  bool isLast = lane.pendingSlices == 0;
+
+  double volume = currentVolume(child);
+  double traded = std::max(0.0, volume - lane.volumeBaseline);
+  lane.volumeBaseline = std::max(lane.volumeBaseline, volume);
+
+  double quantity =
+      isLast ? lane.remainingQuantity
+             : std::min(lane.remainingQuantity,
+                        child.participationRate * traded);
+
+  // Too little traded to participate: keep the quantity for a later slice
+  bool skip = isLast ? quantity <= 0.0 : quantity < 1.0;
+  if (!skip) {
+    lane.remainingQuantity -= quantity;
+  }
+  if (isLast) {
+    m_lanes.erase(it);
+  }
+
+  if (skip) {
+    onDrop(child);
+    return;
+  }
+
+  child.order = pinnacle::Order(
+      child.order.getOrderId(), child.order.getSymbol(),
+      child.order.getSide(), child.order.getType(), child.order.getPrice(),
+      quantity, nowNanos);
+  onRelease(std::move(child));
+}
+
 // =============================================================================
 // OrderRouter Implementation
 // =============================================================================
 
-OrderRouter::OrderRouter() {
+namespace {
+// Timeout wheel resolution; execution timeouts are seconds-scale
+constexpr uint64_t TIMEOUT_TICK_NANOS = 10'000'000ULL; // 10ms
+// Upper bound on how long an idle stage parks before rechecking shutdown
+constexpr auto STAGE_IDLE_WAIT = std::chrono::milliseconds(50);
+// Release resolution for time-sliced child orders
+constexpr uint64_t SCHEDULER_TICK_NANOS = 1'000'000ULL; // 1ms
+// Quotes older than this are ignored by routing
+constexpr uint64_t QUOTE_STALENESS_NANOS = 5'000'000'000ULL; // 5 seconds
+} // namespace
+
+OrderRouter::OrderRouter()
+    : m_scheduler(SCHEDULER_TICK_NANOS, utils::TimeUtils::getCurrentNanos()),
+      m_timeoutWheel(TIMEOUT_TICK_NANOS, utils::TimeUtils::getCurrentNanos()) {
   initializeStrategies();
 
+  m_scheduler.setVolumeSource(
+      [this](const std::string& venue, const std::string& symbol) {
+        return observedVolume(venue, symbol);
+      });
+
   // Initialize exchange factories
   m_webSocketFactory = std::make_shared<exchange::ExchangeConnectorFactory>();
   // Note: FixConnectorFactory initialization deferred due to singleton pattern
@@ -330,10 +531,10 @@ bool OrderRouter::start() {
 
   m_shouldStop.store(false);
 
-  // Start worker threads
-  m_routingThread = std::thread(&OrderRouter::routingThreadLoop, this);
-  m_executionThread = std::thread(&OrderRouter::executionThreadLoop, this);
-  m_monitoringThread = std::thread(&OrderRouter::monitoringThreadLoop, this);
+  // Start pipeline stages, downstream first so no stage feeds a dead queue
+  m_aggregationThread = std::thread(&OrderRouter::aggregationThreadLoop, this);
+  m_dispatchThread = std::thread(&OrderRouter::dispatchThreadLoop, this);
+  m_planningThread = std::thread(&OrderRouter::planningThreadLoop, this);
 
   m_isRunning.store(true);
 
@@ -348,15 +549,20 @@ bool OrderRouter::stop() {
 
   m_shouldStop.store(true);
 
+  // Wake parked stages so they observe the stop flag immediately
+  m_intakeQueue.wakeAll();
+  m_dispatchQueue.wakeAll();
+  m_aggregationQueue.wakeAll();
+
   // Join worker threads
-  if (m_routingThread.joinable()) {
-    m_routingThread.join();
+  if (m_planningThread.joinable()) {
+    m_planningThread.join();
   }
-  if (m_executionThread.joinable()) {
-    m_executionThread.join();
+  if (m_dispatchThread.joinable()) {
+    m_dispatchThread.join();
   }
-  if (m_monitoringThread.joinable()) {
-    m_monitoringThread.join();
+  if (m_aggregationThread.joinable()) {
+    m_aggregationThread.join();
   }
 
   m_isRunning.store(false);
@@ -367,33 +573,28 @@ bool OrderRouter::stop() {
 
 std::string OrderRouter::submitOrder(const ExecutionRequest& request) {
   std::string requestId = generateRequestId();
+  uint64_t submitTime = utils::TimeUtils::getCurrentNanos();
 
-  ExecutionRequest modifiedRequest;
-  modifiedRequest.requestId = requestId;
-  modifiedRequest.order =
-      Order(request.order.getOrderId(), request.order.getSymbol(),
-            request.order.getSide(), request.order.getType(),
-            request.order.getPrice(), request.order.getQuantity(),
-            request.order.getTimestamp());
-  modifiedRequest.targetVenue = request.targetVenue;
-  modifiedRequest.maxExecutionTime = request.maxExecutionTime;
-  modifiedRequest.maxSlippage = request.maxSlippage;
-  modifiedRequest.allowPartialFills = request.allowPartialFills;
-  modifiedRequest.routingStrategy = request.routingStrategy;
+  PipelineOrder pending;
+  pending.request = cloneRequest(request);
+  pending.request.requestId = requestId;
+  pending.submitTime = submitTime;
 
   // Store in active executions
   {
     std::lock_guard<std::mutex> lock(m_executionsMutex);
     ActiveExecution execution;
-    execution.originalRequest = std::move(modifiedRequest);
-    execution.startTime = utils::TimeUtils::getCurrentNanos();
+    execution.originalRequest = cloneRequest(pending.request);
+    execution.startTime = submitTime;
     m_activeExecutions.emplace(requestId, std::move(execution));
   }
 
-  // Queue for routing
-  if (!m_executionQueue.tryEnqueue(std::move(modifiedRequest))) {
+  // Hand off to the planning stage
+  if (!m_intakeQueue.tryEnqueue(std::move(pending))) {
     std::cerr << "Failed to queue execution request: " << requestId
               << std::endl;
+    std::lock_guard<std::mutex> lock(m_executionsMutex);
+    m_activeExecutions.erase(requestId);
     return "";
   }
 
@@ -406,7 +607,10 @@ std::string OrderRouter::submitOrder(const ExecutionRequest& request) {
 }
 
 bool OrderRouter::cancelOrder(const std::string& requestId) {
-  return m_cancelQueue.tryEnqueue(requestId);
+  PipelineEvent event;
+  event.type = PipelineEvent::Type::CANCEL;
+  event.requestId = requestId;
+  return m_aggregationQueue.tryEnqueue(std::move(event));
 }
 
 void OrderRouter::setExecutionCallback(
@@ -415,33 +619,199 @@ void OrderRouter::setExecutionCallback(
   m_executionCallback = callback;
 }
 
+void OrderRouter::setChildOrderCallback(
+    std::function<void(const ExecutionRequest&)> callback) {
+  std::lock_guard<std::mutex> lock(m_callbackMutex);
+  m_childOrderCallback = callback;
+}
+
+void OrderRouter::setOrderSender(OrderSender sender) {
+  std::lock_guard<std::mutex> lock(m_callbackMutex);
+  m_orderSender = std::move(sender);
+}
+
 bool OrderRouter::addVenue(const std::string& venueName,
                            const std::string& connectionType) {
   std::lock_guard<std::mutex> lock(m_venuesMutex);
 
+  auto existing = m_venues.find(venueName);
+  if (existing != m_venues.end()) {
+    // Re-adding keeps the venue's quote row
+    existing->second.type = connectionType;
+    m_venueActive[existing->second.quoteIndex].store(
+        true, std::memory_order_release);
+    return true;
+  }
+
+  size_t index = m_venueCount.load(std::memory_order_relaxed);
+  if (index >= MAX_ROUTING_VENUES) {
+    std::cerr << "Cannot add venue " << venueName << ": limit of "
+              << MAX_ROUTING_VENUES << " venues reached" << std::endl;
+    return false;
+  }
+
   VenueConnection venue;
   venue.name = venueName;
   venue.type = connectionType;
-  venue.isActive = true; // Would actually test connection
+  venue.quoteIndex = index;
 
   m_venues[venueName] = venue;
 
+  // Publish the name before the count so lock-free readers never see a
+  // half-initialized slot
+  m_venueNames[index] = venueName;
+  m_lifecycleVenues[index] = m_lifecycle.registerVenue(venueName);
+  // Would actually test connection
+  m_venueActive[index].store(true, std::memory_order_relaxed);
+  m_venueCount.store(index + 1, std::memory_order_release);
+
   std::cout << "Added venue: " << venueName << " (type: " << connectionType
             << ")" << std::endl;
   return true;
 }
 
+bool OrderRouter::removeVenue(const std::string& venueName) {
+  std::lock_guard<std::mutex> lock(m_venuesMutex);
+
+  auto it = m_venues.find(venueName);
+  if (it == m_venues.end()) {
+    return false;
+  }
+
+  // The index stays reserved so in-flight snapshots keep valid names
+  m_venueActive[it->second.quoteIndex].store(false,
+                                             std::memory_order_release);
+  return true;
+}
+
 void OrderRouter::updateMarketData(const std::string& venue,
                                    const MarketData& data) {
-  std::lock_guard<std::mutex> lock(m_venuesMutex);
+  size_t index = findVenueIndex(venue);
+  if (index != NO_VENUE) {
+    m_defaultQuotes.publish(index, data, utils::TimeUtils::getCurrentNanos());
+    m_latencyModel.recordQuote(index, data.timestamp,
+                               utils::TimeUtils::getWallClockNanos());
+  }
+}
+
+void OrderRouter::updateMarketData(const std::string& venue,
+                                   const std::string& symbol,
+                                   const MarketData& data) {
+  size_t index = findVenueIndex(venue);
+  if (index != NO_VENUE) {
+    getOrCreateQuoteTable(symbol).publish(index, data,
+                                          utils::TimeUtils::getCurrentNanos());
+    m_latencyModel.recordQuote(index, data.timestamp,
+                               utils::TimeUtils::getWallClockNanos());
+  }
+}
+
+void OrderRouter::onOrderAck(const std::string& venue,
+                             execution::OrderHandle handle,
+                             uint64_t timestamp) {
+  if (!m_lifecycle.onAck(handle, timestamp)) {
+    return; // Unknown, already acknowledged or closed
+  }
 
-  auto it = m_venues.find(venue);
-  if (it != m_venues.end()) {
-    it->second.lastMarketData = data;
-    it->second.lastMarketData.timestamp = utils::TimeUtils::getCurrentNanos();
+  execution::OrderRecord record;
+  size_t index = findVenueIndex(venue);
+  if (index != NO_VENUE && m_lifecycle.get(handle, record)) {
+    m_latencyModel.recordRoundTrip(index, record.ackedAt - record.createdAt);
   }
 }
 
+void OrderRouter::onExecutionReport(execution::OrderHandle handle,
+                                    pinnacle::OrderStatus status,
+                                    double cumulativeFilled,
+                                    double avgFillPrice, uint64_t timestamp) {
+  bool terminal = status == pinnacle::OrderStatus::FILLED ||
+                  status == pinnacle::OrderStatus::CANCELED ||
+                  status == pinnacle::OrderStatus::REJECTED ||
+                  status == pinnacle::OrderStatus::EXPIRED;
+
+  InFlightChild child;
+  {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    auto it = m_inFlight.find(handle);
+    if (it == m_inFlight.end()) {
+      return; // Not ours, or already terminal
+    }
+    child = terminal ? std::move(it->second) : it->second;
+    if (terminal) {
+      m_inFlight.erase(it);
+    }
+  }
+
+  if (status != pinnacle::OrderStatus::REJECTED) {
+    onOrderAck(child.venue, handle, timestamp);
+  }
+
+  execution::OrderRecord record;
+  m_lifecycle.applyStatus(handle, status, cumulativeFilled, timestamp,
+                          &record);
+  if (!terminal) {
+    return;
+  }
+
+  PipelineEvent fill;
+  fill.type = PipelineEvent::Type::FILL;
+  fill.requestId = child.parentRequestId;
+
+  ExecutionResult& result = fill.result;
+  result.requestId = std::move(child.requestId);
+  result.parentRequestId = std::move(child.parentRequestId);
+  result.orderId = std::move(child.orderId);
+  result.venue = std::move(child.venue);
+  result.status = status;
+  result.filledQuantity = cumulativeFilled;
+  result.avgFillPrice = avgFillPrice;
+  result.executionTime =
+      record.createdAt > 0 && timestamp > record.createdAt
+          ? (timestamp - record.createdAt) / 1000
+          : 0;
+  result.orderHandle = handle;
+
+  enqueueWithBackpressure(m_aggregationQueue, std::move(fill));
+}
+
+VenueLatencyEstimate
+OrderRouter::getVenueLatency(const std::string& venue) const {
+  size_t index = findVenueIndex(venue);
+  return index != NO_VENUE ? m_latencyModel.estimate(index)
+                           : VenueLatencyEstimate{};
+}
+
+void OrderRouter::updateMarketDepth(const std::string& venue,
+                                    const std::string& symbol,
+                                    std::span<const double> bidPrices,
+                                    std::span<const double> bidSizes,
+                                    std::span<const double> askPrices,
+                                    std::span<const double> askSizes) {
+  size_t index = findVenueIndex(venue);
+  if (index == NO_VENUE) {
+    return;
+  }
+
+  VenueDepthTable* table = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> lock(m_depthTablesMutex);
+    auto it = m_depthTables.find(symbol);
+    if (it != m_depthTables.end()) {
+      table = it->second.get();
+    }
+  }
+  if (!table) {
+    std::unique_lock<std::shared_mutex> lock(m_depthTablesMutex);
+    auto& entry = m_depthTables[symbol];
+    if (!entry) {
+      entry = std::make_unique<VenueDepthTable>();
+    }
+    table = entry.get();
+  }
+
+  table->publish(index, bidPrices, bidSizes, askPrices, askSizes);
+}
+
 void OrderRouter::setRoutingStrategy(const std::string& strategyName) {
   if (m_strategies.find(strategyName) != m_strategies.end()) {
     m_currentStrategy = strategyName;
@@ -461,19 +831,19 @@ std::string OrderRouter::getStatistics() const {
   oss << "  Completed: " << m_stats.completedExecutions << "\n";
   oss << "  Canceled: " << m_stats.canceledExecutions << "\n";
   oss << "  Failed: " << m_stats.failedExecutions << "\n";
+  oss << "  Timed Out: " << m_stats.timedOutExecutions << "\n";
   oss << "  Total Volume: " << m_stats.totalVolume << "\n";
   oss << "  Avg Execution Time: " << m_stats.avgExecutionTime << "ms\n";
+  oss << "  Avg Submit-to-First-Child: " << m_stats.avgFirstChildLatency
+      << "us (max " << m_stats.maxFirstChildLatency << "us)\n";
   oss << "  Best Fill Rate: " << (m_stats.bestFillRate * 100) << "%\n";
   oss << "  Current Strategy: " << m_currentStrategy << "\n";
   oss << "  Active Venues: ";
 
-  {
-    std::lock_guard<std::mutex> venueLock(
-        const_cast<std::mutex&>(m_venuesMutex));
-    for (const auto& venue : m_venues) {
-      if (venue.second.isActive) {
-        oss << venue.first << " ";
-      }
+  size_t venueCount = m_venueCount.load(std::memory_order_acquire);
+  for (size_t i = 0; i < venueCount; ++i) {
+    if (m_venueActive[i].load(std::memory_order_acquire)) {
+      oss << m_venueNames[i] << " ";
     }
   }
 
@@ -481,131 +851,457 @@ std::string OrderRouter::getStatistics() const {
 }
 
 // =============================================================================
-// Private Methods
+// Pipeline Stages
 // =============================================================================
 
-void OrderRouter::routingThreadLoop() {
+template <typename Queue, typename Item>
+bool OrderRouter::enqueueWithBackpressure(Queue& queue, Item&& item) {
+  // A failed tryEnqueue leaves the item intact, so retrying is safe
+  while (!queue.tryEnqueue(std::forward<Item>(item))) {
+    if (m_shouldStop.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+void OrderRouter::planningThreadLoop() {
+  PipelineOrder pending;
+
+  auto release = [this](ExecutionRequest&& child) {
+    releaseScheduledChild(std::move(child));
+  };
+  auto drop = [this](const ExecutionRequest& child) {
+    dropScheduledChild(child);
+  };
+
   while (!m_shouldStop.load()) {
-    ExecutionRequest request;
-
-    // Process execution requests
-    while (m_executionQueue.tryDequeue(request)) {
-      // Get market data for routing decision
-      std::vector<MarketData> marketData =
-          getAllMarketData(request.order.getSymbol());
-
-      // Apply routing strategy
-      auto strategy = m_strategies.find(m_currentStrategy);
-      if (strategy == m_strategies.end()) {
-        std::cerr << "Invalid routing strategy: " << m_currentStrategy
-                  << std::endl;
-        continue;
+    // Park until the next order, or until the next scheduler tick while any
+    // time-sliced child is waiting
+    auto wait = std::chrono::nanoseconds(STAGE_IDLE_WAIT);
+    if (!m_scheduler.empty()) {
+      uint64_t now = utils::TimeUtils::getCurrentNanos();
+      uint64_t nextTick = m_scheduler.nextTickNanos();
+      wait = std::min(wait, std::chrono::nanoseconds(
+                                nextTick > now ? nextTick - now : 0));
+    }
+
+    if (m_intakeQueue.waitDequeue(pending, wait)) {
+      planRequest(pending);
+    }
+
+    m_scheduler.advance(utils::TimeUtils::getCurrentNanos(), release, drop);
+  }
+}
+
+void OrderRouter::planRequest(PipelineOrder& pending) {
+  ExecutionRequest& request = pending.request;
+
+  // Snapshot venue quotes for the routing decision (no allocation)
+  snapshotQuotes(request.order.getSymbol(), m_planningQuotes);
+
+  // Apply routing strategy
+  auto strategy = m_strategies.find(m_currentStrategy);
+  if (strategy == m_strategies.end()) {
+    std::cerr << "Invalid routing strategy: " << m_currentStrategy
+              << std::endl;
+    return;
+  }
+
+  VenueQuoteView quotes = m_planningQuotes.view();
+  if (strategy->second->requiresDepth()) {
+    snapshotDepth(request.order.getSymbol(), m_planningQuotes,
+                  m_planningDepth);
+    quotes.depth = &m_planningDepth;
+  }
+
+  std::vector<ExecutionRequest> childRequests =
+      strategy->second->planExecution(request, quotes);
+
+  // Register the plan before any child can produce a fill, so aggregation
+  // always sees PLANNED ahead of the corresponding FILL events
+  PipelineEvent planned;
+  planned.type = PipelineEvent::Type::PLANNED;
+  planned.requestId = request.requestId;
+  planned.childCount = childRequests.size();
+  if (!enqueueWithBackpressure(m_aggregationQueue, std::move(planned))) {
+    return;
+  }
+
+  uint64_t planTime = utils::TimeUtils::getCurrentNanos();
+  bool isFirst = true;
+  bool scheduled = false;
+  for (auto& childRequest : childRequests) {
+    childRequest.parentRequestId = request.requestId;
+
+    // Time-sliced children wait on the scheduler
+    if (childRequest.releaseDelay.count() > 0) {
+      m_scheduler.schedule(std::move(childRequest), planTime);
+      scheduled = true;
+      continue;
+    }
+
+    PipelineOrder child;
+    child.request = std::move(childRequest);
+    child.submitTime = pending.submitTime;
+    child.isFirstChild = isFirst;
+    isFirst = false;
+
+    if (!enqueueWithBackpressure(m_dispatchQueue, std::move(child))) {
+      return;
+    }
+  }
+
+  // With a child already dispatched, released ones are never the first
+  if (!isFirst && scheduled) {
+    std::lock_guard<std::mutex> lock(m_executionsMutex);
+    auto it = m_activeExecutions.find(request.requestId);
+    if (it != m_activeExecutions.end()) {
+      it->second.childDispatched = true;
+    }
+  }
+}
+
+void OrderRouter::releaseScheduledChild(ExecutionRequest&& child) {
+  // Children of canceled or timed-out parents are discarded lazily here
+  // rather than searched for in the wheel
+  PipelineOrder pending;
+  {
+    std::lock_guard<std::mutex> lock(m_executionsMutex);
+    auto it = m_activeExecutions.find(child.parentRequestId);
+    if (it == m_activeExecutions.end() || it->second.isComplete.load()) {
+      return;
+    }
+
+    // The first child of a fully time-sliced parent is released here
+    if (!it->second.childDispatched) {
+      it->second.childDispatched = true;
+      pending.submitTime = it->second.startTime;
+      pending.isFirstChild = true;
+    }
+  }
+
+  pending.request = std::move(child);
+  enqueueWithBackpressure(m_dispatchQueue, std::move(pending));
+}
+
+void OrderRouter::dropScheduledChild(const ExecutionRequest& child) {
+  PipelineEvent dropped;
+  dropped.type = PipelineEvent::Type::DROPPED;
+  dropped.requestId = child.parentRequestId;
+  enqueueWithBackpressure(m_aggregationQueue, std::move(dropped));
+}
+
+void OrderRouter::dispatchThreadLoop() {
+  PipelineOrder child;
+
+  while (!m_shouldStop.load()) {
+    if (!m_dispatchQueue.waitDequeue(child, STAGE_IDLE_WAIT)) {
+      continue;
+    }
+
+    if (child.isFirstChild) {
+      recordFirstChildLatency(utils::TimeUtils::getDiffNanos(
+          child.submitTime, utils::TimeUtils::getCurrentNanos()));
+    }
+
+    size_t venueIndex = findVenueIndex(child.request.targetVenue);
+    execution::VenueId venueId =
+        venueIndex != NO_VENUE
+            ? m_lifecycleVenues[venueIndex]
+            : m_lifecycle.registerVenue(child.request.targetVenue);
+    child.request.orderHandle = m_lifecycle.onNew(
+        venueId, child.request.order.getSide(), child.request.order.getPrice(),
+        child.request.order.getQuantity(), utils::TimeUtils::getCurrentNanos());
+
+    // Call out with copies, so that a callback or sender may reenter the
+    // router, and a full aggregation queue cannot block the thread draining
+    // it on this lock
+    std::function<void(const ExecutionRequest&)> childOrderCallback;
+    OrderSender orderSender;
+    {
+      std::lock_guard<std::mutex> lock(m_callbackMutex);
+      childOrderCallback = m_childOrderCallback;
+      orderSender = m_orderSender;
+    }
+
+    if (childOrderCallback) {
+      childOrderCallback(child.request);
+    }
+    if (orderSender) {
+      sendOrder(child.request, orderSender);
+      continue;
+    }
+
+    executeOrder(child.request);
+  }
+}
+
+void OrderRouter::aggregationThreadLoop() {
+  PipelineEvent event;
+
+  while (!m_shouldStop.load()) {
+    // Park until the next event, or until the next wheel tick while any
+    // execution timeout is pending
+    auto wait = std::chrono::nanoseconds(STAGE_IDLE_WAIT);
+    if (!m_timeoutWheel.empty()) {
+      uint64_t now = utils::TimeUtils::getCurrentNanos();
+      uint64_t nextTick = m_timeoutWheel.nextTickNanos();
+      wait = std::min(wait, std::chrono::nanoseconds(
+                                nextTick > now ? nextTick - now : 0));
+    }
+
+    if (m_aggregationQueue.waitDequeue(event, wait)) {
+      handlePipelineEvent(event);
+
+      // Drain whatever else is ready before touching the wheel
+      while (m_aggregationQueue.tryDequeue(event)) {
+        handlePipelineEvent(event);
       }
+    }
 
-      std::vector<ExecutionRequest> childRequests =
-          strategy->second->planExecution(request, marketData);
+    m_timeoutWheel.advance(
+        utils::TimeUtils::getCurrentNanos(),
+        [this](std::string&& requestId) { handleTimeout(requestId); });
+  }
+}
+
+void OrderRouter::handlePipelineEvent(PipelineEvent& event) {
+  switch (event.type) {
+  case PipelineEvent::Type::PLANNED: {
+    bool failed = false;
+    {
+      std::lock_guard<std::mutex> lock(m_executionsMutex);
+      auto it = m_activeExecutions.find(event.requestId);
+      if (it == m_activeExecutions.end()) {
+        return; // Canceled before planning finished
+      }
 
-      // Execute child requests
-      for (auto& childRequest : childRequests) {
-        executeOrder(childRequest);
+      auto& execution = it->second;
+      execution.expectedChildren = event.childCount;
+      if (event.childCount == 0) {
+        // No venue could take the order
+        failed = true;
+      } else if (!execution.isComplete.load()) {
+        uint64_t deadline =
+            execution.startTime +
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                execution.originalRequest.maxExecutionTime)
+                .count();
+        execution.timeoutTimer =
+            m_timeoutWheel.schedule(deadline, event.requestId);
       }
+    }
 
-      // Store child requests for tracking
+    if (failed) {
       {
-        std::lock_guard<std::mutex> lock(m_executionsMutex);
-        auto it = m_activeExecutions.find(request.requestId);
-        if (it != m_activeExecutions.end()) {
-          it->second.childRequests = std::move(childRequests);
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.failedExecutions++;
+      }
+      processCompletedExecution(event.requestId);
+    }
+    break;
+  }
+
+  case PipelineEvent::Type::FILL:
+    updateExecutionResult(event.result);
+    break;
+
+  case PipelineEvent::Type::DROPPED: {
+    // A volume-driven slice had nothing to send; stop waiting for it
+    bool allChildrenDone = false;
+    {
+      std::lock_guard<std::mutex> lock(m_executionsMutex);
+      auto it = m_activeExecutions.find(event.requestId);
+      if (it != m_activeExecutions.end() && it->second.expectedChildren > 0) {
+        auto& execution = it->second;
+        execution.expectedChildren--;
+        if (execution.results.size() >= execution.expectedChildren) {
+          execution.isComplete.store(true);
+          allChildrenDone = true;
         }
       }
     }
 
-    // Process cancellation requests
-    std::string cancelRequestId;
-    while (m_cancelQueue.tryDequeue(cancelRequestId)) {
+    if (allChildrenDone) {
+      processCompletedExecution(event.requestId);
+    }
+    break;
+  }
+
+  case PipelineEvent::Type::CANCEL: {
+    bool canceled = false;
+    {
       std::lock_guard<std::mutex> lock(m_executionsMutex);
-      auto it = m_activeExecutions.find(cancelRequestId);
-      if (it != m_activeExecutions.end()) {
-        // Mark as canceled - actual cancellation would happen in execution
-        // thread
+      auto it = m_activeExecutions.find(event.requestId);
+      if (it != m_activeExecutions.end() && !it->second.isComplete.load()) {
+        // Mark as canceled - outstanding children are left to their venues
         it->second.isComplete.store(true);
+        canceled = true;
+      }
+    }
 
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+    if (canceled) {
+      {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
         m_stats.canceledExecutions++;
       }
+      processCompletedExecution(event.requestId);
     }
+    break;
+  }
+  }
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+void OrderRouter::handleTimeout(const std::string& requestId) {
+  {
+    std::lock_guard<std::mutex> lock(m_executionsMutex);
+    auto it = m_activeExecutions.find(requestId);
+    if (it == m_activeExecutions.end()) {
+      return;
+    }
+    // The timer has fired; make sure processCompletedExecution does not try
+    // to cancel it again
+    it->second.timeoutTimer = TimeoutWheel::INVALID_TIMER;
+    it->second.isComplete.store(true);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.timedOutExecutions++;
   }
+
+  processCompletedExecution(requestId);
 }
 
-void OrderRouter::executionThreadLoop() {
-  // This would handle actual order execution to exchanges
-  // For now, simulate execution
-  while (!m_shouldStop.load()) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+void OrderRouter::recordFirstChildLatency(uint64_t latencyNanos) {
+  double latencyMicros = latencyNanos / 1000.0;
+
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  m_stats.firstChildSamples++;
+  m_stats.avgFirstChildLatency +=
+      (latencyMicros - m_stats.avgFirstChildLatency) /
+      m_stats.firstChildSamples;
+  m_stats.maxFirstChildLatency =
+      std::max(m_stats.maxFirstChildLatency, latencyMicros);
+}
+
+// =============================================================================
+// Private Methods
+// =============================================================================
+
+size_t OrderRouter::findVenueIndex(const std::string& venue) const {
+  // Venue counts are small; a scan over immutable names beats hashing and
+  // needs no lock
+  size_t venueCount = m_venueCount.load(std::memory_order_acquire);
+  for (size_t i = 0; i < venueCount; ++i) {
+    if (m_venueNames[i] == venue) {
+      return i;
+    }
   }
+  return NO_VENUE;
 }
 
-void OrderRouter::monitoringThreadLoop() {
-  while (!m_shouldStop.load()) {
-    // Monitor execution timeouts and update statistics
-    std::vector<std::string> completedExecutions;
+VenueQuoteTable* OrderRouter::findQuoteTable(const std::string& symbol) const {
+  std::shared_lock<std::shared_mutex> lock(m_quoteTablesMutex);
+  auto it = m_quoteTables.find(symbol);
+  return it != m_quoteTables.end() ? it->second.get() : nullptr;
+}
 
-    {
-      std::lock_guard<std::mutex> lock(m_executionsMutex);
-      auto now = utils::TimeUtils::getCurrentNanos();
+VenueQuoteTable& OrderRouter::getOrCreateQuoteTable(const std::string& symbol) {
+  if (VenueQuoteTable* table = findQuoteTable(symbol)) {
+    return *table;
+  }
 
-      for (auto& pair : m_activeExecutions) {
-        auto& execution = pair.second;
+  std::unique_lock<std::shared_mutex> lock(m_quoteTablesMutex);
+  auto& table = m_quoteTables[symbol];
+  if (!table) {
+    table = std::make_unique<VenueQuoteTable>();
+  }
+  return *table;
+}
 
-        // Check for timeouts
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-            std::chrono::nanoseconds(now - execution.startTime));
+double OrderRouter::observedVolume(const std::string& venue,
+                                   const std::string& symbol) const {
+  size_t index = findVenueIndex(venue);
+  if (index == NO_VENUE) {
+    return 0.0;
+  }
 
-        if (elapsed > execution.originalRequest.maxExecutionTime) {
-          execution.isComplete.store(true);
-          completedExecutions.push_back(pair.first);
-        }
-      }
-    }
+  const VenueQuoteTable* symbolTable = findQuoteTable(symbol);
+  if (symbolTable && symbolTable->version(index) > 0) {
+    return symbolTable->cumulativeVolume(index);
+  }
+  return m_defaultQuotes.cumulativeVolume(index);
+}
 
-    // Process completed executions
-    for (const auto& requestId : completedExecutions) {
-      processCompletedExecution(requestId);
+void OrderRouter::snapshotDepth(const std::string& symbol,
+                                const VenueQuoteSnapshot& quotes,
+                                VenueDepthSnapshot& out) const {
+  const VenueDepthTable* table = nullptr;
+  {
+    // Tables are never erased, so the pointer stays valid without the lock
+    std::shared_lock<std::shared_mutex> lock(m_depthTablesMutex);
+    auto it = m_depthTables.find(symbol);
+    if (it != m_depthTables.end()) {
+      table = it->second.get();
     }
+  }
 
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+  for (size_t row = 0; row < quotes.count; ++row) {
+    if (!table ||
+        !table->read(quotes.sourceIndex[row], out.bids[row], out.asks[row])) {
+      out.bids[row].levels = 0;
+      out.asks[row].levels = 0;
+    }
   }
 }
 
-std::vector<MarketData>
-OrderRouter::getAllMarketData(const std::string& /* symbol */) {
-  std::lock_guard<std::mutex> lock(m_venuesMutex);
+void OrderRouter::snapshotQuotes(const std::string& symbol,
+                                 VenueQuoteSnapshot& out) {
+  out.clear();
 
-  std::vector<MarketData> marketData;
+  // Tables are never erased, so the pointer stays valid without the lock
+  const VenueQuoteTable* symbolTable = findQuoteTable(symbol);
   auto now = utils::TimeUtils::getCurrentNanos();
+  size_t venueCount = m_venueCount.load(std::memory_order_acquire);
 
-  for (const auto& venue : m_venues) {
-    if (!venue.second.isActive)
+  for (size_t i = 0; i < venueCount; ++i) {
+    if (!m_venueActive[i].load(std::memory_order_acquire))
       continue;
 
-    const auto& data = venue.second.lastMarketData;
+    size_t slot = out.count;
+    bool found = (symbolTable && symbolTable->read(i, out, slot)) ||
+                 m_defaultQuotes.read(i, out, slot);
+    if (!found)
+      continue;
 
-    // Check if market data is recent (within last 5 seconds)
-    if (now - data.timestamp < 5000000000ULL) { // 5 seconds in nanoseconds
-      marketData.push_back(data);
+    // Check if market data is recent
+    uint64_t received = out.timestamp[slot];
+    if (received + QUOTE_STALENESS_NANOS > now) {
+      // Measured round trips override the feed's configured latency
+      out.latencyMicros[slot] =
+          m_latencyModel.latencyMicros(i, out.latencyMicros[slot]);
+      out.stalenessMicros[slot] = m_latencyModel.stalenessMicros(
+          i, now > received ? now - received : 0,
+          out.updateIntervalMicros[slot]);
+      out.venue[slot] = m_venueNames[i];
+      out.count++;
     }
   }
-
-  return marketData;
 }
 
 void OrderRouter::executeOrder(const ExecutionRequest& request) {
   // Simulate order execution - in reality this would connect to actual
   // exchanges
-  ExecutionResult result;
+  PipelineEvent fill;
+  fill.type = PipelineEvent::Type::FILL;
+  fill.requestId = request.parentRequestId;
+
+  ExecutionResult& result = fill.result;
   result.requestId = request.requestId;
+  result.parentRequestId = request.parentRequestId;
   result.orderId = request.order.getOrderId();
   result.venue = request.targetVenue;
   result.status = pinnacle::OrderStatus::FILLED; // Simulate immediate fill
@@ -613,38 +1309,79 @@ void OrderRouter::executeOrder(const ExecutionRequest& request) {
   result.avgFillPrice = request.order.getPrice();
   result.totalFees = result.filledQuantity * 0.001; // 0.1% fee simulation
   result.executionTime = 1000;                      // 1ms simulation
+  result.orderHandle = request.orderHandle;
 
-  updateExecutionResult(result);
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  onOrderAck(request.targetVenue, request.orderHandle, now);
+  m_lifecycle.onFill(request.orderHandle, result.filledQuantity,
+                     result.avgFillPrice, now);
+
+  enqueueWithBackpressure(m_aggregationQueue, std::move(fill));
+}
+
+void OrderRouter::sendOrder(const ExecutionRequest& request,
+                            const OrderSender& sender) {
+  // Register first: the venue may answer before the sender returns
+  {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    m_inFlight[request.orderHandle] = {request.requestId,
+                                       request.parentRequestId,
+                                       request.order.getOrderId(),
+                                       request.targetVenue};
+  }
+
+  if (sender(request)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    m_inFlight.erase(request.orderHandle);
+  }
+  m_lifecycle.onReject(request.orderHandle,
+                       utils::TimeUtils::getCurrentNanos());
+
+  PipelineEvent rejected;
+  rejected.type = PipelineEvent::Type::FILL;
+  rejected.requestId = request.parentRequestId;
+
+  ExecutionResult& result = rejected.result;
+  result.requestId = request.requestId;
+  result.parentRequestId = request.parentRequestId;
+  result.orderId = request.order.getOrderId();
+  result.venue = request.targetVenue;
+  result.status = pinnacle::OrderStatus::REJECTED;
+  result.errorMessage = "Order could not be sent to venue";
+  result.orderHandle = request.orderHandle;
+
+  enqueueWithBackpressure(m_aggregationQueue, std::move(rejected));
 }
 
 void OrderRouter::updateExecutionResult(const ExecutionResult& result) {
+  bool allChildrenDone = false;
   {
     std::lock_guard<std::mutex> lock(m_executionsMutex);
 
-    // Find parent execution by parsing request ID
-    std::string parentId = result.requestId;
-    size_t pos = parentId.find('_');
-    if (pos != std::string::npos) {
-      parentId = parentId.substr(0, pos);
-    }
-
-    auto it = m_activeExecutions.find(parentId);
+    auto it = m_activeExecutions.find(result.parentRequestId);
     if (it != m_activeExecutions.end()) {
       it->second.results.push_back(result);
 
       // Check if all child requests are complete
-      if (it->second.results.size() >= it->second.childRequests.size()) {
+      if (it->second.results.size() >= it->second.expectedChildren) {
         it->second.isComplete.store(true);
+        allChildrenDone = true;
       }
     }
   }
 
   // Call execution callback
+  std::function<void(const ExecutionResult&)> executionCallback;
   {
     std::lock_guard<std::mutex> lock(m_callbackMutex);
-    if (m_executionCallback) {
-      m_executionCallback(result);
-    }
+    executionCallback = m_executionCallback;
+  }
+  if (executionCallback) {
+    executionCallback(result);
   }
 
   // Update statistics
@@ -659,6 +1396,10 @@ void OrderRouter::updateExecutionResult(const ExecutionResult& result) {
     m_stats.avgExecutionTime = (totalTime + result.executionTime / 1000.0) /
                                m_stats.completedExecutions;
   }
+
+  if (allChildrenDone) {
+    processCompletedExecution(result.parentRequestId);
+  }
 }
 
 void OrderRouter::initializeStrategies() {
@@ -666,6 +1407,7 @@ void OrderRouter::initializeStrategies() {
   m_strategies["TWAP"] = std::make_unique<TWAPStrategy>();
   m_strategies["VWAP"] = std::make_unique<VWAPStrategy>();
   m_strategies["MARKET_IMPACT"] = std::make_unique<MarketImpactStrategy>();
+  m_strategies["DEPTH_AWARE"] = std::make_unique<DepthAwareStrategy>();
 }
 
 void OrderRouter::processCompletedExecution(const std::string& requestId) {
@@ -674,10 +1416,30 @@ void OrderRouter::processCompletedExecution(const std::string& requestId) {
   auto it = m_activeExecutions.find(requestId);
   if (it != m_activeExecutions.end()) {
     // Could aggregate results and send final callback here
+    m_timeoutWheel.cancel(it->second.timeoutTimer);
     m_activeExecutions.erase(it);
   }
 }
 
+ExecutionRequest OrderRouter::cloneRequest(const ExecutionRequest& request) {
+  ExecutionRequest copy;
+  copy.requestId = request.requestId;
+  copy.order = Order(request.order.getOrderId(), request.order.getSymbol(),
+                     request.order.getSide(), request.order.getType(),
+                     request.order.getPrice(), request.order.getQuantity(),
+                     request.order.getTimestamp());
+  copy.targetVenue = request.targetVenue;
+  copy.maxExecutionTime = request.maxExecutionTime;
+  copy.maxSlippage = request.maxSlippage;
+  copy.allowPartialFills = request.allowPartialFills;
+  copy.routingStrategy = request.routingStrategy;
+  copy.parentRequestId = request.parentRequestId;
+  copy.releaseDelay = request.releaseDelay;
+  copy.participationRate = request.participationRate;
+  copy.orderHandle = request.orderHandle;
+  return copy;
+}
+
 std::string OrderRouter::generateRequestId() {
   return "REQ_" + std::to_string(m_requestIdCounter.fetch_add(1)) + "_" +
          std::to_string(utils::TimeUtils::getCurrentNanos());
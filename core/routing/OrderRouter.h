@@ -2,15 +2,24 @@
 
 #include "../../exchange/connector/ExchangeConnectorFactory.h"
 #include "../../exchange/fix/FixConnectorFactory.h"
+#include "../execution/OrderLifecycleManager.h"
 #include "../orderbook/Order.h"
 #include "../utils/LockFreeQueue.h"
 #include "../utils/TimeUtils.h"
+#include "../utils/TimingWheel.h"
+#include "DepthSplitter.h"
+#include "VenueDepthTable.h"
+#include "VenueLatencyModel.h"
+#include "VenueQuoteTable.h"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -20,22 +29,6 @@ namespace pinnacle {
 namespace core {
 namespace routing {
 
-/**
- * @brief Market data snapshot for routing decisions
- */
-struct MarketData {
-  std::string venue;
-  double bidPrice{0.0};
-  double askPrice{0.0};
-  double bidSize{0.0};
-  double askSize{0.0};
-  uint64_t timestamp{0};
-  double averageDailyVolume{0.0};
-  double recentVolume{0.0};
-  double impactCost{0.0}; // Estimated market impact
-  double fees{0.0};       // Trading fees for this venue
-};
-
 /**
  * @brief Order execution request
  */
@@ -47,7 +40,17 @@ struct ExecutionRequest {
   double maxSlippage{0.001};                  // 0.1% default
   bool allowPartialFills{true};
   std::string routingStrategy{
-      "BEST_PRICE"}; // BEST_PRICE, TWAP, VWAP, MARKET_IMPACT
+      "BEST_PRICE"}; // BEST_PRICE, TWAP, VWAP, MARKET_IMPACT,
+                     // DEPTH_AWARE
+  std::string parentRequestId; // Set by the router on child requests
+
+  // Time slicing: children are held until releaseDelay after planning, and
+  // a positive participationRate sizes them from observed volume on release
+  std::chrono::nanoseconds releaseDelay{0};
+  double participationRate{0.0};
+
+  // Lifecycle record of a dispatched child; set by the router
+  execution::OrderHandle orderHandle{execution::INVALID_ORDER_HANDLE};
 
   // Default constructor
   ExecutionRequest() = default;
@@ -66,6 +69,7 @@ struct ExecutionRequest {
  */
 struct ExecutionResult {
   std::string requestId;
+  std::string parentRequestId;
   std::string orderId;
   std::string venue;
   pinnacle::OrderStatus status;
@@ -74,6 +78,7 @@ struct ExecutionResult {
   double totalFees{0.0};
   uint64_t executionTime{0}; // Microseconds
   std::string errorMessage;
+  execution::OrderHandle orderHandle{execution::INVALID_ORDER_HANDLE};
 };
 
 /**
@@ -85,25 +90,51 @@ public:
 
   /**
    * @brief Plan order execution across venues and time
+   *
+   * @param quotes Venue quotes as contiguous columns; valid only for the
+   * duration of the call
    */
   virtual std::vector<ExecutionRequest>
   planExecution(const ExecutionRequest& originalRequest,
-                const std::vector<MarketData>& marketData) = 0;
+                const VenueQuoteView& quotes) = 0;
+
+  /**
+   * @brief Convenience overload for callers holding a MarketData vector
+   */
+  std::vector<ExecutionRequest>
+  planExecution(const ExecutionRequest& originalRequest,
+                const std::vector<MarketData>& marketData);
 
   /**
    * @brief Get strategy name
    */
   virtual std::string getName() const = 0;
+
+  /**
+   * @brief Whether the router should attach L2 depth to the quote view
+   */
+  virtual bool requiresDepth() const { return false; }
 };
 
 /**
  * @brief Best price routing strategy
+ *
+ * Prices are discounted by latencyPenaltyPerMicro per microsecond of the
+ * venue's delayMicros, so a slow or stale venue must quote better to win.
  */
 class BestPriceStrategy : public RoutingStrategy {
+private:
+  double m_latencyPenaltyPerMicro;
+
 public:
+  explicit BestPriceStrategy(double latencyPenaltyPerMicro = 1e-7)
+      : m_latencyPenaltyPerMicro(latencyPenaltyPerMicro) {}
+
+  using RoutingStrategy::planExecution;
+
   std::vector<ExecutionRequest>
   planExecution(const ExecutionRequest& originalRequest,
-                const std::vector<MarketData>& marketData) override;
+                const VenueQuoteView& quotes) override;
 
   std::string getName() const override { return "BEST_PRICE"; }
 };
@@ -114,17 +145,22 @@ public:
 class TWAPStrategy : public RoutingStrategy {
 private:
   int m_numSlices;
-  [[maybe_unused]] std::chrono::seconds
-      m_sliceInterval; // Reserved for future TWAP timing
+  std::chrono::seconds m_sliceInterval; // Spacing between slice releases
+  double m_latencyPenaltyPerMicro;      // Venue score discount per delay us
 
 public:
-  explicit TWAPStrategy(int numSlices = 10, std::chrono::seconds sliceInterval =
-                                                std::chrono::seconds(30))
-      : m_numSlices(numSlices), m_sliceInterval(sliceInterval) {}
+  explicit TWAPStrategy(
+      int numSlices = 10,
+      std::chrono::seconds sliceInterval = std::chrono::seconds(30),
+      double latencyPenaltyPerMicro = 1e-7)
+      : m_numSlices(numSlices), m_sliceInterval(sliceInterval),
+        m_latencyPenaltyPerMicro(latencyPenaltyPerMicro) {}
+
+  using RoutingStrategy::planExecution;
 
   std::vector<ExecutionRequest>
   planExecution(const ExecutionRequest& originalRequest,
-                const std::vector<MarketData>& marketData) override;
+                const VenueQuoteView& quotes) override;
 
   std::string getName() const override { return "TWAP"; }
 };
@@ -135,14 +171,20 @@ public:
 class VWAPStrategy : public RoutingStrategy {
 private:
   double m_participationRate;
+  std::chrono::seconds m_sliceInterval; // Spacing between slice releases
 
 public:
-  explicit VWAPStrategy(double participationRate = 0.1)
-      : m_participationRate(participationRate) {}
+  explicit VWAPStrategy(
+      double participationRate = 0.1,
+      std::chrono::seconds sliceInterval = std::chrono::seconds(30))
+      : m_participationRate(participationRate),
+        m_sliceInterval(sliceInterval) {}
+
+  using RoutingStrategy::planExecution;
 
   std::vector<ExecutionRequest>
   planExecution(const ExecutionRequest& originalRequest,
-                const std::vector<MarketData>& marketData) override;
+                const VenueQuoteView& quotes) override;
 
   std::string getName() const override { return "VWAP"; }
 };
@@ -158,13 +200,123 @@ public:
   explicit MarketImpactStrategy(double maxImpactThreshold = 0.005)
       : m_maxImpactThreshold(maxImpactThreshold) {}
 
+  using RoutingStrategy::planExecution;
+
   std::vector<ExecutionRequest>
   planExecution(const ExecutionRequest& originalRequest,
-                const std::vector<MarketData>& marketData) override;
+                const VenueQuoteView& quotes) override;
 
   std::string getName() const override { return "MARKET_IMPACT"; }
 };
 
+/**
+ * @brief Depth-aware smart order routing strategy
+ *
+ * Splits the order across venues by walking every venue's L2 book at once
+ * (see splitByDepth), so the allocation accounts for book depth, fees and
+ * expected venue latency rather than top of book alone. One child is sent
+ * per venue, limited at the deepest level it needs.
+ */
+class DepthAwareStrategy : public RoutingStrategy {
+private:
+  double m_latencyPenaltyPerMicro;
+  size_t m_maxLevels;
+
+public:
+  explicit DepthAwareStrategy(double latencyPenaltyPerMicro = 1e-7,
+                              size_t maxLevels = 50)
+      : m_latencyPenaltyPerMicro(latencyPenaltyPerMicro),
+        m_maxLevels(maxLevels) {}
+
+  using RoutingStrategy::planExecution;
+
+  std::vector<ExecutionRequest>
+  planExecution(const ExecutionRequest& originalRequest,
+                const VenueQuoteView& quotes) override;
+
+  std::string getName() const override { return "DEPTH_AWARE"; }
+  bool requiresDepth() const override { return true; }
+};
+
+/**
+ * @brief Releases time-sliced child orders from a hierarchical timing wheel
+ *
+ * Children with a non-zero releaseDelay are held here instead of being sent
+ * at planning time. Children with a participationRate are volume-driven: on
+ * release a slice is resized to participationRate times the volume traded on
+ * its venue since the previous slice of the same parent. Quantity a slice
+ * cannot place is carried to later slices and the final slice sends whatever
+ * remains; slices left with nothing to send are dropped.
+ *
+ * Schedule and cancel are O(1) and nothing sleeps per slice, so thousands of
+ * parents can be in flight. Not thread-safe: the router's planning stage owns
+ * it.
+ */
+class ExecutionScheduler {
+public:
+  using VolumeSource = std::function<double(const std::string& venue,
+                                            const std::string& symbol)>;
+  using ReleaseCallback = std::function<void(ExecutionRequest&& child)>;
+  using DropCallback = std::function<void(const ExecutionRequest& child)>;
+
+  /**
+   * @brief Constructor
+   *
+   * @param tickNanos Release resolution
+   * @param startNanos Current time
+   */
+  ExecutionScheduler(uint64_t tickNanos, uint64_t startNanos);
+
+  /**
+   * @brief Set the cumulative traded volume source for volume-driven slices
+   */
+  void setVolumeSource(VolumeSource source);
+
+  /**
+   * @brief Hold a child until planTimeNanos + child.releaseDelay
+   */
+  void schedule(ExecutionRequest&& child, uint64_t planTimeNanos);
+
+  /**
+   * @brief Release every child due at or before nowNanos
+   *
+   * @return Number of children released or dropped
+   */
+  size_t advance(uint64_t nowNanos, const ReleaseCallback& onRelease,
+                 const DropCallback& onDrop);
+
+  /**
+   * @brief Number of children waiting for release
+   */
+  size_t pendingCount() const { return m_wheel.size(); }
+
+  bool empty() const { return m_wheel.empty(); }
+
+  /**
+   * @brief Time of the next wheel tick, for bounding idle waits
+   */
+  uint64_t nextTickNanos() const { return m_wheel.nextTickNanos(); }
+
+private:
+  /**
+   * @brief Volume-driven slices of one parent on one venue
+   */
+  struct ParticipationLane {
+    double remainingQuantity{0.0};
+    double volumeBaseline{0.0};
+    size_t pendingSlices{0};
+  };
+
+  static std::string laneKey(const ExecutionRequest& child);
+  void release(ExecutionRequest&& child, uint64_t nowNanos,
+               const ReleaseCallback& onRelease, const DropCallback& onDrop);
+  double currentVolume(const ExecutionRequest& child) const;
+
+  utils::HierarchicalTimingWheel<ExecutionRequest> m_wheel;
+  std::unordered_map<std::string, ParticipationLane> m_lanes;
+  VolumeSource m_volumeSource;
+};
+
 /**
  * @brief Main order routing engine
  */
@@ -221,6 +373,42 @@ public:
   void
   setExecutionCallback(std::function<void(const ExecutionResult&)> callback);
 
+  /**
+   * @brief Register callback invoked as each child order is sent to a venue
+   */
+  void
+  setChildOrderCallback(std::function<void(const ExecutionRequest&)> callback);
+
+  /**
+   * @brief Gateway that puts a child order on the wire
+   *
+   * Called on the dispatch thread; must not block on the venue's response.
+   * Returns false if the order could not be sent.
+   */
+  using OrderSender = std::function<bool(const ExecutionRequest&)>;
+
+  /**
+   * @brief Send child orders through a venue gateway
+   *
+   * Without a sender, children are filled in-process at their limit price.
+   * With one, each child stays open until its venue's terminal execution
+   * report arrives through onExecutionReport; a failed send rejects it.
+   */
+  void setOrderSender(OrderSender sender);
+
+  /**
+   * @brief Apply a venue execution report to a child sent by the sender
+   *
+   * Any report other than a reject acknowledges the child. Fills advance
+   * its lifecycle record; a terminal status completes it.
+   *
+   * @param cumulativeFilled Total filled quantity so far
+   * @param avgFillPrice Average price of that quantity
+   */
+  void onExecutionReport(execution::OrderHandle handle,
+                         pinnacle::OrderStatus status, double cumulativeFilled,
+                         double avgFillPrice, uint64_t timestamp);
+
   /**
    * @brief Add venue for routing (WebSocket or FIX)
    */
@@ -233,10 +421,41 @@ public:
   bool removeVenue(const std::string& venueName);
 
   /**
-   * @brief Update market data for a venue
+   * @brief Update market data for a venue (applies to every symbol that has
+   * no symbol-specific quote from this venue)
    */
   void updateMarketData(const std::string& venue, const MarketData& data);
 
+  /**
+   * @brief Update market data for a venue and symbol
+   */
+  void updateMarketData(const std::string& venue, const std::string& symbol,
+                        const MarketData& data);
+
+  /**
+   * @brief Update L2 depth for a venue and symbol, best level first
+   */
+  void updateMarketDepth(const std::string& venue, const std::string& symbol,
+                         std::span<const double> bidPrices,
+                         std::span<const double> bidSizes,
+                         std::span<const double> askPrices,
+                         std::span<const double> askSizes);
+
+  /**
+   * @brief Record a venue's acknowledgement of a dispatched child order
+   *
+   * Advances the child's lifecycle record and feeds its new-to-ack round
+   * trip into the venue latency model. Connectors call this from their I/O
+   * thread.
+   */
+  void onOrderAck(const std::string& venue, execution::OrderHandle handle,
+                  uint64_t timestamp);
+
+  /**
+   * @brief Current latency estimates for a venue
+   */
+  VenueLatencyEstimate getVenueLatency(const std::string& venue) const;
+
   /**
    * @brief Set routing strategy
    */
@@ -248,6 +467,8 @@ public:
   std::string getStatistics() const;
 
 private:
+  using TimeoutWheel = utils::HierarchicalTimingWheel<std::string>;
+
   /**
    * @brief Routing engine state
    */
@@ -261,21 +482,61 @@ private:
     std::string name;
     std::string type;                // "websocket" or "fix"
     std::shared_ptr<void> connector; // WebSocket or FIX connector
-    bool isActive{false};
-    MarketData lastMarketData;
+    size_t quoteIndex{0};            // Row in the venue quote tables
   };
 
   std::unordered_map<std::string, VenueConnection> m_venues;
   std::mutex m_venuesMutex;
 
+  /**
+   * @brief Venue index registry
+   *
+   * Indexes are handed out by addVenue and never reused. A name is written
+   * before m_venueCount is published, so lock-free readers below the count
+   * always see it fully constructed.
+   */
+  std::array<std::string, MAX_ROUTING_VENUES> m_venueNames;
+  std::array<std::atomic<bool>, MAX_ROUTING_VENUES> m_venueActive{};
+  std::array<execution::VenueId, MAX_ROUTING_VENUES> m_lifecycleVenues{};
+  std::atomic<size_t> m_venueCount{0};
+
+  /**
+   * @brief Shared lifecycle records for dispatched child orders
+   */
+  execution::OrderLifecycleManager& m_lifecycle{
+      execution::OrderLifecycleManager::getInstance()};
+
+  /**
+   * @brief Per-venue round-trip and feed delay estimates, indexed like the
+   * quote tables
+   */
+  VenueLatencyModel m_latencyModel;
+
+  /**
+   * @brief Quote tables: one per symbol plus a symbol-agnostic fallback
+   */
+  std::unordered_map<std::string, std::unique_ptr<VenueQuoteTable>>
+      m_quoteTables;
+  mutable std::shared_mutex m_quoteTablesMutex;
+  VenueQuoteTable m_defaultQuotes;
+
+  /**
+   * @brief L2 depth tables, one per symbol
+   */
+  std::unordered_map<std::string, std::unique_ptr<VenueDepthTable>>
+      m_depthTables;
+  mutable std::shared_mutex m_depthTablesMutex;
+
   /**
    * @brief Active execution requests
    */
   struct ActiveExecution {
     ExecutionRequest originalRequest;
-    std::vector<ExecutionRequest> childRequests;
+    size_t expectedChildren{0};
     std::vector<ExecutionResult> results;
     uint64_t startTime;
+    TimeoutWheel::TimerId timeoutTimer{TimeoutWheel::INVALID_TIMER};
+    bool childDispatched{false}; // For submit-to-first-child latency
     std::atomic<bool> isComplete{false};
 
     // Default constructor
@@ -284,16 +545,20 @@ private:
     // Move constructor and assignment
     ActiveExecution(ActiveExecution&& other) noexcept
         : originalRequest(std::move(other.originalRequest)),
-          childRequests(std::move(other.childRequests)),
+          expectedChildren(other.expectedChildren),
           results(std::move(other.results)), startTime(other.startTime),
+          timeoutTimer(other.timeoutTimer),
+          childDispatched(other.childDispatched),
           isComplete(other.isComplete.load()) {}
 
     ActiveExecution& operator=(ActiveExecution&& other) noexcept {
       if (this != &other) {
         originalRequest = std::move(other.originalRequest);
-        childRequests = std::move(other.childRequests);
+        expectedChildren = other.expectedChildren;
         results = std::move(other.results);
         startTime = other.startTime;
+        timeoutTimer = other.timeoutTimer;
+        childDispatched = other.childDispatched;
         isComplete = other.isComplete.load();
       }
       return *this;
@@ -315,21 +580,71 @@ private:
   std::string m_currentStrategy{"BEST_PRICE"};
 
   /**
-   * @brief Execution threads and queues
+   * @brief Pipeline stages
+   *
+   * submitOrder -> intake ring -> planning -> dispatch -> fill aggregation.
+   * Each stage owns one thread and parks on its input queue when idle.
+   */
+  std::thread m_planningThread;
+  std::thread m_dispatchThread;
+  std::thread m_aggregationThread;
+
+  struct PipelineOrder {
+    ExecutionRequest request;
+    uint64_t submitTime{0};
+    bool isFirstChild{false};
+  };
+
+  struct PipelineEvent {
+    enum class Type { PLANNED, FILL, CANCEL, DROPPED };
+
+    Type type{Type::FILL};
+    std::string requestId; // Parent request
+    size_t childCount{0};
+    ExecutionResult result;
+  };
+
+  utils::BlockingMPMCQueue<PipelineOrder, 1024> m_intakeQueue;
+  utils::BlockingMPMCQueue<PipelineOrder, 4096> m_dispatchQueue;
+  utils::BlockingMPMCQueue<PipelineEvent, 4096> m_aggregationQueue;
+
+  /**
+   * @brief Quote and depth snapshots reused by the planning stage
+   */
+  VenueQuoteSnapshot m_planningQuotes;
+  VenueDepthSnapshot m_planningDepth;
+
+  /**
+   * @brief Time-sliced children awaiting release, owned by the planning stage
    */
-  std::thread m_routingThread;
-  std::thread m_executionThread;
-  std::thread m_monitoringThread;
+  ExecutionScheduler m_scheduler;
 
-  utils::LockFreeMPMCQueue<ExecutionRequest, 1024> m_executionQueue;
-  utils::LockFreeMPMCQueue<std::string, 256> m_cancelQueue;
+  /**
+   * @brief Execution timeouts, owned by the aggregation stage
+   */
+  TimeoutWheel m_timeoutWheel;
 
   /**
-   * @brief Execution callback
+   * @brief Execution callbacks
    */
   std::function<void(const ExecutionResult&)> m_executionCallback;
+  std::function<void(const ExecutionRequest&)> m_childOrderCallback;
+  OrderSender m_orderSender;
   std::mutex m_callbackMutex;
 
+  /**
+   * @brief Children handed to the order sender and not yet terminal
+   */
+  struct InFlightChild {
+    std::string requestId;
+    std::string parentRequestId;
+    std::string orderId;
+    std::string venue;
+  };
+
+  std::unordered_map<execution::OrderHandle, InFlightChild> m_inFlight;
+  std::mutex m_inFlightMutex;
+
   /**
    * @brief Statistics
    */
@@ -342,6 +657,10 @@ private:
     double avgExecutionTime{0.0}; // milliseconds
     double bestFillRate{
         0.0}; // percentage of orders getting best available price
+    uint64_t timedOutExecutions{0};
+    uint64_t firstChildSamples{0};
+    double avgFirstChildLatency{0.0}; // microseconds, submit -> first child
+    double maxFirstChildLatency{0.0}; // microseconds
   };
 
   Statistics m_stats;
@@ -350,13 +669,32 @@ private:
   /**
    * @brief Internal methods
    */
-  void routingThreadLoop();
-  void executionThreadLoop();
-  void monitoringThreadLoop();
+  void planningThreadLoop();
+  void dispatchThreadLoop();
+  void aggregationThreadLoop();
+
+  void planRequest(PipelineOrder& pending);
+  void releaseScheduledChild(ExecutionRequest&& child);
+  void dropScheduledChild(const ExecutionRequest& child);
+  void handlePipelineEvent(PipelineEvent& event);
+  void handleTimeout(const std::string& requestId);
+  void recordFirstChildLatency(uint64_t latencyNanos);
+
+  template <typename Queue, typename Item>
+  bool enqueueWithBackpressure(Queue& queue, Item&& item);
 
   VenueConnection* selectBestVenue(const ExecutionRequest& request);
-  std::vector<MarketData> getAllMarketData(const std::string& symbol);
+  size_t findVenueIndex(const std::string& venue) const;
+  VenueQuoteTable* findQuoteTable(const std::string& symbol) const;
+  VenueQuoteTable& getOrCreateQuoteTable(const std::string& symbol);
+  void snapshotQuotes(const std::string& symbol, VenueQuoteSnapshot& out);
+  double observedVolume(const std::string& venue,
+                        const std::string& symbol) const;
+  void snapshotDepth(const std::string& symbol,
+                     const VenueQuoteSnapshot& quotes,
+                     VenueDepthSnapshot& out) const;
   void executeOrder(const ExecutionRequest& request);
+  void sendOrder(const ExecutionRequest& request, const OrderSender& sender);
   void updateExecutionResult(const ExecutionResult& result);
 
   double calculateMarketImpact(const ExecutionRequest& request,
@@ -367,6 +705,8 @@ private:
   void initializeStrategies();
   void processCompletedExecution(const std::string& requestId);
 
+  static ExecutionRequest cloneRequest(const ExecutionRequest& request);
+
   /**
    * @brief Exchange connectors
    */
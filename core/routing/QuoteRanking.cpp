@@ -0,0 +1,110 @@
+#include "QuoteRanking.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+namespace {
+
+// Reduce the column to its extreme value. NaN lanes never win: the x86
+// min/max instructions return the second operand when either is NaN, and
+// the NEON *nm variants ignore NaN inputs.
+double reduceMin(const double* values, size_t n) {
+  constexpr double INF = std::numeric_limits<double>::infinity();
+  size_t i = 0;
+  double best = INF;
+
+#if defined(__AVX__)
+  __m256d acc = _mm256_set1_pd(INF);
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm256_min_pd(_mm256_loadu_pd(values + i), acc);
+  }
+  __m128d half = _mm_min_pd(_mm256_castpd256_pd128(acc),
+                            _mm256_extractf128_pd(acc, 1));
+  half = _mm_min_sd(half, _mm_unpackhi_pd(half, half));
+  best = _mm_cvtsd_f64(half);
+#elif defined(__aarch64__)
+  float64x2_t acc = vdupq_n_f64(INF);
+  for (; i + 2 <= n; i += 2) {
+    acc = vminnmq_f64(acc, vld1q_f64(values + i));
+  }
+  best = vminnmvq_f64(acc);
+#endif
+
+  for (; i < n; ++i) {
+    if (values[i] < best) {
+      best = values[i];
+    }
+  }
+  return best;
+}
+
+double reduceMax(const double* values, size_t n) {
+  constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
+  size_t i = 0;
+  double best = NEG_INF;
+
+#if defined(__AVX__)
+  __m256d acc = _mm256_set1_pd(NEG_INF);
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm256_max_pd(_mm256_loadu_pd(values + i), acc);
+  }
+  __m128d half = _mm_max_pd(_mm256_castpd256_pd128(acc),
+                            _mm256_extractf128_pd(acc, 1));
+  half = _mm_max_sd(half, _mm_unpackhi_pd(half, half));
+  best = _mm_cvtsd_f64(half);
+#elif defined(__aarch64__)
+  float64x2_t acc = vdupq_n_f64(NEG_INF);
+  for (; i + 2 <= n; i += 2) {
+    acc = vmaxnmq_f64(acc, vld1q_f64(values + i));
+  }
+  best = vmaxnmvq_f64(acc);
+#endif
+
+  for (; i < n; ++i) {
+    if (values[i] > best) {
+      best = values[i];
+    }
+  }
+  return best;
+}
+
+// Ties resolve to the lowest index so results match a sequential scan
+size_t firstIndexOf(std::span<const double> values, double target) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i] == target) {
+      return i;
+    }
+  }
+  return NO_VENUE;
+}
+
+} // namespace
+
+size_t argMinVenue(std::span<const double> values) {
+  double best = reduceMin(values.data(), values.size());
+  if (best == std::numeric_limits<double>::infinity()) {
+    return NO_VENUE;
+  }
+  return firstIndexOf(values, best);
+}
+
+size_t argMaxVenue(std::span<const double> values) {
+  double best = reduceMax(values.data(), values.size());
+  if (best == -std::numeric_limits<double>::infinity()) {
+    return NO_VENUE;
+  }
+  return firstIndexOf(values, best);
+}
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
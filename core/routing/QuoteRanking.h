@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+/**
+ * @brief Returned by the ranking helpers when no candidate qualifies
+ */
+constexpr size_t NO_VENUE = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief Index of the smallest finite value (first one on ties)
+ *
+ * Vectorized with AVX2/AVX or NEON when available. Entries set to +infinity
+ * (or NaN) are treated as excluded.
+ *
+ * @return Index of the minimum, or NO_VENUE if every entry is excluded
+ */
+size_t argMinVenue(std::span<const double> values);
+
+/**
+ * @brief Index of the largest finite value (first one on ties)
+ *
+ * Entries set to -infinity (or NaN) are treated as excluded.
+ *
+ * @return Index of the maximum, or NO_VENUE if every entry is excluded
+ */
+size_t argMaxVenue(std::span<const double> values);
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
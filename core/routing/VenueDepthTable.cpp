@@ -0,0 +1,116 @@
+#include "VenueDepthTable.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+namespace {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+} // namespace
+
+VenueDepthTable::VenueDepthTable() {
+  for (auto& book : m_books) {
+    for (Side* side : {&book.bids, &book.asks}) {
+      for (size_t i = 0; i < MAX_DEPTH_LEVELS; ++i) {
+        side->price[i].store(0.0, std::memory_order_relaxed);
+        side->size[i].store(0.0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+void VenueDepthTable::store(Side& side, std::span<const double> prices,
+                            std::span<const double> sizes) {
+  size_t levels = std::min({prices.size(), sizes.size(), MAX_DEPTH_LEVELS});
+  for (size_t i = 0; i < levels; ++i) {
+    side.price[i].store(prices[i], std::memory_order_relaxed);
+    side.size[i].store(sizes[i], std::memory_order_relaxed);
+  }
+  side.levels.store(levels, std::memory_order_relaxed);
+}
+
+void VenueDepthTable::load(const Side& side, DepthLadder& out) {
+  size_t levels =
+      std::min(side.levels.load(std::memory_order_relaxed), MAX_DEPTH_LEVELS);
+  for (size_t i = 0; i < levels; ++i) {
+    out.price[i] = side.price[i].load(std::memory_order_relaxed);
+    out.size[i] = side.size[i].load(std::memory_order_relaxed);
+  }
+  out.levels = levels;
+}
+
+void VenueDepthTable::publish(size_t venueIndex,
+                              std::span<const double> bidPrices,
+                              std::span<const double> bidSizes,
+                              std::span<const double> askPrices,
+                              std::span<const double> askSizes) {
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return;
+  }
+
+  auto& sequence = m_sequence[venueIndex].value;
+
+  uint64_t seq = sequence.load(std::memory_order_relaxed);
+  for (;;) {
+    if ((seq & 1) == 0 &&
+        sequence.compare_exchange_weak(seq, seq + 1,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+      break;
+    }
+    cpuRelax();
+    seq = sequence.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  store(m_books[venueIndex].bids, bidPrices, bidSizes);
+  store(m_books[venueIndex].asks, askPrices, askSizes);
+
+  sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool VenueDepthTable::read(size_t venueIndex, DepthLadder& bids,
+                           DepthLadder& asks) const {
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return false;
+  }
+
+  const auto& sequence = m_sequence[venueIndex].value;
+
+  for (;;) {
+    uint64_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      cpuRelax();
+      continue;
+    }
+    if (before == 0) {
+      return false; // Never published
+    }
+
+    load(m_books[venueIndex].bids, bids);
+    load(m_books[venueIndex].asks, asks);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+}
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "VenueQuoteTable.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+/**
+ * @brief Maximum number of L2 levels kept per venue and side
+ */
+constexpr size_t MAX_DEPTH_LEVELS = 64;
+
+/**
+ * @brief One side of a venue's L2 book, best level first
+ */
+struct DepthLadder {
+  size_t levels{0};
+  alignas(64) std::array<double, MAX_DEPTH_LEVELS> price;
+  alignas(64) std::array<double, MAX_DEPTH_LEVELS> size;
+
+  std::span<const double> prices() const { return {price.data(), levels}; }
+  std::span<const double> sizes() const { return {size.data(), levels}; }
+};
+
+/**
+ * @brief L2 depth for every row of a VenueQuoteSnapshot
+ *
+ * Row i of bids/asks belongs to the venue in row i of the quote snapshot it
+ * was taken alongside. A ladder with zero levels means no depth is known for
+ * that venue and callers should fall back to its top of book.
+ */
+struct VenueDepthSnapshot {
+  std::array<DepthLadder, MAX_ROUTING_VENUES> bids;
+  std::array<DepthLadder, MAX_ROUTING_VENUES> asks;
+};
+
+/**
+ * @class VenueDepthTable
+ * @brief Per-symbol, venue-indexed L2 depth published through seqlocks
+ *
+ * Same layout and publication protocol as VenueQuoteTable, with a
+ * fixed-capacity price/size ladder per venue and side. Levels beyond
+ * MAX_DEPTH_LEVELS are dropped on publish.
+ */
+class VenueDepthTable {
+public:
+  VenueDepthTable();
+
+  VenueDepthTable(const VenueDepthTable&) = delete;
+  VenueDepthTable& operator=(const VenueDepthTable&) = delete;
+
+  /**
+   * @brief Publish a venue's book, best level first on each side
+   */
+  void publish(size_t venueIndex, std::span<const double> bidPrices,
+               std::span<const double> bidSizes,
+               std::span<const double> askPrices,
+               std::span<const double> askSizes);
+
+  /**
+   * @brief Copy one venue's book
+   *
+   * @return false if the venue has never been published
+   */
+  bool read(size_t venueIndex, DepthLadder& bids, DepthLadder& asks) const;
+
+private:
+  struct alignas(64) Sequence {
+    std::atomic<uint64_t> value{0};
+  };
+
+  struct Side {
+    std::atomic<size_t> levels{0};
+    std::array<std::atomic<double>, MAX_DEPTH_LEVELS> price;
+    std::array<std::atomic<double>, MAX_DEPTH_LEVELS> size;
+  };
+
+  struct alignas(64) Book {
+    Side bids;
+    Side asks;
+  };
+
+  static void store(Side& side, std::span<const double> prices,
+                    std::span<const double> sizes);
+  static void load(const Side& side, DepthLadder& out);
+
+  std::array<Sequence, MAX_ROUTING_VENUES> m_sequence;
+  std::array<Book, MAX_ROUTING_VENUES> m_books;
+};
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
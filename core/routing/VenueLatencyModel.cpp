@@ -0,0 +1,162 @@
+#include "VenueLatencyModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+namespace {
+
+// Exchange-to-receive delays beyond this are clock mismatches (a feed
+// stamping with a non-epoch clock), not latency
+constexpr uint64_t MAX_FEED_DELAY_NANOS = 60'000'000'000ULL;
+
+} // namespace
+
+// =============================================================================
+// EwmaEstimator
+// =============================================================================
+
+void EwmaEstimator::update(double sample) {
+  if (m_count.fetch_add(1, std::memory_order_relaxed) == 0) {
+    m_mean.store(sample, std::memory_order_relaxed);
+    return;
+  }
+
+  double mean = m_mean.load(std::memory_order_relaxed);
+  double diff;
+  double next;
+  do {
+    diff = sample - mean;
+    next = mean + m_alpha * diff;
+  } while (!m_mean.compare_exchange_weak(mean, next,
+                                         std::memory_order_relaxed));
+
+  double variance = m_variance.load(std::memory_order_relaxed);
+  double nextVariance;
+  do {
+    nextVariance = (1.0 - m_alpha) * (variance + m_alpha * diff * diff);
+  } while (!m_variance.compare_exchange_weak(variance, nextVariance,
+                                             std::memory_order_relaxed));
+}
+
+void EwmaEstimator::reset() {
+  m_mean.store(0.0, std::memory_order_relaxed);
+  m_variance.store(0.0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_relaxed);
+}
+
+// =============================================================================
+// QuantileEstimator
+// =============================================================================
+
+void QuantileEstimator::update(double sample, double scale) {
+  if (!m_seeded.load(std::memory_order_acquire)) {
+    m_value.store(sample, std::memory_order_relaxed);
+    m_seeded.store(true, std::memory_order_release);
+    return;
+  }
+
+  double step = m_rate * scale;
+  double value = m_value.load(std::memory_order_relaxed);
+  double next;
+  do {
+    next = sample > value ? value + m_quantile * step
+                          : value - (1.0 - m_quantile) * step;
+    next = std::max(next, 0.0);
+  } while (
+      !m_value.compare_exchange_weak(value, next, std::memory_order_relaxed));
+}
+
+void QuantileEstimator::reset() {
+  m_seeded.store(false, std::memory_order_release);
+  m_value.store(0.0, std::memory_order_relaxed);
+}
+
+// =============================================================================
+// VenueLatencyModel
+// =============================================================================
+
+void VenueLatencyModel::recordRoundTrip(size_t venueIndex, uint64_t nanos) {
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return;
+  }
+
+  VenueStats& stats = m_venues[venueIndex];
+  double sample = static_cast<double>(nanos);
+  stats.roundTrip.update(sample);
+
+  // Step by the stream's own spread, floored at a fraction of the mean so
+  // a perfectly steady venue still converges
+  double scale = std::max(std::sqrt(stats.roundTrip.variance()),
+                          0.05 * stats.roundTrip.mean());
+  stats.roundTripP90.update(sample, scale);
+}
+
+void VenueLatencyModel::recordQuote(size_t venueIndex,
+                                    uint64_t exchangeTimestamp,
+                                    uint64_t wallClockNanos) {
+  if (venueIndex >= MAX_ROUTING_VENUES || exchangeTimestamp == 0) {
+    return;
+  }
+
+  // Exchange clocks running ahead of ours count as zero delay
+  uint64_t delay = wallClockNanos > exchangeTimestamp
+                       ? wallClockNanos - exchangeTimestamp
+                       : 0;
+  if (delay > MAX_FEED_DELAY_NANOS) {
+    return;
+  }
+  m_venues[venueIndex].feedDelay.update(static_cast<double>(delay));
+}
+
+double VenueLatencyModel::latencyMicros(size_t venueIndex,
+                                        double fallbackMicros) const {
+  if (venueIndex >= MAX_ROUTING_VENUES ||
+      m_venues[venueIndex].roundTripP90.empty()) {
+    return fallbackMicros;
+  }
+  return m_venues[venueIndex].roundTripP90.value() / 1000.0;
+}
+
+double VenueLatencyModel::stalenessMicros(size_t venueIndex,
+                                          uint64_t ageNanos,
+                                          double updateIntervalMicros) const {
+  double excessAge =
+      std::max(static_cast<double>(ageNanos) / 1000.0 - updateIntervalMicros,
+               0.0);
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return excessAge;
+  }
+  return m_venues[venueIndex].feedDelay.mean() / 1000.0 + excessAge;
+}
+
+VenueLatencyEstimate VenueLatencyModel::estimate(size_t venueIndex) const {
+  VenueLatencyEstimate result;
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return result;
+  }
+
+  const VenueStats& stats = m_venues[venueIndex];
+  result.roundTripSamples = stats.roundTrip.count();
+  result.roundTripMeanMicros = stats.roundTrip.mean() / 1000.0;
+  result.roundTripP90Micros = stats.roundTripP90.value() / 1000.0;
+  result.feedDelaySamples = stats.feedDelay.count();
+  result.feedDelayMeanMicros = stats.feedDelay.mean() / 1000.0;
+  return result;
+}
+
+void VenueLatencyModel::reset(size_t venueIndex) {
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return;
+  }
+  m_venues[venueIndex].roundTrip.reset();
+  m_venues[venueIndex].roundTripP90.reset();
+  m_venues[venueIndex].feedDelay.reset();
+}
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
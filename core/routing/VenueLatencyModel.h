@@ -0,0 +1,147 @@
+#pragma once
+
+#include "VenueQuoteTable.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+/**
+ * @class EwmaEstimator
+ * @brief Lock-free exponentially weighted mean and variance
+ *
+ * Any number of threads may update concurrently; each update is a CAS on
+ * the mean followed by one on the variance, so a reader can see the two
+ * from different updates, which is harmless for an estimator. The first
+ * sample seeds the mean.
+ */
+class EwmaEstimator {
+public:
+  explicit EwmaEstimator(double alpha = 0.125) : m_alpha(alpha) {}
+
+  void update(double sample);
+
+  double mean() const { return m_mean.load(std::memory_order_relaxed); }
+
+  double variance() const {
+    return m_variance.load(std::memory_order_relaxed);
+  }
+
+  uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+  void reset();
+
+private:
+  double m_alpha;
+  std::atomic<double> m_mean{0.0};
+  std::atomic<double> m_variance{0.0};
+  std::atomic<uint64_t> m_count{0};
+};
+
+/**
+ * @class QuantileEstimator
+ * @brief Lock-free streaming quantile by stochastic approximation
+ *
+ * Each sample nudges the estimate up by q * step when it lands above and
+ * down by (1 - q) * step otherwise, which converges to the q-quantile of a
+ * slowly drifting distribution in O(1) space. The step is scaled by the
+ * caller (typically by the stream's EWMA deviation) so the estimator tracks
+ * nanosecond and millisecond streams alike.
+ */
+class QuantileEstimator {
+public:
+  QuantileEstimator(double quantile, double rate = 0.05)
+      : m_quantile(quantile), m_rate(rate) {}
+
+  void update(double sample, double scale);
+
+  double value() const { return m_value.load(std::memory_order_relaxed); }
+
+  bool empty() const { return !m_seeded.load(std::memory_order_acquire); }
+
+  void reset();
+
+private:
+  double m_quantile;
+  double m_rate;
+  std::atomic<double> m_value{0.0};
+  std::atomic<bool> m_seeded{false};
+};
+
+/**
+ * @brief Latency figures for one venue, for diagnostics
+ */
+struct VenueLatencyEstimate {
+  uint64_t roundTripSamples{0};
+  double roundTripMeanMicros{0.0};
+  double roundTripP90Micros{0.0};
+  uint64_t feedDelaySamples{0};
+  double feedDelayMeanMicros{0.0};
+};
+
+/**
+ * @class VenueLatencyModel
+ * @brief Per-venue order round-trip and market data delay estimators
+ *
+ * Indexed by the router's venue index. Order acknowledgements feed an EWMA
+ * and a p90 sketch of new-to-ack round trip; quotes that carry an exchange
+ * timestamp feed an EWMA of exchange-to-receive delay. Writers are the I/O
+ * threads and update through CAS loops; planners read with plain atomic
+ * loads. Neither side takes a lock.
+ */
+class VenueLatencyModel {
+public:
+  /**
+   * @brief Record a measured new-to-ack round trip
+   */
+  void recordRoundTrip(size_t venueIndex, uint64_t nanos);
+
+  /**
+   * @brief Record a quote's arrival
+   *
+   * @param exchangeTimestamp Exchange send time in nanoseconds since the
+   * Unix epoch; 0 when the feed does not provide one
+   * @param wallClockNanos Local wall-clock receive time, same epoch
+   */
+  void recordQuote(size_t venueIndex, uint64_t exchangeTimestamp,
+                   uint64_t wallClockNanos);
+
+  /**
+   * @brief Planning latency for a venue: p90 round trip once measured
+   *
+   * @return fallbackMicros if no round trip has been recorded
+   */
+  double latencyMicros(size_t venueIndex, double fallbackMicros) const;
+
+  /**
+   * @brief Expected staleness of a quote received ageNanos ago
+   *
+   * Feed delay plus the part of the quote's age beyond the row's usual
+   * update interval. A quote younger than its typical update gap is as
+   * fresh as the feed allows; older than that, updates are likely missing.
+   */
+  double stalenessMicros(size_t venueIndex, uint64_t ageNanos,
+                         double updateIntervalMicros) const;
+
+  VenueLatencyEstimate estimate(size_t venueIndex) const;
+
+  void reset(size_t venueIndex);
+
+private:
+  struct alignas(64) VenueStats {
+    EwmaEstimator roundTrip;
+    QuantileEstimator roundTripP90{0.9};
+    EwmaEstimator feedDelay;
+  };
+
+  std::array<VenueStats, MAX_ROUTING_VENUES> m_venues;
+};
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
@@ -0,0 +1,226 @@
+#include "VenueQuoteTable.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+namespace {
+
+// Weight of the newest gap in the update interval EWMA
+constexpr double UPDATE_INTERVAL_ALPHA = 0.125;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+} // namespace
+
+// =============================================================================
+// VenueQuoteView / VenueQuoteSnapshot
+// =============================================================================
+
+MarketData VenueQuoteView::at(size_t index) const {
+  MarketData data;
+  data.venue = std::string(venue[index]);
+  data.bidPrice = bidPrice[index];
+  data.askPrice = askPrice[index];
+  data.bidSize = bidSize[index];
+  data.askSize = askSize[index];
+  data.timestamp = timestamp[index];
+  data.averageDailyVolume = averageDailyVolume[index];
+  data.recentVolume = recentVolume[index];
+  data.impactCost = impactCost[index];
+  data.fees = fees[index];
+  data.cumulativeVolume = cumulativeVolume[index];
+  data.latencyMicros = latencyMicros[index];
+  return data;
+}
+
+bool VenueQuoteSnapshot::append(std::string_view venueName,
+                                const MarketData& data) {
+  if (count >= MAX_ROUTING_VENUES) {
+    return false;
+  }
+
+  size_t i = count++;
+  venue[i] = venueName;
+  bidPrice[i] = data.bidPrice;
+  askPrice[i] = data.askPrice;
+  bidSize[i] = data.bidSize;
+  askSize[i] = data.askSize;
+  fees[i] = data.fees;
+  impactCost[i] = data.impactCost;
+  recentVolume[i] = data.recentVolume;
+  averageDailyVolume[i] = data.averageDailyVolume;
+  cumulativeVolume[i] = data.cumulativeVolume;
+  latencyMicros[i] = data.latencyMicros;
+  updateIntervalMicros[i] = 0.0;
+  stalenessMicros[i] = 0.0;
+  sourceIndex[i] = i;
+  timestamp[i] = data.timestamp;
+  return true;
+}
+
+void VenueQuoteSnapshot::assign(const std::vector<MarketData>& marketData) {
+  clear();
+  for (const auto& data : marketData) {
+    if (!append(data.venue, data)) {
+      break;
+    }
+  }
+}
+
+VenueQuoteView VenueQuoteSnapshot::view() const {
+  VenueQuoteView v;
+  v.venue = std::span<const std::string_view>(venue.data(), count);
+  v.bidPrice = std::span<const double>(bidPrice.data(), count);
+  v.askPrice = std::span<const double>(askPrice.data(), count);
+  v.bidSize = std::span<const double>(bidSize.data(), count);
+  v.askSize = std::span<const double>(askSize.data(), count);
+  v.fees = std::span<const double>(fees.data(), count);
+  v.impactCost = std::span<const double>(impactCost.data(), count);
+  v.recentVolume = std::span<const double>(recentVolume.data(), count);
+  v.averageDailyVolume =
+      std::span<const double>(averageDailyVolume.data(), count);
+  v.cumulativeVolume = std::span<const double>(cumulativeVolume.data(), count);
+  v.latencyMicros = std::span<const double>(latencyMicros.data(), count);
+  v.updateIntervalMicros =
+      std::span<const double>(updateIntervalMicros.data(), count);
+  v.stalenessMicros = std::span<const double>(stalenessMicros.data(), count);
+  v.timestamp = std::span<const uint64_t>(timestamp.data(), count);
+  return v;
+}
+
+// =============================================================================
+// VenueQuoteTable
+// =============================================================================
+
+VenueQuoteTable::VenueQuoteTable() {
+  for (size_t i = 0; i < MAX_ROUTING_VENUES; ++i) {
+    m_bidPrice[i].store(0.0, std::memory_order_relaxed);
+    m_askPrice[i].store(0.0, std::memory_order_relaxed);
+    m_bidSize[i].store(0.0, std::memory_order_relaxed);
+    m_askSize[i].store(0.0, std::memory_order_relaxed);
+    m_fees[i].store(0.0, std::memory_order_relaxed);
+    m_impactCost[i].store(0.0, std::memory_order_relaxed);
+    m_recentVolume[i].store(0.0, std::memory_order_relaxed);
+    m_averageDailyVolume[i].store(0.0, std::memory_order_relaxed);
+    m_cumulativeVolume[i].store(0.0, std::memory_order_relaxed);
+    m_latencyMicros[i].store(0.0, std::memory_order_relaxed);
+    m_updateInterval[i].store(0.0, std::memory_order_relaxed);
+    m_timestamp[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void VenueQuoteTable::publish(size_t venueIndex, const MarketData& data,
+                              uint64_t timestamp) {
+  if (venueIndex >= MAX_ROUTING_VENUES) {
+    return;
+  }
+
+  auto& sequence = m_sequence[venueIndex].value;
+
+  // Claim the row by moving the counter from even to odd; this also
+  // serializes concurrent publishers of the same venue
+  uint64_t seq = sequence.load(std::memory_order_relaxed);
+  for (;;) {
+    if ((seq & 1) == 0 &&
+        sequence.compare_exchange_weak(seq, seq + 1,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+      break;
+    }
+    cpuRelax();
+    seq = sequence.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  m_bidPrice[venueIndex].store(data.bidPrice, std::memory_order_relaxed);
+  m_askPrice[venueIndex].store(data.askPrice, std::memory_order_relaxed);
+  m_bidSize[venueIndex].store(data.bidSize, std::memory_order_relaxed);
+  m_askSize[venueIndex].store(data.askSize, std::memory_order_relaxed);
+  m_fees[venueIndex].store(data.fees, std::memory_order_relaxed);
+  m_impactCost[venueIndex].store(data.impactCost, std::memory_order_relaxed);
+  m_recentVolume[venueIndex].store(data.recentVolume,
+                                   std::memory_order_relaxed);
+  m_averageDailyVolume[venueIndex].store(data.averageDailyVolume,
+                                         std::memory_order_relaxed);
+  m_cumulativeVolume[venueIndex].store(data.cumulativeVolume,
+                                       std::memory_order_relaxed);
+  m_latencyMicros[venueIndex].store(data.latencyMicros,
+                                    std::memory_order_relaxed);
+
+  // The row is exclusively ours while the counter is odd
+  uint64_t previous = m_timestamp[venueIndex].load(std::memory_order_relaxed);
+  if (previous != 0 && timestamp > previous) {
+    double gap = static_cast<double>(timestamp - previous);
+    double interval =
+        m_updateInterval[venueIndex].load(std::memory_order_relaxed);
+    interval = interval == 0.0
+                   ? gap
+                   : interval + UPDATE_INTERVAL_ALPHA * (gap - interval);
+    m_updateInterval[venueIndex].store(interval, std::memory_order_relaxed);
+  }
+  m_timestamp[venueIndex].store(timestamp, std::memory_order_relaxed);
+
+  sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool VenueQuoteTable::read(size_t venueIndex, VenueQuoteSnapshot& out,
+                           size_t slot) const {
+  if (venueIndex >= MAX_ROUTING_VENUES || slot >= MAX_ROUTING_VENUES) {
+    return false;
+  }
+
+  const auto& sequence = m_sequence[venueIndex].value;
+
+  for (;;) {
+    uint64_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      cpuRelax();
+      continue;
+    }
+    if (before == 0) {
+      return false; // Never published
+    }
+
+    out.bidPrice[slot] = m_bidPrice[venueIndex].load(std::memory_order_relaxed);
+    out.askPrice[slot] = m_askPrice[venueIndex].load(std::memory_order_relaxed);
+    out.bidSize[slot] = m_bidSize[venueIndex].load(std::memory_order_relaxed);
+    out.askSize[slot] = m_askSize[venueIndex].load(std::memory_order_relaxed);
+    out.fees[slot] = m_fees[venueIndex].load(std::memory_order_relaxed);
+    out.impactCost[slot] =
+        m_impactCost[venueIndex].load(std::memory_order_relaxed);
+    out.recentVolume[slot] =
+        m_recentVolume[venueIndex].load(std::memory_order_relaxed);
+    out.averageDailyVolume[slot] =
+        m_averageDailyVolume[venueIndex].load(std::memory_order_relaxed);
+    out.cumulativeVolume[slot] =
+        m_cumulativeVolume[venueIndex].load(std::memory_order_relaxed);
+    out.latencyMicros[slot] =
+        m_latencyMicros[venueIndex].load(std::memory_order_relaxed);
+    out.updateIntervalMicros[slot] =
+        m_updateInterval[venueIndex].load(std::memory_order_relaxed) / 1000.0;
+    out.stalenessMicros[slot] = 0.0;
+    out.timestamp[slot] =
+        m_timestamp[venueIndex].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == before) {
+      out.sourceIndex[slot] = venueIndex;
+      return true;
+    }
+  }
+}
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
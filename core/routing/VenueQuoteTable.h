@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace core {
+namespace routing {
+
+/**
+ * @brief Market data snapshot for routing decisions
+ */
+struct MarketData {
+  std::string venue;
+  double bidPrice{0.0};
+  double askPrice{0.0};
+  double bidSize{0.0};
+  double askSize{0.0};
+  uint64_t timestamp{0}; // Exchange send time, ns since epoch (0 if unknown)
+  double averageDailyVolume{0.0};
+  double recentVolume{0.0};
+  double impactCost{0.0};       // Estimated market impact
+  double fees{0.0};             // Trading fees for this venue
+  double cumulativeVolume{0.0}; // Traded volume since session start (feed)
+  double latencyMicros{0.0};    // Estimated order-to-venue latency
+};
+
+struct VenueDepthSnapshot;
+
+/**
+ * @brief Maximum number of venues a router can index
+ */
+constexpr size_t MAX_ROUTING_VENUES = 32;
+
+/**
+ * @brief Read-only structure-of-arrays view over venue quotes
+ *
+ * Every span has size() elements and index i refers to the same venue in each
+ * array, so ranking code can run straight over contiguous columns.
+ */
+struct VenueQuoteView {
+  std::span<const std::string_view> venue;
+  std::span<const double> bidPrice;
+  std::span<const double> askPrice;
+  std::span<const double> bidSize;
+  std::span<const double> askSize;
+  std::span<const double> fees;
+  std::span<const double> impactCost;
+  std::span<const double> recentVolume;
+  std::span<const double> averageDailyVolume;
+  std::span<const double> cumulativeVolume;
+  std::span<const double> latencyMicros;
+  std::span<const double> updateIntervalMicros; // Typical gap between quotes
+  std::span<const double> stalenessMicros;      // Expected quote staleness
+  std::span<const uint64_t> timestamp;
+
+  /**
+   * @brief L2 depth aligned with the quote rows, when the caller has it
+   */
+  const VenueDepthSnapshot* depth{nullptr};
+
+  size_t size() const { return venue.size(); }
+  bool empty() const { return venue.empty(); }
+
+  /**
+   * @brief Order latency plus quote staleness for a row, in microseconds
+   *
+   * What strategies discount a venue by: the time until an order lands there
+   * plus how far its quote likely lags the venue's real book.
+   */
+  double delayMicros(size_t index) const {
+    return latencyMicros[index] +
+           (stalenessMicros.empty() ? 0.0 : stalenessMicros[index]);
+  }
+
+  /**
+   * @brief Materialize one venue as a MarketData (allocates the venue name)
+   */
+  MarketData at(size_t index) const;
+};
+
+/**
+ * @brief Fixed-capacity SoA quote snapshot
+ *
+ * Filled by VenueQuoteTable::snapshot() or from a MarketData vector without
+ * touching the heap. Venue names are views into storage owned by the source
+ * (the router's venue registry or the caller's vector) and must not outlive it.
+ */
+struct VenueQuoteSnapshot {
+  size_t count{0};
+  std::array<std::string_view, MAX_ROUTING_VENUES> venue;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> bidPrice;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> askPrice;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> bidSize;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> askSize;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> fees;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> impactCost;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> recentVolume;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> averageDailyVolume;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> cumulativeVolume;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> latencyMicros;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> updateIntervalMicros;
+  alignas(64) std::array<double, MAX_ROUTING_VENUES> stalenessMicros;
+  alignas(64) std::array<uint64_t, MAX_ROUTING_VENUES> timestamp;
+
+  // Venue index each row was read from (the row number when assigned from a
+  // vector); used to line up other per-venue tables with the rows
+  std::array<size_t, MAX_ROUTING_VENUES> sourceIndex;
+
+  /**
+   * @brief Reset to an empty snapshot
+   */
+  void clear() { count = 0; }
+
+  /**
+   * @brief Append one venue; returns false once capacity is exhausted
+   */
+  bool append(std::string_view venueName, const MarketData& data);
+
+  /**
+   * @brief Load from a MarketData vector (extra venues beyond capacity are
+   * dropped)
+   */
+  void assign(const std::vector<MarketData>& marketData);
+
+  /**
+   * @brief View over the populated prefix of every column
+   */
+  VenueQuoteView view() const;
+};
+
+/**
+ * @class VenueQuoteTable
+ * @brief Per-symbol, venue-indexed quote table published through seqlocks
+ *
+ * Columns are stored as arrays indexed by the router-assigned venue index.
+ * Each venue row is guarded by its own sequence counter: publish() makes the
+ * counter odd, writes the row and makes it even again, while readers copy the
+ * row and retry if the counter moved. Readers therefore never block writers or
+ * each other, and a torn row is never observed.
+ *
+ * Fields are stored as relaxed atomics so the seqlock is free of data races;
+ * on x86-64 and AArch64 these compile to plain loads and stores.
+ *
+ * Each publish also folds the gap since the row's previous publish into an
+ * EWMA, giving readers the row's typical update interval.
+ */
+class VenueQuoteTable {
+public:
+  VenueQuoteTable();
+
+  VenueQuoteTable(const VenueQuoteTable&) = delete;
+  VenueQuoteTable& operator=(const VenueQuoteTable&) = delete;
+
+  /**
+   * @brief Publish a quote for a venue
+   *
+   * @param venueIndex Router-assigned venue index (< MAX_ROUTING_VENUES)
+   * @param data Quote fields (venue name is ignored)
+   * @param timestamp Receive time in nanoseconds
+   */
+  void publish(size_t venueIndex, const MarketData& data, uint64_t timestamp);
+
+  /**
+   * @brief Copy one venue row into a snapshot slot
+   *
+   * @return false if the venue has never been published
+   */
+  bool read(size_t venueIndex, VenueQuoteSnapshot& out, size_t slot) const;
+
+  /**
+   * @brief Latest traded volume published for a venue
+   *
+   * A single field needs no seqlock retry, so this is a plain atomic load.
+   */
+  double cumulativeVolume(size_t venueIndex) const {
+    return m_cumulativeVolume[venueIndex].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of publishes seen for a venue (diagnostics)
+   */
+  uint64_t version(size_t venueIndex) const {
+    return m_sequence[venueIndex].value.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  struct alignas(64) Sequence {
+    std::atomic<uint64_t> value{0};
+  };
+
+  using Column = std::array<std::atomic<double>, MAX_ROUTING_VENUES>;
+
+  std::array<Sequence, MAX_ROUTING_VENUES> m_sequence;
+
+  alignas(64) Column m_bidPrice;
+  alignas(64) Column m_askPrice;
+  alignas(64) Column m_bidSize;
+  alignas(64) Column m_askSize;
+  alignas(64) Column m_fees;
+  alignas(64) Column m_impactCost;
+  alignas(64) Column m_recentVolume;
+  alignas(64) Column m_averageDailyVolume;
+  alignas(64) Column m_cumulativeVolume;
+  alignas(64) Column m_latencyMicros;
+  alignas(64) Column m_updateInterval; // EWMA of publish gaps, nanoseconds
+  alignas(64) std::array<std::atomic<uint64_t>, MAX_ROUTING_VENUES> m_timestamp;
+};
+
+} // namespace routing
+} // namespace core
+} // namespace pinnacle
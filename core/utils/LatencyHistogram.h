@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace pinnacle {
+namespace utils {
+
+/**
+ * @class LatencyHistogram
+ * @brief Lock-free log-linear histogram of nanosecond latencies
+ *
+ * Values are bucketed by power of two, with each power split into
+ * SUB_BUCKETS linear sub-buckets, so the relative error of any reported
+ * percentile is bounded by 1/SUB_BUCKETS (12.5%) across the full uint64
+ * range. Recording is a handful of relaxed atomic increments and is safe
+ * from any number of threads; readers see a consistent-enough view for
+ * monitoring without stopping writers.
+ */
+class LatencyHistogram {
+public:
+  static constexpr size_t SUB_BUCKET_BITS = 3;
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) *
+                                         SUB_BUCKETS;
+
+  /**
+   * @brief Record one sample
+   */
+  void record(uint64_t nanos) {
+    m_buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(nanos, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanos > max && !m_max.compare_exchange_weak(
+                              max, nanos, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+  uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+  double mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0
+                  : static_cast<double>(m_sum.load(std::memory_order_relaxed)) /
+                        static_cast<double>(n);
+  }
+
+  /**
+   * @brief Value at or below which the given fraction of samples fall
+   *
+   * @param quantile In [0, 1]
+   * @return Upper bound of the bucket holding the quantile, capped at the
+   * largest recorded sample; 0 when empty
+   */
+  uint64_t percentile(double quantile) const {
+    uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+
+    quantile = quantile < 0.0 ? 0.0 : (quantile > 1.0 ? 1.0 : quantile);
+    uint64_t rank = static_cast<uint64_t>(quantile * (total - 1)) + 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+      seen += m_buckets[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        uint64_t upper = bucketUpperBound(i);
+        uint64_t observedMax = max();
+        return upper < observedMax ? upper : observedMax;
+      }
+    }
+    return max();
+  }
+
+  void reset() {
+    for (auto& bucket : m_buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Bucket index for a value
+   *
+   * Values below SUB_BUCKETS map one-to-one; above that the top
+   * SUB_BUCKET_BITS + 1 significant bits select the bucket.
+   */
+  static size_t bucketFor(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return static_cast<size_t>(value);
+    }
+    size_t msb = 63 - static_cast<size_t>(std::countl_zero(value));
+    size_t shift = msb - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+  }
+
+  /**
+   * @brief Largest value that maps to a bucket
+   */
+  static uint64_t bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+    size_t shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+  std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace utils
+} // namespace pinnacle
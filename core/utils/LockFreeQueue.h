@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace pinnacle {
@@ -401,5 +405,128 @@ public:
   constexpr size_t capacity() const { return Capacity; }
 };
 
+/**
+ * @class BlockingMPMCQueue
+ * @brief LockFreeMPMCQueue with an optional blocking wait for consumers
+ *
+ * Enqueue and dequeue stay lock-free. A consumer that finds the queue empty
+ * may park on a condition variable; producers only touch the mutex when a
+ * consumer is actually parked, so the hot path costs one extra atomic load.
+ *
+ * @tparam T Type of elements stored in the queue
+ * @tparam Capacity Fixed capacity of the queue (must be a power of 2)
+ */
+template <typename T, size_t Capacity> class BlockingMPMCQueue {
+public:
+  BlockingMPMCQueue() = default;
+
+  BlockingMPMCQueue(const BlockingMPMCQueue&) = delete;
+  BlockingMPMCQueue& operator=(const BlockingMPMCQueue&) = delete;
+
+  /**
+   * @brief Try to enqueue an element and wake a parked consumer
+   *
+   * @param data Element to enqueue
+   * @return true if the element was enqueued, false if the queue was full
+   */
+  bool tryEnqueue(const T& data) {
+    if (!m_queue.tryEnqueue(data)) {
+      return false;
+    }
+    notifyOne();
+    return true;
+  }
+
+  /**
+   * @brief Try to enqueue an element (move version)
+   *
+   * @param data Element to enqueue
+   * @return true if the element was enqueued, false if the queue was full
+   */
+  bool tryEnqueue(T&& data) {
+    if (!m_queue.tryEnqueue(std::move(data))) {
+      return false;
+    }
+    notifyOne();
+    return true;
+  }
+
+  /**
+   * @brief Try to dequeue an element without blocking
+   *
+   * @param result Reference to store the dequeued element
+   * @return true if an element was dequeued
+   */
+  bool tryDequeue(T& result) { return m_queue.tryDequeue(result); }
+
+  /**
+   * @brief Dequeue an element, blocking up to the given timeout
+   *
+   * @param result Reference to store the dequeued element
+   * @param timeout Maximum time to wait for an element
+   * @return true if an element was dequeued, false on timeout or wakeAll()
+   */
+  template <typename Rep, typename Period>
+  bool waitDequeue(T& result, std::chrono::duration<Rep, Period> timeout) {
+    if (m_queue.tryDequeue(result)) {
+      return true;
+    }
+
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    uint64_t wakeEpoch = m_wakeEpoch;
+    bool dequeued = false;
+    m_waitCondition.wait_for(lock, timeout, [&] {
+      dequeued = m_queue.tryDequeue(result);
+      return dequeued || m_wakeEpoch != wakeEpoch;
+    });
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+    return dequeued;
+  }
+
+  /**
+   * @brief Wake every parked consumer (used on shutdown)
+   */
+  void wakeAll() {
+    std::lock_guard<std::mutex> lock(m_waitMutex);
+    ++m_wakeEpoch;
+    m_waitCondition.notify_all();
+  }
+
+  /**
+   * @brief Check if the queue is empty (diagnostics only)
+   */
+  bool isEmpty() const { return m_queue.isEmpty(); }
+
+  /**
+   * @brief Get the approximate size of the queue (diagnostics only)
+   */
+  size_t approximateSize() const { return m_queue.approximateSize(); }
+
+  /**
+   * @brief Get the capacity of the queue
+   */
+  constexpr size_t capacity() const { return Capacity; }
+
+private:
+  void notifyOne() {
+    // Pairs with the seq_cst increment in waitDequeue so a consumer that is
+    // about to park either sees the new element or is seen here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(m_waitMutex);
+      m_waitCondition.notify_one();
+    }
+  }
+
+  LockFreeMPMCQueue<T, Capacity> m_queue;
+
+  alignas(64) std::atomic<uint32_t> m_waiters{0};
+  std::mutex m_waitMutex;
+  std::condition_variable m_waitCondition;
+  uint64_t m_wakeEpoch{0};
+};
+
 } // namespace utils
 } // namespace pinnacle
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pinnacle {
+namespace utils {
+
+/**
+ * @class SlabRing
+ * @brief Recycled buffer slabs handed from one producer to one consumer
+ *
+ * The slabs are allocated once and move between the threads by index: the
+ * producer acquires a free slab, fills it in place and publishes it; the
+ * consumer takes published slabs in order and releases them when done.
+ * Free and published indices travel through two SPSC rings sized to the
+ * slab count, so neither can overflow and nothing is copied or allocated
+ * per item. When every slab is published or in use the producer waits in
+ * acquire() until the consumer releases one, which throttles the source
+ * rather than dropping data.
+ *
+ * @tparam Slab Reusable buffer type, e.g. a byte buffer that keeps its
+ * capacity when cleared
+ */
+template <typename Slab> class SlabRing {
+public:
+  static constexpr uint32_t NO_SLAB = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @param slabCount Number of slabs, each default-constructed
+   */
+  explicit SlabRing(size_t slabCount)
+      : m_slabs(slabCount), m_free(slabCount), m_ready(slabCount) {
+    for (uint32_t i = 0; i < slabCount; ++i) {
+      m_free.push(i);
+    }
+  }
+
+  SlabRing(const SlabRing&) = delete;
+  SlabRing& operator=(const SlabRing&) = delete;
+
+  Slab& slab(uint32_t index) { return m_slabs[index]; }
+
+  size_t slabCount() const { return m_slabs.size(); }
+
+  // --- Producer side ---
+
+  /**
+   * @brief Take a free slab, NO_SLAB if all are published or in use
+   */
+  uint32_t tryAcquire() { return m_free.pop(); }
+
+  /**
+   * @brief Take a free slab, waiting for the consumer if there is none
+   *
+   * @param shouldStop Polled while waiting; NO_SLAB is returned once it
+   * reports true
+   */
+  template <typename StopFn> uint32_t acquire(StopFn&& shouldStop) {
+    uint32_t index = m_free.pop();
+    if (index != NO_SLAB) {
+      return index;
+    }
+
+    m_backpressureStalls.fetch_add(1, std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t spins = 0; index == NO_SLAB; ++spins) {
+      if (shouldStop()) {
+        break;
+      }
+      backoff(spins);
+      index = m_free.pop();
+    }
+    m_stallNanos.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        std::memory_order_relaxed);
+    return index;
+  }
+
+  /**
+   * @brief Hand a filled slab to the consumer
+   */
+  void publish(uint32_t index) { m_ready.push(index); }
+
+  // --- Consumer side ---
+
+  /**
+   * @brief Take the oldest published slab, NO_SLAB if there is none
+   */
+  uint32_t tryConsume() { return m_ready.pop(); }
+
+  /**
+   * @brief Take the oldest published slab, waiting for one if necessary
+   *
+   * @param shouldStop Polled while the ring is empty; NO_SLAB is returned
+   * once it reports true, so published slabs are always drained first
+   */
+  template <typename StopFn> uint32_t consume(StopFn&& shouldStop) {
+    uint32_t index = m_ready.pop();
+    for (uint32_t spins = 0; index == NO_SLAB; ++spins) {
+      if (shouldStop()) {
+        return m_ready.pop();
+      }
+      backoff(spins);
+      index = m_ready.pop();
+    }
+    return index;
+  }
+
+  /**
+   * @brief Return a consumed slab to the producer
+   */
+  void release(uint32_t index) { m_free.push(index); }
+
+  // --- Statistics ---
+
+  /**
+   * @brief Slabs published and not yet consumed (approximate)
+   */
+  size_t readyCount() const { return m_ready.size(); }
+
+  /**
+   * @brief Times acquire() found no free slab and had to wait
+   */
+  uint64_t getBackpressureStalls() const {
+    return m_backpressureStalls.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Total time acquire() spent waiting for a free slab
+   */
+  uint64_t getStallNanos() const {
+    return m_stallNanos.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  /**
+   * @brief SPSC ring of slab indices
+   *
+   * Never holds more than the slab count, so push() needs no full check.
+   */
+  class IndexRing {
+  public:
+    explicit IndexRing(size_t count) {
+      size_t capacity = 1;
+      while (capacity < count + 1) {
+        capacity *= 2;
+      }
+      m_indices.resize(capacity, NO_SLAB);
+      m_mask = capacity - 1;
+    }
+
+    void push(uint32_t index) {
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      m_indices[tail & m_mask] = index;
+      m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    uint32_t pop() {
+      size_t head = m_head.load(std::memory_order_relaxed);
+      if (head == m_tail.load(std::memory_order_acquire)) {
+        return NO_SLAB;
+      }
+      uint32_t index = m_indices[head & m_mask];
+      m_head.store(head + 1, std::memory_order_release);
+      return index;
+    }
+
+    size_t size() const {
+      return m_tail.load(std::memory_order_acquire) -
+             m_head.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::vector<uint32_t> m_indices;
+    size_t m_mask{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+  };
+
+  /**
+   * @brief Spin briefly, then yield, then sleep so an idle side costs little
+   */
+  static void backoff(uint32_t spins) {
+    if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+      _mm_pause();
+#elif defined(__aarch64__)
+      __asm__ __volatile__("yield" ::: "memory");
+#endif
+    } else if (spins < 256) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  std::vector<Slab> m_slabs;
+  IndexRing m_free;  // Consumer to producer
+  IndexRing m_ready; // Producer to consumer
+
+  std::atomic<uint64_t> m_backpressureStalls{0};
+  std::atomic<uint64_t> m_stallNanos{0};
+};
+
+} // namespace utils
+} // namespace pinnacle
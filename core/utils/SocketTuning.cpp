@@ -0,0 +1,226 @@
+#include "SocketTuning.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#endif
+
+namespace pinnacle {
+namespace utils {
+
+namespace {
+
+bool setOption(int fd, int level, int option, int value, const char* name) {
+  if (setsockopt(fd, level, option, &value, sizeof(value)) == 0) {
+    return true;
+  }
+  spdlog::warn("Cannot set {} to {} on socket {}: {}", name, value, fd,
+               std::strerror(errno));
+  return false;
+}
+
+int getOption(int fd, int level, int option) {
+  int value = 0;
+  socklen_t length = sizeof(value);
+  if (getsockopt(fd, level, option, &value, &length) != 0) {
+    return -1;
+  }
+  return value;
+}
+
+#ifdef __linux__
+// Layout of the SCM_TIMESTAMPING control message: software, deprecated,
+// raw hardware
+struct Timestamping {
+  timespec ts[3];
+};
+
+// Room for the timestamps and nothing else, suitably aligned
+union ControlBuffer {
+  char data[CMSG_SPACE(sizeof(Timestamping))];
+  cmsghdr align;
+};
+
+uint64_t nanos(const timespec& ts) {
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Hardware time if the NIC stamped the packet, else software
+uint64_t receiveTime(msghdr& header) {
+  for (cmsghdr* c = CMSG_FIRSTHDR(&header); c; c = CMSG_NXTHDR(&header, c)) {
+    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPING) {
+      Timestamping stamps;
+      std::memcpy(&stamps, CMSG_DATA(c), sizeof(stamps));
+      uint64_t hardware = nanos(stamps.ts[2]);
+      return hardware != 0 ? hardware : nanos(stamps.ts[0]);
+    }
+  }
+  return 0;
+}
+#endif
+
+} // namespace
+
+// ============================================================================
+// SocketTuning
+// ============================================================================
+
+SocketTuningReport SocketTuning::apply(int fd,
+                                       const SocketTuningConfig& config) {
+  SocketTuningReport report;
+  bool isStream = getOption(fd, SOL_SOCKET, SO_TYPE) == SOCK_STREAM;
+
+  if (config.noDelay && isStream) {
+    report.noDelay = setOption(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+  }
+  if (config.receiveBufferBytes > 0) {
+    setOption(fd, SOL_SOCKET, SO_RCVBUF, config.receiveBufferBytes,
+              "SO_RCVBUF");
+  }
+  if (config.sendBufferBytes > 0) {
+    setOption(fd, SOL_SOCKET, SO_SNDBUF, config.sendBufferBytes, "SO_SNDBUF");
+  }
+  report.receiveBufferBytes = getOption(fd, SOL_SOCKET, SO_RCVBUF);
+  report.sendBufferBytes = getOption(fd, SOL_SOCKET, SO_SNDBUF);
+
+#ifdef __linux__
+  if (config.busyPollMicros > 0) {
+    report.busyPoll = setOption(fd, SOL_SOCKET, SO_BUSY_POLL,
+                                config.busyPollMicros, "SO_BUSY_POLL");
+  }
+  if (config.kernelTimestamps || config.hardwareTimestamps) {
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (config.hardwareTimestamps) {
+      flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    }
+    report.timestamps =
+        setOption(fd, SOL_SOCKET, SO_TIMESTAMPING, flags, "SO_TIMESTAMPING");
+  }
+#else
+  if (config.busyPollMicros > 0 || config.kernelTimestamps ||
+      config.hardwareTimestamps) {
+    spdlog::warn("Busy polling and kernel timestamps need Linux");
+  }
+#endif
+
+  return report;
+}
+
+SocketPlacement SocketTuning::placement(int fd) {
+  SocketPlacement placement;
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+  placement.incomingCpu = getOption(fd, SOL_SOCKET, SO_INCOMING_CPU);
+#endif
+#if defined(__linux__) && defined(SO_INCOMING_NAPI_ID)
+  int napiId = getOption(fd, SOL_SOCKET, SO_INCOMING_NAPI_ID);
+  placement.napiId = napiId > 0 ? static_cast<unsigned>(napiId) : 0;
+#endif
+  (void)fd;
+  return placement;
+}
+
+ssize_t SocketTuning::receive(int fd, void* buffer, size_t length, int flags,
+                              uint64_t& kernelTime) {
+#ifdef __linux__
+  iovec iov{buffer, length};
+  ControlBuffer control;
+  msghdr header{};
+  header.msg_iov = &iov;
+  header.msg_iovlen = 1;
+  header.msg_control = control.data;
+  header.msg_controllen = sizeof(control.data);
+
+  ssize_t received = recvmsg(fd, &header, flags);
+  if (received > 0) {
+    uint64_t stamped = receiveTime(header);
+    if (stamped != 0) {
+      kernelTime = stamped;
+    }
+  }
+  return received;
+#else
+  (void)kernelTime;
+  return recv(fd, buffer, length, flags);
+#endif
+}
+
+// ============================================================================
+// DatagramBatchReceiver
+// ============================================================================
+
+struct DatagramBatchReceiver::Batch {
+#ifdef __linux__
+  std::vector<mmsghdr> headers;
+  std::vector<iovec> iovecs;
+  std::vector<ControlBuffer> control;
+#endif
+};
+
+DatagramBatchReceiver::DatagramBatchReceiver(size_t maxMessages,
+                                             size_t maxMessageSize)
+    : m_maxMessages(std::max<size_t>(maxMessages, 1)),
+      m_maxMessageSize(maxMessageSize), m_batch(std::make_unique<Batch>()),
+      m_data(m_maxMessages * maxMessageSize), m_lengths(m_maxMessages, 0),
+      m_kernelTimes(m_maxMessages, 0) {
+#ifdef __linux__
+  m_batch->headers.resize(m_maxMessages);
+  m_batch->iovecs.resize(m_maxMessages);
+  m_batch->control.resize(m_maxMessages);
+#endif
+}
+
+DatagramBatchReceiver::~DatagramBatchReceiver() = default;
+
+int DatagramBatchReceiver::receive(int fd, int flags) {
+#ifdef __linux__
+  // The kernel rewrites lengths on return, so every header is reset
+  for (size_t i = 0; i < m_maxMessages; ++i) {
+    m_batch->iovecs[i] = {m_data.data() + i * m_maxMessageSize,
+                          m_maxMessageSize};
+    msghdr& header = m_batch->headers[i].msg_hdr;
+    header = msghdr{};
+    header.msg_iov = &m_batch->iovecs[i];
+    header.msg_iovlen = 1;
+    header.msg_control = m_batch->control[i].data;
+    header.msg_controllen = sizeof(m_batch->control[i].data);
+  }
+
+  int received =
+      recvmmsg(fd, m_batch->headers.data(),
+               static_cast<unsigned>(m_maxMessages), flags, nullptr);
+  if (received < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+  }
+  for (int i = 0; i < received; ++i) {
+    m_lengths[i] = std::min<size_t>(m_batch->headers[i].msg_len,
+                                    m_maxMessageSize);
+    m_kernelTimes[i] = receiveTime(m_batch->headers[i].msg_hdr);
+  }
+  return received;
+#else
+  ssize_t received = recv(fd, m_data.data(), m_maxMessageSize, flags);
+  if (received < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+  }
+  m_lengths[0] = static_cast<size_t>(received);
+  m_kernelTimes[0] = 0;
+  return 1;
+#endif
+}
+
+std::string_view DatagramBatchReceiver::message(size_t i) const {
+  return std::string_view(m_data.data() + i * m_maxMessageSize, m_lengths[i]);
+}
+
+} // namespace utils
+} // namespace pinnacle
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace utils {
+
+/**
+ * @struct SocketTuningConfig
+ * @brief Options applied to a feed or order entry socket
+ *
+ * Zero leaves the system default. Everything here stays within the
+ * standard kernel network stack.
+ */
+struct SocketTuningConfig {
+  bool noDelay{true};             // TCP_NODELAY: send small messages now
+  int busyPollMicros{0};          // SO_BUSY_POLL: spin on the device queue
+  int receiveBufferBytes{0};      // SO_RCVBUF; fixing it ends autotuning
+  int sendBufferBytes{0};         // SO_SNDBUF
+  bool kernelTimestamps{false};   // SO_TIMESTAMPING receive timestamps
+  bool hardwareTimestamps{false}; // Prefer the NIC's, where enabled on it
+};
+
+/**
+ * @struct SocketTuningReport
+ * @brief Which options took effect on a socket
+ *
+ * Options can be refused without failing the connection: busy polling
+ * above net.core.busy_poll needs CAP_NET_ADMIN, and buffers are capped by
+ * net.core.rmem_max and wmem_max.
+ */
+struct SocketTuningReport {
+  bool noDelay{false};
+  bool busyPoll{false};
+  bool timestamps{false};
+  int receiveBufferBytes{0}; // As granted; Linux doubles the request
+  int sendBufferBytes{0};
+};
+
+/**
+ * @struct SocketPlacement
+ * @brief Where the kernel processes a socket's incoming packets
+ *
+ * With RSS or RPS spreading flows over queues, each flow's packets are
+ * handled on one CPU. A reader that busy polls runs that processing itself
+ * and is best pinned there; one that sleeps in reads is best kept off it
+ * and on a sibling core. Known once a packet has arrived.
+ */
+struct SocketPlacement {
+  int incomingCpu{-1}; // SO_INCOMING_CPU, -1 if unknown
+  unsigned napiId{0};  // SO_INCOMING_NAPI_ID, the device queue; 0 if unknown
+};
+
+/**
+ * @class SocketTuning
+ * @brief Low-latency socket options, kernel receive timestamps and pinning
+ * hints
+ */
+class SocketTuning {
+public:
+  /**
+   * @brief Apply the options to a connected or listening socket, logging
+   * any the kernel refuses
+   */
+  static SocketTuningReport apply(int fd, const SocketTuningConfig& config);
+
+  static SocketPlacement placement(int fd);
+
+  /**
+   * @brief recv() that also reports when the data arrived
+   *
+   * @param kernelTime Set to the wall-clock nanoseconds at which the NIC,
+   * or else the kernel, received the last segment read; left unchanged if
+   * the socket has no timestamps enabled
+   * @return As recv()
+   */
+  static ssize_t receive(int fd, void* buffer, size_t length, int flags,
+                         uint64_t& kernelTime);
+};
+
+/**
+ * @class DatagramBatchReceiver
+ * @brief Receives many datagrams per system call, with their timestamps
+ *
+ * For UDP and multicast feeds: recvmmsg() fills up to maxMessages
+ * preallocated buffers per call, saving a system call per packet under
+ * bursts. Stream sockets gain nothing from it and read with
+ * SocketTuning::receive(). Elsewhere than Linux each call receives one
+ * datagram.
+ */
+class DatagramBatchReceiver {
+public:
+  DatagramBatchReceiver(size_t maxMessages, size_t maxMessageSize);
+  ~DatagramBatchReceiver();
+
+  DatagramBatchReceiver(const DatagramBatchReceiver&) = delete;
+  DatagramBatchReceiver& operator=(const DatagramBatchReceiver&) = delete;
+
+  /**
+   * @brief Receive whatever datagrams are waiting, up to maxMessages
+   *
+   * @param flags recvmmsg() flags; MSG_WAITFORONE blocks for the first
+   * datagram only
+   * @return Number received, 0 if none were waiting, -1 on error
+   */
+  int receive(int fd, int flags = MSG_DONTWAIT);
+
+  /**
+   * @brief A datagram of the last receive(), valid until the next; longer
+   * datagrams are truncated to maxMessageSize
+   */
+  std::string_view message(size_t i) const;
+
+  /**
+   * @brief Kernel or NIC receive time of a datagram, 0 without timestamps
+   */
+  uint64_t kernelTime(size_t i) const { return m_kernelTimes[i]; }
+
+private:
+  struct Batch;
+
+  size_t m_maxMessages;
+  size_t m_maxMessageSize;
+  std::unique_ptr<Batch> m_batch;
+  std::vector<char> m_data;
+  std::vector<size_t> m_lengths;
+  std::vector<uint64_t> m_kernelTimes;
+};
+
+} // namespace utils
+} // namespace pinnacle
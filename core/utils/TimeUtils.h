@@ -47,6 +47,18 @@ public:
         .count();
   }
 
+  /**
+   * @brief Get current wall-clock time in nanoseconds
+   * @return Nanoseconds since the Unix epoch, comparable with exchange
+   * timestamps (unlike getCurrentNanos, which is monotonic)
+   */
+  static uint64_t getWallClockNanos() {
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               now.time_since_epoch())
+        .count();
+  }
+
   /**
    * @brief Get current timestamp in seconds
    * @return Current timestamp in seconds since epoch
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace pinnacle {
+namespace utils {
+
+/**
+ * @class HierarchicalTimingWheel
+ * @brief Hashed hierarchical timing wheel with O(1) schedule and cancel
+ *
+ * Timers are bucketed by expiry tick into Levels wheels of SlotsPerLevel
+ * slots each. Level 0 holds timers due within one rotation; higher levels hold
+ * progressively coarser buckets which are cascaded down as the wheel turns.
+ * Timer nodes live in a pre-sized pool linked through indices, so steady-state
+ * operation performs no allocation.
+ *
+ * Not thread-safe: a wheel is owned and advanced by a single thread.
+ *
+ * @tparam T Payload delivered to the expiry callback
+ * @tparam SlotsPerLevel Slots per wheel level (must be a power of 2)
+ * @tparam Levels Number of wheel levels
+ */
+template <typename T, size_t SlotsPerLevel = 256, size_t Levels = 4>
+class HierarchicalTimingWheel {
+private:
+  static_assert((SlotsPerLevel & (SlotsPerLevel - 1)) == 0,
+                "SlotsPerLevel must be a power of 2");
+  static_assert(Levels >= 1 && Levels <= 8, "Levels must be in [1, 8]");
+
+  static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+  static constexpr uint64_t SLOT_MASK = SlotsPerLevel - 1;
+  static constexpr unsigned SLOT_BITS = [] {
+    unsigned bits = 0;
+    while ((size_t{1} << bits) < SlotsPerLevel) {
+      ++bits;
+    }
+    return bits;
+  }();
+
+  struct Node {
+    uint64_t expiryTick{0};
+    uint32_t prev{NIL};
+    uint32_t next{NIL};
+    uint32_t generation{0};
+    uint16_t level{0};
+    uint16_t slot{0};
+    bool active{false};
+    T payload{};
+  };
+
+public:
+  using TimerId = uint64_t;
+  static constexpr TimerId INVALID_TIMER = 0;
+
+  /**
+   * @brief Constructor
+   *
+   * @param tickNanos Resolution of the wheel in nanoseconds
+   * @param startNanos Time origin (typically TimeUtils::getCurrentNanos())
+   * @param initialCapacity Number of timer nodes to pre-allocate
+   */
+  HierarchicalTimingWheel(uint64_t tickNanos, uint64_t startNanos,
+                          size_t initialCapacity = 1024)
+      : m_tickNanos(tickNanos == 0 ? 1 : tickNanos),
+        m_currentTick(startNanos / m_tickNanos) {
+    for (auto& level : m_slots) {
+      level.fill(NIL);
+    }
+    m_nodes.reserve(initialCapacity);
+    for (size_t i = 0; i < initialCapacity; ++i) {
+      m_nodes.emplace_back();
+      m_nodes.back().next = m_freeHead;
+      m_freeHead = static_cast<uint32_t>(i);
+    }
+  }
+
+  HierarchicalTimingWheel(const HierarchicalTimingWheel&) = delete;
+  HierarchicalTimingWheel& operator=(const HierarchicalTimingWheel&) = delete;
+
+  /**
+   * @brief Schedule a timer
+   *
+   * Deadlines in the past fire on the next tick.
+   *
+   * @param deadlineNanos Absolute expiry time in nanoseconds
+   * @param payload Value passed to the expiry callback
+   * @return Handle usable with cancel()
+   */
+  TimerId schedule(uint64_t deadlineNanos, T payload) {
+    uint32_t index = allocateNode();
+    Node& node = m_nodes[index];
+    uint64_t tick = (deadlineNanos + m_tickNanos - 1) / m_tickNanos;
+    node.expiryTick = std::max(tick, m_currentTick + 1);
+    node.payload = std::move(payload);
+    node.active = true;
+    link(index);
+    ++m_size;
+    return makeId(index, node.generation);
+  }
+
+  /**
+   * @brief Cancel a pending timer
+   *
+   * @param id Handle returned by schedule()
+   * @return true if the timer was pending and is now removed
+   */
+  bool cancel(TimerId id) {
+    if (id == INVALID_TIMER) {
+      return false;
+    }
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFULL) - 1;
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= m_nodes.size()) {
+      return false;
+    }
+    Node& node = m_nodes[index];
+    if (!node.active || node.generation != generation) {
+      return false;
+    }
+    unlink(index);
+    releaseNode(index);
+    --m_size;
+    return true;
+  }
+
+  /**
+   * @brief Advance the wheel to the given time, firing expired timers
+   *
+   * @param nowNanos Current time in nanoseconds
+   * @param onExpire Callable invoked as onExpire(T&&) for each expired timer
+   * @return Number of timers fired
+   */
+  template <typename Callback>
+  size_t advance(uint64_t nowNanos, Callback&& onExpire) {
+    uint64_t targetTick = nowNanos / m_tickNanos;
+    size_t fired = 0;
+
+    while (m_currentTick < targetTick) {
+      if (m_size == 0) {
+        // Nothing pending; jump straight to the target tick
+        m_currentTick = targetTick;
+        break;
+      }
+
+      ++m_currentTick;
+      cascade();
+
+      // Pop one node at a time so callbacks may safely schedule or cancel
+      uint16_t slot = static_cast<uint16_t>(m_currentTick & SLOT_MASK);
+      uint32_t index;
+      while ((index = m_slots[0][slot]) != NIL) {
+        unlink(index);
+        T payload = std::move(m_nodes[index].payload);
+        releaseNode(index);
+        --m_size;
+        ++fired;
+        onExpire(std::move(payload));
+      }
+    }
+
+    return fired;
+  }
+
+  /**
+   * @brief Number of pending timers
+   */
+  size_t size() const { return m_size; }
+
+  /**
+   * @brief Check if no timers are pending
+   */
+  bool empty() const { return m_size == 0; }
+
+  /**
+   * @brief Wheel resolution in nanoseconds
+   */
+  uint64_t tickNanos() const { return m_tickNanos; }
+
+  /**
+   * @brief Absolute time (nanoseconds) at which the next tick is due
+   */
+  uint64_t nextTickNanos() const { return (m_currentTick + 1) * m_tickNanos; }
+
+private:
+  uint64_t m_tickNanos;
+  uint64_t m_currentTick;
+  size_t m_size{0};
+
+  std::array<std::array<uint32_t, SlotsPerLevel>, Levels> m_slots;
+  std::vector<Node> m_nodes;
+  uint32_t m_freeHead{NIL};
+
+  static TimerId makeId(uint32_t index, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) |
+           (static_cast<uint64_t>(index) + 1);
+  }
+
+  uint32_t allocateNode() {
+    if (m_freeHead == NIL) {
+      m_nodes.emplace_back();
+      return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+    uint32_t index = m_freeHead;
+    m_freeHead = m_nodes[index].next;
+    return index;
+  }
+
+  void releaseNode(uint32_t index) {
+    Node& node = m_nodes[index];
+    node.active = false;
+    node.generation++;
+    node.payload = T{};
+    node.prev = NIL;
+    node.next = m_freeHead;
+    m_freeHead = index;
+  }
+
+  void link(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint64_t delta = node.expiryTick - m_currentTick;
+
+    size_t level = 0;
+    while (level + 1 < Levels &&
+           delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+      ++level;
+    }
+
+    uint64_t tick = node.expiryTick;
+    if (level == Levels - 1) {
+      // Clamp beyond-horizon timers to the farthest top-level slot; they are
+      // re-bucketed when that slot cascades.
+      uint64_t horizon =
+          m_currentTick + (SLOT_MASK << (SLOT_BITS * (Levels - 1)));
+      tick = std::min(tick, horizon);
+    }
+
+    node.level = static_cast<uint16_t>(level);
+    node.slot = static_cast<uint16_t>((tick >> (SLOT_BITS * level)) &
+                                      SLOT_MASK);
+    node.prev = NIL;
+    node.next = m_slots[level][node.slot];
+    if (node.next != NIL) {
+      m_nodes[node.next].prev = index;
+    }
+    m_slots[level][node.slot] = index;
+  }
+
+  void unlink(uint32_t index) {
+    Node& node = m_nodes[index];
+    if (node.prev != NIL) {
+      m_nodes[node.prev].next = node.next;
+    } else {
+      m_slots[node.level][node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+      m_nodes[node.next].prev = node.prev;
+    }
+  }
+
+  void cascade() {
+    for (size_t level = 1; level < Levels; ++level) {
+      // Only cascade a level when every level below it has wrapped
+      if ((m_currentTick & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) != 0) {
+        break;
+      }
+
+      uint16_t slot = static_cast<uint16_t>(
+          (m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+      uint32_t index = m_slots[level][slot];
+      m_slots[level][slot] = NIL;
+
+      while (index != NIL) {
+        uint32_t next = m_nodes[index].next;
+        link(index);
+        index = next;
+      }
+    }
+  }
+};
+
+} // namespace utils
+} // namespace pinnacle
@@ -0,0 +1,133 @@
+#include "WorkStealingPool.h"
+#include "ThreadAffinity.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace pinnacle {
+namespace utils {
+
+namespace {
+
+// Pool and worker index of the calling thread, so a task's own submissions
+// stay on its worker
+thread_local const WorkStealingPool* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threadCount,
+                                   const std::string& name) {
+  if (threadCount == 0) {
+    threadCount = defaultThreadCount();
+  }
+
+  m_workers.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_workers.push_back(std::make_unique<Worker>());
+  }
+
+  m_threads.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_threads.emplace_back([this, i, name]() { run(i, name); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_stopping = true;
+  }
+  m_wakeup.notify_all();
+
+  for (auto& thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+size_t WorkStealingPool::defaultThreadCount() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void WorkStealingPool::submit(Task task) {
+  size_t index = t_pool == this
+                     ? t_workerIndex
+                     : m_nextWorker.fetch_add(1, std::memory_order_relaxed) %
+                           m_workers.size();
+
+  // Counted before the task is visible, so a worker taking it cannot count
+  // it down first, and under the sleep mutex so a worker about to sleep
+  // cannot miss it
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_pending.fetch_add(1, std::memory_order_release);
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+    m_workers[index]->tasks.push_back(std::move(task));
+  }
+  m_wakeup.notify_one();
+}
+
+bool WorkStealingPool::take(size_t index, Task& task) {
+  {
+    Worker& own = *m_workers[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // Steal the oldest task of the next worker that has any
+  for (size_t offset = 1; offset < m_workers.size(); ++offset) {
+    Worker& victim = *m_workers[(index + offset) % m_workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::run(size_t index, const std::string& name) {
+  t_pool = this;
+  t_workerIndex = index;
+  ThreadAffinity::setThreadName(name + "-" + std::to_string(index));
+
+  Task task;
+  while (true) {
+    if (take(index, task)) {
+      m_pending.fetch_sub(1, std::memory_order_acq_rel);
+      try {
+        task();
+      } catch (const std::exception& e) {
+        spdlog::error("Pool task failed: {}", e.what());
+      } catch (...) {
+        spdlog::error("Pool task failed with an unknown exception");
+      }
+      task = nullptr;
+      continue;
+    }
+
+    // Nothing to take: sleep until there is, draining the queue before
+    // stopping
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_wakeup.wait(lock, [this]() {
+      return m_stopping || m_pending.load(std::memory_order_acquire) > 0;
+    });
+    if (m_stopping && m_pending.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+} // namespace utils
+} // namespace pinnacle
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pinnacle {
+namespace utils {
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed pool of worker threads that balance uneven tasks by stealing
+ *
+ * Each worker has its own deque. Tasks submitted from outside the pool are
+ * dealt round-robin over the deques; tasks submitted by a running task go to
+ * its own worker's deque. A worker takes from the back of its own deque and,
+ * once that is empty, steals from the front of the others', so a worker
+ * stuck on a long task never holds up work that another could be doing.
+ *
+ * Suited to coarse tasks such as whole backtests, where a mutex per deque
+ * costs nothing next to the task; it is not meant for the hot path.
+ */
+class WorkStealingPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param threadCount Number of workers; 0 uses one per hardware thread
+   * @param name Thread name prefix, suffixed with the worker index
+   */
+  explicit WorkStealingPool(size_t threadCount = 0,
+                            const std::string& name = "pool");
+
+  /**
+   * @brief Runs every task already submitted, then joins the workers
+   */
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /**
+   * @brief Queue a task; safe to call from any thread, including a task
+   *
+   * A task that throws is logged and dropped; the worker carries on.
+   */
+  void submit(Task task);
+
+  /**
+   * @brief Number of worker threads
+   */
+  size_t size() const { return m_workers.size(); }
+
+  /**
+   * @brief Tasks queued but not yet started
+   */
+  size_t pending() const { return m_pending.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Worker count used for a threadCount of 0
+   */
+  static size_t defaultThreadCount();
+
+private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+
+  std::atomic<size_t> m_pending{0};
+  std::atomic<size_t> m_nextWorker{0};
+
+  // Idle workers sleep here until a task is submitted or the pool stops
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wakeup;
+  bool m_stopping{false};
+
+  void run(size_t index, const std::string& name);
+  bool take(size_t index, Task& task);
+};
+
+} // namespace utils
+} // namespace pinnacle
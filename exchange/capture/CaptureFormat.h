@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+/**
+ * Market data capture files (.pmcap)
+ *
+ * A capture is a file header followed by a sequence of chunks. Each chunk
+ * carries a header and a payload of frame records, optionally compressed
+ * as a whole:
+ *
+ *   CaptureFileHeader
+ *   ChunkHeader, payload (storedSize bytes)
+ *   ChunkHeader, payload
+ *   ...
+ *
+ * A decompressed payload is frameCount records of
+ *
+ *   uint64_t receivedAt   wall-clock nanoseconds the frame was read
+ *   uint32_t length       frame length in bytes
+ *   char     data[length] raw frame as received from the venue
+ *
+ * All integers are little-endian and records are not padded. Chunks are
+ * written whole and flushed, so a recorder that dies loses at most the
+ * chunk it was filling; readers stop at a truncated trailing chunk.
+ */
+
+constexpr char CAPTURE_MAGIC[8] = {'P', 'M', 'M', 'C', 'A', 'P', '0', '1'};
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+constexpr const char* CAPTURE_EXTENSION = ".pmcap";
+
+/**
+ * @enum ChunkCodec
+ * @brief How a chunk payload is stored
+ */
+enum class ChunkCodec : uint32_t { NONE = 0, ZLIB = 1 };
+
+/**
+ * @struct CaptureFileHeader
+ * @brief Start of every capture file
+ */
+struct CaptureFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize; // sizeof(CaptureFileHeader) when written
+  uint64_t createdAt;  // Wall-clock nanoseconds
+  char source[32];     // Feed name, NUL padded
+};
+
+/**
+ * @struct ChunkHeader
+ * @brief Precedes each chunk payload
+ */
+struct ChunkHeader {
+  uint32_t magic;
+  uint32_t codec;      // ChunkCodec
+  uint32_t frameCount; // Records in the payload
+  uint32_t rawSize;    // Payload bytes once decompressed
+  uint32_t storedSize; // Payload bytes in the file
+  uint32_t reserved;
+  uint64_t firstReceivedAt;
+  uint64_t lastReceivedAt;
+};
+
+/**
+ * @brief Bytes of receivedAt and length ahead of each frame's data
+ */
+constexpr size_t FRAME_RECORD_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+static_assert(sizeof(CaptureFileHeader) == 56, "Capture header layout");
+static_assert(sizeof(ChunkHeader) == 40, "Chunk header layout");
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,192 @@
+#include "CaptureReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+CaptureReader::~CaptureReader() { close(); }
+
+bool CaptureReader::open(const std::string& path) {
+  close();
+
+  m_fd = ::open(path.c_str(), O_RDONLY);
+  if (m_fd == -1) {
+    spdlog::error("Cannot open capture {}: {}", path, std::strerror(errno));
+    return false;
+  }
+
+  struct stat st {};
+  if (fstat(m_fd, &st) == -1 ||
+      static_cast<size_t>(st.st_size) < sizeof(CaptureFileHeader)) {
+    spdlog::error("Capture {} is too short to hold a header", path);
+    close();
+    return false;
+  }
+
+  m_size = static_cast<size_t>(st.st_size);
+  void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (mapped == MAP_FAILED) {
+    spdlog::error("Cannot map capture {}: {}", path, std::strerror(errno));
+    m_size = 0;
+    close();
+    return false;
+  }
+  m_data = static_cast<const char*>(mapped);
+  madvise(mapped, m_size, MADV_SEQUENTIAL);
+
+  std::memcpy(&m_header, m_data, sizeof(m_header));
+  if (std::memcmp(m_header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+      m_header.version != CAPTURE_VERSION ||
+      m_header.headerSize < sizeof(CaptureFileHeader) ||
+      m_header.headerSize > m_size) {
+    spdlog::error("{} is not a version {} capture file", path,
+                  CAPTURE_VERSION);
+    close();
+    return false;
+  }
+
+  m_path = path;
+  rewind();
+  return true;
+}
+
+void CaptureReader::close() {
+  if (m_data) {
+    munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+  }
+  if (m_fd != -1) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+  m_size = 0;
+  m_payload = nullptr;
+  m_framesLeft = 0;
+}
+
+void CaptureReader::rewind() {
+  m_nextChunk = m_header.headerSize;
+  m_payload = nullptr;
+  m_payloadSize = 0;
+  m_payloadOffset = 0;
+  m_framesLeft = 0;
+  m_framesRead = 0;
+  m_truncated = false;
+}
+
+bool CaptureReader::next(CapturedFrame& frame) {
+  while (m_framesLeft == 0) {
+    if (!m_data || m_truncated || !loadChunk()) {
+      return false;
+    }
+  }
+
+  if (m_payloadSize - m_payloadOffset < FRAME_RECORD_HEADER_SIZE) {
+    return damaged("frame record overruns its chunk");
+  }
+  const char* record = m_payload + m_payloadOffset;
+  uint32_t length = 0;
+  std::memcpy(&frame.receivedAt, record, sizeof(frame.receivedAt));
+  std::memcpy(&length, record + sizeof(frame.receivedAt), sizeof(length));
+  if (m_payloadSize - m_payloadOffset - FRAME_RECORD_HEADER_SIZE < length) {
+    return damaged("frame record overruns its chunk");
+  }
+
+  frame.data = std::string_view(record + FRAME_RECORD_HEADER_SIZE, length);
+  m_payloadOffset += FRAME_RECORD_HEADER_SIZE + length;
+  --m_framesLeft;
+  ++m_framesRead;
+  return true;
+}
+
+bool CaptureReader::loadChunk() {
+  if (m_nextChunk == m_size) {
+    return false; // Clean end of file
+  }
+  if (m_size - m_nextChunk < sizeof(ChunkHeader)) {
+    return damaged("truncated chunk header");
+  }
+
+  ChunkHeader header;
+  std::memcpy(&header, m_data + m_nextChunk, sizeof(header));
+  const char* stored = m_data + m_nextChunk + sizeof(header);
+  if (header.magic != CHUNK_MAGIC) {
+    return damaged("bad chunk magic");
+  }
+  if (m_size - m_nextChunk - sizeof(header) < header.storedSize) {
+    return damaged("truncated chunk payload");
+  }
+
+  switch (static_cast<ChunkCodec>(header.codec)) {
+  case ChunkCodec::NONE:
+    if (header.storedSize != header.rawSize) {
+      return damaged("chunk sizes disagree");
+    }
+    m_payload = stored;
+    break;
+  case ChunkCodec::ZLIB: {
+#ifdef HAVE_ZLIB
+    m_inflated.resize(header.rawSize);
+    uLongf rawSize = header.rawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(m_inflated.data()), &rawSize,
+                   reinterpret_cast<const Bytef*>(stored),
+                   header.storedSize) != Z_OK ||
+        rawSize != header.rawSize) {
+      return damaged("chunk does not inflate");
+    }
+    m_payload = m_inflated.data();
+    break;
+#else
+    return damaged("chunk is zlib compressed but zlib is not available");
+#endif
+  }
+  default:
+    return damaged("unknown chunk codec");
+  }
+
+  m_payloadSize = header.rawSize;
+  m_payloadOffset = 0;
+  m_framesLeft = header.frameCount;
+  m_nextChunk += sizeof(header) + header.storedSize;
+  return true;
+}
+
+bool CaptureReader::damaged(const char* reason) {
+  spdlog::warn("Capture {} ends early at offset {}: {} ({} frames read)",
+               m_path, m_nextChunk, reason, m_framesRead);
+  m_truncated = true;
+  m_framesLeft = 0;
+  return false;
+}
+
+std::vector<std::string>
+CaptureReader::listCaptures(const std::string& directory) {
+  std::vector<std::string> files;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(directory, ec)) {
+    if (entry.is_regular_file() &&
+        entry.path().extension() == CAPTURE_EXTENSION) {
+      files.push_back(entry.path().string());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
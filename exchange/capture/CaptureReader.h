@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CaptureFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+/**
+ * @struct CapturedFrame
+ * @brief One recorded frame
+ */
+struct CapturedFrame {
+  uint64_t receivedAt{0};
+  std::string_view data; // Valid until the next call to CaptureReader::next()
+};
+
+/**
+ * @class CaptureReader
+ * @brief Reads frames back from a memory-mapped capture file
+ *
+ * Uncompressed chunks are read in place from the mapping; compressed ones
+ * are inflated into a buffer reused from chunk to chunk. Every header and
+ * record is bounds-checked, and reading stops cleanly at a truncated or
+ * corrupt chunk such as the tail of a capture whose recorder was killed.
+ */
+class CaptureReader {
+public:
+  CaptureReader() = default;
+  ~CaptureReader();
+
+  CaptureReader(const CaptureReader&) = delete;
+  CaptureReader& operator=(const CaptureReader&) = delete;
+
+  /**
+   * @brief Map a capture file and validate its header
+   *
+   * @return false if the file cannot be mapped or is not a capture
+   */
+  bool open(const std::string& path);
+
+  void close();
+
+  bool isOpen() const { return m_data != nullptr; }
+
+  /**
+   * @brief Read the next frame
+   *
+   * @return false at the end of the capture or at the first damaged chunk
+   */
+  bool next(CapturedFrame& frame);
+
+  /**
+   * @brief Go back to the first frame
+   */
+  void rewind();
+
+  const CaptureFileHeader& getHeader() const { return m_header; }
+
+  uint64_t getFramesRead() const { return m_framesRead; }
+
+  /**
+   * @brief Whether reading stopped early at a damaged or truncated chunk
+   */
+  bool isTruncated() const { return m_truncated; }
+
+  /**
+   * @brief Capture files in a directory, in recording order
+   */
+  static std::vector<std::string> listCaptures(const std::string& directory);
+
+private:
+  std::string m_path;
+  int m_fd{-1};
+  const char* m_data{nullptr};
+  size_t m_size{0};
+  CaptureFileHeader m_header{};
+
+  size_t m_nextChunk{0}; // File offset of the next chunk header
+  const char* m_payload{nullptr};
+  size_t m_payloadSize{0};
+  size_t m_payloadOffset{0};
+  uint32_t m_framesLeft{0};
+  std::vector<char> m_inflated;
+
+  uint64_t m_framesRead{0};
+  bool m_truncated{false};
+
+  bool loadChunk();
+  bool damaged(const char* reason);
+};
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,289 @@
+#include "CaptureRecorder.h"
+#include "../../core/utils/TimeUtils.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+CaptureRecorder::CaptureRecorder(CaptureConfig config)
+    : m_config(std::move(config)),
+      m_chunks(std::max<size_t>(m_config.chunkBuffers, 2)) {
+  for (uint32_t i = 0; i < m_chunks.slabCount(); ++i) {
+    m_chunks.slab(i).payload.reserve(m_config.chunkBytes);
+  }
+}
+
+CaptureRecorder::~CaptureRecorder() { stop(); }
+
+bool CaptureRecorder::start() {
+  if (m_running.load()) {
+    return true;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(m_config.directory, ec);
+  if (ec) {
+    spdlog::error("Cannot create capture directory {}: {}",
+                  m_config.directory, ec.message());
+    return false;
+  }
+
+  m_stopWriter.store(false);
+  m_writerThread = std::thread(&CaptureRecorder::writerLoop, this);
+  m_running.store(true, std::memory_order_release);
+  spdlog::info("Recording market data to {}", m_config.directory);
+  return true;
+}
+
+void CaptureRecorder::stop() {
+  if (!m_running.exchange(false)) {
+    return;
+  }
+
+  // No record() starts now; once those in progress return, this thread is
+  // the only producer and may seal the last chunk
+  while (m_recording.load() != 0) {
+    std::this_thread::yield();
+  }
+  seal();
+  m_stopWriter.store(true);
+  if (m_writerThread.joinable()) {
+    m_writerThread.join();
+  }
+  closeFile();
+
+  spdlog::info("Capture stopped: {} frames recorded, {} dropped, {} bytes "
+               "written",
+               getFramesRecorded(), getFramesDropped(), getBytesWritten());
+}
+
+bool CaptureRecorder::record(std::string_view frame, uint64_t receivedAt) {
+  // Announce the call before checking m_running, so stop() either sees it
+  // or this call sees the recorder stopped
+  m_recording.fetch_add(1);
+  struct Leave {
+    std::atomic<uint32_t>& recording;
+    ~Leave() { recording.fetch_sub(1, std::memory_order_release); }
+  } leave{m_recording};
+
+  if (!m_running.load()) {
+    return false;
+  }
+
+  if (m_sealRequested.load(std::memory_order_relaxed) &&
+      m_sealRequested.exchange(false, std::memory_order_acquire)) {
+    seal();
+  }
+
+  size_t recordSize = FRAME_RECORD_HEADER_SIZE + frame.size();
+  if (m_current != ChunkRing::NO_SLAB) {
+    const Chunk& chunk = m_chunks.slab(m_current);
+    if (chunk.payload.size() + recordSize > m_config.chunkBytes) {
+      seal();
+    }
+  }
+
+  if (m_current == ChunkRing::NO_SLAB) {
+    m_current = m_chunks.tryAcquire();
+    if (m_current == ChunkRing::NO_SLAB) {
+      dropFrames(1);
+      return false;
+    }
+    Chunk& chunk = m_chunks.slab(m_current);
+    chunk.payload.clear();
+    chunk.frameCount = 0;
+    chunk.firstReceivedAt = receivedAt;
+  }
+
+  // Append the record; an oversized frame gets a chunk to itself
+  Chunk& chunk = m_chunks.slab(m_current);
+  size_t offset = chunk.payload.size();
+  uint32_t length = static_cast<uint32_t>(frame.size());
+  chunk.payload.resize(offset + recordSize);
+  char* out = chunk.payload.data() + offset;
+  std::memcpy(out, &receivedAt, sizeof(receivedAt));
+  std::memcpy(out + sizeof(receivedAt), &length, sizeof(length));
+  std::memcpy(out + FRAME_RECORD_HEADER_SIZE, frame.data(), frame.size());
+  ++chunk.frameCount;
+  chunk.lastReceivedAt = receivedAt;
+
+  if (receivedAt - chunk.firstReceivedAt >= m_config.flushIntervalNs) {
+    seal();
+  }
+  return true;
+}
+
+void CaptureRecorder::flush() {
+  m_sealRequested.store(true, std::memory_order_release);
+}
+
+std::vector<std::string> CaptureRecorder::getFilesWritten() const {
+  std::lock_guard<std::mutex> lock(m_filesMutex);
+  return m_files;
+}
+
+void CaptureRecorder::seal() {
+  if (m_current == ChunkRing::NO_SLAB) {
+    return;
+  }
+  m_chunks.publish(m_current);
+  m_current = ChunkRing::NO_SLAB;
+}
+
+void CaptureRecorder::dropFrames(uint64_t count) {
+  uint64_t dropped =
+      m_framesDropped.fetch_add(count, std::memory_order_relaxed) + count;
+  // Warn each time the total passes a power of two, so a slow disk is
+  // visible without flooding the log
+  if (std::bit_floor(dropped) > dropped - count) {
+    spdlog::warn("Capture writer is behind, {} frames dropped", dropped);
+  }
+}
+
+void CaptureRecorder::writerLoop() {
+  auto stopping = [this]() {
+    return m_stopWriter.load(std::memory_order_acquire);
+  };
+
+  for (;;) {
+    uint32_t index = m_chunks.consume(stopping);
+    if (index == ChunkRing::NO_SLAB) {
+      break;
+    }
+    writeChunk(m_chunks.slab(index));
+    m_chunks.release(index);
+  }
+}
+
+void CaptureRecorder::writeChunk(const Chunk& chunk) {
+  if (chunk.frameCount == 0) {
+    return;
+  }
+
+  ChunkHeader header{};
+  header.magic = CHUNK_MAGIC;
+  header.codec = static_cast<uint32_t>(ChunkCodec::NONE);
+  header.frameCount = chunk.frameCount;
+  header.rawSize = static_cast<uint32_t>(chunk.payload.size());
+  header.storedSize = header.rawSize;
+  header.firstReceivedAt = chunk.firstReceivedAt;
+  header.lastReceivedAt = chunk.lastReceivedAt;
+
+  const void* payload = chunk.payload.data();
+#ifdef HAVE_ZLIB
+  if (m_config.compressionLevel > 0) {
+    uLongf compressedSize = compressBound(chunk.payload.size());
+    m_compressed.resize(compressedSize);
+    int rc = compress2(
+        m_compressed.data(), &compressedSize,
+        reinterpret_cast<const Bytef*>(chunk.payload.data()),
+        chunk.payload.size(), m_config.compressionLevel);
+    // Keep the raw payload when compression does not pay
+    if (rc == Z_OK && compressedSize < chunk.payload.size()) {
+      header.codec = static_cast<uint32_t>(ChunkCodec::ZLIB);
+      header.storedSize = static_cast<uint32_t>(compressedSize);
+      payload = m_compressed.data();
+    }
+  }
+#endif
+
+  size_t chunkSize = sizeof(header) + header.storedSize;
+  if (m_file && m_fileBytes > sizeof(CaptureFileHeader) &&
+      m_fileBytes + chunkSize > m_config.maxFileBytes) {
+    closeFile();
+  }
+  if (!m_file && !openFile()) {
+    dropFrames(chunk.frameCount);
+    return;
+  }
+
+  if (std::fwrite(&header, sizeof(header), 1, m_file) != 1 ||
+      std::fwrite(payload, 1, header.storedSize, m_file) !=
+          header.storedSize ||
+      std::fflush(m_file) != 0) {
+    spdlog::error("Capture write failed: {}", std::strerror(errno));
+    closeFile();
+    dropFrames(chunk.frameCount);
+    return;
+  }
+
+  m_fileBytes += chunkSize;
+  m_framesRecorded.fetch_add(chunk.frameCount, std::memory_order_relaxed);
+  m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+  m_bytesWritten.fetch_add(chunkSize, std::memory_order_relaxed);
+}
+
+bool CaptureRecorder::openFile() {
+  uint64_t now = utils::TimeUtils::getWallClockNanos();
+  std::time_t seconds = static_cast<std::time_t>(now / 1'000'000'000);
+  std::tm utc{};
+  gmtime_r(&seconds, &utc);
+
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &utc);
+  // Never overwrite an earlier capture, e.g. from a restart in the same
+  // second
+  std::string path;
+  do {
+    char sequence[8];
+    std::snprintf(sequence, sizeof(sequence), "%04u",
+                  m_fileSequence++ % 10000);
+    path = (std::filesystem::path(m_config.directory) /
+            (m_config.prefix + "-" + stamp + "-" + sequence +
+             CAPTURE_EXTENSION))
+               .string();
+  } while (std::filesystem::exists(path));
+
+  m_file = std::fopen(path.c_str(), "wb");
+  if (!m_file) {
+    spdlog::error("Cannot open capture file {}: {}", path,
+                  std::strerror(errno));
+    return false;
+  }
+
+  CaptureFileHeader header{};
+  std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+  header.version = CAPTURE_VERSION;
+  header.headerSize = sizeof(header);
+  header.createdAt = now;
+  std::strncpy(header.source, m_config.source.c_str(),
+               sizeof(header.source) - 1);
+  if (std::fwrite(&header, sizeof(header), 1, m_file) != 1) {
+    spdlog::error("Capture write failed: {}", std::strerror(errno));
+    std::fclose(m_file);
+    m_file = nullptr;
+    return false;
+  }
+
+  m_fileBytes = sizeof(header);
+  m_bytesWritten.fetch_add(sizeof(header), std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+    m_files.push_back(path);
+  }
+  spdlog::debug("Opened capture file {}", path);
+  return true;
+}
+
+void CaptureRecorder::closeFile() {
+  if (m_file) {
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+  m_fileBytes = 0;
+}
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../../core/utils/SlabRing.h"
+#include "CaptureFormat.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+/**
+ * @struct CaptureConfig
+ * @brief Where and how a CaptureRecorder writes
+ */
+struct CaptureConfig {
+  std::string directory{"captures"};
+  std::string prefix{"capture"};
+  std::string source; // Stored in the file header, e.g. "coinbase"
+
+  size_t chunkBytes{1024 * 1024};          // Raw payload per chunk
+  size_t maxFileBytes{256 * 1024 * 1024};  // Rotate past this size
+  uint64_t flushIntervalNs{1'000'000'000}; // Seal chunks spanning this
+  size_t chunkBuffers{8};                  // Chunks in flight to the writer
+  int compressionLevel{1}; // zlib level, 0 stores chunks uncompressed
+};
+
+/**
+ * @class CaptureRecorder
+ * @brief Records raw feed frames to chunked capture files off the hot path
+ *
+ * The feed thread appends each frame with its receive time into a chunk
+ * buffer; full chunks are handed through a SlabRing to a writer thread
+ * that compresses, writes and flushes them and rotates files. Chunks are
+ * also sealed once they span flushIntervalNs of receive time, so a quiet
+ * feed still reaches disk. If the writer falls behind and every chunk
+ * buffer is in flight, frames are dropped and counted rather than stalling
+ * the feed.
+ *
+ * Files are named <prefix>-YYYYMMDD-HHMMSS-NNNN.pmcap (UTC), so sorting by
+ * name gives recording order. Without zlib chunks are stored uncompressed.
+ *
+ * record() must be called from a single producer thread, the only one to
+ * hand chunks to the writer. flush() and stop() may be called from any
+ * thread: flush() asks the producer to seal its chunk on its next record(),
+ * and stop() waits for any record() in progress before sealing the last
+ * chunk itself.
+ */
+class CaptureRecorder {
+public:
+  explicit CaptureRecorder(CaptureConfig config);
+  ~CaptureRecorder();
+
+  CaptureRecorder(const CaptureRecorder&) = delete;
+  CaptureRecorder& operator=(const CaptureRecorder&) = delete;
+
+  /**
+   * @brief Create the capture directory and start the writer thread
+   */
+  bool start();
+
+  /**
+   * @brief Seal the current chunk, write everything pending and close
+   */
+  void stop();
+
+  bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Append one frame to the current chunk
+   *
+   * @param receivedAt Wall-clock nanoseconds the frame was received
+   * @return false if the recorder is stopped or the frame was dropped
+   */
+  bool record(std::string_view frame, uint64_t receivedAt);
+
+  /**
+   * @brief Hand the current chunk to the writer even if it is not full, at
+   * the producer's next record()
+   */
+  void flush();
+
+  /**
+   * @brief Frames written to disk
+   */
+  uint64_t getFramesRecorded() const {
+    return m_framesRecorded.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Frames lost to a full ring or a failed write
+   */
+  uint64_t getFramesDropped() const {
+    return m_framesDropped.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getChunksWritten() const {
+    return m_chunksWritten.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getBytesWritten() const {
+    return m_bytesWritten.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Paths of the files written so far, oldest first
+   */
+  std::vector<std::string> getFilesWritten() const;
+
+private:
+  struct Chunk {
+    std::vector<char> payload;
+    uint32_t frameCount{0};
+    uint64_t firstReceivedAt{0};
+    uint64_t lastReceivedAt{0};
+  };
+  using ChunkRing = utils::SlabRing<Chunk>;
+
+  CaptureConfig m_config;
+  ChunkRing m_chunks;
+  uint32_t m_current{ChunkRing::NO_SLAB}; // Owned by the producer
+
+  std::atomic<bool> m_running{false};
+  std::atomic<uint32_t> m_recording{0}; // record() calls in progress
+  std::atomic<bool> m_sealRequested{false};
+  std::atomic<bool> m_stopWriter{false};
+  std::thread m_writerThread;
+
+  // Writer thread state
+  std::FILE* m_file{nullptr};
+  size_t m_fileBytes{0};
+  uint32_t m_fileSequence{0};
+  std::vector<unsigned char> m_compressed;
+
+  mutable std::mutex m_filesMutex;
+  std::vector<std::string> m_files;
+
+  std::atomic<uint64_t> m_framesRecorded{0};
+  std::atomic<uint64_t> m_framesDropped{0};
+  std::atomic<uint64_t> m_chunksWritten{0};
+  std::atomic<uint64_t> m_bytesWritten{0};
+
+  void seal();
+  void dropFrames(uint64_t count);
+  void writerLoop();
+  void writeChunk(const Chunk& chunk);
+  bool openFile();
+  void closeFile();
+};
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,226 @@
+#include "ReplayMarketDataFeed.h"
+#include "../../core/utils/TimeUtils.h"
+#include "CaptureReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+ReplayMarketDataFeed::ReplayMarketDataFeed(std::vector<std::string> files,
+                                           double speed)
+    : m_files(std::move(files)), m_speed(std::max(speed, 0.0)) {}
+
+ReplayMarketDataFeed::~ReplayMarketDataFeed() { stop(); }
+
+bool ReplayMarketDataFeed::start() {
+  if (m_isRunning.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  m_shouldStop.store(false, std::memory_order_release);
+  m_finished.store(false, std::memory_order_release);
+  m_replayThread = std::thread([this]() {
+    replay(m_speed > 0.0);
+    if (!m_shouldStop.load(std::memory_order_acquire)) {
+      m_finished.store(true, std::memory_order_release);
+    }
+  });
+  m_isRunning.store(true, std::memory_order_release);
+  return true;
+}
+
+bool ReplayMarketDataFeed::stop() {
+  if (!m_isRunning.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  m_shouldStop.store(true, std::memory_order_release);
+  if (m_replayThread.joinable()) {
+    m_replayThread.join();
+  }
+  m_isRunning.store(false, std::memory_order_release);
+  return true;
+}
+
+bool ReplayMarketDataFeed::isRunning() const {
+  return m_isRunning.load(std::memory_order_acquire);
+}
+
+bool ReplayMarketDataFeed::subscribeToMarketUpdates(
+    const std::string& symbol,
+    std::function<void(const MarketUpdate&)> callback) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_marketUpdateCallbacks[symbol].push_back(std::move(callback));
+  return true;
+}
+
+bool ReplayMarketDataFeed::subscribeToOrderBookUpdates(
+    const std::string& symbol,
+    std::function<void(const OrderBookUpdate&)> callback) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_orderBookUpdateCallbacks[symbol].push_back(std::move(callback));
+  return true;
+}
+
+bool ReplayMarketDataFeed::unsubscribeFromMarketUpdates(
+    const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_marketUpdateCallbacks.erase(symbol);
+  return true;
+}
+
+bool ReplayMarketDataFeed::unsubscribeFromOrderBookUpdates(
+    const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_orderBookUpdateCallbacks.erase(symbol);
+  return true;
+}
+
+void ReplayMarketDataFeed::subscribeToEvents(
+    std::function<void(std::span<const MarketEvent>)> callback) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_eventCallbacks.push_back(std::move(callback));
+}
+
+void ReplayMarketDataFeed::publishMarketUpdate(const MarketUpdate& update) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  auto it = m_marketUpdateCallbacks.find(update.symbol);
+  if (it != m_marketUpdateCallbacks.end()) {
+    for (const auto& callback : it->second) {
+      callback(update);
+    }
+  }
+}
+
+void ReplayMarketDataFeed::publishOrderBookUpdate(
+    const OrderBookUpdate& update) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  auto it = m_orderBookUpdateCallbacks.find(update.symbol);
+  if (it != m_orderBookUpdateCallbacks.end()) {
+    for (const auto& callback : it->second) {
+      callback(update);
+    }
+  }
+}
+
+uint64_t ReplayMarketDataFeed::replayAll() {
+  if (m_isRunning.load(std::memory_order_acquire)) {
+    spdlog::warn("replayAll() called while the replay thread is running");
+    return 0;
+  }
+  m_shouldStop.store(false, std::memory_order_release);
+  return replay(false);
+}
+
+std::unique_ptr<NormalizedFeedHandler>
+ReplayMarketDataFeed::createHandler(Venue venue) {
+  auto handler =
+      std::make_unique<NormalizedFeedHandler>(createVenueDecoder(venue));
+  handler->setMarketUpdateSink(
+      [this](const MarketUpdate& update) { publishMarketUpdate(update); });
+  handler->setOrderBookUpdateSink(
+      [this](const OrderBookUpdate& update) { publishOrderBookUpdate(update); });
+
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  if (!m_eventCallbacks.empty()) {
+    handler->setEventSink([this](std::span<const MarketEvent> events) {
+      std::lock_guard<std::mutex> lock(m_callbacksMutex);
+      for (const auto& callback : m_eventCallbacks) {
+        callback(events);
+      }
+    });
+  }
+  // Map the venue's spelling of subscribed symbols to the subscribed names
+  for (const auto& [symbol, callbacks] : m_marketUpdateCallbacks) {
+    handler->addSymbol(symbol);
+  }
+  for (const auto& [symbol, callbacks] : m_orderBookUpdateCallbacks) {
+    handler->addSymbol(symbol);
+  }
+  return handler;
+}
+
+uint64_t ReplayMarketDataFeed::replay(bool paced) {
+  CaptureReader reader;
+  CapturedFrame frame;
+  uint64_t replayed = 0;
+  std::unique_ptr<NormalizedFeedHandler> handler;
+  Venue venue = Venue::COINBASE;
+
+  // Pacing anchor: the first frame's receive time maps to the start time
+  bool anchored = false;
+  uint64_t firstReceivedAt = 0;
+  uint64_t startNanos = 0;
+
+  for (const auto& file : m_files) {
+    if (!reader.open(file)) {
+      continue;
+    }
+    spdlog::debug("Replaying capture {}", file);
+
+    // Decoder state carries over between the files of one venue
+    const auto& source = reader.getHeader().source;
+    Venue fileVenue =
+        venueFromName(std::string_view(source, strnlen(source, sizeof(source))))
+            .value_or(Venue::COINBASE);
+    if (!handler || fileVenue != venue) {
+      venue = fileVenue;
+      handler = createHandler(venue);
+    }
+
+    while (reader.next(frame)) {
+      if (m_shouldStop.load(std::memory_order_acquire)) {
+        return replayed;
+      }
+
+      if (paced) {
+        if (!anchored) {
+          anchored = true;
+          firstReceivedAt = frame.receivedAt;
+          startNanos = utils::TimeUtils::getCurrentNanos();
+        }
+        uint64_t elapsed = frame.receivedAt > firstReceivedAt
+                               ? frame.receivedAt - firstReceivedAt
+                               : 0;
+        if (!waitUntil(startNanos +
+                       static_cast<uint64_t>(elapsed / m_speed))) {
+          return replayed;
+        }
+      }
+
+      handler->process(frame.data, frame.receivedAt);
+      ++replayed;
+      m_framesReplayed.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  spdlog::info("Replayed {} frames from {} capture files", replayed,
+               m_files.size());
+  return replayed;
+}
+
+bool ReplayMarketDataFeed::waitUntil(uint64_t steadyNanos) {
+  // Sleep in slices so stop() is honoured during long gaps
+  constexpr uint64_t MAX_SLICE_NANOS = 50'000'000;
+
+  for (;;) {
+    if (m_shouldStop.load(std::memory_order_acquire)) {
+      return false;
+    }
+    uint64_t now = utils::TimeUtils::getCurrentNanos();
+    if (now >= steadyNanos) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(
+        std::min(steadyNanos - now, MAX_SLICE_NANOS)));
+  }
+}
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
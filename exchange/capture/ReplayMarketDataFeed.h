@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../connector/NormalizedFeedHandler.h"
+#include "../simulator/MarketDataFeed.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace capture {
+
+/**
+ * @class ReplayMarketDataFeed
+ * @brief Market data feed that plays back recorded captures
+ *
+ * Frames are read from memory-mapped capture files in order and decoded
+ * exactly as the live feed decodes them, with the decoder of the venue
+ * named as the capture's source (Coinbase if it names none), so
+ * strategies see the same updates they saw live. Updates carry the recorded receive time as
+ * their timestamp. start() replays on a background thread paced by the
+ * receive times, scaled by the speed; replayAll() replays synchronously
+ * and unpaced for backtests.
+ */
+class ReplayMarketDataFeed : public MarketDataFeed {
+public:
+  /**
+   * @brief Speed that replays without pacing
+   */
+  static constexpr double MAX_SPEED = 0.0;
+
+  /**
+   * @brief Constructor
+   *
+   * @param files Capture files, replayed in the given order
+   * @param speed 1.0 for recorded pace, N for N times faster, MAX_SPEED to
+   * replay as fast as the subscribers keep up
+   */
+  explicit ReplayMarketDataFeed(std::vector<std::string> files,
+                                double speed = 1.0);
+
+  /**
+   * @brief Destructor
+   */
+  ~ReplayMarketDataFeed() override;
+
+  // Implementation of MarketDataFeed interface
+  bool start() override;
+  bool stop() override;
+  bool isRunning() const override;
+
+  bool subscribeToMarketUpdates(
+      const std::string& symbol,
+      std::function<void(const MarketUpdate&)> callback) override;
+
+  bool subscribeToOrderBookUpdates(
+      const std::string& symbol,
+      std::function<void(const OrderBookUpdate&)> callback) override;
+
+  bool unsubscribeFromMarketUpdates(const std::string& symbol) override;
+  bool unsubscribeFromOrderBookUpdates(const std::string& symbol) override;
+
+  void publishMarketUpdate(const MarketUpdate& update) override;
+  void publishOrderBookUpdate(const OrderBookUpdate& update) override;
+
+  /**
+   * @brief Receive every replayed frame as a batch of normalized events
+   *
+   * The callback runs on the replaying thread with events that are only
+   * valid during the call. Register before replaying.
+   */
+  void subscribeToEvents(
+      std::function<void(std::span<const MarketEvent>)> callback);
+
+  /**
+   * @brief Replay every capture on the calling thread, ignoring the speed
+   *
+   * @return Number of frames replayed
+   */
+  uint64_t replayAll();
+
+  /**
+   * @brief Whether the background replay has reached the end of the input
+   */
+  bool isFinished() const { return m_finished.load(std::memory_order_acquire); }
+
+  uint64_t getFramesReplayed() const {
+    return m_framesReplayed.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::vector<std::string> m_files;
+  double m_speed;
+
+  // Feed state
+  std::atomic<bool> m_isRunning{false};
+  std::atomic<bool> m_shouldStop{false};
+  std::atomic<bool> m_finished{false};
+  std::atomic<uint64_t> m_framesReplayed{0};
+
+  // Subscription management
+  std::unordered_map<std::string,
+                     std::vector<std::function<void(const MarketUpdate&)>>>
+      m_marketUpdateCallbacks;
+  std::unordered_map<std::string,
+                     std::vector<std::function<void(const OrderBookUpdate&)>>>
+      m_orderBookUpdateCallbacks;
+  std::vector<std::function<void(std::span<const MarketEvent>)>>
+      m_eventCallbacks;
+  std::mutex m_callbacksMutex;
+
+  // Replay thread
+  std::thread m_replayThread;
+
+  uint64_t replay(bool paced);
+  std::unique_ptr<NormalizedFeedHandler> createHandler(Venue venue);
+  bool waitUntil(uint64_t steadyNanos);
+};
+
+} // namespace capture
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,335 @@
+#include "CoinbaseMessageScanner.h"
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+using json::Cursor;
+using json::forEachElement;
+using json::forEachMember;
+
+/**
+ * @brief Ticker being assembled from whichever fields have been seen
+ */
+struct TickerFields {
+  FixedPointTicker ticker;
+  int64_t volume24h{0};
+  bool hasLastSize{false};
+
+  /**
+   * @brief Consume the value if the key is a ticker field
+   *
+   * @return false if the key is not a ticker field (value not consumed)
+   */
+  bool read(Cursor& c, std::string_view key) {
+    if (key == "product_id") {
+      c.string(ticker.symbol);
+    } else if (key == "price") {
+      c.decimal(ticker.price);
+    } else if (key == "best_bid") {
+      c.decimal(ticker.bidPrice);
+    } else if (key == "best_ask") {
+      c.decimal(ticker.askPrice);
+    } else if (key == "best_bid_quantity" || key == "best_bid_size") {
+      c.decimal(ticker.bidSize);
+    } else if (key == "best_ask_quantity" || key == "best_ask_size") {
+      c.decimal(ticker.askSize);
+    } else if (key == "last_size") {
+      hasLastSize = c.decimal(ticker.size);
+    } else if (key == "volume_24_h" || key == "volume_24h") {
+      c.decimal(volume24h);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  const FixedPointTicker& finish() {
+    if (!hasLastSize) {
+      ticker.size = volume24h;
+    }
+    return ticker;
+  }
+};
+
+bool scanTicker(Cursor& c, CoinbaseScanHandler& handler) {
+  TickerFields fields;
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    return fields.read(c, key) ? c.ok() : c.skipValue();
+  });
+  if (ok && !fields.ticker.symbol.empty()) {
+    handler.onTicker(fields.finish());
+  }
+  return ok;
+}
+
+/**
+ * @brief Scan an Advanced Trade updates array
+ */
+bool scanUpdates(Cursor& c, std::string_view symbol, BookEventType type,
+                 CoinbaseScanHandler& handler) {
+  handler.onBookEventBegin(symbol, type);
+  bool ok = forEachElement(c, [&]() {
+    std::string_view side;
+    BookDelta delta;
+    delta.symbol = symbol;
+    bool hasPrice = false;
+    bool hasQuantity = false;
+    bool parsed = forEachMember(c, [&](std::string_view key) {
+      if (key == "side") {
+        return c.string(side);
+      }
+      if (key == "price_level") {
+        hasPrice = c.decimal(delta.price);
+        return c.ok();
+      }
+      if (key == "new_quantity") {
+        hasQuantity = c.decimal(delta.quantity);
+        return c.ok();
+      }
+      return c.skipValue();
+    });
+    if (parsed && hasPrice && hasQuantity &&
+        (side == "bid" || side == "offer")) {
+      delta.isBid = side == "bid";
+      handler.onBookDelta(delta);
+    }
+    return parsed;
+  });
+  if (ok) {
+    handler.onBookEventEnd(symbol, type);
+  }
+  return ok;
+}
+
+/**
+ * @brief Scan a legacy l2update changes array of [side, price, size]
+ */
+bool scanChanges(Cursor& c, std::string_view symbol,
+                 CoinbaseScanHandler& handler) {
+  handler.onBookEventBegin(symbol, BookEventType::UPDATE);
+  bool ok = forEachElement(c, [&]() {
+    std::string_view side;
+    BookDelta delta;
+    delta.symbol = symbol;
+    if (!c.expect('[') || !c.string(side) || !c.expect(',')) {
+      return false;
+    }
+    bool hasPrice = c.decimal(delta.price);
+    if (!c.expect(',')) {
+      return false;
+    }
+    bool hasQuantity = c.decimal(delta.quantity);
+    while (c.consume(',')) {
+      c.skipValue();
+    }
+    if (!c.expect(']')) {
+      return false;
+    }
+    if (hasPrice && hasQuantity) {
+      if (side == "buy" || side == "bid") {
+        delta.isBid = true;
+        handler.onBookDelta(delta);
+      } else if (side == "sell" || side == "offer") {
+        handler.onBookDelta(delta);
+      }
+    }
+    return true;
+  });
+  if (ok) {
+    handler.onBookEventEnd(symbol, BookEventType::UPDATE);
+  }
+  return ok;
+}
+
+/**
+ * @brief Scan one level2 event object
+ */
+bool scanBookEvent(Cursor& c, CoinbaseScanHandler& handler) {
+  std::string_view type;
+  std::string_view symbol;
+  const char* deferredUpdates = nullptr;
+
+  auto eventType = [&type]() {
+    return type == "snapshot" ? BookEventType::SNAPSHOT : BookEventType::UPDATE;
+  };
+  auto knownType = [&type]() {
+    return type == "snapshot" || type == "update";
+  };
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "type") {
+      return c.string(type);
+    }
+    if (key == "product_id") {
+      return c.string(symbol);
+    }
+    if (key == "updates") {
+      if (!symbol.empty() && knownType()) {
+        return scanUpdates(c, symbol, eventType(), handler);
+      }
+      deferredUpdates = c.position();
+    }
+    return c.skipValue();
+  });
+
+  if (ok && deferredUpdates != nullptr && !symbol.empty() && knownType()) {
+    const char* end = c.position();
+    c.seek(deferredUpdates);
+    ok = scanUpdates(c, symbol, eventType(), handler);
+    c.seek(end);
+  }
+  return ok;
+}
+
+enum class Channel { NONE, TICKER, LEVEL2, HEARTBEATS, SUBSCRIPTIONS, OTHER };
+
+Channel classifyChannel(std::string_view channel) {
+  if (channel == "ticker" || channel == "ticker_batch") {
+    return Channel::TICKER;
+  }
+  if (channel == "l2_data" || channel == "level2") {
+    return Channel::LEVEL2;
+  }
+  if (channel == "heartbeats") {
+    return Channel::HEARTBEATS;
+  }
+  if (channel == "subscriptions") {
+    return Channel::SUBSCRIPTIONS;
+  }
+  return Channel::OTHER;
+}
+
+bool scanEvents(Cursor& c, Channel channel, CoinbaseScanHandler& handler) {
+  if (channel == Channel::LEVEL2) {
+    return forEachElement(c, [&]() { return scanBookEvent(c, handler); });
+  }
+  if (channel == Channel::TICKER) {
+    return forEachElement(c, [&]() {
+      return forEachMember(c, [&](std::string_view key) {
+        if (key == "tickers") {
+          return forEachElement(c, [&]() { return scanTicker(c, handler); });
+        }
+        return c.skipValue();
+      });
+    });
+  }
+  return c.skipValue();
+}
+
+} // namespace
+
+bool CoinbaseMessageScanner::parseFixedPoint(std::string_view text,
+                                             int64_t& value) {
+  return exchange::parseFixedPoint(text, value);
+}
+
+CoinbaseMessageKind
+CoinbaseMessageScanner::scan(std::string_view frame,
+                             CoinbaseScanHandler& handler) {
+  ++m_messagesScanned;
+  m_bytesScanned += frame.size();
+
+  Cursor c(frame);
+  std::string_view channelName;
+  std::string_view type;
+  Channel channel = Channel::NONE;
+  const char* deferredEvents = nullptr;
+  const char* changes = nullptr;
+  TickerFields legacyTicker;
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "channel") {
+      if (!c.string(channelName)) {
+        return false;
+      }
+      channel = classifyChannel(channelName);
+      return true;
+    }
+    if (key == "type") {
+      return c.string(type);
+    }
+    if (key == "events") {
+      if (channel != Channel::NONE) {
+        return scanEvents(c, channel, handler);
+      }
+      deferredEvents = c.position();
+      return c.skipValue();
+    }
+    if (key == "changes") {
+      changes = c.position();
+      return c.skipValue();
+    }
+    if (key == "sequence_num") {
+      uint64_t sequence = 0;
+      if (c.integer(sequence)) {
+        handler.onSequence(sequence);
+      }
+      return c.ok();
+    }
+    if (legacyTicker.read(c, key)) {
+      return c.ok();
+    }
+    return c.skipValue();
+  });
+
+  if (ok && !c.atEnd()) {
+    ok = c.fail();
+  }
+
+  if (ok && channel != Channel::NONE && deferredEvents != nullptr) {
+    c.seek(deferredEvents);
+    ok = scanEvents(c, channel, handler);
+  }
+
+  if (ok && channel == Channel::NONE && type == "l2update" &&
+      changes != nullptr && !legacyTicker.ticker.symbol.empty()) {
+    c.seek(changes);
+    ok = scanChanges(c, legacyTicker.ticker.symbol, handler);
+  }
+
+  if (!ok) {
+    ++m_malformedMessages;
+    return CoinbaseMessageKind::MALFORMED;
+  }
+
+  switch (channel) {
+  case Channel::TICKER:
+    return CoinbaseMessageKind::TICKER;
+  case Channel::LEVEL2:
+    return CoinbaseMessageKind::LEVEL2;
+  case Channel::HEARTBEATS:
+    return CoinbaseMessageKind::HEARTBEAT;
+  case Channel::SUBSCRIPTIONS:
+    return CoinbaseMessageKind::SUBSCRIPTIONS;
+  case Channel::OTHER:
+    return CoinbaseMessageKind::OTHER;
+  case Channel::NONE:
+    break;
+  }
+
+  // Legacy Exchange feed messages are identified by their type
+  if (type == "ticker") {
+    if (!legacyTicker.ticker.symbol.empty()) {
+      handler.onTicker(legacyTicker.finish());
+    }
+    return CoinbaseMessageKind::TICKER;
+  }
+  if (type == "l2update") {
+    return CoinbaseMessageKind::LEVEL2;
+  }
+  if (type == "heartbeat") {
+    return CoinbaseMessageKind::HEARTBEAT;
+  }
+  if (type == "subscriptions") {
+    return CoinbaseMessageKind::SUBSCRIPTIONS;
+  }
+  if (type == "error") {
+    return CoinbaseMessageKind::ERROR;
+  }
+  return CoinbaseMessageKind::OTHER;
+}
+
+} // namespace exchange
+} // namespace pinnacle
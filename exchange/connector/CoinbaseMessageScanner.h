@@ -0,0 +1,133 @@
+#pragma once
+
+#include "JsonCursor.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @struct FixedPointTicker
+ * @brief Ticker fields scanned from a Coinbase ticker message
+ *
+ * Prices and sizes are scaled by FIXED_POINT_SCALE; fields the message did
+ * not carry are zero. The symbol points into the scanned frame and is only
+ * valid during the handler call.
+ */
+struct FixedPointTicker {
+  std::string_view symbol;
+  int64_t price{0};
+  int64_t size{0}; // last_size, or volume_24_h when absent
+  int64_t bidPrice{0};
+  int64_t bidSize{0};
+  int64_t askPrice{0};
+  int64_t askSize{0};
+};
+
+/**
+ * @enum BookEventType
+ * @brief Whether a level2 event replaces the book or amends it
+ */
+enum class BookEventType { SNAPSHOT, UPDATE };
+
+/**
+ * @struct BookDelta
+ * @brief One price level change from a level2 event
+ */
+struct BookDelta {
+  std::string_view symbol; // Points into the scanned frame
+  bool isBid{false};
+  int64_t price{0};    // Scaled by FIXED_POINT_SCALE
+  int64_t quantity{0}; // New size at the level, zero removes it
+};
+
+/**
+ * @class CoinbaseScanHandler
+ * @brief Receives records as CoinbaseMessageScanner finds them
+ *
+ * Deltas of one level2 event arrive between onBookEventBegin() and
+ * onBookEventEnd(). If the frame turns out to be malformed part way
+ * through an event, onBookEventEnd() is not called for it.
+ */
+class CoinbaseScanHandler {
+public:
+  virtual ~CoinbaseScanHandler() = default;
+
+  virtual void onTicker(const FixedPointTicker& ticker) = 0;
+
+  virtual void onBookEventBegin(std::string_view /*symbol*/,
+                                BookEventType /*type*/) {}
+
+  virtual void onBookDelta(const BookDelta& delta) = 0;
+
+  virtual void onBookEventEnd(std::string_view /*symbol*/,
+                              BookEventType /*type*/) {}
+
+  /**
+   * @brief Connection-wide sequence_num of an Advanced Trade message
+   *
+   * May arrive before or after the records of its message.
+   */
+  virtual void onSequence(uint64_t /*sequence*/) {}
+};
+
+/**
+ * @enum CoinbaseMessageKind
+ * @brief What a scanned frame turned out to be
+ */
+enum class CoinbaseMessageKind {
+  TICKER,
+  LEVEL2,
+  HEARTBEAT,
+  SUBSCRIPTIONS,
+  ERROR,
+  OTHER,
+  MALFORMED
+};
+
+/**
+ * @class CoinbaseMessageScanner
+ * @brief Allocation-free scanner for Coinbase ticker and level2 messages
+ *
+ * Walks the frame once without building a DOM, extracting only the fields
+ * of the Advanced Trade ticker and level2/l2_data channels and of the
+ * legacy ticker and l2update messages. Other members are skipped
+ * structurally; strings are located with memchr. Decimal strings are
+ * converted straight to fixed point, truncating digits beyond 1e-8.
+ * Members may appear in any order: an events or updates array seen before
+ * the fields it depends on is skipped and revisited. Escape sequences are
+ * not decoded, which is fine for the identifiers and numbers extracted.
+ *
+ * Not thread-safe; use one scanner per feed thread.
+ */
+class CoinbaseMessageScanner {
+public:
+  /**
+   * @brief Scan one frame, reporting its records to the handler
+   */
+  CoinbaseMessageKind scan(std::string_view frame,
+                           CoinbaseScanHandler& handler);
+
+  uint64_t getMessagesScanned() const { return m_messagesScanned; }
+
+  uint64_t getBytesScanned() const { return m_bytesScanned; }
+
+  uint64_t getMalformedMessages() const { return m_malformedMessages; }
+
+  /**
+   * @brief Parse a decimal such as "109231.23" or "-1.5e-3" to fixed point
+   *
+   * @return false if the text is not a number or does not fit
+   */
+  static bool parseFixedPoint(std::string_view text, int64_t& value);
+
+private:
+  uint64_t m_messagesScanned{0};
+  uint64_t m_bytesScanned{0};
+  uint64_t m_malformedMessages{0};
+};
+
+} // namespace exchange
+} // namespace pinnacle
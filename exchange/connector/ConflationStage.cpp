@@ -0,0 +1,320 @@
+#include "ConflationStage.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+} // namespace
+
+ConflationStage::ConflationStage(size_t maxLevelsPerSide)
+    : m_maxLevelsPerSide(std::max<size_t>(maxLevelsPerSide, 1)) {}
+
+size_t ConflationStage::addSymbol(const std::string& symbol) {
+  auto it = m_symbolIndex.find(symbol);
+  if (it != m_symbolIndex.end()) {
+    return it->second;
+  }
+  size_t index = m_slots.size();
+  m_slots.emplace_back().symbol = symbol;
+  m_symbolIndex.emplace(symbol, index);
+  for (auto& consumer : m_consumers) {
+    consumer.cursors.emplace_back();
+  }
+  return index;
+}
+
+ConflationStage::ConsumerId ConflationStage::addConsumer(Notifier notifier) {
+  auto& consumer = m_consumers.emplace_back();
+  consumer.notifier = std::move(notifier);
+  for (size_t i = 0; i < m_slots.size(); ++i) {
+    consumer.cursors.emplace_back();
+  }
+  return static_cast<ConsumerId>(m_consumers.size() - 1);
+}
+
+std::optional<size_t>
+ConflationStage::findSymbol(const std::string& symbol) const {
+  auto it = m_symbolIndex.find(symbol);
+  if (it == m_symbolIndex.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void ConflationStage::attach(MarketDataFeed& feed) {
+  for (const auto& slot : m_slots) {
+    feed.subscribeToMarketUpdates(
+        slot.symbol,
+        [this](const MarketUpdate& update) { onMarketUpdate(update); });
+    feed.subscribeToOrderBookUpdates(
+        slot.symbol,
+        [this](const OrderBookUpdate& update) { onOrderBookUpdate(update); });
+  }
+}
+
+void ConflationStage::onMarketUpdate(const MarketUpdate& update) {
+  auto index = findSymbol(update.symbol);
+  if (!index) {
+    return;
+  }
+  Slot* slot = &m_slots[*index];
+
+  {
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    uint64_t seq = slot->topSequence.load(std::memory_order_relaxed);
+    slot->topSequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (update.bidPrice > 0.0) {
+      slot->bidPrice.store(update.bidPrice, std::memory_order_relaxed);
+    }
+    if (update.askPrice > 0.0) {
+      slot->askPrice.store(update.askPrice, std::memory_order_relaxed);
+    }
+    if (update.volume > 0.0) {
+      slot->lastPrice.store(update.price, std::memory_order_relaxed);
+      slot->cumulativeVolume.store(
+          slot->cumulativeVolume.load(std::memory_order_relaxed) +
+              update.volume,
+          std::memory_order_relaxed);
+    }
+    slot->timestamp.store(update.timestamp, std::memory_order_relaxed);
+
+    slot->topSequence.store(seq + 2, std::memory_order_release);
+    slot->version.fetch_add(1, std::memory_order_release);
+  }
+
+  m_updatesPublished.fetch_add(1, std::memory_order_relaxed);
+  notify(*index);
+}
+
+void ConflationStage::onOrderBookUpdate(const OrderBookUpdate& update) {
+  auto found = findSymbol(update.symbol);
+  if (!found) {
+    return;
+  }
+  size_t index = *found;
+  Slot* slot = &m_slots[index];
+
+  {
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    uint64_t version = slot->version.load(std::memory_order_relaxed) + 1;
+    for (const auto& [price, quantity] : update.bids) {
+      upsert(slot->bids, price, quantity, version, std::greater<double>());
+    }
+    for (const auto& [price, quantity] : update.asks) {
+      upsert(slot->asks, price, quantity, version, std::less<double>());
+    }
+
+    size_t size = std::max(slot->bids.size(), slot->asks.size());
+    if (size >= slot->pruneAt) {
+      prune(index, *slot);
+      size = std::max(slot->bids.size(), slot->asks.size());
+      if (size > m_maxLevelsPerSide) {
+        // Keep only this update; consumers that had not read everything
+        // before it rebuild from a reset instead
+        auto older = [version](const Level& level) {
+          return level.version < version;
+        };
+        std::erase_if(slot->bids, older);
+        std::erase_if(slot->asks, older);
+        slot->resetVersion = version - 1;
+        m_logOverflows.fetch_add(1, std::memory_order_relaxed);
+        size = std::max(slot->bids.size(), slot->asks.size());
+      }
+      slot->pruneAt =
+          std::min(std::max<size_t>(64, size * 2), m_maxLevelsPerSide + 1);
+    }
+    slot->version.store(version, std::memory_order_release);
+  }
+
+  m_updatesPublished.fetch_add(1, std::memory_order_relaxed);
+  notify(index);
+}
+
+void ConflationStage::resetBook(size_t symbol) {
+  if (symbol >= m_slots.size()) {
+    return;
+  }
+  Slot& slot = m_slots[symbol];
+  {
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    uint64_t version = slot.version.load(std::memory_order_relaxed) + 1;
+    slot.bids.clear();
+    slot.asks.clear();
+    slot.resetVersion = version;
+    slot.version.store(version, std::memory_order_release);
+  }
+  notify(symbol);
+}
+
+bool ConflationStage::isDirty(ConsumerId consumer, size_t symbol) const {
+  if (consumer >= m_consumers.size() || symbol >= m_slots.size()) {
+    return false;
+  }
+  return m_slots[symbol].version.load(std::memory_order_acquire) >
+         m_consumers[consumer].cursors[symbol].version.load(
+             std::memory_order_acquire);
+}
+
+bool ConflationStage::readTopOfBook(size_t symbol,
+                                    ConflatedTopOfBook& out) const {
+  if (symbol >= m_slots.size()) {
+    return false;
+  }
+  const Slot& slot = m_slots[symbol];
+
+  for (;;) {
+    uint64_t before = slot.topSequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      cpuRelax();
+      continue;
+    }
+    if (before == 0) {
+      return false; // Never published
+    }
+
+    out.bidPrice = slot.bidPrice.load(std::memory_order_relaxed);
+    out.askPrice = slot.askPrice.load(std::memory_order_relaxed);
+    out.lastPrice = slot.lastPrice.load(std::memory_order_relaxed);
+    out.cumulativeVolume =
+        slot.cumulativeVolume.load(std::memory_order_relaxed);
+    out.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.topSequence.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+}
+
+bool ConflationStage::read(ConsumerId consumer, size_t symbol,
+                           ConflatedBook& out) {
+  if (consumer >= m_consumers.size() || symbol >= m_slots.size()) {
+    return false;
+  }
+  Consumer& reader = m_consumers[consumer];
+  Cursor& cursor = reader.cursors[symbol];
+  Slot& slot = m_slots[symbol];
+
+  // Cleared first, so an update landing during the read notifies again
+  cursor.notified.store(false, std::memory_order_release);
+
+  uint64_t from = cursor.version.load(std::memory_order_relaxed);
+  if (slot.version.load(std::memory_order_acquire) <= from) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(slot.mutex);
+  uint64_t to = slot.version.load(std::memory_order_relaxed);
+
+  out.bids.clear();
+  out.asks.clear();
+  for (const auto& level : slot.bids) {
+    if (level.version > from) {
+      out.bids.emplace_back(level.price, level.quantity);
+    }
+  }
+  for (const auto& level : slot.asks) {
+    if (level.version > from) {
+      out.asks.emplace_back(level.price, level.quantity);
+    }
+  }
+  out.reset = from < slot.resetVersion;
+
+  if (!readTopOfBook(symbol, out.top)) {
+    out.top = ConflatedTopOfBook{};
+  }
+  out.tradedVolume = out.top.cumulativeVolume - cursor.cumulativeVolume;
+  cursor.cumulativeVolume = out.top.cumulativeVolume;
+  out.updates = to - from;
+
+  cursor.version.store(to, std::memory_order_release);
+  reader.reads.fetch_add(1, std::memory_order_relaxed);
+  reader.updatesConflated.fetch_add(out.updates - 1,
+                                    std::memory_order_relaxed);
+  return true;
+}
+
+uint64_t ConflationStage::version(size_t symbol) const {
+  return symbol < m_slots.size()
+             ? m_slots[symbol].version.load(std::memory_order_acquire)
+             : 0;
+}
+
+uint64_t ConflationStage::getReads(ConsumerId consumer) const {
+  return consumer < m_consumers.size()
+             ? m_consumers[consumer].reads.load(std::memory_order_relaxed)
+             : 0;
+}
+
+uint64_t ConflationStage::getUpdatesConflated(ConsumerId consumer) const {
+  return consumer < m_consumers.size()
+             ? m_consumers[consumer].updatesConflated.load(
+                   std::memory_order_relaxed)
+             : 0;
+}
+
+uint64_t ConflationStage::minCursor(size_t symbol) const {
+  uint64_t lowest = std::numeric_limits<uint64_t>::max();
+  for (const auto& consumer : m_consumers) {
+    lowest = std::min(lowest, consumer.cursors[symbol].version.load(
+                                  std::memory_order_acquire));
+  }
+  return lowest;
+}
+
+void ConflationStage::prune(size_t symbol, Slot& slot) {
+  // Without consumers nothing is ever read, so nothing needs keeping
+  uint64_t seen = minCursor(symbol);
+  auto read = [seen](const Level& level) { return level.version <= seen; };
+  std::erase_if(slot.bids, read);
+  std::erase_if(slot.asks, read);
+}
+
+void ConflationStage::notify(size_t symbol) {
+  for (auto& consumer : m_consumers) {
+    auto& notified = consumer.cursors[symbol].notified;
+    if (!notified.load(std::memory_order_relaxed) &&
+        !notified.exchange(true, std::memory_order_acq_rel) &&
+        consumer.notifier) {
+      consumer.notifier();
+    }
+  }
+}
+
+template <typename Better>
+void ConflationStage::upsert(std::vector<Level>& levels, double price,
+                             double quantity, uint64_t version,
+                             Better better) {
+  auto it = std::lower_bound(
+      levels.begin(), levels.end(), price,
+      [&](const Level& level, double value) {
+        return better(level.price, value);
+      });
+  if (it != levels.end() && it->price == price) {
+    it->quantity = quantity;
+    it->version = version;
+  } else {
+    levels.insert(it, Level{price, quantity, version});
+  }
+}
+
+} // namespace exchange
+} // namespace pinnacle
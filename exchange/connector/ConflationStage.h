@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../simulator/MarketDataFeed.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @struct ConflatedTopOfBook
+ * @brief Latest quote and trade for a symbol
+ */
+struct ConflatedTopOfBook {
+  double bidPrice{0.0};
+  double askPrice{0.0};
+  double lastPrice{0.0};
+  double cumulativeVolume{0.0}; // Traded since the stage started
+  uint64_t timestamp{0};        // Of the latest market update
+};
+
+/**
+ * @struct ConflatedBook
+ * @brief What changed for a symbol since a consumer's previous read
+ */
+struct ConflatedBook {
+  ConflatedTopOfBook top;
+
+  // Levels changed since the previous read, best first, each at its latest
+  // quantity; a quantity of 0 means the level was removed
+  std::vector<std::pair<double, double>> bids;
+  std::vector<std::pair<double, double>> asks;
+
+  double tradedVolume{0.0}; // Since the previous read
+  uint64_t updates{0};      // Feed updates folded into this read
+
+  // The consumer's copy of the book is out of date: discard it before
+  // applying the levels, which then only cover changes since the reset
+  bool reset{false};
+};
+
+/**
+ * @class ConflationStage
+ * @brief Per-symbol conflation between a market data feed and consumers
+ * that may not keep up with it
+ *
+ * The feed publishes into one slot per symbol instead of a queue per
+ * consumer. A slot holds the latest top of book, behind a seqlock so that
+ * readTopOfBook() never blocks, and a log of changed book levels, where a
+ * level updated again is overwritten in place. Every publish bumps the
+ * slot's version.
+ *
+ * Each consumer has a cursor per symbol holding the version it last read.
+ * The slot is dirty for the consumer while the version is ahead of the
+ * cursor, and read() returns everything that changed in between as one
+ * ConflatedBook. A slow consumer therefore gets fewer, larger reads of the
+ * freshest state rather than a backlog, and the feed never waits for it.
+ * The notifier given to addConsumer() runs on the feed thread when a slot
+ * turns dirty for that consumer, once until the consumer reads it.
+ *
+ * Levels every consumer has read are pruned from the log. If a lagging
+ * consumer lets a side grow past maxLevelsPerSide, the log is cleared and
+ * consumers behind that point get a read with reset set.
+ *
+ * Symbols and consumers are registered before the feed starts publishing.
+ * After that, any number of consumer threads may read, one thread per
+ * consumer.
+ */
+class ConflationStage {
+public:
+  using ConsumerId = uint32_t;
+  using Notifier = std::function<void()>;
+
+  explicit ConflationStage(size_t maxLevelsPerSide = 4096);
+
+  ConflationStage(const ConflationStage&) = delete;
+  ConflationStage& operator=(const ConflationStage&) = delete;
+
+  /**
+   * @brief Register a symbol, or look up one already registered
+   *
+   * @return Symbol index used by the consumer calls
+   */
+  size_t addSymbol(const std::string& symbol);
+
+  /**
+   * @brief Register a consumer with a cursor on every symbol
+   *
+   * @param notifier Called on the feed thread when a symbol turns dirty
+   */
+  ConsumerId addConsumer(Notifier notifier = {});
+
+  std::optional<size_t> findSymbol(const std::string& symbol) const;
+
+  /**
+   * @brief Subscribe to market and book updates of every registered symbol
+   */
+  void attach(MarketDataFeed& feed);
+
+  // Feed side
+
+  void onMarketUpdate(const MarketUpdate& update);
+  void onOrderBookUpdate(const OrderBookUpdate& update);
+
+  /**
+   * @brief Drop the level log, for instance after the feed resynchronized
+   * the book; every consumer's next read has reset set
+   */
+  void resetBook(size_t symbol);
+
+  // Consumer side
+
+  /**
+   * @brief Whether the symbol changed since the consumer's last read
+   */
+  bool isDirty(ConsumerId consumer, size_t symbol) const;
+
+  /**
+   * @brief Latest top of book without moving any cursor; lock-free
+   *
+   * @return false if no market update has been published yet
+   */
+  bool readTopOfBook(size_t symbol, ConflatedTopOfBook& out) const;
+
+  /**
+   * @brief Collect what changed since the consumer's last read and advance
+   * its cursor
+   *
+   * @param out Reused between reads; its vectors keep their capacity
+   * @return false, leaving out untouched, if nothing changed
+   */
+  bool read(ConsumerId consumer, size_t symbol, ConflatedBook& out);
+
+  /**
+   * @brief Number of updates published for a symbol
+   */
+  uint64_t version(size_t symbol) const;
+
+  size_t getSymbolCount() const { return m_slots.size(); }
+  size_t getConsumerCount() const { return m_consumers.size(); }
+
+  uint64_t getUpdatesPublished() const {
+    return m_updatesPublished.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getLogOverflows() const {
+    return m_logOverflows.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Reads by a consumer that returned data
+   */
+  uint64_t getReads(ConsumerId consumer) const;
+
+  /**
+   * @brief Updates a consumer skipped by reading several at once
+   */
+  uint64_t getUpdatesConflated(ConsumerId consumer) const;
+
+private:
+  struct Level {
+    double price;
+    double quantity;
+    uint64_t version; // Of the update that last changed the level
+  };
+
+  struct alignas(64) Slot {
+    std::string symbol;
+
+    // Seqlock over the top of book; odd while being written
+    std::atomic<uint64_t> topSequence{0};
+    std::atomic<double> bidPrice{0.0};
+    std::atomic<double> askPrice{0.0};
+    std::atomic<double> lastPrice{0.0};
+    std::atomic<double> cumulativeVolume{0.0};
+    std::atomic<uint64_t> timestamp{0};
+
+    std::atomic<uint64_t> version{0};
+
+    // Serializes publishers and guards the log against readers
+    std::mutex mutex;
+    std::vector<Level> bids; // Best (highest) first
+    std::vector<Level> asks; // Best (lowest) first
+    uint64_t resetVersion{0}; // Readers behind it get reset set
+    size_t pruneAt{64};
+  };
+
+  struct alignas(64) Cursor {
+    std::atomic<uint64_t> version{0};
+    std::atomic<bool> notified{false};
+    double cumulativeVolume{0.0};
+  };
+
+  struct Consumer {
+    Notifier notifier;
+    std::deque<Cursor> cursors; // One per symbol
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> updatesConflated{0};
+  };
+
+  size_t m_maxLevelsPerSide;
+  std::deque<Slot> m_slots;
+  std::unordered_map<std::string, size_t> m_symbolIndex;
+  std::deque<Consumer> m_consumers;
+
+  std::atomic<uint64_t> m_updatesPublished{0};
+  std::atomic<uint64_t> m_logOverflows{0};
+
+  uint64_t minCursor(size_t symbol) const;
+  void prune(size_t symbol, Slot& slot);
+  void notify(size_t symbol);
+
+  template <typename Better>
+  static void upsert(std::vector<Level>& levels, double price,
+                     double quantity, uint64_t version, Better better);
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,91 @@
+#include "JsonCursor.h"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+constexpr int FIXED_POINT_DIGITS = 8;
+
+constexpr int64_t POW10[FIXED_POINT_DIGITS + 1] = {
+    1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+
+} // namespace
+
+bool parseFixedPoint(std::string_view text, int64_t& value) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  bool negative = false;
+  if (p != end && *p == '-') {
+    negative = true;
+    ++p;
+  }
+
+  constexpr int64_t maxInteger =
+      std::numeric_limits<int64_t>::max() / FIXED_POINT_SCALE;
+  int64_t integer = 0;
+  const char* digits = p;
+  while (p != end && *p >= '0' && *p <= '9') {
+    integer = integer * 10 + (*p - '0');
+    if (integer > maxInteger) {
+      return false;
+    }
+    ++p;
+  }
+  bool hasInteger = p != digits;
+
+  int64_t fraction = 0;
+  int fractionDigits = 0;
+  bool hasFraction = false;
+  if (p != end && *p == '.') {
+    ++p;
+    const char* start = p;
+    while (p != end && *p >= '0' && *p <= '9') {
+      if (fractionDigits < FIXED_POINT_DIGITS) {
+        fraction = fraction * 10 + (*p - '0');
+        ++fractionDigits;
+      }
+      ++p;
+    }
+    hasFraction = p != start;
+  }
+  if (!hasInteger && !hasFraction) {
+    return false;
+  }
+
+  if (p != end) {
+    if (*p != 'e' && *p != 'E') {
+      return false;
+    }
+    // Exponents are rare on the wire; take the slow path
+    double parsed = 0.0;
+    auto [ptr, ec] = std::from_chars(text.data(), end, parsed);
+    if (ec != std::errc() || ptr != end) {
+      return false;
+    }
+    double scaled = parsed * static_cast<double>(FIXED_POINT_SCALE);
+    if (!(std::abs(scaled) <
+          static_cast<double>(std::numeric_limits<int64_t>::max()))) {
+      return false;
+    }
+    value = static_cast<int64_t>(scaled);
+    return true;
+  }
+
+  int64_t scaledFraction =
+      fraction * POW10[FIXED_POINT_DIGITS - fractionDigits];
+  if (scaledFraction >
+      std::numeric_limits<int64_t>::max() - integer * FIXED_POINT_SCALE) {
+    return false;
+  }
+  int64_t result = integer * FIXED_POINT_SCALE + scaledFraction;
+  value = negative ? -result : result;
+  return true;
+}
+
+} // namespace exchange
+} // namespace pinnacle
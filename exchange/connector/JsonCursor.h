@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @brief Scale of fixed-point prices and sizes: 1 unit = 1e-8
+ */
+constexpr int64_t FIXED_POINT_SCALE = 100'000'000;
+
+inline double fromFixedPoint(int64_t value) {
+  return static_cast<double>(value) / static_cast<double>(FIXED_POINT_SCALE);
+}
+
+/**
+ * @brief Parse a decimal such as "109231.23" or "-1.5e-3" to fixed point
+ *
+ * Digits beyond 1e-8 are truncated.
+ *
+ * @return false if the text is not a number or does not fit
+ */
+bool parseFixedPoint(std::string_view text, int64_t& value);
+
+namespace json {
+
+/**
+ * @class Cursor
+ * @brief Position in a frame with the JSON primitives the venue scanners need
+ *
+ * Any syntax error moves the cursor to the end and marks it failed, so
+ * callers only have to check ok() once a structure is done. Strings are
+ * located with memchr and returned raw, without decoding escapes.
+ */
+class Cursor {
+public:
+  explicit Cursor(std::string_view text)
+      : m_pos(text.data()), m_end(text.data() + text.size()) {}
+
+  bool ok() const { return !m_failed; }
+
+  bool atEnd() {
+    skipWhitespace();
+    return m_pos == m_end;
+  }
+
+  const char* position() const { return m_pos; }
+
+  void seek(const char* pos) { m_pos = pos; }
+
+  /**
+   * @brief Next significant character, or '\0' at the end
+   */
+  char peek() {
+    skipWhitespace();
+    return m_pos == m_end ? '\0' : *m_pos;
+  }
+
+  bool fail() {
+    m_failed = true;
+    m_pos = m_end;
+    return false;
+  }
+
+  bool consume(char c) {
+    skipWhitespace();
+    if (m_pos != m_end && *m_pos == c) {
+      ++m_pos;
+      return true;
+    }
+    return false;
+  }
+
+  bool expect(char c) { return consume(c) || fail(); }
+
+  /**
+   * @brief Read a string, returning its raw contents between the quotes
+   */
+  bool string(std::string_view& out) {
+    if (!expect('"')) {
+      return false;
+    }
+    const char* start = m_pos;
+    if (!skipStringBody()) {
+      return false;
+    }
+    out = std::string_view(start, static_cast<size_t>(m_pos - start - 1));
+    return true;
+  }
+
+  /**
+   * @brief Read a number or numeric string as fixed point
+   *
+   * A well-formed value that is not numeric (null, "", an object) is
+   * skipped and reported as absent without failing the cursor.
+   */
+  bool decimal(int64_t& out) {
+    std::string_view text;
+    return scalar(text) && parseFixedPoint(text, out);
+  }
+
+  /**
+   * @brief Read a non-negative integer or integer string, such as a
+   * sequence number
+   *
+   * Like decimal(), a value that is not an integer is skipped and reported
+   * as absent.
+   */
+  bool integer(uint64_t& out) {
+    std::string_view text;
+    if (!scalar(text) || text.empty()) {
+      return false;
+    }
+    uint64_t value = 0;
+    for (char c : text) {
+      if (c < '0' || c > '9' || value > (UINT64_MAX - 9) / 10) {
+        return false;
+      }
+      value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    out = value;
+    return true;
+  }
+
+  /**
+   * @brief Read true or false; any other value is skipped as absent
+   */
+  bool boolean(bool& out) {
+    char c = peek();
+    bool isBoolean = c == 't' || c == 'f';
+    if (isBoolean) {
+      out = c == 't';
+    }
+    return skipValue() && isBoolean;
+  }
+
+  /**
+   * @brief Skip one value of any type
+   */
+  bool skipValue() {
+    skipWhitespace();
+    if (m_pos == m_end) {
+      return fail();
+    }
+    char c = *m_pos;
+    if (c == '"') {
+      ++m_pos;
+      return skipStringBody();
+    }
+    if (c == '{' || c == '[') {
+      return skipContainer();
+    }
+    const char* start = m_pos;
+    while (m_pos != m_end && !isDelimiter(*m_pos)) {
+      ++m_pos;
+    }
+    return m_pos != start || fail();
+  }
+
+private:
+  const char* m_pos;
+  const char* m_end;
+  bool m_failed{false};
+
+  static bool isDelimiter(char c) {
+    return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' ||
+           c == '\r' || c == '\t';
+  }
+
+  void skipWhitespace() {
+    while (m_pos != m_end &&
+           (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' ||
+            *m_pos == '\t')) {
+      ++m_pos;
+    }
+  }
+
+  /**
+   * @brief Read the text of a number or string; skip anything else
+   */
+  bool scalar(std::string_view& text) {
+    skipWhitespace();
+    if (m_pos == m_end) {
+      return fail();
+    }
+    if (*m_pos == '"') {
+      return string(text);
+    }
+    if (*m_pos == '-' || (*m_pos >= '0' && *m_pos <= '9')) {
+      const char* start = m_pos;
+      while (m_pos != m_end && !isDelimiter(*m_pos)) {
+        ++m_pos;
+      }
+      text = std::string_view(start, static_cast<size_t>(m_pos - start));
+      return true;
+    }
+    skipValue();
+    return false;
+  }
+
+  /**
+   * @brief Advance past the closing quote of a string already opened
+   */
+  bool skipStringBody() {
+    while (true) {
+      const void* quote =
+          std::memchr(m_pos, '"', static_cast<size_t>(m_end - m_pos));
+      if (quote == nullptr) {
+        return fail();
+      }
+      const char* q = static_cast<const char*>(quote);
+      // The quote is escaped if preceded by an odd run of backslashes
+      const char* b = q;
+      while (b != m_pos && b[-1] == '\\') {
+        --b;
+      }
+      m_pos = q + 1;
+      if (((q - b) & 1) == 0) {
+        return true;
+      }
+    }
+  }
+
+  bool skipContainer() {
+    int depth = 0;
+    while (m_pos != m_end) {
+      char c = *m_pos++;
+      if (c == '"') {
+        if (!skipStringBody()) {
+          return false;
+        }
+      } else if (c == '{' || c == '[') {
+        ++depth;
+      } else if (c == '}' || c == ']') {
+        if (--depth == 0) {
+          return true;
+        }
+      }
+    }
+    return fail();
+  }
+};
+
+/**
+ * @brief Visit each member of an object; the visitor must consume the value
+ */
+template <typename Visitor> bool forEachMember(Cursor& c, Visitor&& visit) {
+  if (!c.expect('{')) {
+    return false;
+  }
+  if (c.consume('}')) {
+    return true;
+  }
+  do {
+    std::string_view key;
+    if (!c.string(key) || !c.expect(':') || !visit(key)) {
+      return c.fail();
+    }
+  } while (c.consume(','));
+  return c.expect('}');
+}
+
+/**
+ * @brief Visit each element of an array; the visitor must consume it
+ */
+template <typename Visitor> bool forEachElement(Cursor& c, Visitor&& visit) {
+  if (!c.expect('[')) {
+    return false;
+  }
+  if (c.consume(']')) {
+    return true;
+  }
+  do {
+    if (!visit()) {
+      return c.fail();
+    }
+  } while (c.consume(','));
+  return c.expect(']');
+}
+
+} // namespace json
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @enum Venue
+ * @brief Exchanges with a market data decoder
+ */
+enum class Venue : uint8_t { COINBASE, KRAKEN, GEMINI, BINANCE, BITSTAMP };
+
+/**
+ * @enum MarketEventType
+ * @brief What a normalized market event describes
+ */
+enum class MarketEventType : uint8_t {
+  BOOK_DELTA, // New quantity at one price level, zero removes it
+  TRADE,      // One trade, side is the aggressor
+  BBO,        // Best bid in price/quantity, best ask in askPrice/askQuantity
+  BOOK_RESET  // Discard the book for the symbol
+};
+
+/**
+ * @enum EventSide
+ * @brief Book side of a delta, or aggressor side of a trade
+ */
+enum class EventSide : uint8_t { NONE, BID, ASK };
+
+/**
+ * @brief MarketEvent::flags bit set on a reset and the deltas that rebuild
+ * the book from a snapshot
+ */
+constexpr uint8_t EVENT_FLAG_SNAPSHOT = 0x01;
+
+/**
+ * @struct MarketEvent
+ * @brief One normalized market data event, in a fixed 64-byte layout
+ *
+ * Every venue decoder produces the same record, so consumers handle all
+ * venues alike. Prices and quantities are fixed point scaled by
+ * FIXED_POINT_SCALE. Times are nanoseconds since the epoch;
+ * venueTimestamp is zero when the venue does not send one, and sequence
+ * is zero for venues without sequence numbers.
+ */
+struct MarketEvent {
+  uint64_t receivedAt;
+  uint64_t venueTimestamp;
+  uint64_t sequence;
+  int64_t price;
+  int64_t quantity;
+  int64_t askPrice;    // BBO only
+  int64_t askQuantity; // BBO only
+  uint32_t symbolId;   // Index into the handler's SymbolTable
+  MarketEventType type;
+  EventSide side;
+  uint8_t flags;
+  Venue venue;
+};
+
+static_assert(sizeof(MarketEvent) == 64, "MarketEvent must fill a cache line");
+static_assert(std::is_trivially_copyable_v<MarketEvent>);
+
+/**
+ * @class SymbolTable
+ * @brief Interns symbols to dense ids, mapping venue spellings to canonical
+ * ones
+ *
+ * Venues spell the same instrument differently (BTC-USD, BTCUSD, BTC/USD,
+ * btcusd). An alias makes a venue spelling resolve to the id of the
+ * canonical symbol, so events carry the symbol subscribers asked for.
+ * Lookups are a linear scan behind a last-hit cache, which beats hashing
+ * for the handful of symbols one feed carries.
+ */
+class SymbolTable {
+public:
+  /**
+   * @brief Id of a symbol, adding it if unseen
+   */
+  uint32_t intern(std::string_view symbol) {
+    if (m_lastHit < m_keys.size() && m_keys[m_lastHit].first == symbol) {
+      return m_keys[m_lastHit].second;
+    }
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+      if (m_keys[i].first == symbol) {
+        m_lastHit = i;
+        return m_keys[i].second;
+      }
+    }
+    uint32_t id = static_cast<uint32_t>(m_names.size());
+    m_names.emplace_back(symbol);
+    m_lastHit = m_keys.size();
+    m_keys.emplace_back(std::string(symbol), id);
+    return id;
+  }
+
+  /**
+   * @brief Make a venue spelling resolve to the id of a canonical symbol
+   */
+  uint32_t alias(std::string_view venueSymbol, std::string_view canonical) {
+    uint32_t id = intern(canonical);
+    for (auto& key : m_keys) {
+      if (key.first == venueSymbol) {
+        key.second = id;
+        return id;
+      }
+    }
+    m_keys.emplace_back(std::string(venueSymbol), id);
+    return id;
+  }
+
+  /**
+   * @brief Canonical name of an id
+   */
+  const std::string& name(uint32_t id) const { return m_names[id]; }
+
+  size_t size() const { return m_names.size(); }
+
+private:
+  std::vector<std::string> m_names;
+  std::vector<std::pair<std::string, uint32_t>> m_keys;
+  size_t m_lastHit{0};
+};
+
+/**
+ * @class MarketEventBuffer
+ * @brief Events decoded from one frame
+ *
+ * Reused from frame to frame; once the vector has grown, decoding
+ * allocates nothing.
+ */
+class MarketEventBuffer {
+public:
+  explicit MarketEventBuffer(SymbolTable& symbols) : m_symbols(symbols) {}
+
+  /**
+   * @brief Start a new frame, stamping its events with the venue and time
+   */
+  void reset(Venue venue, uint64_t receivedAt) {
+    m_events.clear();
+    m_venue = venue;
+    m_receivedAt = receivedAt;
+  }
+
+  uint32_t symbol(std::string_view venueSymbol) {
+    return m_symbols.intern(venueSymbol);
+  }
+
+  /**
+   * @brief Append a zeroed event of the given type
+   */
+  MarketEvent& append(MarketEventType type, uint32_t symbolId) {
+    MarketEvent& event = m_events.emplace_back();
+    event.receivedAt = m_receivedAt;
+    event.symbolId = symbolId;
+    event.type = type;
+    event.venue = m_venue;
+    return event;
+  }
+
+  std::vector<MarketEvent>& events() { return m_events; }
+
+  std::span<const MarketEvent> view() const { return m_events; }
+
+  size_t size() const { return m_events.size(); }
+
+  const SymbolTable& symbols() const { return m_symbols; }
+
+private:
+  SymbolTable& m_symbols;
+  std::vector<MarketEvent> m_events;
+  Venue m_venue{Venue::COINBASE};
+  uint64_t m_receivedAt{0};
+};
+
+/**
+ * @enum FrameKind
+ * @brief What a decoded frame turned out to be
+ */
+enum class FrameKind : uint8_t {
+  DATA,      // Market data events, possibly none
+  SNAPSHOT,  // A book snapshot, possibly with other events
+  HEARTBEAT, // Keep-alive
+  CONTROL,   // Subscription acknowledgement or other venue status
+  ERROR,     // Venue reported an error
+  MALFORMED, // Not valid JSON
+  IGNORED    // Valid but of no interest
+};
+
+/**
+ * @struct DecodedFrame
+ * @brief Result of decoding one frame, with its sequence numbers if any
+ *
+ * Sequence numbers are checked per stream: either one symbol's book
+ * (sequenceStream is its id) or the whole connection.
+ */
+struct DecodedFrame {
+  static constexpr uint32_t NO_SEQUENCE = UINT32_MAX;
+  static constexpr uint32_t CONNECTION_SEQUENCE = UINT32_MAX - 1;
+
+  FrameKind kind{FrameKind::IGNORED};
+  uint32_t sequenceStream{NO_SEQUENCE};
+  uint64_t firstSequence{0};
+  uint64_t lastSequence{0};
+};
+
+} // namespace exchange
+} // namespace pinnacle
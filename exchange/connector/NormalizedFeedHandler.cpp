@@ -0,0 +1,301 @@
+#include "NormalizedFeedHandler.h"
+#include "../../core/utils/TimeUtils.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace pinnacle {
+namespace exchange {
+
+NormalizedFeedHandler::NormalizedFeedHandler(
+    std::unique_ptr<VenueDecoder> decoder)
+    : m_decoder(std::move(decoder)), m_buffer(m_symbols) {}
+
+uint32_t NormalizedFeedHandler::addSymbol(const std::string& canonical) {
+  uint32_t symbolId =
+      m_symbols.alias(m_decoder->venueSymbol(canonical), canonical);
+  state(symbolId);
+  return symbolId;
+}
+
+FrameKind NormalizedFeedHandler::process(std::string_view frame,
+                                         uint64_t receivedAt,
+                                         uint64_t kernelReceivedAt) {
+  m_update.kernelTimestamp = kernelReceivedAt;
+  m_buffer.reset(m_decoder->venue(), receivedAt);
+  DecodedFrame decoded = m_decoder->decode(frame, receivedAt, m_buffer);
+  ++m_framesDecoded;
+
+  if (decoded.kind == FrameKind::MALFORMED) {
+    ++m_malformedFrames;
+    return decoded.kind;
+  }
+
+  auto& events = m_buffer.events();
+  if (checkSequence(decoded)) {
+    filterEvents();
+  } else {
+    m_deltasDropped += static_cast<uint64_t>(
+        std::count_if(events.begin(), events.end(), [](const auto& event) {
+          return event.type == MarketEventType::BOOK_DELTA;
+        }));
+    events.clear();
+  }
+
+  // Books invalidated by this frame are reset before its events
+  if (!m_pendingResets.empty()) {
+    MarketEvent reset{};
+    reset.receivedAt = receivedAt;
+    reset.type = MarketEventType::BOOK_RESET;
+    reset.venue = m_decoder->venue();
+    for (uint32_t symbolId : m_pendingResets) {
+      reset.symbolId = symbolId;
+      events.insert(events.begin(), reset);
+    }
+    m_pendingResets.clear();
+  }
+
+  if (events.empty()) {
+    return decoded.kind;
+  }
+  m_eventsDecoded += events.size();
+  if (m_eventSink) {
+    m_eventSink(m_buffer.view());
+  }
+  publishLegacy(receivedAt);
+  return decoded.kind;
+}
+
+void NormalizedFeedHandler::requestResync(uint32_t symbolId) {
+  markStale(symbolId);
+  if (m_pendingResets.empty()) {
+    return;
+  }
+  MarketEvent reset{};
+  reset.receivedAt = utils::TimeUtils::getWallClockNanos();
+  reset.symbolId = symbolId;
+  reset.type = MarketEventType::BOOK_RESET;
+  reset.venue = m_decoder->venue();
+  m_pendingResets.clear();
+  if (m_eventSink) {
+    m_eventSink(std::span<const MarketEvent>(&reset, 1));
+  }
+}
+
+bool NormalizedFeedHandler::isStale(uint32_t symbolId) const {
+  return symbolId < m_states.size() && m_states[symbolId].stale;
+}
+
+NormalizedFeedHandler::SymbolState&
+NormalizedFeedHandler::state(uint32_t symbolId) {
+  if (symbolId >= m_states.size()) {
+    m_states.resize(symbolId + 1);
+  }
+  return m_states[symbolId];
+}
+
+bool NormalizedFeedHandler::checkSequence(const DecodedFrame& decoded) {
+  if (decoded.sequenceStream == DecodedFrame::NO_SEQUENCE) {
+    return true;
+  }
+
+  // One sequence for the whole connection: a gap may have hidden a change
+  // to any book, so all of them are resynchronized
+  if (decoded.sequenceStream == DecodedFrame::CONNECTION_SEQUENCE) {
+    if (m_hasConnectionSequence) {
+      if (decoded.lastSequence <= m_connectionSequence) {
+        ++m_framesOutOfOrder;
+        return false;
+      }
+      if (decoded.firstSequence > m_connectionSequence + 1) {
+        ++m_sequenceGaps;
+        spdlog::warn("{} sequence gap: expected {}, got {}",
+                     venueName(m_decoder->venue()), m_connectionSequence + 1,
+                     decoded.firstSequence);
+        for (uint32_t id = 0; id < m_states.size(); ++id) {
+          if (m_states[id].hasBook) {
+            markStale(id);
+          }
+        }
+      }
+    }
+    m_connectionSequence = decoded.lastSequence;
+    m_hasConnectionSequence = true;
+    return true;
+  }
+
+  // One sequence per book
+  SymbolState& book = state(decoded.sequenceStream);
+  if (decoded.kind == FrameKind::SNAPSHOT) {
+    // A snapshot older than the deltas already applied would roll the
+    // book back
+    if (book.hasSequence && !book.stale &&
+        decoded.lastSequence < book.lastSequence) {
+      ++m_framesOutOfOrder;
+      return false;
+    }
+    book.lastSequence = decoded.lastSequence;
+    book.hasSequence = true;
+    return true;
+  }
+  if (book.stale) {
+    return false;
+  }
+  if (book.hasSequence) {
+    if (decoded.lastSequence <= book.lastSequence) {
+      ++m_framesOutOfOrder;
+      return false;
+    }
+    if (decoded.firstSequence > book.lastSequence + 1) {
+      ++m_sequenceGaps;
+      spdlog::warn("{} sequence gap on {}: expected {}, got {}",
+                   venueName(m_decoder->venue()),
+                   m_symbols.name(decoded.sequenceStream),
+                   book.lastSequence + 1, decoded.firstSequence);
+      markStale(decoded.sequenceStream);
+      return false;
+    }
+  }
+  book.lastSequence = decoded.lastSequence;
+  book.hasSequence = true;
+  return true;
+}
+
+void NormalizedFeedHandler::markStale(uint32_t symbolId) {
+  SymbolState& book = state(symbolId);
+  if (book.stale) {
+    return;
+  }
+  book.stale = true;
+  book.hasSequence = false;
+  m_pendingResets.push_back(symbolId);
+  ++m_resyncsRequested;
+  send(m_decoder->resyncRequest(m_symbols.name(symbolId)));
+}
+
+void NormalizedFeedHandler::filterEvents() {
+  auto& events = m_buffer.events();
+  auto kept = events.begin();
+  for (auto it = events.begin(); it != events.end(); ++it) {
+    SymbolState& book = state(it->symbolId);
+    if (it->type == MarketEventType::BOOK_RESET &&
+        (it->flags & EVENT_FLAG_SNAPSHOT) != 0) {
+      book.hasBook = true;
+      if (book.stale) {
+        book.stale = false;
+        ++m_resyncsCompleted;
+        spdlog::info("{} book for {} resynchronized",
+                     venueName(m_decoder->venue()),
+                     m_symbols.name(it->symbolId));
+        send(m_decoder->resyncComplete(m_symbols.name(it->symbolId)));
+      }
+    } else if (it->type == MarketEventType::BOOK_DELTA) {
+      if (book.stale) {
+        ++m_deltasDropped;
+        continue;
+      }
+      book.hasBook = true;
+    }
+    *kept++ = *it;
+  }
+  events.erase(kept, events.end());
+}
+
+void NormalizedFeedHandler::publishLegacy(uint64_t receivedAt) {
+  if (!m_marketUpdateSink && !m_orderBookUpdateSink) {
+    return;
+  }
+
+  for (const auto& event : m_buffer.view()) {
+    SymbolState& book = state(event.symbolId);
+    switch (event.type) {
+    case MarketEventType::BBO:
+      book.bidPrice = event.price;
+      book.askPrice = event.askPrice;
+      if (!book.bboChanged) {
+        book.bboChanged = true;
+        m_bboChanged.push_back(event.symbolId);
+      }
+      break;
+    case MarketEventType::TRADE:
+      book.lastPrice = event.price;
+      book.bboChanged = false;
+      publishMarketUpdate(event.symbolId, book, event.price, event.quantity,
+                          event.side, receivedAt);
+      break;
+    case MarketEventType::BOOK_DELTA:
+      if ((event.flags & EVENT_FLAG_SNAPSHOT) != 0 ||
+          !m_orderBookUpdateSink) {
+        break;
+      }
+      if (event.symbolId != m_bookSymbol) {
+        flushBook(receivedAt);
+        m_bookSymbol = event.symbolId;
+        m_book.symbol.assign(m_symbols.name(event.symbolId));
+        m_book.bids.clear();
+        m_book.asks.clear();
+      }
+      (event.side == EventSide::BID ? m_book.bids : m_book.asks)
+          .emplace_back(fromFixedPoint(event.price),
+                        fromFixedPoint(event.quantity));
+      break;
+    case MarketEventType::BOOK_RESET:
+      break;
+    }
+  }
+  flushBook(receivedAt);
+
+  // A BBO change without a trade still moves the quote strategies see
+  for (uint32_t symbolId : m_bboChanged) {
+    SymbolState& book = m_states[symbolId];
+    if (book.bboChanged) {
+      book.bboChanged = false;
+      int64_t price = book.lastPrice != 0
+                          ? book.lastPrice
+                          : book.bidPrice / 2 + book.askPrice / 2;
+      publishMarketUpdate(symbolId, book, price, 0, EventSide::NONE,
+                          receivedAt);
+    }
+  }
+  m_bboChanged.clear();
+}
+
+void NormalizedFeedHandler::publishMarketUpdate(uint32_t symbolId,
+                                                const SymbolState& state,
+                                                int64_t price,
+                                                int64_t quantity,
+                                                EventSide side,
+                                                uint64_t receivedAt) {
+  if (!m_marketUpdateSink) {
+    return;
+  }
+  m_update.symbol.assign(m_symbols.name(symbolId));
+  m_update.price = fromFixedPoint(price);
+  m_update.volume = fromFixedPoint(quantity);
+  m_update.timestamp = receivedAt;
+  m_update.isBuy = side == EventSide::BID;
+  m_update.bidPrice = fromFixedPoint(state.bidPrice);
+  m_update.askPrice = fromFixedPoint(state.askPrice);
+  m_marketUpdateSink(m_update);
+}
+
+void NormalizedFeedHandler::flushBook(uint64_t receivedAt) {
+  if (m_bookSymbol == NO_SYMBOL) {
+    return;
+  }
+  m_bookSymbol = NO_SYMBOL;
+  m_book.timestamp = receivedAt;
+  m_orderBookUpdateSink(m_book);
+}
+
+void NormalizedFeedHandler::send(const std::vector<std::string>& messages) {
+  if (!m_messageSender) {
+    return;
+  }
+  for (const auto& message : messages) {
+    m_messageSender(message);
+  }
+}
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "../simulator/MarketDataFeed.h"
+#include "MarketEvent.h"
+#include "VenueDecoder.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class NormalizedFeedHandler
+ * @brief Decodes one venue's frames into normalized events, checking
+ * sequence numbers and resynchronizing books after a gap
+ *
+ * Each frame is decoded by the venue's VenueDecoder into a reused
+ * MarketEventBuffer. Where the venue numbers its messages, the handler
+ * checks the numbers per stream: a repeated or older frame is dropped,
+ * and a gap invalidates the affected books. An invalidated book gets a
+ * BOOK_RESET event, its deltas are dropped from then on, and the decoder's
+ * resync request is sent; the next snapshot for the symbol brings it back.
+ *
+ * Events of a frame are passed to the event sink as one batch. For
+ * MarketDataFeed subscribers they are also assembled into the legacy
+ * records: one MarketUpdate per trade, or per frame for a BBO change
+ * without a trade, and one OrderBookUpdate per run of deltas for a symbol.
+ * Snapshots are not forwarded as OrderBookUpdate, since those subscribers
+ * apply updates as deltas.
+ *
+ * Not thread-safe; use one handler per feed thread.
+ */
+class NormalizedFeedHandler {
+public:
+  using EventSink = std::function<void(std::span<const MarketEvent>)>;
+  using MarketUpdateSink = std::function<void(const MarketUpdate&)>;
+  using OrderBookUpdateSink = std::function<void(const OrderBookUpdate&)>;
+  using MessageSender = std::function<void(const std::string&)>;
+
+  explicit NormalizedFeedHandler(std::unique_ptr<VenueDecoder> decoder);
+
+  NormalizedFeedHandler(const NormalizedFeedHandler&) = delete;
+  NormalizedFeedHandler& operator=(const NormalizedFeedHandler&) = delete;
+
+  void setEventSink(EventSink sink) { m_eventSink = std::move(sink); }
+
+  void setMarketUpdateSink(MarketUpdateSink sink) {
+    m_marketUpdateSink = std::move(sink);
+  }
+
+  void setOrderBookUpdateSink(OrderBookUpdateSink sink) {
+    m_orderBookUpdateSink = std::move(sink);
+  }
+
+  /**
+   * @brief Set where resync messages are sent, normally the venue socket
+   */
+  void setMessageSender(MessageSender sender) {
+    m_messageSender = std::move(sender);
+  }
+
+  /**
+   * @brief Register a canonical symbol so the venue's spelling of it maps
+   * to the canonical name
+   *
+   * @return Symbol id used in events
+   */
+  uint32_t addSymbol(const std::string& canonical);
+
+  /**
+   * @brief Decode one frame and pass its events to the sinks
+   *
+   * @param receivedAt Wall-clock receive time, stamped on every event
+   * @param kernelReceivedAt Socket receive timestamp, passed on as
+   * MarketUpdate::kernelTimestamp; 0 if unknown
+   */
+  FrameKind process(std::string_view frame, uint64_t receivedAt,
+                    uint64_t kernelReceivedAt = 0);
+
+  /**
+   * @brief Invalidate a book and ask the venue for a fresh snapshot
+   *
+   * For venues without sequence numbers this is the only way to resync,
+   * for instance after a reconnect.
+   */
+  void requestResync(uint32_t symbolId);
+
+  /**
+   * @brief Whether a book is waiting for a snapshot after a gap or resync
+   */
+  bool isStale(uint32_t symbolId) const;
+
+  VenueDecoder& getDecoder() { return *m_decoder; }
+
+  const SymbolTable& getSymbols() const { return m_symbols; }
+
+  uint64_t getFramesDecoded() const { return m_framesDecoded; }
+  uint64_t getEventsDecoded() const { return m_eventsDecoded; }
+  uint64_t getMalformedFrames() const { return m_malformedFrames; }
+  uint64_t getSequenceGaps() const { return m_sequenceGaps; }
+  uint64_t getFramesOutOfOrder() const { return m_framesOutOfOrder; }
+  uint64_t getResyncsRequested() const { return m_resyncsRequested; }
+  uint64_t getResyncsCompleted() const { return m_resyncsCompleted; }
+  uint64_t getDeltasDropped() const { return m_deltasDropped; }
+
+private:
+  static constexpr uint32_t NO_SYMBOL = UINT32_MAX;
+
+  struct SymbolState {
+    uint64_t lastSequence{0};
+    bool hasSequence{false};
+    bool stale{false};
+    bool hasBook{false};
+    bool bboChanged{false};
+    int64_t bidPrice{0};
+    int64_t askPrice{0};
+    int64_t lastPrice{0};
+  };
+
+  std::unique_ptr<VenueDecoder> m_decoder;
+  SymbolTable m_symbols;
+  MarketEventBuffer m_buffer;
+  std::vector<SymbolState> m_states;
+  uint64_t m_connectionSequence{0};
+  bool m_hasConnectionSequence{false};
+  std::vector<uint32_t> m_pendingResets;
+
+  EventSink m_eventSink;
+  MarketUpdateSink m_marketUpdateSink;
+  OrderBookUpdateSink m_orderBookUpdateSink;
+  MessageSender m_messageSender;
+
+  // Legacy records, reused from frame to frame
+  MarketUpdate m_update{};
+  OrderBookUpdate m_book{};
+  uint32_t m_bookSymbol{NO_SYMBOL};
+  std::vector<uint32_t> m_bboChanged;
+
+  uint64_t m_framesDecoded{0};
+  uint64_t m_eventsDecoded{0};
+  uint64_t m_malformedFrames{0};
+  uint64_t m_sequenceGaps{0};
+  uint64_t m_framesOutOfOrder{0};
+  uint64_t m_resyncsRequested{0};
+  uint64_t m_resyncsCompleted{0};
+  uint64_t m_deltasDropped{0};
+
+  SymbolState& state(uint32_t symbolId);
+  bool checkSequence(const DecodedFrame& decoded);
+  void markStale(uint32_t symbolId);
+  void filterEvents();
+  void publishLegacy(uint64_t receivedAt);
+  void publishMarketUpdate(uint32_t symbolId, const SymbolState& state,
+                           int64_t price, int64_t quantity, EventSide side,
+                           uint64_t receivedAt);
+  void flushBook(uint64_t receivedAt);
+  void send(const std::vector<std::string>& messages);
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../../core/utils/SocketTuning.h"
+
+#include <poll.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class TimestampedSocket
+ * @brief TCP socket layer that remembers when its data arrived
+ *
+ * Sits under an ssl::stream in place of a plain tcp::socket. Blocking
+ * reads go through SocketTuning::receive(), keeping the kernel (or NIC)
+ * receive time of the latest segment read, so a WebSocket frame can be
+ * stamped with when its last bytes reached the host rather than when the
+ * reader got to it. Asynchronous operations pass straight through to the
+ * socket without timestamps.
+ */
+class TimestampedSocket {
+public:
+  using tcp = boost::asio::ip::tcp;
+  using next_layer_type = tcp::socket;
+  using lowest_layer_type = tcp::socket::lowest_layer_type;
+  using executor_type = tcp::socket::executor_type;
+
+  explicit TimestampedSocket(boost::asio::io_context& ioContext)
+      : m_socket(ioContext) {}
+
+  executor_type get_executor() noexcept { return m_socket.get_executor(); }
+
+  next_layer_type& next_layer() { return m_socket; }
+  lowest_layer_type& lowest_layer() { return m_socket.lowest_layer(); }
+  const lowest_layer_type& lowest_layer() const {
+    return m_socket.lowest_layer();
+  }
+
+  /**
+   * @brief Kernel receive time of the latest segment read, wall-clock
+   * nanoseconds, or 0 if the socket has no timestamps enabled
+   */
+  uint64_t lastKernelTime() const { return m_lastKernelTime; }
+
+  template <class MutableBufferSequence>
+  size_t read_some(const MutableBufferSequence& buffers,
+                   boost::system::error_code& ec) {
+    // Like the socket itself, fill the first non-empty buffer only
+    boost::asio::mutable_buffer target;
+    for (auto it = boost::asio::buffer_sequence_begin(buffers);
+         it != boost::asio::buffer_sequence_end(buffers); ++it) {
+      target = *it;
+      if (target.size() > 0) {
+        break;
+      }
+    }
+    ec = {};
+    if (target.size() == 0) {
+      return 0;
+    }
+
+    while (true) {
+      ssize_t received =
+          utils::SocketTuning::receive(m_socket.native_handle(), target.data(),
+                                       target.size(), 0, m_lastKernelTime);
+      if (received > 0) {
+        return static_cast<size_t>(received);
+      }
+      if (received == 0) {
+        ec = boost::asio::error::eof;
+        return 0;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Asio leaves the descriptor non-blocking after any async operation
+        pollfd in{m_socket.native_handle(), POLLIN, 0};
+        ::poll(&in, 1, -1);
+      } else if (errno != EINTR) {
+        ec.assign(errno, boost::asio::error::get_system_category());
+        return 0;
+      }
+    }
+  }
+
+  template <class MutableBufferSequence>
+  size_t read_some(const MutableBufferSequence& buffers) {
+    boost::system::error_code ec;
+    size_t bytes = read_some(buffers, ec);
+    if (ec) {
+      throw boost::system::system_error(ec);
+    }
+    return bytes;
+  }
+
+  template <class ConstBufferSequence>
+  size_t write_some(const ConstBufferSequence& buffers,
+                    boost::system::error_code& ec) {
+    return m_socket.write_some(buffers, ec);
+  }
+
+  template <class ConstBufferSequence>
+  size_t write_some(const ConstBufferSequence& buffers) {
+    return m_socket.write_some(buffers);
+  }
+
+  template <class MutableBufferSequence, class ReadToken>
+  auto async_read_some(const MutableBufferSequence& buffers,
+                       ReadToken&& token) {
+    return m_socket.async_read_some(buffers, std::forward<ReadToken>(token));
+  }
+
+  template <class ConstBufferSequence, class WriteToken>
+  auto async_write_some(const ConstBufferSequence& buffers,
+                        WriteToken&& token) {
+    return m_socket.async_write_some(buffers, std::forward<WriteToken>(token));
+  }
+
+private:
+  tcp::socket m_socket;
+  uint64_t m_lastKernelTime{0};
+};
+
+} // namespace exchange
+} // namespace pinnacle
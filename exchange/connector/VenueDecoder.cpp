@@ -0,0 +1,157 @@
+#include "VenueDecoder.h"
+#include "decoders/BinanceDecoder.h"
+#include "decoders/BitstampDecoder.h"
+#include "decoders/CoinbaseDecoder.h"
+#include "decoders/GeminiDecoder.h"
+#include "decoders/KrakenDecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+constexpr std::array<Venue, 5> ALL_VENUES = {
+    Venue::COINBASE, Venue::KRAKEN, Venue::GEMINI, Venue::BINANCE,
+    Venue::BITSTAMP};
+
+} // namespace
+
+std::unique_ptr<VenueDecoder> createVenueDecoder(Venue venue) {
+  switch (venue) {
+  case Venue::COINBASE:
+    return std::make_unique<CoinbaseDecoder>();
+  case Venue::KRAKEN:
+    return std::make_unique<KrakenDecoder>();
+  case Venue::GEMINI:
+    return std::make_unique<GeminiDecoder>();
+  case Venue::BINANCE:
+    return std::make_unique<BinanceDecoder>();
+  case Venue::BITSTAMP:
+    return std::make_unique<BitstampDecoder>();
+  }
+  return nullptr;
+}
+
+const char* venueName(Venue venue) {
+  switch (venue) {
+  case Venue::COINBASE:
+    return "coinbase";
+  case Venue::KRAKEN:
+    return "kraken";
+  case Venue::GEMINI:
+    return "gemini";
+  case Venue::BINANCE:
+    return "binance";
+  case Venue::BITSTAMP:
+    return "bitstamp";
+  }
+  return "unknown";
+}
+
+std::optional<Venue> venueFromName(std::string_view name) {
+  for (Venue venue : ALL_VENUES) {
+    std::string_view candidate = venueName(venue);
+    if (candidate.size() == name.size() &&
+        std::equal(candidate.begin(), candidate.end(), name.begin(),
+                   [](char a, char b) {
+                     return a == std::tolower(static_cast<unsigned char>(b));
+                   })) {
+      return venue;
+    }
+  }
+  return std::nullopt;
+}
+
+uint64_t parseIsoTimestamp(std::string_view text) {
+  auto digits = [&text](size_t pos, size_t count, int64_t& value) {
+    if (pos + count > text.size()) {
+      return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+      if (text[i] < '0' || text[i] > '9') {
+        return false;
+      }
+      value = value * 10 + (text[i] - '0');
+    }
+    return true;
+  };
+
+  int64_t year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day) ||
+      !digits(11, 2, hour) || !digits(14, 2, minute) ||
+      !digits(17, 2, second) || text[4] != '-' || text[7] != '-' ||
+      text[10] != 'T' || month < 1 || month > 12) {
+    return 0;
+  }
+
+  // Fraction of a second, to nanosecond precision
+  int64_t nanos = 0;
+  size_t pos = 19;
+  if (pos < text.size() && text[pos] == '.') {
+    int64_t scale = 100'000'000;
+    for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9';
+         ++pos) {
+      nanos += (text[pos] - '0') * scale;
+      scale /= 10;
+    }
+  }
+
+  // Days since the epoch of a proleptic Gregorian date
+  int64_t y = month <= 2 ? year - 1 : year;
+  int64_t era = y / 400;
+  int64_t yearOfEra = y - era * 400;
+  int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t dayOfEra =
+      yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  int64_t days = era * 146097 + dayOfEra - 719468;
+
+  int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+  if (seconds < 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(seconds) * 1'000'000'000ULL +
+         static_cast<uint64_t>(nanos);
+}
+
+namespace json {
+
+bool readLevels(Cursor& c, MarketEventBuffer& out, uint32_t symbolId,
+                EventSide side, uint8_t flags, uint64_t venueTimestamp) {
+  return forEachElement(c, [&]() {
+    int64_t price = 0;
+    int64_t quantity = 0;
+    if (!c.expect('[')) {
+      return false;
+    }
+    bool hasPrice = c.decimal(price);
+    if (!c.expect(',')) {
+      return false;
+    }
+    bool hasQuantity = c.decimal(quantity);
+    while (c.consume(',')) {
+      c.skipValue();
+    }
+    if (!c.expect(']')) {
+      return false;
+    }
+    if (hasPrice && hasQuantity) {
+      MarketEvent& event = out.append(MarketEventType::BOOK_DELTA, symbolId);
+      event.venueTimestamp = venueTimestamp;
+      event.price = price;
+      event.quantity = quantity;
+      event.side = side;
+      event.flags = flags;
+    }
+    return true;
+  });
+}
+
+} // namespace json
+
+} // namespace exchange
+} // namespace pinnacle
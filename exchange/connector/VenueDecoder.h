@@ -0,0 +1,109 @@
+#pragma once
+
+#include "JsonCursor.h"
+#include "MarketEvent.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class VenueDecoder
+ * @brief Converts one venue's market data frames into normalized events
+ *
+ * A decoder knows its venue's wire format and subscription protocol; gap
+ * detection and resynchronization are left to NormalizedFeedHandler, which
+ * asks the decoder for the messages that request and end a resync.
+ * Decoders keep whatever per-connection state their format needs, so use
+ * one per connection and thread.
+ */
+class VenueDecoder {
+public:
+  virtual ~VenueDecoder() = default;
+
+  virtual Venue venue() const = 0;
+
+  /**
+   * @brief Decode one frame, appending its events to the buffer
+   *
+   * @param receivedAt Wall-clock receive time, already set on the buffer
+   */
+  virtual DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                              MarketEventBuffer& out) = 0;
+
+  /**
+   * @brief Default WebSocket endpoint of the venue
+   */
+  virtual std::string endpoint() const = 0;
+
+  /**
+   * @brief A canonical symbol such as BTC-USD as the venue spells it in
+   * frames
+   */
+  virtual std::string venueSymbol(const std::string& canonical) const = 0;
+
+  /**
+   * @brief Messages subscribing to book, trade and top-of-book data
+   */
+  virtual std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) = 0;
+
+  /**
+   * @brief Messages that make the venue send a fresh book snapshot
+   */
+  virtual std::vector<std::string>
+  resyncRequest(const std::string& canonical) = 0;
+
+  /**
+   * @brief Messages to send once the snapshot requested by resyncRequest()
+   * has arrived
+   */
+  virtual std::vector<std::string>
+  resyncComplete(const std::string& /*canonical*/) {
+    return {};
+  }
+};
+
+/**
+ * @brief Create the decoder for a venue
+ */
+std::unique_ptr<VenueDecoder> createVenueDecoder(Venue venue);
+
+/**
+ * @brief Lower-case venue name, as used for credentials and capture sources
+ */
+const char* venueName(Venue venue);
+
+/**
+ * @brief Venue for a name such as "coinbase", ignoring case
+ */
+std::optional<Venue> venueFromName(std::string_view name);
+
+/**
+ * @brief Parse an RFC 3339 UTC time such as 2024-01-02T03:04:05.123456Z
+ *
+ * @return Nanoseconds since the epoch, or zero if the text is not such a
+ * time
+ */
+uint64_t parseIsoTimestamp(std::string_view text);
+
+namespace json {
+
+/**
+ * @brief Read an array of [price, quantity, ...] pairs as book deltas
+ *
+ * Shared by the venues that send book levels as arrays of numbers or
+ * numeric strings; elements past the quantity are skipped.
+ */
+bool readLevels(Cursor& c, MarketEventBuffer& out, uint32_t symbolId,
+                EventSide side, uint8_t flags, uint64_t venueTimestamp);
+
+} // namespace json
+
+} // namespace exchange
+} // namespace pinnacle
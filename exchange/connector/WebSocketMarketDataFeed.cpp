@@ -1,4 +1,7 @@
 #include "WebSocketMarketDataFeed.h"
+#include "../../core/utils/ThreadAffinity.h"
+#include "../../core/utils/TimeUtils.h"
+#include "../capture/CaptureRecorder.h"
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl.hpp>
@@ -116,11 +119,25 @@ std::string createCoinbaseJWT(const std::string& apiKey,
 WebSocketMarketDataFeed::WebSocketMarketDataFeed(
     Exchange exchange, std::shared_ptr<utils::ApiCredentials> credentials)
     : m_exchange(exchange), m_credentials(credentials),
-      m_io_context(std::make_shared<boost::asio::io_context>()) {
+      m_io_context(std::make_shared<boost::asio::io_context>()),
+      m_handler(createVenueDecoder(exchange)) {
 
   // Initialize exchange-specific settings
   initExchangeSpecifics();
 
+  m_handler.setMarketUpdateSink(
+      [this](const MarketUpdate& update) { dispatchMarketUpdate(update); });
+  m_handler.setOrderBookUpdateSink([this](const OrderBookUpdate& update) {
+    dispatchOrderBookUpdate(update);
+  });
+  m_handler.setEventSink([this](std::span<const MarketEvent> events) {
+    for (const auto& callback : m_eventCallbacks) {
+      callback(events);
+    }
+  });
+  m_handler.setMessageSender(
+      [this](const std::string& message) { sendMessage(message); });
+
   // Initialize SSL context
   m_ssl_context = std::make_shared<boost::asio::ssl::context>(
       boost::asio::ssl::context::tlsv12_client);
@@ -149,7 +166,13 @@ bool WebSocketMarketDataFeed::start() {
   m_shouldStop.store(false, std::memory_order_release);
   m_reconnectAttempts = 0;
 
-  // Start processing thread first
+  // Start the parser and reader threads first
+  m_parserThread = std::thread(&WebSocketMarketDataFeed::parseFrames, this);
+  if (m_parserCore >= 0 &&
+      !utils::ThreadAffinity::pinThreadToCore(m_parserThread, m_parserCore)) {
+    spdlog::warn("Could not pin {} parser thread to core {}", m_exchangeName,
+                 m_parserCore);
+  }
   m_processingThread =
       std::thread(&WebSocketMarketDataFeed::processMessages, this);
   m_isRunning.store(true, std::memory_order_release);
@@ -174,6 +197,9 @@ bool WebSocketMarketDataFeed::stop() {
     if (m_processingThread.joinable()) {
       m_processingThread.join();
     }
+    if (m_parserThread.joinable()) {
+      m_parserThread.join();
+    }
 
     m_isRunning.store(false, std::memory_order_release);
 
@@ -189,7 +215,12 @@ bool WebSocketMarketDataFeed::stop() {
 }
 
 void WebSocketMarketDataFeed::initialize() {
-  // Basic initialization - connection will be established in connectWebSocket()
+  // Size the frame slabs up front; they grow only for unusually large frames
+  for (size_t i = 0; i < m_frameRing.slabCount(); ++i) {
+    m_frameRing.slab(static_cast<uint32_t>(i))
+        .buffer.reserve(FRAME_SLAB_RESERVE);
+  }
+  // Connection will be established in connectWebSocket()
 }
 
 void WebSocketMarketDataFeed::connectWithRetry() {
@@ -258,6 +289,11 @@ void WebSocketMarketDataFeed::connectWebSocket() {
     } else {
       host = temp;
     }
+    auto portPos = host.find(':');
+    if (portPos != std::string::npos) {
+      port = host.substr(portPos + 1);
+      host = host.substr(0, portPos);
+    }
   }
 
   spdlog::info("Connecting to host: {}, port: {}, path: {}", host, port, path);
@@ -271,8 +307,9 @@ void WebSocketMarketDataFeed::connectWebSocket() {
   spdlog::info("DNS resolution successful");
 
   // Create SSL stream and WebSocket
-  auto ssl_stream = std::make_unique<boost::asio::ssl::stream<tcp::socket>>(
-      *m_io_context, *m_ssl_context);
+  auto ssl_stream =
+      std::make_unique<WebSocketMarketDataFeed::ssl_stream>(*m_io_context,
+                                                            *m_ssl_context);
 
   // Connect TCP
   boost::system::error_code connect_ec;
@@ -282,6 +319,13 @@ void WebSocketMarketDataFeed::connectWebSocket() {
   }
   spdlog::info("TCP connection established");
 
+  utils::SocketTuningReport tuning = utils::SocketTuning::apply(
+      ssl_stream->lowest_layer().native_handle(), m_socketTuning);
+  spdlog::info("Feed socket: nodelay={} busy_poll={} timestamps={} "
+               "rcvbuf={}",
+               tuning.noDelay, tuning.busyPoll, tuning.timestamps,
+               tuning.receiveBufferBytes);
+
   // Set SNI hostname
   if (!SSL_set_tlsext_host_name(ssl_stream->native_handle(), host.c_str())) {
     throw std::runtime_error("Failed to set SNI hostname");
@@ -320,6 +364,7 @@ void WebSocketMarketDataFeed::connectWebSocket() {
 }
 
 void WebSocketMarketDataFeed::disconnectWebSocket() {
+  std::lock_guard<std::mutex> lock(m_writeMutex);
   if (m_websocket) {
     try {
       m_websocket->close(boost::beast::websocket::close_code::normal);
@@ -331,18 +376,42 @@ void WebSocketMarketDataFeed::disconnectWebSocket() {
 }
 
 void WebSocketMarketDataFeed::processMessages() {
-  boost::beast::flat_buffer buffer;
+  auto shouldStop = [this]() {
+    return m_shouldStop.load(std::memory_order_acquire);
+  };
+  uint32_t slab = FrameRing::NO_SLAB;
+  if (m_readerCore >= 0 && !utils::ThreadAffinity::pinToCore(m_readerCore)) {
+    spdlog::warn("Could not pin market data reader to core {}", m_readerCore);
+  }
+  bool placed = false;
 
-  while (!m_shouldStop.load(std::memory_order_acquire)) {
+  while (!shouldStop()) {
     try {
       if (!m_websocket) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         continue;
       }
 
-      // Read message
+      // Wait for the parser to free a slab rather than drop the frame
+      if (slab == FrameRing::NO_SLAB) {
+        uint64_t stalls = m_frameRing.getBackpressureStalls();
+        slab = m_frameRing.acquire(shouldStop);
+        uint64_t stalled = m_frameRing.getBackpressureStalls();
+        if (stalled != stalls && (stalled & (stalled - 1)) == 0) {
+          spdlog::warn("Market data parser is behind; reader stalled {} times",
+                       stalled);
+        }
+        if (slab == FrameRing::NO_SLAB) {
+          break;
+        }
+      }
+
+      // Read the frame straight into the slab
+      auto& frame = m_frameRing.slab(slab);
+      frame.buffer.clear();
       boost::beast::error_code ec;
-      auto bytes_transferred = m_websocket->read(buffer, ec);
+      m_websocket->read(frame.buffer, ec);
+      frame.receivedAt = utils::TimeUtils::getWallClockNanos();
 
       if (ec) {
         if (ec != boost::beast::websocket::error::closed) {
@@ -351,17 +420,58 @@ void WebSocketMarketDataFeed::processMessages() {
         break;
       }
 
-      // Convert to string and process
-      std::string message = boost::beast::buffers_to_string(buffer.data());
-      buffer.consume(bytes_transferred);
+      auto& socket = m_websocket->next_layer().next_layer();
+      frame.kernelReceivedAt = socket.lastKernelTime();
+      if (!placed) {
+        placed = true;
+        placeReader(socket.lowest_layer().native_handle());
+      }
 
-      onMessage(message);
+      m_frameRing.publish(slab);
+      slab = FrameRing::NO_SLAB;
 
     } catch (const std::exception& e) {
       spdlog::error("Error in message processing: {}", e.what());
       std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
   }
+
+  // Hand back a slab still held; the parser skips empty frames
+  if (slab != FrameRing::NO_SLAB) {
+    m_frameRing.slab(slab).buffer.clear();
+    m_frameRing.publish(slab);
+  }
+}
+
+void WebSocketMarketDataFeed::parseFrames() {
+  auto shouldStop = [this]() {
+    return m_shouldStop.load(std::memory_order_acquire);
+  };
+
+  while (true) {
+    uint32_t slab = m_frameRing.consume(shouldStop);
+    if (slab == FrameRing::NO_SLAB) {
+      break;
+    }
+    if (m_hasNewSymbols.load(std::memory_order_acquire)) {
+      registerNewSymbols();
+    }
+    if (m_hasResyncRequests.load(std::memory_order_acquire)) {
+      applyResyncRequests();
+    }
+
+    const auto& frame = m_frameRing.slab(slab);
+    auto data = frame.buffer.data();
+    if (data.size() > 0) {
+      std::string_view message(static_cast<const char*>(data.data()),
+                               data.size());
+      if (m_captureRecorder) {
+        m_captureRecorder->record(message, frame.receivedAt);
+      }
+      onMessage(message, frame.receivedAt, frame.kernelReceivedAt);
+    }
+    m_frameRing.release(slab);
+  }
 }
 
 void WebSocketMarketDataFeed::onConnect() {
@@ -385,22 +495,87 @@ void WebSocketMarketDataFeed::onError(const std::string& error) {
   }
 }
 
-void WebSocketMarketDataFeed::onMessage(const std::string& message) {
+void WebSocketMarketDataFeed::placeReader(int fd) {
+  utils::SocketPlacement placement = utils::SocketTuning::placement(fd);
+  if (placement.incomingCpu < 0) {
+    return;
+  }
+  spdlog::info("{} feed packets are processed on CPU {} (NAPI id {})",
+               m_exchangeName, placement.incomingCpu, placement.napiId);
+  if (m_readerCore == READER_ON_INCOMING_CPU &&
+      !utils::ThreadAffinity::pinToCore(placement.incomingCpu)) {
+    spdlog::warn("Could not pin market data reader to core {}",
+                 placement.incomingCpu);
+  }
+}
+
+void WebSocketMarketDataFeed::onMessage(std::string_view message,
+                                        uint64_t receivedAt,
+                                        uint64_t kernelReceivedAt) {
   try {
-    // Always log full message at info level for debugging Coinbase issue
-    spdlog::info("WebSocket received message (length: {}): {}",
-                 message.length(), message);
-
-    spdlog::debug("Received message: {}",
-                  message.substr(0, 200) +
-                      (message.length() > 200 ? "..." : ""));
-    parseMessage(message);
+    spdlog::debug("Received message (length: {}): {}", message.length(),
+                  message.substr(0, 200));
+    parseMessage(message, receivedAt, kernelReceivedAt);
   } catch (const std::exception& e) {
     spdlog::error("Error parsing message: {}", e.what());
   }
 }
 
+void WebSocketMarketDataFeed::registerNewSymbols() {
+  std::vector<std::string> symbols;
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    symbols.swap(m_newSymbols);
+    m_hasNewSymbols.store(false, std::memory_order_release);
+  }
+  for (const auto& symbol : symbols) {
+    m_handler.addSymbol(symbol);
+  }
+}
+
+void WebSocketMarketDataFeed::requestResync(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(m_callbacksMutex);
+  m_resyncSymbols.push_back(symbol);
+  m_hasResyncRequests.store(true, std::memory_order_release);
+}
+
+void WebSocketMarketDataFeed::applyResyncRequests() {
+  std::vector<std::string> symbols;
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    symbols.swap(m_resyncSymbols);
+    m_hasResyncRequests.store(false, std::memory_order_release);
+  }
+  for (const auto& symbol : symbols) {
+    spdlog::info("Resynchronizing {} book for {}", m_exchangeName, symbol);
+    m_handler.requestResync(m_handler.addSymbol(symbol));
+  }
+}
+
+bool WebSocketMarketDataFeed::sendMessage(const std::string& message) {
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  if (!m_websocket) {
+    spdlog::warn("Not connected to {}; dropping message: {}", m_exchangeName,
+                 message);
+    return false;
+  }
+  boost::beast::error_code ec;
+  m_websocket->write(boost::asio::buffer(message), ec);
+  if (ec) {
+    spdlog::error("Failed to send message to {}: {}", m_exchangeName,
+                  ec.message());
+    return false;
+  }
+  return true;
+}
+
 bool WebSocketMarketDataFeed::sendSubscription(const std::string& symbol) {
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_newSymbols.push_back(symbol);
+    m_hasNewSymbols.store(true, std::memory_order_release);
+  }
+
   if (!m_isRunning.load(std::memory_order_acquire) || !m_websocket) {
     // Add to pending subscriptions if not connected yet
     m_pendingSubscriptions.push_back(symbol);
@@ -412,6 +587,17 @@ bool WebSocketMarketDataFeed::sendSubscription(const std::string& symbol) {
 
 bool WebSocketMarketDataFeed::sendSubscriptionInternal(
     const std::string& symbol) {
+  if (m_exchange != Exchange::COINBASE) {
+    bool sent = true;
+    for (const auto& message :
+         m_handler.getDecoder().subscriptionMessages(symbol)) {
+      spdlog::info("Sending {} subscription for {}: {}", m_exchangeName,
+                   symbol, message);
+      sent = sendMessage(message) && sent;
+    }
+    return sent;
+  }
+
   try {
     // Coinbase Advanced Trade requires separate subscription for each channel
     // Try public channels first (no auth), then authenticated channels
@@ -430,12 +616,9 @@ bool WebSocketMarketDataFeed::sendSubscriptionInternal(
       spdlog::info("Sending {} subscription for {} (auth: {}): {}", channel,
                    symbol, requiresAuth, subscriptionMessage);
 
-      boost::beast::error_code ec;
-      m_websocket->write(boost::asio::buffer(subscriptionMessage), ec);
-
-      if (ec) {
+      if (!sendMessage(subscriptionMessage)) {
         throw std::runtime_error("Failed to send " + channel +
-                                 " subscription message: " + ec.message());
+                                 " subscription message");
       }
 
       spdlog::info("{} subscription sent successfully for {}", channel, symbol);
@@ -514,17 +697,10 @@ WebSocketMarketDataFeed::createSubscriptionMessage(const std::string& symbol) {
   return createSubscriptionMessage(symbol, "level2", true);
 }
 
-// Implement remaining methods with simplified logic for now
 void WebSocketMarketDataFeed::initExchangeSpecifics() {
-  switch (m_exchange) {
-  case Exchange::COINBASE:
-    m_exchangeName = "coinbase";
-    m_endpoint = "wss://advanced-trade-ws.coinbase.com";
-    m_useSSL = true;
-    break;
-  default:
-    throw std::runtime_error("Unsupported exchange");
-  }
+  m_exchangeName = venueName(m_exchange);
+  m_endpoint = m_handler.getDecoder().endpoint();
+  m_useSSL = true;
 }
 
 std::string WebSocketMarketDataFeed::getExchangeName() const {
@@ -555,6 +731,11 @@ void WebSocketMarketDataFeed::setJsonLogger(
   m_jsonLogger = jsonLogger;
 }
 
+void WebSocketMarketDataFeed::setCaptureRecorder(
+    std::shared_ptr<capture::CaptureRecorder> recorder) {
+  m_captureRecorder = std::move(recorder);
+}
+
 bool WebSocketMarketDataFeed::subscribeToMarketUpdates(
     const std::string& symbol,
     std::function<void(const MarketUpdate&)> callback) {
@@ -569,6 +750,15 @@ bool WebSocketMarketDataFeed::subscribeToOrderBookUpdates(
   return sendSubscription(symbol);
 }
 
+void WebSocketMarketDataFeed::subscribeToEvents(
+    std::function<void(std::span<const MarketEvent>)> callback) {
+  if (m_isRunning.load(std::memory_order_acquire)) {
+    spdlog::warn("Event subscriptions must be made before the feed starts");
+    return;
+  }
+  m_eventCallbacks.push_back(std::move(callback));
+}
+
 bool WebSocketMarketDataFeed::unsubscribeFromMarketUpdates(
     const std::string& symbol) {
   m_marketUpdateCallbacks.erase(symbol);
@@ -614,240 +804,59 @@ bool WebSocketMarketDataFeed::isRunning() const {
   return m_isRunning.load(std::memory_order_acquire);
 }
 
-void WebSocketMarketDataFeed::parseMessage(const std::string& message) {
-  try {
-    auto json = nlohmann::json::parse(message);
-
-    // Debug: Log the message structure for analysis
-    spdlog::info("Parsing JSON message with keys: [{}]", [&json]() {
-      std::string keys;
-      for (auto it = json.begin(); it != json.end(); ++it) {
-        if (!keys.empty())
-          keys += ", ";
-        keys += "\"" + it.key() + "\"";
-      }
-      return keys;
-    }());
-
-    // Handle Coinbase Advanced Trade messages
-    if (json.contains("channel")) {
-      std::string channel = json["channel"];
-      spdlog::info("Processing channel: {}", channel);
-
-      if ((channel == "level2" || channel == "l2_data") &&
-          json.contains("events")) {
-        spdlog::info("Processing level2/l2_data events, count: {}",
-                     json["events"].size());
-        // Level 2 order book updates
-        for (const auto& event : json["events"]) {
-          if (event.contains("type") && event["type"] == "update") {
-            spdlog::info("Processing level2 update event");
-            OrderBookUpdate update = parseOrderBookUpdate(event.dump());
-
-            auto it = m_orderBookUpdateCallbacks.find(update.symbol);
-            if (it != m_orderBookUpdateCallbacks.end()) {
-              spdlog::info("Calling {} order book callbacks for {}",
-                           it->second.size(), update.symbol);
-              for (const auto& callback : it->second) {
-                callback(update);
-              }
-            } else {
-              spdlog::warn("No order book callbacks registered for symbol: {}",
-                           update.symbol);
-            }
-          } else {
-            spdlog::info("Level2 event type: {}",
-                         event.value("type", "unknown"));
-          }
-        }
-      } else if (channel == "ticker" && json.contains("events")) {
-        spdlog::info("Processing ticker events, count: {}",
-                     json["events"].size());
-        // Ticker updates
-        for (const auto& event : json["events"]) {
-          if (event.contains("tickers")) {
-            for (const auto& ticker : event["tickers"]) {
-              MarketUpdate update = parseMarketUpdate(ticker.dump());
-
-              auto it = m_marketUpdateCallbacks.find(update.symbol);
-              if (it != m_marketUpdateCallbacks.end()) {
-                spdlog::info("Calling {} market update callbacks for {}",
-                             it->second.size(), update.symbol);
-                for (const auto& callback : it->second) {
-                  callback(update);
-                }
-              } else {
-                spdlog::warn(
-                    "No market update callbacks registered for symbol: {}",
-                    update.symbol);
-              }
-            }
-          }
-        }
-      } else if (channel == "heartbeats" && json.contains("events")) {
-        // Handle heartbeat messages - these keep the connection alive
-        spdlog::debug("Received heartbeat message - connection is alive");
-        for (const auto& event : json["events"]) {
-          if (event.contains("heartbeat_counter")) {
-            spdlog::debug("Heartbeat #{}: {}",
-                          event.value("heartbeat_counter", 0),
-                          event.value("current_time", "unknown"));
-          }
-        }
-      } else if (channel == "subscriptions") {
-        // Handle subscription confirmation messages
-        spdlog::info("Subscription confirmation received: {}",
-                     message.substr(0, 300));
-      } else {
-        spdlog::warn(
-            "Unknown channel or missing events: channel={}, has_events={}",
-            channel, json.contains("events"));
-      }
-    }
-    // Handle subscription acknowledgments, errors, and original ticker messages
-    else if (json.contains("type")) {
-      std::string type = json["type"];
-      spdlog::info("Processing message type: {}", type);
-
-      if (type == "subscriptions") {
-        spdlog::info("Subscription confirmed: {}", message.substr(0, 200));
-      } else if (type == "error") {
-        std::string errorMsg = json.value("message", "Unknown error");
-        spdlog::error("WebSocket error from server: {}", errorMsg);
-      } else if (type == "ticker" && json.contains("product_id")) {
-        // Handle original Coinbase ticker format for immediate price updates
-        spdlog::info("Processing ticker message for price update");
-        MarketUpdate update = parseMarketUpdate(message);
-
-        auto it = m_marketUpdateCallbacks.find(update.symbol);
-        if (it != m_marketUpdateCallbacks.end()) {
-          spdlog::info("Calling {} market update callbacks for ticker data: {}",
-                       it->second.size(), update.symbol);
-          for (const auto& callback : it->second) {
-            callback(update);
-          }
-        } else {
-          spdlog::warn(
-              "No market update callbacks registered for ticker symbol: {}",
-              update.symbol);
-        }
-      } else if (type == "heartbeat") {
-        // Handle heartbeat messages to keep connection alive
-        spdlog::debug("Received heartbeat message - connection is alive");
-      } else {
-        spdlog::info("Unhandled message type: {}", type);
-      }
-    } else {
-      spdlog::warn("Message has no 'channel' or 'type' field - unknown format");
-    }
-  } catch (const std::exception& e) {
-    spdlog::error("Error parsing message: {}", e.what());
+void WebSocketMarketDataFeed::parseMessage(std::string_view message,
+                                           uint64_t receivedAt,
+                                           uint64_t kernelReceivedAt) {
+  switch (m_handler.process(message, receivedAt, kernelReceivedAt)) {
+  case FrameKind::DATA:
+  case FrameKind::SNAPSHOT:
+    // Already dispatched by the handler
+    return;
+  case FrameKind::HEARTBEAT:
+    spdlog::debug("Received heartbeat message - connection is alive");
+    return;
+  case FrameKind::CONTROL:
+    spdlog::info("{} control message: {}", m_exchangeName,
+                 message.substr(0, 300));
+    return;
+  case FrameKind::ERROR:
+    spdlog::error("WebSocket error from server: {}", message.substr(0, 500));
+    return;
+  case FrameKind::MALFORMED:
+    spdlog::error("Error parsing message: malformed JSON ({} bytes)",
+                  message.length());
     spdlog::debug("Problematic message: {}", message.substr(0, 500));
+    return;
+  case FrameKind::IGNORED:
+    spdlog::debug("Unhandled {} message: {}", m_exchangeName,
+                  message.substr(0, 200));
+    return;
   }
 }
 
-MarketUpdate
-WebSocketMarketDataFeed::parseMarketUpdate(const std::string& message) {
-  MarketUpdate update;
-
-  try {
-    auto json = nlohmann::json::parse(message);
-
-    // Coinbase Advanced Trade ticker format
-    if (json.contains("product_id")) {
-      update.symbol = json["product_id"];
-    }
-
-    if (json.contains("price")) {
-      update.price = std::stod(json["price"].get<std::string>());
-    }
-
-    // Handle volume from various possible fields
-    if (json.contains("last_size")) {
-      update.volume = std::stod(json["last_size"].get<std::string>());
-    } else if (json.contains("volume_24_h")) {
-      update.volume = std::stod(json["volume_24_h"].get<std::string>());
-    }
-
-    // Parse additional ticker fields from Coinbase Advanced Trade
-    if (json.contains("best_bid")) {
-      update.bidPrice = std::stod(json["best_bid"].get<std::string>());
-    }
-
-    if (json.contains("best_ask")) {
-      update.askPrice = std::stod(json["best_ask"].get<std::string>());
-    }
-
-    update.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                           std::chrono::system_clock::now().time_since_epoch())
-                           .count();
-
-  } catch (const std::exception& e) {
-    spdlog::error("Error parsing market update: {}", e.what());
-    spdlog::debug("Problematic ticker message: {}", message.substr(0, 200));
+void WebSocketMarketDataFeed::dispatchMarketUpdate(const MarketUpdate& update) {
+  auto it = m_marketUpdateCallbacks.find(update.symbol);
+  if (it == m_marketUpdateCallbacks.end()) {
+    spdlog::debug("No market update callbacks registered for symbol: {}",
+                  update.symbol);
+    return;
+  }
+  for (const auto& callback : it->second) {
+    callback(update);
   }
-
-  return update;
 }
 
-OrderBookUpdate
-WebSocketMarketDataFeed::parseOrderBookUpdate(const std::string& message) {
-  OrderBookUpdate update;
-
-  try {
-    auto json = nlohmann::json::parse(message);
-
-    // Advanced Trade format
-    if (json.contains("product_id")) {
-      update.symbol = json["product_id"];
-    }
-
-    // Parse updates array for Advanced Trade format
-    if (json.contains("updates")) {
-      for (const auto& updateItem : json["updates"]) {
-        if (updateItem.contains("side") && updateItem.contains("price_level") &&
-            updateItem.contains("new_quantity")) {
-          std::string side = updateItem["side"];
-          double price =
-              std::stod(updateItem["price_level"].get<std::string>());
-          double size =
-              std::stod(updateItem["new_quantity"].get<std::string>());
-
-          if (side == "bid") {
-            update.bids.emplace_back(price, size);
-          } else if (side == "offer") {
-            update.asks.emplace_back(price, size);
-          }
-        }
-      }
-    }
-    // Fallback for old format (legacy support)
-    else if (json.contains("changes")) {
-      for (const auto& change : json["changes"]) {
-        if (change.is_array() && change.size() >= 3) {
-          std::string side = change[0];
-          double price = std::stod(change[1].get<std::string>());
-          double size = std::stod(change[2].get<std::string>());
-
-          if (side == "buy" || side == "bid") {
-            update.bids.emplace_back(price, size);
-          } else if (side == "sell" || side == "offer") {
-            update.asks.emplace_back(price, size);
-          }
-        }
-      }
-    }
-
-    update.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                           std::chrono::system_clock::now().time_since_epoch())
-                           .count();
-
-  } catch (const std::exception& e) {
-    spdlog::error("Error parsing order book update: {}", e.what());
-    spdlog::debug("Problematic message: {}", message.substr(0, 500));
+void WebSocketMarketDataFeed::dispatchOrderBookUpdate(
+    const OrderBookUpdate& update) {
+  auto it = m_orderBookUpdateCallbacks.find(update.symbol);
+  if (it == m_orderBookUpdateCallbacks.end()) {
+    spdlog::debug("No order book callbacks registered for symbol: {}",
+                  update.symbol);
+    return;
+  }
+  for (const auto& callback : it->second) {
+    callback(update);
   }
-
-  return update;
 }
 
 } // namespace exchange
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "../../core/utils/JsonLogger.h"
-#include "../../core/utils/LockFreeQueue.h"
+#include "../../core/utils/SlabRing.h"
+#include "../../core/utils/SocketTuning.h"
 #include "../../exchange/simulator/MarketDataFeed.h"
+#include "NormalizedFeedHandler.h"
 #include "SecureConfig.h"
+#include "TimestampedSocket.h"
 #include <boost/asio/ssl.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
@@ -20,19 +23,27 @@
 namespace pinnacle {
 namespace exchange {
 
+namespace capture {
+class CaptureRecorder;
+} // namespace capture
+
 /**
  * @class WebSocketMarketDataFeed
  * @brief Real-time market data feed using WebSockets
  *
  * This class provides a concrete implementation of the MarketDataFeed interface
  * using WebSockets for real-time market data from cryptocurrency exchanges.
+ * Frames are decoded on the feed's parser thread by a NormalizedFeedHandler
+ * with the exchange's VenueDecoder, which checks sequence numbers and
+ * resynchronizes books after a gap. Run one feed per venue; each has its
+ * own reader and parser thread, and the parser can be pinned to a core.
  */
 class WebSocketMarketDataFeed : public MarketDataFeed {
 public:
   /**
    * @brief Supported exchanges
    */
-  enum class Exchange { COINBASE, KRAKEN, GEMINI, BINANCE, BITSTAMP };
+  using Exchange = Venue;
 
   /**
    * @brief Constructor
@@ -73,6 +84,55 @@ public:
   void publishMarketUpdate(const MarketUpdate& update) override;
   void publishOrderBookUpdate(const OrderBookUpdate& update) override;
 
+  /**
+   * @brief Receive every decoded frame as a batch of normalized events
+   *
+   * The callback runs on the parser thread with events that are only valid
+   * during the call. Register before start().
+   */
+  void subscribeToEvents(
+      std::function<void(std::span<const MarketEvent>)> callback);
+
+  /**
+   * @brief Invalidate a symbol's book and ask the venue for a fresh snapshot
+   *
+   * Kraken, Gemini and Bitstamp send no sequence numbers, so the feed
+   * cannot see a gap on them; call this when a book is suspect, for
+   * instance after crossing. Thread safe: the parser thread makes the
+   * request before it decodes the next frame, dropping deltas for the
+   * symbol until the snapshot arrives.
+   */
+  void requestResync(const std::string& symbol);
+
+  /**
+   * @brief Pin the parser thread to a CPU core when the feed starts
+   */
+  void setParserCore(int coreId) { m_parserCore = coreId; }
+
+  /**
+   * @brief Reader core meaning the CPU that processes the socket's incoming
+   * packets, found once the first frame arrives
+   */
+  static constexpr int READER_ON_INCOMING_CPU = -2;
+
+  /**
+   * @brief Pin the socket reader thread to a CPU core when the feed starts
+   *
+   * READER_ON_INCOMING_CPU suits busy polling, where the reader does the
+   * receive processing itself. Either way the incoming CPU is logged.
+   */
+  void setReaderCore(int coreId) { m_readerCore = coreId; }
+
+  /**
+   * @brief Options for the feed socket, applied on every connect
+   *
+   * By default TCP_NODELAY and kernel receive timestamps are on, and the
+   * timestamps reach subscribers as MarketUpdate::kernelTimestamp.
+   */
+  void setSocketTuning(const utils::SocketTuningConfig& tuning) {
+    m_socketTuning = tuning;
+  }
+
   /**
    * @brief Set connection parameters
    *
@@ -95,6 +155,15 @@ public:
    */
   std::string getStatusMessage() const;
 
+  /**
+   * @brief Times the reader waited because every frame slab was in use
+   *
+   * Non-zero means the parser thread is falling behind the socket.
+   */
+  uint64_t getFrameBackpressureStalls() const {
+    return m_frameRing.getBackpressureStalls();
+  }
+
   /**
    * @brief Set JSON logger for structured data export
    *
@@ -102,6 +171,14 @@ public:
    */
   void setJsonLogger(std::shared_ptr<utils::JsonLogger> jsonLogger);
 
+  /**
+   * @brief Record every received frame, with its receive time, to a capture
+   *
+   * Frames are handed to the recorder from the parser thread before they
+   * are decoded. Set before start().
+   */
+  void setCaptureRecorder(std::shared_ptr<capture::CaptureRecorder> recorder);
+
 private:
   // Exchange information
   Exchange m_exchange;
@@ -114,7 +191,7 @@ private:
 
   // WebSocket client using Boost.Beast
   using tcp = boost::asio::ip::tcp;
-  using ssl_stream = boost::asio::ssl::stream<tcp::socket>;
+  using ssl_stream = boost::asio::ssl::stream<TimestampedSocket>;
   using websocket_stream = boost::beast::websocket::stream<ssl_stream>;
   using context_ptr = std::shared_ptr<boost::asio::ssl::context>;
 
@@ -142,12 +219,32 @@ private:
   std::unordered_map<std::string,
                      std::vector<std::function<void(const OrderBookUpdate&)>>>
       m_orderBookUpdateCallbacks;
+  std::vector<std::function<void(std::span<const MarketEvent>)>>
+      m_eventCallbacks;
   std::vector<std::string> m_pendingSubscriptions;
+  std::vector<std::string> m_newSymbols; // For the parser to register
+  std::atomic<bool> m_hasNewSymbols{false};
+  std::vector<std::string> m_resyncSymbols; // For the parser to resync
+  std::atomic<bool> m_hasResyncRequests{false};
   std::mutex m_callbacksMutex;
-
-  // Message processing
+  std::mutex m_writeMutex;
+
+  // Message processing: the reader thread fills recycled frame slabs in
+  // place and the parser thread decodes and releases them
+  static constexpr size_t FRAME_SLAB_COUNT = 256;
+  static constexpr size_t FRAME_SLAB_RESERVE = 16 * 1024; // Bytes per slab
+  struct Frame {
+    boost::beast::flat_buffer buffer;
+    uint64_t receivedAt{0};       // Wall-clock nanoseconds
+    uint64_t kernelReceivedAt{0}; // From the socket, 0 if unavailable
+  };
+  using FrameRing = utils::SlabRing<Frame>;
   std::thread m_processingThread;
-  utils::LockFreeMPMCQueue<std::string, 1024> m_messageQueue;
+  std::thread m_parserThread;
+  int m_parserCore{-1};
+  int m_readerCore{-1};
+  utils::SocketTuningConfig m_socketTuning{.kernelTimestamps = true};
+  FrameRing m_frameRing{FRAME_SLAB_COUNT};
 
   // JSON logging
   std::shared_ptr<utils::JsonLogger> m_jsonLogger;
@@ -158,19 +255,29 @@ private:
   void connectWithRetry();
   void disconnectWebSocket();
   void processMessages();
+  void placeReader(int fd);
+  void parseFrames();
 
   // Event handlers
   void onConnect();
   void onDisconnect();
   void onError(const std::string& error);
-  void onMessage(const std::string& message);
+  void onMessage(std::string_view message, uint64_t receivedAt,
+                 uint64_t kernelReceivedAt);
+
+  // Message parsing, on the parser thread
+  NormalizedFeedHandler m_handler;
+  std::shared_ptr<capture::CaptureRecorder> m_captureRecorder;
 
-  // Message parsing
-  void parseMessage(const std::string& message);
-  MarketUpdate parseMarketUpdate(const std::string& message);
-  OrderBookUpdate parseOrderBookUpdate(const std::string& message);
+  void parseMessage(std::string_view message, uint64_t receivedAt,
+                    uint64_t kernelReceivedAt);
+  void registerNewSymbols();
+  void applyResyncRequests();
+  void dispatchMarketUpdate(const MarketUpdate& update);
+  void dispatchOrderBookUpdate(const OrderBookUpdate& update);
 
   // Subscription methods
+  bool sendMessage(const std::string& message);
   bool sendSubscription(const std::string& symbol);
   bool sendSubscriptionInternal(const std::string& symbol);
   std::string createSubscriptionMessage(const std::string& symbol);
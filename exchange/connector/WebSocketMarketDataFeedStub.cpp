@@ -137,14 +137,20 @@ WebSocketMarketDataFeed::context_ptr
 WebSocketMarketDataFeed::onTlsInit(websocketpp::connection_hdl hdl) {
   return nullptr;
 }
-void WebSocketMarketDataFeed::parseMessage(const std::string& message) {}
-MarketUpdate
-WebSocketMarketDataFeed::parseMarketUpdate(const std::string& message) {
-  return MarketUpdate();
-}
-OrderBookUpdate
-WebSocketMarketDataFeed::parseOrderBookUpdate(const std::string& message) {
-  return OrderBookUpdate();
+void WebSocketMarketDataFeed::parseFrames() {}
+void WebSocketMarketDataFeed::parseMessage(std::string_view message,
+                                           uint64_t receivedAt) {}
+void WebSocketMarketDataFeed::registerNewSymbols() {}
+void WebSocketMarketDataFeed::dispatchMarketUpdate(const MarketUpdate& update) {
+}
+void WebSocketMarketDataFeed::dispatchOrderBookUpdate(
+    const OrderBookUpdate& update) {}
+void WebSocketMarketDataFeed::setCaptureRecorder(
+    std::shared_ptr<capture::CaptureRecorder> recorder) {}
+void WebSocketMarketDataFeed::subscribeToEvents(
+    std::function<void(std::span<const MarketEvent>)> callback) {}
+bool WebSocketMarketDataFeed::sendMessage(const std::string& message) {
+  return true;
 }
 bool WebSocketMarketDataFeed::sendSubscription(const std::string& symbol) {
   return true;
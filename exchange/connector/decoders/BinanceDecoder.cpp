@@ -0,0 +1,311 @@
+#include "BinanceDecoder.h"
+
+#include <cctype>
+#include <nlohmann/json.hpp>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+using json::Cursor;
+using json::forEachMember;
+
+constexpr uint64_t NANOS_PER_MILLI = 1'000'000;
+
+/**
+ * @brief Fields of a stream payload, read in whatever order they come
+ */
+struct Payload {
+  std::string_view eventType;
+  std::string_view symbol;
+  uint64_t eventTime{0};
+  uint64_t tradeTime{0};
+  uint64_t firstUpdateId{0};
+  uint64_t lastUpdateId{0};
+  bool hasUpdateIds{false};
+  bool isSnapshot{false};
+  bool buyerIsMaker{false};
+  int64_t price{0};
+  int64_t quantity{0};
+  int64_t bestBid{0};
+  int64_t bestBidQuantity{0};
+  int64_t bestAsk{0};
+  int64_t bestAskQuantity{0};
+  const char* bids{nullptr}; // Level arrays, revisited once all is read
+  const char* asks{nullptr};
+
+  bool read(Cursor& c, std::string_view key) {
+    if (key.size() == 1) {
+      switch (key[0]) {
+      case 'e':
+        return c.string(eventType);
+      case 's':
+        return c.string(symbol);
+      case 'E':
+        c.integer(eventTime);
+        return c.ok();
+      case 'T':
+        c.integer(tradeTime);
+        return c.ok();
+      case 'U':
+        hasUpdateIds = c.integer(firstUpdateId);
+        return c.ok();
+      case 'u':
+        c.integer(lastUpdateId);
+        return c.ok();
+      case 'm':
+        c.boolean(buyerIsMaker);
+        return c.ok();
+      case 'p':
+        c.decimal(price);
+        return c.ok();
+      case 'q':
+        c.decimal(quantity);
+        return c.ok();
+      case 'B':
+        c.decimal(bestBidQuantity);
+        return c.ok();
+      case 'A':
+        c.decimal(bestAskQuantity);
+        return c.ok();
+      case 'b':
+        // Levels in a depthUpdate, the best bid in a bookTicker
+        if (c.peek() == '[') {
+          bids = c.position();
+          return c.skipValue();
+        }
+        c.decimal(bestBid);
+        return c.ok();
+      case 'a':
+        if (c.peek() == '[') {
+          asks = c.position();
+          return c.skipValue();
+        }
+        c.decimal(bestAsk);
+        return c.ok();
+      }
+    } else if (key == "lastUpdateId") {
+      isSnapshot = c.integer(lastUpdateId);
+      return c.ok();
+    } else if (key == "bids") {
+      bids = c.position();
+    } else if (key == "asks") {
+      asks = c.position();
+    }
+    return c.skipValue();
+  }
+};
+
+bool readSide(Cursor& c, const char* levels, MarketEventBuffer& out,
+              uint32_t symbolId, EventSide side, uint8_t flags,
+              uint64_t venueTimestamp) {
+  if (levels == nullptr) {
+    return true;
+  }
+  c.seek(levels);
+  return json::readLevels(c, out, symbolId, side, flags, venueTimestamp);
+}
+
+/**
+ * @brief Symbol of a stream name such as btcusdt@depth20@100ms
+ */
+uint32_t streamSymbol(std::string_view stream, MarketEventBuffer& out) {
+  char upper[32];
+  size_t length = stream.find('@');
+  if (length == std::string_view::npos || length > sizeof(upper)) {
+    return out.symbol(stream.substr(0, length));
+  }
+  for (size_t i = 0; i < length; ++i) {
+    upper[i] = static_cast<char>(
+        std::toupper(static_cast<unsigned char>(stream[i])));
+  }
+  return out.symbol(std::string_view(upper, length));
+}
+
+DecodedFrame decodePayload(Cursor& c, std::string_view stream,
+                           MarketEventBuffer& out) {
+  Payload payload;
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    return payload.read(c, key);
+  });
+  const char* end = c.position();
+
+  DecodedFrame decoded;
+  if (!ok) {
+    decoded.kind = FrameKind::MALFORMED;
+    return decoded;
+  }
+
+  if (payload.eventType == "depthUpdate") {
+    if (payload.symbol.empty()) {
+      return decoded;
+    }
+    uint32_t symbolId = out.symbol(payload.symbol);
+    uint64_t timestamp = payload.eventTime * NANOS_PER_MILLI;
+    size_t first = out.size();
+    ok = readSide(c, payload.bids, out, symbolId, EventSide::BID, 0,
+                  timestamp) &&
+         readSide(c, payload.asks, out, symbolId, EventSide::ASK, 0,
+                  timestamp);
+    for (size_t i = first; i < out.size(); ++i) {
+      out.events()[i].sequence = payload.lastUpdateId;
+    }
+    decoded.kind = FrameKind::DATA;
+    if (payload.hasUpdateIds) {
+      decoded.sequenceStream = symbolId;
+      decoded.firstSequence = payload.firstUpdateId;
+      decoded.lastSequence = payload.lastUpdateId;
+    }
+  } else if (payload.eventType == "trade" ||
+             payload.eventType == "aggTrade") {
+    if (payload.symbol.empty()) {
+      return decoded;
+    }
+    MarketEvent& trade =
+        out.append(MarketEventType::TRADE, out.symbol(payload.symbol));
+    trade.venueTimestamp = (payload.tradeTime != 0 ? payload.tradeTime
+                                                   : payload.eventTime) *
+                           NANOS_PER_MILLI;
+    trade.price = payload.price;
+    trade.quantity = payload.quantity;
+    trade.side = payload.buyerIsMaker ? EventSide::ASK : EventSide::BID;
+    decoded.kind = FrameKind::DATA;
+  } else if (payload.isSnapshot && payload.eventType.empty()) {
+    // Partial depth frames name their symbol only in the stream
+    if (stream.empty()) {
+      return decoded;
+    }
+    uint32_t symbolId = streamSymbol(stream, out);
+    out.append(MarketEventType::BOOK_RESET, symbolId).flags =
+        EVENT_FLAG_SNAPSHOT;
+    size_t first = out.size();
+    ok = readSide(c, payload.bids, out, symbolId, EventSide::BID,
+                  EVENT_FLAG_SNAPSHOT, 0) &&
+         readSide(c, payload.asks, out, symbolId, EventSide::ASK,
+                  EVENT_FLAG_SNAPSHOT, 0);
+    for (size_t i = first - 1; i < out.size(); ++i) {
+      out.events()[i].sequence = payload.lastUpdateId;
+    }
+    decoded.kind = FrameKind::SNAPSHOT;
+    decoded.sequenceStream = symbolId;
+    decoded.firstSequence = payload.lastUpdateId;
+    decoded.lastSequence = payload.lastUpdateId;
+  } else if (payload.eventType.empty() && !payload.symbol.empty() &&
+             (payload.bestBid != 0 || payload.bestAsk != 0)) {
+    MarketEvent& bbo =
+        out.append(MarketEventType::BBO, out.symbol(payload.symbol));
+    bbo.price = payload.bestBid;
+    bbo.quantity = payload.bestBidQuantity;
+    bbo.askPrice = payload.bestAsk;
+    bbo.askQuantity = payload.bestAskQuantity;
+    decoded.kind = FrameKind::DATA;
+  }
+
+  c.seek(end);
+  if (!ok) {
+    decoded = DecodedFrame{};
+    decoded.kind = FrameKind::MALFORMED;
+  }
+  return decoded;
+}
+
+} // namespace
+
+DecodedFrame BinanceDecoder::decode(std::string_view frame,
+                                    uint64_t /*receivedAt*/,
+                                    MarketEventBuffer& out) {
+  Cursor c(frame);
+  std::string_view stream;
+  const char* data = nullptr;
+  bool isPayload = false;
+  bool isControl = false;
+  bool isError = false;
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "stream") {
+      return c.string(stream);
+    }
+    if (key == "data") {
+      data = c.position();
+    } else if (key == "result" || key == "id") {
+      isControl = true;
+    } else if (key == "error" || key == "code" || key == "msg") {
+      isError = true;
+    } else if (key == "e" || key == "lastUpdateId" || key == "u") {
+      isPayload = true; // A raw, single-stream payload
+    }
+    return c.skipValue();
+  });
+
+  DecodedFrame decoded;
+  if (!ok || !c.atEnd()) {
+    decoded.kind = FrameKind::MALFORMED;
+    return decoded;
+  }
+
+  if (data != nullptr) {
+    c.seek(data);
+    return decodePayload(c, stream, out);
+  }
+  if (isPayload) {
+    c.seek(frame.data());
+    return decodePayload(c, stream, out);
+  }
+  decoded.kind = isError     ? FrameKind::ERROR
+                 : isControl ? FrameKind::CONTROL
+                             : FrameKind::IGNORED;
+  return decoded;
+}
+
+std::string BinanceDecoder::endpoint() const {
+  return "wss://stream.binance.com:9443/stream";
+}
+
+std::string BinanceDecoder::venueSymbol(const std::string& canonical) const {
+  std::string symbol;
+  symbol.reserve(canonical.size());
+  for (char c : canonical) {
+    if (c != '-' && c != '/') {
+      symbol.push_back(
+          static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+  }
+  return symbol;
+}
+
+std::string BinanceDecoder::streamPrefix(const std::string& canonical) const {
+  std::string prefix = venueSymbol(canonical);
+  for (char& c : prefix) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return prefix;
+}
+
+std::string BinanceDecoder::request(const char* method,
+                                    std::vector<std::string> streams) {
+  nlohmann::json message = {
+      {"method", method}, {"params", streams}, {"id", ++m_requestId}};
+  return message.dump();
+}
+
+std::vector<std::string>
+BinanceDecoder::subscriptionMessages(const std::string& canonical) {
+  std::string prefix = streamPrefix(canonical);
+  return {request("SUBSCRIBE", {prefix + "@depth@100ms", prefix + "@trade",
+                                prefix + "@bookTicker"})};
+}
+
+std::vector<std::string>
+BinanceDecoder::resyncRequest(const std::string& canonical) {
+  return {request("SUBSCRIBE", {streamPrefix(canonical) + "@depth20@100ms"})};
+}
+
+std::vector<std::string>
+BinanceDecoder::resyncComplete(const std::string& canonical) {
+  return {
+      request("UNSUBSCRIBE", {streamPrefix(canonical) + "@depth20@100ms"})};
+}
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../VenueDecoder.h"
+
+#include <atomic>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class BinanceDecoder
+ * @brief Decodes Binance spot combined-stream frames
+ *
+ * Subscribes each symbol to the diff depth, trade and bookTicker streams.
+ * Diff depth events carry first and last update ids (U and u), checked
+ * per symbol. Binance publishes full snapshots only over REST, so a resync
+ * subscribes to the 20-level partial depth stream instead: its frames
+ * carry a lastUpdateId in the same id space as the diffs, and the stream
+ * is unsubscribed again once one has arrived. Levels deeper than 20 that
+ * were lost in the gap only return as they next change. Trades report
+ * whether the buyer was the maker, so the aggressor is the other side.
+ */
+class BinanceDecoder : public VenueDecoder {
+public:
+  Venue venue() const override { return Venue::BINANCE; }
+
+  DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                      MarketEventBuffer& out) override;
+
+  std::string endpoint() const override;
+  std::string venueSymbol(const std::string& canonical) const override;
+  std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncRequest(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncComplete(const std::string& canonical) override;
+
+private:
+  std::atomic<uint64_t> m_requestId{0};
+
+  std::string request(const char* method, std::vector<std::string> streams);
+  std::string streamPrefix(const std::string& canonical) const;
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,208 @@
+#include "BitstampDecoder.h"
+
+#include <cctype>
+#include <nlohmann/json.hpp>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+using json::Cursor;
+using json::forEachMember;
+
+constexpr std::string_view DIFF_BOOK_PREFIX = "diff_order_book_";
+constexpr std::string_view FULL_BOOK_PREFIX = "order_book_";
+constexpr std::string_view TRADES_PREFIX = "live_trades_";
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+  return text.substr(0, prefix.size()) == prefix;
+}
+
+bool decodeBook(Cursor& c, uint32_t symbolId, bool snapshot,
+                MarketEventBuffer& out) {
+  uint64_t micros = 0;
+  const char* bids = nullptr;
+  const char* asks = nullptr;
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "microtimestamp") {
+      c.integer(micros);
+      return c.ok();
+    }
+    if (key == "bids") {
+      bids = c.position();
+    } else if (key == "asks") {
+      asks = c.position();
+    }
+    return c.skipValue();
+  });
+  if (!ok) {
+    return false;
+  }
+
+  const char* end = c.position();
+  uint8_t flags = snapshot ? EVENT_FLAG_SNAPSHOT : 0;
+  uint64_t timestamp = micros * 1'000;
+  if (snapshot) {
+    out.append(MarketEventType::BOOK_RESET, symbolId).flags = flags;
+  }
+  if (bids != nullptr) {
+    c.seek(bids);
+    if (!json::readLevels(c, out, symbolId, EventSide::BID, flags,
+                          timestamp)) {
+      return false;
+    }
+  }
+  if (asks != nullptr) {
+    c.seek(asks);
+    if (!json::readLevels(c, out, symbolId, EventSide::ASK, flags,
+                          timestamp)) {
+      return false;
+    }
+  }
+  c.seek(end);
+  return true;
+}
+
+bool decodeTrade(Cursor& c, uint32_t symbolId, MarketEventBuffer& out) {
+  uint64_t micros = 0;
+  uint64_t type = 2;
+  int64_t price = 0;
+  int64_t amount = 0;
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "microtimestamp") {
+      c.integer(micros);
+    } else if (key == "type") {
+      c.integer(type);
+    } else if (key == "price_str" || (key == "price" && price == 0)) {
+      c.decimal(price);
+    } else if (key == "amount_str" || (key == "amount" && amount == 0)) {
+      c.decimal(amount);
+    } else {
+      return c.skipValue();
+    }
+    return c.ok();
+  });
+  if (ok && price != 0) {
+    MarketEvent& trade = out.append(MarketEventType::TRADE, symbolId);
+    trade.venueTimestamp = micros * 1'000;
+    trade.price = price;
+    trade.quantity = amount;
+    trade.side = type == 0   ? EventSide::BID
+                 : type == 1 ? EventSide::ASK
+                             : EventSide::NONE;
+  }
+  return ok;
+}
+
+std::string request(const char* event, std::string_view prefix,
+                    const std::string& symbol) {
+  nlohmann::json message = {
+      {"event", event},
+      {"data", {{"channel", std::string(prefix) + symbol}}}};
+  return message.dump();
+}
+
+} // namespace
+
+DecodedFrame BitstampDecoder::decode(std::string_view frame,
+                                     uint64_t /*receivedAt*/,
+                                     MarketEventBuffer& out) {
+  Cursor c(frame);
+  std::string_view event;
+  std::string_view channel;
+  const char* data = nullptr;
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "event") {
+      return c.string(event);
+    }
+    if (key == "channel") {
+      return c.string(channel);
+    }
+    if (key == "data") {
+      data = c.position();
+    }
+    return c.skipValue();
+  });
+
+  DecodedFrame decoded;
+  if (!ok || !c.atEnd()) {
+    decoded.kind = FrameKind::MALFORMED;
+    return decoded;
+  }
+
+  if (event == "bts:heartbeat") {
+    decoded.kind = FrameKind::HEARTBEAT;
+    return decoded;
+  }
+  if (event == "bts:error") {
+    decoded.kind = FrameKind::ERROR;
+    return decoded;
+  }
+  if (startsWith(event, "bts:")) {
+    // Subscription acknowledgements and reconnect requests
+    decoded.kind = FrameKind::CONTROL;
+    return decoded;
+  }
+  if (data == nullptr) {
+    return decoded;
+  }
+
+  c.seek(data);
+  if (event == "data" && startsWith(channel, DIFF_BOOK_PREFIX)) {
+    ok = decodeBook(c, out.symbol(channel.substr(DIFF_BOOK_PREFIX.size())),
+                    false, out);
+    decoded.kind = FrameKind::DATA;
+  } else if (event == "data" && startsWith(channel, FULL_BOOK_PREFIX)) {
+    ok = decodeBook(c, out.symbol(channel.substr(FULL_BOOK_PREFIX.size())),
+                    true, out);
+    decoded.kind = FrameKind::SNAPSHOT;
+  } else if (event == "trade" && startsWith(channel, TRADES_PREFIX)) {
+    ok = decodeTrade(c, out.symbol(channel.substr(TRADES_PREFIX.size())),
+                     out);
+    decoded.kind = FrameKind::DATA;
+  }
+
+  if (!ok) {
+    decoded.kind = FrameKind::MALFORMED;
+  }
+  return decoded;
+}
+
+std::string BitstampDecoder::endpoint() const {
+  return "wss://ws.bitstamp.net";
+}
+
+std::string BitstampDecoder::venueSymbol(const std::string& canonical) const {
+  std::string symbol;
+  symbol.reserve(canonical.size());
+  for (char c : canonical) {
+    if (c != '-' && c != '/') {
+      symbol.push_back(
+          static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+  }
+  return symbol;
+}
+
+std::vector<std::string>
+BitstampDecoder::subscriptionMessages(const std::string& canonical) {
+  std::string symbol = venueSymbol(canonical);
+  return {request("bts:subscribe", DIFF_BOOK_PREFIX, symbol),
+          request("bts:subscribe", TRADES_PREFIX, symbol)};
+}
+
+std::vector<std::string>
+BitstampDecoder::resyncRequest(const std::string& canonical) {
+  return {request("bts:subscribe", FULL_BOOK_PREFIX, venueSymbol(canonical))};
+}
+
+std::vector<std::string>
+BitstampDecoder::resyncComplete(const std::string& canonical) {
+  return {
+      request("bts:unsubscribe", FULL_BOOK_PREFIX, venueSymbol(canonical))};
+}
+
+} // namespace exchange
+} // namespace pinnacle
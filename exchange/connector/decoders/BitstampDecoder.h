@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../VenueDecoder.h"
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class BitstampDecoder
+ * @brief Decodes Bitstamp WebSocket v2 order book and trade frames
+ *
+ * Subscribes each symbol to diff_order_book and live_trades. Bitstamp
+ * sends no sequence numbers, so gaps cannot be detected from the stream;
+ * a resync subscribes to the order_book channel, every frame of which is
+ * a full top-100 snapshot, and unsubscribes once one has arrived. Trades
+ * carry the aggressor as type 0 (buy) or 1 (sell).
+ */
+class BitstampDecoder : public VenueDecoder {
+public:
+  Venue venue() const override { return Venue::BITSTAMP; }
+
+  DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                      MarketEventBuffer& out) override;
+
+  std::string endpoint() const override;
+  std::string venueSymbol(const std::string& canonical) const override;
+  std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncRequest(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncComplete(const std::string& canonical) override;
+};
+
+} // namespace exchange
+} // namespace pinnacle
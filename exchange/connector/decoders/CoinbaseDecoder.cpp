@@ -0,0 +1,128 @@
+#include "CoinbaseDecoder.h"
+
+#include <nlohmann/json.hpp>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+std::string subscription(const char* type, const std::string& symbol,
+                         const char* channel) {
+  nlohmann::json message = {
+      {"type", type}, {"product_ids", {symbol}}, {"channel", channel}};
+  return message.dump();
+}
+
+} // namespace
+
+DecodedFrame CoinbaseDecoder::decode(std::string_view frame,
+                                     uint64_t /*receivedAt*/,
+                                     MarketEventBuffer& out) {
+  m_out = &out;
+  m_hasSequence = false;
+  m_snapshot = false;
+  CoinbaseMessageKind kind = m_scanner.scan(frame, *this);
+  m_out = nullptr;
+
+  DecodedFrame decoded;
+  if (m_hasSequence) {
+    decoded.sequenceStream = DecodedFrame::CONNECTION_SEQUENCE;
+    decoded.firstSequence = m_sequence;
+    decoded.lastSequence = m_sequence;
+    for (auto& event : out.events()) {
+      event.sequence = m_sequence;
+    }
+  }
+
+  switch (kind) {
+  case CoinbaseMessageKind::TICKER:
+    decoded.kind = FrameKind::DATA;
+    break;
+  case CoinbaseMessageKind::LEVEL2:
+    decoded.kind = m_snapshot ? FrameKind::SNAPSHOT : FrameKind::DATA;
+    break;
+  case CoinbaseMessageKind::HEARTBEAT:
+    decoded.kind = FrameKind::HEARTBEAT;
+    break;
+  case CoinbaseMessageKind::SUBSCRIPTIONS:
+    decoded.kind = FrameKind::CONTROL;
+    break;
+  case CoinbaseMessageKind::ERROR:
+    decoded.kind = FrameKind::ERROR;
+    break;
+  case CoinbaseMessageKind::MALFORMED:
+    decoded.kind = FrameKind::MALFORMED;
+    decoded.sequenceStream = DecodedFrame::NO_SEQUENCE;
+    break;
+  case CoinbaseMessageKind::OTHER:
+    decoded.kind = FrameKind::IGNORED;
+    break;
+  }
+  return decoded;
+}
+
+std::string CoinbaseDecoder::endpoint() const {
+  return "wss://advanced-trade-ws.coinbase.com";
+}
+
+std::string CoinbaseDecoder::venueSymbol(const std::string& canonical) const {
+  return canonical;
+}
+
+std::vector<std::string>
+CoinbaseDecoder::subscriptionMessages(const std::string& canonical) {
+  // The heartbeats channel needs a JWT, which the feed adds itself
+  return {subscription("subscribe", canonical, "ticker"),
+          subscription("subscribe", canonical, "level2")};
+}
+
+std::vector<std::string>
+CoinbaseDecoder::resyncRequest(const std::string& canonical) {
+  return {subscription("unsubscribe", canonical, "level2"),
+          subscription("subscribe", canonical, "level2")};
+}
+
+void CoinbaseDecoder::onTicker(const FixedPointTicker& ticker) {
+  uint32_t symbolId = m_out->symbol(ticker.symbol);
+  if (ticker.bidPrice != 0 || ticker.askPrice != 0) {
+    MarketEvent& bbo = m_out->append(MarketEventType::BBO, symbolId);
+    bbo.price = ticker.bidPrice;
+    bbo.quantity = ticker.bidSize;
+    bbo.askPrice = ticker.askPrice;
+    bbo.askQuantity = ticker.askSize;
+  }
+  if (ticker.price != 0) {
+    MarketEvent& trade = m_out->append(MarketEventType::TRADE, symbolId);
+    trade.price = ticker.price;
+    trade.quantity = ticker.size;
+  }
+}
+
+void CoinbaseDecoder::onBookEventBegin(std::string_view symbol,
+                                       BookEventType type) {
+  m_bookSymbol = m_out->symbol(symbol);
+  m_bookFlags = 0;
+  if (type == BookEventType::SNAPSHOT) {
+    m_snapshot = true;
+    m_bookFlags = EVENT_FLAG_SNAPSHOT;
+    m_out->append(MarketEventType::BOOK_RESET, m_bookSymbol).flags =
+        EVENT_FLAG_SNAPSHOT;
+  }
+}
+
+void CoinbaseDecoder::onBookDelta(const BookDelta& delta) {
+  MarketEvent& event = m_out->append(MarketEventType::BOOK_DELTA, m_bookSymbol);
+  event.price = delta.price;
+  event.quantity = delta.quantity;
+  event.side = delta.isBid ? EventSide::BID : EventSide::ASK;
+  event.flags = m_bookFlags;
+}
+
+void CoinbaseDecoder::onSequence(uint64_t sequence) {
+  m_sequence = sequence;
+  m_hasSequence = true;
+}
+
+} // namespace exchange
+} // namespace pinnacle
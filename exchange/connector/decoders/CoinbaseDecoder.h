@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../CoinbaseMessageScanner.h"
+#include "../VenueDecoder.h"
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class CoinbaseDecoder
+ * @brief Decodes Coinbase Advanced Trade ticker and level2 frames
+ *
+ * Runs CoinbaseMessageScanner over each frame. A ticker becomes a BBO
+ * event followed by a TRADE for its last price; level2 events become book
+ * deltas. Every Advanced Trade message carries a connection-wide
+ * sequence_num, so gaps are checked per connection. A resync resubscribes
+ * to level2, which answers with a fresh snapshot. Frames of the legacy
+ * Exchange feed decode too, without sequence numbers.
+ */
+class CoinbaseDecoder : public VenueDecoder, private CoinbaseScanHandler {
+public:
+  Venue venue() const override { return Venue::COINBASE; }
+
+  DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                      MarketEventBuffer& out) override;
+
+  std::string endpoint() const override;
+  std::string venueSymbol(const std::string& canonical) const override;
+  std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncRequest(const std::string& canonical) override;
+
+  const CoinbaseMessageScanner& getScanner() const { return m_scanner; }
+
+private:
+  CoinbaseMessageScanner m_scanner;
+  MarketEventBuffer* m_out{nullptr};
+  uint64_t m_sequence{0};
+  bool m_hasSequence{false};
+  bool m_snapshot{false};
+  uint32_t m_bookSymbol{0};
+  uint8_t m_bookFlags{0};
+
+  void onTicker(const FixedPointTicker& ticker) override;
+  void onBookEventBegin(std::string_view symbol, BookEventType type) override;
+  void onBookDelta(const BookDelta& delta) override;
+  void onSequence(uint64_t sequence) override;
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,175 @@
+#include "GeminiDecoder.h"
+
+#include <cctype>
+#include <nlohmann/json.hpp>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+using json::Cursor;
+using json::forEachElement;
+using json::forEachMember;
+
+constexpr uint64_t NANOS_PER_MILLI = 1'000'000;
+
+/**
+ * @brief Read an l2_updates changes array of [side, price, quantity]
+ */
+bool readChanges(Cursor& c, uint32_t symbolId, uint8_t flags,
+                 MarketEventBuffer& out) {
+  return forEachElement(c, [&]() {
+    std::string_view side;
+    int64_t price = 0;
+    int64_t quantity = 0;
+    if (!c.expect('[') || !c.string(side) || !c.expect(',')) {
+      return false;
+    }
+    bool hasPrice = c.decimal(price);
+    if (!c.expect(',')) {
+      return false;
+    }
+    bool hasQuantity = c.decimal(quantity);
+    while (c.consume(',')) {
+      c.skipValue();
+    }
+    if (!c.expect(']')) {
+      return false;
+    }
+    if (hasPrice && hasQuantity && (side == "buy" || side == "sell")) {
+      MarketEvent& event = out.append(MarketEventType::BOOK_DELTA, symbolId);
+      event.price = price;
+      event.quantity = quantity;
+      event.side = side == "buy" ? EventSide::BID : EventSide::ASK;
+      event.flags = flags;
+    }
+    return true;
+  });
+}
+
+std::string request(const char* type, const std::string& symbol) {
+  nlohmann::json message = {
+      {"type", type},
+      {"subscriptions", {{{"name", "l2"}, {"symbols", {symbol}}}}}};
+  return message.dump();
+}
+
+} // namespace
+
+DecodedFrame GeminiDecoder::decode(std::string_view frame,
+                                   uint64_t /*receivedAt*/,
+                                   MarketEventBuffer& out) {
+  Cursor c(frame);
+  std::string_view type;
+  std::string_view symbol;
+  std::string_view side;
+  std::string_view result;
+  uint64_t timestamp = 0;
+  int64_t price = 0;
+  int64_t quantity = 0;
+  const char* changes = nullptr;
+  bool hasTrades = false;
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "type") {
+      return c.string(type);
+    }
+    if (key == "symbol") {
+      return c.string(symbol);
+    }
+    if (key == "side") {
+      return c.string(side);
+    }
+    if (key == "result") {
+      return c.string(result);
+    }
+    if (key == "timestamp") {
+      c.integer(timestamp);
+      return c.ok();
+    }
+    if (key == "price") {
+      c.decimal(price);
+      return c.ok();
+    }
+    if (key == "quantity") {
+      c.decimal(quantity);
+      return c.ok();
+    }
+    if (key == "changes") {
+      changes = c.position();
+    } else if (key == "trades") {
+      hasTrades = true;
+    }
+    return c.skipValue();
+  });
+
+  DecodedFrame decoded;
+  if (!ok || !c.atEnd()) {
+    decoded.kind = FrameKind::MALFORMED;
+    return decoded;
+  }
+
+  if (result == "error") {
+    decoded.kind = FrameKind::ERROR;
+  } else if (type == "heartbeat") {
+    decoded.kind = FrameKind::HEARTBEAT;
+  } else if (type == "l2_updates" && !symbol.empty()) {
+    uint32_t symbolId = out.symbol(symbol);
+    uint8_t flags = hasTrades ? EVENT_FLAG_SNAPSHOT : 0;
+    if (hasTrades) {
+      out.append(MarketEventType::BOOK_RESET, symbolId).flags = flags;
+    }
+    if (changes != nullptr) {
+      c.seek(changes);
+      if (!readChanges(c, symbolId, flags, out)) {
+        decoded.kind = FrameKind::MALFORMED;
+        return decoded;
+      }
+    }
+    decoded.kind = hasTrades ? FrameKind::SNAPSHOT : FrameKind::DATA;
+  } else if (type == "trade" && !symbol.empty()) {
+    MarketEvent& trade =
+        out.append(MarketEventType::TRADE, out.symbol(symbol));
+    trade.venueTimestamp = timestamp * NANOS_PER_MILLI;
+    trade.price = price;
+    trade.quantity = quantity;
+    trade.side = side == "buy"    ? EventSide::BID
+                 : side == "sell" ? EventSide::ASK
+                                  : EventSide::NONE;
+    decoded.kind = FrameKind::DATA;
+  } else if (!type.empty()) {
+    decoded.kind = FrameKind::CONTROL;
+  }
+  return decoded;
+}
+
+std::string GeminiDecoder::endpoint() const {
+  return "wss://api.gemini.com/v2/marketdata";
+}
+
+std::string GeminiDecoder::venueSymbol(const std::string& canonical) const {
+  std::string symbol;
+  symbol.reserve(canonical.size());
+  for (char c : canonical) {
+    if (c != '-' && c != '/') {
+      symbol.push_back(
+          static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+  }
+  return symbol;
+}
+
+std::vector<std::string>
+GeminiDecoder::subscriptionMessages(const std::string& canonical) {
+  return {request("subscribe", venueSymbol(canonical))};
+}
+
+std::vector<std::string>
+GeminiDecoder::resyncRequest(const std::string& canonical) {
+  std::string symbol = venueSymbol(canonical);
+  return {request("unsubscribe", symbol), request("subscribe", symbol)};
+}
+
+} // namespace exchange
+} // namespace pinnacle
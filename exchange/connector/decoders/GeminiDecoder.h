@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../VenueDecoder.h"
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class GeminiDecoder
+ * @brief Decodes Gemini market data v2 l2 frames
+ *
+ * The l2 subscription carries book changes and trades; Gemini has no
+ * top-of-book stream, so no BBO events are produced. The first l2_updates
+ * of a subscription is the full book and is the only one that also carries
+ * a trades array of recent history, which marks it as a snapshot; the
+ * history itself is skipped.
+ * Gemini sends no sequence numbers, so gaps cannot be detected from the
+ * stream; a resync resubscribes to l2 for a fresh snapshot.
+ */
+class GeminiDecoder : public VenueDecoder {
+public:
+  Venue venue() const override { return Venue::GEMINI; }
+
+  DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                      MarketEventBuffer& out) override;
+
+  std::string endpoint() const override;
+  std::string venueSymbol(const std::string& canonical) const override;
+  std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncRequest(const std::string& canonical) override;
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,324 @@
+#include "KrakenDecoder.h"
+
+#include <nlohmann/json.hpp>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+using json::Cursor;
+using json::forEachElement;
+using json::forEachMember;
+
+enum class Channel { NONE, BOOK, TRADE, TICKER, HEARTBEAT, STATUS, OTHER };
+
+Channel classifyChannel(std::string_view channel) {
+  if (channel == "book") {
+    return Channel::BOOK;
+  }
+  if (channel == "trade") {
+    return Channel::TRADE;
+  }
+  if (channel == "ticker") {
+    return Channel::TICKER;
+  }
+  if (channel == "heartbeat") {
+    return Channel::HEARTBEAT;
+  }
+  if (channel == "status") {
+    return Channel::STATUS;
+  }
+  return Channel::OTHER;
+}
+
+/**
+ * @brief Read an array of {"price": p, "qty": q} levels
+ */
+bool readLevelObjects(Cursor& c, MarketEventBuffer& out, uint32_t symbolId,
+                      EventSide side, uint8_t flags, uint64_t timestamp) {
+  return forEachElement(c, [&]() {
+    int64_t price = 0;
+    int64_t quantity = 0;
+    bool hasPrice = false;
+    bool hasQuantity = false;
+    bool parsed = forEachMember(c, [&](std::string_view key) {
+      if (key == "price") {
+        hasPrice = c.decimal(price);
+        return c.ok();
+      }
+      if (key == "qty") {
+        hasQuantity = c.decimal(quantity);
+        return c.ok();
+      }
+      return c.skipValue();
+    });
+    if (parsed && hasPrice && hasQuantity) {
+      MarketEvent& event = out.append(MarketEventType::BOOK_DELTA, symbolId);
+      event.venueTimestamp = timestamp;
+      event.price = price;
+      event.quantity = quantity;
+      event.side = side;
+      event.flags = flags;
+    }
+    return parsed;
+  });
+}
+
+bool decodeBook(Cursor& c, bool snapshot, MarketEventBuffer& out) {
+  uint8_t flags = snapshot ? EVENT_FLAG_SNAPSHOT : 0;
+  return forEachElement(c, [&]() {
+    std::string_view symbol;
+    std::string_view timestamp;
+    const char* bids = nullptr;
+    const char* asks = nullptr;
+    bool parsed = forEachMember(c, [&](std::string_view key) {
+      if (key == "symbol") {
+        return c.string(symbol);
+      }
+      if (key == "timestamp") {
+        return c.string(timestamp);
+      }
+      if (key == "bids") {
+        bids = c.position();
+      } else if (key == "asks") {
+        asks = c.position();
+      }
+      return c.skipValue();
+    });
+    if (!parsed || symbol.empty()) {
+      return parsed;
+    }
+
+    const char* end = c.position();
+    uint32_t symbolId = out.symbol(symbol);
+    uint64_t venueTimestamp = parseIsoTimestamp(timestamp);
+    if (snapshot) {
+      out.append(MarketEventType::BOOK_RESET, symbolId).flags = flags;
+    }
+    if (bids != nullptr) {
+      c.seek(bids);
+      if (!readLevelObjects(c, out, symbolId, EventSide::BID, flags,
+                            venueTimestamp)) {
+        return false;
+      }
+    }
+    if (asks != nullptr) {
+      c.seek(asks);
+      if (!readLevelObjects(c, out, symbolId, EventSide::ASK, flags,
+                            venueTimestamp)) {
+        return false;
+      }
+    }
+    c.seek(end);
+    return true;
+  });
+}
+
+bool decodeTrades(Cursor& c, MarketEventBuffer& out) {
+  return forEachElement(c, [&]() {
+    std::string_view symbol;
+    std::string_view side;
+    std::string_view timestamp;
+    int64_t price = 0;
+    int64_t quantity = 0;
+    bool parsed = forEachMember(c, [&](std::string_view key) {
+      if (key == "symbol") {
+        return c.string(symbol);
+      }
+      if (key == "side") {
+        return c.string(side);
+      }
+      if (key == "timestamp") {
+        return c.string(timestamp);
+      }
+      if (key == "price") {
+        c.decimal(price);
+        return c.ok();
+      }
+      if (key == "qty") {
+        c.decimal(quantity);
+        return c.ok();
+      }
+      return c.skipValue();
+    });
+    if (parsed && !symbol.empty() && price != 0) {
+      MarketEvent& trade =
+          out.append(MarketEventType::TRADE, out.symbol(symbol));
+      trade.venueTimestamp = parseIsoTimestamp(timestamp);
+      trade.price = price;
+      trade.quantity = quantity;
+      trade.side = side == "buy"    ? EventSide::BID
+                   : side == "sell" ? EventSide::ASK
+                                    : EventSide::NONE;
+    }
+    return parsed;
+  });
+}
+
+bool decodeTickers(Cursor& c, MarketEventBuffer& out) {
+  return forEachElement(c, [&]() {
+    std::string_view symbol;
+    int64_t bid = 0, bidQuantity = 0, ask = 0, askQuantity = 0;
+    bool parsed = forEachMember(c, [&](std::string_view key) {
+      if (key == "symbol") {
+        return c.string(symbol);
+      }
+      if (key == "bid") {
+        c.decimal(bid);
+      } else if (key == "bid_qty") {
+        c.decimal(bidQuantity);
+      } else if (key == "ask") {
+        c.decimal(ask);
+      } else if (key == "ask_qty") {
+        c.decimal(askQuantity);
+      } else {
+        return c.skipValue();
+      }
+      return c.ok();
+    });
+    if (parsed && !symbol.empty() && (bid != 0 || ask != 0)) {
+      MarketEvent& bbo = out.append(MarketEventType::BBO, out.symbol(symbol));
+      bbo.price = bid;
+      bbo.quantity = bidQuantity;
+      bbo.askPrice = ask;
+      bbo.askQuantity = askQuantity;
+    }
+    return parsed;
+  });
+}
+
+std::string request(const char* method, const char* channel,
+                    const std::string& symbol) {
+  nlohmann::json params = {{"channel", channel}, {"symbol", {symbol}}};
+  if (std::string_view(channel) == "book") {
+    params["depth"] = 100;
+  } else if (std::string_view(channel) == "ticker") {
+    params["event_trigger"] = "bbo";
+  }
+  nlohmann::json message = {{"method", method}, {"params", params}};
+  return message.dump();
+}
+
+} // namespace
+
+DecodedFrame KrakenDecoder::decode(std::string_view frame,
+                                   uint64_t /*receivedAt*/,
+                                   MarketEventBuffer& out) {
+  Cursor c(frame);
+  Channel channel = Channel::NONE;
+  std::string_view type;
+  std::string_view method;
+  const char* data = nullptr;
+  bool success = true;
+  bool hasError = false;
+
+  bool ok = forEachMember(c, [&](std::string_view key) {
+    if (key == "channel") {
+      std::string_view name;
+      if (!c.string(name)) {
+        return false;
+      }
+      channel = classifyChannel(name);
+      return true;
+    }
+    if (key == "type") {
+      return c.string(type);
+    }
+    if (key == "method") {
+      return c.string(method);
+    }
+    if (key == "success") {
+      c.boolean(success);
+      return c.ok();
+    }
+    if (key == "data") {
+      data = c.position();
+    } else if (key == "error") {
+      hasError = true;
+    }
+    return c.skipValue();
+  });
+
+  DecodedFrame decoded;
+  if (!ok || !c.atEnd()) {
+    decoded.kind = FrameKind::MALFORMED;
+    return decoded;
+  }
+
+  if (!method.empty() || hasError) {
+    decoded.kind =
+        success && !hasError ? FrameKind::CONTROL : FrameKind::ERROR;
+    return decoded;
+  }
+
+  bool snapshot = type == "snapshot";
+  switch (channel) {
+  case Channel::HEARTBEAT:
+    decoded.kind = FrameKind::HEARTBEAT;
+    return decoded;
+  case Channel::STATUS:
+    decoded.kind = FrameKind::CONTROL;
+    return decoded;
+  case Channel::BOOK:
+    if (data != nullptr) {
+      c.seek(data);
+      ok = decodeBook(c, snapshot, out);
+      decoded.kind = snapshot ? FrameKind::SNAPSHOT : FrameKind::DATA;
+    }
+    break;
+  case Channel::TRADE:
+    // The snapshot replays recent trades, which are history by now
+    if (data != nullptr && !snapshot) {
+      c.seek(data);
+      ok = decodeTrades(c, out);
+      decoded.kind = FrameKind::DATA;
+    }
+    break;
+  case Channel::TICKER:
+    if (data != nullptr) {
+      c.seek(data);
+      ok = decodeTickers(c, out);
+      decoded.kind = FrameKind::DATA;
+    }
+    break;
+  case Channel::NONE:
+  case Channel::OTHER:
+    break;
+  }
+
+  if (!ok) {
+    decoded.kind = FrameKind::MALFORMED;
+  }
+  return decoded;
+}
+
+std::string KrakenDecoder::endpoint() const { return "wss://ws.kraken.com/v2"; }
+
+std::string KrakenDecoder::venueSymbol(const std::string& canonical) const {
+  std::string symbol = canonical;
+  for (char& c : symbol) {
+    if (c == '-') {
+      c = '/';
+    }
+  }
+  return symbol;
+}
+
+std::vector<std::string>
+KrakenDecoder::subscriptionMessages(const std::string& canonical) {
+  std::string symbol = venueSymbol(canonical);
+  return {request("subscribe", "book", symbol),
+          request("subscribe", "trade", symbol),
+          request("subscribe", "ticker", symbol)};
+}
+
+std::vector<std::string>
+KrakenDecoder::resyncRequest(const std::string& canonical) {
+  std::string symbol = venueSymbol(canonical);
+  return {request("unsubscribe", "book", symbol),
+          request("subscribe", "book", symbol)};
+}
+
+} // namespace exchange
+} // namespace pinnacle
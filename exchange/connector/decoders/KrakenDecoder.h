@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../VenueDecoder.h"
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class KrakenDecoder
+ * @brief Decodes Kraken WebSocket v2 book, trade and ticker frames
+ *
+ * Book frames are a snapshot on subscription and updates after it; the
+ * ticker channel, subscribed with the bbo trigger, becomes BBO events.
+ * Kraken v2 has no sequence numbers on public channels, so gaps cannot be
+ * detected from the stream; a resync requested by the handler's owner
+ * resubscribes to the book, which answers with a fresh snapshot.
+ */
+class KrakenDecoder : public VenueDecoder {
+public:
+  Venue venue() const override { return Venue::KRAKEN; }
+
+  DecodedFrame decode(std::string_view frame, uint64_t receivedAt,
+                      MarketEventBuffer& out) override;
+
+  std::string endpoint() const override;
+  std::string venueSymbol(const std::string& canonical) const override;
+  std::vector<std::string>
+  subscriptionMessages(const std::string& canonical) override;
+  std::vector<std::string>
+  resyncRequest(const std::string& canonical) override;
+};
+
+} // namespace exchange
+} // namespace pinnacle
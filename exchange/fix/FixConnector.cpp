@@ -1,28 +1,85 @@
 #include "FixConnector.h"
+#include "../../core/utils/TimeUtils.h"
 
-#include <arpa/inet.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
-#include <openssl/err.h>
-#include <openssl/ssl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <cstring>
 #include <iostream>
-#include <sstream>
 
 namespace pinnacle {
 namespace exchange {
 namespace fix {
 
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+// Longest the network thread waits in poll(), bounding how late stop() and
+// heartbeats are noticed
+constexpr int POLL_TIMEOUT_MS = 50;
+
+constexpr auto RECONNECT_DELAY = std::chrono::seconds(1);
+
+// Session messages are gap filled rather than resent
+bool isAdminMessage(std::string_view msgType) {
+  return msgType.size() == 1 &&
+         std::string_view("012345A").find(msgType[0]) != std::string_view::npos;
+}
+
+struct NewOrderLayout {
+  size_t kind; // Index into OrderTemplates::newOrder
+  char ordType;
+  char timeInForce;
+};
+
+bool newOrderLayout(pinnacle::OrderType type, NewOrderLayout& layout) {
+  switch (type) {
+  case pinnacle::OrderType::MARKET:
+    layout = {0, '1', '1'};
+    return true;
+  case pinnacle::OrderType::LIMIT:
+    layout = {1, '2', '1'}; // Good till cancel
+    return true;
+  case pinnacle::OrderType::IOC:
+    layout = {2, '2', '3'};
+    return true;
+  case pinnacle::OrderType::FOK:
+    layout = {3, '2', '4'};
+    return true;
+  default:
+    return false; // Stop orders have no template
+  }
+}
+
+char sideCode(pinnacle::OrderSide side) {
+  return side == pinnacle::OrderSide::BUY ? '1' : '2';
+}
+
+std::chrono::steady_clock::rep steadyTicks() {
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
 FixConnector::FixConnector(const FixConfig& config,
                            std::shared_ptr<utils::ApiCredentials> credentials)
-    : m_config(config), m_credentials(credentials) {
-  m_receiveBuffer.reserve(RECEIVE_BUFFER_SIZE);
-}
+    : m_config(config), m_credentials(credentials),
+      m_reader(RECEIVE_BUFFER_SIZE), m_builder(config.fixVersion),
+      // Microseconds since the epoch fill the 16-digit ClOrdID and keep
+      // increasing across restarts unless orders outpace the clock
+      m_nextClOrdId(utils::TimeUtils::getWallClockNanos() / 1000) {}
 
 FixConnector::~FixConnector() { stop(); }
 
@@ -31,20 +88,39 @@ bool FixConnector::start() {
     return false;
   }
 
+  // Derived connectors finish the configuration in their constructors, so
+  // everything that depends on it is set up here
+  m_builder = FixMessageBuilder(m_config.fixVersion);
+  std::string sessionId = m_config.senderCompId + "->" + m_config.targetCompId;
+  if (!m_config.sequenceStorePath.empty() &&
+      !m_sequenceStore.open(m_config.sequenceStorePath, sessionId)) {
+    setSessionStatus("Cannot open sequence store " +
+                     m_config.sequenceStorePath);
+    return false;
+  }
+  if (!m_messageStore.open(m_config.messageStorePath, sessionId,
+                           m_config.messageStoreCapacity)) {
+    setSessionStatus("Cannot open message store " +
+                     m_config.messageStorePath);
+    m_sequenceStore.close();
+    return false;
+  }
+
+  // A crash after storing a message but before advancing the sequence
+  // number leaves a number that may already be on the wire
+  uint64_t stored = m_messageStore.lastSeqNum();
+  if (stored >= m_sequenceStore.nextSenderSeqNum()) {
+    std::cerr << "FIX: message store is ahead of the sequence store, "
+              << "continuing from " << stored + 1 << std::endl;
+    m_sequenceStore.setNextSenderSeqNum(stored + 1);
+  }
+
   m_shouldStop.store(false);
   m_isRunning.store(true);
 
   // Start network thread
   m_networkThread = std::thread(&FixConnector::networkThread, this);
-
-  // Start message processing thread
-  m_messageProcessingThread =
-      std::thread(&FixConnector::messageProcessingLoop, this);
-
-  // Wait a moment for connection
-  std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-  return m_isRunning.load();
+  return true;
 }
 
 bool FixConnector::stop() {
@@ -52,25 +128,19 @@ bool FixConnector::stop() {
     return true;
   }
 
-  m_shouldStop.store(true);
-
   if (m_isLoggedOn.load()) {
     sendLogout();
   }
+  m_shouldStop.store(true);
 
-  disconnectFromExchange();
-
-  // Join threads
   if (m_networkThread.joinable()) {
     m_networkThread.join();
   }
-  if (m_messageProcessingThread.joinable()) {
-    m_messageProcessingThread.join();
-  }
 
+  m_sequenceStore.close();
+  m_messageStore.close();
   m_isRunning.store(false);
   m_isLoggedOn.store(false);
-
   return true;
 }
 
@@ -79,58 +149,52 @@ bool FixConnector::isRunning() const { return m_isRunning.load(); }
 bool FixConnector::subscribeToMarketUpdates(
     const std::string& symbol,
     std::function<void(const MarketUpdate&)> callback) {
-
-  std::lock_guard<std::mutex> lock(m_callbacksMutex);
-  m_marketUpdateCallbacks[symbol].push_back(callback);
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_marketUpdateCallbacks[symbol].push_back(callback);
+  }
 
   if (m_isLoggedOn.load()) {
-    // Subscribe to market data
-    auto mdRequest = createMarketDataRequest(symbol, '1'); // Subscribe
-    return sendMessage(mdRequest);
+    return sendMarketDataRequest(symbol, '1'); // Subscribe
   }
-
   return true; // Will subscribe when logged on
 }
 
 bool FixConnector::subscribeToOrderBookUpdates(
     const std::string& symbol,
     std::function<void(const OrderBookUpdate&)> callback) {
-
-  std::lock_guard<std::mutex> lock(m_callbacksMutex);
-  m_orderBookUpdateCallbacks[symbol].push_back(callback);
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_orderBookUpdateCallbacks[symbol].push_back(callback);
+  }
 
   if (m_isLoggedOn.load()) {
-    // Subscribe to market data
-    auto mdRequest = createMarketDataRequest(symbol, '1'); // Subscribe
-    return sendMessage(mdRequest);
+    return sendMarketDataRequest(symbol, '1'); // Subscribe
   }
-
   return true; // Will subscribe when logged on
 }
 
 bool FixConnector::unsubscribeFromMarketUpdates(const std::string& symbol) {
-  std::lock_guard<std::mutex> lock(m_callbacksMutex);
-  m_marketUpdateCallbacks.erase(symbol);
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_marketUpdateCallbacks.erase(symbol);
+  }
 
   if (m_isLoggedOn.load()) {
-    // Unsubscribe from market data
-    auto mdRequest = createMarketDataRequest(symbol, '2'); // Unsubscribe
-    return sendMessage(mdRequest);
+    return sendMarketDataRequest(symbol, '2'); // Unsubscribe
   }
-
   return true;
 }
 
 bool FixConnector::unsubscribeFromOrderBookUpdates(const std::string& symbol) {
-  std::lock_guard<std::mutex> lock(m_callbacksMutex);
-  m_orderBookUpdateCallbacks.erase(symbol);
+  {
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    m_orderBookUpdateCallbacks.erase(symbol);
+  }
 
   if (m_isLoggedOn.load()) {
-    // Unsubscribe from market data
-    auto mdRequest = createMarketDataRequest(symbol, '2'); // Unsubscribe
-    return sendMessage(mdRequest);
+    return sendMarketDataRequest(symbol, '2'); // Unsubscribe
   }
-
   return true;
 }
 
@@ -161,459 +225,591 @@ std::string FixConnector::getSessionStatus() const {
   return m_sessionStatus;
 }
 
-bool FixConnector::sendMessage(const hffix::message_writer& msg) {
-  if (m_socket == -1) {
-    return false;
-  }
-
-  std::string message = std::string(msg.message_begin(), msg.message_end());
-
-  // Add to outgoing queue for network thread to process
-  return m_outgoingMessages.push(message);
+void FixConnector::setSessionStatus(std::string status) {
+  std::lock_guard<std::mutex> lock(m_statusMutex);
+  m_sessionStatus = std::move(status);
 }
 
-hffix::message_writer
-FixConnector::createMarketDataRequest(const std::string& symbol,
-                                      char subscriptionRequestType) {
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
-
-  msg.push_back_header("V"); // Market Data Request
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
-
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
-
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
+// ============================================================================
+// Sending
+// ============================================================================
 
-  // Market Data Request specific fields
-  msg.push_back_string(hffix::tag::MDReqID, "MD001");
-  msg.push_back_char(hffix::tag::SubscriptionRequestType,
-                     subscriptionRequestType);
-  msg.push_back_int(hffix::tag::MarketDepth, 1); // Top of book
+FixHeaderFields FixConnector::headerFields() const {
+  return FixHeaderFields{m_config.fixVersion, m_config.senderCompId,
+                         m_config.targetCompId};
+}
 
-  // NoMDEntryTypes
-  msg.push_back_int(hffix::tag::NoMDEntryTypes, 2);
-  msg.push_back_char(hffix::tag::MDEntryType, '0'); // Bid
-  msg.push_back_char(hffix::tag::MDEntryType, '1'); // Offer
+FixConnector::OrderTemplates&
+FixConnector::templatesFor(const std::string& symbol) {
+  auto it = m_templates.find(symbol);
+  if (it != m_templates.end()) {
+    return it->second;
+  }
 
-  // NoRelatedSym
-  msg.push_back_int(hffix::tag::NoRelatedSym, 1);
-  msg.push_back_string(hffix::tag::Symbol, symbol.c_str());
+  OrderTemplates& templates = m_templates[symbol];
+  FixHeaderFields header = headerFields();
+  for (auto side : {pinnacle::OrderSide::BUY, pinnacle::OrderSide::SELL}) {
+    size_t s = static_cast<size_t>(side);
+    for (auto type : {pinnacle::OrderType::MARKET, pinnacle::OrderType::LIMIT,
+                      pinnacle::OrderType::IOC, pinnacle::OrderType::FOK}) {
+      NewOrderLayout layout{};
+      newOrderLayout(type, layout);
+      templates.newOrder[s][layout.kind] =
+          std::make_unique<NewOrderSingleTemplate>(
+              header, symbol, sideCode(side), layout.ordType,
+              layout.timeInForce, m_config.priceDecimals,
+              m_config.quantityDecimals);
+    }
+    templates.cancel[s] = std::make_unique<OrderCancelTemplate>(
+        header, symbol, sideCode(side), m_config.quantityDecimals);
+  }
+  return templates;
+}
 
-  msg.push_back_trailer();
-  return msg;
+void FixConnector::prepareOrderTemplates(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  templatesFor(symbol);
 }
 
-hffix::message_writer
-FixConnector::createNewOrderSingle(const pinnacle::Order& order) {
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
+bool FixConnector::submitNewOrderSingle(const pinnacle::Order& order) {
+  NewOrderLayout layout{};
+  if (!newOrderLayout(order.getType(), layout)) {
+    return false;
+  }
 
-  msg.push_back_header("D"); // New Order Single
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
+  uint64_t clOrdId;
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    auto& message =
+        *templatesFor(order.getSymbol())
+             .newOrder[static_cast<size_t>(order.getSide())][layout.kind];
+
+    clOrdId = m_nextClOrdId;
+    uint64_t seqNum = m_sequenceStore.nextSenderSeqNum();
+    uint64_t now = utils::TimeUtils::getWallClockNanos();
+    std::string_view encoded = message.encode(
+        seqNum, now, clOrdId, order.getPrice(), order.getQuantity());
+    if (encoded.empty()) {
+      std::cerr << "FIX: order " << order.getOrderId()
+                << " does not fit the message template" << std::endl;
+      return false;
+    }
 
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
+    ++m_nextClOrdId;
+    // Mapped before the write, as the venue may answer before it returns
+    {
+      std::lock_guard<std::mutex> ordersLock(m_ordersMutex);
+      m_orderIdByClOrdId[clOrdId] = order.getOrderId();
+    }
+    if (!sendSequenced(seqNum, now, encoded, false)) {
+      std::lock_guard<std::mutex> ordersLock(m_ordersMutex);
+      m_orderIdByClOrdId.erase(clOrdId);
+      return false;
+    }
+  }
 
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
+  // Only cancels need the rest, so it waits until the order is on the wire
+  std::lock_guard<std::mutex> lock(m_ordersMutex);
+  m_sentOrders[order.getOrderId()] =
+      SentOrder{clOrdId, order.getSymbol(), order.getSide(),
+                order.getQuantity()};
+  return true;
+}
 
-  // Order fields
-  msg.push_back_string(hffix::tag::ClOrdID, order.getOrderId().c_str());
-  msg.push_back_string(hffix::tag::Symbol, order.getSymbol().c_str());
-  msg.push_back_char(hffix::tag::Side,
-                     order.getSide() == pinnacle::OrderSide::BUY ? '1' : '2');
-  msg.push_back_char(hffix::tag::OrdType,
-                     order.getType() == pinnacle::OrderType::LIMIT
-                         ? '2'
-                         : '1'); // Market = 1, Limit = 2
-  msg.push_back_decimal(hffix::tag::OrderQty, order.getQuantity(), 8);
+bool FixConnector::submitOrderCancel(const std::string& orderId) {
+  SentOrder sent;
+  {
+    std::lock_guard<std::mutex> lock(m_ordersMutex);
+    auto it = m_sentOrders.find(orderId);
+    if (it == m_sentOrders.end()) {
+      return false;
+    }
+    sent = it->second;
+  }
 
-  if (order.getType() == pinnacle::OrderType::LIMIT) {
-    msg.push_back_decimal(hffix::tag::Price, order.getPrice(), 8);
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  auto& message =
+      *templatesFor(sent.symbol).cancel[static_cast<size_t>(sent.side)];
+  uint64_t clOrdId = m_nextClOrdId++;
+  uint64_t seqNum = m_sequenceStore.nextSenderSeqNum();
+  uint64_t now = utils::TimeUtils::getWallClockNanos();
+  std::string_view encoded =
+      message.encode(seqNum, now, clOrdId, sent.clOrdId, sent.quantity);
+  if (encoded.empty()) {
+    return false;
   }
 
-  msg.push_back_char(hffix::tag::TimeInForce, '1'); // Good Till Cancel
+  // As for new orders, mapped before the venue can answer
+  {
+    std::lock_guard<std::mutex> ordersLock(m_ordersMutex);
+    m_orderIdByClOrdId[clOrdId] = orderId;
+  }
+  if (!sendSequenced(seqNum, now, encoded, false)) {
+    std::lock_guard<std::mutex> ordersLock(m_ordersMutex);
+    m_orderIdByClOrdId.erase(clOrdId);
+    return false;
+  }
+  return true;
+}
 
-  msg.push_back_trailer();
-  return msg;
+bool FixConnector::sendMessage(
+    std::string_view msgType,
+    const std::function<void(FixMessageBuilder&)>& addFields) {
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  uint64_t seqNum = m_sequenceStore.nextSenderSeqNum();
+  uint64_t now = utils::TimeUtils::getWallClockNanos();
+  m_builder.begin(msgType, m_config.senderCompId, m_config.targetCompId,
+                  seqNum, now);
+  if (addFields) {
+    addFields(m_builder);
+  }
+  return sendSequenced(seqNum, now, m_builder.finish(),
+                       isAdminMessage(msgType));
 }
 
-hffix::message_writer
-FixConnector::createOrderCancelRequest(const std::string& orderId) {
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
+bool FixConnector::sendSequenced(uint64_t seqNum, uint64_t sendingTime,
+                                 std::string_view message, bool isAdmin) {
+  // Stored before the number is taken, so a crash in between cannot hand
+  // the same number to a different message after a restart
+  m_messageStore.store(seqNum, sendingTime, message, isAdmin);
+  m_sequenceStore.takeSenderSeqNum();
+  return writeToSocket(message);
+}
 
-  msg.push_back_header("F"); // Order Cancel Request
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
+bool FixConnector::sendMarketDataRequest(const std::string& symbol,
+                                         char subscriptionRequestType) {
+  return sendMessage("V", [&](FixMessageBuilder& msg) {
+    msg.field(tag::MDReqID, static_cast<int64_t>(++m_mdReqId))
+        .field(tag::SubscriptionRequestType, subscriptionRequestType)
+        .field(tag::MarketDepth, static_cast<int64_t>(1)) // Top of book
+        .field(tag::NoMDEntryTypes, static_cast<int64_t>(2))
+        .field(tag::MDEntryType, '0') // Bid
+        .field(tag::MDEntryType, '1') // Offer
+        .field(tag::NoRelatedSym, static_cast<int64_t>(1))
+        .field(tag::Symbol, symbol);
+  });
+}
 
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
+std::string FixConnector::orderIdForClOrdId(std::string_view clOrdId) const {
+  uint64_t id = 0;
+  auto [ptr, ec] =
+      std::from_chars(clOrdId.data(), clOrdId.data() + clOrdId.size(), id);
+  if (ec != std::errc() || ptr != clOrdId.data() + clOrdId.size()) {
+    return {};
+  }
 
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
-
-  msg.push_back_string(hffix::tag::OrigClOrdID, orderId.c_str());
-  msg.push_back_string(hffix::tag::ClOrdID, ("CANCEL_" + orderId).c_str());
-
-  msg.push_back_trailer();
-  return msg;
+  std::lock_guard<std::mutex> lock(m_ordersMutex);
+  auto it = m_orderIdByClOrdId.find(id);
+  return it != m_orderIdByClOrdId.end() ? it->second : std::string();
 }
 
-void FixConnector::networkThread() {
-  while (!m_shouldStop.load()) {
-    if (!m_isLoggedOn.load()) {
-      connectToExchange();
-      if (m_socket != -1) {
-        sendLogon();
+bool FixConnector::writeToSocket(std::string_view message) {
+  int socket = m_socket.load();
+  if (socket == -1) {
+    return false;
+  }
+
+  while (!message.empty()) {
+    ssize_t written = send(socket, message.data(), message.size(), SEND_FLAGS);
+    if (written > 0) {
+      message.remove_prefix(static_cast<size_t>(written));
+      continue;
+    }
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // Socket buffer full: wait for room rather than drop half a message
+      pollfd out{socket, POLLOUT, 0};
+      if (poll(&out, 1, 1000) > 0) {
+        continue;
       }
     }
+    return false;
+  }
 
-    if (m_socket != -1) {
-      processIncomingMessages();
+  m_lastMessageSent.store(steadyTicks());
+  m_messagesSent.fetch_add(1);
+  return true;
+}
 
-      // Send any pending outgoing messages
-      std::string outgoingMsg;
-      while (m_outgoingMessages.pop(outgoingMsg)) {
-        send(m_socket, outgoingMsg.c_str(), outgoingMsg.length(), 0);
-      }
+// ============================================================================
+// Connection
+// ============================================================================
 
-      // Check for heartbeat timeout
-      auto now = std::chrono::steady_clock::now();
-      if (std::chrono::duration_cast<std::chrono::seconds>(now -
-                                                           m_lastHeartbeatSent)
-              .count() >= m_config.heartbeatInterval) {
-        sendHeartbeat();
+void FixConnector::networkThread() {
+  while (!m_shouldStop.load()) {
+    if (m_socket.load() == -1) {
+      if (!connectToExchange()) {
+        auto retryAt = std::chrono::steady_clock::now() + RECONNECT_DELAY;
+        while (!m_shouldStop.load() &&
+               std::chrono::steady_clock::now() < retryAt) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        continue;
       }
+      m_reader.clear();
+      m_lastMessageReceived = std::chrono::steady_clock::now();
+      m_testRequestPending = false;
+      sendLogon();
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    pollfd in{m_socket.load(), POLLIN, 0};
+    int ready = poll(&in, 1, POLL_TIMEOUT_MS);
+    if (ready > 0 && !readFromSocket()) {
+      disconnectFromExchange();
+      continue;
+    }
+    checkHeartbeats();
   }
 
-  if (m_socket != -1) {
-    close(m_socket);
-    m_socket = -1;
-  }
+  disconnectFromExchange();
 }
 
-void FixConnector::connectToExchange() {
-  if (m_socket != -1) {
-    return; // Already connected
+bool FixConnector::connectToExchange() {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  std::string port = std::to_string(m_config.port);
+  if (getaddrinfo(m_config.host.c_str(), port.c_str(), &hints, &addresses) !=
+      0) {
+    setSessionStatus("Failed to resolve hostname: " + m_config.host);
+    return false;
   }
 
-  // Create socket
-  m_socket = socket(AF_INET, SOCK_STREAM, 0);
-  if (m_socket == -1) {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus = "Failed to create socket";
-    return;
+  int socket = -1;
+  for (addrinfo* address = addresses; address; address = address->ai_next) {
+    socket = ::socket(address->ai_family, address->ai_socktype,
+                      address->ai_protocol);
+    if (socket == -1) {
+      continue;
+    }
+    if (connect(socket, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(socket);
+    socket = -1;
   }
+  freeaddrinfo(addresses);
 
-  // Resolve hostname
-  struct hostent* server = gethostbyname(m_config.host.c_str());
-  if (server == nullptr) {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus = "Failed to resolve hostname: " + m_config.host;
-    close(m_socket);
-    m_socket = -1;
-    return;
+  if (socket == -1) {
+    setSessionStatus("Failed to connect to " + m_config.host + ":" + port);
+    return false;
   }
 
-  // Connect to server
-  struct sockaddr_in serv_addr;
-  memset(&serv_addr, 0, sizeof(serv_addr));
-  serv_addr.sin_family = AF_INET;
-  serv_addr.sin_port = htons(m_config.port);
-  memcpy(&serv_addr.sin_addr.s_addr, server->h_addr, server->h_length);
-
-  if (connect(m_socket, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus = "Failed to connect to " + m_config.host + ":" +
-                      std::to_string(m_config.port);
-    close(m_socket);
-    m_socket = -1;
-    return;
-  }
+  // Orders are small and latency bound; never hold them back
+  utils::SocketTuning::apply(socket, m_config.socketTuning);
 
   // Set socket to non-blocking
-  int flags = fcntl(m_socket, F_GETFL, 0);
-  fcntl(m_socket, F_SETFL, flags | O_NONBLOCK);
+  int flags = fcntl(socket, F_GETFL, 0);
+  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
 
-  {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus =
-        "Connected to " + m_config.host + ":" + std::to_string(m_config.port);
-  }
+  m_socket.store(socket);
+  setSessionStatus("Connected to " + m_config.host + ":" + port);
+  return true;
 }
 
 void FixConnector::disconnectFromExchange() {
-  if (m_socket != -1) {
-    close(m_socket);
-    m_socket = -1;
+  bool wasLoggedOn = m_isLoggedOn.exchange(false);
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    int socket = m_socket.exchange(-1);
+    if (socket != -1) {
+      close(socket);
+    }
+  }
+  if (wasLoggedOn) {
+    setSessionStatus("Disconnected");
+    onLogout();
   }
-  m_isLoggedOn.store(false);
 }
 
-void FixConnector::processIncomingMessages() {
-  if (m_socket == -1) {
-    return;
+bool FixConnector::readFromSocket() {
+  std::span<char> space = m_reader.writable();
+  if (space.empty()) {
+    std::cerr << "FIX: message larger than the receive buffer" << std::endl;
+    return false;
   }
 
-  char buffer[4096];
-  ssize_t bytesRead = recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-
-  if (bytesRead > 0) {
-    buffer[bytesRead] = '\0';
-    m_receiveBuffer.append(buffer, bytesRead);
-    m_lastMessageReceived = std::chrono::steady_clock::now();
-
-    // Process complete messages
-    size_t pos = 0;
-    while (pos < m_receiveBuffer.length()) {
-      // Find SOH (Start of Header, ASCII 1)
-      size_t sohPos = m_receiveBuffer.find('\x01', pos);
-      if (sohPos == std::string::npos) {
-        break;
-      }
+  ssize_t bytesRead =
+      utils::SocketTuning::receive(m_socket.load(), space.data(), space.size(),
+                                   0, m_kernelReceiveTime);
+  if (bytesRead == 0) {
+    return false; // Connection closed
+  }
+  if (bytesRead < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
 
-      // Extract message
-      std::string message = m_receiveBuffer.substr(pos, sohPos - pos + 1);
-      m_incomingMessages.push(message);
-      pos = sohPos + 1;
-    }
+  m_reader.commit(static_cast<size_t>(bytesRead));
+  m_lastMessageReceived = std::chrono::steady_clock::now();
+  m_testRequestPending = false;
 
-    // Remove processed data
-    if (pos > 0) {
-      m_receiveBuffer.erase(0, pos);
-    }
-  } else if (bytesRead == 0) {
-    // Connection closed
-    disconnectFromExchange();
-  } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-    // Error
-    disconnectFromExchange();
+  std::string_view message;
+  while (m_socket.load() != -1 && m_reader.next(message)) {
+    processMessage(message);
   }
+  return m_socket.load() != -1;
 }
 
-void FixConnector::messageProcessingLoop() {
-  while (!m_shouldStop.load()) {
-    std::string message;
-    while (m_incomingMessages.pop(message)) {
-      processMessage(message);
-    }
-    std::this_thread::sleep_for(std::chrono::microseconds(100));
+void FixConnector::checkHeartbeats() {
+  if (!m_isLoggedOn.load() || m_socket.load() == -1) {
+    return;
   }
-}
 
-void FixConnector::processMessage(const std::string& rawMessage) {
-  hffix::message_reader msg(rawMessage.c_str(),
-                            rawMessage.c_str() + rawMessage.length());
+  using namespace std::chrono;
+  auto interval = seconds(m_config.heartbeatInterval);
+  auto now = steady_clock::now();
 
-  if (!validateMessage(msg)) {
-    return;
+  auto sinceSent = now - steady_clock::time_point(
+                             steady_clock::duration(m_lastMessageSent.load()));
+  if (sinceSent >= interval) {
+    sendHeartbeat();
   }
 
-  hffix::field msgType;
-  if (msg.find_with_hint(hffix::tag::MsgType, msgType)) {
-    std::string msgTypeStr(msgType.begin(), msgType.end());
-
-    if (msgTypeStr == "A") {
-      handleLogon(msg);
-    } else if (msgTypeStr == "5") {
-      handleLogout(msg);
-    } else if (msgTypeStr == "0") {
-      handleHeartbeat(msg);
-    } else if (msgTypeStr == "1") {
-      handleTestRequest(msg);
-    } else if (msgTypeStr == "2") {
-      handleResendRequest(msg);
-    } else if (msgTypeStr == "W") {
-      onMarketDataMessage(msg);
-    } else if (msgTypeStr == "8") {
-      onExecutionReport(msg);
-    } else if (msgTypeStr == "9") {
-      onOrderCancelReject(msg);
-    }
+  // Silence past the interval earns a TestRequest; a second interval
+  // without an answer ends the connection
+  auto sinceReceived = now - m_lastMessageReceived;
+  if (sinceReceived >= 2 * interval) {
+    setSessionStatus("Heartbeat timeout");
+    disconnectFromExchange();
+  } else if (sinceReceived >= interval + interval / 5 &&
+             !m_testRequestPending) {
+    sendTestRequest();
+    m_testRequestPending = true;
   }
 }
 
-bool FixConnector::validateMessage(const hffix::message_reader& msg) {
-  // Basic validation - check sequence number
-  hffix::field seqNum;
-  if (msg.find_with_hint(hffix::tag::MsgSeqNum, seqNum)) {
-    int receivedSeqNum;
-    if (hffix::extract_int(seqNum, receivedSeqNum)) {
-      if (receivedSeqNum == m_expectedSeqNum.load()) {
-        m_expectedSeqNum.fetch_add(1);
-        return true;
-      } else {
-        // Sequence number mismatch - send resend request
-        // For simplicity, we'll just log this for now
-        std::cerr << "Sequence number mismatch. Expected: "
-                  << m_expectedSeqNum.load() << ", Received: " << receivedSeqNum
-                  << std::endl;
-      }
-    }
-  }
-  return false;
-}
+// ============================================================================
+// Session messages
+// ============================================================================
 
 void FixConnector::sendLogon() {
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
-
-  msg.push_back_header("A"); // Logon
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
-
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
-
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
-
-  msg.push_back_int(hffix::tag::HeartBtInt, m_config.heartbeatInterval);
-  msg.push_back_string(hffix::tag::ResetSeqNumFlag,
-                       m_config.resetSeqNumsOnLogon.c_str());
-
-  // Add authentication if credentials are provided
-  if (m_credentials) {
-    auto apiKey = m_credentials->getApiKey("default");
-    if (apiKey && !apiKey->empty()) {
-      msg.push_back_string(hffix::tag::Username, apiKey->c_str());
-      auto apiSecret = m_credentials->getApiSecret("default");
-      if (apiSecret && !apiSecret->empty()) {
-        msg.push_back_string(hffix::tag::Password, apiSecret->c_str());
-      }
-    }
+  bool reset = m_config.resetSeqNumsOnLogon == "Y";
+  if (reset) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_sequenceStore.reset();
+    m_messageStore.reset();
   }
 
-  msg.push_back_trailer();
-
-  std::string message = std::string(msg.message_begin(), msg.message_end());
-  send(m_socket, message.c_str(), message.length(), 0);
+  sendMessage("A", [&](FixMessageBuilder& msg) {
+    msg.field(tag::EncryptMethod, '0')
+        .field(tag::HeartBtInt,
+               static_cast<int64_t>(m_config.heartbeatInterval));
+    if (reset) {
+      msg.field(tag::ResetSeqNumFlag, 'Y');
+    }
 
-  m_lastHeartbeatSent = std::chrono::steady_clock::now();
+    // Add authentication if credentials are provided
+    if (m_credentials) {
+      auto apiKey = m_credentials->getApiKey("default");
+      if (apiKey && !apiKey->empty()) {
+        msg.field(tag::Username, *apiKey);
+        auto apiSecret = m_credentials->getApiSecret("default");
+        if (apiSecret && !apiSecret->empty()) {
+          msg.field(tag::Password, *apiSecret);
+        }
+      }
+    }
+  });
 }
 
-void FixConnector::sendLogout() {
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
+void FixConnector::sendLogout() { sendMessage("5", {}); }
 
-  msg.push_back_header("5"); // Logout
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
+void FixConnector::sendHeartbeat(std::string_view testReqId) {
+  sendMessage("0", [&](FixMessageBuilder& msg) {
+    if (!testReqId.empty()) {
+      msg.field(tag::TestReqID, testReqId);
+    }
+  });
+}
 
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
+void FixConnector::sendTestRequest() {
+  sendMessage("1", [](FixMessageBuilder& msg) {
+    msg.field(tag::TestReqID,
+              static_cast<int64_t>(utils::TimeUtils::getWallClockNanos()));
+  });
+}
 
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
+void FixConnector::sendResendRequest(uint64_t beginSeqNo) {
+  sendMessage("2", [&](FixMessageBuilder& msg) {
+    msg.field(tag::BeginSeqNo, static_cast<int64_t>(beginSeqNo))
+        .field(tag::EndSeqNo, static_cast<int64_t>(0)); // Through the latest
+  });
+}
 
-  msg.push_back_trailer();
+void FixConnector::processMessage(std::string_view rawMessage) {
+  if (!m_view.parse(rawMessage)) {
+    m_malformedMessages.fetch_add(1);
+    return;
+  }
+  m_messagesReceived.fetch_add(1);
 
-  std::string message = std::string(msg.message_begin(), msg.message_end());
-  send(m_socket, message.c_str(), message.length(), 0);
-}
+  std::string_view msgType = m_view.msgType();
 
-void FixConnector::sendHeartbeat() {
-  char buffer[512];
-  hffix::message_writer msg(buffer, sizeof(buffer));
+  // SequenceReset moves the expected number itself
+  if (msgType == "4") {
+    handleSequenceReset(m_view);
+    return;
+  }
+  if (msgType == "A") {
+    handleLogon(m_view);
+    return;
+  }
+  if (!validateSequence(m_view)) {
+    return;
+  }
 
-  msg.push_back_header("0"); // Heartbeat
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
+  if (msgType == "5") {
+    handleLogout(m_view);
+  } else if (msgType == "0") {
+    // Heartbeat: receipt time is already recorded
+  } else if (msgType == "1") {
+    sendHeartbeat(m_view.get(tag::TestReqID));
+  } else if (msgType == "2") {
+    handleResendRequest(m_view);
+  } else if (msgType == "W" || msgType == "X") {
+    onMarketDataMessage(m_view);
+  } else if (msgType == "8") {
+    onExecutionReport(m_view);
+  } else if (msgType == "9") {
+    onOrderCancelReject(m_view);
+  } else if (msgType == "3") {
+    std::cerr << "FIX: session reject of message "
+              << m_view.get(tag::RefSeqNum) << ": " << m_view.get(tag::Text)
+              << std::endl;
+  }
+}
 
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
+bool FixConnector::validateSequence(const FixMessageView& msg) {
+  uint64_t received = static_cast<uint64_t>(msg.getInt(tag::MsgSeqNum, 0));
+  uint64_t expected = m_sequenceStore.nextTargetSeqNum();
 
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
+  if (received == expected) {
+    m_sequenceStore.setNextTargetSeqNum(expected + 1);
+    return true;
+  }
 
-  msg.push_back_trailer();
+  if (received > expected) {
+    // Ask for the missing range and carry on; the resent messages come
+    // back flagged as possible duplicates
+    m_sequenceGaps.fetch_add(1);
+    sendResendRequest(expected);
+    m_sequenceStore.setNextTargetSeqNum(received + 1);
+    return true;
+  }
 
-  std::string message = std::string(msg.message_begin(), msg.message_end());
-  send(m_socket, message.c_str(), message.length(), 0);
+  if (msg.getChar(tag::PossDupFlag) == 'Y') {
+    return true; // Resent message filling an earlier gap
+  }
 
-  m_lastHeartbeatSent = std::chrono::steady_clock::now();
+  // A number already seen without PossDupFlag means the counterparty lost
+  // its sequence state; the session cannot continue
+  std::cerr << "FIX: MsgSeqNum too low. Expected: " << expected
+            << ", Received: " << received << std::endl;
+  setSessionStatus("MsgSeqNum too low");
+  sendMessage("5", [](FixMessageBuilder& logout) {
+    logout.field(tag::Text, "MsgSeqNum too low");
+  });
+  disconnectFromExchange();
+  return false;
 }
 
-void FixConnector::sendTestRequest() {
-  // Implementation for test request
-}
+void FixConnector::handleLogon(const FixMessageView& msg) {
+  uint64_t received = static_cast<uint64_t>(msg.getInt(tag::MsgSeqNum, 0));
+  if (msg.getChar(tag::ResetSeqNumFlag) == 'Y' ||
+      m_config.resetSeqNumsOnLogon == "Y") {
+    m_sequenceStore.setNextTargetSeqNum(received + 1);
+  } else if (!validateSequence(msg)) {
+    return;
+  }
 
-void FixConnector::handleLogon(const hffix::message_reader& msg) {
   m_isLoggedOn.store(true);
-  {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus = "Logged on successfully";
-  }
+  setSessionStatus("Logged on successfully");
   onLogon();
-}
 
-void FixConnector::handleLogout(const hffix::message_reader& msg) {
-  m_isLoggedOn.store(false);
+  std::vector<std::string> symbols;
   {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    m_sessionStatus = "Logged out";
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    for (const auto& [symbol, callbacks] : m_marketUpdateCallbacks) {
+      symbols.push_back(symbol);
+    }
+    for (const auto& [symbol, callbacks] : m_orderBookUpdateCallbacks) {
+      if (!m_marketUpdateCallbacks.count(symbol)) {
+        symbols.push_back(symbol);
+      }
+    }
+  }
+  for (const auto& symbol : symbols) {
+    sendMarketDataRequest(symbol, '1');
   }
-  onLogout();
 }
 
-void FixConnector::handleHeartbeat(const hffix::message_reader& msg) {
-  // Heartbeat received, update last message time
-  m_lastMessageReceived = std::chrono::steady_clock::now();
+void FixConnector::handleLogout(const FixMessageView& /*msg*/) {
+  setSessionStatus("Logged out");
+  disconnectFromExchange();
+}
+
+void FixConnector::handleResendRequest(const FixMessageView& msg) {
+  uint64_t begin =
+      static_cast<uint64_t>(std::max<int64_t>(msg.getInt(tag::BeginSeqNo), 1));
+  uint64_t end = static_cast<uint64_t>(msg.getInt(tag::EndSeqNo, 0));
+
+  // New messages wait until the range has been replayed, so they follow it
+  // on the wire
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  uint64_t last = m_sequenceStore.nextSenderSeqNum() - 1;
+  if (end == 0 || end > last) {
+    end = last;
+  }
+
+  uint64_t now = utils::TimeUtils::getWallClockNanos();
+  uint64_t maxAge = static_cast<uint64_t>(m_config.resendMaxAgeMs) * 1'000'000;
+  uint64_t gapStart = 0;
+  for (uint64_t seqNum = begin; seqNum <= end; ++seqNum) {
+    // Session messages, stale orders and anything no longer stored are
+    // skipped together by one SequenceReset-GapFill
+    FixMessageStore::StoredMessage stored{};
+    bool resend = m_messageStore.lookup(seqNum, stored) && !stored.isAdmin &&
+                  now - std::min(now, stored.sendingTime) <= maxAge &&
+                  writePossDupResend(stored.message, now, m_resendBuffer);
+    if (!resend) {
+      gapStart = gapStart ? gapStart : seqNum;
+      continue;
+    }
+
+    if (gapStart) {
+      sendGapFill(gapStart, seqNum, now);
+      gapStart = 0;
+    }
+    if (writeToSocket(m_resendBuffer)) {
+      m_messagesResent.fetch_add(1);
+    }
+  }
+  if (gapStart) {
+    sendGapFill(gapStart, end + 1, now);
+  }
 }
 
-void FixConnector::handleTestRequest(const hffix::message_reader& msg) {
-  // Send heartbeat in response to test request
-  sendHeartbeat();
+void FixConnector::sendGapFill(uint64_t seqNum, uint64_t newSeqNo,
+                               uint64_t sendingTime) {
+  // Takes the number of the first message skipped, not a new one
+  m_builder.begin("4", m_config.senderCompId, m_config.targetCompId, seqNum,
+                  sendingTime)
+      .field(tag::PossDupFlag, 'Y')
+      .timestampField(tag::OrigSendingTime, sendingTime)
+      .field(tag::GapFillFlag, 'Y')
+      .field(tag::NewSeqNo, static_cast<int64_t>(newSeqNo));
+  writeToSocket(m_builder.finish());
 }
 
-void FixConnector::handleResendRequest(const hffix::message_reader& msg) {
-  // For simplicity, we'll just ignore resend requests for now
-  // In a production system, I'd need to store and resend messages
+void FixConnector::handleSequenceReset(const FixMessageView& msg) {
+  uint64_t newSeqNo = static_cast<uint64_t>(msg.getInt(tag::NewSeqNo, 0));
+  if (newSeqNo > m_sequenceStore.nextTargetSeqNum() ||
+      msg.getChar(tag::GapFillFlag) != 'Y') {
+    m_sequenceStore.setNextTargetSeqNum(newSeqNo);
+  }
 }
 
 } // namespace fix
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "../../core/orderbook/Order.h"
-#include "../../core/utils/LockFreeQueue.h"
+#include "../../core/utils/SocketTuning.h"
 #include "../connector/SecureConfig.h"
 #include "../simulator/MarketDataFeed.h"
-#include "hffix.hpp"
+#include "FixMessageStore.h"
+#include "FixSequenceStore.h"
+#include "FixStreamReader.h"
+#include "FixTemplate.h"
+#include "FixWire.h"
 
 #include <atomic>
 #include <chrono>
@@ -12,8 +16,10 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace pinnacle {
 namespace exchange {
@@ -25,6 +31,20 @@ namespace fix {
  *
  * Provides common FIX protocol functionality for connecting to exchanges
  * that support FIX protocol for market data and order execution.
+ *
+ * Orders are encoded from preallocated templates (see FixTemplate) and
+ * written to the socket on the calling thread, so sending an order does not
+ * allocate or wait for another thread. One network thread receives into a
+ * FixStreamReader and dispatches each message as a FixMessageView over the
+ * receive buffer, without copying it. Sequence numbers live in a
+ * FixSequenceStore, persisted to a file when sequenceStorePath is set so
+ * that a session with resetSeqNumsOnLogon "N" resumes where it stopped.
+ *
+ * Every message is put in a FixMessageStore before it is written, and a
+ * ResendRequest is answered from there: recent application messages are
+ * resent as possible duplicates and everything else is gap filled. A
+ * number found in the message store but not in the sequence store, left
+ * by a crash between the two, is never reused.
  */
 class FixConnector : public MarketDataFeed {
 public:
@@ -41,6 +61,23 @@ public:
     int heartbeatInterval{30};
     int logonTimeout{30};
     std::string resetSeqNumsOnLogon{"Y"};
+
+    // Sequence numbers are kept in memory only when empty
+    std::string sequenceStorePath;
+
+    // Sent messages are kept in memory only when empty
+    std::string messageStorePath;
+    size_t messageStoreCapacity{FixMessageStore::DEFAULT_CAPACITY};
+
+    // Orders and cancels older than this are gap filled, not resent
+    int resendMaxAgeMs{10000};
+
+    // Fixed decimals of the Price and OrderQty template slots
+    int priceDecimals{8};
+    int quantityDecimals{8};
+
+    // Order entry socket options; kernel timestamps stamp market data
+    utils::SocketTuningConfig socketTuning;
   };
 
   /**
@@ -84,47 +121,82 @@ public:
   virtual bool replaceOrder(const std::string& orderId,
                             const pinnacle::Order& newOrder) = 0;
 
+  /**
+   * @brief Build the order templates of a symbol ahead of its first order,
+   * which otherwise pays for building them
+   */
+  void prepareOrderTemplates(const std::string& symbol);
+
   /**
    * @brief Get connection status
    */
   bool isLoggedOn() const { return m_isLoggedOn.load(); }
   std::string getSessionStatus() const;
 
+  uint64_t getNextSenderSeqNum() const {
+    return m_sequenceStore.nextSenderSeqNum();
+  }
+  uint64_t getNextTargetSeqNum() const {
+    return m_sequenceStore.nextTargetSeqNum();
+  }
+
+  uint64_t getMessagesSent() const { return m_messagesSent.load(); }
+  uint64_t getMessagesReceived() const { return m_messagesReceived.load(); }
+  uint64_t getSequenceGaps() const { return m_sequenceGaps.load(); }
+  uint64_t getMessagesResent() const { return m_messagesResent.load(); }
+  uint64_t getMalformedMessages() const {
+    return m_malformedMessages.load();
+  }
+
 protected:
   /**
    * @brief Exchange-specific methods to be implemented by derived classes
+   *
+   * Handlers run on the network thread; the view is only valid during the
+   * call.
    */
   virtual void onLogon() = 0;
   virtual void onLogout() = 0;
-  virtual void onMarketDataMessage(const hffix::message_reader& msg) = 0;
-  virtual void onExecutionReport(const hffix::message_reader& msg) = 0;
-  virtual void onOrderCancelReject(const hffix::message_reader& msg) = 0;
+  virtual void onMarketDataMessage(const FixMessageView& msg) = 0;
+  virtual void onExecutionReport(const FixMessageView& msg) = 0;
+  virtual void onOrderCancelReject(const FixMessageView& msg) = 0;
 
   /**
-   * @brief Send FIX message
+   * @brief Request or stop market data for a symbol
+   *
+   * @param subscriptionRequestType '1' to subscribe, '2' to unsubscribe
    */
-  bool sendMessage(const hffix::message_writer& msg);
+  virtual bool sendMarketDataRequest(const std::string& symbol,
+                                     char subscriptionRequestType);
 
   /**
-   * @brief Create market data request
+   * @brief Encode an order from its template and send it
    */
-  hffix::message_writer createMarketDataRequest(const std::string& symbol,
-                                                char subscriptionRequestType);
+  bool submitNewOrderSingle(const pinnacle::Order& order);
 
   /**
-   * @brief Create new order single message
+   * @brief Cancel an order sent with submitNewOrderSingle()
    */
-  hffix::message_writer createNewOrderSingle(const pinnacle::Order& order);
+  bool submitOrderCancel(const std::string& orderId);
 
   /**
-   * @brief Create order cancel request
+   * @brief Build a message with the session header and send it
+   *
+   * @param addFields Appends the body fields to the builder
    */
-  hffix::message_writer createOrderCancelRequest(const std::string& orderId);
+  bool sendMessage(std::string_view msgType,
+                   const std::function<void(FixMessageBuilder&)>& addFields);
 
   /**
-   * @brief Get next message sequence number
+   * @brief Order id of a ClOrdID we sent, or empty if unknown
    */
-  int getNextSeqNum() { return ++m_msgSeqNum; }
+  std::string orderIdForClOrdId(std::string_view clOrdId) const;
+
+  /**
+   * @brief Kernel receive time of the data holding the message being
+   * handled, or 0 without kernel timestamps; for the network thread
+   */
+  uint64_t getKernelReceiveTime() const { return m_kernelReceiveTime; }
 
   /**
    * @brief Configuration and credentials
@@ -133,32 +205,54 @@ protected:
   std::shared_ptr<utils::ApiCredentials> m_credentials;
 
 private:
+  struct OrderTemplates {
+    // [side][market, limit, IOC, FOK]
+    std::unique_ptr<NewOrderSingleTemplate> newOrder[2][4];
+    std::unique_ptr<OrderCancelTemplate> cancel[2];
+  };
+
+  struct SentOrder {
+    uint64_t clOrdId;
+    std::string symbol;
+    pinnacle::OrderSide side;
+    double quantity;
+  };
+
   /**
    * @brief Connection management
    */
-  void connectToExchange();
+  bool connectToExchange();
   void disconnectFromExchange();
   void networkThread();
-  void processIncomingMessages();
+  bool readFromSocket();
+  bool writeToSocket(std::string_view message);
+  bool sendSequenced(uint64_t seqNum, uint64_t sendingTime,
+                     std::string_view message, bool isAdmin);
+  void checkHeartbeats();
 
   /**
    * @brief FIX protocol handlers
    */
   void sendLogon();
   void sendLogout();
-  void sendHeartbeat();
+  void sendHeartbeat(std::string_view testReqId = {});
   void sendTestRequest();
-  void handleLogon(const hffix::message_reader& msg);
-  void handleLogout(const hffix::message_reader& msg);
-  void handleHeartbeat(const hffix::message_reader& msg);
-  void handleTestRequest(const hffix::message_reader& msg);
-  void handleResendRequest(const hffix::message_reader& msg);
+  void sendResendRequest(uint64_t beginSeqNo);
+  void sendGapFill(uint64_t seqNum, uint64_t newSeqNo, uint64_t sendingTime);
+  void handleLogon(const FixMessageView& msg);
+  void handleLogout(const FixMessageView& msg);
+  void handleResendRequest(const FixMessageView& msg);
+  void handleSequenceReset(const FixMessageView& msg);
 
   /**
    * @brief Message processing
    */
-  void processMessage(const std::string& rawMessage);
-  bool validateMessage(const hffix::message_reader& msg);
+  void processMessage(std::string_view rawMessage);
+  bool validateSequence(const FixMessageView& msg);
+  void setSessionStatus(std::string status);
+
+  FixHeaderFields headerFields() const;
+  OrderTemplates& templatesFor(const std::string& symbol);
 
   /**
    * @brief Connection state
@@ -170,30 +264,50 @@ private:
   mutable std::mutex m_statusMutex;
 
   /**
-   * @brief Networking
+   * @brief Networking; writes are serialized by m_sendMutex
    */
   std::thread m_networkThread;
-  int m_socket{-1};
-  std::string m_receiveBuffer;
+  std::atomic<int> m_socket{-1};
+  FixStreamReader m_reader;
+  FixMessageView m_view;
+  uint64_t m_kernelReceiveTime{0};
   static constexpr size_t RECEIVE_BUFFER_SIZE = 65536;
 
   /**
-   * @brief Message sequence numbers
+   * @brief Sending: sequence numbers are taken and messages written under
+   * one lock, so they reach the wire in sequence order
+   */
+  std::mutex m_sendMutex;
+  FixSequenceStore m_sequenceStore;
+  FixMessageStore m_messageStore;
+  FixMessageBuilder m_builder;
+  std::string m_resendBuffer;
+  std::unordered_map<std::string, OrderTemplates> m_templates;
+  uint64_t m_nextClOrdId;
+  uint64_t m_mdReqId{0};
+
+  /**
+   * @brief Orders sent in this session, by order id and by ClOrdID
    */
-  std::atomic<int> m_msgSeqNum{1};
-  std::atomic<int> m_expectedSeqNum{1};
+  std::unordered_map<std::string, SentOrder> m_sentOrders;
+  std::unordered_map<uint64_t, std::string> m_orderIdByClOrdId;
+  mutable std::mutex m_ordersMutex;
 
   /**
-   * @brief Heartbeat management
+   * @brief Heartbeat management; the send time is set by any sending thread
    */
-  std::chrono::steady_clock::time_point m_lastHeartbeatSent;
+  std::atomic<std::chrono::steady_clock::rep> m_lastMessageSent{0};
   std::chrono::steady_clock::time_point m_lastMessageReceived;
+  bool m_testRequestPending{false};
 
   /**
-   * @brief Message queues
+   * @brief Statistics
    */
-  utils::LockFreeMPMCQueue<std::string, 1024> m_incomingMessages;
-  utils::LockFreeMPMCQueue<std::string, 1024> m_outgoingMessages;
+  std::atomic<uint64_t> m_messagesSent{0};
+  std::atomic<uint64_t> m_messagesReceived{0};
+  std::atomic<uint64_t> m_sequenceGaps{0};
+  std::atomic<uint64_t> m_messagesResent{0};
+  std::atomic<uint64_t> m_malformedMessages{0};
 
   /**
    * @brief Subscription management
@@ -205,12 +319,6 @@ private:
                      std::vector<std::function<void(const OrderBookUpdate&)>>>
       m_orderBookUpdateCallbacks;
   std::mutex m_callbacksMutex;
-
-  /**
-   * @brief Message processing thread
-   */
-  std::thread m_messageProcessingThread;
-  void messageProcessingLoop();
 };
 
 } // namespace fix
@@ -1,4 +1,6 @@
 #include "FixConnectorFactory.h"
+#include "InteractiveBrokersFixConnector.h"
+
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -12,7 +14,7 @@ FixConnectorFactory& FixConnectorFactory::getInstance() {
   return instance;
 }
 
-void* FixConnectorFactory::createConnector(
+std::shared_ptr<FixConnector> FixConnectorFactory::createConnector(
     Exchange exchange, std::shared_ptr<utils::ApiCredentials> credentials) {
 
   if (!credentials) {
@@ -22,11 +24,7 @@ void* FixConnectorFactory::createConnector(
 
   switch (exchange) {
   case Exchange::INTERACTIVE_BROKERS:
-    // return std::make_shared<InteractiveBrokersFixConnector>(credentials);
-    std::cout << "FixConnectorFactory: Interactive Brokers FIX connector ready "
-                 "(implementation pending hffix API fix)"
-              << std::endl;
-    return nullptr;
+    return std::make_shared<InteractiveBrokersFixConnector>(credentials);
 
   case Exchange::COINBASE_FIX:
     // TODO: Implement CoinbaseFixConnector
@@ -54,7 +52,7 @@ void* FixConnectorFactory::createConnector(
   }
 }
 
-void* FixConnectorFactory::getConnector(
+std::shared_ptr<FixConnector> FixConnectorFactory::getConnector(
     Exchange exchange, std::shared_ptr<utils::ApiCredentials> credentials) {
 
   if (!credentials) {
@@ -1,8 +1,7 @@
 #pragma once
 
-// #include "FixConnector.h"
-// #include "InteractiveBrokersFixConnector.h"
 #include "../connector/SecureConfig.h"
+#include "FixConnector.h"
 
 #include <memory>
 #include <mutex>
@@ -41,9 +40,9 @@ public:
    * @param credentials API credentials
    * @return Shared pointer to FIX connector
    */
-  // Placeholder for now - returning nullptr until hffix API is resolved
-  void* createConnector(Exchange exchange,
-                        std::shared_ptr<utils::ApiCredentials> credentials);
+  std::shared_ptr<FixConnector>
+  createConnector(Exchange exchange,
+                  std::shared_ptr<utils::ApiCredentials> credentials);
 
   /**
    * @brief Get existing connector or create new one
@@ -52,8 +51,9 @@ public:
    * @param credentials API credentials
    * @return Shared pointer to FIX connector
    */
-  void* getConnector(Exchange exchange,
-                     std::shared_ptr<utils::ApiCredentials> credentials);
+  std::shared_ptr<FixConnector>
+  getConnector(Exchange exchange,
+               std::shared_ptr<utils::ApiCredentials> credentials);
 
   /**
    * @brief Check if exchange supports FIX protocol
@@ -94,9 +94,9 @@ private:
   FixConnectorFactory& operator=(const FixConnectorFactory&) = delete;
 
   /**
-   * @brief Active connectors cache - placeholder
+   * @brief Active connectors cache
    */
-  std::unordered_map<std::string, void*> m_connectors;
+  std::unordered_map<std::string, std::shared_ptr<FixConnector>> m_connectors;
   std::mutex m_connectorsMutex;
 
   /**
@@ -0,0 +1,264 @@
+#include "FixMessageStore.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+namespace {
+
+constexpr char STORE_MAGIC[8] = {'P', 'M', 'M', 'F', 'I', 'X', 'M', 'S'};
+constexpr uint32_t STORE_VERSION = 1;
+constexpr size_t SESSION_ID_LENGTH = 64;
+
+enum SlotKind : uint8_t { APPLICATION = 0, ADMIN = 1 };
+
+uint64_t load(const uint64_t& value) {
+  return std::atomic_ref<const uint64_t>(value).load(
+      std::memory_order_acquire);
+}
+
+void store(uint64_t& value, uint64_t next) {
+  std::atomic_ref<uint64_t>(value).store(next, std::memory_order_release);
+}
+
+} // namespace
+
+struct alignas(64) FixMessageStore::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t slotSize;
+  uint64_t capacity;
+  uint64_t epoch; // Advanced by reset(), invalidating every slot
+  uint64_t lastSeqNum;
+  char sessionId[SESSION_ID_LENGTH]; // NUL-padded
+};
+
+struct FixMessageStore::Slot {
+  uint64_t seqNum; // 0 while empty or being written
+  uint64_t epoch;
+  uint64_t sendingTime;
+  uint16_t length;
+  uint8_t kind;
+  uint8_t reserved[5];
+  char data[SLOT_SIZE - 32];
+};
+
+FixMessageStore::~FixMessageStore() { close(); }
+
+size_t FixMessageStore::maxMessageLength() { return sizeof(Slot::data); }
+
+size_t FixMessageStore::capacity() const {
+  return m_header ? m_header->capacity : 0;
+}
+
+size_t FixMessageStore::mappedSize() const {
+  return sizeof(Header) + m_header->capacity * sizeof(Slot);
+}
+
+bool FixMessageStore::open(const std::string& path,
+                           const std::string& sessionId, size_t capacity) {
+  static_assert(sizeof(Slot) == SLOT_SIZE);
+  close();
+  if (capacity == 0) {
+    capacity = DEFAULT_CAPACITY;
+  }
+
+  char expectedId[SESSION_ID_LENGTH] = {};
+  std::strncpy(expectedId, sessionId.c_str(), SESSION_ID_LENGTH - 1);
+  size_t size = sizeof(Header) + capacity * sizeof(Slot);
+  auto initialize = [&]() {
+    std::memcpy(m_header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    m_header->version = STORE_VERSION;
+    m_header->slotSize = SLOT_SIZE;
+    m_header->capacity = capacity;
+    m_header->epoch = 1;
+    m_header->lastSeqNum = 0;
+    std::memcpy(m_header->sessionId, expectedId, SESSION_ID_LENGTH);
+  };
+
+  if (path.empty()) {
+    // Anonymous pages are zero-filled and only backed once touched
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+      spdlog::error("Cannot map FIX message store: {}", std::strerror(errno));
+      return false;
+    }
+    m_header = static_cast<Header*>(mapped);
+    initialize();
+    return true;
+  }
+
+  m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (m_fd < 0) {
+    spdlog::error("Cannot open FIX message store {}: {}", path,
+                  std::strerror(errno));
+    return false;
+  }
+
+  struct stat info {};
+  if (fstat(m_fd, &info) != 0) {
+    spdlog::error("Cannot stat FIX message store {}: {}", path,
+                  std::strerror(errno));
+    close();
+    return false;
+  }
+
+  bool created = info.st_size == 0;
+  if (created && ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+    spdlog::error("Cannot size FIX message store {}: {}", path,
+                  std::strerror(errno));
+    close();
+    return false;
+  }
+
+  Header existing{};
+  if (!created) {
+    if (static_cast<size_t>(info.st_size) < sizeof(Header) ||
+        pread(m_fd, &existing, sizeof(Header), 0) !=
+            static_cast<ssize_t>(sizeof(Header))) {
+      spdlog::error("FIX message store {} is truncated", path);
+      close();
+      return false;
+    }
+    if (std::memcmp(existing.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+        existing.version != STORE_VERSION || existing.slotSize != SLOT_SIZE) {
+      spdlog::error("{} is not a version {} FIX message store", path,
+                    STORE_VERSION);
+      close();
+      return false;
+    }
+    if (std::memcmp(existing.sessionId, expectedId, SESSION_ID_LENGTH) != 0) {
+      spdlog::error("FIX message store {} belongs to session {}", path,
+                    std::string(existing.sessionId,
+                                strnlen(existing.sessionId,
+                                        SESSION_ID_LENGTH)));
+      close();
+      return false;
+    }
+    size = sizeof(Header) + existing.capacity * sizeof(Slot);
+    if (static_cast<size_t>(info.st_size) < size) {
+      spdlog::error("FIX message store {} is truncated", path);
+      close();
+      return false;
+    }
+  }
+
+  void* mapped =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (mapped == MAP_FAILED) {
+    spdlog::error("Cannot map FIX message store {}: {}", path,
+                  std::strerror(errno));
+    close();
+    return false;
+  }
+  m_header = static_cast<Header*>(mapped);
+
+  if (created) {
+    initialize();
+  }
+
+  spdlog::info("FIX message store {}: {} slots, last sequence number {}",
+               path, m_header->capacity, lastSeqNum());
+  return true;
+}
+
+void FixMessageStore::close() {
+  if (m_header) {
+    if (m_fd >= 0) {
+      msync(m_header, mappedSize(), MS_ASYNC);
+    }
+    munmap(m_header, mappedSize());
+    m_header = nullptr;
+  }
+  if (m_fd >= 0) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+}
+
+FixMessageStore::Slot* FixMessageStore::slot(uint64_t seqNum) const {
+  auto* slots = reinterpret_cast<Slot*>(m_header + 1);
+  return &slots[seqNum % m_header->capacity];
+}
+
+void FixMessageStore::store(uint64_t seqNum, uint64_t sendingTime,
+                            std::string_view message, bool isAdmin) {
+  if (!m_header || seqNum == 0) {
+    return;
+  }
+
+  Slot* target = slot(seqNum);
+  fix::store(target->seqNum, 0);
+
+  // Too long to resend from here: stored as a session message, so the
+  // number is still known to be used and is gap filled
+  bool keepBytes = !isAdmin && message.size() <= sizeof(Slot::data);
+  if (keepBytes) {
+    std::memcpy(target->data, message.data(), message.size());
+  } else if (!isAdmin) {
+    spdlog::warn("FIX message {} is too long for the message store", seqNum);
+  }
+  target->length = static_cast<uint16_t>(keepBytes ? message.size() : 0);
+  target->kind = keepBytes ? APPLICATION : ADMIN;
+  target->sendingTime = sendingTime;
+  target->epoch = m_header->epoch;
+  fix::store(target->seqNum, seqNum);
+
+  if (seqNum > m_header->lastSeqNum) {
+    fix::store(m_header->lastSeqNum, seqNum);
+  }
+}
+
+bool FixMessageStore::lookup(uint64_t seqNum, StoredMessage& out) const {
+  if (!m_header || seqNum == 0) {
+    return false;
+  }
+
+  const Slot* found = slot(seqNum);
+  if (load(found->seqNum) != seqNum || found->epoch != m_header->epoch) {
+    return false;
+  }
+
+  out.isAdmin = found->kind == ADMIN;
+  out.sendingTime = found->sendingTime;
+  out.message = std::string_view(found->data, found->length);
+  return true;
+}
+
+uint64_t FixMessageStore::lastSeqNum() const {
+  if (!m_header) {
+    return 0;
+  }
+
+  // The slot after the recorded last may have been written just before a
+  // crash that came ahead of the header update
+  uint64_t last = load(m_header->lastSeqNum);
+  const Slot* after = slot(last + 1);
+  if (load(after->seqNum) == last + 1 && after->epoch == m_header->epoch) {
+    return last + 1;
+  }
+  return last;
+}
+
+void FixMessageStore::reset() {
+  if (!m_header) {
+    return;
+  }
+  fix::store(m_header->lastSeqNum, 0);
+  fix::store(m_header->epoch, m_header->epoch + 1);
+}
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
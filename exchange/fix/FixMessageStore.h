@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+/**
+ * @class FixMessageStore
+ * @brief Outgoing messages of a FIX session by MsgSeqNum, in a
+ * memory-mapped ring of fixed-size slots
+ *
+ * Every sequence number sent goes into slot seqNum % capacity, holding the
+ * encoded bytes of application messages and only the sequence number of
+ * session messages, which are gap filled rather than resent. A
+ * ResendRequest is then served by copying the stored bytes, without
+ * encoding the messages again. Messages longer than a slot, or overwritten
+ * by a later lap of the ring, are reported missing and gap filled.
+ *
+ * A slot is marked empty before it is written and takes its sequence
+ * number last, so a process dying mid-write leaves a missing message, not
+ * a corrupt one. Without a file the ring lives in anonymous memory and
+ * serves resends for the life of the process.
+ *
+ * Not thread-safe; FixConnector calls it under its send lock.
+ */
+class FixMessageStore {
+public:
+  static constexpr size_t SLOT_SIZE = 512;
+  static constexpr size_t DEFAULT_CAPACITY = 16384;
+
+  /**
+   * @brief A message found in the store, valid until the slot is reused
+   */
+  struct StoredMessage {
+    std::string_view message; // Empty for session messages
+    uint64_t sendingTime;     // Wall-clock nanoseconds
+    bool isAdmin;
+  };
+
+  FixMessageStore() = default;
+  ~FixMessageStore();
+
+  FixMessageStore(const FixMessageStore&) = delete;
+  FixMessageStore& operator=(const FixMessageStore&) = delete;
+
+  /**
+   * @brief Map the store file, creating it with the given capacity if
+   * missing; an existing file keeps the capacity it was created with
+   *
+   * @param path File to map, or empty for memory only
+   * @return false if the file cannot be created or mapped, or belongs to a
+   * different session
+   */
+  bool open(const std::string& path, const std::string& sessionId,
+            size_t capacity = DEFAULT_CAPACITY);
+
+  void close();
+
+  bool isOpen() const { return m_header != nullptr; }
+  bool isPersistent() const { return isOpen() && m_fd >= 0; }
+  size_t capacity() const;
+
+  /**
+   * @brief Longest application message that fits a slot
+   */
+  static size_t maxMessageLength();
+
+  /**
+   * @brief Record a message about to be sent
+   *
+   * @param isAdmin Session-level message, stored without its bytes
+   */
+  void store(uint64_t seqNum, uint64_t sendingTime, std::string_view message,
+             bool isAdmin);
+
+  /**
+   * @return false if the message was never stored, was too long or has
+   * been overwritten
+   */
+  bool lookup(uint64_t seqNum, StoredMessage& out) const;
+
+  /**
+   * @brief Highest sequence number stored since the last reset, or 0
+   *
+   * After a crash this may be ahead of the sequence store, in which case
+   * the message may have reached the counterparty and its number must not
+   * be used again.
+   */
+  uint64_t lastSeqNum() const;
+
+  /**
+   * @brief Forget every stored message, as on a logon with ResetSeqNumFlag
+   */
+  void reset();
+
+private:
+  struct Header;
+  struct Slot;
+
+  Slot* slot(uint64_t seqNum) const;
+  size_t mappedSize() const;
+
+  Header* m_header{nullptr};
+  int m_fd{-1};
+};
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,158 @@
+#include "FixSequenceStore.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+namespace {
+
+constexpr char STORE_MAGIC[8] = {'P', 'M', 'M', 'F', 'I', 'X', 'S', 'Q'};
+constexpr uint32_t STORE_VERSION = 1;
+constexpr size_t SESSION_ID_LENGTH = 64;
+
+uint64_t load(uint64_t& value) {
+  return std::atomic_ref<uint64_t>(value).load(std::memory_order_acquire);
+}
+
+void store(uint64_t& value, uint64_t next) {
+  std::atomic_ref<uint64_t>(value).store(next, std::memory_order_release);
+}
+
+} // namespace
+
+struct FixSequenceStore::File {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  char sessionId[SESSION_ID_LENGTH]; // NUL-padded
+  Counters counters;
+};
+
+FixSequenceStore::~FixSequenceStore() { close(); }
+
+bool FixSequenceStore::open(const std::string& path,
+                            const std::string& sessionId) {
+  close();
+
+  m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (m_fd < 0) {
+    spdlog::error("Cannot open FIX sequence store {}: {}", path,
+                  std::strerror(errno));
+    return false;
+  }
+
+  struct stat info {};
+  bool created = fstat(m_fd, &info) == 0 && info.st_size == 0;
+  if (created && ftruncate(m_fd, sizeof(File)) != 0) {
+    spdlog::error("Cannot size FIX sequence store {}: {}", path,
+                  std::strerror(errno));
+    close();
+    return false;
+  }
+  if (!created && static_cast<size_t>(info.st_size) < sizeof(File)) {
+    spdlog::error("FIX sequence store {} is truncated", path);
+    close();
+    return false;
+  }
+
+  void* mapped =
+      mmap(nullptr, sizeof(File), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (mapped == MAP_FAILED) {
+    spdlog::error("Cannot map FIX sequence store {}: {}", path,
+                  std::strerror(errno));
+    close();
+    return false;
+  }
+  File* file = static_cast<File*>(mapped);
+
+  char expectedId[SESSION_ID_LENGTH] = {};
+  std::strncpy(expectedId, sessionId.c_str(), SESSION_ID_LENGTH - 1);
+
+  if (created) {
+    std::memcpy(file->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    file->version = STORE_VERSION;
+    file->reserved = 0;
+    std::memcpy(file->sessionId, expectedId, SESSION_ID_LENGTH);
+    file->counters = Counters{};
+  } else if (std::memcmp(file->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+             file->version != STORE_VERSION) {
+    spdlog::error("{} is not a version {} FIX sequence store", path,
+                  STORE_VERSION);
+    munmap(mapped, sizeof(File));
+    close();
+    return false;
+  } else if (std::memcmp(file->sessionId, expectedId, SESSION_ID_LENGTH) !=
+             0) {
+    spdlog::error("FIX sequence store {} belongs to session {}", path,
+                  std::string(file->sessionId,
+                              strnlen(file->sessionId, SESSION_ID_LENGTH)));
+    munmap(mapped, sizeof(File));
+    close();
+    return false;
+  }
+
+  m_file = file;
+  spdlog::info("FIX sequence store {}: next sender {}, next target {}", path,
+               nextSenderSeqNum(), nextTargetSeqNum());
+  return true;
+}
+
+void FixSequenceStore::close() {
+  if (m_file) {
+    // Later numbers continue in memory from where the file left off
+    m_memory = m_file->counters;
+    munmap(m_file, sizeof(File));
+    m_file = nullptr;
+  }
+  if (m_fd >= 0) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+}
+
+FixSequenceStore::Counters& FixSequenceStore::counters() const {
+  return m_file ? m_file->counters : m_memory;
+}
+
+uint64_t FixSequenceStore::nextSenderSeqNum() const {
+  return load(counters().nextSender);
+}
+
+uint64_t FixSequenceStore::nextTargetSeqNum() const {
+  return load(counters().nextTarget);
+}
+
+uint64_t FixSequenceStore::takeSenderSeqNum() {
+  // Only the sending thread advances it, so load and store suffice
+  uint64_t& next = counters().nextSender;
+  uint64_t seqNum = load(next);
+  store(next, seqNum + 1);
+  return seqNum;
+}
+
+void FixSequenceStore::setNextSenderSeqNum(uint64_t seqNum) {
+  store(counters().nextSender, seqNum);
+}
+
+void FixSequenceStore::setNextTargetSeqNum(uint64_t seqNum) {
+  store(counters().nextTarget, seqNum);
+}
+
+void FixSequenceStore::reset() {
+  setNextSenderSeqNum(1);
+  setNextTargetSeqNum(1);
+}
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
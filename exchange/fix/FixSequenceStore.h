@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+/**
+ * @class FixSequenceStore
+ * @brief Next outgoing and expected incoming MsgSeqNum of a FIX session,
+ * kept in a memory-mapped file so they survive a restart
+ *
+ * Taking a sequence number is a store into the mapping, with no system
+ * call on the send path; the kernel writes the page back, so the numbers
+ * survive the process dying but not the machine losing power. Without a
+ * file the store works the same in memory only.
+ *
+ * One thread takes outgoing numbers and one thread advances the incoming
+ * one; each value is read and written atomically.
+ */
+class FixSequenceStore {
+public:
+  FixSequenceStore() = default;
+  ~FixSequenceStore();
+
+  FixSequenceStore(const FixSequenceStore&) = delete;
+  FixSequenceStore& operator=(const FixSequenceStore&) = delete;
+
+  /**
+   * @brief Map the store file, creating it starting from 1 if missing
+   *
+   * @return false if the file cannot be created or mapped, or belongs to a
+   * different session
+   */
+  bool open(const std::string& path, const std::string& sessionId);
+
+  void close();
+
+  bool isPersistent() const { return m_file != nullptr; }
+
+  uint64_t nextSenderSeqNum() const;
+  uint64_t nextTargetSeqNum() const;
+
+  /**
+   * @brief Return the next outgoing sequence number and advance it
+   */
+  uint64_t takeSenderSeqNum();
+
+  void setNextSenderSeqNum(uint64_t seqNum);
+  void setNextTargetSeqNum(uint64_t seqNum);
+
+  /**
+   * @brief Start both directions again from 1, as on a logon with
+   * ResetSeqNumFlag
+   */
+  void reset();
+
+private:
+  struct Counters {
+    uint64_t nextSender{1};
+    uint64_t nextTarget{1};
+  };
+
+  struct File;
+
+  Counters& counters() const;
+
+  mutable Counters m_memory;
+  File* m_file{nullptr};
+  int m_fd{-1};
+};
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
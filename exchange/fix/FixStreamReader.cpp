@@ -0,0 +1,81 @@
+#include "FixStreamReader.h"
+#include "FixWire.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+namespace {
+
+constexpr std::string_view MESSAGE_START = "8=FIX";
+
+// Bytes to drop before the next possible message start, keeping a tail that
+// may be the beginning of one still being received
+size_t garbageLength(std::string_view pending) {
+  size_t start = pending.find(MESSAGE_START, 1);
+  if (start != std::string_view::npos) {
+    return start;
+  }
+  for (size_t keep = std::min(pending.size() - 1, MESSAGE_START.size() - 1);
+       keep > 0; --keep) {
+    if (pending.ends_with(MESSAGE_START.substr(0, keep))) {
+      return pending.size() - keep;
+    }
+  }
+  return pending.size();
+}
+
+} // namespace
+
+FixStreamReader::FixStreamReader(size_t capacity)
+    : m_buffer(capacity < 256 ? 256 : capacity) {}
+
+std::span<char> FixStreamReader::writable() {
+  if (m_begin == m_end) {
+    m_begin = m_end = 0;
+  } else if (m_begin > 0 && m_buffer.size() - m_end < m_buffer.size() / 4) {
+    // Wrap, carrying the partial message along
+    std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+    m_end -= m_begin;
+    m_begin = 0;
+    ++m_compactions;
+  }
+  return std::span<char>(m_buffer.data() + m_end, m_buffer.size() - m_end);
+}
+
+void FixStreamReader::commit(size_t bytes) {
+  m_end += bytes < m_buffer.size() - m_end ? bytes : m_buffer.size() - m_end;
+}
+
+bool FixStreamReader::next(std::string_view& message) {
+  while (m_begin < m_end) {
+    std::string_view pending(m_buffer.data() + m_begin, m_end - m_begin);
+
+    if (!pending.starts_with(MESSAGE_START.substr(
+            0, std::min(pending.size(), MESSAGE_START.size())))) {
+      size_t skip = garbageLength(pending);
+      m_bytesSkipped += skip;
+      m_begin += skip;
+      continue;
+    }
+
+    size_t length = fixFrameLength(pending);
+    if (length == 0) {
+      return false;
+    }
+    message = pending.substr(0, length);
+    m_begin += length;
+    ++m_messagesRead;
+    return true;
+  }
+  return false;
+}
+
+void FixStreamReader::clear() { m_begin = m_end = 0; }
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
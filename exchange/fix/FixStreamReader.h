@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+/**
+ * @class FixStreamReader
+ * @brief Splits a TCP byte stream into FIX messages without copying them
+ *
+ * The socket reads straight into writable() and next() hands out complete
+ * messages as views into the same buffer, so a message is never copied
+ * between the kernel and its parser. The buffer works as a ring: consumed
+ * bytes free the front, and when the tail runs low the partial message left
+ * over is moved back to the start. That is the only copy, at most one
+ * message per wrap.
+ *
+ * Views returned by next() stay valid until the next call to writable().
+ * Bytes that cannot start a message are skipped up to the next "8=FIX".
+ */
+class FixStreamReader {
+public:
+  /**
+   * @param capacity Buffer size; must exceed the largest expected message
+   */
+  explicit FixStreamReader(size_t capacity = 65536);
+
+  /**
+   * @brief Free space at the tail to receive into
+   *
+   * @return Empty if a single message fills the whole buffer
+   */
+  std::span<char> writable();
+
+  /**
+   * @brief Mark bytes written into writable() as received
+   */
+  void commit(size_t bytes);
+
+  /**
+   * @brief Take the next complete message
+   *
+   * @return false if no complete message is buffered
+   */
+  bool next(std::string_view& message);
+
+  /**
+   * @brief Drop everything buffered, e.g. after a reconnect
+   */
+  void clear();
+
+  size_t buffered() const { return m_end - m_begin; }
+  size_t capacity() const { return m_buffer.size(); }
+
+  uint64_t getMessagesRead() const { return m_messagesRead; }
+  uint64_t getBytesSkipped() const { return m_bytesSkipped; }
+  uint64_t getCompactions() const { return m_compactions; }
+
+private:
+  std::vector<char> m_buffer;
+  size_t m_begin{0};
+  size_t m_end{0};
+
+  uint64_t m_messagesRead{0};
+  uint64_t m_bytesSkipped{0};
+  uint64_t m_compactions{0};
+};
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
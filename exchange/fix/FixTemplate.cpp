@@ -0,0 +1,281 @@
+#include "FixTemplate.h"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+namespace {
+
+constexpr uint64_t POW10[] = {1ULL,
+                              10ULL,
+                              100ULL,
+                              1000ULL,
+                              10000ULL,
+                              100000ULL,
+                              1000000ULL,
+                              10000000ULL,
+                              100000000ULL,
+                              1000000000ULL,
+                              10000000000ULL,
+                              100000000000ULL,
+                              1000000000000ULL,
+                              10000000000000ULL,
+                              100000000000000ULL,
+                              1000000000000000ULL,
+                              10000000000000000ULL,
+                              100000000000000000ULL,
+                              1000000000000000000ULL,
+                              10000000000000000000ULL};
+
+constexpr size_t MAX_DIGITS = 19;
+
+} // namespace
+
+// ============================================================================
+// FixTemplate Implementation
+// ============================================================================
+
+FixTemplate::FixTemplate(const FixHeaderFields& header,
+                         std::string_view msgType)
+    : m_beginString(header.beginString) {
+  m_body.reserve(256);
+  field(tag::MsgType, msgType);
+  field(tag::SenderCompID, header.senderCompId);
+  field(tag::TargetCompID, header.targetCompId);
+  m_seqNum = numberSlot(tag::MsgSeqNum, SEQ_NUM_WIDTH);
+  m_sendingTime = timestampSlot(tag::SendingTime);
+}
+
+void FixTemplate::appendTag(int tag) {
+  if (m_sealed) {
+    throw std::logic_error("FixTemplate: field added after seal()");
+  }
+  char buffer[16];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), tag);
+  m_body.append(buffer, ptr);
+  m_body.push_back('=');
+}
+
+FixTemplate& FixTemplate::field(int tag, std::string_view value) {
+  appendTag(tag);
+  m_body.append(value);
+  m_body.push_back(SOH);
+  return *this;
+}
+
+FixTemplate& FixTemplate::field(int tag, char value) {
+  appendTag(tag);
+  m_body.push_back(value);
+  m_body.push_back(SOH);
+  return *this;
+}
+
+FixTemplate::Slot FixTemplate::addSlot(int tag, size_t width, int decimals) {
+  appendTag(tag);
+  m_slots.push_back(SlotInfo{m_body.size(), width, decimals});
+  m_body.append(width, '0');
+  if (decimals > 0) {
+    m_body[m_body.size() - decimals - 1] = '.';
+  }
+  m_body.push_back(SOH);
+  return static_cast<Slot>(m_slots.size() - 1);
+}
+
+FixTemplate::Slot FixTemplate::numberSlot(int tag, size_t width) {
+  if (width == 0 || width > MAX_DIGITS) {
+    throw std::invalid_argument("FixTemplate: unsupported number width");
+  }
+  return addSlot(tag, width, 0);
+}
+
+FixTemplate::Slot FixTemplate::decimalSlot(int tag, size_t width,
+                                           int decimals) {
+  if (decimals <= 0 || static_cast<size_t>(decimals) + 2 > width ||
+      width - 1 > MAX_DIGITS) {
+    throw std::invalid_argument("FixTemplate: unsupported decimal layout");
+  }
+  return addSlot(tag, width, decimals);
+}
+
+FixTemplate::Slot FixTemplate::timestampSlot(int tag) {
+  return addSlot(tag, FIX_TIMESTAMP_LENGTH, 0);
+}
+
+void FixTemplate::seal() {
+  if (m_sealed) {
+    return;
+  }
+
+  m_buffer.reserve(m_beginString.size() + m_body.size() + 24);
+  m_buffer.append("8=");
+  m_buffer.append(m_beginString);
+  m_buffer.push_back(SOH);
+  m_buffer.append("9=");
+  char buffer[16];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                 m_body.size());
+  m_buffer.append(buffer, ptr);
+  m_buffer.push_back(SOH);
+
+  size_t headerLength = m_buffer.size();
+  for (auto& slot : m_slots) {
+    slot.offset += headerLength;
+  }
+  m_buffer.append(m_body);
+
+  m_sum = 0;
+  for (char c : m_buffer) {
+    m_sum += static_cast<unsigned char>(c);
+  }
+
+  m_buffer.append("10=");
+  m_checksumOffset = m_buffer.size();
+  m_buffer.append("000");
+  m_buffer.push_back(SOH);
+
+  m_body.clear();
+  m_body.shrink_to_fit();
+  m_sealed = true;
+}
+
+void FixTemplate::patch(const SlotInfo& slot, const char* bytes) {
+  char* out = m_buffer.data() + slot.offset;
+  for (size_t i = 0; i < slot.width; ++i) {
+    m_sum += static_cast<unsigned char>(bytes[i]);
+    m_sum -= static_cast<unsigned char>(out[i]);
+    out[i] = bytes[i];
+  }
+}
+
+bool FixTemplate::setNumber(Slot slot, uint64_t value) {
+  const SlotInfo& info = m_slots[slot];
+  if (info.width < MAX_DIGITS && value >= POW10[info.width]) {
+    return false;
+  }
+  char digits[MAX_DIGITS];
+  writeFixDigits(digits, info.width, value);
+  patch(info, digits);
+  return true;
+}
+
+bool FixTemplate::setDecimal(Slot slot, double value) {
+  const SlotInfo& info = m_slots[slot];
+  if (!(value >= 0.0)) {
+    return false; // Negative or NaN
+  }
+
+  size_t integerWidth = info.width - info.decimals - 1;
+  uint64_t scale = POW10[info.decimals];
+  double scaled = std::nearbyint(value * static_cast<double>(scale));
+  if (!(scaled < static_cast<double>(POW10[integerWidth]) *
+                     static_cast<double>(scale))) {
+    return false; // Too large for the slot, or infinite
+  }
+
+  auto units = static_cast<uint64_t>(scaled);
+  char digits[MAX_DIGITS + 1];
+  writeFixDigits(digits, integerWidth, units / scale);
+  digits[integerWidth] = '.';
+  writeFixDigits(digits + integerWidth + 1, info.decimals, units % scale);
+  patch(info, digits);
+  return true;
+}
+
+void FixTemplate::setTimestamp(Slot slot, uint64_t wallClockNanos) {
+  uint64_t second = wallClockNanos / 1000000000ULL;
+  if (second != m_cachedSecond) {
+    writeFixTimestamp(m_cachedTimestamp, wallClockNanos);
+    m_cachedSecond = second;
+  } else {
+    // "YYYYMMDD-HH:MM:SS." is unchanged; only the microseconds move
+    writeFixDigits(m_cachedTimestamp + FIX_TIMESTAMP_LENGTH - 6, 6,
+                   wallClockNanos / 1000 % 1000000);
+  }
+  patch(m_slots[slot], m_cachedTimestamp);
+}
+
+std::string_view FixTemplate::finish() {
+  if (!m_sealed) {
+    seal();
+  }
+  writeFixDigits(m_buffer.data() + m_checksumOffset, 3, m_sum & 0xFF);
+  return m_buffer;
+}
+
+// ============================================================================
+// Order templates
+// ============================================================================
+
+NewOrderSingleTemplate::NewOrderSingleTemplate(const FixHeaderFields& header,
+                                               std::string_view symbol,
+                                               char side, char ordType,
+                                               char timeInForce,
+                                               int priceDecimals,
+                                               int quantityDecimals)
+    : m_message(header, "D"), m_hasPrice(ordType != '1') {
+  m_clOrdId = m_message.numberSlot(tag::ClOrdID, CL_ORD_ID_WIDTH);
+  m_message.field(tag::Symbol, symbol).field(tag::Side, side);
+  m_transactTime = m_message.timestampSlot(tag::TransactTime);
+  m_orderQty = m_message.decimalSlot(tag::OrderQty, 10 + quantityDecimals,
+                                     quantityDecimals);
+  m_message.field(tag::OrdType, ordType);
+  m_price = m_hasPrice ? m_message.decimalSlot(tag::Price, 10 + priceDecimals,
+                                               priceDecimals)
+                       : 0;
+  m_message.field(tag::TimeInForce, timeInForce);
+  m_message.seal();
+}
+
+std::string_view NewOrderSingleTemplate::encode(uint64_t seqNum,
+                                                uint64_t wallClockNanos,
+                                                uint64_t clOrdId, double price,
+                                                double quantity) {
+  if (!m_message.setNumber(m_clOrdId, clOrdId) ||
+      !m_message.setDecimal(m_orderQty, quantity) ||
+      (m_hasPrice && !m_message.setDecimal(m_price, price))) {
+    return {};
+  }
+  m_message.setSeqNum(seqNum);
+  m_message.setSendingTime(wallClockNanos);
+  m_message.setTimestamp(m_transactTime, wallClockNanos);
+  return m_message.finish();
+}
+
+OrderCancelTemplate::OrderCancelTemplate(const FixHeaderFields& header,
+                                         std::string_view symbol, char side,
+                                         int quantityDecimals)
+    : m_message(header, "F") {
+  m_origClOrdId = m_message.numberSlot(
+      tag::OrigClOrdID, NewOrderSingleTemplate::CL_ORD_ID_WIDTH);
+  m_clOrdId = m_message.numberSlot(tag::ClOrdID,
+                                   NewOrderSingleTemplate::CL_ORD_ID_WIDTH);
+  m_message.field(tag::Symbol, symbol).field(tag::Side, side);
+  m_transactTime = m_message.timestampSlot(tag::TransactTime);
+  m_orderQty = m_message.decimalSlot(tag::OrderQty, 10 + quantityDecimals,
+                                     quantityDecimals);
+  m_message.seal();
+}
+
+std::string_view OrderCancelTemplate::encode(uint64_t seqNum,
+                                             uint64_t wallClockNanos,
+                                             uint64_t clOrdId,
+                                             uint64_t origClOrdId,
+                                             double quantity) {
+  if (!m_message.setNumber(m_clOrdId, clOrdId) ||
+      !m_message.setNumber(m_origClOrdId, origClOrdId) ||
+      !m_message.setDecimal(m_orderQty, quantity)) {
+    return {};
+  }
+  m_message.setSeqNum(seqNum);
+  m_message.setSendingTime(wallClockNanos);
+  m_message.setTimestamp(m_transactTime, wallClockNanos);
+  return m_message.finish();
+}
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "FixWire.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+/**
+ * @brief Session identity stamped into every template's header
+ */
+struct FixHeaderFields {
+  std::string_view beginString{"FIX.4.4"};
+  std::string_view senderCompId;
+  std::string_view targetCompId;
+};
+
+/**
+ * @class FixTemplate
+ * @brief Preassembled FIX message whose variable fields are patched in place
+ *
+ * Every field is laid out once when the template is built. Variable fields
+ * are reserved as slots of a fixed width (numbers zero-padded on the left),
+ * so BodyLength never changes and sending a message is a handful of digit
+ * writes into a buffer that is already in wire format. The checksum is kept
+ * as a running byte sum that every patch adjusts, so finish() only writes
+ * the three trailer digits.
+ *
+ * Build with field() and the slot functions, then seal(); only the set
+ * functions and finish() may be called after that.
+ */
+class FixTemplate {
+public:
+  using Slot = uint32_t;
+
+  static constexpr size_t SEQ_NUM_WIDTH = 9;
+
+  /**
+   * @brief Start a template with the standard header; MsgSeqNum and
+   * SendingTime are slots
+   */
+  FixTemplate(const FixHeaderFields& header, std::string_view msgType);
+
+  FixTemplate& field(int tag, std::string_view value);
+  FixTemplate& field(int tag, char value);
+
+  /**
+   * @brief Reserve a non-negative integer field of a fixed width
+   */
+  Slot numberSlot(int tag, size_t width);
+
+  /**
+   * @brief Reserve a decimal field with a fixed number of decimals; the
+   * width includes the point
+   */
+  Slot decimalSlot(int tag, size_t width, int decimals);
+
+  /**
+   * @brief Reserve a UTCTimestamp field with microseconds
+   */
+  Slot timestampSlot(int tag);
+
+  /**
+   * @brief Lay out the final message; no fields can be added afterwards
+   */
+  void seal();
+
+  void setSeqNum(uint64_t seqNum) { setNumber(m_seqNum, seqNum); }
+  void setSendingTime(uint64_t wallClockNanos) {
+    setTimestamp(m_sendingTime, wallClockNanos);
+  }
+
+  /**
+   * @return false, leaving the slot unchanged, if the value does not fit
+   */
+  bool setNumber(Slot slot, uint64_t value);
+  bool setDecimal(Slot slot, double value);
+
+  void setTimestamp(Slot slot, uint64_t wallClockNanos);
+
+  /**
+   * @brief Write the checksum
+   *
+   * @return The complete message, valid until the next patch
+   */
+  std::string_view finish();
+
+  size_t size() const { return m_buffer.size(); }
+
+private:
+  struct SlotInfo {
+    size_t offset; // Into the body until sealed, into m_buffer afterwards
+    size_t width;
+    int decimals;
+  };
+
+  Slot addSlot(int tag, size_t width, int decimals);
+  void appendTag(int tag);
+  void patch(const SlotInfo& slot, const char* bytes);
+
+  std::string m_body;
+  std::string m_buffer;
+  std::string m_beginString;
+  std::vector<SlotInfo> m_slots;
+  size_t m_checksumOffset{0};
+  uint32_t m_sum{0}; // Of every byte before the trailer, modulo 2^32
+  bool m_sealed{false};
+
+  Slot m_seqNum;
+  Slot m_sendingTime;
+
+  // The date and time of day only change once a second
+  uint64_t m_cachedSecond{UINT64_MAX};
+  char m_cachedTimestamp[FIX_TIMESTAMP_LENGTH];
+};
+
+/**
+ * @class NewOrderSingleTemplate
+ * @brief NewOrderSingle (35=D) for one symbol, side and order type
+ *
+ * ClOrdID is numeric so that it can be patched like the other slots.
+ * Market orders carry no Price field.
+ */
+class NewOrderSingleTemplate {
+public:
+  static constexpr size_t CL_ORD_ID_WIDTH = 16;
+
+  NewOrderSingleTemplate(const FixHeaderFields& header,
+                         std::string_view symbol, char side, char ordType,
+                         char timeInForce, int priceDecimals = 8,
+                         int quantityDecimals = 8);
+
+  /**
+   * @return The message, or an empty view if a value does not fit its slot
+   */
+  std::string_view encode(uint64_t seqNum, uint64_t wallClockNanos,
+                          uint64_t clOrdId, double price, double quantity);
+
+private:
+  FixTemplate m_message;
+  FixTemplate::Slot m_clOrdId;
+  FixTemplate::Slot m_orderQty;
+  FixTemplate::Slot m_price;
+  FixTemplate::Slot m_transactTime;
+  bool m_hasPrice;
+};
+
+/**
+ * @class OrderCancelTemplate
+ * @brief OrderCancelRequest (35=F) for one symbol and side
+ *
+ * OrderQty repeats the quantity of the order being canceled.
+ */
+class OrderCancelTemplate {
+public:
+  OrderCancelTemplate(const FixHeaderFields& header, std::string_view symbol,
+                      char side, int quantityDecimals = 8);
+
+  /**
+   * @return The message, or an empty view if a value does not fit its slot
+   */
+  std::string_view encode(uint64_t seqNum, uint64_t wallClockNanos,
+                          uint64_t clOrdId, uint64_t origClOrdId,
+                          double quantity);
+
+private:
+  FixTemplate m_message;
+  FixTemplate::Slot m_clOrdId;
+  FixTemplate::Slot m_origClOrdId;
+  FixTemplate::Slot m_orderQty;
+  FixTemplate::Slot m_transactTime;
+};
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,320 @@
+#include "FixWire.h"
+
+#include <charconv>
+#include <chrono>
+#include <string>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+namespace {
+
+constexpr size_t TIMESTAMP_LENGTH = FIX_TIMESTAMP_LENGTH;
+
+size_t writeTimestamp(char* out, uint64_t wallClockNanos) {
+  using namespace std::chrono;
+  sys_time<nanoseconds> time{nanoseconds(wallClockNanos)};
+  auto day = floor<days>(time);
+  year_month_day date{day};
+  hh_mm_ss<nanoseconds> clock{time - day};
+
+  // YYYYMMDD-HH:MM:SS.ssssss
+  writeFixDigits(out, 4, static_cast<int>(date.year()));
+  writeFixDigits(out + 4, 2, static_cast<unsigned>(date.month()));
+  writeFixDigits(out + 6, 2, static_cast<unsigned>(date.day()));
+  out[8] = '-';
+  writeFixDigits(out + 9, 2, clock.hours().count());
+  out[11] = ':';
+  writeFixDigits(out + 12, 2, clock.minutes().count());
+  out[14] = ':';
+  writeFixDigits(out + 15, 2, clock.seconds().count());
+  out[17] = '.';
+  writeFixDigits(out + 18, 6, clock.subseconds().count() / 1000);
+  return TIMESTAMP_LENGTH;
+}
+
+template <typename T> T parseNumber(std::string_view text, T fallback) {
+  T value{};
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                   value);
+  return ec == std::errc() && ptr == text.data() + text.size() ? value
+                                                               : fallback;
+}
+
+void appendTrailer(std::string& message) {
+  uint8_t checksum = fixChecksum(message);
+  char trailer[8] = {'1',
+                     '0',
+                     '=',
+                     static_cast<char>('0' + checksum / 100),
+                     static_cast<char>('0' + checksum / 10 % 10),
+                     static_cast<char>('0' + checksum % 10),
+                     SOH};
+  message.append(trailer, 7);
+}
+
+} // namespace
+
+// ============================================================================
+// FixMessageBuilder Implementation
+// ============================================================================
+
+FixMessageBuilder::FixMessageBuilder(std::string_view beginString)
+    : m_beginString(beginString) {
+  m_body.reserve(256);
+  m_message.reserve(320);
+}
+
+FixMessageBuilder& FixMessageBuilder::begin(std::string_view msgType,
+                                            std::string_view senderCompId,
+                                            std::string_view targetCompId,
+                                            uint64_t seqNum,
+                                            uint64_t sendingTime) {
+  m_body.clear();
+  field(tag::MsgType, msgType);
+  field(tag::SenderCompID, senderCompId);
+  field(tag::TargetCompID, targetCompId);
+  field(tag::MsgSeqNum, static_cast<int64_t>(seqNum));
+  timestampField(tag::SendingTime, sendingTime);
+  return *this;
+}
+
+void FixMessageBuilder::appendTag(int tag) {
+  char buffer[16];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), tag);
+  m_body.append(buffer, ptr);
+  m_body.push_back('=');
+}
+
+FixMessageBuilder& FixMessageBuilder::field(int tag, std::string_view value) {
+  appendTag(tag);
+  m_body.append(value);
+  m_body.push_back(SOH);
+  return *this;
+}
+
+FixMessageBuilder& FixMessageBuilder::field(int tag, char value) {
+  appendTag(tag);
+  m_body.push_back(value);
+  m_body.push_back(SOH);
+  return *this;
+}
+
+FixMessageBuilder& FixMessageBuilder::field(int tag, int64_t value) {
+  char buffer[24];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return field(tag, std::string_view(buffer, ptr - buffer));
+}
+
+FixMessageBuilder& FixMessageBuilder::field(int tag, double value) {
+  // Shortest representation that round-trips, never exponent notation
+  char buffer[64];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                 std::chars_format::fixed);
+  if (ec != std::errc()) {
+    ptr = buffer;
+    *ptr++ = '0';
+  }
+  return field(tag, std::string_view(buffer, ptr - buffer));
+}
+
+FixMessageBuilder& FixMessageBuilder::timestampField(int tag,
+                                                     uint64_t wallClockNanos) {
+  char buffer[TIMESTAMP_LENGTH];
+  size_t length = writeTimestamp(buffer, wallClockNanos);
+  return field(tag, std::string_view(buffer, length));
+}
+
+std::string_view FixMessageBuilder::finish() {
+  m_message.clear();
+  m_message.append("8=");
+  m_message.append(m_beginString);
+  m_message.push_back(SOH);
+  m_message.append("9=");
+
+  char buffer[16];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                 m_body.size());
+  m_message.append(buffer, ptr);
+  m_message.push_back(SOH);
+  m_message.append(m_body);
+  appendTrailer(m_message);
+  return m_message;
+}
+
+// ============================================================================
+// FixMessageView Implementation
+// ============================================================================
+
+bool FixMessageView::parse(std::string_view message) {
+  m_fields.clear();
+
+  size_t length = fixFrameLength(message);
+  if (length == 0 || length != message.size()) {
+    return false;
+  }
+
+  size_t position = 0;
+  while (position < message.size()) {
+    size_t equals = message.find('=', position);
+    size_t end = message.find(SOH, position);
+    if (equals == std::string_view::npos || end == std::string_view::npos ||
+        equals > end) {
+      return false;
+    }
+
+    int tag = parseNumber<int>(message.substr(position, equals - position), 0);
+    if (tag <= 0) {
+      return false;
+    }
+    m_fields.emplace_back(tag, message.substr(equals + 1, end - equals - 1));
+    position = end + 1;
+  }
+
+  // The trailer is the last field; everything before it is summed
+  size_t trailerStart = message.size() - 7;
+  int expected = parseNumber<int>(get(tag::CheckSum), -1);
+  return m_fields.back().first == tag::CheckSum &&
+         expected == fixChecksum(message.substr(0, trailerStart));
+}
+
+bool FixMessageView::has(int tag) const {
+  for (const auto& [fieldTag, value] : m_fields) {
+    if (fieldTag == tag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string_view FixMessageView::get(int tag) const {
+  for (const auto& [fieldTag, value] : m_fields) {
+    if (fieldTag == tag) {
+      return value;
+    }
+  }
+  return {};
+}
+
+int64_t FixMessageView::getInt(int tag, int64_t fallback) const {
+  std::string_view value = get(tag);
+  return value.empty() ? fallback : parseNumber<int64_t>(value, fallback);
+}
+
+double FixMessageView::getDouble(int tag, double fallback) const {
+  std::string_view value = get(tag);
+  return value.empty() ? fallback : parseNumber<double>(value, fallback);
+}
+
+char FixMessageView::getChar(int tag) const {
+  std::string_view value = get(tag);
+  return value.empty() ? '\0' : value.front();
+}
+
+// ============================================================================
+// Framing helpers
+// ============================================================================
+
+size_t fixFrameLength(std::string_view buffer) {
+  // "8=<version>|9=<length>|" precedes the body
+  size_t beginEnd = buffer.find(SOH);
+  if (beginEnd == std::string_view::npos) {
+    return 0;
+  }
+  size_t lengthStart = beginEnd + 1;
+  if (buffer.substr(lengthStart, 2) != "9=") {
+    return 0;
+  }
+  size_t lengthEnd = buffer.find(SOH, lengthStart);
+  if (lengthEnd == std::string_view::npos) {
+    return 0;
+  }
+
+  size_t bodyLength = parseNumber<size_t>(
+      buffer.substr(lengthStart + 2, lengthEnd - lengthStart - 2), 0);
+  if (bodyLength == 0) {
+    return 0;
+  }
+
+  // Body, then the fixed-width "10=nnn|" trailer
+  size_t total = lengthEnd + 1 + bodyLength + 7;
+  return buffer.size() >= total ? total : 0;
+}
+
+uint8_t fixChecksum(std::string_view bytes) {
+  unsigned sum = 0;
+  for (char c : bytes) {
+    sum += static_cast<unsigned char>(c);
+  }
+  return static_cast<uint8_t>(sum & 0xFF);
+}
+
+std::string formatFixTimestamp(uint64_t wallClockNanos) {
+  char buffer[TIMESTAMP_LENGTH];
+  return std::string(buffer, writeTimestamp(buffer, wallClockNanos));
+}
+
+void writeFixTimestamp(char* out, uint64_t wallClockNanos) {
+  writeTimestamp(out, wallClockNanos);
+}
+
+void writeFixDigits(char* out, size_t width, uint64_t value) {
+  for (size_t i = width; i > 0; --i) {
+    out[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+bool writePossDupResend(std::string_view original, uint64_t sendingTime,
+                        std::string& out) {
+  if (!original.starts_with("8=") ||
+      fixFrameLength(original) != original.size()) {
+    return false;
+  }
+
+  size_t beginStringEnd = original.find(SOH);
+  size_t bodyStart = original.find(SOH, beginStringEnd + 1) + 1;
+  std::string_view body =
+      original.substr(bodyStart, original.size() - 7 - bodyStart);
+
+  size_t timeStart = body.find("\x01" "52=");
+  if (timeStart == std::string_view::npos) {
+    return false;
+  }
+  timeStart += 4;
+  size_t timeEnd = body.find(SOH, timeStart);
+  if (timeEnd == std::string_view::npos) {
+    return false;
+  }
+  std::string_view originalTime = body.substr(timeStart, timeEnd - timeStart);
+
+  // SendingTime becomes now and the original moves to OrigSendingTime
+  constexpr std::string_view POSS_DUP = "\x01" "43=Y\x01" "122=";
+  size_t bodyLength = body.size() + POSS_DUP.size() + originalTime.size();
+
+  out.clear();
+  out.append(original.substr(0, beginStringEnd + 1));
+  out.append("9=");
+  char buffer[16];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), bodyLength);
+  out.append(buffer, ptr);
+  out.push_back(SOH);
+  out.append(body.substr(0, timeStart));
+  if (originalTime.size() == TIMESTAMP_LENGTH) {
+    size_t at = out.size();
+    out.resize(at + TIMESTAMP_LENGTH);
+    writeFixTimestamp(out.data() + at, sendingTime);
+  } else {
+    out.append(originalTime);
+  }
+  out.append(POSS_DUP);
+  out.append(originalTime);
+  out.append(body.substr(timeEnd));
+  appendTrailer(out);
+  return true;
+}
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace fix {
+
+/**
+ * @brief FIX field delimiter
+ */
+constexpr char SOH = '\x01';
+
+/**
+ * @brief Standard FIX 4.4 tags used on the wire
+ */
+namespace tag {
+constexpr int AvgPx = 6;
+constexpr int BeginSeqNo = 7;
+constexpr int BeginString = 8;
+constexpr int BodyLength = 9;
+constexpr int CheckSum = 10;
+constexpr int ClOrdID = 11;
+constexpr int CumQty = 14;
+constexpr int EndSeqNo = 16;
+constexpr int ExecID = 17;
+constexpr int LastPx = 31;
+constexpr int LastQty = 32;
+constexpr int MsgSeqNum = 34;
+constexpr int MsgType = 35;
+constexpr int NewSeqNo = 36;
+constexpr int OrderID = 37;
+constexpr int OrderQty = 38;
+constexpr int OrdStatus = 39;
+constexpr int OrdType = 40;
+constexpr int OrigClOrdID = 41;
+constexpr int PossDupFlag = 43;
+constexpr int Price = 44;
+constexpr int RefSeqNum = 45;
+constexpr int SenderCompID = 49;
+constexpr int SendingTime = 52;
+constexpr int Side = 54;
+constexpr int Symbol = 55;
+constexpr int TargetCompID = 56;
+constexpr int Text = 58;
+constexpr int TimeInForce = 59;
+constexpr int TransactTime = 60;
+constexpr int EncryptMethod = 98;
+constexpr int CxlRejReason = 102;
+constexpr int HeartBtInt = 108;
+constexpr int TestReqID = 112;
+constexpr int OrigSendingTime = 122;
+constexpr int GapFillFlag = 123;
+constexpr int ResetSeqNumFlag = 141;
+constexpr int NoRelatedSym = 146;
+constexpr int ExecType = 150;
+constexpr int LeavesQty = 151;
+constexpr int MDReqID = 262;
+constexpr int SubscriptionRequestType = 263;
+constexpr int MarketDepth = 264;
+constexpr int NoMDEntryTypes = 267;
+constexpr int NoMDEntries = 268;
+constexpr int MDEntryType = 269;
+constexpr int MDEntryPx = 270;
+constexpr int MDEntrySize = 271;
+constexpr int CxlRejResponseTo = 434;
+constexpr int Username = 553;
+constexpr int Password = 554;
+} // namespace tag
+
+/**
+ * @class FixMessageBuilder
+ * @brief Serializes tag=value FIX messages into reusable buffers
+ *
+ * Fields are appended after the standard header; finish() prepends
+ * BeginString and BodyLength and appends the CheckSum trailer. Buffers are
+ * kept between messages, so a builder reused for every send stops
+ * allocating once it has seen its largest message.
+ */
+class FixMessageBuilder {
+public:
+  explicit FixMessageBuilder(std::string_view beginString = "FIX.4.4");
+
+  /**
+   * @brief Start a message with the standard header fields
+   *
+   * @param sendingTime Wall-clock nanoseconds since the Unix epoch
+   */
+  FixMessageBuilder& begin(std::string_view msgType,
+                           std::string_view senderCompId,
+                           std::string_view targetCompId, uint64_t seqNum,
+                           uint64_t sendingTime);
+
+  FixMessageBuilder& field(int tag, std::string_view value);
+  FixMessageBuilder& field(int tag, char value);
+  FixMessageBuilder& field(int tag, int64_t value);
+  FixMessageBuilder& field(int tag, double value);
+
+  /**
+   * @brief UTCTimestamp field (YYYYMMDD-HH:MM:SS.ssssss)
+   */
+  FixMessageBuilder& timestampField(int tag, uint64_t wallClockNanos);
+
+  /**
+   * @brief Complete the message
+   *
+   * @return View of the serialized message, valid until the next begin()
+   */
+  std::string_view finish();
+
+private:
+  void appendTag(int tag);
+
+  std::string m_beginString;
+  std::string m_body;
+  std::string m_message;
+};
+
+/**
+ * @class FixMessageView
+ * @brief Non-owning parsed view over one FIX message
+ *
+ * Field values are views into the parsed buffer, which must outlive the
+ * view. Repeated tags keep their first occurrence for get().
+ */
+class FixMessageView {
+public:
+  /**
+   * @brief Split a complete message into fields
+   *
+   * @return false if the message is malformed or its checksum is wrong
+   */
+  bool parse(std::string_view message);
+
+  std::string_view msgType() const { return get(tag::MsgType); }
+
+  bool has(int tag) const;
+
+  /**
+   * @return Field value, or an empty view if absent
+   */
+  std::string_view get(int tag) const;
+
+  int64_t getInt(int tag, int64_t fallback = 0) const;
+  double getDouble(int tag, double fallback = 0.0) const;
+
+  /**
+   * @return First character of the value, or '\0' if absent
+   */
+  char getChar(int tag) const;
+
+  const std::vector<std::pair<int, std::string_view>>& fields() const {
+    return m_fields;
+  }
+
+private:
+  std::vector<std::pair<int, std::string_view>> m_fields;
+};
+
+/**
+ * @brief Length of the first complete message at the start of a buffer
+ *
+ * Uses BodyLength to find the CheckSum trailer, so it works on partially
+ * received streams.
+ *
+ * @return 0 if the buffer does not yet hold a complete message
+ */
+size_t fixFrameLength(std::string_view buffer);
+
+/**
+ * @brief Modulo-256 sum of every byte, as carried in the CheckSum field
+ */
+uint8_t fixChecksum(std::string_view bytes);
+
+/**
+ * @brief Width of a UTCTimestamp with microseconds (YYYYMMDD-HH:MM:SS.ssssss)
+ */
+constexpr size_t FIX_TIMESTAMP_LENGTH = 24;
+
+/**
+ * @brief Format wall-clock nanoseconds as a FIX UTCTimestamp
+ */
+std::string formatFixTimestamp(uint64_t wallClockNanos);
+
+/**
+ * @brief Write a UTCTimestamp without allocating
+ *
+ * @param out Room for FIX_TIMESTAMP_LENGTH characters; no terminator is
+ * written
+ */
+void writeFixTimestamp(char* out, uint64_t wallClockNanos);
+
+/**
+ * @brief Write value as width zero-padded digits, keeping the low ones if
+ * it has more
+ */
+void writeFixDigits(char* out, size_t width, uint64_t value);
+
+/**
+ * @brief Copy a sent message as a resend: PossDupFlag=Y, SendingTime set to
+ * now and the original moved to OrigSendingTime; every other field is kept
+ * byte for byte
+ *
+ * @return false if the original is not a complete message with a
+ * SendingTime
+ */
+bool writePossDupResend(std::string_view original, uint64_t sendingTime,
+                        std::string& out);
+
+} // namespace fix
+} // namespace exchange
+} // namespace pinnacle
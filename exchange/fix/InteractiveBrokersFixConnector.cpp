@@ -1,12 +1,23 @@
 #include "InteractiveBrokersFixConnector.h"
-#include <iomanip>
+#include "../../core/utils/TimeUtils.h"
+
+#include <charconv>
 #include <iostream>
-#include <sstream>
 
 namespace pinnacle {
 namespace exchange {
 namespace fix {
 
+namespace {
+
+double parseDecimal(std::string_view value) {
+  double result = 0.0;
+  std::from_chars(value.data(), value.data() + value.size(), result);
+  return result;
+}
+
+} // namespace
+
 InteractiveBrokersFixConnector::InteractiveBrokersFixConnector(
     std::shared_ptr<utils::ApiCredentials> credentials)
     : FixConnector(FixConfig{}, credentials) {
@@ -43,15 +54,7 @@ bool InteractiveBrokersFixConnector::sendNewOrderSingle(
     return false;
   }
 
-  auto msg = createNewOrderSingle(order);
-
-  // Store order ID mapping
-  {
-    std::lock_guard<std::mutex> lock(m_orderIdMappingMutex);
-    m_orderIdMapping[order.getOrderId()] = order.getOrderId();
-  }
-
-  return sendMessage(msg);
+  return submitNewOrderSingle(order);
 }
 
 bool InteractiveBrokersFixConnector::cancelOrder(const std::string& orderId) {
@@ -60,8 +63,7 @@ bool InteractiveBrokersFixConnector::cancelOrder(const std::string& orderId) {
     return false;
   }
 
-  auto msg = createOrderCancelRequest(orderId);
-  return sendMessage(msg);
+  return submitOrderCancel(orderId);
 }
 
 bool InteractiveBrokersFixConnector::replaceOrder(
@@ -84,9 +86,6 @@ bool InteractiveBrokersFixConnector::replaceOrder(
 void InteractiveBrokersFixConnector::onLogon() {
   std::cout << "IB FIX: Successfully logged on to Interactive Brokers"
             << std::endl;
-
-  // Subscribe to any pending market data requests
-  subscribeToConfiguredSymbols();
 }
 
 void InteractiveBrokersFixConnector::onLogout() {
@@ -94,183 +93,103 @@ void InteractiveBrokersFixConnector::onLogout() {
 }
 
 void InteractiveBrokersFixConnector::onMarketDataMessage(
-    const hffix::message_reader& msg) {
-  hffix::field_reader msgType;
-  if (!msg.find_with_hint(hffix::tag::MsgType, msgType)) {
-    return;
-  }
-
-  std::string msgTypeStr(msgType.begin(), msgType.end());
-
-  if (msgTypeStr == "W") {
-    // Market Data Snapshot/Full Refresh
-    parseMarketDataSnapshot(msg);
-  } else if (msgTypeStr == "X") {
-    // Market Data Incremental Refresh
-    parseMarketDataIncrementalRefresh(msg);
-  }
+    const FixMessageView& msg) {
+  // Snapshots (W) and incremental refreshes (X) carry the same entries
+  parseMarketData(msg);
 }
 
 void InteractiveBrokersFixConnector::onExecutionReport(
-    const hffix::message_reader& msg) {
+    const FixMessageView& msg) {
   handleExecutionReport(msg);
 }
 
 void InteractiveBrokersFixConnector::onOrderCancelReject(
-    const hffix::message_reader& msg) {
-  hffix::field clOrdId, origClOrdId, ordStatus, cxlRejReason, text;
-
-  std::string orderIdStr, origOrderIdStr, statusStr, reasonStr, textStr;
-
-  if (msg.find_with_hint(hffix::tag::ClOrdID, clOrdId)) {
-    orderIdStr = std::string(clOrdId.begin(), clOrdId.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::OrigClOrdID, origClOrdId)) {
-    origOrderIdStr = std::string(origClOrdId.begin(), origClOrdId.end());
+    const FixMessageView& msg) {
+  std::string origOrderId = orderIdForClOrdId(msg.get(tag::OrigClOrdID));
+  if (origOrderId.empty()) {
+    origOrderId = msg.get(tag::OrigClOrdID);
   }
 
-  if (msg.find_with_hint(hffix::tag::OrdStatus, ordStatus)) {
-    statusStr = std::string(ordStatus.begin(), ordStatus.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::CxlRejReason, cxlRejReason)) {
-    reasonStr = std::string(cxlRejReason.begin(), cxlRejReason.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::Text, text)) {
-    textStr = std::string(text.begin(), text.end());
-  }
-
-  std::cout << "IB FIX: Order cancel rejected - Order: " << origOrderIdStr
-            << ", Reason: " << reasonStr << ", Text: " << textStr << std::endl;
+  std::cout << "IB FIX: Order cancel rejected - Order: " << origOrderId
+            << ", Reason: " << msg.get(tag::CxlRejReason)
+            << ", Text: " << msg.get(tag::Text) << std::endl;
 }
 
-hffix::message_writer InteractiveBrokersFixConnector::createIBMarketDataRequest(
+bool InteractiveBrokersFixConnector::sendMarketDataRequest(
     const std::string& symbol, char subscriptionRequestType) {
-
-  char buffer[1024];
-  hffix::message_writer msg(buffer, sizeof(buffer));
-
-  msg.push_back_header("V"); // Market Data Request
-  msg.push_back_string(hffix::tag::SenderCompID, m_config.senderCompId.c_str());
-  msg.push_back_string(hffix::tag::TargetCompID, m_config.targetCompId.c_str());
-  msg.push_back_int(hffix::tag::MsgSeqNum, getNextSeqNum());
-
-  // Current UTC time
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  std::tm* utc_tm = std::gmtime(&time_t);
-
-  char sendingTime[32];
-  std::snprintf(sendingTime, sizeof(sendingTime), "%04d%02d%02d-%02d:%02d:%02d",
-                utc_tm->tm_year + 1900, utc_tm->tm_mon + 1, utc_tm->tm_mday,
-                utc_tm->tm_hour, utc_tm->tm_min, utc_tm->tm_sec);
-  msg.push_back_string(hffix::tag::SendingTime, sendingTime);
-
-  // Market Data Request specific fields for IB
-  std::string mdReqId = "MD" + std::to_string(m_mdReqIdCounter.fetch_add(1));
-  msg.push_back_string(hffix::tag::MDReqID, mdReqId.c_str());
-  msg.push_back_char(hffix::tag::SubscriptionRequestType,
-                     subscriptionRequestType);
-  msg.push_back_int(hffix::tag::MarketDepth, 1); // Top of book
-
-  // NoMDEntryTypes - IB supports Bid(0), Offer(1), Trade(2)
-  msg.push_back_int(hffix::tag::NoMDEntryTypes, 3);
-  msg.push_back_char(hffix::tag::MDEntryType, '0'); // Bid
-  msg.push_back_char(hffix::tag::MDEntryType, '1'); // Offer
-  msg.push_back_char(hffix::tag::MDEntryType, '2'); // Trade
-
-  // NoRelatedSym
-  msg.push_back_int(hffix::tag::NoRelatedSym, 1);
   std::string ibSymbol = convertInternalSymbolToIB(symbol);
-  msg.push_back_string(hffix::tag::Symbol, ibSymbol.c_str());
-
-  msg.push_back_trailer();
-  return msg;
-}
-
-void InteractiveBrokersFixConnector::parseMarketDataSnapshot(
-    const hffix::message_reader& msg) {
-  hffix::field symbol, noMDEntries;
-
-  if (!msg.find_with_hint(hffix::tag::Symbol, symbol)) {
-    return;
-  }
-
-  std::string symbolStr =
-      convertIBSymbolToInternal(std::string(symbol.begin(), symbol.end()));
-
-  if (!msg.find_with_hint(hffix::tag::NoMDEntries, noMDEntries)) {
-    return;
-  }
-
-  int numEntries;
-  if (!hffix::extract_int(noMDEntries, numEntries)) {
-    return;
-  }
-
+  int64_t mdReqId = m_mdReqIdCounter.fetch_add(1);
+
+  return sendMessage("V", [&](FixMessageBuilder& msg) {
+    msg.field(tag::MDReqID, mdReqId)
+        .field(tag::SubscriptionRequestType, subscriptionRequestType)
+        .field(tag::MarketDepth, static_cast<int64_t>(1)) // Top of book
+        // NoMDEntryTypes - IB supports Bid(0), Offer(1), Trade(2)
+        .field(tag::NoMDEntryTypes, static_cast<int64_t>(3))
+        .field(tag::MDEntryType, '0')
+        .field(tag::MDEntryType, '1')
+        .field(tag::MDEntryType, '2')
+        .field(tag::NoRelatedSym, static_cast<int64_t>(1))
+        .field(tag::Symbol, ibSymbol);
+  });
+}
+
+void InteractiveBrokersFixConnector::parseMarketData(
+    const FixMessageView& msg) {
   MarketUpdate update;
-  update.symbol = symbolStr;
-  update.timestamp = std::chrono::steady_clock::now();
-
-  // Parse MD entries
-  hffix::field entryType, entryPx, entrySize;
-  auto entryTypeIter = msg.begin();
-  auto entryPxIter = msg.begin();
-  auto entrySizeIter = msg.begin();
-
-  for (int i = 0; i < numEntries; ++i) {
-    if (msg.find_with_hint(hffix::tag::MDEntryType, entryType, entryTypeIter)) {
-      char type;
-      if (hffix::extract_char(entryType, type)) {
-        if (msg.find_with_hint(hffix::tag::MDEntryPx, entryPx, entryPxIter)) {
-          double price;
-          if (hffix::extract_decimal(entryPx, price)) {
-            if (type == '0') { // Bid
-              update.bid = price;
-            } else if (type == '1') { // Offer
-              update.ask = price;
-            } else if (type == '2') { // Trade
-              update.lastPrice = price;
-            }
-          }
-        }
-
-        if (msg.find_with_hint(hffix::tag::MDEntrySize, entrySize,
-                               entrySizeIter)) {
-          double size;
-          if (hffix::extract_decimal(entrySize, size)) {
-            if (type == '0') { // Bid
-              update.bidSize = size;
-            } else if (type == '1') { // Offer
-              update.askSize = size;
-            } else if (type == '2') { // Trade
-              update.volume = size;
-            }
-          }
-        }
+  update.price = 0.0;
+  update.volume = 0.0;
+  update.isBuy = true;
+  update.timestamp = utils::TimeUtils::getCurrentNanos();
+  update.kernelTimestamp = getKernelReceiveTime();
+
+  // Walk the MD entry group in order: each MDEntryType starts an entry
+  // whose price and size follow it
+  char entryType = '\0';
+  for (const auto& [fieldTag, value] : msg.fields()) {
+    switch (fieldTag) {
+    case tag::Symbol:
+      update.symbol = convertIBSymbolToInternal(std::string(value));
+      break;
+    case tag::MDEntryType:
+      entryType = value.empty() ? '\0' : value.front();
+      break;
+    case tag::MDEntryPx: {
+      double price = parseDecimal(value);
+      if (entryType == '0') { // Bid
+        update.bidPrice = price;
+      } else if (entryType == '1') { // Offer
+        update.askPrice = price;
+      } else if (entryType == '2') { // Trade
+        update.price = price;
       }
+      break;
+    }
+    case tag::MDEntrySize:
+      if (entryType == '2') { // Trade
+        update.volume = parseDecimal(value);
+      }
+      break;
+    default:
+      break;
     }
   }
 
+  if (update.symbol.empty()) {
+    return;
+  }
+  if (update.price == 0.0 && update.bidPrice > 0.0 && update.askPrice > 0.0) {
+    update.price = (update.bidPrice + update.askPrice) / 2.0;
+  }
   publishMarketUpdate(update);
 }
 
-void InteractiveBrokersFixConnector::parseMarketDataIncrementalRefresh(
-    const hffix::message_reader& msg) {
-  // Similar to snapshot parsing but for incremental updates
-  parseMarketDataSnapshot(msg); // Simplified implementation
-}
-
 std::string InteractiveBrokersFixConnector::convertIBSymbolToInternal(
     const std::string& ibSymbol) {
   // IB uses different symbol formats, convert to our internal format
   // For example: "EUR.USD" -> "EURUSD", "AAPL" -> "AAPL"
   std::string internal = ibSymbol;
-  std::replace(internal.begin(), internal.end(), '.', '\0');
-  internal.erase(std::find(internal.begin(), internal.end(), '\0'),
-                 internal.end());
+  std::erase(internal, '.');
   return internal;
 }
 
@@ -290,73 +209,24 @@ std::string InteractiveBrokersFixConnector::convertInternalSymbolToIB(
 }
 
 void InteractiveBrokersFixConnector::handleExecutionReport(
-    const hffix::message_reader& msg) {
-  hffix::field clOrdId, symbol, side, orderQty, price, cumQty, avgPx, ordStatus,
-      execType;
-
-  std::string orderIdStr, symbolStr, sideStr, statusStr, execTypeStr;
-  double orderQuantity = 0.0, orderPrice = 0.0, cumQuantity = 0.0,
-         avgPrice = 0.0;
-
-  if (msg.find_with_hint(hffix::tag::ClOrdID, clOrdId)) {
-    orderIdStr = std::string(clOrdId.begin(), clOrdId.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::Symbol, symbol)) {
-    symbolStr =
-        convertIBSymbolToInternal(std::string(symbol.begin(), symbol.end()));
-  }
-
-  if (msg.find_with_hint(hffix::tag::Side, side)) {
-    sideStr = std::string(side.begin(), side.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::OrderQty, orderQty)) {
-    hffix::extract_decimal(orderQty, orderQuantity);
-  }
-
-  if (msg.find_with_hint(hffix::tag::Price, price)) {
-    hffix::extract_decimal(price, orderPrice);
-  }
-
-  if (msg.find_with_hint(hffix::tag::CumQty, cumQty)) {
-    hffix::extract_decimal(cumQty, cumQuantity);
-  }
-
-  if (msg.find_with_hint(hffix::tag::AvgPx, avgPx)) {
-    hffix::extract_decimal(avgPx, avgPrice);
-  }
-
-  if (msg.find_with_hint(hffix::tag::OrdStatus, ordStatus)) {
-    statusStr = std::string(ordStatus.begin(), ordStatus.end());
-  }
-
-  if (msg.find_with_hint(hffix::tag::ExecType, execType)) {
-    execTypeStr = std::string(execType.begin(), execType.end());
+    const FixMessageView& msg) {
+  std::string orderIdStr = orderIdForClOrdId(msg.get(tag::ClOrdID));
+  if (orderIdStr.empty()) {
+    orderIdStr = msg.get(tag::ClOrdID);
   }
+  std::string symbolStr =
+      convertIBSymbolToInternal(std::string(msg.get(tag::Symbol)));
 
   std::cout << "IB FIX: Execution Report - Order: " << orderIdStr
-            << ", Symbol: " << symbolStr << ", Side: " << sideStr
-            << ", Status: " << statusStr << ", Exec Type: " << execTypeStr
-            << ", Cum Qty: " << cumQuantity << ", Avg Px: " << avgPrice
-            << std::endl;
+            << ", Symbol: " << symbolStr << ", Side: " << msg.get(tag::Side)
+            << ", Status: " << msg.get(tag::OrdStatus)
+            << ", Exec Type: " << msg.get(tag::ExecType)
+            << ", Cum Qty: " << msg.getDouble(tag::CumQty)
+            << ", Avg Px: " << msg.getDouble(tag::AvgPx) << std::endl;
 
   // Typically here would update internal order state, notify strategy, etc.
 }
 
-void InteractiveBrokersFixConnector::subscribeToConfiguredSymbols() {
-  std::lock_guard<std::mutex> lock(m_pendingSubscriptionsMutex);
-
-  for (const auto& symbol : m_pendingSubscriptions) {
-    auto mdRequest = createIBMarketDataRequest(symbol, '1'); // Subscribe
-    sendMessage(mdRequest);
-    std::cout << "IB FIX: Subscribed to market data for " << symbol
-              << std::endl;
-  }
-
-  m_pendingSubscriptions.clear();
-}
-
 } // namespace fix
 } // namespace exchange
 } // namespace pinnacle
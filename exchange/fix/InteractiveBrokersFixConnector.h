@@ -38,31 +38,26 @@ protected:
   // FIX message handlers
   void onLogon() override;
   void onLogout() override;
-  void onMarketDataMessage(const hffix::message_reader& msg) override;
-  void onExecutionReport(const hffix::message_reader& msg) override;
-  void onOrderCancelReject(const hffix::message_reader& msg) override;
+  void onMarketDataMessage(const FixMessageView& msg) override;
+  void onExecutionReport(const FixMessageView& msg) override;
+  void onOrderCancelReject(const FixMessageView& msg) override;
 
-private:
   /**
-   * @brief Initialize IB-specific configuration
+   * @brief IB-specific market data request
    */
-  void initializeIBConfig();
-
-  /**
-   * @brief Create IB-specific market data request
-   */
-  hffix::message_writer createIBMarketDataRequest(const std::string& symbol,
-                                                  char subscriptionRequestType);
+  bool sendMarketDataRequest(const std::string& symbol,
+                             char subscriptionRequestType) override;
 
+private:
   /**
-   * @brief Parse IB market data snapshot
+   * @brief Initialize IB-specific configuration
    */
-  void parseMarketDataSnapshot(const hffix::message_reader& msg);
+  void initializeIBConfig();
 
   /**
-   * @brief Parse IB market data incremental refresh
+   * @brief Parse IB market data snapshot or incremental refresh
    */
-  void parseMarketDataIncrementalRefresh(const hffix::message_reader& msg);
+  void parseMarketData(const FixMessageView& msg);
 
   /**
    * @brief Convert IB symbol format to internal format
@@ -77,29 +72,12 @@ private:
   /**
    * @brief IB-specific order handling
    */
-  void handleExecutionReport(const hffix::message_reader& msg);
-
-  /**
-   * @brief Subscribe to market data after logon
-   */
-  void subscribeToConfiguredSymbols();
+  void handleExecutionReport(const FixMessageView& msg);
 
   /**
    * @brief Market data request ID counter
    */
   std::atomic<int> m_mdReqIdCounter{1};
-
-  /**
-   * @brief Order ID mapping (internal -> IB)
-   */
-  std::unordered_map<std::string, std::string> m_orderIdMapping;
-  std::mutex m_orderIdMappingMutex;
-
-  /**
-   * @brief Pending subscriptions (to be sent after logon)
-   */
-  std::vector<std::string> m_pendingSubscriptions;
-  std::mutex m_pendingSubscriptionsMutex;
 };
 
 } // namespace fix
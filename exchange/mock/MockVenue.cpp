@@ -0,0 +1,997 @@
+#include "MockVenue.h"
+#include "../../core/utils/TimeUtils.h"
+#include "../fix/FixWire.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <set>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace pinnacle {
+namespace exchange {
+namespace mock {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace websocket = boost::beast::websocket;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+namespace {
+
+// Quantities below this are treated as zero
+constexpr double QUANTITY_EPSILON = 1e-9;
+// Levels inspected when checking how much of the book an order can take
+constexpr size_t MAX_CROSS_LEVELS = 1000;
+
+std::string decimal(double value) {
+  char buffer[64];
+  auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                 std::chars_format::fixed);
+  return ec == std::errc() ? std::string(buffer, ptr) : std::string("0");
+}
+
+double roundPrice(double price) { return std::round(price * 100.0) / 100.0; }
+
+double roundQuantity(double quantity) {
+  return std::round(quantity * 1e8) / 1e8;
+}
+
+/**
+ * @brief RFC 3339 UTC time with nanoseconds, as Coinbase timestamps them
+ */
+std::string isoTimestamp(uint64_t wallClockNanos) {
+  using namespace std::chrono;
+  sys_time<nanoseconds> time{nanoseconds(wallClockNanos)};
+  auto day = floor<days>(time);
+  year_month_day date{day};
+  hh_mm_ss<nanoseconds> clock{time - day};
+
+  char buffer[40];
+  int written = std::snprintf(
+      buffer, sizeof(buffer), "%04d-%02u-%02uT%02d:%02d:%02d.%09lldZ",
+      static_cast<int>(date.year()), static_cast<unsigned>(date.month()),
+      static_cast<unsigned>(date.day()), static_cast<int>(clock.hours().count()),
+      static_cast<int>(clock.minutes().count()),
+      static_cast<int>(clock.seconds().count()),
+      static_cast<long long>(clock.subseconds().count()));
+  return std::string(buffer, written > 0 ? written : 0);
+}
+
+/**
+ * @brief Fields of an outbound ExecutionReport
+ */
+struct Report {
+  std::string clOrdId;
+  std::string origClOrdId;
+  std::string orderId;
+  std::string symbol;
+  OrderSide side{OrderSide::BUY};
+  char execType{'0'};
+  char ordStatus{'0'};
+  double orderQty{0.0};
+  double price{0.0};
+  double cumQty{0.0};
+  double lastQty{0.0};
+  double lastPx{0.0};
+  double avgPx{0.0};
+  std::string text;
+};
+
+} // namespace
+
+// ============================================================================
+// WebSocket session
+// ============================================================================
+
+class MockVenue::WsSession : public std::enable_shared_from_this<WsSession> {
+public:
+  WsSession(MockVenue& venue, tcp::socket socket)
+      : m_venue(venue), m_ws(std::move(socket)) {}
+
+  void start() {
+    beast::get_lowest_layer(m_ws).set_option(tcp::no_delay(true));
+    m_ws.text(true);
+    m_ws.async_accept(
+        [self = shared_from_this()](beast::error_code ec) {
+          if (!ec) {
+            self->read();
+          }
+        });
+  }
+
+  void send(std::shared_ptr<const std::string> message) {
+    if (!m_open) {
+      return;
+    }
+    m_queue.push_back(std::move(message));
+    if (m_queue.size() == 1) {
+      writeNext();
+    }
+  }
+
+  bool isSubscribed(const std::string& channel,
+                    const std::string& symbol) const {
+    return m_open && m_subscriptions.count({channel, symbol}) > 0;
+  }
+
+  void close() {
+    m_open = false;
+    beast::error_code ignored;
+    beast::get_lowest_layer(m_ws).close(ignored);
+  }
+
+private:
+  void read() {
+    m_ws.async_read(m_buffer, [self = shared_from_this()](
+                                  beast::error_code ec, size_t) {
+      if (ec) {
+        self->m_open = false;
+        return;
+      }
+      self->onMessage(beast::buffers_to_string(self->m_buffer.data()));
+      self->m_buffer.consume(self->m_buffer.size());
+      self->read();
+    });
+  }
+
+  void onMessage(const std::string& text) {
+    json message = json::parse(text, nullptr, false);
+    if (message.is_discarded() || message.value("type", "") != "subscribe" ||
+        !message.contains("product_ids")) {
+      return;
+    }
+
+    std::string channel = message.value("channel", "");
+    std::vector<std::string> symbols;
+    for (const auto& product : message["product_ids"]) {
+      if (product.is_string() && m_venue.m_symbols.count(product)) {
+        symbols.push_back(product.get<std::string>());
+        m_subscriptions.insert({channel, symbols.back()});
+      }
+    }
+
+    json ack = {{"channel", "subscriptions"},
+                {"timestamp",
+                 isoTimestamp(utils::TimeUtils::getWallClockNanos())},
+                {"events", json::array({{{"subscriptions",
+                                          {{channel, symbols}}}}})}};
+    send(std::make_shared<const std::string>(ack.dump()));
+
+    if (channel == "level2") {
+      for (const auto& symbol : symbols) {
+        m_venue.sendSnapshot(shared_from_this(), symbol);
+      }
+    }
+  }
+
+  void writeNext() {
+    m_ws.async_write(
+        asio::buffer(*m_queue.front()),
+        [self = shared_from_this()](beast::error_code ec, size_t) {
+          if (ec) {
+            self->m_open = false;
+            self->m_queue.clear();
+            return;
+          }
+          self->m_queue.pop_front();
+          if (!self->m_queue.empty()) {
+            self->writeNext();
+          }
+        });
+  }
+
+  MockVenue& m_venue;
+  websocket::stream<tcp::socket> m_ws;
+  beast::flat_buffer m_buffer;
+  std::deque<std::shared_ptr<const std::string>> m_queue;
+  std::set<std::pair<std::string, std::string>> m_subscriptions;
+  bool m_open{true};
+};
+
+// ============================================================================
+// FIX session
+// ============================================================================
+
+class MockVenue::FixSession : public std::enable_shared_from_this<FixSession> {
+public:
+  FixSession(MockVenue& venue, tcp::socket socket)
+      : m_venue(venue), m_socket(std::move(socket)) {}
+
+  void start() {
+    m_socket.set_option(tcp::no_delay(true));
+    read();
+  }
+
+  void sendExecutionReport(const Report& report) {
+    m_builder.begin("8", m_venue.m_config.name, m_clientCompId, m_outSeq++,
+                    utils::TimeUtils::getWallClockNanos())
+        .field(fix::tag::OrderID, report.orderId)
+        .field(fix::tag::ClOrdID, report.clOrdId);
+    if (!report.origClOrdId.empty()) {
+      m_builder.field(fix::tag::OrigClOrdID, report.origClOrdId);
+    }
+    m_builder.field(fix::tag::ExecID, static_cast<int64_t>(++m_execId))
+        .field(fix::tag::ExecType, report.execType)
+        .field(fix::tag::OrdStatus, report.ordStatus)
+        .field(fix::tag::Symbol, report.symbol)
+        .field(fix::tag::Side, report.side == OrderSide::BUY ? '1' : '2')
+        .field(fix::tag::OrderQty, report.orderQty)
+        .field(fix::tag::Price, report.price)
+        .field(fix::tag::LastQty, report.lastQty)
+        .field(fix::tag::LastPx, report.lastPx)
+        .field(fix::tag::CumQty, report.cumQty)
+        .field(fix::tag::LeavesQty,
+               report.ordStatus == '0' || report.ordStatus == '1'
+                   ? roundQuantity(report.orderQty - report.cumQty)
+                   : 0.0)
+        .field(fix::tag::AvgPx, report.avgPx)
+        .timestampField(fix::tag::TransactTime,
+                        utils::TimeUtils::getWallClockNanos());
+    if (!report.text.empty()) {
+      m_builder.field(fix::tag::Text, report.text);
+    }
+    write(m_builder.finish());
+  }
+
+  void sendCancelReject(const std::string& clOrdId,
+                        const std::string& origClOrdId,
+                        const std::string& reason) {
+    m_builder
+        .begin("9", m_venue.m_config.name, m_clientCompId, m_outSeq++,
+               utils::TimeUtils::getWallClockNanos())
+        .field(fix::tag::OrderID, "NONE")
+        .field(fix::tag::ClOrdID, clOrdId)
+        .field(fix::tag::OrigClOrdID, origClOrdId)
+        .field(fix::tag::OrdStatus, '8')
+        .field(fix::tag::CxlRejResponseTo, '1')
+        .field(fix::tag::Text, reason);
+    write(m_builder.finish());
+  }
+
+  void close() {
+    beast::error_code ignored;
+    m_socket.close(ignored);
+  }
+
+private:
+  void read() {
+    m_socket.async_read_some(
+        asio::buffer(m_chunk),
+        [self = shared_from_this()](beast::error_code ec, size_t bytes) {
+          if (ec) {
+            return;
+          }
+          self->m_inbound.append(self->m_chunk.data(), bytes);
+          if (!self->drain()) {
+            self->close();
+            return;
+          }
+          self->read();
+        });
+  }
+
+  bool drain() {
+    size_t consumed = 0;
+    while (size_t length = fix::fixFrameLength(
+               std::string_view(m_inbound).substr(consumed))) {
+      if (!m_view.parse(std::string_view(m_inbound).substr(consumed, length))) {
+        spdlog::warn("MockVenue {}: dropping malformed FIX message",
+                     m_venue.m_config.name);
+        return false;
+      }
+      if (!process()) {
+        return false;
+      }
+      consumed += length;
+    }
+    m_inbound.erase(0, consumed);
+    return true;
+  }
+
+  bool process() {
+    std::string_view type = m_view.msgType();
+
+    if (type == "A") {
+      m_clientCompId = std::string(m_view.get(fix::tag::SenderCompID));
+      m_builder
+          .begin("A", m_venue.m_config.name, m_clientCompId, m_outSeq++,
+                 utils::TimeUtils::getWallClockNanos())
+          .field(fix::tag::EncryptMethod, '0')
+          .field(fix::tag::HeartBtInt, m_view.getInt(fix::tag::HeartBtInt, 30));
+      write(m_builder.finish());
+      m_loggedOn = true;
+      return true;
+    }
+
+    if (!m_loggedOn) {
+      return false; // First message must be a Logon
+    }
+
+    if (type == "D") {
+      std::string clOrdId(m_view.get(fix::tag::ClOrdID));
+      std::string symbol(m_view.get(fix::tag::Symbol));
+      OrderSide side =
+          m_view.getChar(fix::tag::Side) == '2' ? OrderSide::SELL
+                                                : OrderSide::BUY;
+      char ordType = m_view.getChar(fix::tag::OrdType);
+      char timeInForce = m_view.has(fix::tag::TimeInForce)
+                             ? m_view.getChar(fix::tag::TimeInForce)
+                             : '0';
+      double price = m_view.getDouble(fix::tag::Price);
+      double quantity = m_view.getDouble(fix::tag::OrderQty);
+
+      m_venue.afterDelay([venue = &m_venue, self = shared_from_this(),
+                          clOrdId = std::move(clOrdId),
+                          symbol = std::move(symbol), side, ordType,
+                          timeInForce, price, quantity]() mutable {
+        venue->handleNewOrder(self, std::move(clOrdId), std::move(symbol),
+                              side, ordType, timeInForce, price, quantity);
+      });
+    } else if (type == "F") {
+      std::string clOrdId(m_view.get(fix::tag::ClOrdID));
+      std::string origClOrdId(m_view.get(fix::tag::OrigClOrdID));
+      std::string symbol(m_view.get(fix::tag::Symbol));
+      m_venue.afterDelay([venue = &m_venue, self = shared_from_this(),
+                          clOrdId = std::move(clOrdId),
+                          origClOrdId = std::move(origClOrdId),
+                          symbol = std::move(symbol)]() {
+        venue->handleCancel(self, clOrdId, origClOrdId, symbol);
+      });
+    } else if (type == "1") {
+      m_builder
+          .begin("0", m_venue.m_config.name, m_clientCompId, m_outSeq++,
+                 utils::TimeUtils::getWallClockNanos())
+          .field(fix::tag::TestReqID, m_view.get(fix::tag::TestReqID));
+      write(m_builder.finish());
+    } else if (type == "5") {
+      m_builder.begin("5", m_venue.m_config.name, m_clientCompId, m_outSeq++,
+                      utils::TimeUtils::getWallClockNanos());
+      write(m_builder.finish());
+      return false;
+    }
+    // Heartbeats and unsupported messages are ignored
+    return true;
+  }
+
+  void write(std::string_view message) {
+    m_outbound.emplace_back(message);
+    if (m_outbound.size() == 1) {
+      writeNext();
+    }
+  }
+
+  void writeNext() {
+    asio::async_write(
+        m_socket, asio::buffer(m_outbound.front()),
+        [self = shared_from_this()](beast::error_code ec, size_t) {
+          if (ec) {
+            self->m_outbound.clear();
+            return;
+          }
+          self->m_outbound.pop_front();
+          if (!self->m_outbound.empty()) {
+            self->writeNext();
+          }
+        });
+  }
+
+  MockVenue& m_venue;
+  tcp::socket m_socket;
+  std::array<char, 4096> m_chunk;
+  std::string m_inbound;
+  std::deque<std::string> m_outbound;
+  fix::FixMessageBuilder m_builder;
+  fix::FixMessageView m_view;
+  std::string m_clientCompId;
+  uint64_t m_outSeq{1};
+  uint64_t m_execId{0};
+  bool m_loggedOn{false};
+};
+
+// ============================================================================
+// MockVenue Implementation
+// ============================================================================
+
+MockVenue::MockVenue(MockVenueConfig config)
+    : m_config(std::move(config)), m_wsAcceptor(m_io), m_fixAcceptor(m_io),
+      m_tickTimer(m_io), m_rng(m_config.seed) {}
+
+MockVenue::~MockVenue() { stop(); }
+
+bool MockVenue::start() {
+  if (m_running.load()) {
+    return false;
+  }
+
+  try {
+    auto address = asio::ip::make_address(m_config.host);
+    for (auto [acceptor, port] :
+         {std::pair{&m_wsAcceptor, m_config.wsPort},
+          std::pair{&m_fixAcceptor, m_config.fixPort}}) {
+      tcp::endpoint endpoint(address, port);
+      acceptor->open(endpoint.protocol());
+      acceptor->set_option(tcp::acceptor::reuse_address(true));
+      acceptor->bind(endpoint);
+      acceptor->listen();
+    }
+  } catch (const boost::system::system_error& e) {
+    spdlog::error("MockVenue {}: cannot listen on {}: {}", m_config.name,
+                  m_config.host, e.what());
+    beast::error_code ignored;
+    m_wsAcceptor.close(ignored);
+    m_fixAcceptor.close(ignored);
+    return false;
+  }
+  m_wsPort = m_wsAcceptor.local_endpoint().port();
+  m_fixPort = m_fixAcceptor.local_endpoint().port();
+
+  // Seed every book before the first client can connect
+  for (const auto& symbol : m_config.symbols) {
+    SymbolState& state = m_symbols[symbol];
+    state.book = std::make_unique<OrderBook>(symbol, false);
+    state.mid = m_config.initialMid;
+    state.lastPrice = m_config.initialMid;
+    requote(symbol, state);
+  }
+
+  acceptWebSocket();
+  acceptFix();
+  m_lastDue = Clock::now();
+  m_nextTick = Clock::now() + m_config.tickInterval;
+  scheduleTick();
+
+  m_running.store(true);
+  m_thread = std::thread([this]() {
+#ifdef __linux__
+    // Timer wakeups are the venue's latency model; do not let the kernel
+    // coalesce them by the default 50us slack
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+#endif
+    m_io.run();
+  });
+
+  spdlog::info("MockVenue {} listening: ws://{}:{} fix://{}:{}",
+               m_config.name, m_config.host, m_wsPort, m_config.host,
+               m_fixPort);
+  return true;
+}
+
+void MockVenue::stop() {
+  if (!m_running.exchange(false)) {
+    return;
+  }
+
+  m_io.stop();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+
+  beast::error_code ignored;
+  m_wsAcceptor.close(ignored);
+  m_fixAcceptor.close(ignored);
+  for (auto& weak : m_wsSessions) {
+    if (auto session = weak.lock()) {
+      session->close();
+    }
+  }
+  m_wsSessions.clear();
+}
+
+MockVenueStats MockVenue::getStats() const {
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  return m_stats;
+}
+
+void MockVenue::acceptWebSocket() {
+  m_wsAcceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+    if (ec) {
+      return; // Acceptor closed
+    }
+    auto session = std::make_shared<WsSession>(*this, std::move(socket));
+    m_wsSessions.erase(std::remove_if(m_wsSessions.begin(), m_wsSessions.end(),
+                                      [](const auto& weak) {
+                                        return weak.expired();
+                                      }),
+                       m_wsSessions.end());
+    m_wsSessions.push_back(session);
+    session->start();
+    acceptWebSocket();
+  });
+}
+
+void MockVenue::acceptFix() {
+  m_fixAcceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+    if (ec) {
+      return;
+    }
+    std::make_shared<FixSession>(*this, std::move(socket))->start();
+    acceptFix();
+  });
+}
+
+template <typename Fn> void MockVenue::afterDelay(Fn&& action) {
+  auto delay = m_config.latency;
+  if (m_config.jitter.count() > 0) {
+    std::uniform_int_distribution<int64_t> jitter(0, m_config.jitter.count());
+    delay += std::chrono::microseconds(jitter(m_rng));
+  }
+
+  m_lastDue = std::max(m_lastDue, Clock::now() + delay);
+  auto timer = std::make_shared<asio::steady_timer>(m_io, m_lastDue);
+  timer->async_wait([timer, action = std::forward<Fn>(action)](
+                        beast::error_code ec) mutable {
+    if (!ec) {
+      action();
+    }
+  });
+}
+
+std::string MockVenue::nextOrderId(char prefix) {
+  return prefix + std::to_string(++m_orderIdCounter);
+}
+
+// ============================================================================
+// Market data
+// ============================================================================
+
+void MockVenue::scheduleTick() {
+  m_tickTimer.expires_at(m_nextTick);
+  m_tickTimer.async_wait([this](beast::error_code ec) {
+    if (ec) {
+      return;
+    }
+    onTick();
+
+    // Fixed cadence; skip ticks rather than burst after a stall
+    m_nextTick += m_config.tickInterval;
+    auto now = Clock::now();
+    if (m_nextTick < now) {
+      m_nextTick = now + m_config.tickInterval;
+    }
+    scheduleTick();
+  });
+}
+
+void MockVenue::onTick() {
+  std::normal_distribution<double> move(0.0, m_config.volatility);
+
+  for (auto& [symbol, state] : m_symbols) {
+    state.mid = std::max(m_config.levelSpacing, state.mid + move(m_rng));
+    requote(symbol, state);
+
+    uint64_t timestamp = utils::TimeUtils::getWallClockNanos();
+    publish(std::make_shared<const std::string>(
+                tickerMessage(symbol, state, timestamp)),
+            "ticker", symbol);
+    publish(std::make_shared<const std::string>(
+                level2Message(symbol, state, timestamp, false)),
+            "level2", symbol);
+  }
+}
+
+void MockVenue::requote(const std::string& symbol, SymbolState& state) {
+  for (const auto& id : state.makerOrders) {
+    state.book->cancelOrder(id);
+    state.resting.erase(id);
+  }
+  state.makerOrders.clear();
+
+  // Makers take any client order they cross before resting, which is how
+  // resting client orders get filled passively
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+    for (size_t level = 0; level < m_config.bookLevels; ++level) {
+      double offset = m_config.halfSpread + level * m_config.levelSpacing;
+      double price = roundPrice(side == OrderSide::BUY ? state.mid - offset
+                                                       : state.mid + offset);
+      if (price <= 0.0) {
+        continue;
+      }
+
+      std::vector<Fill> fills =
+          cross(state, side, price, m_config.levelQuantity);
+      reportPassiveFills(state, symbol, fills);
+
+      double filled = 0.0;
+      for (const auto& fill : fills) {
+        filled += fill.quantity;
+      }
+      double remaining = roundQuantity(m_config.levelQuantity - filled);
+      if (remaining <= QUANTITY_EPSILON) {
+        continue;
+      }
+
+      std::string id = nextOrderId('M');
+      auto order = std::make_shared<Order>(id, symbol, side, OrderType::LIMIT,
+                                           price, remaining, now);
+      if (state.book->addOrder(order)) {
+        RestingOrder resting;
+        resting.side = side;
+        resting.price = price;
+        resting.quantity = remaining;
+        state.resting.emplace(id, std::move(resting));
+        state.makerOrders.push_back(std::move(id));
+      }
+    }
+  }
+}
+
+std::string MockVenue::tickerMessage(const std::string& symbol,
+                                     const SymbolState& state,
+                                     uint64_t timestamp) {
+  auto bids = state.book->getBidLevels(1);
+  auto asks = state.book->getAskLevels(1);
+
+  json ticker = {{"type", "ticker"},
+                 {"product_id", symbol},
+                 {"price", decimal(state.lastPrice)},
+                 {"volume_24_h", decimal(state.volume)},
+                 {"best_bid", decimal(bids.empty() ? 0.0 : bids[0].price)},
+                 {"best_bid_quantity",
+                  decimal(bids.empty() ? 0.0 : bids[0].totalQuantity)},
+                 {"best_ask", decimal(asks.empty() ? 0.0 : asks[0].price)},
+                 {"best_ask_quantity",
+                  decimal(asks.empty() ? 0.0 : asks[0].totalQuantity)}};
+
+  json message = {
+      {"channel", "ticker"},
+      {"timestamp", isoTimestamp(timestamp)},
+      {"sequence_num", m_stats.marketDataMessages},
+      {"events",
+       json::array({{{"type", "update"}, {"tickers", json::array({ticker})}}})}};
+  return message.dump();
+}
+
+std::string MockVenue::level2Message(const std::string& symbol,
+                                     SymbolState& state, uint64_t timestamp,
+                                     bool snapshot) {
+  std::string eventTime = isoTimestamp(timestamp);
+  json updates = json::array();
+  auto addUpdate = [&](const char* side, double price, double quantity) {
+    updates.push_back({{"side", side},
+                       {"event_time", eventTime},
+                       {"price_level", decimal(price)},
+                       {"new_quantity", decimal(quantity)}});
+  };
+
+  if (snapshot) {
+    // What subscribers already hold, so later diffs apply cleanly
+    for (const auto& [price, quantity] : state.publishedBids) {
+      addUpdate("bid", price, quantity);
+    }
+    for (const auto& [price, quantity] : state.publishedAsks) {
+      addUpdate("offer", price, quantity);
+    }
+  } else {
+    auto diff = [&](const char* side, const std::vector<PriceLevel>& levels,
+                    std::vector<std::pair<double, double>>& published) {
+      std::vector<std::pair<double, double>> current;
+      current.reserve(levels.size());
+      for (const auto& level : levels) {
+        current.emplace_back(level.price, level.totalQuantity);
+      }
+
+      for (const auto& [price, quantity] : published) {
+        bool present = std::any_of(
+            current.begin(), current.end(),
+            [price = price](const auto& entry) { return entry.first == price; });
+        if (!present) {
+          addUpdate(side, price, 0.0);
+        }
+      }
+      for (const auto& entry : current) {
+        if (std::find(published.begin(), published.end(), entry) ==
+            published.end()) {
+          addUpdate(side, entry.first, entry.second);
+        }
+      }
+      published = std::move(current);
+    };
+
+    diff("bid", state.book->getBidLevels(m_config.bookLevels),
+         state.publishedBids);
+    diff("offer", state.book->getAskLevels(m_config.bookLevels),
+         state.publishedAsks);
+  }
+
+  json message = {{"channel", "l2_data"},
+                  {"timestamp", eventTime},
+                  {"sequence_num", m_stats.marketDataMessages},
+                  {"events", json::array({{{"type", snapshot ? "snapshot"
+                                                             : "update"},
+                                           {"product_id", symbol},
+                                           {"updates", updates}}})}};
+  return message.dump();
+}
+
+void MockVenue::publish(std::shared_ptr<const std::string> message,
+                        const std::string& channel,
+                        const std::string& symbol) {
+  afterDelay([this, message = std::move(message), channel, symbol]() {
+    uint64_t sent = 0;
+    for (const auto& weak : m_wsSessions) {
+      auto session = weak.lock();
+      if (session && session->isSubscribed(channel, symbol)) {
+        session->send(message);
+        ++sent;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.marketDataMessages += sent;
+  });
+}
+
+void MockVenue::sendSnapshot(const std::shared_ptr<WsSession>& session,
+                             const std::string& symbol) {
+  auto it = m_symbols.find(symbol);
+  if (it != m_symbols.end()) {
+    session->send(std::make_shared<const std::string>(level2Message(
+        symbol, it->second, utils::TimeUtils::getWallClockNanos(), true)));
+  }
+}
+
+// ============================================================================
+// Order entry
+// ============================================================================
+
+std::vector<MockVenue::Fill> MockVenue::cross(SymbolState& state,
+                                              OrderSide side, double limit,
+                                              double quantity) {
+  std::vector<Fill> result;
+
+  // Only take what sits at or inside the limit
+  double crossable = 0.0;
+  auto levels = side == OrderSide::BUY
+                    ? state.book->getAskLevels(MAX_CROSS_LEVELS)
+                    : state.book->getBidLevels(MAX_CROSS_LEVELS);
+  for (const auto& level : levels) {
+    bool inside = side == OrderSide::BUY ? level.price <= limit
+                                         : level.price >= limit;
+    if (!inside || crossable >= quantity) {
+      break;
+    }
+    crossable += level.totalQuantity;
+  }
+  crossable = std::min(crossable, quantity);
+  if (crossable <= QUANTITY_EPSILON) {
+    return result;
+  }
+
+  std::vector<std::pair<std::string, double>> bookFills;
+  state.book->executeMarketOrder(side, crossable, bookFills);
+
+  result.reserve(bookFills.size());
+  for (const auto& [id, filled] : bookFills) {
+    auto it = state.resting.find(id);
+    if (it == state.resting.end()) {
+      continue;
+    }
+    RestingOrder& resting = it->second;
+    result.push_back({id, resting.price, filled});
+
+    state.lastPrice = resting.price;
+    state.volume += filled;
+  }
+  return result;
+}
+
+void MockVenue::reportPassiveFills(SymbolState& state,
+                                   const std::string& symbol,
+                                   const std::vector<Fill>& fills) {
+  for (const auto& fill : fills) {
+    auto it = state.resting.find(fill.bookId);
+    if (it == state.resting.end()) {
+      continue;
+    }
+
+    RestingOrder& resting = it->second;
+    resting.cumQty = roundQuantity(resting.cumQty + fill.quantity);
+    resting.notional += fill.quantity * fill.price;
+    bool done = resting.cumQty >= resting.quantity - QUANTITY_EPSILON;
+
+    if (auto session = resting.session.lock()) {
+      Report report;
+      report.clOrdId = resting.clOrdId;
+      report.orderId = fill.bookId;
+      report.symbol = symbol;
+      report.side = resting.side;
+      report.execType = 'F';
+      report.ordStatus = done ? '2' : '1';
+      report.orderQty = resting.quantity;
+      report.price = resting.price;
+      report.cumQty = resting.cumQty;
+      report.lastQty = fill.quantity;
+      report.lastPx = fill.price;
+      report.avgPx = resting.notional / resting.cumQty;
+
+      afterDelay([session, report = std::move(report)]() {
+        session->sendExecutionReport(report);
+      });
+
+      std::lock_guard<std::mutex> lock(m_statsMutex);
+      m_stats.fills++;
+    }
+
+    if (done) {
+      state.clientOrders.erase(resting.clOrdId);
+      state.resting.erase(it);
+    }
+  }
+}
+
+void MockVenue::handleNewOrder(const std::shared_ptr<FixSession>& session,
+                               std::string clOrdId, std::string symbol,
+                               OrderSide side, char ordType, char timeInForce,
+                               double price, double quantity) {
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.ordersReceived++;
+  }
+
+  Report report;
+  report.clOrdId = clOrdId;
+  report.symbol = symbol;
+  report.side = side;
+  report.orderQty = quantity;
+  report.price = price;
+
+  auto symbolIt = m_symbols.find(symbol);
+  std::string reason;
+  if (symbolIt == m_symbols.end()) {
+    reason = "Unknown symbol";
+  } else if (quantity <= 0.0 || (ordType != '1' && price <= 0.0)) {
+    reason = "Invalid quantity or price";
+  } else if (symbolIt->second.clientOrders.count(clOrdId)) {
+    reason = "Duplicate ClOrdID";
+  } else if (std::uniform_real_distribution<double>(0.0, 1.0)(m_rng) <
+             m_config.rejectRate) {
+    reason = "Rejected by venue";
+  }
+
+  if (!reason.empty()) {
+    report.orderId = "NONE";
+    report.execType = '8';
+    report.ordStatus = '8';
+    report.text = reason;
+    session->sendExecutionReport(report);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.ordersRejected++;
+    return;
+  }
+
+  SymbolState& state = symbolIt->second;
+  report.orderId = nextOrderId('C');
+  report.execType = '0';
+  report.ordStatus = '0';
+  session->sendExecutionReport(report);
+
+  // An injected partial fill caps how much of the book the order may take
+  double fillable = quantity;
+  if (std::uniform_real_distribution<double>(0.0, 1.0)(m_rng) <
+      m_config.partialFillRate) {
+    fillable = roundQuantity(
+        quantity * std::uniform_real_distribution<double>(0.1, 0.9)(m_rng));
+  }
+
+  double limit = ordType == '1' ? (side == OrderSide::BUY
+                                       ? std::numeric_limits<double>::max()
+                                       : 0.0)
+                                : price;
+  std::vector<Fill> fills = cross(state, side, limit, fillable);
+
+  double notional = 0.0;
+  for (const auto& fill : fills) {
+    report.cumQty = roundQuantity(report.cumQty + fill.quantity);
+    notional += fill.quantity * fill.price;
+
+    report.execType = 'F';
+    report.ordStatus =
+        report.cumQty >= quantity - QUANTITY_EPSILON ? '2' : '1';
+    report.lastQty = fill.quantity;
+    report.lastPx = fill.price;
+    report.avgPx = notional / report.cumQty;
+    session->sendExecutionReport(report);
+  }
+  reportPassiveFills(state, symbol, fills);
+
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.fills += fills.size();
+  }
+
+  double remaining = roundQuantity(quantity - report.cumQty);
+  if (remaining <= QUANTITY_EPSILON) {
+    return;
+  }
+
+  // Market, IOC and FOK remainders are canceled; FOK is not all-or-none
+  bool immediate = ordType == '1' || timeInForce == '3' || timeInForce == '4';
+  if (immediate) {
+    report.execType = '4';
+    report.ordStatus = '4';
+    report.lastQty = 0.0;
+    report.lastPx = 0.0;
+    session->sendExecutionReport(report);
+    return;
+  }
+
+  auto order = std::make_shared<Order>(report.orderId, symbol, side,
+                                       OrderType::LIMIT, price, remaining,
+                                       utils::TimeUtils::getCurrentNanos());
+  if (state.book->addOrder(order)) {
+    RestingOrder resting;
+    resting.session = session;
+    resting.clOrdId = clOrdId;
+    resting.side = side;
+    resting.price = price;
+    resting.quantity = quantity;
+    resting.cumQty = report.cumQty;
+    resting.notional = notional;
+    state.resting.emplace(report.orderId, std::move(resting));
+    state.clientOrders.emplace(std::move(clOrdId), report.orderId);
+  }
+}
+
+void MockVenue::handleCancel(const std::shared_ptr<FixSession>& session,
+                             const std::string& clOrdId,
+                             const std::string& origClOrdId,
+                             const std::string& symbol) {
+  auto symbolIt = m_symbols.find(symbol);
+  if (symbolIt == m_symbols.end()) {
+    session->sendCancelReject(clOrdId, origClOrdId, "Unknown symbol");
+    return;
+  }
+
+  SymbolState& state = symbolIt->second;
+  auto clientIt = state.clientOrders.find(origClOrdId);
+  if (clientIt == state.clientOrders.end()) {
+    session->sendCancelReject(clOrdId, origClOrdId, "Unknown order");
+    return;
+  }
+
+  std::string bookId = clientIt->second;
+  auto restingIt = state.resting.find(bookId);
+  state.book->cancelOrder(bookId);
+  state.clientOrders.erase(clientIt);
+  if (restingIt == state.resting.end()) {
+    session->sendCancelReject(clOrdId, origClOrdId, "Unknown order");
+    return;
+  }
+
+  const RestingOrder& resting = restingIt->second;
+  Report report;
+  report.clOrdId = clOrdId;
+  report.origClOrdId = origClOrdId;
+  report.orderId = bookId;
+  report.symbol = symbol;
+  report.side = resting.side;
+  report.execType = '4';
+  report.ordStatus = '4';
+  report.orderQty = resting.quantity;
+  report.price = resting.price;
+  report.cumQty = resting.cumQty;
+  report.avgPx = resting.cumQty > 0.0 ? resting.notional / resting.cumQty : 0.0;
+  session->sendExecutionReport(report);
+  state.resting.erase(restingIt);
+
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  m_stats.cancels++;
+}
+
+} // namespace mock
+} // namespace exchange
+} // namespace pinnacle
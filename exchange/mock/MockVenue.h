@@ -0,0 +1,217 @@
+#pragma once
+
+#include "../../core/orderbook/OrderBook.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace mock {
+
+/**
+ * @brief Configuration of one mock venue
+ */
+struct MockVenueConfig {
+  std::string name{"MOCK"};
+  std::vector<std::string> symbols{"BTC-USD"};
+
+  // Listening endpoints; port 0 picks a free port (see MockVenue::wsPort)
+  std::string host{"127.0.0.1"};
+  uint16_t wsPort{0};
+  uint16_t fixPort{0};
+
+  // Synthetic liquidity: a ladder of maker orders around a random-walk mid,
+  // requoted every tickInterval
+  double initialMid{50000.0};
+  double halfSpread{0.5};
+  double levelSpacing{0.5};
+  double levelQuantity{1.0};
+  size_t bookLevels{10};
+  double volatility{1.0}; // Standard deviation of the mid move per tick
+  std::chrono::microseconds tickInterval{1000};
+
+  // Artificial delay added to every order response and market data message:
+  // latency plus a uniform draw in [0, jitter]
+  std::chrono::microseconds latency{0};
+  std::chrono::microseconds jitter{0};
+
+  // Probability that a new order is rejected, and that an aggressive order
+  // only fills a random fraction of what the book could give it
+  double rejectRate{0.0};
+  double partialFillRate{0.0};
+
+  uint64_t seed{42};
+};
+
+/**
+ * @brief Counters exposed for tests and benchmarks
+ */
+struct MockVenueStats {
+  uint64_t ordersReceived{0};
+  uint64_t ordersRejected{0};
+  uint64_t fills{0};
+  uint64_t cancels{0};
+  uint64_t marketDataMessages{0};
+};
+
+/**
+ * @class MockVenue
+ * @brief Loopback stand-in for an exchange
+ *
+ * Serves market data over plain WebSocket in the Coinbase Advanced Trade
+ * dialect (ticker and level2 channels, the same messages
+ * WebSocketMarketDataFeed parses) and order entry over a FIX 4.4 session
+ * (Logon, NewOrderSingle, OrderCancelRequest, TestRequest, Logout).
+ *
+ * Each symbol is backed by a real OrderBook. Orders cross the book up to
+ * their limit price; IOC and market remainders are canceled and day
+ * limits rest until canceled or crossed by a later requote. All sockets,
+ * timers and books are driven by one I/O thread.
+ */
+class MockVenue {
+public:
+  explicit MockVenue(MockVenueConfig config);
+  ~MockVenue();
+
+  MockVenue(const MockVenue&) = delete;
+  MockVenue& operator=(const MockVenue&) = delete;
+
+  /**
+   * @brief Bind both listeners and start serving
+   *
+   * @return false if either port cannot be bound
+   */
+  bool start();
+
+  void stop();
+
+  bool isRunning() const { return m_running.load(); }
+
+  /**
+   * @brief Bound ports, valid after start()
+   */
+  uint16_t wsPort() const { return m_wsPort; }
+  uint16_t fixPort() const { return m_fixPort; }
+
+  const MockVenueConfig& config() const { return m_config; }
+
+  MockVenueStats getStats() const;
+
+private:
+  class WsSession;
+  class FixSession;
+
+  /**
+   * @brief An order resting in a symbol's book
+   *
+   * Client orders keep their session so fills against them can be reported;
+   * maker orders have none.
+   */
+  struct RestingOrder {
+    std::weak_ptr<FixSession> session;
+    std::string clOrdId;
+    OrderSide side{OrderSide::BUY};
+    double price{0.0};
+    double quantity{0.0};
+    double cumQty{0.0};
+    double notional{0.0};
+  };
+
+  struct SymbolState {
+    std::unique_ptr<OrderBook> book;
+    double mid{0.0};
+    double lastPrice{0.0};
+    double volume{0.0};
+    std::vector<std::string> makerOrders;
+    std::unordered_map<std::string, RestingOrder> resting; // By book id
+    std::unordered_map<std::string, std::string> clientOrders; // ClOrdID -> id
+    std::vector<std::pair<double, double>> publishedBids;
+    std::vector<std::pair<double, double>> publishedAsks;
+  };
+
+  struct Fill {
+    std::string bookId;
+    double price{0.0};
+    double quantity{0.0};
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  // Accept loops
+  void acceptWebSocket();
+  void acceptFix();
+
+  // Market data
+  void scheduleTick();
+  void onTick();
+  void requote(const std::string& symbol, SymbolState& state);
+  std::string tickerMessage(const std::string& symbol,
+                            const SymbolState& state, uint64_t timestamp);
+  std::string level2Message(const std::string& symbol, SymbolState& state,
+                            uint64_t timestamp, bool snapshot);
+  void publish(std::shared_ptr<const std::string> message,
+               const std::string& channel, const std::string& symbol);
+  void sendSnapshot(const std::shared_ptr<WsSession>& session,
+                    const std::string& symbol);
+
+  // Order entry
+  void handleNewOrder(const std::shared_ptr<FixSession>& session,
+                      std::string clOrdId, std::string symbol, OrderSide side,
+                      char ordType, char timeInForce, double price,
+                      double quantity);
+  void handleCancel(const std::shared_ptr<FixSession>& session,
+                    const std::string& clOrdId,
+                    const std::string& origClOrdId,
+                    const std::string& symbol);
+  std::vector<Fill> cross(SymbolState& state, OrderSide side, double limit,
+                          double quantity);
+  void reportPassiveFills(SymbolState& state, const std::string& symbol,
+                          const std::vector<Fill>& fills);
+
+  /**
+   * @brief Run an action after the configured latency and jitter
+   *
+   * Due times never go backwards, so delayed messages keep their order.
+   */
+  template <typename Fn> void afterDelay(Fn&& action);
+
+  std::string nextOrderId(char prefix);
+
+  MockVenueConfig m_config;
+  boost::asio::io_context m_io;
+  boost::asio::ip::tcp::acceptor m_wsAcceptor;
+  boost::asio::ip::tcp::acceptor m_fixAcceptor;
+  boost::asio::steady_timer m_tickTimer;
+  std::thread m_thread;
+  std::atomic<bool> m_running{false};
+  uint16_t m_wsPort{0};
+  uint16_t m_fixPort{0};
+
+  // Owned by the I/O thread
+  std::unordered_map<std::string, SymbolState> m_symbols;
+  std::vector<std::weak_ptr<WsSession>> m_wsSessions;
+  std::mt19937_64 m_rng;
+  Clock::time_point m_lastDue;
+  Clock::time_point m_nextTick;
+  uint64_t m_orderIdCounter{0};
+
+  mutable std::mutex m_statsMutex;
+  MockVenueStats m_stats;
+};
+
+} // namespace mock
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,437 @@
+#include "MockVenueClient.h"
+#include "../../core/utils/TimeUtils.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <poll.h>
+#include <sys/socket.h>
+
+namespace pinnacle {
+namespace exchange {
+namespace mock {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * @brief Parse an RFC 3339 UTC timestamp into nanoseconds since the epoch
+ *
+ * @return 0 if the text is not of the form YYYY-MM-DDTHH:MM:SS[.frac]Z
+ */
+uint64_t parseIsoTimestamp(const std::string& text) {
+  int year, month, day, hour, minute, second, consumed = 0;
+  if (std::sscanf(text.c_str(), "%d-%d-%dT%d:%d:%d%n", &year, &month, &day,
+                  &hour, &minute, &second, &consumed) != 6) {
+    return 0;
+  }
+
+  using namespace std::chrono;
+  sys_days date = year_month_day{std::chrono::year(year),
+                                 std::chrono::month(month),
+                                 std::chrono::day(day)};
+  auto time = date + hours(hour) + minutes(minute) + seconds(second);
+
+  // Up to nine fractional digits
+  uint64_t fraction = 0;
+  size_t position = static_cast<size_t>(consumed);
+  if (position < text.size() && text[position] == '.') {
+    int digits = 0;
+    for (++position; position < text.size() &&
+                     std::isdigit(static_cast<unsigned char>(text[position]));
+         ++position) {
+      if (digits < 9) {
+        fraction = fraction * 10 + (text[position] - '0');
+        ++digits;
+      }
+    }
+    for (; digits < 9; ++digits) {
+      fraction *= 10;
+    }
+  }
+
+  return static_cast<uint64_t>(
+             duration_cast<nanoseconds>(time.time_since_epoch()).count()) +
+         fraction;
+}
+
+double number(const json& object, const char* key) {
+  auto it = object.find(key);
+  if (it == object.end()) {
+    return 0.0;
+  }
+  return it->is_string() ? std::stod(it->get<std::string>())
+                         : it->get<double>();
+}
+
+OrderStatus toOrderStatus(char ordStatus) {
+  switch (ordStatus) {
+  case '1':
+    return OrderStatus::PARTIALLY_FILLED;
+  case '2':
+    return OrderStatus::FILLED;
+  case '4':
+    return OrderStatus::CANCELED;
+  case '8':
+    return OrderStatus::REJECTED;
+  case 'C':
+    return OrderStatus::EXPIRED;
+  default:
+    return OrderStatus::NEW;
+  }
+}
+
+} // namespace
+
+MockVenueClient::MockVenueClient(std::string venue)
+    : m_venue(std::move(venue)), m_work(asio::make_work_guard(m_io)),
+      m_ws(m_io), m_fix(m_io) {
+  m_thread = std::thread([this]() { m_io.run(); });
+}
+
+MockVenueClient::~MockVenueClient() { disconnect(); }
+
+void MockVenueClient::setTickCallback(TickCallback callback) {
+  m_tickCallback = std::move(callback);
+}
+
+void MockVenueClient::setDepthCallback(DepthCallback callback) {
+  m_depthCallback = std::move(callback);
+}
+
+void MockVenueClient::setExecutionReportCallback(
+    ExecutionReportCallback callback) {
+  m_executionReportCallback = std::move(callback);
+}
+
+// ============================================================================
+// Market data
+// ============================================================================
+
+bool MockVenueClient::connectMarketData(const std::string& host, uint16_t port,
+                                        const std::vector<std::string>& symbols,
+                                        bool subscribeDepth) {
+  try {
+    auto& socket = beast::get_lowest_layer(m_ws);
+    socket.connect(tcp::endpoint(asio::ip::make_address(host), port));
+    socket.set_option(tcp::no_delay(true));
+    m_ws.handshake(host + ":" + std::to_string(port), "/");
+    m_ws.text(true);
+
+    std::vector<std::string> channels = {"ticker"};
+    if (subscribeDepth) {
+      channels.push_back("level2");
+    }
+    // One channel per subscription, as Coinbase Advanced Trade requires
+    for (const auto& channel : channels) {
+      json subscribe = {
+          {"type", "subscribe"}, {"product_ids", symbols}, {"channel", channel}};
+      m_ws.write(asio::buffer(subscribe.dump()));
+    }
+  } catch (const boost::system::system_error& e) {
+    spdlog::error("MockVenueClient {}: market data connect failed: {}",
+                  m_venue, e.what());
+    return false;
+  }
+
+  asio::post(m_io, [this]() { readMarketData(); });
+  return true;
+}
+
+void MockVenueClient::readMarketData() {
+  m_ws.async_read(m_wsBuffer, [this](beast::error_code ec, size_t) {
+    if (ec) {
+      return;
+    }
+    uint64_t receivedAt = utils::TimeUtils::getCurrentNanos();
+    onMarketData(beast::buffers_to_string(m_wsBuffer.data()), receivedAt);
+    m_wsBuffer.consume(m_wsBuffer.size());
+    readMarketData();
+  });
+}
+
+void MockVenueClient::onMarketData(const std::string& text,
+                                   uint64_t receivedAt) {
+  json message = json::parse(text, nullptr, false);
+  if (message.is_discarded() || !message.contains("events")) {
+    return;
+  }
+
+  std::string channel = message.value("channel", "");
+  uint64_t timestamp = parseIsoTimestamp(message.value("timestamp", ""));
+
+  if (channel == "ticker") {
+    for (const auto& event : message["events"]) {
+      if (!event.contains("tickers")) {
+        continue;
+      }
+      for (const auto& ticker : event["tickers"]) {
+        MockVenueTick tick;
+        tick.symbol = ticker.value("product_id", "");
+        tick.bidPrice = number(ticker, "best_bid");
+        tick.bidSize = number(ticker, "best_bid_quantity");
+        tick.askPrice = number(ticker, "best_ask");
+        tick.askSize = number(ticker, "best_ask_quantity");
+        tick.lastPrice = number(ticker, "price");
+        tick.volume = number(ticker, "volume_24_h");
+        tick.exchangeTimestamp = timestamp;
+        tick.receivedAt = receivedAt;
+        if (m_tickCallback) {
+          m_tickCallback(tick);
+        }
+      }
+    }
+  } else if (channel == "l2_data") {
+    for (const auto& event : message["events"]) {
+      std::string symbol = event.value("product_id", "");
+      Book& book = m_books[symbol];
+      if (event.value("type", "") == "snapshot") {
+        book.bids.clear();
+        book.asks.clear();
+      }
+
+      for (const auto& update : event.value("updates", json::array())) {
+        double price = number(update, "price_level");
+        double quantity = number(update, "new_quantity");
+        bool isBid = update.value("side", "") == "bid";
+        if (quantity > 0.0) {
+          (isBid ? book.bids[price] : book.asks[price]) = quantity;
+        } else if (isBid) {
+          book.bids.erase(price);
+        } else {
+          book.asks.erase(price);
+        }
+      }
+
+      if (m_depthCallback) {
+        MockVenueDepth depth;
+        depth.symbol = symbol;
+        for (const auto& [price, quantity] : book.bids) {
+          depth.bidPrices.push_back(price);
+          depth.bidSizes.push_back(quantity);
+        }
+        for (const auto& [price, quantity] : book.asks) {
+          depth.askPrices.push_back(price);
+          depth.askSizes.push_back(quantity);
+        }
+        depth.exchangeTimestamp = timestamp;
+        depth.receivedAt = receivedAt;
+        m_depthCallback(depth);
+      }
+    }
+  }
+}
+
+// ============================================================================
+// Order entry
+// ============================================================================
+
+bool MockVenueClient::connectOrderEntry(const std::string& host, uint16_t port,
+                                        const std::string& senderCompId,
+                                        std::chrono::milliseconds logonTimeout) {
+  try {
+    m_fix.connect(tcp::endpoint(asio::ip::make_address(host), port));
+    m_fix.set_option(tcp::no_delay(true));
+  } catch (const boost::system::system_error& e) {
+    spdlog::error("MockVenueClient {}: order entry connect failed: {}",
+                  m_venue, e.what());
+    return false;
+  }
+
+  asio::post(m_io, [this]() { readOrderEntry(); });
+
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_senderCompId = senderCompId;
+    m_fixConnected = true;
+    m_builder
+        .begin("A", m_senderCompId, m_venue, m_outSeq++,
+               utils::TimeUtils::getWallClockNanos())
+        .field(fix::tag::EncryptMethod, '0')
+        .field(fix::tag::HeartBtInt, int64_t{30})
+        .field(fix::tag::ResetSeqNumFlag, 'Y');
+    if (!writeFix(m_builder.finish())) {
+      return false;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(m_logonMutex);
+  return m_logonCondition.wait_for(lock, logonTimeout,
+                                   [this]() { return m_loggedOn; });
+}
+
+uint64_t MockVenueClient::sendNewOrder(const std::string& clOrdId,
+                                       const std::string& symbol,
+                                       OrderSide side, OrderType type,
+                                       double price, double quantity) {
+  char ordType = type == OrderType::MARKET ? '1' : '2';
+  char timeInForce = '0';
+  if (type == OrderType::MARKET || type == OrderType::IOC) {
+    timeInForce = '3';
+  } else if (type == OrderType::FOK) {
+    timeInForce = '4';
+  }
+
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  if (!m_fixConnected) {
+    return 0;
+  }
+
+  m_builder
+      .begin("D", m_senderCompId, m_venue, m_outSeq++,
+             utils::TimeUtils::getWallClockNanos())
+      .field(fix::tag::ClOrdID, clOrdId)
+      .field(fix::tag::Symbol, symbol)
+      .field(fix::tag::Side, side == OrderSide::BUY ? '1' : '2')
+      .field(fix::tag::OrderQty, quantity)
+      .field(fix::tag::OrdType, ordType);
+  if (ordType == '2') {
+    m_builder.field(fix::tag::Price, price);
+  }
+  m_builder.field(fix::tag::TimeInForce, timeInForce)
+      .timestampField(fix::tag::TransactTime,
+                      utils::TimeUtils::getWallClockNanos());
+
+  std::string_view message = m_builder.finish();
+  uint64_t sentAt = utils::TimeUtils::getCurrentNanos();
+  return writeFix(message) ? sentAt : 0;
+}
+
+bool MockVenueClient::sendCancel(const std::string& clOrdId,
+                                 const std::string& origClOrdId,
+                                 const std::string& symbol, OrderSide side) {
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  if (!m_fixConnected) {
+    return false;
+  }
+
+  m_builder
+      .begin("F", m_senderCompId, m_venue, m_outSeq++,
+             utils::TimeUtils::getWallClockNanos())
+      .field(fix::tag::ClOrdID, clOrdId)
+      .field(fix::tag::OrigClOrdID, origClOrdId)
+      .field(fix::tag::Symbol, symbol)
+      .field(fix::tag::Side, side == OrderSide::BUY ? '1' : '2')
+      .timestampField(fix::tag::TransactTime,
+                      utils::TimeUtils::getWallClockNanos());
+  return writeFix(m_builder.finish());
+}
+
+bool MockVenueClient::writeFix(std::string_view message) {
+  // Called with m_sendMutex held. Writing through the descriptor keeps the
+  // send on the caller's thread while the I/O thread owns the asio reads;
+  // the descriptor is non-blocking once those reads start.
+  int fd = m_fix.native_handle();
+  while (!message.empty()) {
+    ssize_t written = ::send(fd, message.data(), message.size(), MSG_NOSIGNAL);
+    if (written > 0) {
+      message.remove_prefix(static_cast<size_t>(written));
+    } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      pollfd pending{fd, POLLOUT, 0};
+      ::poll(&pending, 1, 100);
+    } else if (written < 0 && errno == EINTR) {
+      continue;
+    } else {
+      m_fixConnected = false;
+      return false;
+    }
+  }
+  return true;
+}
+
+void MockVenueClient::readOrderEntry() {
+  m_fix.async_read_some(
+      asio::buffer(m_fixChunk), [this](beast::error_code ec, size_t bytes) {
+        if (ec) {
+          return;
+        }
+        uint64_t receivedAt = utils::TimeUtils::getCurrentNanos();
+        m_fixInbound.append(m_fixChunk.data(), bytes);
+
+        size_t consumed = 0;
+        std::string_view inbound(m_fixInbound);
+        while (size_t length =
+                   fix::fixFrameLength(inbound.substr(consumed))) {
+          if (m_inboundView.parse(inbound.substr(consumed, length))) {
+            onFixMessage(m_inboundView, receivedAt);
+          }
+          consumed += length;
+        }
+        m_fixInbound.erase(0, consumed);
+        readOrderEntry();
+      });
+}
+
+void MockVenueClient::onFixMessage(const fix::FixMessageView& message,
+                                   uint64_t receivedAt) {
+  std::string_view type = message.msgType();
+
+  if (type == "8") {
+    MockExecutionReport report;
+    report.clOrdId = std::string(message.get(fix::tag::ClOrdID));
+    report.orderId = std::string(message.get(fix::tag::OrderID));
+    report.execType = message.getChar(fix::tag::ExecType);
+    report.status = toOrderStatus(message.getChar(fix::tag::OrdStatus));
+    report.cumQty = message.getDouble(fix::tag::CumQty);
+    report.leavesQty = message.getDouble(fix::tag::LeavesQty);
+    report.lastQty = message.getDouble(fix::tag::LastQty);
+    report.lastPx = message.getDouble(fix::tag::LastPx);
+    report.avgPx = message.getDouble(fix::tag::AvgPx);
+    report.text = std::string(message.get(fix::tag::Text));
+    report.receivedAt = receivedAt;
+    if (m_executionReportCallback) {
+      m_executionReportCallback(report);
+    }
+  } else if (type == "A") {
+    std::lock_guard<std::mutex> lock(m_logonMutex);
+    m_loggedOn = true;
+    m_logonCondition.notify_all();
+  } else if (type == "1") {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_builder
+        .begin("0", m_senderCompId, m_venue, m_outSeq++,
+               utils::TimeUtils::getWallClockNanos())
+        .field(fix::tag::TestReqID, message.get(fix::tag::TestReqID));
+    writeFix(m_builder.finish());
+  } else if (type == "9") {
+    spdlog::warn("MockVenueClient {}: cancel rejected for {}: {}", m_venue,
+                 message.get(fix::tag::OrigClOrdID),
+                 message.get(fix::tag::Text));
+  }
+}
+
+void MockVenueClient::disconnect() {
+  if (!m_thread.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (m_fixConnected) {
+      m_builder.begin("5", m_senderCompId, m_venue, m_outSeq++,
+                      utils::TimeUtils::getWallClockNanos());
+      writeFix(m_builder.finish());
+      m_fixConnected = false;
+    }
+  }
+
+  asio::post(m_io, [this]() {
+    beast::error_code ignored;
+    beast::get_lowest_layer(m_ws).close(ignored);
+    m_fix.close(ignored);
+  });
+  m_work.reset();
+  m_thread.join();
+}
+
+} // namespace mock
+} // namespace exchange
+} // namespace pinnacle
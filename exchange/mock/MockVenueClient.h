@@ -0,0 +1,194 @@
+#pragma once
+
+#include "../../core/orderbook/Order.h"
+#include "../fix/FixWire.h"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+namespace mock {
+
+/**
+ * @brief Top of book from a venue's ticker channel
+ *
+ * exchangeTimestamp is the venue's send time in wall-clock nanoseconds;
+ * receivedAt is TimeUtils::getCurrentNanos() when the message was parsed.
+ */
+struct MockVenueTick {
+  std::string symbol;
+  double bidPrice{0.0};
+  double bidSize{0.0};
+  double askPrice{0.0};
+  double askSize{0.0};
+  double lastPrice{0.0};
+  double volume{0.0};
+  uint64_t exchangeTimestamp{0};
+  uint64_t receivedAt{0};
+};
+
+/**
+ * @brief L2 book after applying a level2 message, best level first
+ */
+struct MockVenueDepth {
+  std::string symbol;
+  std::vector<double> bidPrices;
+  std::vector<double> bidSizes;
+  std::vector<double> askPrices;
+  std::vector<double> askSizes;
+  uint64_t exchangeTimestamp{0};
+  uint64_t receivedAt{0};
+};
+
+/**
+ * @brief Decoded FIX ExecutionReport
+ */
+struct MockExecutionReport {
+  std::string clOrdId;
+  std::string orderId;
+  char execType{'0'};
+  OrderStatus status{OrderStatus::NEW};
+  double cumQty{0.0};
+  double leavesQty{0.0};
+  double lastQty{0.0};
+  double lastPx{0.0};
+  double avgPx{0.0};
+  std::string text;
+  uint64_t receivedAt{0};
+};
+
+/**
+ * @class MockVenueClient
+ * @brief Market data and order entry client for one MockVenue
+ *
+ * Speaks the same dialects the venue serves: Coinbase-style WebSocket
+ * market data and a FIX 4.4 order session. Inbound messages are decoded on
+ * the client's I/O thread, which also runs the callbacks; register them
+ * before connecting. Orders are written straight to the socket from the
+ * calling thread so the send timestamp is the wire time.
+ */
+class MockVenueClient {
+public:
+  using TickCallback = std::function<void(const MockVenueTick&)>;
+  using DepthCallback = std::function<void(const MockVenueDepth&)>;
+  using ExecutionReportCallback =
+      std::function<void(const MockExecutionReport&)>;
+
+  explicit MockVenueClient(std::string venue);
+  ~MockVenueClient();
+
+  MockVenueClient(const MockVenueClient&) = delete;
+  MockVenueClient& operator=(const MockVenueClient&) = delete;
+
+  void setTickCallback(TickCallback callback);
+  void setDepthCallback(DepthCallback callback);
+  void setExecutionReportCallback(ExecutionReportCallback callback);
+
+  /**
+   * @brief Connect to the venue's WebSocket and subscribe to ticker and,
+   * optionally, level2 for each symbol
+   */
+  bool connectMarketData(const std::string& host, uint16_t port,
+                         const std::vector<std::string>& symbols,
+                         bool subscribeDepth = true);
+
+  /**
+   * @brief Connect and log on to the venue's FIX session
+   *
+   * Blocks until the venue answers the Logon or the timeout expires.
+   */
+  bool connectOrderEntry(
+      const std::string& host, uint16_t port,
+      const std::string& senderCompId = "PINNACLE",
+      std::chrono::milliseconds logonTimeout = std::chrono::seconds(2));
+
+  /**
+   * @brief Send a NewOrderSingle
+   *
+   * MARKET orders are sent as market IOC, IOC and FOK as limit with that
+   * time in force, and everything else as a day limit.
+   *
+   * @return TimeUtils::getCurrentNanos() just before the write, or 0 if
+   * the session is down
+   */
+  uint64_t sendNewOrder(const std::string& clOrdId, const std::string& symbol,
+                        OrderSide side, OrderType type, double price,
+                        double quantity);
+
+  /**
+   * @brief Send an OrderCancelRequest
+   */
+  bool sendCancel(const std::string& clOrdId, const std::string& origClOrdId,
+                  const std::string& symbol, OrderSide side);
+
+  void disconnect();
+
+  const std::string& venue() const { return m_venue; }
+
+private:
+  using WebSocket = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+
+  struct Book {
+    std::map<double, double, std::greater<double>> bids;
+    std::map<double, double> asks;
+  };
+
+  void readMarketData();
+  void onMarketData(const std::string& text, uint64_t receivedAt);
+  void readOrderEntry();
+  void onFixMessage(const fix::FixMessageView& message, uint64_t receivedAt);
+  bool writeFix(std::string_view message);
+
+  std::string m_venue;
+
+  boost::asio::io_context m_io;
+  std::optional<boost::asio::executor_work_guard<
+      boost::asio::io_context::executor_type>>
+      m_work;
+  std::thread m_thread;
+
+  WebSocket m_ws;
+  boost::beast::flat_buffer m_wsBuffer;
+  std::unordered_map<std::string, Book> m_books; // I/O thread only
+
+  boost::asio::ip::tcp::socket m_fix;
+  std::array<char, 4096> m_fixChunk;
+  std::string m_fixInbound;
+  fix::FixMessageView m_inboundView;
+
+  // Outbound FIX state, shared by every sending thread
+  std::mutex m_sendMutex;
+  fix::FixMessageBuilder m_builder;
+  std::string m_senderCompId;
+  uint64_t m_outSeq{1};
+  bool m_fixConnected{false};
+
+  std::mutex m_logonMutex;
+  std::condition_variable m_logonCondition;
+  bool m_loggedOn{false};
+
+  TickCallback m_tickCallback;
+  DepthCallback m_depthCallback;
+  ExecutionReportCallback m_executionReportCallback;
+};
+
+} // namespace mock
+} // namespace exchange
+} // namespace pinnacle
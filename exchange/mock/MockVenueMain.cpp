@@ -0,0 +1,108 @@
+#include "MockVenue.h"
+
+#include <boost/program_options.hpp>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+namespace po = boost::program_options;
+using namespace pinnacle::exchange::mock;
+
+namespace {
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) { g_running.store(false); }
+} // namespace
+
+// Runs one MockVenue until interrupted. Start several on different ports to
+// stand in for a multi-venue setup on one machine.
+int main(int argc, char* argv[]) {
+  std::signal(SIGINT, signalHandler);
+  std::signal(SIGTERM, signalHandler);
+
+  MockVenueConfig config;
+  int64_t latencyMicros = 0;
+  int64_t jitterMicros = 0;
+  int64_t tickMicros = 1000;
+
+  po::options_description desc("Mock venue options");
+  desc.add_options()("help", "Show help message")(
+      "name", po::value<std::string>(&config.name)->default_value("MOCK"),
+      "Venue name, also the FIX SenderCompID")(
+      "symbols",
+      po::value<std::vector<std::string>>(&config.symbols)
+          ->multitoken()
+          ->default_value({"BTC-USD"}, "BTC-USD"),
+      "Symbols to list")(
+      "host", po::value<std::string>(&config.host)->default_value("127.0.0.1"),
+      "Listen address")("ws-port",
+                        po::value<uint16_t>(&config.wsPort)->default_value(0),
+                        "WebSocket market data port (0 = any)")(
+      "fix-port", po::value<uint16_t>(&config.fixPort)->default_value(0),
+      "FIX order entry port (0 = any)")(
+      "mid", po::value<double>(&config.initialMid)->default_value(50000.0),
+      "Initial mid price")(
+      "volatility", po::value<double>(&config.volatility)->default_value(1.0),
+      "Mid move standard deviation per tick")(
+      "levels", po::value<size_t>(&config.bookLevels)->default_value(10),
+      "Maker levels per side")(
+      "level-quantity",
+      po::value<double>(&config.levelQuantity)->default_value(1.0),
+      "Maker quantity per level")(
+      "tick-us", po::value<int64_t>(&tickMicros)->default_value(1000),
+      "Requote and publish interval in microseconds")(
+      "latency-us", po::value<int64_t>(&latencyMicros)->default_value(0),
+      "Added delay per response in microseconds")(
+      "jitter-us", po::value<int64_t>(&jitterMicros)->default_value(0),
+      "Uniform extra delay bound in microseconds")(
+      "reject-rate", po::value<double>(&config.rejectRate)->default_value(0.0),
+      "Probability of rejecting a new order")(
+      "partial-rate",
+      po::value<double>(&config.partialFillRate)->default_value(0.0),
+      "Probability of capping an order's fill")(
+      "seed", po::value<uint64_t>(&config.seed)->default_value(42),
+      "Random seed");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << e.what() << "\n" << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+
+  config.latency = std::chrono::microseconds(latencyMicros);
+  config.jitter = std::chrono::microseconds(jitterMicros);
+  config.tickInterval = std::chrono::microseconds(tickMicros);
+
+  MockVenue venue(config);
+  if (!venue.start()) {
+    return 1;
+  }
+
+  // Machine-readable line for scripts that start venues on port 0
+  std::cout << "READY " << config.name << " ws=" << venue.wsPort()
+            << " fix=" << venue.fixPort() << std::endl;
+
+  while (g_running.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  venue.stop();
+  MockVenueStats stats = venue.getStats();
+  spdlog::info("MockVenue {} stopped: orders={} rejected={} fills={} "
+               "cancels={} md={}",
+               config.name, stats.ordersReceived, stats.ordersRejected,
+               stats.fills, stats.cancels, stats.marketDataMessages);
+  return 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class EventScheduler
+ * @brief Discrete-event scheduler over a simulated clock
+ *
+ * Events run in time order, and events due at the same time in the order
+ * they were scheduled, so a run is reproducible. The clock jumps from one
+ * event to the next, so a simulation runs as fast as its events can be
+ * handled; pacing it to the wall clock is left to the caller.
+ *
+ * Not thread-safe: a scheduler is owned and run by a single thread.
+ *
+ * @tparam T Payload delivered to the event handler
+ */
+template <typename T> class EventScheduler {
+public:
+  explicit EventScheduler(uint64_t startNanos = 0) : m_now(startNanos) {}
+
+  /**
+   * @brief Schedule an event; one in the past runs at the current time
+   */
+  void schedule(uint64_t atNanos, T payload) {
+    m_events.push_back({std::max(atNanos, m_now), m_sequence++,
+                        std::move(payload)});
+    std::push_heap(m_events.begin(), m_events.end(), Later{});
+  }
+
+  /**
+   * @brief Run every event due up to and including the given time, then
+   * move the clock there
+   *
+   * Handlers may schedule further events; those due in time run too.
+   *
+   * @param onEvent Callable invoked as onEvent(T&&) for each event
+   * @return Number of events run
+   */
+  template <typename Callback>
+  size_t runUntil(uint64_t untilNanos, Callback&& onEvent) {
+    size_t ran = 0;
+    while (!m_events.empty() && m_events.front().time <= untilNanos) {
+      runNext(onEvent);
+      ++ran;
+    }
+    m_now = std::max(m_now, untilNanos);
+    return ran;
+  }
+
+  /**
+   * @brief Run the earliest event, moving the clock to its time
+   *
+   * @return false if no event was pending
+   */
+  template <typename Callback> bool runNext(Callback&& onEvent) {
+    if (m_events.empty()) {
+      return false;
+    }
+    std::pop_heap(m_events.begin(), m_events.end(), Later{});
+    Event event = std::move(m_events.back());
+    m_events.pop_back();
+    m_now = event.time;
+    onEvent(std::move(event.payload));
+    return true;
+  }
+
+  /**
+   * @brief Current simulated time in nanoseconds
+   */
+  uint64_t now() const { return m_now; }
+
+  /**
+   * @brief Time of the earliest pending event; only valid when not empty
+   */
+  uint64_t nextTime() const { return m_events.front().time; }
+
+  size_t size() const { return m_events.size(); }
+  bool empty() const { return m_events.empty(); }
+
+  /**
+   * @brief Drop every pending event, keeping the clock
+   */
+  void clear() { m_events.clear(); }
+
+private:
+  struct Event {
+    uint64_t time;
+    uint64_t sequence;
+    T payload;
+  };
+
+  // Max-heap comparator putting the earliest event on top
+  struct Later {
+    bool operator()(const Event& a, const Event& b) const {
+      return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+  };
+
+  std::vector<Event> m_events;
+  uint64_t m_now;
+  uint64_t m_sequence{0};
+};
+
+} // namespace exchange
+} // namespace pinnacle
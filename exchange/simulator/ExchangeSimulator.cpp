@@ -4,15 +4,30 @@
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <sstream>
 
 namespace pinnacle {
 namespace exchange {
 
+namespace {
+
+constexpr uint64_t PRICE_TICK_NANOS = 100'000'000;
+constexpr uint64_t BOOK_TICK_NANOS = 500'000'000;
+
+// Events run between releases of the lock when running unpaced
+constexpr size_t UNPACED_BATCH = 1024;
+
+constexpr size_t ALL_LEVELS = std::numeric_limits<size_t>::max();
+
+void runEvent(std::function<void()>&& event) { event(); }
+
+} // namespace
+
 ExchangeSimulator::ExchangeSimulator(std::shared_ptr<OrderBook> orderBook)
-    : m_orderBook(orderBook), m_rng(std::random_device()()),
-      m_priceDistribution(0.0, 1.0) {
+    : m_orderBook(orderBook), m_scheduler(utils::TimeUtils::getCurrentNanos()),
+      m_rng(std::random_device()()), m_priceDistribution(0.0, 1.0) {
 
   // Initialize market price
   if (m_orderBook) {
@@ -46,15 +61,17 @@ bool ExchangeSimulator::start() {
   // Reset stop flag
   m_shouldStop.store(false, std::memory_order_release);
 
-  // Start threads
-  m_mainThread = std::thread(&ExchangeSimulator::mainLoop, this);
-  m_participantThread = std::thread(&ExchangeSimulator::participantLoop, this);
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    scheduleRecurringEvents();
+    m_wallStart = std::chrono::steady_clock::now();
+    m_simulatedStart = m_scheduler.now();
+  }
 
-  // If we have a market data feed, start the market data thread
   if (m_marketDataFeed) {
-    m_marketDataThread = std::thread(&ExchangeSimulator::marketDataLoop, this);
     m_marketDataFeed->start();
   }
+  m_mainThread = std::thread(&ExchangeSimulator::mainLoop, this);
 
   // Mark as running
   m_isRunning.store(true, std::memory_order_release);
@@ -68,25 +85,20 @@ bool ExchangeSimulator::stop() {
     return false;
   }
 
-  // Set stop flag
-  m_shouldStop.store(true, std::memory_order_release);
+  // Set stop flag, under the lock so the simulator thread cannot miss it
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_shouldStop.store(true, std::memory_order_release);
+  }
+  m_wakeup.notify_all();
 
-  // Join threads
   if (m_mainThread.joinable()) {
     m_mainThread.join();
   }
 
-  if (m_participantThread.joinable()) {
-    m_participantThread.join();
-  }
-
   // Stop market data feed
   if (m_marketDataFeed && m_marketDataFeed->isRunning()) {
     m_marketDataFeed->stop();
-
-    if (m_marketDataThread.joinable()) {
-      m_marketDataThread.join();
-    }
   }
 
   // Mark as stopped
@@ -111,7 +123,7 @@ void ExchangeSimulator::addMarketParticipant(const std::string& type,
                                              double frequency,
                                              double volumeRatio) {
   // Lock for thread safety
-  std::lock_guard<std::mutex> lock(m_participantsMutex);
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
   // Create participant
   MarketParticipant participant;
@@ -124,147 +136,246 @@ void ExchangeSimulator::addMarketParticipant(const std::string& type,
   participant.activityDistribution =
       std::exponential_distribution<double>(frequency / 60.0);
 
-  // Set initial activity time
-  participant.nextActivityTime =
-      utils::TimeUtils::getCurrentSeconds() +
-      static_cast<uint64_t>(participant.activityDistribution(m_rng));
-
-  // Add to participants list
+  // Add to participants list; it first acts once the simulation runs
   m_participants.push_back(participant);
+  if (m_eventsScheduled) {
+    scheduleParticipant(m_participants.size() - 1);
+  }
+}
+
+void ExchangeSimulator::setLatency(const SimulatorLatency& latency) {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  m_orderEntry.setDistribution(latency.orderEntry);
+  m_acknowledgement.setDistribution(latency.acknowledgement);
+  m_marketData.setDistribution(latency.marketData);
+}
+
+void ExchangeSimulator::setSeed(uint64_t seed) {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  m_rng.seed(static_cast<std::mt19937::result_type>(seed));
+  m_priceDistribution.reset();
+}
+
+void ExchangeSimulator::setExecutionCallback(ExecutionCallback callback) {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  m_executionCallback = std::move(callback);
+}
+
+bool ExchangeSimulator::submitOrder(const std::string& orderId,
+                                    OrderSide side, double price,
+                                    double quantity) {
+  if (price <= 0.0 || quantity <= 0.0) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  if (!m_openOrders.emplace(orderId, side).second) {
+    return false;
+  }
+  uint64_t arrival = m_orderEntry.deliveryTime(currentTime(), m_rng);
+  m_scheduler.schedule(arrival, [this, orderId, side, price, quantity] {
+    onOrderArrival(orderId, side, price, quantity);
+  });
+  m_wakeup.notify_all();
+  return true;
+}
+
+bool ExchangeSimulator::cancelOrder(const std::string& orderId) {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  if (m_openOrders.find(orderId) == m_openOrders.end()) {
+    return false;
+  }
+  uint64_t arrival = m_orderEntry.deliveryTime(currentTime(), m_rng);
+  m_scheduler.schedule(arrival, [this, orderId] { onCancelArrival(orderId); });
+  m_wakeup.notify_all();
+  return true;
+}
+
+size_t ExchangeSimulator::runFor(uint64_t durationNanos) {
+  if (m_isRunning.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  scheduleRecurringEvents();
+  return m_scheduler.runUntil(m_scheduler.now() + durationNanos, runEvent);
+}
+
+uint64_t ExchangeSimulator::getSimulatedTime() const {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  return currentTime();
+}
+
+std::vector<QueuePositionModel::QueuedOrder>
+ExchangeSimulator::getQueuedOrders() const {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+  return m_queue.getOrders();
 }
 
 void ExchangeSimulator::mainLoop() {
-  // Main simulator loop
+  std::unique_lock<std::recursive_mutex> lock(m_mutex);
+
   while (!m_shouldStop.load(std::memory_order_acquire)) {
-    // Update market price
-    updateMarketPrice();
+    if (m_speed == 0.0) {
+      // Unpaced: run flat out, letting other threads in between batches
+      for (size_t i = 0; i < UNPACED_BATCH; ++i) {
+        if (!m_scheduler.runNext(runEvent)) {
+          m_wakeup.wait(lock);
+          break;
+        }
+      }
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+      continue;
+    }
+
+    m_scheduler.runUntil(currentTime(), runEvent);
+
+    // Sleep until the next event is due, or an order is sent
+    auto wakeAt = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    if (!m_scheduler.empty()) {
+      auto due = m_wallStart +
+                 std::chrono::nanoseconds(static_cast<int64_t>(
+                     static_cast<double>(m_scheduler.nextTime() -
+                                         m_simulatedStart) /
+                     m_speed));
+      wakeAt = std::min(wakeAt, due);
+    }
+    m_wakeup.wait_until(lock, wakeAt);
+  }
+}
 
-    // Sleep for a short interval
-    utils::TimeUtils::sleepForMillis(100);
+uint64_t ExchangeSimulator::currentTime() const {
+  if (!m_isRunning.load(std::memory_order_acquire) || m_speed == 0.0) {
+    return m_scheduler.now();
   }
+  double elapsed = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - m_wallStart)
+                       .count();
+  return std::max(m_scheduler.now(),
+                  m_simulatedStart + static_cast<uint64_t>(elapsed * m_speed));
 }
 
-void ExchangeSimulator::marketDataLoop() {
-  // Market data loop
-  while (!m_shouldStop.load(std::memory_order_acquire) && m_marketDataFeed) {
-    // Get current order book state
-    if (m_orderBook) {
-      std::shared_ptr<OrderBookSnapshot> snapshot = m_orderBook->getSnapshot();
+void ExchangeSimulator::scheduleRecurringEvents() {
+  if (m_eventsScheduled) {
+    return;
+  }
+  m_eventsScheduled = true;
 
-      if (snapshot) {
-        // Create order book update
-        OrderBookUpdate update;
-        update.symbol = m_orderBook->getSymbol();
-        update.timestamp = utils::TimeUtils::getCurrentNanos();
+  uint64_t now = m_scheduler.now();
+  m_scheduler.schedule(now + PRICE_TICK_NANOS, [this] { onPriceTick(); });
+  m_scheduler.schedule(now + BOOK_TICK_NANOS, [this] { onBookTick(); });
+  for (size_t i = 0; i < m_participants.size(); ++i) {
+    scheduleParticipant(i);
+  }
+}
 
-        // Extract bids and asks
-        const auto& bids = snapshot->getBids();
-        const auto& asks = snapshot->getAsks();
+void ExchangeSimulator::onPriceTick() {
+  updateMarketPrice();
+  m_scheduler.schedule(m_scheduler.now() + PRICE_TICK_NANOS,
+                       [this] { onPriceTick(); });
+}
 
-        // Add bids to update
-        for (const auto& level : bids) {
-          update.bids.emplace_back(level.price, level.totalQuantity);
-        }
+void ExchangeSimulator::onBookTick() {
+  if (m_orderBook && m_marketDataFeed) {
+    std::shared_ptr<OrderBookSnapshot> snapshot = m_orderBook->getSnapshot();
 
-        // Add asks to update
-        for (const auto& level : asks) {
-          update.asks.emplace_back(level.price, level.totalQuantity);
-        }
+    if (snapshot) {
+      // Create order book update
+      OrderBookUpdate update;
+      update.symbol = m_orderBook->getSymbol();
+      update.timestamp = m_scheduler.now();
 
-        // Publish update
-        m_marketDataFeed->publishOrderBookUpdate(update);
+      // Extract bids and asks
+      for (const auto& level : snapshot->getBids()) {
+        update.bids.emplace_back(level.price, level.totalQuantity);
+      }
+      for (const auto& level : snapshot->getAsks()) {
+        update.asks.emplace_back(level.price, level.totalQuantity);
       }
-    }
 
-    // Sleep for a short interval
-    utils::TimeUtils::sleepForMillis(500);
+      // Publish once it has crossed the network
+      m_scheduler.schedule(
+          m_marketData.deliveryTime(m_scheduler.now(), m_rng),
+          [this, update = std::move(update)] {
+            m_marketDataFeed->publishOrderBookUpdate(update);
+          });
+    }
   }
+  m_scheduler.schedule(m_scheduler.now() + BOOK_TICK_NANOS,
+                       [this] { onBookTick(); });
 }
 
-void ExchangeSimulator::participantLoop() {
-  // Participant activity loop
-  while (!m_shouldStop.load(std::memory_order_acquire)) {
-    uint64_t currentTime = utils::TimeUtils::getCurrentSeconds();
-
-    // Lock for thread safety
-    std::lock_guard<std::mutex> lock(m_participantsMutex);
-
-    // Check each participant
-    for (auto& participant : m_participants) {
-      // Check if it's time for activity
-      if (currentTime >= participant.nextActivityTime) {
-        // Perform activity based on participant type
-        if (participant.type == "taker") {
-          // Takers submit market orders
-          double quantity =
-              0.01 + (0.1 * participant.volumeRatio * (m_rng() % 10) / 10.0);
-          OrderSide side =
-              (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
-          simulateMarketOrder(side, quantity);
-        } else if (participant.type == "maker") {
-          // Makers submit limit orders
-          double quantity =
-              0.01 + (0.2 * participant.volumeRatio * (m_rng() % 10) / 10.0);
-          OrderSide side =
-              (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
-          double priceOffset = m_tickSize * (1 + m_rng() % 5);
-          double price;
-
-          if (side == OrderSide::BUY) {
-            price = m_lastPrice - priceOffset;
-          } else {
-            price = m_lastPrice + priceOffset;
-          }
-
-          simulateLimitOrder(side, roundToTickSize(price), quantity);
-        } else if (participant.type == "arbitrageur") {
-          // Arbitrageurs look for imbalances
-          double imbalance =
-              m_orderBook ? m_orderBook->calculateOrderBookImbalance(5) : 0.0;
-
-          if (std::abs(imbalance) > 0.3) {
-            // Trade against the imbalance
-            OrderSide side = (imbalance > 0) ? OrderSide::SELL : OrderSide::BUY;
-            double quantity =
-                0.05 + (0.2 * participant.volumeRatio * (m_rng() % 10) / 10.0);
-            simulateMarketOrder(side, quantity);
-          }
-        } else if (participant.type == "noise") {
-          // Noise traders randomly cancel orders or submit small orders
-          if (m_rng() % 3 == 0) {
-            simulateOrderCancellation();
-          } else {
-            double quantity = 0.001 + (0.01 * (m_rng() % 10) / 10.0);
-            OrderSide side =
-                (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
-
-            if (m_rng() % 2 == 0) {
-              simulateMarketOrder(side, quantity);
-            } else {
-              double priceOffset = m_tickSize * (1 + m_rng() % 10);
-              double price;
-
-              if (side == OrderSide::BUY) {
-                price = m_lastPrice - priceOffset;
-              } else {
-                price = m_lastPrice + priceOffset;
-              }
-
-              simulateLimitOrder(side, roundToTickSize(price), quantity);
-            }
-          }
+void ExchangeSimulator::scheduleParticipant(size_t index) {
+  // Activity is exponentially distributed, in seconds
+  double delay = m_participants[index].activityDistribution(m_rng);
+  m_scheduler.schedule(m_scheduler.now() + static_cast<uint64_t>(delay * 1e9),
+                       [this, index] { runParticipant(index); });
+}
+
+void ExchangeSimulator::runParticipant(size_t index) {
+  MarketParticipant& participant = m_participants[index];
+
+  // Perform activity based on participant type
+  if (participant.type == "taker") {
+    // Takers submit market orders
+    double quantity =
+        0.01 + (0.1 * participant.volumeRatio * (m_rng() % 10) / 10.0);
+    OrderSide side = (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+    simulateMarketOrder(side, quantity);
+  } else if (participant.type == "maker") {
+    // Makers submit limit orders
+    double quantity =
+        0.01 + (0.2 * participant.volumeRatio * (m_rng() % 10) / 10.0);
+    OrderSide side = (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+    double priceOffset = m_tickSize * (1 + m_rng() % 5);
+    double price;
+
+    if (side == OrderSide::BUY) {
+      price = m_lastPrice - priceOffset;
+    } else {
+      price = m_lastPrice + priceOffset;
+    }
+
+    simulateLimitOrder(side, roundToTickSize(price), quantity);
+  } else if (participant.type == "arbitrageur") {
+    // Arbitrageurs look for imbalances
+    double imbalance =
+        m_orderBook ? m_orderBook->calculateOrderBookImbalance(5) : 0.0;
+
+    if (std::abs(imbalance) > 0.3) {
+      // Trade against the imbalance
+      OrderSide side = (imbalance > 0) ? OrderSide::SELL : OrderSide::BUY;
+      double quantity =
+          0.05 + (0.2 * participant.volumeRatio * (m_rng() % 10) / 10.0);
+      simulateMarketOrder(side, quantity);
+    }
+  } else if (participant.type == "noise") {
+    // Noise traders randomly cancel orders or submit small orders
+    if (m_rng() % 3 == 0) {
+      simulateOrderCancellation();
+    } else {
+      double quantity = 0.001 + (0.01 * (m_rng() % 10) / 10.0);
+      OrderSide side = (m_rng() % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+
+      if (m_rng() % 2 == 0) {
+        simulateMarketOrder(side, quantity);
+      } else {
+        double priceOffset = m_tickSize * (1 + m_rng() % 10);
+        double price;
+
+        if (side == OrderSide::BUY) {
+          price = m_lastPrice - priceOffset;
+        } else {
+          price = m_lastPrice + priceOffset;
         }
 
-        // Schedule next activity
-        participant.nextActivityTime =
-            currentTime +
-            static_cast<uint64_t>(participant.activityDistribution(m_rng));
+        simulateLimitOrder(side, roundToTickSize(price), quantity);
       }
     }
-
-    // Sleep for a short interval
-    utils::TimeUtils::sleepForMillis(100);
   }
+
+  // Schedule next activity
+  scheduleParticipant(index);
 }
 
 void ExchangeSimulator::simulateMarketOrder(OrderSide side, double quantity) {
@@ -272,43 +383,18 @@ void ExchangeSimulator::simulateMarketOrder(OrderSide side, double quantity) {
     return;
   }
 
+  // The levels it will trade through, to price the fills
+  std::vector<PriceLevel> levels = side == OrderSide::BUY
+                                       ? m_orderBook->getAskLevels(ALL_LEVELS)
+                                       : m_orderBook->getBidLevels(ALL_LEVELS);
+
   // Execute market order
   std::vector<std::pair<std::string, double>> fills;
   double executedQuantity =
       m_orderBook->executeMarketOrder(side, quantity, fills);
 
-  // Update last price if there was a fill
-  if (!fills.empty() && executedQuantity > 0) {
-    // Calculate volume-weighted price
-    double volumeWeightedPrice = 0.0;
-    double totalVolume = 0.0;
-
-    for (const auto& fill : fills) {
-      const std::string& orderId = fill.first;
-      double fillQuantity = fill.second;
-
-      auto order = m_orderBook->getOrder(orderId);
-      if (order) {
-        volumeWeightedPrice += order->getPrice() * fillQuantity;
-        totalVolume += fillQuantity;
-      }
-    }
-
-    if (totalVolume > 0) {
-      m_lastPrice = volumeWeightedPrice / totalVolume;
-    }
-
-    // Publish market update if market data feed is available
-    if (m_marketDataFeed) {
-      MarketUpdate update;
-      update.symbol = m_orderBook->getSymbol();
-      update.price = m_lastPrice;
-      update.volume = executedQuantity;
-      update.timestamp = utils::TimeUtils::getCurrentNanos();
-      update.isBuy = (side == OrderSide::BUY);
-
-      m_marketDataFeed->publishMarketUpdate(update);
-    }
+  if (executedQuantity > 0) {
+    recordTrades(side, levels, executedQuantity);
   }
 }
 
@@ -324,7 +410,7 @@ void ExchangeSimulator::simulateLimitOrder(OrderSide side, double price,
   // Create and add order
   auto order = std::make_shared<Order>(orderId, m_orderBook->getSymbol(), side,
                                        OrderType::LIMIT, price, quantity,
-                                       utils::TimeUtils::getCurrentNanos());
+                                       m_scheduler.now());
 
   m_orderBook->addOrder(order);
 }
@@ -340,28 +426,156 @@ void ExchangeSimulator::simulateOrderCancellation() {
     return;
   }
 
-  // Combine bids and asks
-  std::vector<std::string> orderIds;
-
-  // Add bid orders
+  // Combine bids and asks, with the level each order rests in
+  std::vector<std::pair<std::shared_ptr<Order>, const PriceLevel*>> orders;
   for (const auto& level : snapshot->getBids()) {
     for (const auto& order : level.orders) {
-      orderIds.push_back(order->getOrderId());
+      orders.emplace_back(order, &level);
     }
   }
-
-  // Add ask orders
   for (const auto& level : snapshot->getAsks()) {
     for (const auto& order : level.orders) {
-      orderIds.push_back(order->getOrderId());
+      orders.emplace_back(order, &level);
     }
   }
 
   // Select random order to cancel
-  if (!orderIds.empty()) {
-    size_t index = m_rng() % orderIds.size();
-    m_orderBook->cancelOrder(orderIds[index]);
+  if (!orders.empty()) {
+    const auto& [order, level] = orders[m_rng() % orders.size()];
+    double remaining = order->getRemainingQuantity();
+    if (m_orderBook->cancelOrder(order->getOrderId())) {
+      // Part of the volume ahead of our orders at the price may be gone
+      m_queue.onCancel(order->getSide(), level->price, remaining,
+                       level->totalQuantity);
+    }
+  }
+}
+
+void ExchangeSimulator::onOrderArrival(const std::string& orderId,
+                                       OrderSide side, double price,
+                                       double quantity) {
+  report({SimulatedExecution::Type::ACK, orderId, 0.0, 0.0, quantity});
+
+  // A marketable order takes what the book shows within its price. The book
+  // itself is left alone, as for resting fills, but what we took stays gone
+  // from its levels until the book next changes
+  double remaining = quantity;
+  bool crossed = false;
+  if (m_orderBook) {
+    uint64_t update = m_orderBook->getUpdateCount();
+    if (update != m_takenAtUpdate) {
+      m_takenBids.clear();
+      m_takenAsks.clear();
+      m_takenAtUpdate = update;
+    }
+    auto& taken = side == OrderSide::BUY ? m_takenAsks : m_takenBids;
+
+    std::vector<PriceLevel> levels =
+        side == OrderSide::BUY ? m_orderBook->getAskLevels(ALL_LEVELS)
+                               : m_orderBook->getBidLevels(ALL_LEVELS);
+    for (const auto& level : levels) {
+      bool beyond =
+          side == OrderSide::BUY ? level.price > price : level.price < price;
+      if (remaining <= 0.0 || beyond) {
+        break;
+      }
+      crossed = true;
+      double& takenAtLevel = taken[level.price];
+      double fill = std::min(remaining, level.totalQuantity - takenAtLevel);
+      if (fill <= 0.0) {
+        continue;
+      }
+      takenAtLevel += fill;
+      remaining -= fill;
+      report({SimulatedExecution::Type::FILL, orderId, level.price, fill,
+              std::max(remaining, 0.0)});
+    }
+  }
+  if (remaining <= 0.0) {
+    return;
+  }
+
+  // The rest joins the back of its level, behind everything resting there
+  double ahead =
+      crossed || !m_orderBook ? 0.0 : m_orderBook->getVolumeAtPrice(price);
+  m_queue.addOrder(orderId, side, price, remaining, ahead);
+}
+
+void ExchangeSimulator::onCancelArrival(const std::string& orderId) {
+  const QueuePositionModel::QueuedOrder* order = m_queue.find(orderId);
+  if (!order) {
+    // Already filled, with the report on its way back
+    report({SimulatedExecution::Type::CANCEL_REJECTED, orderId});
+    return;
+  }
+  double remaining = order->remaining;
+  m_queue.removeOrder(orderId);
+  report({SimulatedExecution::Type::CANCELED, orderId, 0.0, remaining, 0.0});
+}
+
+void ExchangeSimulator::recordTrades(OrderSide takerSide,
+                                     const std::vector<PriceLevel>& levels,
+                                     double executed) {
+  OrderSide restingSide =
+      takerSide == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY;
+
+  // Fills walk the levels best first, each taking what the level held
+  double left = executed;
+  double notional = 0.0;
+  for (const auto& level : levels) {
+    if (left <= 0.0) {
+      break;
+    }
+    double traded = std::min(left, level.totalQuantity);
+    left -= traded;
+    notional += traded * level.price;
+    m_queue.onTrade(restingSide, level.price, traded, m_fills);
+    publishTrade(level.price, traded, takerSide == OrderSide::BUY);
+  }
+  if (executed > left) {
+    m_lastPrice = notional / (executed - left);
+  }
+
+  for (const auto& fill : m_fills) {
+    report({SimulatedExecution::Type::FILL, fill.orderId, fill.price,
+            fill.quantity, fill.remaining});
+  }
+  m_fills.clear();
+}
+
+void ExchangeSimulator::report(SimulatedExecution execution) {
+  execution.exchangeTime = m_scheduler.now();
+  execution.receivedAt =
+      m_acknowledgement.deliveryTime(execution.exchangeTime, m_rng);
+  m_scheduler.schedule(execution.receivedAt, [this, execution] {
+    bool done = execution.type == SimulatedExecution::Type::CANCELED ||
+                (execution.type == SimulatedExecution::Type::FILL &&
+                 execution.remaining <= 0.0);
+    if (done) {
+      m_openOrders.erase(execution.orderId);
+    }
+    if (m_executionCallback) {
+      m_executionCallback(execution);
+    }
+  });
+}
+
+void ExchangeSimulator::publishTrade(double price, double quantity,
+                                     bool isBuy) {
+  if (!m_marketDataFeed) {
+    return;
   }
+  MarketUpdate update;
+  update.symbol = m_orderBook->getSymbol();
+  update.price = price;
+  update.volume = quantity;
+  update.timestamp = m_scheduler.now();
+  update.isBuy = isBuy;
+
+  m_scheduler.schedule(m_marketData.deliveryTime(update.timestamp, m_rng),
+                       [this, update = std::move(update)] {
+                         m_marketDataFeed->publishMarketUpdate(update);
+                       });
 }
 
 void ExchangeSimulator::updateMarketPrice() {
@@ -400,8 +614,7 @@ double ExchangeSimulator::roundToTickSize(double price) const {
 std::string ExchangeSimulator::generateOrderId() {
   // Generate a unique order ID
   std::ostringstream oss;
-  oss << "sim-" << utils::TimeUtils::getCurrentNanos() << "-"
-      << (m_rng() % 1000);
+  oss << "sim-" << ++m_nextOrderId;
   return oss.str();
 }
 
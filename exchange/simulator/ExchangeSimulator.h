@@ -1,9 +1,16 @@
 #pragma once
 
 #include "../../core/orderbook/OrderBook.h"
+#include "EventScheduler.h"
+#include "LatencyModel.h"
 #include "MarketDataFeed.h"
+#include "QueuePositionModel.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -15,12 +22,44 @@
 namespace pinnacle {
 namespace exchange {
 
+/**
+ * @struct SimulatedExecution
+ * @brief Report on an order sent to the simulator, as received back
+ */
+struct SimulatedExecution {
+  enum class Type : uint8_t { ACK, FILL, CANCELED, CANCEL_REJECTED };
+
+  Type type;
+  std::string orderId;
+  double price{0.0};        // Fill price
+  double quantity{0.0};     // Fill or canceled quantity
+  double remaining{0.0};    // Open quantity after this report
+  uint64_t exchangeTime{0}; // When the venue acted, simulated nanoseconds
+  uint64_t receivedAt{0};   // When the report arrived back
+};
+
 /**
  * @class ExchangeSimulator
  * @brief Simulates an exchange for testing strategies
+ *
+ * Everything happens as events on a simulated clock: price moves,
+ * participants trading against the shared order book, market data and our
+ * own orders. start() paces the clock to the wall clock (scaled by
+ * setSpeed()) on a simulator thread; runFor() runs the events as fast as
+ * they can be handled on the calling thread.
+ *
+ * Orders sent with submitOrder() reach the venue after the order entry
+ * latency and join the back of their price level's queue, tracked by a
+ * QueuePositionModel beside the book rather than in it. They fill once the
+ * volume ahead has traded. Reports come back after the acknowledgement
+ * latency, and market data reaches the feed after the market data latency.
+ * Callbacks run on the simulator thread, or the runFor() caller, and may
+ * send further orders.
  */
 class ExchangeSimulator {
 public:
+  using ExecutionCallback = std::function<void(const SimulatedExecution&)>;
+
   /**
    * @brief Constructor
    *
@@ -108,7 +147,65 @@ public:
   void addMarketParticipant(const std::string& type, double frequency,
                             double volumeRatio);
 
+  /**
+   * @brief Set the latency of each path to and from the venue
+   */
+  void setLatency(const SimulatorLatency& latency);
+
+  /**
+   * @brief Simulated seconds per wall-clock second when started; 0 runs
+   * without pacing
+   */
+  void setSpeed(double speed) { m_speed = std::max(speed, 0.0); }
+
+  /**
+   * @brief Reseed the random numbers, for a reproducible run
+   */
+  void setSeed(uint64_t seed);
+
+  /**
+   * @brief Receive reports on orders sent with submitOrder()
+   */
+  void setExecutionCallback(ExecutionCallback callback);
+
+  /**
+   * @brief Send a limit order to the venue
+   *
+   * @return false if the order id is already in use
+   */
+  bool submitOrder(const std::string& orderId, OrderSide side, double price,
+                   double quantity);
+
+  /**
+   * @brief Send a cancel for an order sent with submitOrder()
+   *
+   * @return false if no such order is open
+   */
+  bool cancelOrder(const std::string& orderId);
+
+  /**
+   * @brief Run the simulation for a span of simulated time, unpaced, on the
+   * calling thread
+   *
+   * @return Number of events run, or 0 if the simulator is started
+   */
+  size_t runFor(uint64_t durationNanos);
+
+  /**
+   * @brief Current simulated time in nanoseconds
+   *
+   * Starts at the wall-clock time at construction.
+   */
+  uint64_t getSimulatedTime() const;
+
+  /**
+   * @brief Our resting orders and the volume estimated ahead of them
+   */
+  std::vector<QueuePositionModel::QueuedOrder> getQueuedOrders() const;
+
 private:
+  using Event = std::function<void()>;
+
   // Core components
   std::shared_ptr<OrderBook> m_orderBook;
   std::shared_ptr<MarketDataFeed> m_marketDataFeed;
@@ -117,10 +214,18 @@ private:
   std::atomic<bool> m_isRunning{false};
   std::atomic<bool> m_shouldStop{false};
 
-  // Simulator threads
+  // Simulator thread, pacing the event clock to the wall clock
   std::thread m_mainThread;
-  std::thread m_marketDataThread;
-  std::thread m_participantThread;
+  double m_speed{1.0};
+  std::chrono::steady_clock::time_point m_wallStart;
+  uint64_t m_simulatedStart{0};
+
+  // Events and everything they touch are guarded by m_mutex, recursive so
+  // that callbacks can send orders
+  mutable std::recursive_mutex m_mutex;
+  std::condition_variable_any m_wakeup;
+  EventScheduler<Event> m_scheduler;
+  bool m_eventsScheduled{false};
 
   // Market parameters
   double m_volatility{0.2};
@@ -138,22 +243,49 @@ private:
     double frequency;
     double volumeRatio;
     std::exponential_distribution<double> activityDistribution;
-    uint64_t nextActivityTime;
   };
 
   std::vector<MarketParticipant> m_participants;
-  std::mutex m_participantsMutex;
+
+  // Our orders: the three network paths and the queues at the venue
+  LatencyChannel m_orderEntry;
+  LatencyChannel m_acknowledgement;
+  LatencyChannel m_marketData;
+  QueuePositionModel m_queue;
+  std::unordered_map<std::string, OrderSide> m_openOrders; // As we see them
+  ExecutionCallback m_executionCallback;
+  std::vector<QueueFill> m_fills;
+  uint64_t m_nextOrderId{0};
+
+  // Visible quantity our marketable orders took, by price, as of a book
+  // update count
+  std::unordered_map<double, double> m_takenBids;
+  std::unordered_map<double, double> m_takenAsks;
+  uint64_t m_takenAtUpdate{0};
 
   // Internal implementation
   void mainLoop();
-  void marketDataLoop();
-  void participantLoop();
+  uint64_t currentTime() const;
+  void scheduleRecurringEvents();
+  void onPriceTick();
+  void onBookTick();
+  void scheduleParticipant(size_t index);
+  void runParticipant(size_t index);
 
   void simulateMarketOrder(OrderSide side, double quantity);
   void simulateLimitOrder(OrderSide side, double price, double quantity);
   void simulateOrderCancellation();
   void updateMarketPrice();
 
+  // Venue side of our orders
+  void onOrderArrival(const std::string& orderId, OrderSide side,
+                      double price, double quantity);
+  void onCancelArrival(const std::string& orderId);
+  void recordTrades(OrderSide takerSide, const std::vector<PriceLevel>& levels,
+                    double executed);
+  void report(SimulatedExecution execution);
+  void publishTrade(double price, double quantity, bool isBuy);
+
   double generateRandomPrice();
   double roundToTickSize(double price) const;
 
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class LatencyDistribution
+ * @brief One-way delay of a simulated network path, in nanoseconds
+ *
+ * Defaults to no delay. Log-normal suits most real paths: a tight body with
+ * a long right tail from queuing and retransmits. Samples never go below 0.
+ */
+class LatencyDistribution {
+public:
+  enum class Shape : uint8_t { FIXED, UNIFORM, NORMAL, LOG_NORMAL };
+
+  LatencyDistribution() = default;
+
+  static LatencyDistribution fixed(uint64_t nanos) {
+    return {Shape::FIXED, static_cast<double>(nanos), 0.0};
+  }
+
+  static LatencyDistribution uniform(uint64_t lowNanos, uint64_t highNanos) {
+    return {Shape::UNIFORM, static_cast<double>(lowNanos),
+            static_cast<double>(std::max(lowNanos, highNanos))};
+  }
+
+  static LatencyDistribution normal(uint64_t meanNanos, uint64_t stddevNanos) {
+    return {Shape::NORMAL, static_cast<double>(meanNanos),
+            static_cast<double>(stddevNanos)};
+  }
+
+  /**
+   * @param sigma Standard deviation of the log; 0.5 puts the 99th percentile
+   * at about 3.2 times the median
+   */
+  static LatencyDistribution logNormal(uint64_t medianNanos, double sigma) {
+    return {Shape::LOG_NORMAL,
+            std::log(static_cast<double>(std::max<uint64_t>(medianNanos, 1))),
+            std::max(sigma, 0.0)};
+  }
+
+  template <class Rng> uint64_t sample(Rng& rng) const {
+    double nanos = m_first;
+    switch (m_shape) {
+    case Shape::FIXED:
+      break;
+    case Shape::UNIFORM:
+      nanos = std::uniform_real_distribution<double>(m_first, m_second)(rng);
+      break;
+    case Shape::NORMAL:
+      nanos = std::normal_distribution<double>(m_first, m_second)(rng);
+      break;
+    case Shape::LOG_NORMAL:
+      nanos = std::lognormal_distribution<double>(m_first, m_second)(rng);
+      break;
+    }
+    return nanos > 0.0 ? static_cast<uint64_t>(nanos) : 0;
+  }
+
+  Shape getShape() const { return m_shape; }
+
+private:
+  LatencyDistribution(Shape shape, double first, double second)
+      : m_shape(shape), m_first(first), m_second(second) {}
+
+  Shape m_shape{Shape::FIXED};
+  double m_first{0.0};  // Fixed, low, mean or log median
+  double m_second{0.0}; // High, standard deviation or sigma
+};
+
+/**
+ * @class LatencyChannel
+ * @brief A connection with a latency distribution that keeps messages in
+ * order
+ *
+ * Like a TCP session, a message never overtakes one sent before it: a
+ * sample that would do so is held back until the earlier message arrives.
+ */
+class LatencyChannel {
+public:
+  explicit LatencyChannel(LatencyDistribution distribution = {})
+      : m_distribution(distribution) {}
+
+  /**
+   * @brief Time at which a message sent now arrives at the other end
+   */
+  template <class Rng> uint64_t deliveryTime(uint64_t sentAt, Rng& rng) {
+    m_lastDelivery =
+        std::max(m_lastDelivery, sentAt + m_distribution.sample(rng));
+    return m_lastDelivery;
+  }
+
+  void setDistribution(LatencyDistribution distribution) {
+    m_distribution = distribution;
+  }
+
+private:
+  LatencyDistribution m_distribution;
+  uint64_t m_lastDelivery{0};
+};
+
+/**
+ * @struct SimulatorLatency
+ * @brief Latency of each path between a trading system and a simulated venue
+ */
+struct SimulatorLatency {
+  LatencyDistribution orderEntry;      // Orders and cancels to the venue
+  LatencyDistribution acknowledgement; // Acks, fills and rejects back
+  LatencyDistribution marketData;      // Trades and book updates
+};
+
+} // namespace exchange
+} // namespace pinnacle
@@ -24,6 +24,7 @@ struct MarketUpdate {
   bool isBuy;
   double bidPrice = 0.0;
   double askPrice = 0.0;
+  uint64_t kernelTimestamp = 0; // Kernel or NIC receive time, 0 if unknown
 };
 
 /**
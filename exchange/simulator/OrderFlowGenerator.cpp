@@ -0,0 +1,517 @@
+#include "OrderFlowGenerator.h"
+#include "../connector/JsonCursor.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+uint64_t splitMix64(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+int64_t toFixedPoint(double value) {
+  return std::llround(value * static_cast<double>(FIXED_POINT_SCALE));
+}
+
+// Splits a uniform on (0, 1] at p into one of two uniforms on (0, 1], so
+// one draw decides both a branch and a value inside it
+bool split(double& u, double p) {
+  if (u <= p) {
+    u = p > 0.0 ? u / p : 1.0;
+    return true;
+  }
+  u = (u - p) / (1.0 - p);
+  return false;
+}
+
+// Natural log of a positive normal double, as fdlibm's log but without its
+// branches or errno, so a loop over it vectorizes where one over std::log
+// does not. Within an ulp or two of std::log
+inline double batchLog(double x) {
+  constexpr double Lg1 = 6.666666666666735130e-01;
+  constexpr double Lg2 = 3.999999999940941908e-01;
+  constexpr double Lg3 = 2.857142874366239149e-01;
+  constexpr double Lg4 = 2.222219843214978396e-01;
+  constexpr double Lg5 = 1.818357216161805012e-01;
+  constexpr double Lg6 = 1.531383769920937332e-01;
+  constexpr double Lg7 = 1.479819860511658591e-01;
+  constexpr double ln2Hi = 6.93147180369123816490e-01;
+  constexpr double ln2Lo = 1.90821492927058770002e-10;
+
+  // x = 2^k * m with m in [sqrt(2)/2, sqrt(2))
+  uint64_t bits = std::bit_cast<uint64_t>(x);
+  bits += (0x3ff00000ULL - 0x3fe6a09eULL) << 32;
+  double k = std::bit_cast<double>((bits >> 52) | 0x4330000000000000ULL) -
+             (0x1.0p52 + 1023.0);
+  double m = std::bit_cast<double>((bits & 0x000fffffffffffffULL) +
+                                   (0x3fe6a09eULL << 32));
+
+  double f = m - 1.0;
+  double hfsq = 0.5 * f * f;
+  double s = f / (2.0 + f);
+  double z = s * s;
+  double w = z * z;
+  double r = w * (Lg2 + w * (Lg4 + w * Lg6)) +
+             z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+  return s * (hfsq + r) + k * ln2Lo - hfsq + f + k * ln2Hi;
+}
+
+// e^x for x in [0, 709], as fdlibm's exp but without its branches or errno
+inline double batchExp(double x) {
+  constexpr double P1 = 1.66666666666666019037e-01;
+  constexpr double P2 = -2.77777777770155933842e-03;
+  constexpr double P3 = 6.61375632143793436117e-05;
+  constexpr double P4 = -1.65339022054652515390e-06;
+  constexpr double P5 = 4.13813679705723846039e-08;
+  constexpr double invLn2 = 1.44269504088896338700e+00;
+  constexpr double ln2Hi = 6.93147180369123816490e-01;
+  constexpr double ln2Lo = 1.90821492927058770002e-10;
+  constexpr double roundShift = 0x1.8p52;
+
+  // x = k ln2 + r with |r| <= ln2 / 2, k rounded in the low mantissa bits
+  double shifted = x * invLn2 + roundShift;
+  uint64_t k = std::bit_cast<uint64_t>(shifted) -
+               std::bit_cast<uint64_t>(roundShift);
+  double kd = shifted - roundShift;
+  double hi = x - kd * ln2Hi;
+  double lo = kd * ln2Lo;
+  double r = hi - lo;
+
+  double t = r * r;
+  double c = r - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+  double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+  return std::bit_cast<double>(std::bit_cast<uint64_t>(y) + (k << 52));
+}
+
+} // namespace
+
+OrderFlowGenerator::OrderFlowGenerator(OrderFlowConfig config)
+    : m_config(std::move(config)), m_time(m_config.startTime) {
+  const auto& c = m_config;
+  if (c.symbols.empty()) {
+    throw std::invalid_argument("Order flow needs at least one symbol");
+  }
+  if (c.baseRate <= 0.0 || c.decayRate <= 0.0) {
+    throw std::invalid_argument("Base rate and decay rate must be positive");
+  }
+  if (c.selfExcitation < 0.0 || c.crossExcitation < 0.0 ||
+      c.selfExcitation + (c.symbols.size() > 1 ? c.crossExcitation : 0.0) >=
+          1.0) {
+    throw std::invalid_argument(
+        "Self and cross excitation must sum to less than 1");
+  }
+  if (c.limitWeight <= 0.0 || c.cancelWeight < 0.0 || c.marketWeight < 0.0) {
+    throw std::invalid_argument("Event weights must not be negative");
+  }
+  if (c.levels < 2 || c.targetLevelLots < 1.0 || c.placementDecay <= 0.0) {
+    throw std::invalid_argument("Book needs two levels of at least a lot");
+  }
+  if (c.sizeTailExponent <= 0.0 || c.maxOrderLots < 1.0) {
+    throw std::invalid_argument("Order sizes need a positive tail exponent");
+  }
+  if (c.flowCorrelation < 0.0 || c.flowCorrelation > 1.0 ||
+      c.flowFlipProbability < 0.0 || c.flowFlipProbability > 1.0 ||
+      c.improveProbability < 0.0 || c.improveProbability > 1.0) {
+    throw std::invalid_argument("Probabilities must be between 0 and 1");
+  }
+
+  uint64_t seed = c.seed;
+  for (auto& word : m_rng) {
+    word = splitMix64(seed);
+  }
+
+  m_symbols.resize(c.symbols.size());
+  for (size_t i = 0; i < c.symbols.size(); ++i) {
+    const auto& symbol = c.symbols[i];
+    SymbolState& state = m_symbols[i];
+    state.tickFixed = toFixedPoint(symbol.tickSize);
+    state.lotFixed = toFixedPoint(symbol.lotSize);
+    int64_t bidTicks = std::llround(symbol.initialPrice / symbol.tickSize);
+    if (state.tickFixed <= 0 || state.lotFixed <= 0 ||
+        bidTicks <= static_cast<int64_t>(2 * c.levels)) {
+      throw std::invalid_argument("Invalid tick, lot or price for " +
+                                  symbol.symbol);
+    }
+
+    state.bids.ring.resize(c.levels);
+    state.bids.bestTicks = bidTicks;
+    state.bids.isBid = true;
+    state.asks.ring.resize(c.levels);
+    state.asks.bestTicks = bidTicks + 1;
+    state.asks.isBid = false;
+  }
+
+  m_out = &m_initialBook;
+  for (uint32_t i = 0; i < m_symbols.size(); ++i) {
+    seedBook(i);
+  }
+  m_out = nullptr;
+}
+
+// ============================================================================
+// Random numbers
+// ============================================================================
+
+uint64_t OrderFlowGenerator::nextRandom() {
+  // xoshiro256**
+  uint64_t result = rotl(m_rng[1] * 5, 7) * 9;
+  uint64_t t = m_rng[1] << 17;
+  m_rng[2] ^= m_rng[0];
+  m_rng[3] ^= m_rng[1];
+  m_rng[1] ^= m_rng[2];
+  m_rng[0] ^= m_rng[3];
+  m_rng[2] ^= t;
+  m_rng[3] = rotl(m_rng[3], 45);
+  return result;
+}
+
+double OrderFlowGenerator::nextUniform() {
+  // On (0, 1], so logarithms stay finite
+  return static_cast<double>((nextRandom() >> 11) + 1) * 0x1.0p-53;
+}
+
+void OrderFlowGenerator::drawBatch() {
+  Batch& b = m_batch;
+  for (auto* column : {&b.arrival, &b.excitation, &b.pick, &b.action,
+                       &b.choice, &b.placement, &b.size}) {
+    for (double& u : *column) {
+      u = nextUniform();
+    }
+  }
+
+  // Each transform is one branch-free pass over an array. std::log and
+  // std::pow may set errno, which stops the compiler vectorizing a loop
+  // over them, so these use batchLog() and batchExp() instead
+  const double inverseTail = -1.0 / m_config.sizeTailExponent;
+  const double maxLogLots = std::log(m_config.maxOrderLots);
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    b.arrival[i] = -batchLog(b.arrival[i]);
+  }
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    b.excitation[i] = batchLog(b.excitation[i]);
+  }
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    b.placement[i] = -batchLog(b.placement[i]);
+  }
+  // u^(-1/alpha), capped in log space so the exponent stays in range
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    b.size[i] =
+        batchExp(std::min(maxLogLots, inverseTail * batchLog(b.size[i])));
+  }
+  m_batchUsed = 0;
+}
+
+// ============================================================================
+// Generation
+// ============================================================================
+
+void OrderFlowGenerator::generate(size_t count,
+                                  std::vector<OrderFlowEvent>& out) {
+  out.clear();
+  if (!m_initialBook.empty()) {
+    out.swap(m_initialBook);
+  }
+  size_t target = out.size() + count;
+  out.insert(out.end(), m_carry.begin(), m_carry.end());
+  m_carry.clear();
+
+  m_out = &out;
+  while (out.size() < target) {
+    if (m_batchUsed == BATCH_SIZE) {
+      drawBatch();
+    }
+    step(m_batchUsed++);
+  }
+  m_out = nullptr;
+
+  // A market order's fills are kept together in the stream, not the call
+  if (out.size() > target) {
+    m_carry.assign(out.begin() + static_cast<ptrdiff_t>(target), out.end());
+    out.resize(target);
+  }
+}
+
+uint32_t OrderFlowGenerator::advanceClock(size_t i) {
+  // Every symbol's excitation decays at the same rate, so the total
+  // intensity is base + S e^(-beta t) and its next arrival can be sampled
+  // exactly: the sooner of a base arrival and an excited one
+  const double beta = m_config.decayRate;
+  const double base = m_config.baseRate;
+  const double totalBase = base * static_cast<double>(m_symbols.size());
+  double excited = 0.0;
+  for (const auto& symbol : m_symbols) {
+    excited += symbol.excitation;
+  }
+
+  double wait = m_batch.arrival[i] / totalBase;
+  if (excited > 0.0) {
+    double d = 1.0 + beta * m_batch.excitation[i] / excited;
+    if (d > 0.0) {
+      wait = std::min(wait, -std::log(d) / beta);
+    }
+  }
+
+  double decay = std::exp(-beta * wait);
+  excited = 0.0;
+  for (auto& symbol : m_symbols) {
+    symbol.excitation *= decay;
+    excited += symbol.excitation;
+  }
+
+  m_timeFraction += wait * 1e9;
+  double whole = std::floor(m_timeFraction);
+  m_time += static_cast<uint64_t>(whole);
+  m_timeFraction -= whole;
+
+  // The symbol of the event, in proportion to its intensity
+  double target = m_batch.pick[i] * (totalBase + excited);
+  uint32_t chosen = static_cast<uint32_t>(m_symbols.size() - 1);
+  double sum = 0.0;
+  for (uint32_t s = 0; s < m_symbols.size(); ++s) {
+    sum += base + m_symbols[s].excitation;
+    if (target <= sum) {
+      chosen = s;
+      break;
+    }
+  }
+
+  double self = beta * m_config.selfExcitation;
+  double cross = m_symbols.size() > 1
+                     ? beta * m_config.crossExcitation /
+                           static_cast<double>(m_symbols.size() - 1)
+                     : 0.0;
+  for (uint32_t s = 0; s < m_symbols.size(); ++s) {
+    m_symbols[s].excitation += s == chosen ? self : cross;
+  }
+  return chosen;
+}
+
+void OrderFlowGenerator::step(size_t i) {
+  uint32_t symbolId = advanceClock(i);
+  SymbolState& state = m_symbols[symbolId];
+
+  // Cancels grow with the resting depth relative to its target, which
+  // keeps the books from draining or piling up
+  double target = 2.0 * static_cast<double>(m_config.levels) *
+                  m_config.targetLevelLots;
+  double limit = m_config.limitWeight;
+  double cancels = m_config.cancelWeight *
+                   static_cast<double>(state.bids.lots + state.asks.lots) /
+                   target;
+  double total = limit + cancels + m_config.marketWeight;
+
+  double u = m_batch.action[i];
+  if (split(u, limit / total)) {
+    double& choice = m_batch.choice[i];
+    addLimit(symbolId, split(choice, 0.5), i);
+  } else if (split(u, cancels / (cancels + m_config.marketWeight))) {
+    cancel(symbolId, i);
+  } else {
+    if (u <= m_config.flowFlipProbability) {
+      m_flowBuys = !m_flowBuys;
+    }
+    double choice = m_batch.choice[i];
+    bool buys = split(choice, m_config.flowCorrelation) ? m_flowBuys
+                                                         : choice <= 0.5;
+    marketOrder(symbolId, buys, i);
+  }
+}
+
+void OrderFlowGenerator::seedBook(uint32_t symbolId) {
+  SymbolState& state = m_symbols[symbolId];
+  const auto target = static_cast<int64_t>(m_config.targetLevelLots);
+  for (BookSide* side : {&state.bids, &state.asks}) {
+    for (size_t k = 0; k < m_config.levels; ++k) {
+      while (side->level(k).lots < target) {
+        double lots = std::pow(nextUniform(), -1.0 / m_config.sizeTailExponent);
+        int64_t remaining = target - side->level(k).lots;
+        restOrder(symbolId, *side, k,
+                  std::min(remaining, static_cast<int64_t>(lots)),
+                  EVENT_FLAG_SNAPSHOT);
+      }
+    }
+  }
+}
+
+void OrderFlowGenerator::addLimit(uint32_t symbolId, bool isBid, size_t i) {
+  SymbolState& state = m_symbols[symbolId];
+  BookSide& side = isBid ? state.bids : state.asks;
+  auto lots = static_cast<int64_t>(m_batch.size[i]);
+
+  bool wide = state.asks.bestTicks - state.bids.bestTicks > 1;
+  if (wide && m_batch.choice[i] <= m_config.improveProbability) {
+    improve(symbolId, side);
+    restOrder(symbolId, side, 0, lots, 0);
+    return;
+  }
+
+  auto k = static_cast<size_t>(m_batch.placement[i] / m_config.placementDecay);
+  restOrder(symbolId, side, std::min(k, m_config.levels - 1), lots, 0);
+}
+
+void OrderFlowGenerator::cancel(uint32_t symbolId, size_t i) {
+  SymbolState& state = m_symbols[symbolId];
+
+  // A resting lot is picked uniformly, so a queue is canceled from in
+  // proportion to its size, and so is an order within it
+  double u = m_batch.choice[i];
+  double bidShare = static_cast<double>(state.bids.lots) /
+                    static_cast<double>(state.bids.lots + state.asks.lots);
+  BookSide& side = split(u, bidShare) ? state.bids : state.asks;
+  if (side.orders <= 1) {
+    return; // Each side keeps an order, so it always has a best price
+  }
+
+  auto position = std::min(
+      side.lots - 1, static_cast<int64_t>(u * static_cast<double>(side.lots)));
+  size_t k = 0;
+  while (position >= side.level(k).lots && k + 1 < m_config.levels) {
+    position -= side.level(k).lots;
+    ++k;
+  }
+  Level& level = side.level(k);
+  auto it = level.orders.begin();
+  while (position >= it->lots && std::next(it) != level.orders.end()) {
+    position -= it->lots;
+    ++it;
+  }
+
+  RestingOrder order = *it;
+  level.orders.erase(it);
+  level.lots -= order.lots;
+  side.lots -= order.lots;
+  --side.orders;
+  emit(symbolId, OrderFlowAction::CANCEL,
+       side.isBid ? EventSide::BID : EventSide::ASK, order.id,
+       side.priceTicks(k), order.lots, level.lots);
+  if (k == 0) {
+    settleBest(side);
+  }
+}
+
+void OrderFlowGenerator::marketOrder(uint32_t symbolId, bool buys, size_t i) {
+  SymbolState& state = m_symbols[symbolId];
+  BookSide& book = buys ? state.asks : state.bids;
+  EventSide aggressor = buys ? EventSide::BID : EventSide::ASK;
+
+  // Takes at most the best queue, as almost every market order does on
+  // real books, and never the last lot, so the side keeps a best price
+  int64_t remaining = std::min({static_cast<int64_t>(m_batch.size[i]),
+                                book.level(0).lots, book.lots - 1});
+  while (remaining > 0) {
+    Level& level = book.level(0);
+    RestingOrder& maker = level.orders.front();
+    int64_t fill = std::min(maker.lots, remaining);
+    maker.lots -= fill;
+    level.lots -= fill;
+    book.lots -= fill;
+    remaining -= fill;
+    emit(symbolId, OrderFlowAction::TRADE, aggressor, maker.id,
+         book.priceTicks(0), fill, level.lots);
+
+    if (maker.lots == 0) {
+      level.orders.pop_front();
+      --book.orders;
+    }
+    if (level.lots == 0) {
+      settleBest(book);
+    }
+  }
+}
+
+void OrderFlowGenerator::restOrder(uint32_t symbolId, BookSide& side,
+                                   size_t k, int64_t lots, uint8_t flags) {
+  lots = std::max<int64_t>(lots, 1);
+  Level& level = side.level(k);
+  uint64_t id = m_nextOrderId++;
+  level.orders.push_back({id, lots});
+  level.lots += lots;
+  side.lots += lots;
+  ++side.orders;
+  emit(symbolId, OrderFlowAction::ADD,
+       side.isBid ? EventSide::BID : EventSide::ASK, id, side.priceTicks(k),
+       lots, level.lots, flags);
+}
+
+void OrderFlowGenerator::improve(uint32_t symbolId, BookSide& side) {
+  // The farthest level leaves the tracked range; its orders are canceled
+  // so consumers' books stay in step
+  Level& farthest = side.level(m_config.levels - 1);
+  int64_t farPrice = side.priceTicks(m_config.levels - 1);
+  while (!farthest.orders.empty()) {
+    RestingOrder order = farthest.orders.back();
+    farthest.orders.pop_back();
+    farthest.lots -= order.lots;
+    side.lots -= order.lots;
+    --side.orders;
+    emit(symbolId, OrderFlowAction::CANCEL,
+         side.isBid ? EventSide::BID : EventSide::ASK, order.id, farPrice,
+         order.lots, farthest.lots);
+  }
+
+  side.head = (side.head + side.ring.size() - 1) % side.ring.size();
+  side.bestTicks += side.isBid ? 1 : -1;
+}
+
+void OrderFlowGenerator::settleBest(BookSide& side) {
+  while (side.lots > 0 && side.level(0).lots == 0) {
+    side.head = (side.head + 1) % side.ring.size();
+    side.bestTicks += side.isBid ? -1 : 1;
+  }
+}
+
+void OrderFlowGenerator::emit(uint32_t symbolId, OrderFlowAction action,
+                              EventSide side, uint64_t orderId,
+                              int64_t priceTicks, int64_t lots,
+                              int64_t levelLots, uint8_t flags) {
+  const SymbolState& state = m_symbols[symbolId];
+  m_out->push_back(OrderFlowEvent{m_time, orderId,
+                                  priceTicks * state.tickFixed,
+                                  lots * state.lotFixed,
+                                  levelLots * state.lotFixed, symbolId, action,
+                                  side, flags});
+  ++m_eventsGenerated;
+}
+
+// ============================================================================
+// Book queries
+// ============================================================================
+
+int64_t OrderFlowGenerator::getBestBid(uint32_t symbolId) const {
+  const SymbolState& state = m_symbols.at(symbolId);
+  return state.bids.bestTicks * state.tickFixed;
+}
+
+int64_t OrderFlowGenerator::getBestAsk(uint32_t symbolId) const {
+  const SymbolState& state = m_symbols.at(symbolId);
+  return state.asks.bestTicks * state.tickFixed;
+}
+
+std::vector<std::pair<int64_t, int64_t>>
+OrderFlowGenerator::getLevels(uint32_t symbolId, EventSide side) const {
+  const SymbolState& state = m_symbols.at(symbolId);
+  const BookSide& book = side == EventSide::BID ? state.bids : state.asks;
+  std::vector<std::pair<int64_t, int64_t>> levels;
+  for (size_t k = 0; k < m_config.levels; ++k) {
+    if (book.level(k).lots > 0) {
+      levels.emplace_back(book.priceTicks(k) * state.tickFixed,
+                          book.level(k).lots * state.lotFixed);
+    }
+  }
+  return levels;
+}
+
+} // namespace exchange
+} // namespace pinnacle
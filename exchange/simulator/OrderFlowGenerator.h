@@ -0,0 +1,246 @@
+#pragma once
+
+#include "../connector/MarketEvent.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @struct OrderFlowSymbol
+ * @brief An instrument of the generated market
+ */
+struct OrderFlowSymbol {
+  std::string symbol;
+  double initialPrice{50000.0};
+  double tickSize{0.01};
+  double lotSize{0.001}; // Every order is a whole number of lots
+};
+
+/**
+ * @struct OrderFlowConfig
+ * @brief Parameters of a generated order flow
+ *
+ * Arrivals follow a multivariate Hawkes process with an exponential kernel:
+ * every event raises the intensity of its own symbol by selfExcitation and
+ * of the other symbols by crossExcitation events in expectation, decaying
+ * at decayRate. Their sum must stay below 1 for the flow to be stationary.
+ */
+struct OrderFlowConfig {
+  std::vector<OrderFlowSymbol> symbols{{"BTC-USD", 50000.0, 0.01, 0.001}};
+  uint64_t seed{1};
+  uint64_t startTime{0}; // Nanoseconds of the first event
+
+  // Arrivals
+  double baseRate{10000.0};    // Events per second per symbol without bursts
+  double selfExcitation{0.5};  // Events triggered in the same symbol
+  double crossExcitation{0.2}; // Events triggered across the other symbols
+  double decayRate{200.0};     // Per second; clusters last about 1/decayRate
+
+  // Event mix when every level holds targetLevelLots; cancels scale with
+  // the resting depth, so deep books thin out and thin books refill
+  double limitWeight{0.55};
+  double cancelWeight{0.35};
+  double marketWeight{0.10};
+  size_t levels{20}; // Tracked levels per side
+  double targetLevelLots{40.0};
+  double placementDecay{0.3};      // Limit at level k with weight e^(-decay k)
+  double improveProbability{0.25}; // Limit inside a spread wider than a tick
+
+  // Order sizes in lots: Pareto with this tail exponent, at least one lot
+  double sizeTailExponent{1.5};
+  double maxOrderLots{1000.0};
+
+  // Probability a market order follows the flow direction shared by all
+  // symbols, and of that direction flipping at each market order
+  double flowCorrelation{0.6};
+  double flowFlipProbability{0.05};
+};
+
+/**
+ * @enum OrderFlowAction
+ * @brief What a generated event does to the book
+ */
+enum class OrderFlowAction : uint8_t {
+  ADD,    // Limit order rests in the book
+  CANCEL, // Resting order leaves the book
+  TRADE   // Resting order is filled, in full or in part, by a market order
+};
+
+/**
+ * @struct OrderFlowEvent
+ * @brief One order-level event, with the level total it leaves behind
+ *
+ * Prices and quantities are fixed point scaled by FIXED_POINT_SCALE. A
+ * market order produces one TRADE per resting order it fills, in
+ * price-time priority, so applying the events in order to any book that
+ * matches that way reproduces the generator's book.
+ */
+struct OrderFlowEvent {
+  uint64_t timestamp;
+  uint64_t orderId; // Added or canceled order, or the maker of a TRADE
+  int64_t price;
+  int64_t quantity;      // Order size, or filled size of a TRADE
+  int64_t levelQuantity; // Resting at the price after the event
+  uint32_t symbolId;     // Index into OrderFlowConfig::symbols
+  OrderFlowAction action;
+  EventSide side; // Book side, or the aggressor side of a TRADE
+  uint8_t flags;  // EVENT_FLAG_SNAPSHOT on the initial book
+};
+
+static_assert(std::is_trivially_copyable_v<OrderFlowEvent>);
+
+/**
+ * @class OrderFlowGenerator
+ * @brief Seedable, high-rate synthetic order flow for stress tests and
+ * backtests
+ *
+ * Generates clustered arrivals across correlated symbols, power-law order
+ * sizes and cancels that react to queue depth, on a per-symbol book of
+ * FIFO price levels. Arrival times are sampled exactly (Dassios-Zhao), not
+ * by thinning, and the random numbers for each batch are drawn and
+ * transformed in tight loops over arrays before the events are applied.
+ * There are no threads and no sleeps: event timestamps are simulated, so
+ * the rate is bounded only by the consumer.
+ *
+ * The random generator and transforms are implemented here rather than
+ * taken from <random>, whose distributions differ between standard
+ * libraries, so a seed produces the same flow on every platform.
+ */
+class OrderFlowGenerator {
+public:
+  /**
+   * @throws std::invalid_argument if the configuration cannot be simulated
+   */
+  explicit OrderFlowGenerator(OrderFlowConfig config);
+
+  /**
+   * @brief Replace the contents of out with the next count events
+   *
+   * The first call is preceded by the ADD events of the initial book,
+   * flagged EVENT_FLAG_SNAPSHOT.
+   */
+  void generate(size_t count, std::vector<OrderFlowEvent>& out);
+
+  const OrderFlowConfig& getConfig() const { return m_config; }
+
+  /**
+   * @brief Timestamp of the latest event
+   */
+  uint64_t getTime() const { return m_time; }
+
+  uint64_t getEventsGenerated() const { return m_eventsGenerated; }
+
+  int64_t getBestBid(uint32_t symbolId) const;
+  int64_t getBestAsk(uint32_t symbolId) const;
+
+  /**
+   * @brief Non-empty levels of one side, best first, as (price, quantity)
+   */
+  std::vector<std::pair<int64_t, int64_t>> getLevels(uint32_t symbolId,
+                                                     EventSide side) const;
+
+  /**
+   * @brief Random numbers drawn per event, in batches of BATCH_SIZE
+   */
+  static constexpr size_t BATCH_SIZE = 1024;
+
+private:
+  struct RestingOrder {
+    uint64_t id;
+    int64_t lots;
+  };
+
+  struct Level {
+    std::deque<RestingOrder> orders;
+    int64_t lots{0};
+  };
+
+  // Levels of one side in a ring; level k is ring[(head + k) % size], at
+  // k ticks away from the best price
+  struct BookSide {
+    std::vector<Level> ring;
+    size_t head{0};
+    int64_t bestTicks{0};
+    int64_t lots{0};
+    int64_t orders{0};
+    bool isBid{true};
+
+    Level& level(size_t k) { return ring[(head + k) % ring.size()]; }
+    const Level& level(size_t k) const {
+      return ring[(head + k) % ring.size()];
+    }
+    int64_t priceTicks(size_t k) const {
+      int64_t offset = static_cast<int64_t>(k);
+      return isBid ? bestTicks - offset : bestTicks + offset;
+    }
+  };
+
+  struct SymbolState {
+    BookSide bids;
+    BookSide asks;
+    int64_t tickFixed;
+    int64_t lotFixed;
+    double excitation{0.0}; // Intensity above the base rate, per second
+  };
+
+  // Random numbers of one batch, already transformed
+  struct Batch {
+    std::array<double, BATCH_SIZE> arrival;    // Exponential(1)
+    std::array<double, BATCH_SIZE> excitation; // ln of a uniform
+    std::array<double, BATCH_SIZE> pick;       // Uniform, symbol
+    std::array<double, BATCH_SIZE> action;     // Uniform, event type
+    std::array<double, BATCH_SIZE> choice;     // Uniform, side and order
+    std::array<double, BATCH_SIZE> placement;  // Exponential(1)
+    std::array<double, BATCH_SIZE> size;       // Pareto lots
+  };
+
+  OrderFlowConfig m_config;
+  std::vector<SymbolState> m_symbols;
+  std::array<uint64_t, 4> m_rng;
+  Batch m_batch;
+  size_t m_batchUsed{BATCH_SIZE};
+
+  uint64_t m_time;
+  double m_timeFraction{0.0}; // Sub-nanosecond remainder of the clock
+  uint64_t m_nextOrderId{1};
+  uint64_t m_eventsGenerated{0};
+  bool m_flowBuys{true};
+
+  // Events are written to m_out; the initial book waits for the first
+  // generate(), and fills past the count asked for for the next one
+  std::vector<OrderFlowEvent>* m_out{nullptr};
+  std::vector<OrderFlowEvent> m_initialBook;
+  std::vector<OrderFlowEvent> m_carry;
+
+  uint64_t nextRandom();
+  double nextUniform();
+  void drawBatch();
+
+  void seedBook(uint32_t symbolId);
+  uint32_t advanceClock(size_t i);
+  void step(size_t i);
+
+  void addLimit(uint32_t symbolId, bool isBid, size_t i);
+  void cancel(uint32_t symbolId, size_t i);
+  void marketOrder(uint32_t symbolId, bool buys, size_t i);
+
+  void restOrder(uint32_t symbolId, BookSide& side, size_t k, int64_t lots,
+                 uint8_t flags);
+  void improve(uint32_t symbolId, BookSide& side);
+  void settleBest(BookSide& side);
+
+  void emit(uint32_t symbolId, OrderFlowAction action, EventSide side,
+            uint64_t orderId, int64_t priceTicks, int64_t lots,
+            int64_t levelLots, uint8_t flags = 0);
+};
+
+} // namespace exchange
+} // namespace pinnacle
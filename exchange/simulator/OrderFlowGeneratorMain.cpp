@@ -0,0 +1,143 @@
+#include "../capture/CaptureRecorder.h"
+#include "OrderFlowGenerator.h"
+#include "OrderFlowSinks.h"
+
+#include <boost/program_options.hpp>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace po = boost::program_options;
+using namespace pinnacle::exchange;
+
+namespace {
+
+// SYMBOL[:PRICE[:TICK[:LOT]]]
+OrderFlowSymbol parseSymbol(const std::string& spec) {
+  OrderFlowSymbol symbol;
+  std::stringstream fields(spec);
+  std::string field;
+  std::getline(fields, symbol.symbol, ':');
+  double* values[] = {&symbol.initialPrice, &symbol.tickSize, &symbol.lotSize};
+  for (double* value : values) {
+    if (!std::getline(fields, field, ':')) {
+      break;
+    }
+    *value = std::stod(field);
+  }
+  return symbol;
+}
+
+} // namespace
+
+// Writes synthetic Coinbase order flow to capture files, for replay through
+// ReplayMarketDataFeed in backtests and feed handler stress tests.
+int main(int argc, char* argv[]) {
+  OrderFlowConfig config;
+  capture::CaptureConfig captureConfig;
+  captureConfig.prefix = "synthetic";
+  captureConfig.source = "coinbase";
+  captureConfig.chunkBuffers = 64;
+  std::vector<std::string> symbols;
+  uint64_t events = 0;
+
+  po::options_description desc("Order flow generator options");
+  desc.add_options()("help", "Show help message")(
+      "symbols",
+      po::value<std::vector<std::string>>(&symbols)
+          ->multitoken()
+          ->default_value({"BTC-USD:50000:0.01:0.001"},
+                          "BTC-USD:50000:0.01:0.001"),
+      "Symbols as SYMBOL[:PRICE[:TICK[:LOT]]]")(
+      "events", po::value<uint64_t>(&events)->default_value(1'000'000),
+      "Order flow events to generate")(
+      "seed", po::value<uint64_t>(&config.seed)->default_value(1),
+      "Random seed")(
+      "rate", po::value<double>(&config.baseRate)->default_value(10000.0),
+      "Base events per second per symbol")(
+      "self-excitation",
+      po::value<double>(&config.selfExcitation)->default_value(0.5),
+      "Events triggered in the same symbol per event")(
+      "cross-excitation",
+      po::value<double>(&config.crossExcitation)->default_value(0.2),
+      "Events triggered across the other symbols per event")(
+      "decay", po::value<double>(&config.decayRate)->default_value(200.0),
+      "Excitation decay rate per second")(
+      "levels", po::value<size_t>(&config.levels)->default_value(20),
+      "Price levels per side")(
+      "tail-exponent",
+      po::value<double>(&config.sizeTailExponent)->default_value(1.5),
+      "Power-law exponent of order sizes")(
+      "output",
+      po::value<std::string>(&captureConfig.directory)
+          ->default_value("captures"),
+      "Capture directory")(
+      "prefix",
+      po::value<std::string>(&captureConfig.prefix)->default_value("synthetic"),
+      "Capture file name prefix");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << e.what() << "\n" << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+
+  config.startTime = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+
+  std::unique_ptr<OrderFlowGenerator> generator;
+  try {
+    config.symbols.clear();
+    for (const auto& spec : symbols) {
+      config.symbols.push_back(parseSymbol(spec));
+    }
+    generator = std::make_unique<OrderFlowGenerator>(config);
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid order flow: " << e.what() << std::endl;
+    return 1;
+  }
+
+  capture::CaptureRecorder recorder(captureConfig);
+  if (!recorder.start()) {
+    return 1;
+  }
+  OrderFlowCaptureWriter writer(config, recorder);
+
+  auto started = std::chrono::steady_clock::now();
+  std::vector<OrderFlowEvent> batch;
+  uint64_t remaining = events;
+  while (remaining > 0) {
+    size_t count = static_cast<size_t>(std::min<uint64_t>(remaining, 65536));
+    generator->generate(count, batch);
+    writer.write(batch);
+    remaining -= count;
+  }
+  recorder.stop();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - started)
+                       .count();
+
+  spdlog::info("Generated {} events ({:.0f}/s) spanning {:.3f}s of market "
+               "time: {} frames, {} dropped",
+               events, static_cast<double>(events) / seconds,
+               static_cast<double>(generator->getTime() - config.startTime) /
+                   1e9,
+               writer.getFramesWritten(), recorder.getFramesDropped());
+  for (const auto& file : recorder.getFilesWritten()) {
+    std::cout << file << std::endl;
+  }
+  return recorder.getFramesDropped() == 0 ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+#include "OrderFlowSinks.h"
+#include "../connector/JsonCursor.h"
+
+#include <charconv>
+#include <ctime>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+std::vector<std::string> symbolNames(const OrderFlowConfig& config) {
+  std::vector<std::string> names;
+  for (const auto& symbol : config.symbols) {
+    names.push_back(symbol.symbol);
+  }
+  return names;
+}
+
+void appendInteger(std::string& out, uint64_t value, int width = 0) {
+  char digits[24];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  for (int pad = width - static_cast<int>(result.ptr - digits); pad > 0;
+       --pad) {
+    out += '0';
+  }
+  out.append(digits, result.ptr);
+}
+
+// Fixed point as a decimal string without trailing zeros
+void appendDecimal(std::string& out, int64_t value) {
+  if (value < 0) {
+    out += '-';
+    value = -value;
+  }
+  appendInteger(out, static_cast<uint64_t>(value / FIXED_POINT_SCALE));
+  auto fraction = static_cast<uint64_t>(value % FIXED_POINT_SCALE);
+  if (fraction == 0) {
+    return;
+  }
+  int width = 8;
+  while (fraction % 10 == 0) {
+    fraction /= 10;
+    --width;
+  }
+  out += '.';
+  appendInteger(out, fraction, width);
+}
+
+// RFC 3339 UTC with nanoseconds, as Coinbase stamps its messages
+void appendTimestamp(std::string& out, uint64_t nanos) {
+  std::time_t seconds = static_cast<std::time_t>(nanos / 1'000'000'000);
+  std::tm utc{};
+  gmtime_r(&seconds, &utc);
+  char text[32];
+  size_t length = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &utc);
+  out.append(text, length);
+  out += '.';
+  appendInteger(out, nanos % 1'000'000'000, 9);
+  out += 'Z';
+}
+
+bool isSnapshot(const OrderFlowEvent& event) {
+  return (event.flags & EVENT_FLAG_SNAPSHOT) != 0;
+}
+
+// Book side of the level an event changes; a TRADE names the aggressor
+EventSide bookSide(const OrderFlowEvent& event) {
+  if (event.action != OrderFlowAction::TRADE) {
+    return event.side;
+  }
+  return event.side == EventSide::BID ? EventSide::ASK : EventSide::BID;
+}
+
+} // namespace
+
+// ============================================================================
+// OrderFlowCaptureWriter
+// ============================================================================
+
+OrderFlowCaptureWriter::OrderFlowCaptureWriter(
+    const OrderFlowConfig& config, capture::CaptureRecorder& recorder)
+    : m_symbols(symbolNames(config)), m_recorder(recorder) {}
+
+bool OrderFlowCaptureWriter::write(std::span<const OrderFlowEvent> events) {
+  bool recorded = true;
+  size_t begin = 0;
+  while (begin < events.size()) {
+    const OrderFlowEvent& first = events[begin];
+    size_t end = begin + 1;
+    while (end < events.size() && events[end].symbolId == first.symbolId &&
+           events[end].timestamp == first.timestamp &&
+           isSnapshot(events[end]) == isSnapshot(first)) {
+      ++end;
+    }
+    recorded &= writeGroup(events.subspan(begin, end - begin));
+    begin = end;
+  }
+  return recorded;
+}
+
+bool OrderFlowCaptureWriter::writeGroup(
+    std::span<const OrderFlowEvent> group) {
+  const OrderFlowEvent& first = group.front();
+  const std::string& symbol = m_symbols[first.symbolId];
+
+  m_book.clear();
+  m_book += R"({"channel":"l2_data","client_id":"","timestamp":")";
+  appendTimestamp(m_book, first.timestamp);
+  m_book += R"(","sequence_num":)";
+  appendInteger(m_book, m_sequence++);
+  m_book += R"(,"events":[{"type":")";
+  m_book += isSnapshot(first) ? "snapshot" : "update";
+  m_book += R"(","product_id":")";
+  m_book += symbol;
+  m_book += R"(","updates":[)";
+
+  for (size_t i = 0; i < group.size(); ++i) {
+    const OrderFlowEvent& event = group[i];
+    EventSide side = bookSide(event);
+    // Only the last change to a level within the frame is sent
+    if (i + 1 < group.size() && group[i + 1].price == event.price &&
+        bookSide(group[i + 1]) == side) {
+      continue;
+    }
+    if (m_book.back() == '}') {
+      m_book += ',';
+    }
+    m_book += R"({"side":")";
+    m_book += side == EventSide::BID ? "bid" : "offer";
+    m_book += R"(","event_time":")";
+    appendTimestamp(m_book, event.timestamp);
+    m_book += R"(","price_level":")";
+    appendDecimal(m_book, event.price);
+    m_book += R"(","new_quantity":")";
+    appendDecimal(m_book, event.levelQuantity);
+    m_book += R"("})";
+  }
+  m_book += "]}]}";
+
+  bool recorded = m_recorder.record(m_book, first.timestamp);
+
+  for (const auto& event : group) {
+    if (event.action != OrderFlowAction::TRADE) {
+      continue;
+    }
+    m_ticker.clear();
+    m_ticker += R"({"channel":"ticker","client_id":"","timestamp":")";
+    appendTimestamp(m_ticker, event.timestamp);
+    m_ticker += R"(","sequence_num":)";
+    appendInteger(m_ticker, m_sequence++);
+    m_ticker += R"(,"events":[{"type":"update","tickers":[{"type":"ticker",)";
+    m_ticker += R"("product_id":")";
+    m_ticker += symbol;
+    m_ticker += R"(","price":")";
+    appendDecimal(m_ticker, event.price);
+    m_ticker += R"(","last_size":")";
+    appendDecimal(m_ticker, event.quantity);
+    m_ticker += R"("}]}]})";
+    recorded &= m_recorder.record(m_ticker, event.timestamp);
+  }
+  return recorded;
+}
+
+// ============================================================================
+// OrderFlowBookWriter
+// ============================================================================
+
+OrderFlowBookWriter::OrderFlowBookWriter(
+    const OrderFlowConfig& config,
+    std::vector<std::shared_ptr<OrderBook>> books)
+    : m_symbols(symbolNames(config)), m_books(std::move(books)) {
+  m_books.resize(m_symbols.size());
+  for (const auto& symbol : config.symbols) {
+    m_halfLots.push_back(symbol.lotSize / 2.0);
+  }
+}
+
+size_t OrderFlowBookWriter::apply(std::span<const OrderFlowEvent> events) {
+  constexpr double SCALE = static_cast<double>(FIXED_POINT_SCALE);
+  size_t rejected = 0;
+  for (const auto& event : events) {
+    OrderBook* book = m_books[event.symbolId].get();
+    if (!book) {
+      continue;
+    }
+
+    std::string orderId = std::to_string(event.orderId);
+    double quantity = static_cast<double>(event.quantity) / SCALE;
+    bool applied = false;
+    switch (event.action) {
+    case OrderFlowAction::ADD:
+      applied = book->addOrder(std::make_shared<Order>(
+          orderId, m_symbols[event.symbolId],
+          event.side == EventSide::BID ? OrderSide::BUY : OrderSide::SELL,
+          OrderType::LIMIT, static_cast<double>(event.price) / SCALE,
+          quantity, event.timestamp));
+      break;
+    case OrderFlowAction::CANCEL:
+      applied = book->cancelOrder(orderId);
+      break;
+    case OrderFlowAction::TRADE: {
+      auto order = book->getOrder(orderId);
+      if (!order) {
+        break;
+      }
+      // Lot sizes are not exact in binary, so a fill that leaves less
+      // than half a lot fills the order, and whatever rounding leaves of it
+      // is removed
+      double remaining = order->getRemainingQuantity();
+      if (quantity < remaining - m_halfLots[event.symbolId]) {
+        applied = book->executeOrder(orderId, quantity);
+        break;
+      }
+      applied = book->executeOrder(orderId, remaining);
+      if (book->getOrder(orderId)) {
+        applied = book->cancelOrder(orderId);
+      }
+      break;
+    }
+    }
+    rejected += applied ? 0 : 1;
+  }
+  return rejected;
+}
+
+// ============================================================================
+// MarketEvent conversion
+// ============================================================================
+
+void appendMarketEvents(const OrderFlowConfig& config,
+                        std::span<const OrderFlowEvent> events,
+                        MarketEventBuffer& out) {
+  const OrderFlowEvent* previous = nullptr;
+  for (const auto& event : events) {
+    uint32_t symbolId = out.symbol(config.symbols[event.symbolId].symbol);
+    bool startsSnapshot =
+        isSnapshot(event) &&
+        (!previous || !isSnapshot(*previous) ||
+         previous->symbolId != event.symbolId);
+    previous = &event;
+
+    if (startsSnapshot) {
+      MarketEvent& reset = out.append(MarketEventType::BOOK_RESET, symbolId);
+      reset.venueTimestamp = event.timestamp;
+      reset.flags = EVENT_FLAG_SNAPSHOT;
+    }
+    if (event.action == OrderFlowAction::TRADE) {
+      MarketEvent& trade = out.append(MarketEventType::TRADE, symbolId);
+      trade.venueTimestamp = event.timestamp;
+      trade.price = event.price;
+      trade.quantity = event.quantity;
+      trade.side = event.side;
+    }
+
+    MarketEvent& delta = out.append(MarketEventType::BOOK_DELTA, symbolId);
+    delta.venueTimestamp = event.timestamp;
+    delta.price = event.price;
+    delta.quantity = event.levelQuantity;
+    delta.side = bookSide(event);
+    delta.flags = event.flags;
+  }
+}
+
+} // namespace exchange
+} // namespace pinnacle
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../core/orderbook/OrderBook.h"
+#include "../capture/CaptureRecorder.h"
+#include "OrderFlowGenerator.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @class OrderFlowCaptureWriter
+ * @brief Records generated order flow as Coinbase Advanced Trade frames
+ *
+ * The events of one symbol at one timestamp become one l2_data frame of
+ * level updates, a snapshot for the initial book, and each fill also
+ * becomes a ticker frame with its price and size. Frames are received at
+ * the event timestamp and carry a connection sequence_num, so the capture
+ * replays through ReplayMarketDataFeed like a recorded Coinbase session.
+ */
+class OrderFlowCaptureWriter {
+public:
+  OrderFlowCaptureWriter(const OrderFlowConfig& config,
+                         capture::CaptureRecorder& recorder);
+
+  /**
+   * @brief Record the frames of a batch of events
+   *
+   * @return false if the recorder dropped a frame
+   */
+  bool write(std::span<const OrderFlowEvent> events);
+
+  uint64_t getFramesWritten() const { return m_sequence; }
+
+private:
+  std::vector<std::string> m_symbols;
+  capture::CaptureRecorder& m_recorder;
+  uint64_t m_sequence{0};
+
+  // Reused between frames
+  std::string m_book;
+  std::string m_ticker;
+
+  bool writeGroup(std::span<const OrderFlowEvent> group);
+};
+
+/**
+ * @class OrderFlowBookWriter
+ * @brief Applies generated order flow to OrderBooks, order by order
+ *
+ * Books are indexed by symbol id; a null entry skips that symbol. Every
+ * event maps to an OrderBook call: ADD to addOrder, CANCEL to cancelOrder
+ * and TRADE to executeOrder on the resting order, so the books end up
+ * with the generator's orders in the generator's queue order.
+ */
+class OrderFlowBookWriter {
+public:
+  OrderFlowBookWriter(const OrderFlowConfig& config,
+                      std::vector<std::shared_ptr<OrderBook>> books);
+
+  /**
+   * @return Number of events an OrderBook rejected
+   */
+  size_t apply(std::span<const OrderFlowEvent> events);
+
+private:
+  std::vector<std::string> m_symbols;
+  std::vector<std::shared_ptr<OrderBook>> m_books;
+  std::vector<double> m_halfLots;
+};
+
+/**
+ * @brief Append the normalized events of a batch of order flow
+ *
+ * The caller resets the buffer. Book changes become BOOK_DELTA events at
+ * the quantity left on the level, preceded by a BOOK_RESET where a
+ * symbol's initial book starts, and fills also become TRADE events.
+ */
+void appendMarketEvents(const OrderFlowConfig& config,
+                        std::span<const OrderFlowEvent> events,
+                        MarketEventBuffer& out);
+
+} // namespace exchange
+} // namespace pinnacle
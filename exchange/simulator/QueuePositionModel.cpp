@@ -0,0 +1,122 @@
+#include "QueuePositionModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pinnacle {
+namespace exchange {
+
+namespace {
+
+// Prices come from tick rounding on both sides, so only rounding noise
+// separates equal ones
+bool samePrice(double a, double b) {
+  return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(a));
+}
+
+// Whether a trade at tradePrice went through a resting price, leaving
+// nothing at that price
+bool tradedThrough(OrderSide restingSide, double restingPrice,
+                   double tradePrice) {
+  return restingSide == OrderSide::SELL ? tradePrice > restingPrice
+                                        : tradePrice < restingPrice;
+}
+
+constexpr double EPSILON = 1e-12;
+
+} // namespace
+
+void QueuePositionModel::addOrder(const std::string& orderId, OrderSide side,
+                                  double price, double quantity,
+                                  double queueAhead) {
+  if (quantity <= 0.0) {
+    return;
+  }
+  m_orders.push_back(
+      {orderId, side, price, quantity, std::max(queueAhead, 0.0)});
+}
+
+bool QueuePositionModel::removeOrder(const std::string& orderId) {
+  auto it = std::find_if(
+      m_orders.begin(), m_orders.end(),
+      [&](const QueuedOrder& order) { return order.orderId == orderId; });
+  if (it == m_orders.end()) {
+    return false;
+  }
+  m_orders.erase(it);
+  return true;
+}
+
+void QueuePositionModel::onTrade(OrderSide restingSide, double price,
+                                 double quantity,
+                                 std::vector<QueueFill>& fills) {
+  // Volume left of the trade, and how much of it went to others ahead of
+  // the order being looked at
+  double traded = quantity;
+  double othersFilled = 0.0;
+
+  for (auto& order : m_orders) {
+    if (order.side != restingSide) {
+      continue;
+    }
+    double fill = 0.0;
+    if (tradedThrough(restingSide, order.price, price)) {
+      fill = order.remaining;
+    } else if (samePrice(order.price, price)) {
+      double reaching = std::clamp(order.ahead - othersFilled, 0.0, traded);
+      traded -= reaching;
+      othersFilled += reaching;
+      order.ahead = std::max(order.ahead - othersFilled, 0.0);
+      if (order.ahead <= EPSILON) {
+        order.ahead = 0.0;
+        fill = std::min(traded, order.remaining);
+        traded -= fill;
+      }
+    } else {
+      continue;
+    }
+
+    if (fill > 0.0) {
+      order.remaining -= fill;
+      if (order.remaining <= EPSILON) {
+        order.remaining = 0.0;
+      }
+      fills.push_back({order.orderId, order.price, fill, order.remaining});
+    }
+  }
+
+  m_orders.erase(std::remove_if(m_orders.begin(), m_orders.end(),
+                                [](const QueuedOrder& order) {
+                                  return order.remaining == 0.0;
+                                }),
+                 m_orders.end());
+}
+
+void QueuePositionModel::onCancel(OrderSide side, double price,
+                                  double quantity, double levelQuantity) {
+  if (quantity <= 0.0) {
+    return;
+  }
+  for (auto& order : m_orders) {
+    if (order.side != side || !samePrice(order.price, price)) {
+      continue;
+    }
+    if (quantity >= levelQuantity) {
+      order.ahead = 0.0;
+    } else {
+      order.ahead = std::max(
+          order.ahead - quantity * (order.ahead / levelQuantity), 0.0);
+    }
+  }
+}
+
+const QueuePositionModel::QueuedOrder*
+QueuePositionModel::find(const std::string& orderId) const {
+  auto it = std::find_if(
+      m_orders.begin(), m_orders.end(),
+      [&](const QueuedOrder& order) { return order.orderId == orderId; });
+  return it == m_orders.end() ? nullptr : &*it;
+}
+
+} // namespace exchange
+} // namespace pinnacle
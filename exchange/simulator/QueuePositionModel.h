@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../../core/orderbook/Order.h"
+
+#include <string>
+#include <vector>
+
+namespace pinnacle {
+namespace exchange {
+
+/**
+ * @struct QueueFill
+ * @brief A fill of one of our resting orders
+ */
+struct QueueFill {
+  std::string orderId;
+  double price;
+  double quantity;
+  double remaining; // 0 once the order is done
+};
+
+/**
+ * @class QueuePositionModel
+ * @brief Estimates where our resting orders stand in their price level's
+ * queue, and fills them when the volume ahead has traded
+ *
+ * Our orders are not in the book that the rest of the market trades
+ * against, only shadowed next to it: each one starts behind the volume
+ * resting at its price when it arrives. Trades at the price consume that
+ * volume first, then fill us; a trade through the price fills us outright.
+ * Cancels by others come from anywhere in the queue, so a cancel removes
+ * volume ahead of us in proportion to the share of the level that is
+ * ahead. Volume that joins later queues behind us.
+ *
+ * Fills do not take liquidity from the book, so a simulation shadowing
+ * large orders overstates what the market would have given them.
+ *
+ * Not thread-safe.
+ */
+class QueuePositionModel {
+public:
+  struct QueuedOrder {
+    std::string orderId;
+    OrderSide side;
+    double price;
+    double remaining;
+    double ahead; // Others' volume ahead of us at the price
+  };
+
+  /**
+   * @brief Join the back of a level
+   *
+   * @param queueAhead Volume resting at the price when the order arrives
+   */
+  void addOrder(const std::string& orderId, OrderSide side, double price,
+                double quantity, double queueAhead);
+
+  /**
+   * @brief Take an order out of its queue, as for a cancel
+   *
+   * @return false if the order is not resting
+   */
+  bool removeOrder(const std::string& orderId);
+
+  /**
+   * @brief Others traded against resting orders
+   *
+   * @param restingSide Side of the resting orders that traded: SELL for a
+   * buy that lifted the offer
+   * @param fills Our fills are appended, in queue order
+   */
+  void onTrade(OrderSide restingSide, double price, double quantity,
+               std::vector<QueueFill>& fills);
+
+  /**
+   * @brief Others' resting volume left a level without trading
+   *
+   * @param levelQuantity Others' volume at the price before it left
+   */
+  void onCancel(OrderSide side, double price, double quantity,
+                double levelQuantity);
+
+  /**
+   * @brief A resting order, or nullptr
+   */
+  const QueuedOrder* find(const std::string& orderId) const;
+
+  const std::vector<QueuedOrder>& getOrders() const { return m_orders; }
+
+  size_t size() const { return m_orders.size(); }
+  bool empty() const { return m_orders.empty(); }
+
+  void clear() { m_orders.clear(); }
+
+private:
+  // Resting orders in arrival order, which is also queue order at a price
+  std::vector<QueuedOrder> m_orders;
+};
+
+} // namespace exchange
+} // namespace pinnacle
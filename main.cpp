@@ -12,6 +12,10 @@
 #include "core/utils/JsonLogger.h"
 #include "core/utils/SecureInput.h"
 #include "core/utils/TimeUtils.h"
+#include "exchange/capture/CaptureReader.h"
+#include "exchange/capture/CaptureRecorder.h"
+#include "exchange/capture/ReplayMarketDataFeed.h"
+#include "exchange/connector/ConflationStage.h"
 #include "exchange/connector/ExchangeConnectorFactory.h"
 #include "exchange/connector/SecureConfig.h"
 #include "exchange/simulator/ExchangeSimulator.h"
@@ -165,7 +169,7 @@ int main(int argc, char* argv[]) {
         "symbol", po::value<std::string>()->default_value("BTC-USD"),
         "Trading symbol")("mode",
                           po::value<std::string>()->default_value("simulation"),
-                          "Trading mode (simulation/live/backtest)")(
+                          "Trading mode (simulation/live/replay/backtest)")(
         "config",
         po::value<std::string>()->default_value("config/default_config.json"),
         "Configuration file")(
@@ -216,7 +220,14 @@ int main(int argc, char* argv[]) {
                 "arb-min-spread", po::value<double>()->default_value(5.0),
                 "Minimum spread in bps for arbitrage")(
                 "arb-dry-run", po::bool_switch()->default_value(true),
-                "Arbitrage dry-run mode (log only, no execution)");
+                "Arbitrage dry-run mode (log only, no execution)")(
+                "capture-dir", po::value<std::string>(),
+                "Record raw live market data frames to this directory")(
+                "replay-dir",
+                po::value<std::string>()->default_value("captures"),
+                "Capture directory replayed in replay mode")(
+                "replay-speed", po::value<double>()->default_value(1.0),
+                "Replay speed multiplier (0 = as fast as possible)");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -571,7 +582,9 @@ int main(int argc, char* argv[]) {
                                                                         config);
     }
 
-    if (!strategy->initialize(orderBook)) {
+    // Live orders go to the exchange; otherwise the mode stands in for it
+    if (!strategy->initialize(orderBook,
+                              mode == "live" ? exchangeName : mode)) {
       spdlog::error("Failed to initialize strategy");
       return 1;
     }
@@ -632,7 +645,8 @@ int main(int argc, char* argv[]) {
             std::make_shared<pinnacle::strategy::MLEnhancedMarketMaker>(
                 symbol, config, mlCfg);
         auto btOrderBook = std::make_shared<pinnacle::OrderBook>(symbol);
-        if (!btStrategy->initialize(btOrderBook) || !btStrategy->start()) {
+        if (!btStrategy->initialize(btOrderBook, "backtest") ||
+            !btStrategy->start()) {
           spdlog::error("Failed to initialize backtest strategy");
           strategy->stop();
           if (varEngine)
@@ -707,6 +721,26 @@ int main(int argc, char* argv[]) {
 
     // In simulation mode, start the exchange simulator - also in live mode
     std::shared_ptr<pinnacle::exchange::ExchangeSimulator> simulator;
+    std::shared_ptr<pinnacle::exchange::MarketDataFeed> marketDataFeed;
+    std::shared_ptr<pinnacle::exchange::capture::CaptureRecorder>
+        captureRecorder;
+
+    if (mode == "replay") {
+      // Play recorded frames through the same decoder as the live feed
+      std::string replayDir = vm["replay-dir"].as<std::string>();
+      auto captures =
+          pinnacle::exchange::capture::CaptureReader::listCaptures(replayDir);
+      if (captures.empty()) {
+        spdlog::error("No capture files found in {}", replayDir);
+        return 1;
+      }
+      marketDataFeed =
+          std::make_shared<pinnacle::exchange::capture::ReplayMarketDataFeed>(
+              captures, vm["replay-speed"].as<double>());
+      spdlog::info("Replaying {} capture files from {} at speed {}",
+                   captures.size(), replayDir,
+                   vm["replay-speed"].as<double>());
+    }
 
     if (mode == "live") {
       // Get master password for secure configuration
@@ -729,22 +763,38 @@ int main(int argc, char* argv[]) {
       }
 
       // Get market data feed for the specified exchange
-      auto marketDataFeed = factory.getMarketDataFeed(exchangeName);
+      marketDataFeed = factory.getMarketDataFeed(exchangeName);
       if (!marketDataFeed) {
         spdlog::error("Failed to create market data feed");
         return 1;
       }
 
+      auto webSocketFeed = std::dynamic_pointer_cast<
+          pinnacle::exchange::WebSocketMarketDataFeed>(marketDataFeed);
+
       // Set JSON logger for market data feed if enabled
-      if (jsonLogger) {
-        // Cast to WebSocketMarketDataFeed and set JSON logger
-        auto webSocketFeed = std::dynamic_pointer_cast<
-            pinnacle::exchange::WebSocketMarketDataFeed>(marketDataFeed);
-        if (webSocketFeed) {
-          webSocketFeed->setJsonLogger(jsonLogger);
+      if (jsonLogger && webSocketFeed) {
+        webSocketFeed->setJsonLogger(jsonLogger);
+      }
+
+      // Record raw frames for later replay if requested
+      if (vm.count("capture-dir") && webSocketFeed) {
+        pinnacle::exchange::capture::CaptureConfig captureConfig;
+        captureConfig.directory = vm["capture-dir"].as<std::string>();
+        captureConfig.prefix = exchangeName;
+        captureConfig.source = exchangeName;
+        captureRecorder =
+            std::make_shared<pinnacle::exchange::capture::CaptureRecorder>(
+                captureConfig);
+        if (!captureRecorder->start()) {
+          spdlog::error("Failed to start market data capture");
+          return 1;
         }
+        webSocketFeed->setCaptureRecorder(captureRecorder);
       }
+    }
 
+    if (marketDataFeed) {
       // Subscribe to market data and connect to order book
       marketDataFeed->subscribeToOrderBookUpdates(
           symbol, [orderBook,
@@ -779,13 +829,25 @@ int main(int argc, char* argv[]) {
             strategy->onMarketUpdate(update);
           });
 
+      // ML analytics read a conflated view of the feed on their own thread,
+      // so they cannot hold up the feed or the quoting loop
+      if (auto mlStrategy = std::dynamic_pointer_cast<
+              pinnacle::strategy::MLEnhancedMarketMaker>(strategy)) {
+        auto conflation =
+            std::make_shared<pinnacle::exchange::ConflationStage>();
+        mlStrategy->setConflationStage(conflation);
+        conflation->attach(*marketDataFeed);
+      }
+
       // Start market data feed
       if (!marketDataFeed->start()) {
         spdlog::error("Failed to start market data feed");
         return 1;
       }
 
-      spdlog::info("Connected to live exchange: {}", exchangeName);
+      if (mode == "live") {
+        spdlog::info("Connected to live exchange: {}", exchangeName);
+      }
     } else {
       simulator =
           std::make_shared<pinnacle::exchange::ExchangeSimulator>(orderBook);
@@ -890,6 +952,14 @@ int main(int argc, char* argv[]) {
       simulator->stop();
     }
 
+    // Stop the market data feed before the capture it records into
+    if (marketDataFeed) {
+      marketDataFeed->stop();
+    }
+    if (captureRecorder) {
+      captureRecorder->stop();
+    }
+
     spdlog::info("Final statistics:");
     spdlog::info("{}", strategy->getStatistics());
 
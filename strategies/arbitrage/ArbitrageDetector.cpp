@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <spdlog/spdlog.h>
 #include <sstream>
 
@@ -9,7 +10,28 @@ namespace pinnacle {
 namespace arbitrage {
 
 ArbitrageDetector::ArbitrageDetector(const ArbitrageConfig& config)
-    : m_config(config) {}
+    : m_config(config) {
+  for (const auto& venue : m_config.venues) {
+    if (m_venueIndex.emplace(venue, m_venueFees.size()).second) {
+      auto feeIt = m_config.venueFees.find(venue);
+      m_venueFees.push_back(feeIt != m_config.venueFees.end() ? feeIt->second
+                                                              : 0.0);
+    }
+  }
+
+  for (const auto& symbol : m_config.symbols) {
+    if (!m_symbolIndex.emplace(symbol, m_books.size()).second) {
+      continue;
+    }
+    auto book = std::make_unique<SymbolBook>();
+    book->quotes.resize(m_venueFees.size());
+    book->netBids.resize(m_venueFees.size(), 0.0);
+    book->netAsks.resize(m_venueFees.size(), 0.0);
+    book->bidOrder.reserve(m_venueFees.size());
+    book->askOrder.reserve(m_venueFees.size());
+    m_books.push_back(std::move(book));
+  }
+}
 
 ArbitrageDetector::~ArbitrageDetector() { stop(); }
 
@@ -21,6 +43,17 @@ bool ArbitrageDetector::start() {
     return true; // Already running
   }
 
+  // Pick up quotes that arrived while stopped
+  for (const auto& [symbol, index] : m_symbolIndex) {
+    std::vector<ArbitrageOpportunity> emitted;
+    {
+      auto& book = *m_books[index];
+      std::lock_guard<std::mutex> lock(book.mutex);
+      evaluate(symbol, book, SIZE_MAX, &emitted);
+    }
+    notify(emitted);
+  }
+
   try {
     m_scanThread = std::thread(&ArbitrageDetector::scanLoop, this);
   } catch (const std::exception& e) {
@@ -59,21 +92,45 @@ void ArbitrageDetector::updateVenueQuote(const std::string& venue,
                                          const std::string& symbol, double bid,
                                          double bidSize, double ask,
                                          double askSize, uint64_t timestamp) {
-  VenueQuote quote;
-  quote.bidPrice = bid;
-  quote.bidSize = bidSize;
-  quote.askPrice = ask;
-  quote.askSize = askSize;
-  quote.timestamp = timestamp;
-
-  std::lock_guard<std::mutex> lock(m_quotesMutex);
-  m_quotes[venue][symbol] = quote;
+  auto symbolIt = m_symbolIndex.find(symbol);
+  auto venueIt = m_venueIndex.find(venue);
+  if (symbolIt == m_symbolIndex.end() || venueIt == m_venueIndex.end()) {
+    return;
+  }
+  size_t venueIndex = venueIt->second;
+
+  std::vector<ArbitrageOpportunity> emitted;
+  {
+    auto& book = *m_books[symbolIt->second];
+    std::lock_guard<std::mutex> lock(book.mutex);
+
+    auto& quote = book.quotes[venueIndex];
+    quote.bidPrice = bid;
+    quote.bidSize = bidSize;
+    quote.askPrice = ask;
+    quote.askSize = askSize;
+    quote.timestamp = timestamp;
+    reposition(book, venueIndex);
+
+    if (!m_running.load(std::memory_order_acquire)) {
+      return;
+    }
+    evaluate(symbol, book, venueIndex, &emitted);
+  }
+
+  // Callback runs outside the book lock so it may query the detector
+  notify(emitted);
 }
 
 std::vector<ArbitrageOpportunity>
 ArbitrageDetector::getCurrentOpportunities() const {
-  std::lock_guard<std::mutex> lock(m_opportunitiesMutex);
-  return m_opportunities;
+  std::vector<ArbitrageOpportunity> opportunities;
+  for (const auto& book : m_books) {
+    std::lock_guard<std::mutex> lock(book->mutex);
+    opportunities.insert(opportunities.end(), book->opportunities.begin(),
+                         book->opportunities.end());
+  }
+  return opportunities;
 }
 
 void ArbitrageDetector::setOpportunityCallback(OpportunityCallback callback) {
@@ -86,6 +143,8 @@ std::string ArbitrageDetector::getStatistics() const {
   oss << "ArbitrageDetector Statistics:\n";
   oss << "  Total scans: " << m_totalScans.load(std::memory_order_relaxed)
       << "\n";
+  oss << "  Total evaluations: "
+      << m_totalEvaluations.load(std::memory_order_relaxed) << "\n";
   oss << "  Total opportunities: "
       << m_totalOpportunities.load(std::memory_order_relaxed) << "\n";
   oss << "  Dry run: " << (m_config.dryRun ? "yes" : "no") << "\n";
@@ -109,115 +168,95 @@ uint64_t ArbitrageDetector::getTotalOpportunitiesDetected() const {
 
 void ArbitrageDetector::scanLoop() {
   while (m_running.load(std::memory_order_acquire)) {
-    std::vector<ArbitrageOpportunity> allOpps;
-
-    for (const auto& symbol : m_config.symbols) {
-      auto opps = detectOpportunities(symbol);
-      allOpps.insert(allOpps.end(), opps.begin(), opps.end());
+    for (const auto& [symbol, index] : m_symbolIndex) {
+      auto& book = *m_books[index];
+      std::lock_guard<std::mutex> lock(book.mutex);
+      evaluate(symbol, book, SIZE_MAX, nullptr);
     }
 
     m_totalScans.fetch_add(1, std::memory_order_relaxed);
 
-    // Save a copy for callbacks before moving into shared state
-    size_t newOppsCount = allOpps.size();
-    std::vector<ArbitrageOpportunity> callbackOpps;
-    if (newOppsCount > 0) {
-      callbackOpps = allOpps;
-    }
-
-    // Update current opportunities
-    {
-      std::lock_guard<std::mutex> lock(m_opportunitiesMutex);
-      m_opportunities = std::move(allOpps);
-    }
-
-    // Fire callbacks outside any lock to prevent deadlock
-    // (callback may call getCurrentOpportunities() which locks
-    // m_opportunitiesMutex)
-    if (newOppsCount > 0) {
-      m_totalOpportunities.fetch_add(newOppsCount, std::memory_order_relaxed);
-
-      OpportunityCallback cb;
-      {
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        cb = m_callback;
-      }
-
-      if (cb) {
-        for (const auto& opp : callbackOpps) {
-          cb(opp);
-        }
-      }
-    }
-
     std::this_thread::sleep_for(
         std::chrono::milliseconds(m_config.scanIntervalMs));
   }
 }
 
-std::vector<ArbitrageOpportunity>
-ArbitrageDetector::detectOpportunities(const std::string& symbol) const {
-  std::vector<ArbitrageOpportunity> opportunities;
-
-  // Collect non-stale quotes for this symbol across venues under the lock
-  struct VenueData {
-    std::string venue;
-    VenueQuote quote;
-    double fee;
+void ArbitrageDetector::reposition(SymbolBook& book, size_t venue) const {
+  auto removeVenue = [venue](std::vector<size_t>& order) {
+    auto it = std::find(order.begin(), order.end(), venue);
+    if (it != order.end()) {
+      order.erase(it);
+    }
   };
+  removeVenue(book.bidOrder);
+  removeVenue(book.askOrder);
 
-  std::vector<VenueData> venueData;
-  {
-    std::lock_guard<std::mutex> lock(m_quotesMutex);
-    for (const auto& venue : m_config.venues) {
-      auto venueIt = m_quotes.find(venue);
-      if (venueIt == m_quotes.end()) {
-        continue;
-      }
-
-      auto symbolIt = venueIt->second.find(symbol);
-      if (symbolIt == venueIt->second.end()) {
-        continue;
-      }
-
-      const auto& quote = symbolIt->second;
-      if (isStale(quote)) {
-        continue;
-      }
+  const auto& quote = book.quotes[venue];
+  if (quote.bidPrice <= 0 || quote.askPrice <= 0) {
+    return;
+  }
 
-      if (quote.bidPrice <= 0 || quote.askPrice <= 0) {
-        continue;
-      }
+  // Fee-adjusted prices make the net spread of a pair netBid - netAsk
+  double fee = m_venueFees[venue];
+  book.netBids[venue] = quote.bidPrice * (1.0 - fee);
+  book.netAsks[venue] = quote.askPrice * (1.0 + fee);
+
+  auto bidPos = std::upper_bound(
+      book.bidOrder.begin(), book.bidOrder.end(), book.netBids[venue],
+      [&book](double value, size_t other) {
+        return value > book.netBids[other];
+      });
+  book.bidOrder.insert(bidPos, venue);
+
+  auto askPos = std::upper_bound(
+      book.askOrder.begin(), book.askOrder.end(), book.netAsks[venue],
+      [&book](double value, size_t other) {
+        return value < book.netAsks[other];
+      });
+  book.askOrder.insert(askPos, venue);
+}
 
-      venueData.push_back({venue, quote, getVenueFee(venue)});
-    }
-  } // lock released — all data is in local venueData
+void ArbitrageDetector::evaluate(const std::string& symbol, SymbolBook& book,
+                                 size_t emitVenue,
+                                 std::vector<ArbitrageOpportunity>* emitted) {
+  m_totalEvaluations.fetch_add(1, std::memory_order_relaxed);
+  book.opportunities.clear();
+  if (book.bidOrder.empty()) {
+    return;
+  }
 
-  // Compare all venue pairs for arbitrage (no lock held)
   uint64_t now = utils::TimeUtils::getCurrentNanos();
+  double bestNetBid = book.netBids[book.bidOrder.front()];
+
+  // Only pairs whose net bid exceeds the net ask can pay, so both walks stop
+  // at the first venue that no longer crosses
+  for (size_t buyVenue : book.askOrder) {
+    double netAsk = book.netAsks[buyVenue];
+    if (netAsk >= bestNetBid) {
+      break;
+    }
+    const auto& buyer = book.quotes[buyVenue];
+    if (isStale(buyer, now)) {
+      continue;
+    }
 
-  for (size_t i = 0; i < venueData.size(); ++i) {
-    for (size_t j = 0; j < venueData.size(); ++j) {
-      if (i == j) {
-        continue;
+    for (size_t sellVenue : book.bidOrder) {
+      if (book.netBids[sellVenue] <= netAsk) {
+        break;
       }
-
-      const auto& buyer = venueData[i];  // Buy at this venue's ask
-      const auto& seller = venueData[j]; // Sell at this venue's bid
-
-      double buyPrice = buyer.quote.askPrice;
-      double sellPrice = seller.quote.bidPrice;
-
-      // Gross spread
-      double spread = sellPrice - buyPrice;
-      if (spread <= 0) {
+      const auto& seller = book.quotes[sellVenue];
+      if (sellVenue == buyVenue || isStale(seller, now)) {
         continue;
       }
 
+      double buyPrice = buyer.askPrice;
+      double sellPrice = seller.bidPrice;
+
       // Deduct fees
-      double totalFees = (buyPrice * buyer.fee) + (sellPrice * seller.fee);
+      double spread = sellPrice - buyPrice;
+      double totalFees = (buyPrice * m_venueFees[buyVenue]) +
+                         (sellPrice * m_venueFees[sellVenue]);
       double netSpread = spread - totalFees;
-
       if (netSpread <= 0) {
         continue;
       }
@@ -229,7 +268,7 @@ ArbitrageDetector::detectOpportunities(const std::string& symbol) const {
         continue;
       }
 
-      double maxQty = std::min(buyer.quote.askSize, seller.quote.bidSize);
+      double maxQty = std::min(buyer.askSize, seller.bidSize);
       double estimatedProfit = netSpread * maxQty;
 
       if (estimatedProfit < m_config.minProfitUsd) {
@@ -238,8 +277,8 @@ ArbitrageDetector::detectOpportunities(const std::string& symbol) const {
 
       ArbitrageOpportunity opp;
       opp.symbol = symbol;
-      opp.buyVenue = buyer.venue;
-      opp.sellVenue = seller.venue;
+      opp.buyVenue = m_config.venues[buyVenue];
+      opp.sellVenue = m_config.venues[sellVenue];
       opp.buyPrice = buyPrice;
       opp.sellPrice = sellPrice;
       opp.spread = netSpread;
@@ -248,24 +287,38 @@ ArbitrageDetector::detectOpportunities(const std::string& symbol) const {
       opp.estimatedProfit = estimatedProfit;
       opp.detectedAt = now;
 
-      opportunities.push_back(opp);
+      if (emitted && (emitVenue == SIZE_MAX || buyVenue == emitVenue ||
+                      sellVenue == emitVenue)) {
+        emitted->push_back(opp);
+      }
+      book.opportunities.push_back(std::move(opp));
     }
   }
-
-  return opportunities;
 }
 
-bool ArbitrageDetector::isStale(const VenueQuote& quote) const {
-  uint64_t now = utils::TimeUtils::getCurrentNanos();
-  return (now - quote.timestamp) > m_config.maxStalenessNs;
-}
+void ArbitrageDetector::notify(
+    const std::vector<ArbitrageOpportunity>& opportunities) {
+  if (opportunities.empty()) {
+    return;
+  }
+  m_totalOpportunities.fetch_add(opportunities.size(),
+                                 std::memory_order_relaxed);
 
-double ArbitrageDetector::getVenueFee(const std::string& venue) const {
-  auto it = m_config.venueFees.find(venue);
-  if (it != m_config.venueFees.end()) {
-    return it->second;
+  OpportunityCallback cb;
+  {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    cb = m_callback;
   }
-  return 0.0;
+
+  if (cb) {
+    for (const auto& opp : opportunities) {
+      cb(opp);
+    }
+  }
+}
+
+bool ArbitrageDetector::isStale(const VenueQuote& quote, uint64_t now) const {
+  return (now - quote.timestamp) > m_config.maxStalenessNs;
 }
 
 } // namespace arbitrage
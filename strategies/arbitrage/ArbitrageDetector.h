@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -60,10 +61,16 @@ struct VenueQuote {
 
 /**
  * @class ArbitrageDetector
- * @brief Scans multi-venue quotes for profitable cross-exchange spreads
+ * @brief Detects profitable cross-exchange spreads as quotes arrive
  *
- * Maintains a per-venue quote cache and runs a background scan thread
- * to detect arbitrage opportunities based on configurable thresholds.
+ * Each configured symbol keeps its venues' quotes with two small arrays of
+ * venue indices, one by fee-adjusted bid (best first) and one by
+ * fee-adjusted ask. updateVenueQuote() repositions the venue in both and
+ * re-evaluates only that symbol, walking the arrays until bids stop
+ * crossing asks, and fires the callback on the calling thread for
+ * opportunities involving the updated venue. A background thread
+ * re-evaluates every scanIntervalMs without callbacks so opportunities
+ * whose quotes have gone stale are dropped.
  */
 class ArbitrageDetector {
 public:
@@ -120,51 +127,68 @@ public:
   uint64_t getTotalOpportunitiesDetected() const;
 
 private:
-  ArbitrageConfig m_config;
+  /**
+   * @brief Quotes and ranking for one symbol across configured venues
+   */
+  struct SymbolBook {
+    std::mutex mutex;
+    std::vector<VenueQuote> quotes; // By venue index
+    std::vector<double> netBids;    // bid * (1 - fee)
+    std::vector<double> netAsks;    // ask * (1 + fee)
+    std::vector<size_t> bidOrder;   // Venues with a quote, best bid first
+    std::vector<size_t> askOrder;   // Venues with a quote, best ask first
+    std::vector<ArbitrageOpportunity> opportunities;
+  };
 
-  // Venue quotes: venue -> symbol -> quote
-  using QuoteMap =
-      std::unordered_map<std::string,
-                         std::unordered_map<std::string, VenueQuote>>;
-  QuoteMap m_quotes;
-  mutable std::mutex m_quotesMutex;
+  ArbitrageConfig m_config;
 
-  // Current opportunities
-  std::vector<ArbitrageOpportunity> m_opportunities;
-  mutable std::mutex m_opportunitiesMutex;
+  // Built from the config at construction and read-only afterwards
+  std::unordered_map<std::string, size_t> m_symbolIndex;
+  std::unordered_map<std::string, size_t> m_venueIndex;
+  std::vector<double> m_venueFees;
+  std::vector<std::unique_ptr<SymbolBook>> m_books;
 
   // Callback
   OpportunityCallback m_callback;
   std::mutex m_callbackMutex;
 
-  // Scan thread
+  // Staleness sweep thread
   std::thread m_scanThread;
   std::atomic<bool> m_running{false};
 
   // Statistics
   std::atomic<uint64_t> m_totalOpportunities{0};
   std::atomic<uint64_t> m_totalScans{0};
+  std::atomic<uint64_t> m_totalEvaluations{0};
 
   /**
-   * @brief Background scan loop
+   * @brief Background loop expiring stale opportunities
    */
   void scanLoop();
 
   /**
-   * @brief Detect opportunities for a specific symbol
+   * @brief Re-rank one venue in its symbol's bid and ask orders
    */
-  std::vector<ArbitrageOpportunity>
-  detectOpportunities(const std::string& symbol) const;
+  void reposition(SymbolBook& book, size_t venue) const;
 
   /**
-   * @brief Check if a quote is stale
+   * @brief Recompute a symbol's opportunities (book mutex held)
+   *
+   * Opportunities that involve emitVenue, or all of them when emitVenue is
+   * SIZE_MAX, are appended to emitted.
    */
-  bool isStale(const VenueQuote& quote) const;
+  void evaluate(const std::string& symbol, SymbolBook& book, size_t emitVenue,
+                std::vector<ArbitrageOpportunity>* emitted);
 
   /**
-   * @brief Get the fee for a venue (0.0 if not configured)
+   * @brief Pass opportunities to the registered callback
+   */
+  void notify(const std::vector<ArbitrageOpportunity>& opportunities);
+
+  /**
+   * @brief Check if a quote is stale
    */
-  double getVenueFee(const std::string& venue) const;
+  bool isStale(const VenueQuote& quote, uint64_t now) const;
 };
 
 } // namespace arbitrage
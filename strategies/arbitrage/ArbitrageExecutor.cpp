@@ -1,13 +1,32 @@
 #include "ArbitrageExecutor.h"
 #include "../../core/utils/TimeUtils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <spdlog/spdlog.h>
 #include <sstream>
 
 namespace pinnacle {
 namespace arbitrage {
 
-ArbitrageExecutor::ArbitrageExecutor(bool dryRun) : m_dryRun(dryRun) {}
+ArbitrageExecutor::ArbitrageExecutor(bool dryRun, const LegRiskConfig& legRisk)
+    : m_dryRun(dryRun), m_legRisk(legRisk) {
+  if (!m_dryRun) {
+    m_legThread = std::thread(&ArbitrageExecutor::legThreadLoop, this);
+  }
+}
+
+ArbitrageExecutor::~ArbitrageExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(m_legMutex);
+    m_legThreadStop = true;
+  }
+  m_legCondition.notify_all();
+  if (m_legThread.joinable()) {
+    m_legThread.join();
+  }
+}
 
 ExecutionResult
 ArbitrageExecutor::execute(const ArbitrageOpportunity& opportunity) {
@@ -36,17 +55,11 @@ ArbitrageExecutor::execute(const ArbitrageOpportunity& opportunity) {
                  opportunity.estimatedProfit);
 
     m_successfulExecutions.fetch_add(1, std::memory_order_relaxed);
-
-    // Update total profit via CAS
-    double prev = m_totalProfit.load(std::memory_order_relaxed);
-    while (!m_totalProfit.compare_exchange_weak(
-        prev, prev + result.realizedProfit, std::memory_order_release,
-        std::memory_order_relaxed)) {
-    }
+    addProfit(result.realizedProfit);
 
   } else {
     // Real execution via callbacks
-    OrderSubmitCallback cb;
+    LegSubmitCallback cb;
     {
       std::lock_guard<std::mutex> lock(m_callbackMutex);
       cb = m_submitCallback;
@@ -57,39 +70,7 @@ ArbitrageExecutor::execute(const ArbitrageOpportunity& opportunity) {
       m_failedExecutions.fetch_add(1, std::memory_order_relaxed);
       // Fall through to finalization (timing + history)
     } else {
-      // Submit buy order first
-      result.buyFilled =
-          cb(opportunity.buyVenue, opportunity.symbol, OrderSide::BUY,
-             opportunity.buyPrice, opportunity.maxQuantity);
-
-      if (result.buyFilled) {
-        // Only submit sell if buy succeeded to prevent unhedged exposure
-        result.sellFilled =
-            cb(opportunity.sellVenue, opportunity.symbol, OrderSide::SELL,
-               opportunity.sellPrice, opportunity.maxQuantity);
-      }
-
-      if (result.buyFilled && result.sellFilled) {
-        result.buyFillPrice = opportunity.buyPrice;
-        result.sellFillPrice = opportunity.sellPrice;
-        result.fillQuantity = opportunity.maxQuantity;
-        result.realizedProfit = opportunity.estimatedProfit;
-        m_successfulExecutions.fetch_add(1, std::memory_order_relaxed);
-
-        double prev = m_totalProfit.load(std::memory_order_relaxed);
-        while (!m_totalProfit.compare_exchange_weak(
-            prev, prev + result.realizedProfit, std::memory_order_release,
-            std::memory_order_relaxed)) {
-        }
-      } else {
-        result.error = "Execution failed — ";
-        if (!result.buyFilled) {
-          result.error += "buy failed";
-        } else {
-          result.error += "sell failed (buy filled, unwind needed)";
-        }
-        m_failedExecutions.fetch_add(1, std::memory_order_relaxed);
-      }
+      executeLive(cb, opportunity, result);
     }
   }
 
@@ -108,6 +89,21 @@ ArbitrageExecutor::execute(const ArbitrageOpportunity& opportunity) {
 }
 
 void ArbitrageExecutor::setOrderSubmitCallback(OrderSubmitCallback callback) {
+  if (!callback) {
+    setLegSubmitCallback(nullptr);
+    return;
+  }
+  setLegSubmitCallback(
+      [callback = std::move(callback)](
+          const std::string& venue, const std::string& symbol, OrderSide side,
+          double price, double quantity) {
+        return callback(venue, symbol, side, price, quantity)
+                   ? LegFill{quantity, price}
+                   : LegFill{};
+      });
+}
+
+void ArbitrageExecutor::setLegSubmitCallback(LegSubmitCallback callback) {
   std::lock_guard<std::mutex> lock(m_callbackMutex);
   m_submitCallback = std::move(callback);
 }
@@ -122,6 +118,14 @@ std::string ArbitrageExecutor::getStatistics() const {
       << m_successfulExecutions.load(std::memory_order_relaxed) << "\n";
   oss << "  Failed: " << m_failedExecutions.load(std::memory_order_relaxed)
       << "\n";
+  oss << "  Hedged: " << m_hedgedExecutions.load(std::memory_order_relaxed)
+      << "\n";
+  oss << "  Unwound: " << m_unwoundExecutions.load(std::memory_order_relaxed)
+      << "\n";
+  if (m_legSkew.count() > 0) {
+    oss << "  Leg skew p50/p99: " << m_legSkew.percentile(0.50) / 1000.0
+        << "/" << m_legSkew.percentile(0.99) / 1000.0 << " us\n";
+  }
   oss << "  Total profit: $" << m_totalProfit.load(std::memory_order_relaxed)
       << "\n";
   return oss.str();
@@ -135,5 +139,279 @@ double ArbitrageExecutor::getTotalProfit() const {
   return m_totalProfit.load(std::memory_order_relaxed);
 }
 
+double ArbitrageExecutor::getOpenExposure(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(m_exposureMutex);
+  auto it = m_openExposure.find(symbol);
+  return it != m_openExposure.end() ? it->second : 0.0;
+}
+
+void ArbitrageExecutor::reduceOpenExposure(const std::string& symbol,
+                                           double quantity) {
+  std::lock_guard<std::mutex> lock(m_exposureMutex);
+  auto it = m_openExposure.find(symbol);
+  if (it == m_openExposure.end()) {
+    return;
+  }
+
+  double open = it->second;
+  double remaining = open > 0.0 ? std::max(open - quantity, 0.0)
+                                : std::min(open - quantity, 0.0);
+  if (std::abs(remaining) <= m_legRisk.quantityTolerance) {
+    m_openExposure.erase(it);
+  } else {
+    it->second = remaining;
+  }
+}
+
+void ArbitrageExecutor::clearOpenExposure(const std::string& symbol) {
+  std::lock_guard<std::mutex> lock(m_exposureMutex);
+  m_openExposure.erase(symbol);
+}
+
+void ArbitrageExecutor::executeLive(const LegSubmitCallback& submit,
+                                    const ArbitrageOpportunity& opportunity,
+                                    ExecutionResult& result) {
+  std::lock_guard<std::mutex> executionLock(m_executionMutex);
+
+  double openQuantity = getOpenExposure(opportunity.symbol);
+  if (m_legRisk.maxOpenExposure > 0.0 &&
+      std::abs(openQuantity) > m_legRisk.quantityTolerance &&
+      std::abs(openQuantity) * opportunity.buyPrice >=
+          m_legRisk.maxOpenExposure) {
+    result.error = "Open exposure limit reached for " + opportunity.symbol;
+    m_failedExecutions.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto& buyLeg = result.buyLeg;
+  buyLeg.venue = opportunity.buyVenue;
+  buyLeg.side = OrderSide::BUY;
+  buyLeg.requestedQuantity = opportunity.maxQuantity;
+
+  auto& sellLeg = result.sellLeg;
+  sellLeg.venue = opportunity.sellVenue;
+  sellLeg.side = OrderSide::SELL;
+  sellLeg.requestedQuantity = opportunity.maxQuantity;
+
+  // Sell leg goes to the leg thread, buy leg runs here
+  {
+    std::lock_guard<std::mutex> lock(m_legMutex);
+    m_legJob = {&submit, &opportunity.symbol, opportunity.sellPrice,
+                opportunity.maxQuantity, &sellLeg};
+    m_legPending = true;
+  }
+  m_legCondition.notify_all();
+
+  submitLeg(submit, opportunity.symbol, opportunity.buyPrice,
+            opportunity.maxQuantity, buyLeg);
+
+  {
+    std::unique_lock<std::mutex> lock(m_legMutex);
+    while (!m_legCondition.wait_for(lock, std::chrono::milliseconds(100),
+                                    [this] { return m_legDone; })) {
+    }
+    m_legDone = false;
+  }
+
+  result.legSkewNs = buyLeg.submittedAt > sellLeg.submittedAt
+                         ? buyLeg.submittedAt - sellLeg.submittedAt
+                         : sellLeg.submittedAt - buyLeg.submittedAt;
+  m_legSkew.record(result.legSkewNs);
+
+  double unwindLoss = resolveImbalance(submit, opportunity, result);
+
+  double matched = std::min(buyLeg.filledQuantity, sellLeg.filledQuantity);
+  double feePerUnit =
+      (opportunity.sellPrice - opportunity.buyPrice) - opportunity.spread;
+
+  result.buyFilled = buyLeg.state == LegState::FILLED;
+  result.sellFilled = sellLeg.state == LegState::FILLED;
+  result.buyFillPrice = buyLeg.avgPrice;
+  result.sellFillPrice = sellLeg.avgPrice;
+  result.fillQuantity = matched;
+  result.slippage = matched * ((buyLeg.avgPrice - opportunity.buyPrice) +
+                               (opportunity.sellPrice - sellLeg.avgPrice)) +
+                    unwindLoss;
+  result.realizedProfit =
+      matched * (sellLeg.avgPrice - buyLeg.avgPrice - feePerUnit) - unwindLoss;
+  if (matched > 0.0 || unwindLoss != 0.0) {
+    addProfit(result.realizedProfit);
+  }
+
+  if (result.hedgedQuantity > 0.0) {
+    m_hedgedExecutions.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (result.unwoundQuantity > 0.0) {
+    m_unwoundExecutions.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  if (std::abs(result.residualQuantity) > m_legRisk.quantityTolerance) {
+    {
+      std::lock_guard<std::mutex> lock(m_exposureMutex);
+      m_openExposure[opportunity.symbol] += result.residualQuantity;
+    }
+    result.error = "Execution failed — " +
+                   std::to_string(result.residualQuantity) +
+                   " left open after unwind";
+    m_failedExecutions.fetch_add(1, std::memory_order_relaxed);
+    spdlog::error("Arbitrage {} left {} open (buy {}@{} sell {}@{})",
+                  opportunity.symbol, result.residualQuantity,
+                  buyLeg.filledQuantity, buyLeg.venue, sellLeg.filledQuantity,
+                  sellLeg.venue);
+  } else if (result.buyFilled && result.sellFilled) {
+    m_successfulExecutions.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    result.error = "Execution failed — ";
+    if (!result.buyFilled && !result.sellFilled) {
+      result.error += "both legs short";
+    } else if (!result.buyFilled) {
+      result.error += "buy failed";
+    } else {
+      result.error += "sell failed";
+    }
+    if (result.unwoundQuantity > 0.0) {
+      result.error += ", unwound " + std::to_string(result.unwoundQuantity);
+    }
+    m_failedExecutions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+LegFill ArbitrageExecutor::submitGuarded(const LegSubmitCallback& submit,
+                                         const std::string& venue,
+                                         const std::string& symbol,
+                                         OrderSide side, double price,
+                                         double quantity) {
+  // A throwing callback must not unwind past the other leg's thread, or out
+  // of execute() with a leg filled and its exposure unrecorded
+  try {
+    return submit(venue, symbol, side, price, quantity);
+  } catch (const std::exception& e) {
+    spdlog::error("Arbitrage {} order on {} failed: {}",
+                  side == OrderSide::BUY ? "BUY" : "SELL", venue, e.what());
+  }
+  return LegFill{};
+}
+
+void ArbitrageExecutor::submitLeg(const LegSubmitCallback& submit,
+                                  const std::string& symbol, double price,
+                                  double quantity, LegResult& leg) {
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  if (leg.submittedAt == 0) {
+    leg.submittedAt = now;
+  }
+
+  LegFill fill =
+      submitGuarded(submit, leg.venue, symbol, leg.side, price, quantity);
+  double filled = std::clamp(fill.quantity, 0.0, quantity);
+
+  if (filled > 0.0) {
+    double total = leg.filledQuantity + filled;
+    leg.avgPrice =
+        (leg.avgPrice * leg.filledQuantity + fill.price * filled) / total;
+    leg.filledQuantity = total;
+  }
+  leg.completedAt = utils::TimeUtils::getCurrentNanos();
+
+  if (leg.filledQuantity >=
+      leg.requestedQuantity - m_legRisk.quantityTolerance) {
+    leg.state = LegState::FILLED;
+  } else if (leg.filledQuantity > 0.0) {
+    leg.state = LegState::PARTIALLY_FILLED;
+  } else {
+    leg.state = LegState::FAILED;
+  }
+}
+
+double ArbitrageExecutor::resolveImbalance(
+    const LegSubmitCallback& submit, const ArbitrageOpportunity& opportunity,
+    ExecutionResult& result) {
+  auto& buyLeg = result.buyLeg;
+  auto& sellLeg = result.sellLeg;
+  double tolerance = m_legRisk.quantityTolerance;
+  double imbalance = buyLeg.filledQuantity - sellLeg.filledQuantity;
+
+  // Complete the short leg at a conceded price
+  for (int attempt = 0; attempt < m_legRisk.maxHedgeAttempts &&
+                        std::abs(imbalance) > tolerance;
+       ++attempt) {
+    double concession = m_legRisk.hedgeSlippageBps / 10000.0;
+    auto& shortLeg = imbalance > 0.0 ? sellLeg : buyLeg;
+    double price = imbalance > 0.0
+                       ? opportunity.sellPrice * (1.0 - concession)
+                       : opportunity.buyPrice * (1.0 + concession);
+
+    double before = shortLeg.filledQuantity;
+    submitLeg(submit, opportunity.symbol, price, std::abs(imbalance),
+              shortLeg);
+    result.hedgedQuantity += shortLeg.filledQuantity - before;
+    imbalance = buyLeg.filledQuantity - sellLeg.filledQuantity;
+  }
+
+  // Reverse the excess on the venue that filled it
+  double loss = 0.0;
+  for (int attempt = 0; attempt < m_legRisk.maxUnwindAttempts &&
+                        std::abs(imbalance) > tolerance;
+       ++attempt) {
+    double concession = m_legRisk.unwindSlippageBps / 10000.0;
+    bool isLong = imbalance > 0.0;
+    const auto& longLeg = isLong ? buyLeg : sellLeg;
+    double price = isLong ? longLeg.avgPrice * (1.0 - concession)
+                         : longLeg.avgPrice * (1.0 + concession);
+    double quantity = std::abs(imbalance);
+
+    LegFill fill = submitGuarded(submit, longLeg.venue, opportunity.symbol,
+                                 isLong ? OrderSide::SELL : OrderSide::BUY,
+                                 price, quantity);
+    double filled = std::clamp(fill.quantity, 0.0, quantity);
+    if (filled <= 0.0) {
+      continue;
+    }
+
+    loss += isLong ? filled * (longLeg.avgPrice - fill.price)
+                  : filled * (fill.price - longLeg.avgPrice);
+    result.unwoundQuantity += filled;
+    imbalance += isLong ? -filled : filled;
+  }
+
+  result.residualQuantity = std::abs(imbalance) > tolerance ? imbalance : 0.0;
+  return loss;
+}
+
+void ArbitrageExecutor::legThreadLoop() {
+  while (true) {
+    LegJob job;
+    {
+      std::unique_lock<std::mutex> lock(m_legMutex);
+      while (!m_legCondition.wait_for(lock, std::chrono::milliseconds(100),
+                                      [this] {
+                                        return m_legPending || m_legThreadStop;
+                                      })) {
+      }
+      if (m_legThreadStop) {
+        return;
+      }
+      job = m_legJob;
+      m_legPending = false;
+    }
+
+    submitLeg(*job.submit, *job.symbol, job.price, job.quantity, *job.leg);
+
+    {
+      std::lock_guard<std::mutex> lock(m_legMutex);
+      m_legDone = true;
+    }
+    m_legCondition.notify_all();
+  }
+}
+
+void ArbitrageExecutor::addProfit(double profit) {
+  // Update total profit via CAS
+  double prev = m_totalProfit.load(std::memory_order_relaxed);
+  while (!m_totalProfit.compare_exchange_weak(prev, prev + profit,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+  }
+}
+
 } // namespace arbitrage
 } // namespace pinnacle
@@ -1,17 +1,71 @@
 #pragma once
 
+#include "../../core/utils/LatencyHistogram.h"
 #include "ArbitrageDetector.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace pinnacle {
 namespace arbitrage {
 
+/**
+ * @enum LegState
+ * @brief Outcome of one leg of an arbitrage
+ */
+enum class LegState { PENDING, FILLED, PARTIALLY_FILLED, FAILED };
+
+/**
+ * @struct LegFill
+ * @brief What a venue filled for one leg order
+ */
+struct LegFill {
+  double quantity{0.0};
+  double price{0.0}; // Average fill price
+};
+
+/**
+ * @struct LegResult
+ * @brief State of one leg, including any hedge fills on the same venue
+ */
+struct LegResult {
+  std::string venue;
+  OrderSide side{OrderSide::BUY};
+  LegState state{LegState::PENDING};
+  double requestedQuantity{0.0};
+  double filledQuantity{0.0};
+  double avgPrice{0.0};
+  uint64_t submittedAt{0};
+  uint64_t completedAt{0};
+};
+
+/**
+ * @struct LegRiskConfig
+ * @brief Limits for handling legs that fill unevenly
+ *
+ * When one leg fills more than the other, the executor first retries the
+ * short leg at a price conceded by hedgeSlippageBps, then reverses any
+ * remainder on the venue of the long leg at unwindSlippageBps. Whatever is
+ * still open counts towards the symbol's open exposure, and executions for
+ * that symbol are refused while its notional exceeds maxOpenExposure, until
+ * reduceOpenExposure() or clearOpenExposure() records it flattened.
+ */
+struct LegRiskConfig {
+  double hedgeSlippageBps{10.0};
+  int maxHedgeAttempts{1};
+  double unwindSlippageBps{25.0};
+  int maxUnwindAttempts{2};
+  double maxOpenExposure{0.0}; // Notional per symbol; 0 is unlimited
+  double quantityTolerance{1e-8};
+};
+
 /**
  * @struct ExecutionResult
  * @brief Result of an arbitrage execution attempt
@@ -27,12 +81,25 @@ struct ExecutionResult {
   double slippage{0.0};
   uint64_t executionTimeNs{0};
   std::string error;
+
+  LegResult buyLeg;
+  LegResult sellLeg;
+  uint64_t legSkewNs{0};        // Gap between the two leg submissions
+  double hedgedQuantity{0.0};   // Filled by retrying the short leg
+  double unwoundQuantity{0.0};  // Reversed on the long leg's venue
+  double residualQuantity{0.0}; // Still open, positive when long
 };
 
 /**
  * @class ArbitrageExecutor
  * @brief Executes arbitrage opportunities by submitting simultaneous buy/sell
  * orders
+ *
+ * In live mode the sell leg is handed to a dedicated leg thread while the
+ * calling thread submits the buy leg, so both reach their venues at about
+ * the same time. Fills are compared once both legs return and any
+ * imbalance is hedged or unwound under LegRiskConfig. Executions are
+ * serialized so a second opportunity never races an unwind.
  */
 class ArbitrageExecutor {
 public:
@@ -40,8 +107,19 @@ public:
       const std::string& venue, const std::string& symbol,
       pinnacle::OrderSide side, double price, double quantity)>;
 
-  explicit ArbitrageExecutor(bool dryRun = true);
-  ~ArbitrageExecutor() = default;
+  /**
+   * @brief Submit one leg and block until the venue has finished with it
+   *
+   * Must be safe to call from two threads at once. A rejected order
+   * returns a zero quantity.
+   */
+  using LegSubmitCallback = std::function<LegFill(
+      const std::string& venue, const std::string& symbol,
+      pinnacle::OrderSide side, double price, double quantity)>;
+
+  explicit ArbitrageExecutor(bool dryRun = true,
+                             const LegRiskConfig& legRisk = LegRiskConfig{});
+  ~ArbitrageExecutor();
 
   ArbitrageExecutor(const ArbitrageExecutor&) = delete;
   ArbitrageExecutor& operator=(const ArbitrageExecutor&) = delete;
@@ -55,9 +133,17 @@ public:
 
   /**
    * @brief Set the order submission callback (used to route to OrderRouter)
+   *
+   * An accepted order is treated as filled in full at its limit price. Use
+   * setLegSubmitCallback() when the venue can fill partially.
    */
   void setOrderSubmitCallback(OrderSubmitCallback callback);
 
+  /**
+   * @brief Set the leg submission callback reporting actual fills
+   */
+  void setLegSubmitCallback(LegSubmitCallback callback);
+
   /**
    * @brief Get execution statistics
    */
@@ -73,19 +159,109 @@ public:
    */
   double getTotalProfit() const;
 
+  /**
+   * @brief Quantity left open by failed unwinds, positive when long
+   */
+  double getOpenExposure(const std::string& symbol) const;
+
+  /**
+   * @brief Record open quantity flattened outside the executor
+   *
+   * @param quantity Amount closed, signed like the exposure: positive when
+   * a long was sold, negative when a short was bought back. The exposure
+   * moves towards zero by it and never past.
+   */
+  void reduceOpenExposure(const std::string& symbol, double quantity);
+
+  /**
+   * @brief Forget a symbol's open exposure once it has been flattened
+   */
+  void clearOpenExposure(const std::string& symbol);
+
+  /**
+   * @brief Distribution of the gap between a pair's two leg submissions
+   */
+  const utils::LatencyHistogram& getLegSkewHistogram() const {
+    return m_legSkew;
+  }
+
 private:
   bool m_dryRun;
-  OrderSubmitCallback m_submitCallback;
+  LegRiskConfig m_legRisk;
+  LegSubmitCallback m_submitCallback;
   std::mutex m_callbackMutex;
 
+  // Serializes live executions
+  std::mutex m_executionMutex;
+
+  /**
+   * @brief Leg handed to the leg thread, pointing into execute()'s frame
+   */
+  struct LegJob {
+    const LegSubmitCallback* submit{nullptr};
+    const std::string* symbol{nullptr};
+    double price{0.0};
+    double quantity{0.0};
+    LegResult* leg{nullptr};
+  };
+
+  // Leg thread running the sell leg of each pair
+  std::thread m_legThread;
+  std::mutex m_legMutex;
+  std::condition_variable m_legCondition;
+  LegJob m_legJob;
+  bool m_legPending{false};
+  bool m_legDone{false};
+  bool m_legThreadStop{false};
+
+  // Residual quantity per symbol
+  std::unordered_map<std::string, double> m_openExposure;
+  mutable std::mutex m_exposureMutex;
+
   // Statistics
   std::atomic<uint64_t> m_totalExecutions{0};
   std::atomic<uint64_t> m_successfulExecutions{0};
   std::atomic<uint64_t> m_failedExecutions{0};
+  std::atomic<uint64_t> m_hedgedExecutions{0};
+  std::atomic<uint64_t> m_unwoundExecutions{0};
   std::atomic<double> m_totalProfit{0.0};
+  utils::LatencyHistogram m_legSkew;
 
   mutable std::mutex m_resultsMutex;
   std::vector<ExecutionResult> m_recentResults;
+
+  /**
+   * @brief Submit both legs concurrently and handle any imbalance
+   */
+  void executeLive(const LegSubmitCallback& submit,
+                   const ArbitrageOpportunity& opportunity,
+                   ExecutionResult& result);
+
+  /**
+   * @brief Submit one order, treating a throwing callback as a rejection
+   */
+  LegFill submitGuarded(const LegSubmitCallback& submit,
+                        const std::string& venue, const std::string& symbol,
+                        OrderSide side, double price, double quantity);
+
+  /**
+   * @brief Submit one order for a leg and fold its fill into the leg
+   */
+  void submitLeg(const LegSubmitCallback& submit, const std::string& symbol,
+                 double price, double quantity, LegResult& leg);
+
+  /**
+   * @brief Retry the short leg, then reverse what is left on the long one
+   *
+   * @return Realized loss from reversing fills
+   */
+  double resolveImbalance(const LegSubmitCallback& submit,
+                          const ArbitrageOpportunity& opportunity,
+                          ExecutionResult& result);
+
+  void legThreadLoop();
+
+  void addProfit(double profit);
 };
 
 } // namespace arbitrage
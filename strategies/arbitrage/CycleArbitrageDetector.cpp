@@ -0,0 +1,468 @@
+#include "CycleArbitrageDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace pinnacle {
+namespace arbitrage {
+
+namespace {
+
+constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Split BASE-QUOTE or BASE/QUOTE
+ */
+bool splitSymbol(const std::string& symbol, std::string& base,
+                 std::string& quote) {
+  size_t separator = symbol.find_first_of("-/");
+  if (separator == std::string::npos || separator == 0 ||
+      separator + 1 >= symbol.size()) {
+    return false;
+  }
+  base = symbol.substr(0, separator);
+  quote = symbol.substr(separator + 1);
+  return true;
+}
+
+/**
+ * @brief Rotate a cycle so its smallest edge comes first
+ */
+void canonicalize(std::vector<uint32_t>& edges) {
+  std::rotate(edges.begin(), std::min_element(edges.begin(), edges.end()),
+              edges.end());
+}
+
+} // namespace
+
+CycleArbitrageDetector::CycleArbitrageDetector(const ArbitrageConfig& config,
+                                               size_t maxCycleLength)
+    : m_config(config), m_maxCycleLength(std::max<size_t>(maxCycleLength, 3)),
+      m_maxCycleWeight(-std::log1p(config.minSpreadBps / 10000.0)) {
+  for (const auto& venue : m_config.venues) {
+    if (m_venueIndex.emplace(venue, m_venueFees.size()).second) {
+      m_venues.push_back(venue);
+      auto feeIt = m_config.venueFees.find(venue);
+      m_venueFees.push_back(feeIt != m_config.venueFees.end() ? feeIt->second
+                                                              : 0.0);
+    }
+  }
+
+  std::unordered_map<std::string, uint32_t> currencyIndex;
+  auto currencyId = [&](const std::string& currency) {
+    auto [it, inserted] = currencyIndex.emplace(
+        currency, static_cast<uint32_t>(m_currencies.size()));
+    if (inserted) {
+      m_currencies.push_back(currency);
+    }
+    return it->second;
+  };
+
+  // Collect edges as (source, target, info) before laying them out as CSR
+  struct PendingEdge {
+    uint32_t source;
+    uint32_t target;
+    EdgeInfo info;
+  };
+  std::vector<PendingEdge> pending;
+  std::vector<std::pair<uint32_t, uint32_t>> symbolCurrencies;
+
+  for (const auto& symbol : m_config.symbols) {
+    std::string base, quote;
+    if (!splitSymbol(symbol, base, quote) ||
+        m_symbolIndex.count(symbol) != 0) {
+      continue;
+    }
+    auto symbolId = static_cast<uint32_t>(m_symbols.size());
+    m_symbolIndex.emplace(symbol, symbolId);
+    m_symbols.push_back(symbol);
+    symbolCurrencies.emplace_back(currencyId(base), currencyId(quote));
+  }
+
+  size_t venueCount = m_venueFees.size();
+  for (uint32_t symbolId = 0; symbolId < m_symbols.size(); ++symbolId) {
+    auto [base, quote] = symbolCurrencies[symbolId];
+    for (uint32_t venue = 0; venue < venueCount; ++venue) {
+      pending.push_back({base, quote, {venue, symbolId, OrderSide::SELL}});
+      pending.push_back({quote, base, {venue, symbolId, OrderSide::BUY}});
+    }
+  }
+
+  // Order edges by (source, target) so parallel edges sit together
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const PendingEdge& a, const PendingEdge& b) {
+                     return a.source != b.source ? a.source < b.source
+                                                 : a.target < b.target;
+                   });
+
+  size_t nodes = m_currencies.size();
+  size_t edgeCount = pending.size();
+  m_edgeSource.resize(edgeCount);
+  m_edgeTarget.resize(edgeCount);
+  m_edgeGroup.resize(edgeCount);
+  m_edgeWeight.assign(edgeCount, INF);
+  m_edgeRate.assign(edgeCount, 0.0);
+  m_edgePrice.assign(edgeCount, 0.0);
+  m_edgeSize.assign(edgeCount, 0.0);
+  m_edgeTimestamp.assign(edgeCount, 0);
+  m_edgeInfo.resize(edgeCount);
+  m_quoteEdges.assign(venueCount * m_symbols.size(), {NO_EDGE, NO_EDGE});
+  m_offsets.assign(nodes + 1, 0);
+
+  for (uint32_t index = 0; index < edgeCount; ++index) {
+    const auto& edge = pending[index];
+    bool newGroup = index == 0 || edge.source != pending[index - 1].source ||
+                    edge.target != pending[index - 1].target;
+    if (newGroup) {
+      m_groupTarget.push_back(edge.target);
+      m_groupEdges.push_back(index);
+      ++m_offsets[edge.source + 1];
+    }
+
+    m_edgeSource[index] = edge.source;
+    m_edgeTarget[index] = edge.target;
+    m_edgeGroup[index] = static_cast<uint32_t>(m_groupTarget.size() - 1);
+    m_edgeInfo[index] = edge.info;
+
+    auto& slot =
+        m_quoteEdges[edge.info.venue * m_symbols.size() + edge.info.symbol];
+    (edge.info.side == OrderSide::SELL ? slot.first : slot.second) = index;
+  }
+  m_groupEdges.push_back(static_cast<uint32_t>(edgeCount));
+  m_groupBest.assign(m_groupTarget.size(), NO_EDGE);
+  m_groupWeight.assign(m_groupTarget.size(), INF);
+  for (size_t i = 0; i < nodes; ++i) {
+    m_offsets[i + 1] += m_offsets[i];
+  }
+
+  m_distance.resize(m_maxCycleLength * nodes);
+  m_parent.resize(m_maxCycleLength * nodes);
+  m_frontier.reserve(nodes);
+  m_nextFrontier.reserve(nodes);
+  m_inFrontier.assign(nodes, 0);
+}
+
+void CycleArbitrageDetector::updateVenueQuote(
+    const std::string& venue, const std::string& symbol, double bid,
+    double bidSize, double ask, double askSize, uint64_t timestamp) {
+  auto venueIt = m_venueIndex.find(venue);
+  auto symbolIt = m_symbolIndex.find(symbol);
+  if (venueIt == m_venueIndex.end() || symbolIt == m_symbolIndex.end()) {
+    return;
+  }
+
+  auto [sellEdge, buyEdge] =
+      m_quoteEdges[venueIt->second * m_symbols.size() + symbolIt->second];
+  double keep = 1.0 - m_venueFees[venueIt->second];
+
+  std::vector<CycleOpportunity> found;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Selling base at the bid, buying it at the ask
+    bool sellValid = bid > 0.0 && keep > 0.0;
+    m_edgeRate[sellEdge] = sellValid ? bid * keep : 0.0;
+    m_edgeWeight[sellEdge] = sellValid ? -std::log(bid * keep) : INF;
+    m_edgePrice[sellEdge] = bid;
+    m_edgeSize[sellEdge] = bidSize;
+    m_edgeTimestamp[sellEdge] = timestamp;
+
+    bool buyValid = ask > 0.0 && keep > 0.0;
+    m_edgeRate[buyEdge] = buyValid ? keep / ask : 0.0;
+    m_edgeWeight[buyEdge] = buyValid ? -std::log(keep / ask) : INF;
+    m_edgePrice[buyEdge] = ask;
+    m_edgeSize[buyEdge] = askSize;
+    m_edgeTimestamp[buyEdge] = timestamp;
+
+    refreshGroup(m_edgeGroup[sellEdge]);
+    refreshGroup(m_edgeGroup[buyEdge]);
+
+    m_totalUpdates.fetch_add(1, std::memory_order_relaxed);
+    uint64_t now = utils::TimeUtils::getCurrentNanos();
+
+    // Re-price cycles already known and drop the ones that stopped paying
+    auto stillPays = [&](ActiveCycle& cycle) {
+      double weight = cycleWeight(cycle.edges, now);
+      if (weight >= m_maxCycleWeight) {
+        return false;
+      }
+      cycle.opportunity = describe(cycle.edges, weight, now);
+      return true;
+    };
+    m_active.erase(std::remove_if(m_active.begin(), m_active.end(),
+                                  [&](ActiveCycle& cycle) {
+                                    return !stillPays(cycle);
+                                  }),
+                   m_active.end());
+
+    searchThrough(sellEdge, now, found);
+    searchThrough(buyEdge, now, found);
+  }
+
+  if (found.empty()) {
+    return;
+  }
+  m_totalOpportunities.fetch_add(found.size(), std::memory_order_relaxed);
+
+  OpportunityCallback cb;
+  {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    cb = m_callback;
+  }
+  if (cb) {
+    for (const auto& opportunity : found) {
+      cb(opportunity);
+    }
+  }
+}
+
+std::vector<CycleOpportunity>
+CycleArbitrageDetector::getCurrentOpportunities() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+
+  std::vector<CycleOpportunity> opportunities;
+  for (const auto& cycle : m_active) {
+    if (cycleWeight(cycle.edges, now) < m_maxCycleWeight) {
+      opportunities.push_back(cycle.opportunity);
+    }
+  }
+  return opportunities;
+}
+
+void CycleArbitrageDetector::setOpportunityCallback(
+    OpportunityCallback callback) {
+  std::lock_guard<std::mutex> lock(m_callbackMutex);
+  m_callback = std::move(callback);
+}
+
+std::string CycleArbitrageDetector::getStatistics() const {
+  std::ostringstream oss;
+  oss << "CycleArbitrageDetector Statistics:\n";
+  oss << "  Currencies: " << m_currencies.size()
+      << ", edges: " << m_edgeTarget.size()
+      << ", max cycle length: " << m_maxCycleLength << "\n";
+  oss << "  Quote updates: " << m_totalUpdates.load(std::memory_order_relaxed)
+      << "\n";
+  oss << "  Edge relaxations: "
+      << m_totalRelaxations.load(std::memory_order_relaxed) << "\n";
+  oss << "  Total opportunities: "
+      << m_totalOpportunities.load(std::memory_order_relaxed) << "\n";
+
+  auto current = getCurrentOpportunities();
+  oss << "  Active cycles: " << current.size() << "\n";
+  for (const auto& opp : current) {
+    oss << "    " << opp.startCurrency;
+    for (const auto& leg : opp.legs) {
+      oss << " -> " << (leg.side == OrderSide::BUY ? "buy " : "sell ")
+          << leg.symbol << "@" << leg.venue;
+    }
+    oss << " profit=" << opp.profitBps << "bps\n";
+  }
+  return oss.str();
+}
+
+uint64_t CycleArbitrageDetector::getTotalOpportunitiesDetected() const {
+  return m_totalOpportunities.load(std::memory_order_relaxed);
+}
+
+void CycleArbitrageDetector::searchThrough(
+    uint32_t edge, uint64_t now, std::vector<CycleOpportunity>& found) {
+  if (!isLive(edge, now)) {
+    return;
+  }
+
+  // Shortest paths from the edge's target back to its source, bounded to
+  // maxCycleLength - 1 hops. Row h holds distances using at most h edges;
+  // m_parent[h][x] is the edge that improved x in round h, or NO_EDGE if
+  // x's best path at h is the one from round h - 1.
+  const size_t nodes = m_currencies.size();
+  const uint32_t from = m_edgeTarget[edge];
+  const uint32_t to = m_edgeSource[edge];
+  const double edgeWeight = m_edgeWeight[edge];
+
+  std::fill_n(m_distance.begin(), nodes, INF);
+  std::fill_n(m_parent.begin(), nodes, NO_EDGE);
+  m_distance[from] = 0.0;
+  m_frontier.assign(1, from);
+
+  uint64_t relaxations = 0;
+  for (size_t hop = 1; hop < m_maxCycleLength && !m_frontier.empty(); ++hop) {
+    const double* previous = &m_distance[(hop - 1) * nodes];
+    double* current = &m_distance[hop * nodes];
+    uint32_t* parent = &m_parent[hop * nodes];
+    std::copy_n(previous, nodes, current);
+    std::fill_n(parent, nodes, NO_EDGE);
+
+    m_nextFrontier.clear();
+    for (uint32_t node : m_frontier) {
+      if (node == to) {
+        continue; // Paths end at the edge's source
+      }
+      double base = previous[node];
+      for (uint32_t g = m_offsets[node]; g < m_offsets[node + 1]; ++g) {
+        uint32_t target = m_groupTarget[g];
+        // Skip returning to the start and two-edge cycles
+        if (target == from || (hop == 1 && target == to) ||
+            m_groupWeight[g] >= INF) {
+          continue;
+        }
+        uint32_t e = m_groupBest[g];
+        if (!isLive(e, now)) {
+          e = liveEdge(g, now);
+          if (e == NO_EDGE) {
+            continue;
+          }
+        }
+        ++relaxations;
+        double candidate = base + m_edgeWeight[e];
+        if (candidate < current[target]) {
+          current[target] = candidate;
+          parent[target] = e;
+          if (!m_inFrontier[target]) {
+            m_inFrontier[target] = 1;
+            m_nextFrontier.push_back(target);
+          }
+        }
+      }
+    }
+    for (uint32_t node : m_nextFrontier) {
+      m_inFrontier[node] = 0;
+    }
+    m_frontier.swap(m_nextFrontier);
+
+    if (parent[to] == NO_EDGE || current[to] + edgeWeight >= m_maxCycleWeight) {
+      continue;
+    }
+
+    // Walk the parents back to the start, then close with the edge
+    std::vector<uint32_t> cycle;
+    uint32_t node = to;
+    size_t level = hop;
+    bool simple = true;
+    while (node != from) {
+      while (level > 0 && m_parent[level * nodes + node] == NO_EDGE) {
+        --level;
+      }
+      if (level == 0) {
+        simple = false;
+        break;
+      }
+      uint32_t e = m_parent[level * nodes + node];
+      cycle.push_back(e);
+      node = m_edgeSource[e];
+      --level;
+    }
+    if (!simple) {
+      continue;
+    }
+    std::reverse(cycle.begin(), cycle.end());
+    cycle.insert(cycle.begin(), edge);
+
+    // A walk that revisits a currency is not a single cycle through edge
+    std::vector<uint32_t> visited;
+    for (uint32_t e : cycle) {
+      visited.push_back(m_edgeSource[e]);
+    }
+    std::sort(visited.begin(), visited.end());
+    if (std::adjacent_find(visited.begin(), visited.end()) != visited.end()) {
+      continue;
+    }
+
+    // Known cycles were re-priced before the search and are not new
+    canonicalize(cycle);
+    bool known = false;
+    for (const auto& active : m_active) {
+      if (active.edges == cycle) {
+        known = true;
+        break;
+      }
+    }
+    if (known) {
+      continue;
+    }
+
+    double weight = current[to] + edgeWeight;
+    CycleOpportunity opportunity = describe(cycle, weight, now);
+    found.push_back(opportunity);
+    m_active.push_back({std::move(cycle), std::move(opportunity)});
+  }
+
+  m_totalRelaxations.fetch_add(relaxations, std::memory_order_relaxed);
+}
+
+void CycleArbitrageDetector::refreshGroup(uint32_t group) {
+  uint32_t best = NO_EDGE;
+  double bestWeight = INF;
+  for (uint32_t e = m_groupEdges[group]; e < m_groupEdges[group + 1]; ++e) {
+    if (m_edgeWeight[e] < bestWeight) {
+      bestWeight = m_edgeWeight[e];
+      best = e;
+    }
+  }
+  m_groupBest[group] = best;
+  m_groupWeight[group] = bestWeight;
+}
+
+uint32_t CycleArbitrageDetector::liveEdge(uint32_t group, uint64_t now) const {
+  uint32_t best = NO_EDGE;
+  double bestWeight = INF;
+  for (uint32_t e = m_groupEdges[group]; e < m_groupEdges[group + 1]; ++e) {
+    if (isLive(e, now) && m_edgeWeight[e] < bestWeight) {
+      bestWeight = m_edgeWeight[e];
+      best = e;
+    }
+  }
+  return best;
+}
+
+double CycleArbitrageDetector::cycleWeight(const std::vector<uint32_t>& edges,
+                                           uint64_t now) const {
+  double weight = 0.0;
+  for (uint32_t e : edges) {
+    if (!isLive(e, now)) {
+      return INF;
+    }
+    weight += m_edgeWeight[e];
+  }
+  return weight;
+}
+
+CycleOpportunity
+CycleArbitrageDetector::describe(const std::vector<uint32_t>& edges,
+                                 double weight, uint64_t now) const {
+  CycleOpportunity opportunity;
+  opportunity.startCurrency = m_currencies[m_edgeSource[edges.front()]];
+  opportunity.profitBps = std::expm1(-weight) * 10000.0;
+  opportunity.detectedAt = now;
+  opportunity.legs.reserve(edges.size());
+
+  // Sizes are in base units; scale tracks what one start unit has become
+  double scale = 1.0;
+  double limit = std::numeric_limits<double>::max();
+  for (uint32_t e : edges) {
+    const auto& info = m_edgeInfo[e];
+    double rate = m_edgeRate[e];
+    if (info.side == OrderSide::SELL) {
+      limit = std::min(limit, m_edgeSize[e] / scale);
+    } else {
+      limit = std::min(limit, m_edgeSize[e] / (scale * rate));
+    }
+    scale *= rate;
+
+    CycleLeg leg;
+    leg.venue = m_venues[info.venue];
+    leg.symbol = m_symbols[info.symbol];
+    leg.side = info.side;
+    leg.price = m_edgePrice[e];
+    leg.rate = rate;
+    opportunity.legs.push_back(std::move(leg));
+  }
+  opportunity.maxStartQuantity = limit;
+  return opportunity;
+}
+
+} // namespace arbitrage
+} // namespace pinnacle
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "ArbitrageDetector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pinnacle {
+namespace arbitrage {
+
+/**
+ * @struct CycleLeg
+ * @brief One conversion in an arbitrage cycle
+ */
+struct CycleLeg {
+  std::string venue;
+  std::string symbol;
+  OrderSide side{OrderSide::BUY}; // BUY converts quote to base
+  double price{0.0};              // Ask for BUY, bid for SELL
+  double rate{0.0};               // Units received per unit given, after fees
+};
+
+/**
+ * @struct CycleOpportunity
+ * @brief Sequence of conversions returning more of a currency than it used
+ */
+struct CycleOpportunity {
+  std::string startCurrency;
+  std::vector<CycleLeg> legs;
+  double profitBps{0.0};
+  double maxStartQuantity{0.0}; // Largest start amount the quoted sizes allow
+  uint64_t detectedAt{0};
+};
+
+/**
+ * @class CycleArbitrageDetector
+ * @brief Finds triangular and longer arbitrage cycles across symbols and
+ * venues
+ *
+ * Currencies are nodes. Every configured venue and symbol contributes two
+ * edges: selling the base at the bid and buying it at the ask, weighted
+ * -log(rate * (1 - fee)), so a cycle whose weights sum below zero returns
+ * more than it started with. The graph's shape is fixed at construction and
+ * stored as CSR arrays. Parallel edges from different venues between the
+ * same two currencies are grouped, and each group keeps its cheapest edge,
+ * so the search relaxes once per currency pair rather than once per venue.
+ * Quote updates rewrite two edges and refresh their groups.
+ *
+ * A new negative cycle must use an edge that just changed, so each update
+ * runs a hop-bounded Bellman-Ford from the edge's target looking for a path
+ * back to its source, relaxing only from nodes whose distance improved in
+ * the previous round. Two-edge cycles, the same symbol on two venues, are
+ * left to ArbitrageDetector. Uses minSpreadBps, maxStalenessNs, venues,
+ * symbols and venueFees from ArbitrageConfig.
+ */
+class CycleArbitrageDetector {
+public:
+  using OpportunityCallback = std::function<void(const CycleOpportunity&)>;
+
+  /**
+   * @param maxCycleLength Longest cycle searched, at least 3
+   */
+  explicit CycleArbitrageDetector(const ArbitrageConfig& config,
+                                  size_t maxCycleLength = 4);
+
+  CycleArbitrageDetector(const CycleArbitrageDetector&) = delete;
+  CycleArbitrageDetector& operator=(const CycleArbitrageDetector&) = delete;
+
+  /**
+   * @brief Update a venue's quote and report cycles that start paying
+   *
+   * Symbols are BASE-QUOTE (or BASE/QUOTE). Unknown venues and symbols are
+   * ignored. The callback runs on the calling thread.
+   */
+  void updateVenueQuote(const std::string& venue, const std::string& symbol,
+                        double bid, double bidSize, double ask, double askSize,
+                        uint64_t timestamp);
+
+  /**
+   * @brief Cycles found so far that are still profitable on fresh quotes
+   */
+  std::vector<CycleOpportunity> getCurrentOpportunities() const;
+
+  /**
+   * @brief Register a callback for newly found cycles
+   */
+  void setOpportunityCallback(OpportunityCallback callback);
+
+  std::string getStatistics() const;
+
+  uint64_t getTotalOpportunitiesDetected() const;
+
+  size_t getCurrencyCount() const { return m_currencies.size(); }
+
+  size_t getEdgeCount() const { return m_edgeTarget.size(); }
+
+private:
+  /**
+   * @brief Venue and symbol an edge trades on
+   */
+  struct EdgeInfo {
+    uint32_t venue;
+    uint32_t symbol;
+    OrderSide side;
+  };
+
+  /**
+   * @brief Cycle kept between updates, as edge indices in order
+   */
+  struct ActiveCycle {
+    std::vector<uint32_t> edges;
+    CycleOpportunity opportunity;
+  };
+
+  static constexpr double INF = 1e300;
+
+  ArbitrageConfig m_config;
+  size_t m_maxCycleLength;
+  double m_maxCycleWeight; // -log(1 + minSpreadBps)
+
+  std::vector<std::string> m_currencies;
+  std::vector<std::string> m_venues;
+  std::vector<std::string> m_symbols;
+  std::unordered_map<std::string, uint32_t> m_venueIndex;
+  std::unordered_map<std::string, uint32_t> m_symbolIndex;
+  std::vector<double> m_venueFees;
+
+  // CSR adjacency by source currency over groups of parallel edges. Group
+  // g covers edges [m_groupEdges[g], m_groupEdges[g + 1]) into
+  // m_groupTarget[g]; a currency's groups are [m_offsets[c],
+  // m_offsets[c + 1]).
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_groupTarget;
+  std::vector<uint32_t> m_groupEdges;
+  std::vector<uint32_t> m_groupBest; // Cheapest quoted edge, ignoring age
+  std::vector<double> m_groupWeight;
+
+  // Edge e runs from m_edgeSource[e] and belongs to group m_edgeGroup[e]
+  std::vector<uint32_t> m_edgeSource;
+  std::vector<uint32_t> m_edgeGroup;
+  std::vector<uint32_t> m_edgeTarget;
+  std::vector<double> m_edgeWeight; // INF until quoted
+  std::vector<double> m_edgeRate;
+  std::vector<double> m_edgePrice;
+  std::vector<double> m_edgeSize; // Base quantity available
+  std::vector<uint64_t> m_edgeTimestamp;
+  std::vector<EdgeInfo> m_edgeInfo;
+
+  // (venue, symbol) -> {sell edge, buy edge}
+  std::vector<std::pair<uint32_t, uint32_t>> m_quoteEdges;
+
+  // Search scratch, (maxCycleLength) x currencies
+  std::vector<double> m_distance;
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_frontier;
+  std::vector<uint32_t> m_nextFrontier;
+  std::vector<uint8_t> m_inFrontier;
+
+  std::vector<ActiveCycle> m_active;
+  mutable std::mutex m_mutex;
+
+  OpportunityCallback m_callback;
+  std::mutex m_callbackMutex;
+
+  std::atomic<uint64_t> m_totalOpportunities{0};
+  std::atomic<uint64_t> m_totalUpdates{0};
+  std::atomic<uint64_t> m_totalRelaxations{0};
+
+  /**
+   * @brief Search for negative cycles through one edge (lock held)
+   */
+  void searchThrough(uint32_t edge, uint64_t now,
+                     std::vector<CycleOpportunity>& found);
+
+  /**
+   * @brief Recompute a group's cheapest edge after one of its quotes changed
+   */
+  void refreshGroup(uint32_t group);
+
+  /**
+   * @brief Cheapest fresh edge of a group, NO_EDGE if none
+   */
+  uint32_t liveEdge(uint32_t group, uint64_t now) const;
+
+  /**
+   * @brief Total weight of a cycle, INF if any edge is stale or unquoted
+   */
+  double cycleWeight(const std::vector<uint32_t>& edges, uint64_t now) const;
+
+  CycleOpportunity describe(const std::vector<uint32_t>& edges, double weight,
+                            uint64_t now) const;
+
+  bool isLive(uint32_t edge, uint64_t now) const {
+    return m_edgeWeight[edge] < INF &&
+           now - m_edgeTimestamp[edge] <= m_config.maxStalenessNs;
+  }
+};
+
+} // namespace arbitrage
+} // namespace pinnacle
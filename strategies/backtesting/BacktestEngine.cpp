@@ -1,8 +1,13 @@
 #include "BacktestEngine.h"
+#include "TickStore.h"
+#include "../../exchange/capture/CaptureReader.h"
+#include "../../exchange/capture/ReplayMarketDataFeed.h"
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -21,41 +26,59 @@ bool HistoricalDataManager::loadData(const std::string& symbol,
                                      uint64_t startTime, uint64_t endTime) {
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  m_dataPoints.clear();
-  m_currentIndex = 0;
+  std::vector<MarketDataPoint> points;
+
+  // Try the columnar tick store first
+  TickStore store(m_dataDirectory + "/ticks");
+  if (store.hasSymbol(symbol)) {
+    auto stats = store.query(symbol, startTime, endTime, points);
+    if (!points.empty()) {
+      spdlog::info("Loaded {} data points for symbol {} from the tick store "
+                   "({} blocks read, {} skipped)",
+                   points.size(), symbol, stats.blocksRead,
+                   stats.blocksSkipped);
+      return adopt(std::move(points));
+    }
+  }
 
-  // Try to load from CSV first
+  // Then CSV
   std::string csvFile = m_dataDirectory + "/" + symbol + ".csv";
   if (std::filesystem::exists(csvFile)) {
     spdlog::info("Loading historical data from CSV: {}", csvFile);
-    if (loadFromCSV(csvFile)) {
-      // Filter by time range
+    if (loadFromCSV(csvFile, points)) {
+      // Filter by time range; the buffer sorts by timestamp
       auto it = std::remove_if(
-          m_dataPoints.begin(), m_dataPoints.end(),
+          points.begin(), points.end(),
           [startTime, endTime](const MarketDataPoint& point) {
             return point.timestamp < startTime || point.timestamp > endTime;
           });
-      m_dataPoints.erase(it, m_dataPoints.end());
-
-      // Sort by timestamp
-      std::sort(m_dataPoints.begin(), m_dataPoints.end(),
-                [](const MarketDataPoint& a, const MarketDataPoint& b) {
-                  return a.timestamp < b.timestamp;
-                });
+      points.erase(it, points.end());
 
-      spdlog::info("Loaded {} data points for symbol {}", m_dataPoints.size(),
+      spdlog::info("Loaded {} data points for symbol {}", points.size(),
                    symbol);
-      return true;
+      return adopt(std::move(points));
     }
+    points.clear();
   }
 
   // Try binary format
   std::string binFile = m_dataDirectory + "/" + symbol + ".bin";
   if (std::filesystem::exists(binFile)) {
     spdlog::info("Loading historical data from binary: {}", binFile);
-    return loadFromBinary(binFile);
+    return loadFromBinary(binFile, points) && adopt(std::move(points));
   }
 
+  // Try recorded market data captures
+  auto captures =
+      exchange::capture::CaptureReader::listCaptures(m_dataDirectory);
+  if (!captures.empty() &&
+      loadFromCaptures(captures, symbol, startTime, endTime, points)) {
+    spdlog::info("Loaded {} data points for symbol {} from {} captures",
+                 points.size(), symbol, captures.size());
+    return adopt(std::move(points));
+  }
+  points.clear();
+
   // Generate synthetic data if no historical data available
   spdlog::warn("No historical data found for {}, generating synthetic data",
                symbol);
@@ -82,16 +105,42 @@ bool HistoricalDataManager::loadData(const std::string& symbol,
     point.spread = point.ask - point.bid;
     point.volume = std::max(1.0, volume_dist(gen));
 
-    m_dataPoints.push_back(point);
+    points.push_back(point);
     currentTime += timeStep;
   }
 
   spdlog::info("Generated {} synthetic data points for symbol {}",
-               m_dataPoints.size(), symbol);
-  return true;
+               points.size(), symbol);
+  return adopt(std::move(points));
+}
+
+bool HistoricalDataManager::useData(
+    std::shared_ptr<const MarketDataBuffer> data, uint64_t startTime,
+    uint64_t endTime) {
+  std::lock_guard<std::mutex> lock(m_dataMutex);
+
+  m_data = std::move(data);
+  m_begin = m_data ? m_data->lowerBound(startTime) : 0;
+  m_end = m_data ? std::max(m_begin, m_data->upperBound(endTime)) : 0;
+  m_currentIndex = m_begin;
+  return m_end > m_begin;
+}
+
+std::shared_ptr<const MarketDataBuffer> HistoricalDataManager::getData() const {
+  std::lock_guard<std::mutex> lock(m_dataMutex);
+  return m_data;
+}
+
+bool HistoricalDataManager::adopt(std::vector<MarketDataPoint> points) {
+  m_data = MarketDataBuffer::create(std::move(points));
+  m_begin = 0;
+  m_end = m_data ? m_data->size() : 0;
+  m_currentIndex = 0;
+  return m_data != nullptr;
 }
 
-bool HistoricalDataManager::loadFromCSV(const std::string& filename) {
+bool HistoricalDataManager::loadFromCSV(const std::string& filename,
+                                        std::vector<MarketDataPoint>& points) {
   std::ifstream file(filename);
   if (!file.is_open()) {
     spdlog::error("Failed to open CSV file: {}", filename);
@@ -106,18 +155,18 @@ bool HistoricalDataManager::loadFromCSV(const std::string& filename) {
     // No header, parse first line as data
     auto point = parseCSVLine(line);
     if (point.timestamp > 0) {
-      m_dataPoints.push_back(point);
+      points.push_back(point);
     }
   }
 
   while (std::getline(file, line)) {
     auto point = parseCSVLine(line);
     if (point.timestamp > 0) {
-      m_dataPoints.push_back(point);
+      points.push_back(point);
     }
   }
 
-  return !m_dataPoints.empty();
+  return !points.empty();
 }
 
 MarketDataPoint HistoricalDataManager::parseCSVLine(const std::string& line) {
@@ -155,7 +204,8 @@ MarketDataPoint HistoricalDataManager::parseCSVLine(const std::string& line) {
   return point;
 }
 
-bool HistoricalDataManager::loadFromBinary(const std::string& filename) {
+bool HistoricalDataManager::loadFromBinary(
+    const std::string& filename, std::vector<MarketDataPoint>& points) {
   std::ifstream file(filename, std::ios::binary);
   if (!file.is_open()) {
     spdlog::error("Failed to open binary file: {}", filename);
@@ -166,7 +216,7 @@ bool HistoricalDataManager::loadFromBinary(const std::string& filename) {
   uint64_t count;
   file.read(reinterpret_cast<char*>(&count), sizeof(count));
 
-  m_dataPoints.reserve(count);
+  points.reserve(count);
 
   // Read data points
   for (uint64_t i = 0; i < count; ++i) {
@@ -186,51 +236,87 @@ bool HistoricalDataManager::loadFromBinary(const std::string& filename) {
     file.read(reinterpret_cast<char*>(&point.volume), sizeof(point.volume));
 
     point.spread = point.ask - point.bid;
-    m_dataPoints.push_back(point);
+    points.push_back(point);
   }
 
   return true;
 }
 
+bool HistoricalDataManager::loadFromCaptures(
+    const std::vector<std::string>& files, const std::string& symbol,
+    uint64_t startTime, uint64_t endTime,
+    std::vector<MarketDataPoint>& points) {
+  exchange::capture::ReplayMarketDataFeed replay(
+      files, exchange::capture::ReplayMarketDataFeed::MAX_SPEED);
+  replay.subscribeToMarketUpdates(
+      symbol,
+      [&points, startTime, endTime](const exchange::MarketUpdate& update) {
+        if (update.timestamp < startTime || update.timestamp > endTime) {
+          return;
+        }
+        MarketDataPoint point;
+        point.timestamp = update.timestamp;
+        point.price = update.price;
+        point.volume = update.volume;
+        point.bid = update.bidPrice;
+        point.ask = update.askPrice;
+        point.spread = update.askPrice - update.bidPrice;
+        points.push_back(point);
+      });
+  replay.replayAll();
+
+  // Captures are in receive order already; the buffer sorts them in case
+  // files overlap
+  return !points.empty();
+}
+
 bool HistoricalDataManager::hasMoreData() const {
   std::lock_guard<std::mutex> lock(m_dataMutex);
-  return m_currentIndex < m_dataPoints.size();
+  return m_currentIndex < m_end;
 }
 
 MarketDataPoint HistoricalDataManager::getNextDataPoint() {
   std::lock_guard<std::mutex> lock(m_dataMutex);
-  if (m_currentIndex < m_dataPoints.size()) {
-    return m_dataPoints[m_currentIndex++];
+  if (m_currentIndex < m_end) {
+    return m_data->at(m_currentIndex++);
   }
   return MarketDataPoint{}; // Return empty point if no more data
 }
 
+size_t HistoricalDataManager::getDataPointCount() const {
+  std::lock_guard<std::mutex> lock(m_dataMutex);
+  return m_end - m_begin;
+}
+
 uint64_t HistoricalDataManager::getStartTime() const {
   std::lock_guard<std::mutex> lock(m_dataMutex);
-  return m_dataPoints.empty() ? 0 : m_dataPoints.front().timestamp;
+  return m_end > m_begin ? m_data->timestamps()[m_begin] : 0;
 }
 
 uint64_t HistoricalDataManager::getEndTime() const {
   std::lock_guard<std::mutex> lock(m_dataMutex);
-  return m_dataPoints.empty() ? 0 : m_dataPoints.back().timestamp;
+  return m_end > m_begin ? m_data->timestamps()[m_end - 1] : 0;
 }
 
 bool HistoricalDataManager::validateDataIntegrity() const {
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  if (m_dataPoints.empty())
+  if (m_end == m_begin)
     return false;
 
   // Check for time ordering
-  for (size_t i = 1; i < m_dataPoints.size(); ++i) {
-    if (m_dataPoints[i].timestamp <= m_dataPoints[i - 1].timestamp) {
-      spdlog::warn("Data integrity issue: timestamp ordering at index {}", i);
+  auto timestamps = m_data->timestamps();
+  for (size_t i = m_begin + 1; i < m_end; ++i) {
+    if (timestamps[i] <= timestamps[i - 1]) {
+      spdlog::warn("Data integrity issue: timestamp ordering at index {}",
+                   i - m_begin);
       return false;
     }
   }
 
   // Check for reasonable price values
-  for (const auto& point : m_dataPoints) {
+  for (size_t i = m_begin; i < m_end; ++i) {
+    auto point = m_data->at(i);
     if (point.price <= 0 || point.bid <= 0 || point.ask <= 0 ||
         point.volume < 0) {
       spdlog::warn("Data integrity issue: invalid values");
@@ -248,7 +334,7 @@ bool HistoricalDataManager::validateDataIntegrity() const {
 void HistoricalDataManager::printDataStatistics() const {
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  if (m_dataPoints.empty()) {
+  if (m_end == m_begin) {
     spdlog::info("No data loaded");
     return;
   }
@@ -256,32 +342,31 @@ void HistoricalDataManager::printDataStatistics() const {
   // Calculate statistics
   double minPrice = std::numeric_limits<double>::max();
   double maxPrice = std::numeric_limits<double>::min();
+  double totalPrice = 0.0;
   double totalVolume = 0.0;
   double totalSpread = 0.0;
 
-  for (const auto& point : m_dataPoints) {
+  for (size_t i = m_begin; i < m_end; ++i) {
+    auto point = m_data->at(i);
     minPrice = std::min(minPrice, point.price);
     maxPrice = std::max(maxPrice, point.price);
+    totalPrice += point.price;
     totalVolume += point.volume;
     totalSpread += point.spread;
   }
 
-  double avgPrice =
-      std::accumulate(
-          m_dataPoints.begin(), m_dataPoints.end(), 0.0,
-          [](double sum, const MarketDataPoint& p) { return sum + p.price; }) /
-      m_dataPoints.size();
-
-  double avgVolume = totalVolume / m_dataPoints.size();
-  double avgSpread = totalSpread / m_dataPoints.size();
+  size_t count = m_end - m_begin;
+  double avgPrice = totalPrice / count;
+  double avgVolume = totalVolume / count;
+  double avgSpread = totalSpread / count;
 
   // Read timestamps directly - getStartTime()/getEndTime() would
   // re-enter m_dataMutex (non-recursive) and deadlock.
-  uint64_t startTs = m_dataPoints.front().timestamp;
-  uint64_t endTs = m_dataPoints.back().timestamp;
+  uint64_t startTs = m_data->timestamps()[m_begin];
+  uint64_t endTs = m_data->timestamps()[m_end - 1];
 
   spdlog::info("Data Statistics:");
-  spdlog::info("  Data Points: {}", m_dataPoints.size());
+  spdlog::info("  Data Points: {}", count);
   spdlog::info("  Time Range: {} to {}", startTs, endTs);
   spdlog::info("  Price Range: ${:.2f} - ${:.2f} (avg: ${:.2f})", minPrice,
                maxPrice, avgPrice);
@@ -290,91 +375,162 @@ void HistoricalDataManager::printDataStatistics() const {
 }
 
 // PerformanceAnalyzer Implementation
+void PerformanceAnalyzer::RunningMoments::add(double value) {
+  ++count;
+  double delta = value - mean;
+  mean += delta / count;
+  m2 += delta * (value - mean);
+  if (value < 0.0) {
+    downsideSquares += value * value;
+  }
+}
+
+double PerformanceAnalyzer::RunningMoments::sharpe() const {
+  if (count < 2)
+    return 0.0;
+
+  double stdDev = std::sqrt(m2 / (count - 1));
+  return (stdDev == 0.0) ? 0.0 : mean / stdDev;
+}
+
+double PerformanceAnalyzer::RunningMoments::sortino() const {
+  if (count < 2)
+    return 0.0;
+
+  double downsideDeviation = std::sqrt(downsideSquares / count);
+  return (downsideDeviation == 0.0) ? 0.0 : mean / downsideDeviation;
+}
+
+void PerformanceAnalyzer::RollingMoments::add(double value, size_t capacity) {
+  if (capacity == 0)
+    return;
+
+  if (values.size() < capacity) {
+    values.push_back(value);
+    moments.add(value);
+    return;
+  }
+
+  // Replace the oldest value, keeping the count
+  double oldest = values[next];
+  values[next] = value;
+  next = (next + 1) % capacity;
+
+  double delta = value - oldest;
+  double mean = moments.mean + delta / moments.count;
+  moments.m2 += delta * (value - mean + oldest - moments.mean);
+  moments.m2 = std::max(moments.m2, 0.0);
+  moments.mean = mean;
+  double downside = std::min(value, 0.0);
+  double oldDownside = std::min(oldest, 0.0);
+  moments.downsideSquares = std::max(
+      moments.downsideSquares + downside * downside - oldDownside * oldDownside,
+      0.0);
+
+  // Rounding error builds up over many slides, so start over from the
+  // window once per lap
+  if (next == 0) {
+    recompute();
+  }
+}
+
+void PerformanceAnalyzer::RollingMoments::recompute() {
+  moments = RunningMoments{};
+  for (double value : values) {
+    moments.add(value);
+  }
+}
+
+PerformanceAnalyzer::PerformanceAnalyzer(size_t returnWindow)
+    : m_returnWindow(returnWindow) {
+  m_recentReturns.values.reserve(returnWindow);
+}
+
 void PerformanceAnalyzer::recordTrade(const BacktestTrade& trade) {
   std::lock_guard<std::mutex> lock(m_analysisMutex);
-  m_trades.push_back(trade);
+
+  if (m_tradeCount == 0) {
+    m_firstTradeTime = trade.timestamp;
+    m_minPosition = trade.position;
+    m_maxPosition = trade.position;
+    m_peakBalance = trade.balance;
+  } else if (m_lastBalance > 0) {
+    double ret = (trade.balance - m_lastBalance) / m_lastBalance;
+    m_returns.add(ret);
+    m_recentReturns.add(ret, m_returnWindow);
+  }
+  ++m_tradeCount;
+  m_lastTradeTime = trade.timestamp;
+  m_lastBalance = trade.balance;
+
+  m_totalPnL += trade.pnl;
+  m_totalVolume += std::abs(trade.quantity);
+  if (trade.pnl > 0) {
+    ++m_wins;
+    m_grossProfit += trade.pnl;
+  } else if (trade.pnl < 0) {
+    ++m_losses;
+    m_grossLoss -= trade.pnl;
+  }
+
+  m_minPosition = std::min(m_minPosition, trade.position);
+  m_maxPosition = std::max(m_maxPosition, trade.position);
+  m_positionSum += trade.position;
+
+  if (trade.balance > m_peakBalance) {
+    m_peakBalance = trade.balance;
+  } else {
+    double drawdown = (m_peakBalance - trade.balance) / m_peakBalance;
+    m_maxDrawdown = std::max(m_maxDrawdown, drawdown);
+  }
 }
 
 void PerformanceAnalyzer::recordMarketData(const MarketDataPoint& data) {
+  if (data.bid <= 0.0 || data.ask <= 0.0)
+    return;
+
   std::lock_guard<std::mutex> lock(m_analysisMutex);
-  m_marketData.push_back(data);
+  ++m_quoteCount;
+  m_meanSpread += (data.ask - data.bid - m_meanSpread) / m_quoteCount;
 }
 
 TradingStatistics PerformanceAnalyzer::calculateStatistics() const {
   std::lock_guard<std::mutex> lock(m_analysisMutex);
 
   TradingStatistics stats;
+  stats.avgSpread = m_meanSpread;
 
-  if (m_trades.empty())
+  if (m_tradeCount == 0)
     return stats;
 
   // Basic metrics
-  stats.totalTrades = m_trades.size();
-  stats.totalPnL = std::accumulate(
-      m_trades.begin(), m_trades.end(), 0.0,
-      [](double sum, const BacktestTrade& trade) { return sum + trade.pnl; });
-  stats.totalVolume =
-      std::accumulate(m_trades.begin(), m_trades.end(), 0.0,
-                      [](double sum, const BacktestTrade& trade) {
-                        return sum + std::abs(trade.quantity);
-                      });
+  stats.totalTrades = m_tradeCount;
+  stats.totalPnL = m_totalPnL;
+  stats.totalVolume = m_totalVolume;
 
   // Time metrics
-  stats.startTime = m_trades.front().timestamp;
-  stats.endTime = m_trades.back().timestamp;
+  stats.startTime = m_firstTradeTime;
+  stats.endTime = m_lastTradeTime;
   stats.duration = stats.endTime - stats.startTime;
 
   // Win/Loss analysis
-  std::vector<double> profits, losses;
-  for (const auto& trade : m_trades) {
-    if (trade.pnl > 0) {
-      profits.push_back(trade.pnl);
-    } else if (trade.pnl < 0) {
-      losses.push_back(std::abs(trade.pnl));
-    }
-  }
-
-  stats.winRate = profits.empty()
-                      ? 0.0
-                      : static_cast<double>(profits.size()) / stats.totalTrades;
-  stats.avgWin = profits.empty()
-                     ? 0.0
-                     : std::accumulate(profits.begin(), profits.end(), 0.0) /
-                           profits.size();
-  stats.avgLoss =
-      losses.empty()
-          ? 0.0
-          : std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
-  stats.profitFactor =
-      (losses.empty() || stats.avgLoss == 0.0)
-          ? std::numeric_limits<double>::infinity()
-          : (stats.avgWin * profits.size()) / (stats.avgLoss * losses.size());
+  stats.winRate = static_cast<double>(m_wins) / m_tradeCount;
+  stats.avgWin = m_wins == 0 ? 0.0 : m_grossProfit / m_wins;
+  stats.avgLoss = m_losses == 0 ? 0.0 : m_grossLoss / m_losses;
+  stats.profitFactor = (m_losses == 0 || m_grossLoss == 0.0)
+                           ? std::numeric_limits<double>::infinity()
+                           : m_grossProfit / m_grossLoss;
 
   // Position metrics
-  if (!m_trades.empty()) {
-    auto minPos =
-        std::min_element(m_trades.begin(), m_trades.end(),
-                         [](const BacktestTrade& a, const BacktestTrade& b) {
-                           return a.position < b.position;
-                         });
-    auto maxPos =
-        std::max_element(m_trades.begin(), m_trades.end(),
-                         [](const BacktestTrade& a, const BacktestTrade& b) {
-                           return a.position < b.position;
-                         });
-
-    stats.minPosition = minPos->position;
-    stats.maxPosition = maxPos->position;
-    stats.avgPosition =
-        std::accumulate(m_trades.begin(), m_trades.end(), 0.0,
-                        [](double sum, const BacktestTrade& trade) {
-                          return sum + trade.position;
-                        }) /
-        m_trades.size();
-  }
+  stats.minPosition = m_minPosition;
+  stats.maxPosition = m_maxPosition;
+  stats.avgPosition = m_positionSum / m_tradeCount;
 
   // Risk metrics
   stats.sharpeRatio = calculateSharpeRatio();
+  stats.sortinoRatio = calculateSortinoRatio();
+  stats.rollingSharpeRatio = calculateRollingSharpeRatio();
+  stats.rollingSortinoRatio = calculateRollingSortinoRatio();
   stats.maxDrawdown = calculateMaxDrawdown();
   stats.valueAtRisk95 = calculateValueAtRisk(0.95);
   stats.valueAtRisk99 = calculateValueAtRisk(0.99);
@@ -383,79 +539,61 @@ TradingStatistics PerformanceAnalyzer::calculateStatistics() const {
 }
 
 double PerformanceAnalyzer::calculateSharpeRatio() const {
-  if (m_trades.size() < 2)
-    return 0.0;
-
-  auto returns = calculateReturns();
-  if (returns.empty())
-    return 0.0;
+  return m_returns.sharpe();
+}
 
-  double meanReturn =
-      std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+double PerformanceAnalyzer::calculateSortinoRatio() const {
+  return m_returns.sortino();
+}
 
-  double variance = 0.0;
-  for (double ret : returns) {
-    variance += (ret - meanReturn) * (ret - meanReturn);
-  }
-  variance /= (returns.size() - 1);
+double PerformanceAnalyzer::calculateRollingSharpeRatio() const {
+  return m_recentReturns.moments.sharpe();
+}
 
-  double stdDev = std::sqrt(variance);
-  return (stdDev == 0.0) ? 0.0 : meanReturn / stdDev;
+double PerformanceAnalyzer::calculateRollingSortinoRatio() const {
+  return m_recentReturns.moments.sortino();
 }
 
 double PerformanceAnalyzer::calculateMaxDrawdown() const {
-  if (m_trades.empty())
-    return 0.0;
-
-  double peak = m_trades[0].balance;
-  double maxDrawdown = 0.0;
-
-  for (const auto& trade : m_trades) {
-    if (trade.balance > peak) {
-      peak = trade.balance;
-    } else {
-      double drawdown = (peak - trade.balance) / peak;
-      maxDrawdown = std::max(maxDrawdown, drawdown);
-    }
-  }
-
-  return maxDrawdown;
+  return m_maxDrawdown;
 }
 
 double PerformanceAnalyzer::calculateValueAtRisk(double confidence) const {
-  auto returns = calculateReturns();
+  // Historical VaR over the recent returns, bounded by the window
+  auto returns = m_recentReturns.values;
   if (returns.empty())
     return 0.0;
 
-  std::sort(returns.begin(), returns.end());
   size_t index = static_cast<size_t>((1.0 - confidence) * returns.size());
   index = std::min(index, returns.size() - 1);
+  std::nth_element(returns.begin(), returns.begin() + index, returns.end());
 
   return -returns[index]; // VaR is typically expressed as a positive number
 }
 
-std::vector<double> PerformanceAnalyzer::calculateReturns() const {
-  std::vector<double> returns;
-  if (m_trades.size() < 2)
-    return returns;
-
-  returns.reserve(m_trades.size() - 1);
-  for (size_t i = 1; i < m_trades.size(); ++i) {
-    double prevBalance = m_trades[i - 1].balance;
-    double currBalance = m_trades[i].balance;
-    if (prevBalance > 0) {
-      returns.push_back((currBalance - prevBalance) / prevBalance);
-    }
-  }
-
-  return returns;
-}
-
 void PerformanceAnalyzer::reset() {
   std::lock_guard<std::mutex> lock(m_analysisMutex);
-  m_trades.clear();
-  m_marketData.clear();
-  m_snapshots.clear();
+  m_tradeCount = 0;
+  m_firstTradeTime = 0;
+  m_lastTradeTime = 0;
+  m_totalPnL = 0.0;
+  m_totalVolume = 0.0;
+  m_wins = 0;
+  m_losses = 0;
+  m_grossProfit = 0.0;
+  m_grossLoss = 0.0;
+  m_minPosition = 0.0;
+  m_maxPosition = 0.0;
+  m_positionSum = 0.0;
+  m_lastBalance = 0.0;
+  m_peakBalance = 0.0;
+  m_maxDrawdown = 0.0;
+  m_returns = RunningMoments{};
+  m_recentReturns.values.clear();
+  m_recentReturns.next = 0;
+  m_recentReturns.moments = RunningMoments{};
+  m_quoteCount = 0;
+  m_meanSpread = 0.0;
 }
 
 // BacktestEngine Implementation
@@ -478,6 +616,15 @@ void BacktestEngine::setJsonLogger(
   m_jsonLogger = std::move(jsonLogger);
 }
 
+void BacktestEngine::setMarketData(
+    std::shared_ptr<const MarketDataBuffer> data) {
+  m_marketData = std::move(data);
+}
+
+void BacktestEngine::setCheckpointCallback(CheckpointCallback callback) {
+  m_checkpointCallback = std::move(callback);
+}
+
 void BacktestEngine::emitFinalStrategyMetrics() {
   if (!m_jsonLogger || !m_jsonLogger->isEnabled()) {
     return;
@@ -545,9 +692,14 @@ bool BacktestEngine::runBacktest(
   m_progress.store(0.0);
   m_backtestStartTime = std::chrono::steady_clock::now();
 
-  // Load historical data
-  if (!m_dataManager->loadData(symbol, m_config.startTimestamp,
-                               m_config.endTimestamp)) {
+  // Load historical data, unless it was shared in already
+  bool loaded = m_marketData
+                    ? m_dataManager->useData(m_marketData,
+                                             m_config.startTimestamp,
+                                             m_config.endTimestamp)
+                    : m_dataManager->loadData(symbol, m_config.startTimestamp,
+                                              m_config.endTimestamp);
+  if (!loaded) {
     spdlog::error("Failed to load historical data for symbol: {}", symbol);
     m_isRunning.store(false);
     return false;
@@ -608,10 +760,19 @@ bool BacktestEngine::runBacktest(
 
     // Calculate performance periodically
     if (processedPoints % 1000 == 0) {
-      calculatePerformance();
+      auto snapshot = calculatePerformance();
       if (m_config.saveIntermediateResults) {
         saveIntermediateResults();
       }
+      if (m_checkpointCallback && processedPoints > 0) {
+        double progress =
+            static_cast<double>(processedPoints) / totalDataPoints;
+        if (!m_checkpointCallback(progress, snapshot)) {
+          spdlog::info("Backtest stopped at checkpoint, {:.1f}% through",
+                       progress * 100.0);
+          m_shouldStop.store(true);
+        }
+      }
     }
 
     // Update progress
@@ -839,13 +1000,14 @@ void BacktestEngine::updatePortfolio(const MarketDataPoint& data) {
   }
 }
 
-void BacktestEngine::calculatePerformance() {
+PerformanceSnapshot BacktestEngine::calculatePerformance() {
   // Create performance snapshot
-  createSnapshot();
+  auto snapshot = createSnapshot();
 
   // Add to analyzer
   // Note: PerformanceAnalyzer would need a method to add snapshots
   // m_analyzer->addSnapshot(snapshot);
+  return snapshot;
 }
 
 PerformanceSnapshot BacktestEngine::createSnapshot() const {
@@ -903,6 +1065,8 @@ std::string BacktestEngine::getDetailedReport() const {
          << (stats.winRate * 100.0) << "%\n";
   report << "Sharpe Ratio: " << std::fixed << std::setprecision(3)
          << stats.sharpeRatio << "\n";
+  report << "Sortino Ratio: " << std::fixed << std::setprecision(3)
+         << stats.sortinoRatio << "\n";
   report << "Max Drawdown: " << std::fixed << std::setprecision(1)
          << (stats.maxDrawdown * 100.0) << "%\n";
   report << "Total Volume: " << std::fixed << std::setprecision(2)
@@ -944,6 +1108,7 @@ bool BacktestEngine::exportResults(const std::string& filename) const {
     file << "    \"total_trades\": " << stats.totalTrades << ",\n";
     file << "    \"win_rate\": " << stats.winRate << ",\n";
     file << "    \"sharpe_ratio\": " << stats.sharpeRatio << ",\n";
+    file << "    \"sortino_ratio\": " << stats.sortinoRatio << ",\n";
     file << "    \"max_drawdown\": " << stats.maxDrawdown << ",\n";
     file << "    \"total_volume\": " << stats.totalVolume << ",\n";
     file << "    \"profit_factor\": " << stats.profitFactor << ",\n";
@@ -1002,46 +1167,147 @@ BacktestEngine::ComparisonResult BacktestEngine::compareStrategies(
 }
 
 // BacktestRunner Implementation
+namespace {
+
+// Directory a batch's backtest writes its results to, unique within the
+// batch and safe as a path component
+std::string runDirectory(const BacktestConfiguration& config, size_t index,
+                         const std::string& configName) {
+  std::string name = std::to_string(index) + "_" + configName;
+  std::replace_if(
+      name.begin(), name.end(),
+      [](char c) {
+        return !std::isalnum(static_cast<unsigned char>(c)) && c != '.' &&
+               c != '-' && c != '_';
+      },
+      '_');
+  return config.outputDirectory + "/runs/" + name;
+}
+
+} // namespace
+
+BacktestRunner::BacktestRunner(size_t threadCount)
+    : m_pool(std::make_unique<utils::WorkStealingPool>(threadCount,
+                                                       "backtest")) {}
+
+void BacktestRunner::setResultCallback(ResultCallback callback) {
+  m_resultCallback = std::move(callback);
+}
+
+std::shared_ptr<const MarketDataBuffer>
+BacktestRunner::loadMarketData(const std::string& dataDirectory,
+                               const std::string& symbol, uint64_t startTime,
+                               uint64_t endTime) {
+  HistoricalDataManager loader(dataDirectory);
+  if (!loader.loadData(symbol, startTime, endTime)) {
+    return nullptr;
+  }
+  return loader.getData();
+}
+
 std::vector<BacktestRunner::BatchResult> BacktestRunner::runBatchBacktests(
     const std::vector<std::pair<std::string, BacktestConfiguration>>& configs,
     const std::string& symbol) {
+  return runBatch(configs, symbol, nullptr);
+}
 
-  std::vector<BatchResult> results;
-  results.reserve(configs.size());
+std::vector<BacktestRunner::BatchResult> BacktestRunner::runBatch(
+    const std::vector<std::pair<std::string, BacktestConfiguration>>& configs,
+    const std::string& symbol,
+    const std::function<void(size_t, const BatchResult&)>& onResult) {
 
-  spdlog::info("Running batch backtests with {} configurations",
-               configs.size());
+  std::vector<BatchResult> results(configs.size());
+  if (configs.empty()) {
+    return results;
+  }
+
+  spdlog::info("Running {} batch backtests on {} threads", configs.size(),
+               m_pool->size());
 
+  // Load each data directory once, over every time range read from it
+  std::map<std::string, std::pair<uint64_t, uint64_t>> ranges;
   for (const auto& [configName, config] : configs) {
-    spdlog::info("Running backtest: {}", configName);
-
-    BatchResult result;
-    result.configName = configName;
-    result.config = config;
-    result.successful = false;
-
-    try {
-      BacktestEngine engine(config);
-      if (engine.initialize()) {
-        if (engine.runBacktest(symbol)) {
-          result.results = engine.getResults();
-          result.successful = true;
-          spdlog::info("Backtest {} completed successfully", configName);
+    auto [it, inserted] = ranges.try_emplace(
+        config.outputDirectory + "/data", config.startTimestamp,
+        config.endTimestamp);
+    if (!inserted) {
+      it->second.first = std::min(it->second.first, config.startTimestamp);
+      it->second.second = std::max(it->second.second, config.endTimestamp);
+    }
+  }
+  std::map<std::string, std::shared_ptr<const MarketDataBuffer>> data;
+  for (const auto& [directory, range] : ranges) {
+    data[directory] =
+        loadMarketData(directory, symbol, range.first, range.second);
+  }
+
+  std::mutex resultMutex;
+  std::condition_variable finished;
+  size_t completed = 0;
+
+  for (size_t i = 0; i < configs.size(); ++i) {
+    m_pool->submit([&, i]() {
+      const auto& [configName, config] = configs[i];
+      spdlog::info("Running backtest: {}", configName);
+
+      BatchResult result;
+      result.configName = configName;
+      result.config = config;
+      result.successful = false;
+
+      try {
+        BacktestConfiguration runConfig = config;
+        runConfig.outputDirectory = runDirectory(config, i, configName);
+
+        BacktestEngine engine(runConfig);
+        engine.setMarketData(data.at(config.outputDirectory + "/data"));
+        if (engine.initialize()) {
+          if (engine.runBacktest(symbol)) {
+            result.results = engine.getResults();
+            result.successful = true;
+            spdlog::info("Backtest {} completed successfully", configName);
+          } else {
+            result.error = "Backtest execution failed";
+            spdlog::error("Backtest {} failed: {}", configName, result.error);
+          }
         } else {
-          result.error = "Backtest execution failed";
+          result.error = "Engine initialization failed";
           spdlog::error("Backtest {} failed: {}", configName, result.error);
         }
-      } else {
-        result.error = "Engine initialization failed";
-        spdlog::error("Backtest {} failed: {}", configName, result.error);
+      } catch (const std::exception& e) {
+        result.error = e.what();
+        spdlog::error("Backtest {} failed with exception: {}", configName,
+                      result.error);
       }
-    } catch (const std::exception& e) {
-      result.error = e.what();
-      spdlog::error("Backtest {} failed with exception: {}", configName,
-                    result.error);
-    }
 
-    results.push_back(result);
+      std::lock_guard<std::mutex> lock(resultMutex);
+      results[i] = std::move(result);
+      ++completed;
+      // A throwing callback must not skip the notify below and hang the batch
+      try {
+        if (onResult) {
+          onResult(i, results[i]);
+        }
+        if (m_resultCallback) {
+          m_resultCallback(results[i], completed, configs.size());
+        }
+      } catch (const std::exception& e) {
+        spdlog::error("Result callback for backtest {} failed: {}",
+                      configName, e.what());
+      } catch (...) {
+        spdlog::error("Result callback for backtest {} failed", configName);
+      }
+      // Notified under the lock, so the batch cannot return and destroy
+      // the condition variable first
+      if (completed == configs.size()) {
+        finished.notify_one();
+      }
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(resultMutex);
+    finished.wait(lock, [&]() { return completed == configs.size(); });
   }
 
   // Log summary
@@ -1107,18 +1373,26 @@ BacktestRunner::OptimizationResult BacktestRunner::optimizeParameters(
     configs.emplace_back("high_fee", highFeeConfig);
   }
 
-  // Run all configurations
-  optimizationResult.allResults = runBatchBacktests(configs, symbol);
-
-  // Find best configuration based on Sharpe ratio
+  // Run all configurations, keeping the best Sharpe ratio as they finish.
+  // Ties go to the earlier configuration, as they would run serially.
   double bestSharpe = -std::numeric_limits<double>::infinity();
-  for (const auto& result : optimizationResult.allResults) {
-    if (result.successful && result.results.sharpeRatio > bestSharpe) {
-      bestSharpe = result.results.sharpeRatio;
-      optimizationResult.bestConfig = result.config;
-      optimizationResult.bestResults = result.results;
-    }
-  }
+  size_t bestIndex = configs.size();
+  optimizationResult.allResults = runBatch(
+      configs, symbol, [&](size_t index, const BatchResult& result) {
+        if (!result.successful) {
+          return;
+        }
+        double sharpe = result.results.sharpeRatio;
+        if (sharpe > bestSharpe ||
+            (sharpe == bestSharpe && index < bestIndex)) {
+          bestSharpe = sharpe;
+          bestIndex = index;
+          optimizationResult.bestConfig = result.config;
+          optimizationResult.bestResults = result.results;
+          spdlog::info("New best Sharpe ratio {:.3f} from {}", sharpe,
+                       result.configName);
+        }
+      });
 
   spdlog::info("Parameter optimization completed. Best Sharpe ratio: {:.3f}",
                bestSharpe);
@@ -3,8 +3,10 @@
 #include "../../core/orderbook/Order.h"
 #include "../../core/utils/JsonLogger.h"
 #include "../../core/utils/TimeUtils.h"
+#include "../../core/utils/WorkStealingPool.h"
 #include "../../strategies/analytics/MarketRegimeDetector.h"
 #include "../../strategies/basic/MLEnhancedMarketMaker.h"
+#include "MarketDataBuffer.h"
 
 #include <atomic>
 #include <chrono>
@@ -67,12 +69,17 @@ struct TradingStatistics {
 
   // Performance metrics
   double sharpeRatio = 0.0;
+  double sortinoRatio = 0.0;
   double maxDrawdown = 0.0;
   double winRate = 0.0;
   double avgWin = 0.0;
   double avgLoss = 0.0;
   double profitFactor = 0.0;
 
+  // Over the most recent returns only, as PerformanceAnalyzer keeps them
+  double rollingSharpeRatio = 0.0;
+  double rollingSortinoRatio = 0.0;
+
   // Risk metrics
   double valueAtRisk95 = 0.0; // 95% VaR
   double valueAtRisk99 = 0.0; // 99% VaR
@@ -150,11 +157,26 @@ public:
   // Data loading
   bool loadData(const std::string& symbol, uint64_t startTime,
                 uint64_t endTime);
+
+  /**
+   * @brief Replay the part of an already loaded buffer within a time range,
+   * sharing it rather than copying it
+   *
+   * @return false if no point falls in the range
+   */
+  bool useData(std::shared_ptr<const MarketDataBuffer> data,
+               uint64_t startTime, uint64_t endTime);
+
+  /**
+   * @brief The buffer being replayed, for handing to other managers
+   */
+  std::shared_ptr<const MarketDataBuffer> getData() const;
+
   bool hasMoreData() const;
   MarketDataPoint getNextDataPoint();
 
   // Data statistics
-  size_t getDataPointCount() const { return m_dataPoints.size(); }
+  size_t getDataPointCount() const;
   uint64_t getStartTime() const;
   uint64_t getEndTime() const;
 
@@ -164,23 +186,47 @@ public:
 
 private:
   std::string m_dataDirectory;
-  std::vector<MarketDataPoint> m_dataPoints;
+
+  // Points [m_begin, m_end) of m_data are replayed
+  std::shared_ptr<const MarketDataBuffer> m_data;
+  size_t m_begin = 0;
+  size_t m_end = 0;
   size_t m_currentIndex = 0;
   mutable std::mutex m_dataMutex;
 
   // Data loading helpers
-  bool loadFromCSV(const std::string& filename);
-  bool loadFromBinary(const std::string& filename);
+  bool adopt(std::vector<MarketDataPoint> points);
+  bool loadFromCSV(const std::string& filename,
+                   std::vector<MarketDataPoint>& points);
+  bool loadFromBinary(const std::string& filename,
+                      std::vector<MarketDataPoint>& points);
+  bool loadFromCaptures(const std::vector<std::string>& files,
+                        const std::string& symbol, uint64_t startTime,
+                        uint64_t endTime,
+                        std::vector<MarketDataPoint>& points);
   MarketDataPoint parseCSVLine(const std::string& line);
 };
 
 /**
  * @class PerformanceAnalyzer
  * @brief Analyzes and calculates performance metrics
+ *
+ * Statistics are kept as running accumulators updated as each trade is
+ * recorded, rather than recomputed from a stored history: Welford mean and
+ * variance of trade-to-trade returns, the running peak and drawdown, and
+ * win/loss and position totals. Recording is O(1) and memory stays bounded
+ * however long the backtest. Rolling Sharpe and Sortino ratios and VaR are
+ * taken over a window of the most recent returns.
  */
 class PerformanceAnalyzer {
 public:
-  PerformanceAnalyzer() = default;
+  static constexpr size_t DEFAULT_RETURN_WINDOW = 1000;
+
+  /**
+   * @param returnWindow Most recent returns kept for the rolling ratios and
+   * VaR
+   */
+  explicit PerformanceAnalyzer(size_t returnWindow = DEFAULT_RETURN_WINDOW);
   ~PerformanceAnalyzer() = default;
 
   // Trade recording
@@ -189,10 +235,12 @@ public:
 
   // Performance calculation
   TradingStatistics calculateStatistics() const;
-  std::vector<PerformanceSnapshot> getPerformanceHistory() const;
 
   // Risk metrics
   double calculateSharpeRatio() const;
+  double calculateSortinoRatio() const;
+  double calculateRollingSharpeRatio() const;
+  double calculateRollingSortinoRatio() const;
   double calculateMaxDrawdown() const;
   double calculateValueAtRisk(double confidence) const;
   double calculateBeta(const std::vector<double>& marketReturns) const;
@@ -207,15 +255,60 @@ public:
   void exportResults(const std::string& filename) const;
 
 private:
-  std::vector<BacktestTrade> m_trades;
-  std::vector<MarketDataPoint> m_marketData;
-  std::vector<PerformanceSnapshot> m_snapshots;
-  mutable std::mutex m_analysisMutex;
+  /**
+   * @brief Welford mean and variance, plus the downside moment for Sortino
+   */
+  struct RunningMoments {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double downsideSquares = 0.0;
+
+    void add(double value);
+    double sharpe() const;
+    double sortino() const;
+  };
 
-  // Helper methods
-  std::vector<double> calculateReturns() const;
-  std::vector<double> calculateDrawdowns() const;
-  double calculateVolatility() const;
+  /**
+   * @brief Moments of the last few returns, updated as each one slides out
+   */
+  struct RollingMoments {
+    std::vector<double> values; // Ring buffer
+    size_t next = 0;
+    RunningMoments moments;
+
+    void add(double value, size_t capacity);
+    void recompute();
+  };
+
+  size_t m_returnWindow;
+
+  // Trades
+  uint64_t m_tradeCount = 0;
+  uint64_t m_firstTradeTime = 0;
+  uint64_t m_lastTradeTime = 0;
+  double m_totalPnL = 0.0;
+  double m_totalVolume = 0.0;
+  uint64_t m_wins = 0;
+  uint64_t m_losses = 0;
+  double m_grossProfit = 0.0;
+  double m_grossLoss = 0.0;
+  double m_minPosition = 0.0;
+  double m_maxPosition = 0.0;
+  double m_positionSum = 0.0;
+
+  // Balance after the last trade, and the returns between trades
+  double m_lastBalance = 0.0;
+  double m_peakBalance = 0.0;
+  double m_maxDrawdown = 0.0;
+  RunningMoments m_returns;
+  RollingMoments m_recentReturns;
+
+  // Market data
+  uint64_t m_quoteCount = 0;
+  double m_meanSpread = 0.0;
+
+  mutable std::mutex m_analysisMutex;
 };
 
 /**
@@ -241,6 +334,21 @@ public:
   // Structured JSONL logging (platform runner ingests this format).
   void setJsonLogger(std::shared_ptr<pinnacle::utils::JsonLogger> jsonLogger);
 
+  /**
+   * @brief Replay data already loaded instead of loading it from the data
+   * directory; only the points within the configured time range are used
+   */
+  void setMarketData(std::shared_ptr<const MarketDataBuffer> data);
+
+  /**
+   * @brief Called at every performance update with the fraction of the data
+   * replayed so far; returning false stops the backtest there
+   */
+  using CheckpointCallback = std::function<bool(
+      double progress, const PerformanceSnapshot& snapshot)>;
+
+  void setCheckpointCallback(CheckpointCallback callback);
+
   // Results access
   TradingStatistics getResults() const;
   std::vector<BacktestTrade> getTrades() const;
@@ -281,6 +389,11 @@ private:
   std::unique_ptr<HistoricalDataManager> m_dataManager;
   std::unique_ptr<PerformanceAnalyzer> m_analyzer;
 
+  // Shared data set by setMarketData, replayed in place of loading
+  std::shared_ptr<const MarketDataBuffer> m_marketData;
+
+  CheckpointCallback m_checkpointCallback;
+
   // Execution state
   std::atomic<bool> m_isRunning{false};
   std::atomic<bool> m_shouldStop{false};
@@ -310,7 +423,7 @@ private:
   void processMarketData(const MarketDataPoint& data);
   void processStrategyOrders();
   void updatePortfolio(const MarketDataPoint& data);
-  void calculatePerformance();
+  PerformanceSnapshot calculatePerformance();
 
   // Realize P&L against cost basis when a fill reduces/flips position.
   // Returns the realized P&L for this fill (excluding fees).
@@ -343,10 +456,23 @@ private:
 /**
  * @class BacktestRunner
  * @brief Utility class for running multiple backtests and comparisons
+ *
+ * The backtests of a batch run in parallel on a work-stealing pool. Their
+ * market data is loaded once per data directory, over the union of the
+ * configurations' time ranges, and shared read-only between them. Each
+ * backtest writes its result files under
+ * <outputDirectory>/runs/<index>_<configName> so that runs do not overwrite
+ * one another.
+ *
+ * A batch must not be started from a result callback or from another
+ * backtest of the same runner.
  */
 class BacktestRunner {
 public:
-  BacktestRunner() = default;
+  /**
+   * @param threadCount Backtests run at once; 0 runs one per hardware thread
+   */
+  explicit BacktestRunner(size_t threadCount = 0);
   ~BacktestRunner() = default;
 
   // Batch testing
@@ -354,14 +480,40 @@ public:
     std::string configName;
     BacktestConfiguration config;
     TradingStatistics results;
-    bool successful;
+    bool successful = false;
     std::string error;
   };
 
+  /**
+   * @brief Called once per backtest as it finishes, in completion order and
+   * never concurrently
+   *
+   * @param completed Backtests of the batch finished so far, this one included
+   */
+  using ResultCallback = std::function<void(
+      const BatchResult& result, size_t completed, size_t total)>;
+
+  void setResultCallback(ResultCallback callback);
+
+  /**
+   * @return Results in the order of the configurations
+   */
   std::vector<BatchResult> runBatchBacktests(
       const std::vector<std::pair<std::string, BacktestConfiguration>>& configs,
       const std::string& symbol);
 
+  /**
+   * @brief Load a symbol's data the way a BacktestEngine would, for sharing
+   * between backtests
+   *
+   * @return nullptr if nothing could be loaded
+   */
+  static std::shared_ptr<const MarketDataBuffer>
+  loadMarketData(const std::string& dataDirectory, const std::string& symbol,
+                 uint64_t startTime, uint64_t endTime);
+
+  size_t getThreadCount() const { return m_pool->size(); }
+
   // Parameter optimization
   struct OptimizationResult {
     BacktestConfiguration bestConfig;
@@ -394,7 +546,14 @@ public:
                                          int numSimulations);
 
 private:
+  std::unique_ptr<utils::WorkStealingPool> m_pool;
+  ResultCallback m_resultCallback;
+
   // Helper methods
+  std::vector<BatchResult> runBatch(
+      const std::vector<std::pair<std::string, BacktestConfiguration>>& configs,
+      const std::string& symbol,
+      const std::function<void(size_t, const BatchResult&)>& onResult);
   BacktestConfiguration
   perturbeConfiguration(const BacktestConfiguration& base,
                         double perturbationStrength) const;
@@ -0,0 +1,405 @@
+#include "DepthReplayBacktest.h"
+
+#include "../../exchange/capture/ReplayMarketDataFeed.h"
+#include "../../exchange/connector/JsonCursor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pinnacle::backtesting {
+
+using exchange::EventSide;
+using exchange::MarketEvent;
+using exchange::MarketEventType;
+using exchange::SimulatedExecution;
+
+namespace {
+
+constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+constexpr int64_t NO_BUY = std::numeric_limits<int64_t>::min();
+constexpr int64_t NO_SELL = std::numeric_limits<int64_t>::max();
+constexpr double EPSILON = 1e-12;
+
+// Trades still waiting for their level update; older ones are dropped
+constexpr size_t MAX_PENDING_TRADES = 64;
+
+int64_t toFixedPoint(double value) {
+  return std::llround(value *
+                     static_cast<double>(exchange::FIXED_POINT_SCALE));
+}
+
+OrderSide restingSide(EventSide side) {
+  return side == EventSide::BID ? OrderSide::BUY : OrderSide::SELL;
+}
+
+// Whether a level at price is ahead of the top at top, on the given side
+bool better(EventSide side, int64_t price, int64_t top) {
+  return side == EventSide::BID ? price > top : price < top;
+}
+
+} // namespace
+
+DepthReplayBacktest::DepthReplayBacktest(DepthReplayStrategy& strategy,
+                                         DepthReplayConfig config)
+    : m_strategy(strategy), m_config(config), m_rng(config.seed),
+      m_orderEntry(config.latency.orderEntry),
+      m_acknowledgement(config.latency.acknowledgement),
+      m_highestBuy(NO_BUY), m_lowestSell(NO_SELL) {}
+
+void DepthReplayBacktest::process(std::span<const MarketEvent> events) {
+  for (const auto& event : events) {
+    if (event.symbolId != m_config.symbolId) {
+      continue;
+    }
+    uint64_t time = std::max(m_now, event.receivedAt);
+    if (time >= m_nextWakeup) {
+      catchUp(time);
+    }
+    m_now = time;
+    apply(event);
+    ++m_stats.events;
+  }
+
+  if (m_config.decisionInterval == 0 && m_started && !m_finished) {
+    decide(m_now);
+  }
+}
+
+void DepthReplayBacktest::finish() {
+  if (m_finished) {
+    return;
+  }
+  while (!m_toVenue.empty()) {
+    VenueAction action = std::move(m_toVenue.front());
+    m_toVenue.pop_front();
+    m_now = std::max(m_now, action.arrivesAt);
+    runAtVenue(action);
+  }
+  m_finished = true;
+  deliver(NEVER);
+}
+
+uint64_t
+DepthReplayBacktest::run(const std::vector<std::string>& captureFiles) {
+  exchange::capture::ReplayMarketDataFeed feed(
+      captureFiles, exchange::capture::ReplayMarketDataFeed::MAX_SPEED);
+  feed.subscribeToEvents(
+      [this](std::span<const MarketEvent> events) { process(events); });
+  uint64_t frames = feed.replayAll();
+  finish();
+  return frames;
+}
+
+std::string DepthReplayBacktest::submitOrder(OrderSide side, double price,
+                                             double quantity) {
+  if (m_finished || quantity <= 0.0) {
+    return {};
+  }
+  std::string orderId = "depth-" + std::to_string(++m_nextOrderId);
+  uint64_t arrivesAt =
+      m_orderEntry.deliveryTime(std::max(m_sendTime, m_now), m_rng);
+  m_toVenue.push_back({VenueAction::Type::NEW, arrivesAt, orderId, side,
+                       price, quantity});
+  m_nextWakeup = std::min(m_nextWakeup, arrivesAt);
+  ++m_stats.ordersSent;
+  return orderId;
+}
+
+void DepthReplayBacktest::cancelOrder(const std::string& orderId) {
+  if (m_finished) {
+    return;
+  }
+  uint64_t arrivesAt =
+      m_orderEntry.deliveryTime(std::max(m_sendTime, m_now), m_rng);
+  m_toVenue.push_back({VenueAction::Type::CANCEL, arrivesAt, orderId,
+                       OrderSide::BUY, 0.0, 0.0});
+  m_nextWakeup = std::min(m_nextWakeup, arrivesAt);
+  ++m_stats.cancelsSent;
+}
+
+double DepthReplayBacktest::getPnL() const {
+  int64_t bid = m_book.bestBid();
+  int64_t ask = m_book.bestAsk();
+  double mark = bid > 0 && ask > 0
+                    ? (exchange::fromFixedPoint(bid) +
+                       exchange::fromFixedPoint(ask)) /
+                          2.0
+                    : exchange::fromFixedPoint(m_lastTrade);
+  return m_cash + m_position * mark;
+}
+
+void DepthReplayBacktest::apply(const MarketEvent& event) {
+  switch (event.type) {
+  case MarketEventType::BOOK_DELTA:
+    m_levelUpdates = true;
+    onLevel(event.side, event.price, event.quantity);
+    break;
+  case MarketEventType::TRADE:
+    onTrade(event.side, event.price, event.quantity);
+    break;
+  case MarketEventType::BBO:
+    // The top of book that venues also send beside level updates lags
+    // them, so it only stands in for depth when there is none
+    if (!m_levelUpdates) {
+      onTop(EventSide::BID, event.price, event.quantity);
+      onTop(EventSide::ASK, event.askPrice, event.askQuantity);
+    }
+    break;
+  case MarketEventType::BOOK_RESET:
+    m_book.clear();
+    m_pendingTrades.clear();
+    m_taken.clear();
+    break;
+  }
+}
+
+void DepthReplayBacktest::onLevel(EventSide side, int64_t price,
+                                  int64_t quantity) {
+  if (side == EventSide::NONE) {
+    return;
+  }
+  int64_t previous = m_book.apply(side, price, quantity);
+  m_taken.erase(std::remove_if(m_taken.begin(), m_taken.end(),
+                               [&](const PendingTrade& taken) {
+                                 return taken.side == side &&
+                                        taken.price == price;
+                               }),
+                m_taken.end());
+  if (m_queue.empty()) {
+    return;
+  }
+
+  if (quantity < previous) {
+    int64_t removed = previous - quantity;
+    int64_t cancelled = removed - consumeTraded(side, price, removed);
+    if (cancelled > 0) {
+      m_queue.onCancel(restingSide(side), exchange::fromFixedPoint(price),
+                       exchange::fromFixedPoint(cancelled),
+                       exchange::fromFixedPoint(previous));
+    }
+    return;
+  }
+
+  // Volume offered through one of our prices would have traded with us
+  // first; a trade through the price fills the orders behind it
+  if (side == EventSide::ASK && price < m_highestBuy) {
+    m_queue.onTrade(OrderSide::BUY, exchange::fromFixedPoint(price), 0.0,
+                    m_fills);
+    settleFills(OrderSide::BUY);
+  } else if (side == EventSide::BID && price > m_lowestSell) {
+    m_queue.onTrade(OrderSide::SELL, exchange::fromFixedPoint(price), 0.0,
+                    m_fills);
+    settleFills(OrderSide::SELL);
+  }
+}
+
+void DepthReplayBacktest::onTop(EventSide side, int64_t price,
+                                int64_t quantity) {
+  if (price <= 0) {
+    return;
+  }
+  while (m_book.depth(side) > 0 && better(side, m_book.best(side), price)) {
+    onLevel(side, m_book.best(side), 0);
+  }
+  onLevel(side, price, quantity);
+}
+
+void DepthReplayBacktest::onTrade(EventSide aggressor, int64_t price,
+                                  int64_t quantity) {
+  m_lastTrade = price;
+  if (m_queue.empty() || aggressor == EventSide::NONE) {
+    return;
+  }
+
+  EventSide resting =
+      aggressor == EventSide::BID ? EventSide::ASK : EventSide::BID;
+  if (m_pendingTrades.size() == MAX_PENDING_TRADES) {
+    m_pendingTrades.erase(m_pendingTrades.begin());
+  }
+  m_pendingTrades.push_back({resting, price, quantity});
+
+  m_queue.onTrade(restingSide(resting), exchange::fromFixedPoint(price),
+                  exchange::fromFixedPoint(quantity), m_fills);
+  settleFills(restingSide(resting));
+}
+
+int64_t DepthReplayBacktest::consumeTraded(EventSide side, int64_t price,
+                                           int64_t quantity) {
+  int64_t consumed = 0;
+  for (auto& trade : m_pendingTrades) {
+    if (trade.side == side && trade.price == price) {
+      int64_t taken = std::min(trade.quantity, quantity - consumed);
+      trade.quantity -= taken;
+      consumed += taken;
+    }
+  }
+  m_pendingTrades.erase(std::remove_if(m_pendingTrades.begin(),
+                                       m_pendingTrades.end(),
+                                       [](const PendingTrade& trade) {
+                                         return trade.quantity == 0;
+                                       }),
+                        m_pendingTrades.end());
+  return consumed;
+}
+
+void DepthReplayBacktest::catchUp(uint64_t time) {
+  if (!m_started) {
+    m_started = true;
+    m_nextDecision =
+        m_config.decisionInterval > 0 ? time + m_config.decisionInterval
+                                      : NEVER;
+  }
+
+  // Orders reaching the venue and strategy calls due before the event,
+  // in time order; orders first when they coincide
+  while (true) {
+    uint64_t venueAt = m_toVenue.empty() ? NEVER : m_toVenue.front().arrivesAt;
+    uint64_t next = std::min(venueAt, m_nextDecision);
+    if (next > time) {
+      break;
+    }
+    m_now = std::max(m_now, next);
+    if (venueAt <= m_nextDecision) {
+      VenueAction action = std::move(m_toVenue.front());
+      m_toVenue.pop_front();
+      runAtVenue(action);
+    } else {
+      // The book cannot change before the event, so a single call covers
+      // every interval that ended in the gap
+      uint64_t interval = m_config.decisionInterval;
+      m_nextDecision = next + interval * ((time - next) / interval + 1);
+      decide(next);
+    }
+  }
+
+  uint64_t venueAt = m_toVenue.empty() ? NEVER : m_toVenue.front().arrivesAt;
+  m_nextWakeup = std::min(venueAt, m_nextDecision);
+}
+
+void DepthReplayBacktest::runAtVenue(VenueAction& action) {
+  if (action.type == VenueAction::Type::CANCEL) {
+    const auto* order = m_queue.find(action.orderId);
+    if (order == nullptr) {
+      report(SimulatedExecution::Type::CANCEL_REJECTED, action.orderId,
+             action.side, 0.0, 0.0, 0.0);
+      return;
+    }
+    OrderSide side = order->side;
+    double price = order->price;
+    double remaining = order->remaining;
+    m_queue.removeOrder(action.orderId);
+    updateRestingPrices();
+    report(SimulatedExecution::Type::CANCELED, action.orderId, side, price,
+           remaining, 0.0);
+    return;
+  }
+
+  double remaining = action.quantity;
+  report(SimulatedExecution::Type::ACK, action.orderId, action.side,
+         action.price, 0.0, remaining);
+
+  // Take whatever the other side offers at or through the limit, less what
+  // earlier orders took since the level last updated
+  int64_t limit = toFixedPoint(action.price);
+  EventSide own =
+      action.side == OrderSide::BUY ? EventSide::BID : EventSide::ASK;
+  EventSide opposite = own == EventSide::BID ? EventSide::ASK : EventSide::BID;
+  for (size_t i = 0; remaining > EPSILON && i < m_book.depth(opposite); ++i) {
+    const auto& level = m_book.level(opposite, i);
+    if (better(own, level.price, limit)) {
+      break;
+    }
+    auto used = std::find_if(m_taken.begin(), m_taken.end(),
+                             [&](const PendingTrade& earlier) {
+                               return earlier.side == opposite &&
+                                      earlier.price == level.price;
+                             });
+    if (used == m_taken.end()) {
+      used = m_taken.insert(m_taken.end(), {opposite, level.price, 0});
+    }
+    if (used->quantity >= level.quantity) {
+      continue;
+    }
+    double taken = std::min(
+        remaining, exchange::fromFixedPoint(level.quantity - used->quantity));
+    used->quantity = std::min(level.quantity,
+                              used->quantity + toFixedPoint(taken));
+    remaining -= taken;
+    if (remaining <= EPSILON) {
+      remaining = 0.0;
+    }
+    ++m_stats.fills;
+    m_stats.filledQuantity += taken;
+    report(SimulatedExecution::Type::FILL, action.orderId, action.side,
+           exchange::fromFixedPoint(level.price), taken, remaining);
+  }
+
+  if (remaining > 0.0) {
+    m_queue.addOrder(action.orderId, action.side, action.price, remaining,
+                     exchange::fromFixedPoint(m_book.quantityAt(own, limit)));
+    updateRestingPrices();
+  }
+}
+
+void DepthReplayBacktest::decide(uint64_t time) {
+  m_sendTime = time + m_config.latency.marketData.sample(m_rng);
+  deliver(m_sendTime);
+}
+
+void DepthReplayBacktest::deliver(uint64_t until) {
+  m_batch.clear();
+  while (!m_toStrategy.empty() &&
+         m_toStrategy.front().execution.receivedAt <= until) {
+    Report& report = m_toStrategy.front();
+    if (report.execution.type == SimulatedExecution::Type::FILL) {
+      double signedQuantity = report.side == OrderSide::BUY
+                                  ? report.execution.quantity
+                                  : -report.execution.quantity;
+      m_position += signedQuantity;
+      m_cash -= signedQuantity * report.execution.price;
+    }
+    m_batch.push_back(std::move(report.execution));
+    m_toStrategy.pop_front();
+  }
+  ++m_stats.batches;
+  m_strategy.onBatch(*this, m_batch);
+}
+
+void DepthReplayBacktest::report(SimulatedExecution::Type type,
+                                 const std::string& orderId, OrderSide side,
+                                 double price, double quantity,
+                                 double remaining) {
+  uint64_t receivedAt = m_acknowledgement.deliveryTime(m_now, m_rng);
+  m_toStrategy.push_back(
+      {{type, orderId, price, quantity, remaining, m_now, receivedAt}, side});
+}
+
+void DepthReplayBacktest::settleFills(OrderSide side) {
+  if (m_fills.empty()) {
+    return;
+  }
+  for (const auto& fill : m_fills) {
+    ++m_stats.fills;
+    m_stats.filledQuantity += fill.quantity;
+    report(SimulatedExecution::Type::FILL, fill.orderId, side, fill.price,
+           fill.quantity, fill.remaining);
+  }
+  m_fills.clear();
+  updateRestingPrices();
+}
+
+void DepthReplayBacktest::updateRestingPrices() {
+  m_highestBuy = NO_BUY;
+  m_lowestSell = NO_SELL;
+  for (const auto& order : m_queue.getOrders()) {
+    int64_t price = toFixedPoint(order.price);
+    if (order.side == OrderSide::BUY) {
+      m_highestBuy = std::max(m_highestBuy, price);
+    } else {
+      m_lowestSell = std::min(m_lowestSell, price);
+    }
+  }
+}
+
+} // namespace pinnacle::backtesting
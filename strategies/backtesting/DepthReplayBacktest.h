@@ -0,0 +1,244 @@
+#pragma once
+
+#include "../../exchange/connector/MarketEvent.h"
+#include "../../exchange/simulator/ExchangeSimulator.h"
+#include "../../exchange/simulator/LatencyModel.h"
+#include "../../exchange/simulator/QueuePositionModel.h"
+#include "ReplayBook.h"
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace pinnacle::backtesting {
+
+/**
+ * @struct DepthReplayConfig
+ * @brief Settings of a depth replay backtest
+ */
+struct DepthReplayConfig {
+  // Events of other symbols are skipped; captures of one product use 0
+  uint32_t symbolId{0};
+
+  // Market time between strategy calls, 0 for one call per process()
+  uint64_t decisionInterval{1'000'000};
+
+  // marketData delays what the strategy sees, orderEntry its orders and
+  // cancels, acknowledgement the reports coming back
+  exchange::SimulatorLatency latency;
+
+  uint64_t seed{42};
+};
+
+/**
+ * @struct DepthReplayStats
+ * @brief Counters of a depth replay backtest
+ */
+struct DepthReplayStats {
+  uint64_t events{0};  // Market events applied to the book
+  uint64_t batches{0}; // Strategy calls
+  uint64_t ordersSent{0};
+  uint64_t cancelsSent{0};
+  uint64_t fills{0};
+  double filledQuantity{0.0};
+};
+
+class DepthReplayBacktest;
+
+/**
+ * @class DepthReplayStrategy
+ * @brief Strategy driven by a DepthReplayBacktest
+ */
+class DepthReplayStrategy {
+public:
+  virtual ~DepthReplayStrategy() = default;
+
+  /**
+   * @brief Called once per decision interval
+   *
+   * @param backtest Replay to read the book from and send orders to
+   * @param reports Reports on our orders that arrived since the last call,
+   * only valid during the call
+   */
+  virtual void
+  onBatch(DepthReplayBacktest& backtest,
+          std::span<const exchange::SimulatedExecution> reports) = 0;
+};
+
+/**
+ * @class DepthReplayBacktest
+ * @brief Backtest that replays order book deltas and fills our orders by
+ * queue position
+ *
+ * Market events rebuild a ReplayBook level by level. Our resting orders
+ * are shadowed beside it by a QueuePositionModel: each joins the back of
+ * its level, moves up as trades and cancels take volume ahead of it, and
+ * fills once the volume ahead has traded, or when the other side of the
+ * book comes through its price. An order that crosses on arrival takes
+ * the levels it reaches at their prices. Neither kind of fill takes
+ * liquidity from the replayed book.
+ *
+ * The strategy is not called per event but once per decision interval of
+ * market time, and at most once between two events, with the book as it
+ * stood and the reports that reached it meanwhile. It decides as if it saw
+ * that book after the market data latency: orders it sends then reach the
+ * venue after the order entry latency, and reports come back after the
+ * acknowledgement latency. Both channels keep messages in order.
+ *
+ * Depth comes from the venues' aggregated level updates, so queue
+ * positions are estimates; a level's decrease counts as trading when a
+ * trade at that price came before it, and as cancels otherwise. BBO
+ * events set the top of the book only for feeds without level updates.
+ *
+ * Runs on the calling thread, without locks or per-event allocation.
+ */
+class DepthReplayBacktest {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param strategy Called with every batch; must outlive the backtest
+   */
+  explicit DepthReplayBacktest(DepthReplayStrategy& strategy,
+                               DepthReplayConfig config = {});
+
+  /**
+   * @brief Replay events, in receive time order
+   */
+  void process(std::span<const exchange::MarketEvent> events);
+
+  /**
+   * @brief End the replay: orders on their way reach the venue, then the
+   * strategy gets every outstanding report in a last batch
+   *
+   * Orders sent from the last batch are ignored.
+   */
+  void finish();
+
+  /**
+   * @brief Replay capture files from start to end, then finish()
+   *
+   * @return Number of frames replayed
+   */
+  uint64_t run(const std::vector<std::string>& captureFiles);
+
+  /**
+   * @brief Send a limit order
+   *
+   * @return Id that its reports carry, empty once finished
+   */
+  std::string submitOrder(OrderSide side, double price, double quantity);
+
+  /**
+   * @brief Send a cancel; a CANCELED or CANCEL_REJECTED report follows
+   */
+  void cancelOrder(const std::string& orderId);
+
+  /**
+   * @brief The book, in MarketEvent fixed point
+   */
+  const ReplayBook& getBook() const { return m_book; }
+
+  /**
+   * @brief Market time, receive nanoseconds of the events
+   */
+  uint64_t now() const { return m_now; }
+
+  /**
+   * @brief Position and cash from the fills reported so far
+   */
+  double getPosition() const { return m_position; }
+  double getCash() const { return m_cash; }
+
+  /**
+   * @brief Cash plus the position marked at the mid, or the last trade
+   * when a side of the book is empty
+   */
+  double getPnL() const;
+
+  const DepthReplayStats& getStats() const { return m_stats; }
+
+private:
+  struct VenueAction {
+    enum class Type : uint8_t { NEW, CANCEL };
+
+    Type type;
+    uint64_t arrivesAt;
+    std::string orderId;
+    OrderSide side;
+    double price;
+    double quantity;
+  };
+
+  struct Report {
+    exchange::SimulatedExecution execution;
+    OrderSide side;
+  };
+
+  // Volume that traded at a level and has yet to leave it in an update
+  struct PendingTrade {
+    exchange::EventSide side;
+    int64_t price;
+    int64_t quantity;
+  };
+
+  void apply(const exchange::MarketEvent& event);
+  void onLevel(exchange::EventSide side, int64_t price, int64_t quantity);
+  void onTop(exchange::EventSide side, int64_t price, int64_t quantity);
+  void onTrade(exchange::EventSide aggressor, int64_t price,
+               int64_t quantity);
+  int64_t consumeTraded(exchange::EventSide side, int64_t price,
+                        int64_t quantity);
+
+  void catchUp(uint64_t time);
+  void runAtVenue(VenueAction& action);
+  void decide(uint64_t time);
+  void deliver(uint64_t until);
+
+  void report(exchange::SimulatedExecution::Type type,
+              const std::string& orderId, OrderSide side, double price,
+              double quantity, double remaining);
+  void settleFills(OrderSide side);
+  void updateRestingPrices();
+
+  DepthReplayStrategy& m_strategy;
+  DepthReplayConfig m_config;
+  std::mt19937_64 m_rng;
+  exchange::LatencyChannel m_orderEntry;
+  exchange::LatencyChannel m_acknowledgement;
+
+  ReplayBook m_book;
+  exchange::QueuePositionModel m_queue;
+  std::vector<exchange::QueueFill> m_fills;
+  std::vector<PendingTrade> m_pendingTrades;
+  // Volume our marketable orders took, gone from its level until it updates
+  std::vector<PendingTrade> m_taken;
+  int64_t m_lastTrade{0};
+  bool m_levelUpdates{false};
+
+  // Our best resting prices, in fixed point, to skip the queue model for
+  // updates that cannot reach our orders
+  int64_t m_highestBuy;
+  int64_t m_lowestSell;
+
+  std::deque<VenueAction> m_toVenue;
+  std::deque<Report> m_toStrategy;
+  std::vector<exchange::SimulatedExecution> m_batch;
+
+  uint64_t m_now{0};
+  uint64_t m_sendTime{0};
+  uint64_t m_nextDecision{0};
+  uint64_t m_nextWakeup{0};
+  bool m_started{false};
+  bool m_finished{false};
+  uint64_t m_nextOrderId{0};
+
+  double m_position{0.0};
+  double m_cash{0.0};
+  DepthReplayStats m_stats;
+};
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,86 @@
+#include "MarketDataBuffer.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace pinnacle::backtesting {
+
+MarketDataBuffer::~MarketDataBuffer() {
+  if (m_mapping) {
+    ::munmap(m_mapping, m_mappedSize);
+  }
+}
+
+std::shared_ptr<const MarketDataBuffer>
+MarketDataBuffer::create(std::vector<MarketDataPoint> points) {
+  auto earlier = [](const MarketDataPoint& a, const MarketDataPoint& b) {
+    return a.timestamp < b.timestamp;
+  };
+  if (!std::is_sorted(points.begin(), points.end(), earlier)) {
+    std::stable_sort(points.begin(), points.end(), earlier);
+  }
+
+  std::shared_ptr<MarketDataBuffer> buffer(new MarketDataBuffer());
+  buffer->m_size = points.size();
+  if (points.empty()) {
+    return buffer;
+  }
+
+  // Every column is 8 bytes wide, so each one starts aligned
+  static_assert(sizeof(uint64_t) == sizeof(double));
+  size_t columnSize = points.size() * sizeof(double);
+  buffer->m_mappedSize = columnSize * 5;
+
+  void* mapping = ::mmap(nullptr, buffer->m_mappedSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    spdlog::error("Failed to map {} bytes of market data: {}",
+                  buffer->m_mappedSize, std::strerror(errno));
+    return nullptr;
+  }
+  buffer->m_mapping = mapping;
+
+  auto* timestamps = static_cast<uint64_t*>(mapping);
+  auto* prices = reinterpret_cast<double*>(timestamps + points.size());
+  auto* bids = prices + points.size();
+  auto* asks = bids + points.size();
+  auto* volumes = asks + points.size();
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    timestamps[i] = points[i].timestamp;
+    prices[i] = points[i].price;
+    bids[i] = points[i].bid;
+    asks[i] = points[i].ask;
+    volumes[i] = points[i].volume;
+  }
+
+  if (::mprotect(mapping, buffer->m_mappedSize, PROT_READ) != 0) {
+    spdlog::warn("Failed to make market data read-only: {}",
+                 std::strerror(errno));
+  }
+
+  buffer->m_timestamps = timestamps;
+  buffer->m_prices = prices;
+  buffer->m_bids = bids;
+  buffer->m_asks = asks;
+  buffer->m_volumes = volumes;
+  return buffer;
+}
+
+size_t MarketDataBuffer::lowerBound(uint64_t timestamp) const {
+  auto column = timestamps();
+  return std::lower_bound(column.begin(), column.end(), timestamp) -
+         column.begin();
+}
+
+size_t MarketDataBuffer::upperBound(uint64_t timestamp) const {
+  auto column = timestamps();
+  return std::upper_bound(column.begin(), column.end(), timestamp) -
+         column.begin();
+}
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../../strategies/analytics/MarketRegimeDetector.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace pinnacle::backtesting {
+
+using pinnacle::analytics::MarketDataPoint;
+
+/**
+ * @class MarketDataBuffer
+ * @brief Immutable, time-ordered market data laid out one column per field
+ *
+ * Loaded once and shared through a shared_ptr by every backtest that replays
+ * the same symbol, so a parameter sweep parses its data once rather than once
+ * per configuration. The columns live in a single private memory mapping
+ * that is made read-only once filled, so a stray write from any of the
+ * threads sharing it faults instead of corrupting the others' runs.
+ *
+ * Spread is not stored; points are rebuilt with spread = ask - bid.
+ */
+class MarketDataBuffer {
+public:
+  ~MarketDataBuffer();
+
+  MarketDataBuffer(const MarketDataBuffer&) = delete;
+  MarketDataBuffer& operator=(const MarketDataBuffer&) = delete;
+
+  /**
+   * @brief Copy points into a new buffer, sorting them by timestamp
+   *
+   * @return nullptr if the mapping could not be made
+   */
+  static std::shared_ptr<const MarketDataBuffer>
+  create(std::vector<MarketDataPoint> points);
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  std::span<const uint64_t> timestamps() const {
+    return {m_timestamps, m_size};
+  }
+  std::span<const double> prices() const { return {m_prices, m_size}; }
+  std::span<const double> bids() const { return {m_bids, m_size}; }
+  std::span<const double> asks() const { return {m_asks, m_size}; }
+  std::span<const double> volumes() const { return {m_volumes, m_size}; }
+
+  /**
+   * @brief Rebuild the point at an index; index must be below size()
+   */
+  MarketDataPoint at(size_t index) const {
+    MarketDataPoint point;
+    point.timestamp = m_timestamps[index];
+    point.price = m_prices[index];
+    point.bid = m_bids[index];
+    point.ask = m_asks[index];
+    point.spread = m_asks[index] - m_bids[index];
+    point.volume = m_volumes[index];
+    return point;
+  }
+
+  /**
+   * @brief Index of the first point at or after a time
+   */
+  size_t lowerBound(uint64_t timestamp) const;
+
+  /**
+   * @brief Index one past the last point at or before a time
+   */
+  size_t upperBound(uint64_t timestamp) const;
+
+  /**
+   * @brief Bytes mapped for the columns
+   */
+  size_t mappedSize() const { return m_mappedSize; }
+
+private:
+  MarketDataBuffer() = default;
+
+  void* m_mapping{nullptr};
+  size_t m_mappedSize{0};
+  size_t m_size{0};
+
+  const uint64_t* m_timestamps{nullptr};
+  const double* m_prices{nullptr};
+  const double* m_bids{nullptr};
+  const double* m_asks{nullptr};
+  const double* m_volumes{nullptr};
+};
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../../exchange/connector/MarketEvent.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pinnacle::backtesting {
+
+/**
+ * @class ReplayBook
+ * @brief Price level book rebuilt from market events for depth replay
+ *
+ * Holds one symbol's aggregated levels in the fixed-point units of
+ * MarketEvent, without the locks, journal, callbacks and per-order objects
+ * of OrderBook, which a replay owned by one thread never needs. Each side
+ * is a vector sorted so the best level is last: updates land near the top
+ * of the book, where inserting or erasing moves only the few levels in
+ * front of it.
+ *
+ * Not thread-safe.
+ */
+class ReplayBook {
+public:
+  struct Level {
+    int64_t price;
+    int64_t quantity;
+  };
+
+  /**
+   * @brief Set the quantity at a level, removing it when zero
+   *
+   * @return Quantity at the level before
+   */
+  int64_t apply(exchange::EventSide side, int64_t price, int64_t quantity) {
+    auto& levels = sideLevels(side);
+    auto it = find(side, levels, price);
+    if (it != levels.end() && it->price == price) {
+      int64_t previous = it->quantity;
+      if (quantity > 0) {
+        it->quantity = quantity;
+      } else {
+        levels.erase(it);
+      }
+      return previous;
+    }
+    if (quantity > 0) {
+      levels.insert(it, {price, quantity});
+    }
+    return 0;
+  }
+
+  void clear() {
+    m_bids.clear();
+    m_asks.clear();
+  }
+
+  /**
+   * @brief Best price on a side, or 0 when the side is empty
+   */
+  int64_t best(exchange::EventSide side) const {
+    const auto& levels = sideLevels(side);
+    return levels.empty() ? 0 : levels.back().price;
+  }
+
+  int64_t bestBid() const { return best(exchange::EventSide::BID); }
+  int64_t bestAsk() const { return best(exchange::EventSide::ASK); }
+
+  int64_t quantityAt(exchange::EventSide side, int64_t price) const {
+    const auto& levels = sideLevels(side);
+    auto it = find(side, levels, price);
+    return it != levels.end() && it->price == price ? it->quantity : 0;
+  }
+
+  size_t depth(exchange::EventSide side) const {
+    return sideLevels(side).size();
+  }
+
+  /**
+   * @brief Level by distance from the top, 0 being the best
+   */
+  const Level& level(exchange::EventSide side, size_t index) const {
+    const auto& levels = sideLevels(side);
+    return levels[levels.size() - 1 - index];
+  }
+
+  bool empty() const { return m_bids.empty() && m_asks.empty(); }
+
+private:
+  // Bids ascend and asks descend, so both end at the best price
+  static bool worse(exchange::EventSide side, int64_t a, int64_t b) {
+    return side == exchange::EventSide::BID ? a < b : a > b;
+  }
+
+  template <typename Levels>
+  static auto find(exchange::EventSide side, Levels& levels, int64_t price)
+      -> decltype(levels.begin()) {
+    return std::lower_bound(levels.begin(), levels.end(), price,
+                            [side](const Level& level, int64_t value) {
+                              return worse(side, level.price, value);
+                            });
+  }
+
+  std::vector<Level>& sideLevels(exchange::EventSide side) {
+    return side == exchange::EventSide::BID ? m_bids : m_asks;
+  }
+
+  const std::vector<Level>& sideLevels(exchange::EventSide side) const {
+    return side == exchange::EventSide::BID ? m_bids : m_asks;
+  }
+
+  std::vector<Level> m_bids;
+  std::vector<Level> m_asks;
+};
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,493 @@
+#include "TickStore.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pinnacle::backtesting {
+
+namespace {
+
+constexpr uint64_t NANOS_PER_DAY = 86400ULL * 1000000000ULL;
+
+void putVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && in < end; shift += 7) {
+    uint8_t byte = *in++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Reads zigzag deltas of one fixed-point column back into units
+class DeltaColumn {
+public:
+  DeltaColumn(const uint8_t* begin, const uint8_t* end)
+      : m_in(begin), m_end(end) {}
+
+  bool next(int64_t& units) {
+    uint64_t delta;
+    if (!getVarint(m_in, m_end, delta)) {
+      return false;
+    }
+    m_units += unzigzag(delta);
+    units = m_units;
+    return true;
+  }
+
+private:
+  const uint8_t* m_in;
+  const uint8_t* m_end;
+  int64_t m_units{0};
+};
+
+// Day of a YYYY-MM-DD.ticks file name, days since the epoch
+std::optional<int64_t> parseDayFile(const std::string& name) {
+  int year = 0;
+  unsigned month = 0;
+  unsigned day = 0;
+  char extension[16] = {};
+  if (std::sscanf(name.c_str(), "%4d-%2u-%2u%15s", &year, &month, &day,
+                  extension) != 4 ||
+      std::strcmp(extension, TICK_FILE_EXTENSION) != 0) {
+    return std::nullopt;
+  }
+  std::chrono::year_month_day date{std::chrono::year{year},
+                                   std::chrono::month{month},
+                                   std::chrono::day{day}};
+  if (!date.ok()) {
+    return std::nullopt;
+  }
+  return std::chrono::sys_days{date}.time_since_epoch().count();
+}
+
+// A day file mapped read-only, with its header validated
+class MappedTickFile {
+public:
+  ~MappedTickFile() {
+    if (m_data) {
+      munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+  }
+
+  bool open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      spdlog::warn("Cannot open tick file {}: {}", path, std::strerror(errno));
+      return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == -1 ||
+        static_cast<size_t>(st.st_size) < sizeof(TickFileHeader)) {
+      spdlog::warn("Tick file {} is too short to hold a header", path);
+      ::close(fd);
+      return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+      spdlog::warn("Cannot map tick file {}: {}", path, std::strerror(errno));
+      return false;
+    }
+    m_data = static_cast<const uint8_t*>(mapped);
+    madvise(mapped, m_size, MADV_SEQUENTIAL);
+
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    if (std::memcmp(m_header.magic, TICK_FILE_MAGIC,
+                    sizeof(TICK_FILE_MAGIC)) != 0 ||
+        m_header.version != TICK_FILE_VERSION ||
+        m_header.indexOffset < sizeof(TickFileHeader) ||
+        m_header.indexOffset > m_size ||
+        m_header.blockCount >
+            (m_size - m_header.indexOffset) / sizeof(TickBlockIndex)) {
+      spdlog::warn("{} is not a version {} tick file", path,
+                   TICK_FILE_VERSION);
+      return false;
+    }
+    return true;
+  }
+
+  const TickFileHeader& header() const { return m_header; }
+
+  TickBlockIndex block(size_t index) const {
+    TickBlockIndex entry;
+    std::memcpy(&entry,
+                m_data + m_header.indexOffset + index * sizeof(entry),
+                sizeof(entry));
+    return entry;
+  }
+
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  const uint8_t* m_data{nullptr};
+  size_t m_size{0};
+  TickFileHeader m_header{};
+};
+
+} // namespace
+
+// TickStoreWriter Implementation
+TickStoreWriter::TickStoreWriter(const std::string& root,
+                                 const std::string& symbol,
+                                 TickStoreConfig config)
+    : m_directory(root + "/" + symbol), m_config(config),
+      m_priceScale(std::pow(10.0, config.priceDecimals)),
+      m_sizeScale(std::pow(10.0, config.sizeDecimals)) {
+  m_config.blockSize = std::max<size_t>(m_config.blockSize, 1);
+  m_block.reserve(m_config.blockSize);
+}
+
+TickStoreWriter::~TickStoreWriter() { close(); }
+
+bool TickStoreWriter::append(const Tick& tick) {
+  if (m_ticksWritten > 0 && tick.timestamp < m_lastTimestamp) {
+    spdlog::warn("Tick at {} is older than the last one written at {}",
+                 tick.timestamp, m_lastTimestamp);
+    return false;
+  }
+
+  auto day = static_cast<int64_t>(tick.timestamp / NANOS_PER_DAY);
+  if (day != m_day) {
+    if (!close() || !openDay(day)) {
+      return false;
+    }
+  }
+
+  if (m_dayTicks == 0) {
+    m_firstTimestamp = tick.timestamp;
+  }
+  m_block.push_back(tick);
+  m_lastTimestamp = tick.timestamp;
+  ++m_dayTicks;
+  ++m_ticksWritten;
+
+  if (m_block.size() >= m_config.blockSize) {
+    return flushBlock();
+  }
+  return true;
+}
+
+bool TickStoreWriter::openDay(int64_t day) {
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+  m_path = m_directory + "/" + TickStore::dayName(day * NANOS_PER_DAY) +
+           TICK_FILE_EXTENSION;
+  m_file.open(m_path, std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open()) {
+    spdlog::error("Failed to create tick file: {}", m_path);
+    return false;
+  }
+
+  // Left zeroed, so the file is invalid until close() writes the header
+  TickFileHeader header{};
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  m_day = day;
+  m_offset = sizeof(header);
+  m_dayTicks = 0;
+  m_index.clear();
+  return m_file.good();
+}
+
+bool TickStoreWriter::flushBlock() {
+  if (m_block.empty()) {
+    return true;
+  }
+
+  for (auto& column : m_columns) {
+    column.clear();
+  }
+
+  uint64_t lastTimestamp = 0;
+  int64_t last[4] = {0, 0, 0, 0}; // Price, size, bid and ask offsets
+  auto putDelta = [](std::string& column, int64_t& previous, int64_t units) {
+    putVarint(column, zigzag(units - previous));
+    previous = units;
+  };
+  auto toUnits = [](double value, double scale) {
+    return static_cast<int64_t>(std::llround(value * scale));
+  };
+
+  for (const auto& tick : m_block) {
+    putVarint(m_columns[0], tick.timestamp - lastTimestamp);
+    lastTimestamp = tick.timestamp;
+    int64_t price = toUnits(tick.price, m_priceScale);
+    putDelta(m_columns[1], last[0], price);
+    putDelta(m_columns[2], last[1], toUnits(tick.size, m_sizeScale));
+    m_columns[3].push_back(static_cast<char>(tick.side));
+    putDelta(m_columns[4], last[2], price - toUnits(tick.bid, m_priceScale));
+    putDelta(m_columns[5], last[3], toUnits(tick.ask, m_priceScale) - price);
+  }
+
+  TickBlockHeader header{};
+  header.tickCount = static_cast<uint32_t>(m_block.size());
+  size_t length = sizeof(header);
+  for (size_t i = 0; i < TICK_COLUMN_COUNT; ++i) {
+    header.columnLength[i] = static_cast<uint32_t>(m_columns[i].size());
+    length += m_columns[i].size();
+  }
+
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& column : m_columns) {
+    m_file.write(column.data(), static_cast<std::streamsize>(column.size()));
+  }
+
+  m_index.push_back({m_offset, static_cast<uint32_t>(length),
+                     header.tickCount, m_block.front().timestamp,
+                     m_block.back().timestamp});
+  m_offset += length;
+  m_block.clear();
+  return m_file.good();
+}
+
+bool TickStoreWriter::close() {
+  if (m_day < 0) {
+    return true;
+  }
+
+  bool ok = flushBlock();
+  m_file.write(reinterpret_cast<const char*>(m_index.data()),
+               static_cast<std::streamsize>(m_index.size() *
+                                            sizeof(TickBlockIndex)));
+
+  TickFileHeader header{};
+  std::memcpy(header.magic, TICK_FILE_MAGIC, sizeof(TICK_FILE_MAGIC));
+  header.version = TICK_FILE_VERSION;
+  header.priceDecimals = m_config.priceDecimals;
+  header.sizeDecimals = m_config.sizeDecimals;
+  header.tickCount = m_dayTicks;
+  header.blockCount = m_index.size();
+  header.indexOffset = m_offset;
+  header.firstTimestamp = m_firstTimestamp;
+  header.lastTimestamp = m_lastTimestamp;
+  m_file.seekp(0);
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  m_file.close();
+  ok = ok && !m_file.fail();
+  if (ok) {
+    ++m_filesWritten;
+  } else {
+    spdlog::error("Failed to write tick file: {}", m_path);
+  }
+  m_day = -1;
+  return ok;
+}
+
+// TickStore Implementation
+TickStore::TickStore(const std::string& root) : m_root(root) {}
+
+bool TickStore::hasSymbol(const std::string& symbol) const {
+  return !listDays(symbol).empty();
+}
+
+std::vector<std::string>
+TickStore::listDays(const std::string& symbol) const {
+  std::vector<std::string> days;
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(m_root + "/" + symbol, error)) {
+    std::string name = entry.path().filename().string();
+    if (entry.is_regular_file() && parseDayFile(name)) {
+      days.push_back(name.substr(0, name.size() -
+                                        std::strlen(TICK_FILE_EXTENSION)));
+    }
+  }
+  std::sort(days.begin(), days.end());
+  return days;
+}
+
+std::string TickStore::dayName(uint64_t timestamp) {
+  std::chrono::sys_days days{
+      std::chrono::days{static_cast<int64_t>(timestamp / NANOS_PER_DAY)}};
+  std::chrono::year_month_day date{days};
+  char name[16];
+  std::snprintf(name, sizeof(name), "%04d-%02u-%02u",
+                static_cast<int>(date.year()),
+                static_cast<unsigned>(date.month()),
+                static_cast<unsigned>(date.day()));
+  return name;
+}
+
+TickStore::QueryStats TickStore::query(const std::string& symbol,
+                                       uint64_t startTime, uint64_t endTime,
+                                       std::vector<Tick>& ticks) const {
+  return read(symbol, startTime, endTime,
+              [&ticks](const Tick& tick) { ticks.push_back(tick); });
+}
+
+TickStore::QueryStats
+TickStore::query(const std::string& symbol, uint64_t startTime,
+                 uint64_t endTime,
+                 std::vector<MarketDataPoint>& points) const {
+  return read(symbol, startTime, endTime, [&points](const Tick& tick) {
+    MarketDataPoint point;
+    point.timestamp = tick.timestamp;
+    point.price = tick.price;
+    point.volume = tick.size;
+    point.bid = tick.bid;
+    point.ask = tick.ask;
+    point.spread = tick.ask - tick.bid;
+    points.push_back(point);
+  });
+}
+
+template <typename Output>
+TickStore::QueryStats TickStore::read(const std::string& symbol,
+                                      uint64_t startTime, uint64_t endTime,
+                                      Output&& output) const {
+  QueryStats stats;
+  if (startTime > endTime) {
+    return stats;
+  }
+
+  std::vector<Tick> decoded;
+  auto firstDay = static_cast<int64_t>(startTime / NANOS_PER_DAY);
+  auto lastDay = static_cast<int64_t>(endTime / NANOS_PER_DAY);
+  std::vector<std::string> paths;
+  for (const auto& day : listDays(symbol)) {
+    auto number = *parseDayFile(day + TICK_FILE_EXTENSION);
+    if (number >= firstDay && number <= lastDay) {
+      paths.push_back(m_root + "/" + symbol + "/" + day + TICK_FILE_EXTENSION);
+    }
+  }
+
+  for (const auto& path : paths) {
+    MappedTickFile file;
+    if (!file.open(path)) {
+      continue;
+    }
+    ++stats.files;
+
+    const auto& header = file.header();
+    double priceScale = std::pow(10.0, header.priceDecimals);
+    double sizeScale = std::pow(10.0, header.sizeDecimals);
+
+    // Blocks are in time order: skip to the first that reaches startTime
+    size_t first = 0;
+    size_t last = header.blockCount;
+    while (first < last) {
+      size_t middle = first + (last - first) / 2;
+      if (file.block(middle).maxTimestamp < startTime) {
+        first = middle + 1;
+      } else {
+        last = middle;
+      }
+    }
+    stats.blocksSkipped += first;
+
+    for (size_t b = first; b < header.blockCount; ++b) {
+      TickBlockIndex entry = file.block(b);
+      if (entry.minTimestamp > endTime) {
+        stats.blocksSkipped += header.blockCount - b;
+        break;
+      }
+
+      TickBlockHeader block;
+      size_t columnsLength = 0;
+      bool valid = entry.offset >= sizeof(TickFileHeader) &&
+                   entry.length >= sizeof(block) &&
+                   entry.offset + entry.length <= header.indexOffset;
+      if (valid) {
+        std::memcpy(&block, file.data() + entry.offset, sizeof(block));
+        for (uint32_t length : block.columnLength) {
+          columnsLength += length;
+        }
+        valid = block.tickCount == entry.tickCount &&
+                sizeof(block) + columnsLength == entry.length &&
+                block.columnLength[3] == block.tickCount;
+      }
+      if (!valid) {
+        spdlog::warn("Tick file {} has a damaged block at {}", path,
+                     entry.offset);
+        ++stats.blocksDamaged;
+        continue;
+      }
+
+      const uint8_t* columns[TICK_COLUMN_COUNT + 1];
+      columns[0] = file.data() + entry.offset + sizeof(block);
+      for (size_t i = 0; i < TICK_COLUMN_COUNT; ++i) {
+        columns[i + 1] = columns[i] + block.columnLength[i];
+      }
+
+      const uint8_t* timestamps = columns[0];
+      DeltaColumn prices(columns[1], columns[2]);
+      DeltaColumn sizes(columns[2], columns[3]);
+      const uint8_t* sides = columns[3];
+      DeltaColumn bids(columns[4], columns[5]);
+      DeltaColumn asks(columns[5], columns[6]);
+
+      // Decoded whole before any is output, so a damaged block adds nothing
+      decoded.clear();
+      Tick tick;
+      for (uint32_t i = 0; i < block.tickCount; ++i) {
+        uint64_t delta;
+        int64_t price, size, bidOffset, askOffset;
+        if (!getVarint(timestamps, columns[1], delta) || !prices.next(price) ||
+            !sizes.next(size) || !bids.next(bidOffset) ||
+            !asks.next(askOffset)) {
+          valid = false;
+          break;
+        }
+        tick.timestamp += delta;
+        tick.price = static_cast<double>(price) / priceScale;
+        tick.size = static_cast<double>(size) / sizeScale;
+        tick.side = static_cast<TickSide>(sides[i]);
+        tick.bid = static_cast<double>(price - bidOffset) / priceScale;
+        tick.ask = static_cast<double>(price + askOffset) / priceScale;
+        if (tick.timestamp >= startTime && tick.timestamp <= endTime) {
+          decoded.push_back(tick);
+        }
+      }
+      if (!valid) {
+        spdlog::warn("Tick file {} has a damaged block at {}", path,
+                     entry.offset);
+        ++stats.blocksDamaged;
+        continue;
+      }
+
+      for (const auto& decodedTick : decoded) {
+        output(decodedTick);
+      }
+      stats.ticks += decoded.size();
+      ++stats.blocksRead;
+    }
+  }
+
+  return stats;
+}
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../../strategies/analytics/MarketRegimeDetector.h"
+#include "TickStoreFormat.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pinnacle::backtesting {
+
+using pinnacle::analytics::MarketDataPoint;
+
+/**
+ * @enum TickSide
+ * @brief Aggressor side of a trade, when known
+ */
+enum class TickSide : uint8_t { UNKNOWN = 0, BUY = 1, SELL = 2 };
+
+/**
+ * @struct Tick
+ * @brief One trade, with the quote it traded against
+ */
+struct Tick {
+  uint64_t timestamp{0};
+  double price{0.0};
+  double size{0.0};
+  TickSide side{TickSide::UNKNOWN};
+  double bid{0.0}; // 0 when not known
+  double ask{0.0};
+};
+
+/**
+ * @struct TickStoreConfig
+ * @brief How a writer encodes ticks
+ */
+struct TickStoreConfig {
+  size_t blockSize = 4096; // Ticks per block
+  uint8_t priceDecimals = 8;
+  uint8_t sizeDecimals = 8;
+};
+
+/**
+ * @class TickStoreWriter
+ * @brief Appends one symbol's ticks to a tick store, a day file at a time
+ *
+ * Ticks must come in time order. A tick on a later UTC day finishes the
+ * current day's file and starts the next; writing a day replaces any file
+ * already stored for it. Prices and sizes are rounded to the configured
+ * number of decimals.
+ *
+ * Not thread-safe.
+ */
+class TickStoreWriter {
+public:
+  TickStoreWriter(const std::string& root, const std::string& symbol,
+                  TickStoreConfig config = {});
+  ~TickStoreWriter();
+
+  TickStoreWriter(const TickStoreWriter&) = delete;
+  TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+  /**
+   * @return false if the tick is older than the last one or its day file
+   * cannot be written
+   */
+  bool append(const Tick& tick);
+
+  /**
+   * @brief Finish the current day file
+   *
+   * @return false if it could not be written
+   */
+  bool close();
+
+  uint64_t getTicksWritten() const { return m_ticksWritten; }
+  uint64_t getFilesWritten() const { return m_filesWritten; }
+
+private:
+  std::string m_directory;
+  TickStoreConfig m_config;
+  double m_priceScale;
+  double m_sizeScale;
+
+  std::ofstream m_file;
+  std::string m_path;
+  int64_t m_day{-1};
+  uint64_t m_lastTimestamp{0};
+  uint64_t m_offset{0};
+  uint64_t m_dayTicks{0};
+  uint64_t m_firstTimestamp{0};
+  std::vector<TickBlockIndex> m_index;
+
+  std::vector<Tick> m_block;
+  std::string m_columns[TICK_COLUMN_COUNT];
+
+  uint64_t m_ticksWritten{0};
+  uint64_t m_filesWritten{0};
+
+  bool openDay(int64_t day);
+  bool flushBlock();
+};
+
+/**
+ * @class TickStore
+ * @brief Reads time ranges back out of a tick store
+ *
+ * Day files are memory-mapped; days outside the range are never opened and
+ * blocks outside it are skipped using the block index, so the cost of a
+ * query follows the ticks it returns rather than the size of the store.
+ * Damaged files and blocks are logged and skipped.
+ *
+ * Queries are const and may run concurrently.
+ */
+class TickStore {
+public:
+  /**
+   * @struct QueryStats
+   * @brief What a query read
+   */
+  struct QueryStats {
+    size_t files = 0;
+    size_t blocksRead = 0;
+    size_t blocksSkipped = 0;
+    size_t blocksDamaged = 0; // Logged and passed over
+    size_t ticks = 0;
+  };
+
+  explicit TickStore(const std::string& root);
+
+  bool hasSymbol(const std::string& symbol) const;
+
+  /**
+   * @brief Days stored for a symbol, as YYYY-MM-DD in order
+   */
+  std::vector<std::string> listDays(const std::string& symbol) const;
+
+  /**
+   * @brief Append the ticks from startTime to endTime inclusive, in order
+   */
+  QueryStats query(const std::string& symbol, uint64_t startTime,
+                   uint64_t endTime, std::vector<Tick>& ticks) const;
+
+  /**
+   * @brief Same, as backtest market data: size becomes volume
+   */
+  QueryStats query(const std::string& symbol, uint64_t startTime,
+                   uint64_t endTime,
+                   std::vector<MarketDataPoint>& points) const;
+
+  /**
+   * @brief UTC day of a timestamp, as YYYY-MM-DD
+   */
+  static std::string dayName(uint64_t timestamp);
+
+private:
+  std::string m_root;
+
+  template <typename Output>
+  QueryStats read(const std::string& symbol, uint64_t startTime,
+                  uint64_t endTime, Output&& output) const;
+};
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,234 @@
+#include "TickStore.h"
+
+#include <boost/program_options.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string_view>
+
+namespace po = boost::program_options;
+using namespace pinnacle::backtesting;
+
+namespace {
+
+constexpr uint64_t NANOS_PER_DAY = 86400ULL * 1000000000ULL;
+
+template <typename T> bool parseField(std::string_view field, T& value) {
+  while (!field.empty() && field.front() == ' ') {
+    field.remove_prefix(1);
+  }
+  auto result =
+      std::from_chars(field.data(), field.data() + field.size(), value);
+  return result.ec == std::errc();
+}
+
+TickSide parseSide(std::string_view field, const Tick& tick) {
+  if (!field.empty()) {
+    char first = field.front();
+    if (first == 'b' || first == 'B' || first == '1') {
+      return TickSide::BUY;
+    }
+    if (first == 's' || first == 'S' || first == '2') {
+      return TickSide::SELL;
+    }
+  }
+  // Infer the aggressor from where the trade printed against the quote
+  if (tick.ask > 0.0 && tick.price >= tick.ask) {
+    return TickSide::BUY;
+  }
+  if (tick.bid > 0.0 && tick.price <= tick.bid) {
+    return TickSide::SELL;
+  }
+  return TickSide::UNKNOWN;
+}
+
+// timestamp,symbol,price,bid,ask,volume[,side], the backtest CSV layout
+bool parseLine(std::string_view line, std::string_view& symbol, Tick& tick) {
+  std::string_view fields[7];
+  size_t count = 0;
+  while (count < 7) {
+    size_t comma = line.find(',');
+    fields[count++] = line.substr(0, comma);
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    line.remove_prefix(comma + 1);
+  }
+  if (count < 6) {
+    return false;
+  }
+  symbol = fields[1];
+  if (!parseField(fields[0], tick.timestamp) ||
+      !parseField(fields[2], tick.price) || !parseField(fields[3], tick.bid) ||
+      !parseField(fields[4], tick.ask) || !parseField(fields[5], tick.size)) {
+    return false;
+  }
+  tick.side = parseSide(count > 6 ? fields[6] : std::string_view{}, tick);
+  return true;
+}
+
+// One symbol's output: ticks are held a UTC day at a time and sorted
+// before writing, so input only has to be in order from day to day
+struct SymbolOutput {
+  std::unique_ptr<TickStoreWriter> writer;
+  std::vector<Tick> day;
+  uint64_t dayNumber = 0;
+  uint64_t dropped = 0;
+
+  void flush() {
+    std::stable_sort(day.begin(), day.end(),
+                     [](const Tick& a, const Tick& b) {
+                       return a.timestamp < b.timestamp;
+                     });
+    for (const auto& tick : day) {
+      if (!writer->append(tick)) {
+        ++dropped;
+      }
+    }
+    day.clear();
+  }
+};
+
+} // namespace
+
+// Converts backtest CSV files into a columnar tick store that
+// HistoricalDataManager reads from <data directory>/ticks.
+int main(int argc, char* argv[]) {
+  std::vector<std::string> inputs;
+  std::string output;
+  std::string symbolOverride;
+  TickStoreConfig config;
+  unsigned priceDecimals = 0;
+  unsigned sizeDecimals = 0;
+
+  po::options_description desc("Tick store converter options");
+  desc.add_options()("help", "Show help message")(
+      "input", po::value<std::vector<std::string>>(&inputs)->multitoken(),
+      "CSV files as timestamp,symbol,price,bid,ask,volume[,side]")(
+      "output",
+      po::value<std::string>(&output)->default_value(
+          "backtest_results/data/ticks"),
+      "Tick store directory")(
+      "symbol", po::value<std::string>(&symbolOverride),
+      "Store every row under this symbol instead of the CSV's")(
+      "price-decimals",
+      po::value<unsigned>(&priceDecimals)->default_value(8),
+      "Decimals kept of prices, bids and asks")(
+      "size-decimals", po::value<unsigned>(&sizeDecimals)->default_value(8),
+      "Decimals kept of sizes")(
+      "block-size",
+      po::value<size_t>(&config.blockSize)->default_value(4096),
+      "Ticks per compressed block");
+
+  po::positional_options_description positional;
+  positional.add("input", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(positional)
+                  .run(),
+              vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << e.what() << "\n" << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help") || inputs.empty()) {
+    std::cout << "Usage: tick_store_convert [options] FILE.csv...\n"
+              << desc << std::endl;
+    return vm.count("help") ? 0 : 1;
+  }
+  if (priceDecimals > 12 || sizeDecimals > 12) {
+    std::cerr << "At most 12 decimals are supported" << std::endl;
+    return 1;
+  }
+  config.priceDecimals = static_cast<uint8_t>(priceDecimals);
+  config.sizeDecimals = static_cast<uint8_t>(sizeDecimals);
+
+  auto started = std::chrono::steady_clock::now();
+  std::map<std::string, SymbolOutput, std::less<>> outputs;
+  uint64_t rows = 0;
+  uint64_t rejected = 0;
+  uint64_t late = 0;
+
+  for (const auto& input : inputs) {
+    std::ifstream file(input);
+    if (!file.is_open()) {
+      spdlog::error("Cannot open {}", input);
+      return 1;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      std::string_view symbol;
+      Tick tick;
+      if (!parseLine(line, symbol, tick)) {
+        // The header, or a malformed row
+        if (line.find("timestamp") == std::string::npos) {
+          ++rejected;
+        }
+        continue;
+      }
+      ++rows;
+      if (!symbolOverride.empty()) {
+        symbol = symbolOverride;
+      }
+
+      auto it = outputs.find(symbol);
+      if (it == outputs.end()) {
+        it = outputs.emplace(std::string(symbol), SymbolOutput{}).first;
+        it->second.writer = std::make_unique<TickStoreWriter>(
+            output, it->first, config);
+        it->second.dayNumber = tick.timestamp / NANOS_PER_DAY;
+      }
+
+      auto& out = it->second;
+      uint64_t day = tick.timestamp / NANOS_PER_DAY;
+      if (day < out.dayNumber) {
+        ++late; // Its day has been written already
+        continue;
+      }
+      if (day > out.dayNumber) {
+        out.flush();
+        out.dayNumber = day;
+      }
+      out.day.push_back(tick);
+    }
+  }
+
+  uint64_t written = 0;
+  uint64_t files = 0;
+  for (auto& [symbol, out] : outputs) {
+    out.flush();
+    if (!out.writer->close()) {
+      return 1;
+    }
+    written += out.writer->getTicksWritten();
+    files += out.writer->getFilesWritten();
+    late += out.dropped;
+  }
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - started)
+                       .count();
+  spdlog::info("Converted {} rows of {} symbols into {} day files under {} "
+               "in {:.2f}s",
+               written, outputs.size(), files, output, seconds);
+  if (rejected > 0 || late > 0) {
+    spdlog::warn("Skipped {} malformed rows and {} rows out of day order",
+                 rejected, late);
+  }
+  return rows > 0 ? 0 : 1;
+}
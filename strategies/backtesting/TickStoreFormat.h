@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pinnacle::backtesting {
+
+/**
+ * Tick store day files (.ticks)
+ *
+ * A store is a directory per symbol holding one file per UTC day, named
+ * YYYY-MM-DD.ticks. A file is a header, the blocks, then an index with one
+ * entry per block:
+ *
+ *   TickFileHeader
+ *   block 0
+ *   block 1
+ *   ...
+ *   TickBlockIndex[blockCount]   at indexOffset
+ *
+ * A block is up to blockSize ticks in time order, stored a column at a
+ * time so each column compresses on its own:
+ *
+ *   TickBlockHeader
+ *   timestamps   varint of the delta from the previous timestamp
+ *   prices       zigzag varint of the delta from the previous price
+ *   sizes        zigzag varint of the delta from the previous size
+ *   sides        one byte per tick, a TickSide
+ *   bids         zigzag varint of the delta of price - bid from the
+ *                previous tick's
+ *   asks         zigzag varint of the delta of ask - price from the
+ *                previous tick's
+ *
+ * Prices, bids and asks are integers in units of 10^-priceDecimals, sizes
+ * in units of 10^-sizeDecimals. Quotes are stored against the trade price
+ * since they move with it. Deltas start again from 0 in every block,
+ * so a block decodes without the ones before it, and the index's
+ * timestamp range lets a query skip blocks without touching them.
+ *
+ * All integers are little-endian. Files are written whole and the header
+ * last, so a file whose writer died has no valid header and is ignored.
+ */
+
+constexpr char TICK_FILE_MAGIC[8] = {'P', 'M', 'M', 'T', 'I', 'C', 'K', 'S'};
+constexpr uint32_t TICK_FILE_VERSION = 1;
+constexpr const char* TICK_FILE_EXTENSION = ".ticks";
+constexpr size_t TICK_COLUMN_COUNT = 6;
+
+/**
+ * @struct TickFileHeader
+ * @brief Start of every day file
+ */
+struct TickFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint8_t priceDecimals;
+  uint8_t sizeDecimals;
+  uint16_t reserved;
+  uint64_t tickCount;
+  uint64_t blockCount;
+  uint64_t indexOffset;
+  uint64_t firstTimestamp;
+  uint64_t lastTimestamp;
+};
+
+/**
+ * @struct TickBlockIndex
+ * @brief Where a block is and the time range it covers
+ */
+struct TickBlockIndex {
+  uint64_t offset; // From the start of the file
+  uint32_t length; // Bytes, block header included
+  uint32_t tickCount;
+  uint64_t minTimestamp;
+  uint64_t maxTimestamp;
+};
+
+/**
+ * @struct TickBlockHeader
+ * @brief Precedes each block's columns
+ */
+struct TickBlockHeader {
+  uint32_t tickCount;
+  uint32_t columnLength[TICK_COLUMN_COUNT]; // Bytes, in column order
+  uint32_t reserved;
+};
+
+static_assert(sizeof(TickFileHeader) == 56, "Tick file header layout");
+static_assert(sizeof(TickBlockIndex) == 32, "Tick block index layout");
+static_assert(sizeof(TickBlockHeader) == 32, "Tick block header layout");
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,670 @@
+#include "WalkForwardOptimizer.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+namespace pinnacle::backtesting {
+
+namespace {
+
+using json = nlohmann::json;
+
+const char* statusName(WalkForwardTrial::Status status) {
+  switch (status) {
+  case WalkForwardTrial::Status::COMPLETED:
+    return "completed";
+  case WalkForwardTrial::Status::STOPPED:
+    return "stopped";
+  case WalkForwardTrial::Status::FAILED:
+    break;
+  }
+  return "failed";
+}
+
+WalkForwardTrial::Status parseStatus(const std::string& name) {
+  if (name == "completed") {
+    return WalkForwardTrial::Status::COMPLETED;
+  }
+  if (name == "stopped") {
+    return WalkForwardTrial::Status::STOPPED;
+  }
+  return WalkForwardTrial::Status::FAILED;
+}
+
+// nlohmann::json writes NaN and infinity as null
+json finite(double value) {
+  return std::isfinite(value) ? json(value) : json(nullptr);
+}
+
+double number(const json& object, const char* key) {
+  auto it = object.find(key);
+  return it != object.end() && it->is_number() ? it->get<double>() : 0.0;
+}
+
+size_t index(const json& object, const char* key) {
+  auto it = object.find(key);
+  return it != object.end() && it->is_number_unsigned() ? it->get<size_t>()
+                                                        : SIZE_MAX;
+}
+
+size_t count(const json& object, const char* key) {
+  return static_cast<size_t>(number(object, key));
+}
+
+ParameterSet parameters(const json& object) {
+  ParameterSet values;
+  auto it = object.find("parameters");
+  if (it != object.end() && it->is_object()) {
+    for (const auto& [name, value] : it->items()) {
+      if (value.is_number()) {
+        values[name] = value.get<double>();
+      }
+    }
+  }
+  return values;
+}
+
+} // namespace
+
+// Shared by the tasks of one run()
+struct WalkForwardOptimizer::Study {
+  struct WindowState {
+    std::vector<WalkForwardTrial> trials;
+    std::vector<bool> finished;
+    size_t trialsLeft = 0;
+
+    // Objective of every trial that reached each rung
+    std::vector<std::vector<double>> rungScores;
+
+    bool tested = false;
+    WalkForwardWindowResult result;
+  };
+
+  std::vector<WalkForwardWindow> windows;
+  std::vector<double> rungs;
+  std::vector<WindowState> state;
+
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t windowsLeft = 0;
+
+  std::ofstream journal;
+  size_t resumedTrials = 0;
+  size_t resumedWindows = 0;
+
+  // Appends a line and flushes it, so a crash loses at most that line.
+  // Called with the mutex held.
+  void record(const json& entry) {
+    journal << entry.dump() << '\n';
+    journal.flush();
+  }
+};
+
+WalkForwardOptimizer::WalkForwardOptimizer(WalkForwardConfig config,
+                                           size_t threadCount)
+    : m_config(std::move(config)),
+      m_pool(std::make_unique<utils::WorkStealingPool>(threadCount,
+                                                       "walkforward")) {}
+
+WalkForwardOptimizer::~WalkForwardOptimizer() = default;
+
+void WalkForwardOptimizer::setStrategyFactory(StrategyFactory factory) {
+  m_strategyFactory = std::move(factory);
+}
+
+void WalkForwardOptimizer::setEvaluator(Evaluator evaluator) {
+  m_evaluator = std::move(evaluator);
+}
+
+std::string WalkForwardOptimizer::getStudyDirectory() const {
+  return m_config.baseConfig.outputDirectory + "/studies/" +
+         m_config.studyName;
+}
+
+std::vector<WalkForwardWindow>
+WalkForwardOptimizer::makeWindows(const WalkForwardConfig& config) {
+  std::vector<WalkForwardWindow> windows;
+  uint64_t start = config.baseConfig.startTimestamp;
+  uint64_t end = config.baseConfig.endTimestamp;
+  uint64_t step = config.stepNanos > 0 ? config.stepNanos
+                                       : config.outOfSampleNanos;
+  if (config.inSampleNanos == 0 || config.outOfSampleNanos == 0 ||
+      end <= start) {
+    return windows;
+  }
+
+  // Ends are inclusive, as in BacktestConfiguration, so the periods of a
+  // window share no timestamp
+  for (uint64_t offset = 0;
+       end - start >= offset &&
+       end - start - offset >= config.inSampleNanos + config.outOfSampleNanos;
+       offset += step) {
+    WalkForwardWindow window;
+    window.inSampleStart = config.anchored ? start : start + offset;
+    window.outOfSampleStart = start + offset + config.inSampleNanos;
+    window.inSampleEnd = window.outOfSampleStart - 1;
+    window.outOfSampleEnd =
+        window.outOfSampleStart + config.outOfSampleNanos - 1;
+    windows.push_back(window);
+  }
+  return windows;
+}
+
+bool WalkForwardOptimizer::applyParameter(BacktestConfiguration& config,
+                                          const std::string& name,
+                                          double value) {
+  static const std::map<std::string, double BacktestConfiguration::*> fields =
+      {{"trading_fee", &BacktestConfiguration::tradingFee},
+       {"max_position", &BacktestConfiguration::maxPosition},
+       {"max_drawdown", &BacktestConfiguration::maxDrawdown},
+       {"slippage_bps", &BacktestConfiguration::slippageBps},
+       {"initial_balance", &BacktestConfiguration::initialBalance}};
+
+  auto it = fields.find(name);
+  if (it == fields.end()) {
+    return false;
+  }
+  config.*(it->second) = value;
+  return true;
+}
+
+ParameterSet WalkForwardOptimizer::drawParameters(size_t window,
+                                                  size_t trial) const {
+  // Seeded by the trial alone, so a resumed study draws the same values
+  std::seed_seq seed{static_cast<uint32_t>(m_config.seed),
+                     static_cast<uint32_t>(m_config.seed >> 32),
+                     static_cast<uint32_t>(window),
+                     static_cast<uint32_t>(trial)};
+  std::mt19937_64 rng(seed);
+
+  ParameterSet values;
+  for (const auto& [name, range] : m_config.parameters) {
+    double value = range.low;
+    if (!range.choices.empty()) {
+      std::uniform_int_distribution<size_t> pick(0, range.choices.size() - 1);
+      value = range.choices[pick(rng)];
+    } else if (range.high > range.low) {
+      if (range.logScale && range.low > 0.0) {
+        std::uniform_real_distribution<double> exponent(
+            std::log(range.low), std::log(range.high));
+        value = std::exp(exponent(rng));
+      } else {
+        std::uniform_real_distribution<double> linear(range.low, range.high);
+        value = linear(rng);
+      }
+    }
+    values[name] = value;
+  }
+  return values;
+}
+
+std::vector<double> WalkForwardOptimizer::rungFractions() const {
+  std::vector<double> rungs;
+  if (m_config.reductionFactor <= 1.0 || m_config.minBudget <= 0.0) {
+    return rungs;
+  }
+  for (double fraction = m_config.minBudget; fraction < 1.0 - 1e-9;
+       fraction *= m_config.reductionFactor) {
+    rungs.push_back(fraction);
+  }
+  return rungs;
+}
+
+double WalkForwardOptimizer::score(const TradingStatistics& statistics) const {
+  switch (m_config.objective) {
+  case WalkForwardObjective::TOTAL_PNL:
+    return statistics.totalPnL;
+  case WalkForwardObjective::SHARPE_RATIO:
+    break;
+  }
+  return statistics.sharpeRatio;
+}
+
+bool WalkForwardOptimizer::run(WalkForwardResult& result) {
+  result = WalkForwardResult{};
+
+  Study study;
+  study.windows = makeWindows(m_config);
+  if (study.windows.empty()) {
+    spdlog::error("Walk-forward study {}: no window of {}ns in sample and "
+                  "{}ns out of sample fits the period",
+                  m_config.studyName, m_config.inSampleNanos,
+                  m_config.outOfSampleNanos);
+    return false;
+  }
+  study.rungs = rungFractions();
+  study.state.resize(study.windows.size());
+  for (auto& state : study.state) {
+    state.trials.resize(m_config.trialsPerWindow);
+    state.finished.assign(m_config.trialsPerWindow, false);
+    state.trialsLeft = m_config.trialsPerWindow;
+    state.rungScores.resize(study.rungs.size());
+  }
+
+  if (!prepareJournal(study)) {
+    return false;
+  }
+
+  if (!m_evaluator && !m_data) {
+    m_data = BacktestRunner::loadMarketData(
+        m_config.baseConfig.outputDirectory + "/data", m_config.symbol,
+        m_config.baseConfig.startTimestamp, m_config.baseConfig.endTimestamp);
+    if (!m_data) {
+      spdlog::error("Walk-forward study {}: no market data for {}",
+                    m_config.studyName, m_config.symbol);
+      return false;
+    }
+  }
+
+  spdlog::info("Walk-forward study {}: {} windows of {} trials with {} "
+               "rungs on {} threads, {} trials and {} windows resumed",
+               m_config.studyName, study.windows.size(),
+               m_config.trialsPerWindow, study.rungs.size(), m_pool->size(),
+               study.resumedTrials, study.resumedWindows);
+
+  // Count every window before submitting any, so the count cannot reach
+  // zero while tasks are still being submitted
+  for (const auto& state : study.state) {
+    if (!state.tested) {
+      ++study.windowsLeft;
+    }
+  }
+  for (size_t w = 0; w < study.windows.size(); ++w) {
+    auto& state = study.state[w];
+    if (state.tested) {
+      continue;
+    }
+    if (state.trialsLeft == 0) {
+      m_pool->submit([this, &study, w]() { runOutOfSample(study, w); });
+      continue;
+    }
+    for (size_t t = 0; t < m_config.trialsPerWindow; ++t) {
+      if (!state.finished[t]) {
+        m_pool->submit([this, &study, w, t]() { runTrial(study, w, t); });
+      }
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(study.mutex);
+    study.done.wait(lock, [&]() { return study.windowsLeft == 0; });
+  }
+
+  double inSampleTotal = 0.0;
+  double outOfSampleTotal = 0.0;
+  size_t successful = 0;
+  for (auto& state : study.state) {
+    for (size_t t = 0; t < state.trials.size(); ++t) {
+      if (state.finished[t]) {
+        result.trials.push_back(state.trials[t]);
+      }
+    }
+    if (state.result.successful) {
+      inSampleTotal += state.result.inSampleScore;
+      outOfSampleTotal += state.result.outOfSampleScore;
+      result.recommended = state.result.parameters;
+      ++successful;
+    }
+    result.windows.push_back(std::move(state.result));
+  }
+  if (successful > 0) {
+    result.meanInSampleScore = inSampleTotal / successful;
+    result.meanOutOfSampleScore = outOfSampleTotal / successful;
+    if (result.meanInSampleScore != 0.0) {
+      result.efficiency =
+          result.meanOutOfSampleScore / result.meanInSampleScore;
+    }
+  }
+  result.resumedTrials = study.resumedTrials;
+  result.resumedWindows = study.resumedWindows;
+
+  spdlog::info("Walk-forward study {} completed: {}/{} windows, mean "
+               "in-sample {:.4f}, out-of-sample {:.4f}",
+               m_config.studyName, successful, result.windows.size(),
+               result.meanInSampleScore, result.meanOutOfSampleScore);
+  return true;
+}
+
+bool WalkForwardOptimizer::prepareJournal(Study& study) {
+  namespace fs = std::filesystem;
+  std::string directory = getStudyDirectory();
+  std::error_code error;
+  fs::create_directories(directory, error);
+  if (error) {
+    spdlog::error("Cannot create study directory {}: {}", directory,
+                  error.message());
+    return false;
+  }
+
+  // Everything that decides what the trials run and how they are ranked
+  const auto& base = m_config.baseConfig;
+  json settings = {{"symbol", m_config.symbol},
+                   {"start", base.startTimestamp},
+                   {"end", base.endTimestamp},
+                   {"inSample", m_config.inSampleNanos},
+                   {"outOfSample", m_config.outOfSampleNanos},
+                   {"step", m_config.stepNanos},
+                   {"anchored", m_config.anchored},
+                   {"objective", static_cast<int>(m_config.objective)},
+                   {"trialsPerWindow", m_config.trialsPerWindow},
+                   {"reductionFactor", m_config.reductionFactor},
+                   {"minBudget", m_config.minBudget},
+                   {"seed", m_config.seed},
+                   {"initialBalance", base.initialBalance},
+                   {"tradingFee", base.tradingFee},
+                   {"maxPosition", base.maxPosition},
+                   {"maxDrawdown", base.maxDrawdown},
+                   {"enableSlippage", base.enableSlippage},
+                   {"slippageBps", base.slippageBps}};
+  json& ranges = settings["parameters"] = json::object();
+  for (const auto& [name, range] : m_config.parameters) {
+    ranges[name] = {{"low", range.low},
+                    {"high", range.high},
+                    {"logScale", range.logScale},
+                    {"choices", range.choices}};
+  }
+
+  std::string settingsFile = directory + "/study.json";
+  if (fs::exists(settingsFile)) {
+    std::ifstream in(settingsFile);
+    json saved = json::parse(in, nullptr, false);
+    if (saved != settings) {
+      spdlog::error("Study {} was started with other settings; use another "
+                    "study name or remove {}",
+                    m_config.studyName, directory);
+      return false;
+    }
+  } else {
+    std::ofstream out(settingsFile);
+    out << settings.dump(2) << '\n';
+    if (!out) {
+      spdlog::error("Cannot write {}", settingsFile);
+      return false;
+    }
+  }
+
+  // Read back what an earlier run finished. A line cut short by a crash
+  // fails to parse and is skipped; its trial runs again.
+  std::string journalFile = directory + "/journal.jsonl";
+  bool endsInNewline = true;
+  {
+    std::ifstream in(journalFile);
+    std::string line;
+    while (std::getline(in, line)) {
+      endsInNewline = !in.eof();
+      json entry = json::parse(line, nullptr, false);
+      if (!entry.is_object()) {
+        continue;
+      }
+      size_t w = index(entry, "window");
+      if (w >= study.windows.size()) {
+        continue;
+      }
+      auto& state = study.state[w];
+      std::string type = entry.value("type", "");
+
+      if (type == "trial") {
+        size_t t = index(entry, "trial");
+        if (t >= state.trials.size() || state.finished[t]) {
+          continue;
+        }
+        WalkForwardTrial& trial = state.trials[t];
+        trial.window = w;
+        trial.trial = t;
+        trial.parameters = parameters(entry);
+        trial.status = parseStatus(entry.value("status", ""));
+        trial.score = number(entry, "score");
+        if (auto it = entry.find("rungScores"); it != entry.end()) {
+          for (const auto& value : *it) {
+            double rungScore = value.is_number() ? value.get<double>() : 0.0;
+            size_t rung = trial.rungScores.size();
+            if (rung < state.rungScores.size()) {
+              state.rungScores[rung].push_back(rungScore);
+            }
+            trial.rungScores.push_back(rungScore);
+          }
+        }
+        state.finished[t] = true;
+        --state.trialsLeft;
+        ++study.resumedTrials;
+      } else if (type == "window" && !state.tested) {
+        auto& window = state.result;
+        window.window = study.windows[w];
+        window.successful = entry.value("successful", false);
+        window.parameters = parameters(entry);
+        window.inSampleScore = number(entry, "inSampleScore");
+        window.outOfSampleScore = number(entry, "outOfSampleScore");
+        window.trialsCompleted = count(entry, "trialsCompleted");
+        window.trialsStopped = count(entry, "trialsStopped");
+        window.trialsFailed = count(entry, "trialsFailed");
+        if (auto it = entry.find("statistics"); it != entry.end()) {
+          auto& statistics = window.outOfSample;
+          statistics.totalPnL = number(*it, "totalPnL");
+          statistics.sharpeRatio = number(*it, "sharpeRatio");
+          statistics.maxDrawdown = number(*it, "maxDrawdown");
+          statistics.winRate = number(*it, "winRate");
+          statistics.profitFactor = number(*it, "profitFactor");
+          statistics.totalTrades = count(*it, "totalTrades");
+        }
+        state.tested = true;
+        ++study.resumedWindows;
+      }
+    }
+  }
+
+  study.journal.open(journalFile, std::ios::app);
+  if (!study.journal) {
+    spdlog::error("Cannot open journal {}", journalFile);
+    return false;
+  }
+  if (!endsInNewline) {
+    study.journal << '\n';
+  }
+  return true;
+}
+
+void WalkForwardOptimizer::runTrial(Study& study, size_t w, size_t t) {
+  const auto& window = study.windows[w];
+  WalkForwardTrial trial;
+  trial.window = w;
+  trial.trial = t;
+  trial.parameters = drawParameters(w, t);
+
+  BacktestConfiguration config = m_config.baseConfig;
+  config.startTimestamp = window.inSampleStart;
+  config.endTimestamp = window.inSampleEnd;
+  config.outputDirectory = getStudyDirectory() + "/runs/w" +
+                           std::to_string(w) + "_t" + std::to_string(t);
+  config.saveIntermediateResults = false;
+  for (const auto& [name, value] : trial.parameters) {
+    applyParameter(config, name, value);
+  }
+
+  // Successive halving: at each rung, go on only when in the top
+  // 1/reductionFactor of the trials that got there, counting this one;
+  // the first trials to arrive only have to match the best so far
+  bool stopped = false;
+  auto checkpoint = [&](double progress, const PerformanceSnapshot& snapshot) {
+    while (trial.rungScores.size() < study.rungs.size() &&
+           progress >= study.rungs[trial.rungScores.size()]) {
+      double value = score(snapshot.statistics);
+      size_t rung = trial.rungScores.size();
+      trial.rungScores.push_back(value);
+
+      std::lock_guard<std::mutex> lock(study.mutex);
+      auto& scores = study.state[w].rungScores[rung];
+      scores.push_back(value);
+      size_t ahead = std::count_if(scores.begin(), scores.end(),
+                                   [value](double other) {
+                                     return other > value;
+                                   });
+      size_t promoted = std::max<size_t>(
+          1, static_cast<size_t>(scores.size() / m_config.reductionFactor));
+      if (ahead >= promoted) {
+        stopped = true;
+        return false;
+      }
+    }
+    return true;
+  };
+
+  TradingStatistics statistics;
+  bool ok = false;
+  try {
+    ok = runBacktest(config, trial.parameters, checkpoint, statistics);
+  } catch (const std::exception& e) {
+    spdlog::error("Walk-forward trial {} of window {} failed: {}", t, w,
+                  e.what());
+  }
+
+  if (!ok) {
+    trial.status = WalkForwardTrial::Status::FAILED;
+  } else if (stopped) {
+    trial.status = WalkForwardTrial::Status::STOPPED;
+    trial.score = trial.rungScores.back();
+  } else {
+    trial.status = WalkForwardTrial::Status::COMPLETED;
+    trial.score = score(statistics);
+  }
+
+  json rungScores = json::array();
+  for (double value : trial.rungScores) {
+    rungScores.push_back(finite(value));
+  }
+
+  std::lock_guard<std::mutex> lock(study.mutex);
+  study.record({{"type", "trial"},
+                {"window", w},
+                {"trial", t},
+                {"parameters", trial.parameters},
+                {"status", statusName(trial.status)},
+                {"score", finite(trial.score)},
+                {"rungScores", rungScores}});
+
+  auto& state = study.state[w];
+  state.trials[t] = std::move(trial);
+  state.finished[t] = true;
+  if (--state.trialsLeft == 0) {
+    m_pool->submit([this, &study, w]() { runOutOfSample(study, w); });
+  }
+}
+
+void WalkForwardOptimizer::runOutOfSample(Study& study, size_t w) {
+  WalkForwardWindowResult result;
+  result.window = study.windows[w];
+
+  // The trials are all done, so their records are no longer written to
+  const WalkForwardTrial* best = nullptr;
+  for (const auto& trial : study.state[w].trials) {
+    switch (trial.status) {
+    case WalkForwardTrial::Status::COMPLETED:
+      ++result.trialsCompleted;
+      if (best == nullptr || trial.score > best->score) {
+        best = &trial;
+      }
+      break;
+    case WalkForwardTrial::Status::STOPPED:
+      ++result.trialsStopped;
+      break;
+    case WalkForwardTrial::Status::FAILED:
+      ++result.trialsFailed;
+      break;
+    }
+  }
+
+  if (best != nullptr) {
+    result.parameters = best->parameters;
+    result.inSampleScore = best->score;
+
+    BacktestConfiguration config = m_config.baseConfig;
+    config.startTimestamp = result.window.outOfSampleStart;
+    config.endTimestamp = result.window.outOfSampleEnd;
+    config.outputDirectory =
+        getStudyDirectory() + "/runs/w" + std::to_string(w) + "_oos";
+    config.saveIntermediateResults = false;
+    for (const auto& [name, value] : result.parameters) {
+      applyParameter(config, name, value);
+    }
+
+    try {
+      result.successful = runBacktest(config, result.parameters, {},
+                                      result.outOfSample);
+    } catch (const std::exception& e) {
+      spdlog::error("Walk-forward window {} out of sample failed: {}", w,
+                    e.what());
+    }
+    result.outOfSampleScore =
+        result.successful ? score(result.outOfSample) : 0.0;
+  }
+
+  if (result.successful) {
+    spdlog::info("Walk-forward window {}: in sample {:.4f}, out of sample "
+                 "{:.4f}, {} trials stopped early",
+                 w, result.inSampleScore, result.outOfSampleScore,
+                 result.trialsStopped);
+  } else {
+    spdlog::warn("Walk-forward window {} has no out-of-sample result", w);
+  }
+
+  const auto& statistics = result.outOfSample;
+  std::lock_guard<std::mutex> lock(study.mutex);
+  study.record(
+      {{"type", "window"},
+       {"window", w},
+       {"successful", result.successful},
+       {"parameters", result.parameters},
+       {"inSampleScore", finite(result.inSampleScore)},
+       {"outOfSampleScore", finite(result.outOfSampleScore)},
+       {"trialsCompleted", result.trialsCompleted},
+       {"trialsStopped", result.trialsStopped},
+       {"trialsFailed", result.trialsFailed},
+       {"statistics",
+        {{"totalPnL", finite(statistics.totalPnL)},
+         {"sharpeRatio", finite(statistics.sharpeRatio)},
+         {"maxDrawdown", finite(statistics.maxDrawdown)},
+         {"winRate", finite(statistics.winRate)},
+         {"profitFactor", finite(statistics.profitFactor)},
+         {"totalTrades", statistics.totalTrades}}}});
+
+  auto& state = study.state[w];
+  state.result = std::move(result);
+  state.tested = true;
+  // Notified under the lock, so run() cannot return and destroy the study
+  // first
+  if (--study.windowsLeft == 0) {
+    study.done.notify_one();
+  }
+}
+
+bool WalkForwardOptimizer::runBacktest(
+    const BacktestConfiguration& config, const ParameterSet& parameters,
+    const BacktestEngine::CheckpointCallback& checkpoint,
+    TradingStatistics& results) {
+  if (m_evaluator) {
+    return m_evaluator(config, parameters, checkpoint, results);
+  }
+
+  BacktestEngine engine(config);
+  engine.setMarketData(m_data);
+  if (m_strategyFactory) {
+    engine.setStrategy(m_strategyFactory(parameters));
+  }
+  if (checkpoint) {
+    engine.setCheckpointCallback(checkpoint);
+  }
+  if (!engine.initialize() || !engine.runBacktest(m_config.symbol)) {
+    return false;
+  }
+  results = engine.getResults();
+  return true;
+}
+
+} // namespace pinnacle::backtesting
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "../../core/utils/WorkStealingPool.h"
+#include "BacktestEngine.h"
+#include "MarketDataBuffer.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pinnacle::backtesting {
+
+/**
+ * @brief Values of the parameters being optimized, by name
+ */
+using ParameterSet = std::map<std::string, double>;
+
+/**
+ * @struct ParameterRange
+ * @brief Where a parameter's trial values are drawn from
+ */
+struct ParameterRange {
+  double low = 0.0;
+  double high = 0.0;
+  bool logScale = false; // Draw the logarithm uniformly; low must be > 0
+
+  // When set, trials draw one of these instead of from the range
+  std::vector<double> choices;
+};
+
+/**
+ * @enum WalkForwardObjective
+ * @brief Statistic that trials are ranked by, higher being better
+ */
+enum class WalkForwardObjective { SHARPE_RATIO, TOTAL_PNL };
+
+/**
+ * @struct WalkForwardConfig
+ * @brief Settings of a walk-forward study
+ */
+struct WalkForwardConfig {
+  // Names the study's directory, <outputDirectory>/studies/<studyName>
+  std::string studyName = "study";
+  std::string symbol;
+
+  // Settings shared by every backtest; its time range is the whole period
+  // walked through, and market data is read from <outputDirectory>/data
+  BacktestConfiguration baseConfig;
+
+  // Each window optimizes over inSampleNanos, then tests the winner on the
+  // outOfSampleNanos that follow; windows start stepNanos apart, 0 meaning
+  // outOfSampleNanos. Anchored windows all start their in-sample period at
+  // the beginning and grow instead of rolling.
+  uint64_t inSampleNanos = 0;
+  uint64_t outOfSampleNanos = 0;
+  uint64_t stepNanos = 0;
+  bool anchored = false;
+
+  std::map<std::string, ParameterRange> parameters;
+  WalkForwardObjective objective = WalkForwardObjective::SHARPE_RATIO;
+
+  // Successive halving: trials draw their parameters at random, and at each
+  // rung, at minBudget times reductionFactor^k of the in-sample data, only
+  // those in the top 1/reductionFactor of the trials to reach it go on
+  size_t trialsPerWindow = 27;
+  double reductionFactor = 3.0;
+  double minBudget = 1.0 / 9.0;
+
+  uint64_t seed = 42;
+};
+
+/**
+ * @struct WalkForwardWindow
+ * @brief One in-sample period and the out-of-sample period after it
+ */
+struct WalkForwardWindow {
+  uint64_t inSampleStart;
+  uint64_t inSampleEnd;
+  uint64_t outOfSampleStart;
+  uint64_t outOfSampleEnd;
+};
+
+/**
+ * @struct WalkForwardTrial
+ * @brief Outcome of one parameter set on one window's in-sample period
+ */
+struct WalkForwardTrial {
+  enum class Status { COMPLETED, STOPPED, FAILED };
+
+  size_t window = 0;
+  size_t trial = 0;
+  ParameterSet parameters;
+  Status status = Status::FAILED;
+  double score = 0.0;             // Objective at the end, or where stopped
+  std::vector<double> rungScores; // Objective at each rung reached
+};
+
+/**
+ * @struct WalkForwardWindowResult
+ * @brief A window's winning parameters and how they did out of sample
+ */
+struct WalkForwardWindowResult {
+  WalkForwardWindow window;
+  bool successful = false;
+  ParameterSet parameters;
+  double inSampleScore = 0.0;
+  double outOfSampleScore = 0.0;
+  TradingStatistics outOfSample;
+  size_t trialsCompleted = 0;
+  size_t trialsStopped = 0;
+  size_t trialsFailed = 0;
+};
+
+/**
+ * @struct WalkForwardResult
+ * @brief Outcome of a study
+ */
+struct WalkForwardResult {
+  std::vector<WalkForwardWindowResult> windows;
+  std::vector<WalkForwardTrial> trials;
+
+  // Means over the successful windows; efficiency is out-of-sample over
+  // in-sample, near 1 when in-sample results carry over
+  double meanInSampleScore = 0.0;
+  double meanOutOfSampleScore = 0.0;
+  double efficiency = 0.0;
+
+  // Winner of the last window, the one to trade next
+  ParameterSet recommended;
+
+  // Trials and windows read back from the journal instead of run
+  size_t resumedTrials = 0;
+  size_t resumedWindows = 0;
+};
+
+/**
+ * @class WalkForwardOptimizer
+ * @brief Walk-forward optimization with successive halving and early
+ * stopping
+ *
+ * The period is cut into windows of an in-sample period followed by an
+ * out-of-sample one. On each in-sample period, trials with randomly drawn
+ * parameters race under asynchronous successive halving: a trial's
+ * backtest reports its objective at every rung, and is stopped there
+ * unless it ranks in the top 1/reductionFactor of the trials that reached
+ * the rung before it. The best trial to finish is then backtested on the
+ * out-of-sample period that follows, which no trial of the window has
+ * seen. Out-of-sample results are what the study reports.
+ *
+ * Market data is loaded once and shared read-only. Every window's trials,
+ * and each window's out-of-sample test once its trials are done, run
+ * together on a work-stealing pool.
+ *
+ * Each finished trial and window is appended to
+ * <outputDirectory>/studies/<studyName>/journal.jsonl. Running a study
+ * again resumes it: what the journal records is read back, and only the
+ * rest is run. A study refuses to resume under different settings.
+ */
+class WalkForwardOptimizer {
+public:
+  /**
+   * @brief Runs one backtest
+   *
+   * @param config Base configuration with the period and parameters applied
+   * @param checkpoint Must be handed to the engine, or called as the run
+   * progresses; the run should end early when it returns false. Empty for
+   * out-of-sample runs.
+   * @param results Set to the run's statistics
+   * @return false if the backtest failed
+   */
+  using Evaluator = std::function<bool(
+      const BacktestConfiguration& config, const ParameterSet& parameters,
+      const BacktestEngine::CheckpointCallback& checkpoint,
+      TradingStatistics& results)>;
+
+  /**
+   * @brief Makes the strategy for a parameter set, for the default evaluator
+   */
+  using StrategyFactory =
+      std::function<std::shared_ptr<pinnacle::strategy::MLEnhancedMarketMaker>(
+          const ParameterSet& parameters)>;
+
+  /**
+   * @param threadCount Backtests run at once; 0 runs one per hardware thread
+   */
+  explicit WalkForwardOptimizer(WalkForwardConfig config,
+                                size_t threadCount = 0);
+  ~WalkForwardOptimizer();
+
+  /**
+   * @brief Run each trial's BacktestEngine with a strategy built from the
+   * trial's parameters, rather than without a strategy
+   */
+  void setStrategyFactory(StrategyFactory factory);
+
+  /**
+   * @brief Replace the BacktestEngine runs with another backtest
+   */
+  void setEvaluator(Evaluator evaluator);
+
+  /**
+   * @brief Run or resume the study
+   *
+   * @return false if it could not start: no windows fit the period, the
+   * data failed to load or the journal belongs to other settings
+   */
+  bool run(WalkForwardResult& result);
+
+  /**
+   * @brief Windows that fit the configured period, in time order
+   */
+  static std::vector<WalkForwardWindow>
+  makeWindows(const WalkForwardConfig& config);
+
+  /**
+   * @brief Set a BacktestConfiguration field by its parameter name:
+   * trading_fee, max_position, max_drawdown, slippage_bps or
+   * initial_balance
+   *
+   * @return false if the name is not one of them
+   */
+  static bool applyParameter(BacktestConfiguration& config,
+                             const std::string& name, double value);
+
+  std::string getStudyDirectory() const;
+
+  /**
+   * @brief The data the trials share, once run() has loaded it
+   */
+  std::shared_ptr<const MarketDataBuffer> getMarketData() const {
+    return m_data;
+  }
+
+private:
+  struct Study;
+
+  ParameterSet drawParameters(size_t window, size_t trial) const;
+  std::vector<double> rungFractions() const;
+  double score(const TradingStatistics& statistics) const;
+
+  bool prepareJournal(Study& study);
+  void runTrial(Study& study, size_t window, size_t trial);
+  void runOutOfSample(Study& study, size_t window);
+  bool runBacktest(const BacktestConfiguration& config,
+                   const ParameterSet& parameters,
+                   const BacktestEngine::CheckpointCallback& checkpoint,
+                   TradingStatistics& results);
+
+  WalkForwardConfig m_config;
+  std::unique_ptr<utils::WorkStealingPool> m_pool;
+  StrategyFactory m_strategyFactory;
+  Evaluator m_evaluator;
+  std::shared_ptr<const MarketDataBuffer> m_data;
+};
+
+} // namespace pinnacle::backtesting
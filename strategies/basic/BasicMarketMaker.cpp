@@ -34,12 +34,15 @@ BasicMarketMaker::~BasicMarketMaker() {
   stop();
 }
 
-bool BasicMarketMaker::initialize(std::shared_ptr<OrderBook> orderBook) {
+bool BasicMarketMaker::initialize(std::shared_ptr<OrderBook> orderBook,
+                                  const std::string& venue) {
   if (!orderBook) {
     return false;
   }
 
   m_orderBook = orderBook;
+  m_venueId =
+      execution::OrderLifecycleManager::getInstance().registerVenue(venue);
 
   // Register for order book updates
   m_orderBook->registerUpdateCallback([this](const OrderBook& orderBook) {
@@ -101,21 +104,11 @@ bool BasicMarketMaker::isRunning() const {
   return m_isRunning.load(std::memory_order_acquire);
 }
 
-void BasicMarketMaker::onOrderBookUpdate(const OrderBook& orderBook) {
-  // Create an order book update event
-  Event event;
-  event.type = EventType::ORDER_BOOK_UPDATE;
-  event.timestamp = utils::TimeUtils::getCurrentNanos();
-  // event.data = std::make_shared<OrderBook>(orderBook);
-  // Store a pointer to the existing OrderBook instead of copying it
-  event.data = std::shared_ptr<void>(std::shared_ptr<OrderBook>{},
-                                     const_cast<OrderBook*>(&orderBook));
-
-  // Add to event queue
-  if (!m_eventQueue.tryEnqueue(event)) {
-    // Queue is full, this shouldn't happen in normal operation
-    // In a production system, we would log this and possibly alert
-  }
+void BasicMarketMaker::onOrderBookUpdate(const OrderBook& /*orderBook*/) {
+  // Quotes are computed from the live book, so the strategy thread only needs
+  // to know it changed; a burst of updates collapses into one wakeup instead
+  // of filling the event queue
+  m_bookDirty.store(true, std::memory_order_release);
 
   // Notify the strategy thread
   m_eventCondition.notify_one();
@@ -288,6 +281,7 @@ void BasicMarketMaker::strategyMainLoop() {
   while (!m_shouldStop.load(std::memory_order_acquire)) {
     // Process all pending events
     processEvents();
+    m_bookDirty.store(false, std::memory_order_release);
 
     // Current time
     uint64_t currentTime = utils::TimeUtils::getCurrentNanos();
@@ -318,7 +312,11 @@ void BasicMarketMaker::strategyMainLoop() {
       std::unique_lock<std::mutex> lock(m_eventMutex);
       m_eventCondition.wait_for(
           lock, std::chrono::milliseconds(m_config.quoteUpdateIntervalMs / 2),
-          [this] { return !m_eventQueue.isEmpty() || m_shouldStop.load(); });
+          [this] {
+            return !m_eventQueue.isEmpty() ||
+                   m_bookDirty.load(std::memory_order_acquire) ||
+                   m_shouldStop.load();
+          });
     }
   }
 }
@@ -335,10 +333,6 @@ void BasicMarketMaker::processEvents() {
 
     // Process based on event type
     switch (event.type) {
-    case EventType::ORDER_BOOK_UPDATE:
-      // Order book update handled separately - just triggers quote updates
-      break;
-
     case EventType::TRADE: {
       // Market trade notification
       auto tradeInfo = std::static_pointer_cast<TradeInfo>(event.data);
@@ -352,37 +346,38 @@ void BasicMarketMaker::processEvents() {
       // Order status update
       auto updateInfo = std::static_pointer_cast<OrderUpdateInfo>(event.data);
 
+      execution::OrderHandle handle =
+          parseOrderHandle(updateInfo->orderId);
+
       // Lock for thread safety
       std::lock_guard<std::mutex> lock(m_ordersMutex);
 
-      auto it = m_activeOrders.find(updateInfo->orderId);
-      if (it != m_activeOrders.end()) {
-        OrderInfo& orderInfo = it->second;
-
-        // Calculate fill delta
-        double fillDelta =
-            updateInfo->filledQuantity - orderInfo.filledQuantity;
+      auto it = std::find(m_openHandles.begin(), m_openHandles.end(), handle);
+      if (it != m_openHandles.end()) {
+        auto& lifecycle = execution::OrderLifecycleManager::getInstance();
 
-        // Update order info
-        orderInfo.status = updateInfo->status;
-        orderInfo.filledQuantity = updateInfo->filledQuantity;
+        execution::OrderRecord record;
+        bool applied = lifecycle.applyStatus(
+            handle, updateInfo->status, updateInfo->filledQuantity,
+            utils::TimeUtils::getCurrentNanos(), &record);
 
         // Update position and P&L if there was a fill
+        double fillDelta = applied ? record.lastFillQuantity : 0.0;
         if (fillDelta > 0) {
           // Update position
           double positionDelta =
-              (orderInfo.side == OrderSide::BUY) ? fillDelta : -fillDelta;
+              (record.side == OrderSide::BUY) ? fillDelta : -fillDelta;
           double currentPosition = m_position.load(std::memory_order_relaxed);
           double newPosition = currentPosition + positionDelta;
           m_position.store(newPosition, std::memory_order_relaxed);
 
           // Notify risk manager of fill
-          risk::RiskManager::getInstance().onFill(
-              orderInfo.side, orderInfo.price, fillDelta, m_symbol);
+          risk::RiskManager::getInstance().onFill(record.side, record.price,
+                                                  fillDelta, m_symbol);
 
           // Audit log the fill
-          AUDIT_ORDER_ACTIVITY("strategy", orderInfo.orderId, "fill", m_symbol,
-                               true);
+          AUDIT_ORDER_ACTIVITY("strategy", updateInfo->orderId, "fill",
+                               m_symbol, true);
 
           // Update statistics
           {
@@ -394,20 +389,17 @@ void BasicMarketMaker::processEvents() {
           }
         }
 
-        // Remove completed orders
-        if (orderInfo.status == OrderStatus::FILLED ||
-            orderInfo.status == OrderStatus::CANCELED ||
-            orderInfo.status == OrderStatus::REJECTED ||
-            orderInfo.status == OrderStatus::EXPIRED) {
+        // Stop tracking completed orders (or ones the manager has evicted)
+        if (record.handle != handle || !record.isOpen()) {
 
           // Update statistics for cancellations
-          if (orderInfo.status == OrderStatus::CANCELED) {
+          if (updateInfo->status == OrderStatus::CANCELED) {
             std::lock_guard<std::mutex> statsLock(m_statsMutex);
             m_stats.orderCanceledCount++;
           }
 
-          // Remove the order
-          m_activeOrders.erase(it);
+          *it = m_openHandles.back();
+          m_openHandles.pop_back();
         }
       }
       break;
@@ -482,18 +474,30 @@ void BasicMarketMaker::updateQuotes() {
 void BasicMarketMaker::cancelAllOrders() {
   std::lock_guard<std::mutex> lock(m_ordersMutex);
 
-  // Copy order IDs to avoid iterator invalidation
-  std::vector<std::string> orderIds;
-  for (const auto& pair : m_activeOrders) {
-    orderIds.push_back(pair.first);
-  }
+  auto& lifecycle = execution::OrderLifecycleManager::getInstance();
+
+  // Cancel each order, keeping the ones the book refuses so a later order
+  // update can settle them
+  size_t kept = 0;
+  for (execution::OrderHandle handle : m_openHandles) {
+    execution::OrderRecord record;
+    if (!lifecycle.get(handle, record) || !record.isOpen()) {
+      continue;
+    }
+
+    std::string orderId = makeOrderId(record.side, handle);
+    lifecycle.onCancelRequest(handle, utils::TimeUtils::getCurrentNanos());
 
-  // Cancel each order
-  for (const auto& orderId : orderIds) {
     // In a real system, we would call the exchange API here
-    m_orderBook->cancelOrder(orderId);
-    AUDIT_ORDER_ACTIVITY("strategy", orderId, "cancel", m_symbol, true);
+    if (m_orderBook->cancelOrder(orderId)) {
+      lifecycle.onCanceled(handle, utils::TimeUtils::getCurrentNanos());
+      AUDIT_ORDER_ACTIVITY("strategy", orderId, "cancel", m_symbol, true);
+    } else {
+      lifecycle.onCancelRejected(handle, utils::TimeUtils::getCurrentNanos());
+      m_openHandles[kept++] = handle;
+    }
   }
+  m_openHandles.resize(kept);
 }
 
 void BasicMarketMaker::placeOrder(OrderSide side, double price,
@@ -513,10 +517,18 @@ void BasicMarketMaker::placeOrder(OrderSide side, double price,
     return;
   }
 
-  // Generate a unique order ID
-  std::string orderId = m_symbol + "-" +
-                        (side == OrderSide::BUY ? "BUY-" : "SELL-") +
-                        std::to_string(utils::TimeUtils::getCurrentNanos());
+  // Track the order before it reaches the book so the ack latency covers
+  // the submission itself
+  auto& lifecycle = execution::OrderLifecycleManager::getInstance();
+  execution::OrderHandle handle = lifecycle.onNew(
+      m_venueId, side, price, quantity, utils::TimeUtils::getCurrentNanos());
+  if (handle == execution::INVALID_ORDER_HANDLE) {
+    spdlog::warn("Order lifecycle table full, dropping {} order for {}",
+                 side == OrderSide::BUY ? "BUY" : "SELL", m_symbol);
+    return;
+  }
+
+  std::string orderId = makeOrderId(side, handle);
 
   // Create the order
   auto order =
@@ -525,19 +537,12 @@ void BasicMarketMaker::placeOrder(OrderSide side, double price,
 
   // Add to order book
   if (m_orderBook->addOrder(order)) {
-    // Track the order
-    std::lock_guard<std::mutex> lock(m_ordersMutex);
-
-    OrderInfo orderInfo;
-    orderInfo.orderId = orderId;
-    orderInfo.side = side;
-    orderInfo.price = price;
-    orderInfo.quantity = quantity;
-    orderInfo.filledQuantity = 0.0;
-    orderInfo.status = OrderStatus::NEW;
-    orderInfo.timestamp = utils::TimeUtils::getCurrentNanos();
+    lifecycle.onAck(handle, utils::TimeUtils::getCurrentNanos());
 
-    m_activeOrders[orderId] = orderInfo;
+    {
+      std::lock_guard<std::mutex> lock(m_ordersMutex);
+      m_openHandles.push_back(handle);
+    }
 
     // Update statistics
     {
@@ -547,7 +552,37 @@ void BasicMarketMaker::placeOrder(OrderSide side, double price,
 
     // Audit log the order placement
     AUDIT_ORDER_ACTIVITY("strategy", orderId, "submit", m_symbol, true);
+  } else {
+    lifecycle.onReject(handle, utils::TimeUtils::getCurrentNanos());
+  }
+}
+
+std::string BasicMarketMaker::makeOrderId(OrderSide side,
+                                          execution::OrderHandle handle) const {
+  return m_symbol + (side == OrderSide::BUY ? "-BUY-" : "-SELL-") +
+         std::to_string(handle);
+}
+
+execution::OrderHandle
+BasicMarketMaker::parseOrderHandle(const std::string& orderId) const {
+  // Order ids are "<symbol>-<side>-<handle>"; anything else is not ours
+  if (orderId.compare(0, m_symbol.size(), m_symbol) != 0) {
+    return execution::INVALID_ORDER_HANDLE;
+  }
+  size_t dash = orderId.rfind('-');
+  if (dash == std::string::npos || dash + 1 >= orderId.size()) {
+    return execution::INVALID_ORDER_HANDLE;
+  }
+
+  execution::OrderHandle handle = 0;
+  for (size_t i = dash + 1; i < orderId.size(); ++i) {
+    char c = orderId[i];
+    if (c < '0' || c > '9') {
+      return execution::INVALID_ORDER_HANDLE;
+    }
+    handle = handle * 10 + static_cast<execution::OrderHandle>(c - '0');
   }
+  return handle;
 }
 
 void BasicMarketMaker::updateStatistics() {
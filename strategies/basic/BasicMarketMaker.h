@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../core/execution/OrderLifecycleManager.h"
 #include "../../core/orderbook/OrderBook.h"
 #include "../../core/risk/CircuitBreaker.h"
 #include "../../core/risk/RiskManager.h"
@@ -46,9 +47,12 @@ public:
    * @brief Initialize the strategy
    *
    * @param orderBook Reference to the order book
+   * @param venue Exchange the strategy's orders go to, under which
+   * OrderLifecycleManager keeps their latencies
    * @return true if initialization was successful, false otherwise
    */
-  bool initialize(std::shared_ptr<OrderBook> orderBook);
+  bool initialize(std::shared_ptr<OrderBook> orderBook,
+                  const std::string& venue = "simulation");
 
   /**
    * @brief Start the strategy
@@ -189,17 +193,6 @@ private:
   std::atomic<double> m_position{0.0};
   std::atomic<double> m_pnl{0.0};
 
-  // Order tracking
-  struct OrderInfo {
-    std::string orderId;
-    OrderSide side;
-    double price;
-    double quantity;
-    double filledQuantity;
-    OrderStatus status;
-    uint64_t timestamp;
-  };
-
   // Trade and order update structs
   struct TradeInfo {
     std::string symbol;
@@ -216,8 +209,11 @@ private:
     uint64_t timestamp;
   };
 
-  std::unordered_map<std::string, OrderInfo> m_activeOrders;
+  // Order tracking - records live in the shared OrderLifecycleManager, the
+  // strategy only keeps the handles it owns
+  std::vector<execution::OrderHandle> m_openHandles;
   mutable std::mutex m_ordersMutex;
+  execution::VenueId m_venueId{0};
 
   // Statistics
   struct Statistics {
@@ -239,12 +235,7 @@ private:
   std::shared_ptr<utils::JsonLogger> m_jsonLogger;
 
   // Internal event queue
-  enum class EventType {
-    ORDER_BOOK_UPDATE,
-    TRADE,
-    ORDER_UPDATE,
-    CONFIG_UPDATE
-  };
+  enum class EventType { TRADE, ORDER_UPDATE, CONFIG_UPDATE };
 
   struct Event {
     EventType type;
@@ -253,6 +244,7 @@ private:
   };
 
   utils::LockFreeMPMCQueue<Event, 1024> m_eventQueue;
+  std::atomic<bool> m_bookDirty{false}; // Book changed since the last loop
   std::mutex m_eventMutex;
   std::condition_variable m_eventCondition;
 
@@ -271,6 +263,8 @@ private:
   void updateQuotes();
   void cancelAllOrders();
   void placeOrder(OrderSide side, double price, double quantity);
+  std::string makeOrderId(OrderSide side, execution::OrderHandle handle) const;
+  execution::OrderHandle parseOrderHandle(const std::string& orderId) const;
   void updateStatistics();
   double calculateOrderQuantity(OrderSide side) const;
   double calculateInventorySkewFactor() const;
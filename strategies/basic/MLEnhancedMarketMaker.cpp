@@ -53,9 +53,10 @@ MLEnhancedMarketMaker::~MLEnhancedMarketMaker() {
   stop();
 }
 
-bool MLEnhancedMarketMaker::initialize(std::shared_ptr<OrderBook> orderBook) {
+bool MLEnhancedMarketMaker::initialize(std::shared_ptr<OrderBook> orderBook,
+                                       const std::string& venue) {
   // Initialize base strategy
-  if (!BasicMarketMaker::initialize(orderBook)) {
+  if (!BasicMarketMaker::initialize(orderBook, venue)) {
     return false;
   }
 
@@ -132,10 +133,16 @@ bool MLEnhancedMarketMaker::start() {
   // Initialize performance tracking
   m_lastPerformanceReport = utils::TimeUtils::getCurrentNanos();
 
+  if (m_conflation) {
+    startAnalyticsThread();
+  }
+
   return true;
 }
 
 bool MLEnhancedMarketMaker::stop() {
+  stopAnalyticsThread();
+
   // Generate final performance report
   if (m_mlConfig.enablePerformanceTracking) {
     generatePerformanceReport();
@@ -161,19 +168,93 @@ bool MLEnhancedMarketMaker::stop() {
 }
 
 void MLEnhancedMarketMaker::onOrderBookUpdate(const OrderBook& orderBook) {
-  // Collect market data for ML
-  collectMarketData();
+  if (!m_conflatedAnalytics.load(std::memory_order_acquire)) {
+    // Collect market data for ML
+    collectMarketData();
 
-  // Update regime detector with market data
-  updateRegimeDetector(orderBook);
+    // Update regime detector with market data
+    updateRegimeDetector(orderBook);
 
-  // Update RL market state
-  updateRLMarketState();
+    // Update RL market state
+    updateRLMarketState();
+  }
 
   // Call base implementation
   BasicMarketMaker::onOrderBookUpdate(orderBook);
 }
 
+void MLEnhancedMarketMaker::setConflationStage(
+    std::shared_ptr<exchange::ConflationStage> stage) {
+  if (!stage || m_conflation) {
+    return;
+  }
+
+  m_conflation = std::move(stage);
+  m_conflationSymbol = m_conflation->addSymbol(m_symbol);
+  m_analyticsConsumer = m_conflation->addConsumer(
+      [this]() { m_analyticsCondition.notify_one(); });
+  m_conflatedAnalytics.store(true, std::memory_order_release);
+
+  if (isRunning()) {
+    startAnalyticsThread();
+  }
+}
+
+void MLEnhancedMarketMaker::startAnalyticsThread() {
+  if (m_analyticsThread.joinable()) {
+    return;
+  }
+  m_analyticsStop.store(false, std::memory_order_release);
+  m_analyticsThread = std::thread(&MLEnhancedMarketMaker::analyticsLoop, this);
+}
+
+void MLEnhancedMarketMaker::stopAnalyticsThread() {
+  if (!m_analyticsThread.joinable()) {
+    return;
+  }
+  m_analyticsStop.store(true, std::memory_order_release);
+  m_analyticsCondition.notify_all();
+  m_analyticsThread.join();
+}
+
+void MLEnhancedMarketMaker::analyticsLoop() {
+  while (!m_analyticsStop.load(std::memory_order_acquire)) {
+    // Everything published since the last pass arrives as one read
+    if (m_conflation->read(m_analyticsConsumer, m_conflationSymbol,
+                           m_conflatedBook)) {
+      runMarketAnalytics(m_conflatedBook);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_analyticsMutex);
+    m_analyticsCondition.wait_for(lock, std::chrono::milliseconds(100), [this] {
+      return m_analyticsStop.load(std::memory_order_acquire) ||
+             m_conflation->isDirty(m_analyticsConsumer, m_conflationSymbol);
+    });
+  }
+}
+
+void MLEnhancedMarketMaker::runMarketAnalytics(
+    const exchange::ConflatedBook& book) {
+  collectMarketData();
+
+  // The feed's own quote is fresher than the book rebuilt from its deltas
+  {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    if (book.top.bidPrice > 0.0 && book.top.askPrice > 0.0) {
+      m_lastSnapshot.bidPrice = book.top.bidPrice;
+      m_lastSnapshot.askPrice = book.top.askPrice;
+      m_lastSnapshot.midPrice = (book.top.bidPrice + book.top.askPrice) / 2.0;
+    }
+    m_lastSnapshot.tradeVolume = book.tradedVolume;
+  }
+
+  if (m_orderBook) {
+    updateRegimeDetector(*m_orderBook);
+  }
+  updateRLMarketState();
+}
+
 void MLEnhancedMarketMaker::onTrade(const std::string& symbol, double price,
                                     double quantity, OrderSide side,
                                     uint64_t timestamp) {
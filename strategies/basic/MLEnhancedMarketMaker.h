@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../core/utils/TimeUtils.h"
+#include "../../exchange/connector/ConflationStage.h"
 #include "../analytics/CrossMarketCorrelation.h"
 #include "../analytics/MarketImpactPredictor.h"
 #include "../analytics/MarketRegimeDetector.h"
@@ -9,8 +10,12 @@
 #include "../rl/RLParameterAdapter.h"
 #include "BasicMarketMaker.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace pinnacle {
 namespace strategy {
@@ -92,7 +97,8 @@ public:
   /**
    * @brief Initialize the enhanced strategy
    */
-  bool initialize(std::shared_ptr<OrderBook> orderBook);
+  bool initialize(std::shared_ptr<OrderBook> orderBook,
+                  const std::string& venue = "simulation");
 
   /**
    * @brief Start the strategy with ML components
@@ -106,9 +112,22 @@ public:
 
   /**
    * @brief Handle order book updates with ML feature extraction
+   *
+   * With a conflation stage set the analytics run on their own thread
+   * instead, and this only wakes the base strategy.
    */
   void onOrderBookUpdate(const OrderBook& orderBook);
 
+  /**
+   * @brief Run market analytics from a conflation stage on a dedicated thread
+   *
+   * The analytics thread reads the stage as its own consumer, so when it
+   * falls behind it skips straight to the latest state instead of working
+   * through a backlog, and the feed and quoting paths never wait for it.
+   * Must be called before the feed starts publishing into the stage.
+   */
+  void setConflationStage(std::shared_ptr<exchange::ConflationStage> stage);
+
   /**
    * @brief Handle trades with ML outcome tracking
    */
@@ -439,6 +458,22 @@ private:
 
   // Cross-market correlation integration methods
   double calculateCrossMarketAdjustment() const;
+
+  // Conflated analytics, see setConflationStage()
+  std::shared_ptr<exchange::ConflationStage> m_conflation;
+  exchange::ConflationStage::ConsumerId m_analyticsConsumer{0};
+  size_t m_conflationSymbol{0};
+  exchange::ConflatedBook m_conflatedBook; // Analytics thread only
+  std::atomic<bool> m_conflatedAnalytics{false};
+  std::atomic<bool> m_analyticsStop{false};
+  std::thread m_analyticsThread;
+  std::mutex m_analyticsMutex;
+  std::condition_variable m_analyticsCondition;
+
+  void startAnalyticsThread();
+  void stopAnalyticsThread();
+  void analyticsLoop();
+  void runMarketAnalytics(const exchange::ConflatedBook& book);
 };
 
 } // namespace strategy
@@ -0,0 +1,147 @@
+#include "../../core/utils/TimeUtils.h"
+#include "../../strategies/arbitrage/ArbitrageDetector.h"
+#include "../../strategies/arbitrage/CycleArbitrageDetector.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::arbitrage;
+
+namespace {
+
+const std::vector<std::string> VENUES = {"coinbase", "kraken", "binance",
+                                         "bitstamp", "gemini"};
+
+// Reference prices in USD
+const std::vector<std::pair<std::string, double>> CURRENCIES = {
+    {"BTC", 50000.0}, {"ETH", 3000.0}, {"SOL", 150.0}, {"XRP", 0.6},
+    {"ADA", 0.45},    {"LTC", 80.0},   {"DOT", 7.0},   {"USDT", 1.0}};
+
+struct SymbolSpec {
+  std::string name;
+  double fairPrice;
+};
+
+/**
+ * @brief Every currency against USD plus every pair among the first few,
+ * roughly the listing of a large venue
+ */
+std::vector<SymbolSpec> makeSymbols(size_t crossCurrencies) {
+  std::vector<SymbolSpec> symbols;
+  for (const auto& [currency, price] : CURRENCIES) {
+    symbols.push_back({currency + "-USD", price});
+  }
+  for (size_t i = 0; i < crossCurrencies && i < CURRENCIES.size(); ++i) {
+    for (size_t j = i + 1; j < CURRENCIES.size(); ++j) {
+      symbols.push_back({CURRENCIES[j].first + "-" + CURRENCIES[i].first,
+                         CURRENCIES[j].second / CURRENCIES[i].second});
+    }
+  }
+  return symbols;
+}
+
+ArbitrageConfig makeConfig(const std::vector<SymbolSpec>& symbols) {
+  ArbitrageConfig cfg;
+  cfg.minSpreadBps = 5.0;
+  cfg.minProfitUsd = 0.0;
+  cfg.maxStalenessNs = 60'000'000'000ULL;
+  cfg.venues = VENUES;
+  for (const auto& symbol : symbols) {
+    cfg.symbols.push_back(symbol.name);
+  }
+  for (const auto& venue : VENUES) {
+    cfg.venueFees[venue] = 0.001;
+  }
+  return cfg;
+}
+
+/**
+ * @brief Quote stream: each update moves one venue's quote for one symbol
+ * by a few basis points around its fair price
+ */
+class QuoteStream {
+public:
+  explicit QuoteStream(std::vector<SymbolSpec> symbols)
+      : m_symbols(std::move(symbols)), m_rng(42),
+        m_symbolPick(0, m_symbols.size() - 1),
+        m_venuePick(0, VENUES.size() - 1), m_noise(0.0, 3e-4) {}
+
+  template <typename Detector> void seed(Detector& detector) {
+    uint64_t now = utils::TimeUtils::getCurrentNanos();
+    for (const auto& venue : VENUES) {
+      for (const auto& symbol : m_symbols) {
+        double mid = symbol.fairPrice;
+        detector.updateVenueQuote(venue, symbol.name, mid * 0.9998, 1.0,
+                                  mid * 1.0002, 1.0, now);
+      }
+    }
+  }
+
+  template <typename Detector> void next(Detector& detector) {
+    const auto& symbol = m_symbols[m_symbolPick(m_rng)];
+    const auto& venue = VENUES[m_venuePick(m_rng)];
+    double mid = symbol.fairPrice * (1.0 + m_noise(m_rng));
+    detector.updateVenueQuote(venue, symbol.name, mid * 0.9998, 1.0,
+                              mid * 1.0002, 1.0,
+                              utils::TimeUtils::getCurrentNanos());
+  }
+
+private:
+  std::vector<SymbolSpec> m_symbols;
+  std::mt19937_64 m_rng;
+  std::uniform_int_distribution<size_t> m_symbolPick;
+  std::uniform_int_distribution<size_t> m_venuePick;
+  std::normal_distribution<double> m_noise;
+};
+
+} // namespace
+
+// Cost of one quote update including the incremental cycle search, for
+// 5 venues and an increasing number of cross pairs. range(1) is the longest
+// cycle searched.
+static void BM_CycleDetectorQuoteUpdate(benchmark::State& state) {
+  auto symbols = makeSymbols(static_cast<size_t>(state.range(0)));
+  CycleArbitrageDetector detector(makeConfig(symbols),
+                                  static_cast<size_t>(state.range(1)));
+  QuoteStream stream(symbols);
+  stream.seed(detector);
+
+  for (auto _ : state) {
+    stream.next(detector);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["symbols"] = static_cast<double>(symbols.size());
+  state.counters["edges"] = static_cast<double>(detector.getEdgeCount());
+  state.counters["cycles_found"] =
+      static_cast<double>(detector.getTotalOpportunitiesDetected());
+}
+BENCHMARK(BM_CycleDetectorQuoteUpdate)
+    ->Args({0, 3})
+    ->Args({2, 3})
+    ->Args({2, 4})
+    ->Args({8, 3})
+    ->Args({8, 4});
+
+// Same stream through the two-venue detector, for comparison
+static void BM_PairDetectorQuoteUpdate(benchmark::State& state) {
+  auto symbols = makeSymbols(static_cast<size_t>(state.range(0)));
+  ArbitrageDetector detector(makeConfig(symbols));
+  detector.start();
+  QuoteStream stream(symbols);
+  stream.seed(detector);
+
+  for (auto _ : state) {
+    stream.next(detector);
+  }
+
+  detector.stop();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PairDetectorQuoteUpdate)->Arg(0)->Arg(8);
+
+BENCHMARK_MAIN();
@@ -1,10 +1,13 @@
 #include "../../core/utils/TimeUtils.h"
+#include "../../exchange/connector/JsonCursor.h"
 #include "../../strategies/backtesting/BacktestEngine.h"
+#include "../../strategies/backtesting/DepthReplayBacktest.h"
 
 #include <benchmark/benchmark.h>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <random>
 
 using namespace pinnacle::backtesting;
 using namespace pinnacle::utils;
@@ -368,4 +371,82 @@ BENCHMARK(BM_MemoryEfficiency)
     ->Range(1000, 50000)
     ->Unit(benchmark::kMicrosecond);
 
+// Benchmark: Depth replay of book deltas and trades, quoting at the top
+namespace {
+
+class TopOfBookQuoter : public DepthReplayStrategy {
+public:
+  void onBatch(DepthReplayBacktest& backtest,
+               std::span<const pinnacle::exchange::SimulatedExecution>
+                   reports) override {
+    benchmark::DoNotOptimize(reports.size());
+    for (const auto& orderId : m_orders) {
+      backtest.cancelOrder(orderId);
+    }
+    m_orders.clear();
+    const auto& book = backtest.getBook();
+    if (book.bestBid() > 0 && book.bestAsk() > 0) {
+      m_orders.push_back(backtest.submitOrder(
+          pinnacle::OrderSide::BUY,
+          pinnacle::exchange::fromFixedPoint(book.bestBid()), 0.1));
+      m_orders.push_back(backtest.submitOrder(
+          pinnacle::OrderSide::SELL,
+          pinnacle::exchange::fromFixedPoint(book.bestAsk()), 0.1));
+    }
+  }
+
+private:
+  std::vector<std::string> m_orders;
+};
+
+} // namespace
+
+static void BM_DepthReplay(benchmark::State& state) {
+  using pinnacle::exchange::EventSide;
+  using pinnacle::exchange::MarketEvent;
+  using pinnacle::exchange::MarketEventType;
+
+  // Deltas over 20 levels a side of a wandering mid, one trade in ten
+  const size_t numEvents = state.range(0);
+  constexpr int64_t TICK = 1'000'000; // 0.01
+  std::vector<MarketEvent> events(numEvents);
+  std::mt19937_64 rng(7);
+  int64_t mid = 10'000 * pinnacle::exchange::FIXED_POINT_SCALE;
+  for (size_t i = 0; i < numEvents; ++i) {
+    MarketEvent& event = events[i];
+    event = MarketEvent{};
+    event.receivedAt = i * 1'000; // 1 per microsecond
+    if (rng() % 1000 == 0) {
+      mid += (rng() % 2 == 0 ? TICK : -TICK);
+    }
+    bool bid = rng() % 2 == 0;
+    event.side = bid ? EventSide::BID : EventSide::ASK;
+    int64_t offset = static_cast<int64_t>(1 + rng() % 20) * TICK;
+    event.price = bid ? mid - offset : mid + offset;
+    if (i % 10 == 0) {
+      event.type = MarketEventType::TRADE;
+      event.price = bid ? mid + TICK : mid - TICK;
+      event.quantity = TICK * 100; // 1.0
+    } else {
+      event.type = MarketEventType::BOOK_DELTA;
+      event.quantity =
+          static_cast<int64_t>(rng() % 8) * (TICK * 100); // 0 to 7
+    }
+  }
+
+  for (auto _ : state) {
+    TopOfBookQuoter strategy;
+    DepthReplayBacktest backtest(strategy);
+    backtest.process(events);
+    backtest.finish();
+    benchmark::DoNotOptimize(backtest.getPnL());
+  }
+
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * numEvents));
+}
+BENCHMARK(BM_DepthReplay)
+    ->Range(100000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,532 @@
+#include "../../core/routing/OrderRouter.h"
+#include "../../core/utils/LatencyHistogram.h"
+#include "../../core/utils/TimeUtils.h"
+#include "../../exchange/mock/MockVenue.h"
+#include "../../exchange/mock/MockVenueClient.h"
+#include "../../strategies/arbitrage/ArbitrageExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::core::routing;
+using namespace pinnacle::exchange::mock;
+using pinnacle::utils::LatencyHistogram;
+using pinnacle::utils::TimeUtils;
+
+// End-to-end benchmarks against mock venues on loopback. Every venue is a
+// MockVenue with its own I/O thread; the router and the arbitrage executor
+// reach them over real WebSocket and FIX sockets, so the numbers include
+// JSON and FIX encoding, the kernel's loopback path and each venue's
+// artificial latency.
+
+namespace {
+
+const std::string SYMBOL = "BTC-USD";
+constexpr double ORDER_QUANTITY = 0.1;
+constexpr uint64_t WAIT_TIMEOUT_NANOS = 2'000'000'000ULL; // 2s
+
+struct VenueSpec {
+  const char* name;
+  int latencyMicros;
+  double midOffset;
+};
+
+// Offsets make the venues' books cross from time to time, as real venues do
+constexpr VenueSpec VENUES[] = {
+    {"MOCK-A", 50, 0.0}, {"MOCK-B", 150, 1.5}, {"MOCK-C", 300, -1.5}};
+constexpr size_t VENUE_COUNT = sizeof(VENUES) / sizeof(VENUES[0]);
+
+struct Quote {
+  double bid{0.0};
+  double ask{0.0};
+};
+
+/**
+ * @brief Orders the benchmark thread waits on, keyed by ClOrdID
+ */
+struct PendingOrder {
+  uint64_t sentAt{0};
+  uint64_t ackAt{0};
+  uint64_t doneAt{0};
+  double cumQty{0.0};
+  double avgPx{0.0};
+  OrderStatus status{OrderStatus::NEW};
+};
+
+/**
+ * @brief Venues, their clients and a router wired to them
+ *
+ * Built on first use and shared by every benchmark.
+ */
+class EndToEndEnvironment {
+public:
+  static EndToEndEnvironment& get() {
+    static EndToEndEnvironment environment;
+    return environment;
+  }
+
+  ~EndToEndEnvironment() {
+    router.stop();
+    for (auto& client : m_clients) {
+      client->disconnect();
+    }
+    for (auto& venue : m_venues) {
+      venue->stop();
+    }
+  }
+
+  bool ready() const { return m_ready; }
+
+  uint64_t tickSequence() const {
+    return m_tickSequence.load(std::memory_order_acquire);
+  }
+
+  uint64_t lastTickAt() const {
+    return m_lastTickAt.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Spin until a tick newer than sequence arrives
+   *
+   * @return Receive time of that tick, or 0 on timeout
+   */
+  uint64_t waitForTick(uint64_t sequence) const {
+    uint64_t deadline = TimeUtils::getCurrentNanos() + WAIT_TIMEOUT_NANOS;
+    while (tickSequence() == sequence) {
+      if (TimeUtils::getCurrentNanos() > deadline) {
+        return 0;
+      }
+    }
+    return lastTickAt();
+  }
+
+  Quote quote(size_t venue) {
+    std::lock_guard<std::mutex> lock(m_quoteMutex);
+    return m_quotes[venue];
+  }
+
+  MockVenueClient& client(size_t venue) { return *m_clients[venue]; }
+
+  size_t venueIndex(const std::string& name) const {
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      if (name == VENUES[i].name) {
+        return i;
+      }
+    }
+    return VENUE_COUNT;
+  }
+
+  /**
+   * @brief Send an order and track it until a terminal report
+   */
+  uint64_t send(size_t venue, const std::string& clOrdId, OrderSide side,
+                double price, double quantity) {
+    {
+      std::lock_guard<std::mutex> lock(m_pendingMutex);
+      m_pending[clOrdId] = PendingOrder{};
+    }
+    uint64_t sentAt = m_clients[venue]->sendNewOrder(
+        clOrdId, SYMBOL, side, OrderType::IOC, price, quantity);
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending[clOrdId].sentAt = sentAt;
+    return sentAt;
+  }
+
+  /**
+   * @brief Spin until an order sent with send() is terminal, then forget it
+   *
+   * @return false on timeout
+   */
+  bool waitForOrder(const std::string& clOrdId, PendingOrder& out) {
+    uint64_t deadline = TimeUtils::getCurrentNanos() + WAIT_TIMEOUT_NANOS;
+    while (TimeUtils::getCurrentNanos() < deadline) {
+      {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pending.find(clOrdId);
+        if (it != m_pending.end() && it->second.doneAt != 0) {
+          out = it->second;
+          m_pending.erase(it);
+          return true;
+        }
+      }
+      std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.erase(clOrdId);
+    return false;
+  }
+
+  /**
+   * @brief Spin until the router has sent more than count children
+   *
+   * @return ClOrdID of the latest child, or empty on timeout
+   */
+  std::string waitForRoutedOrder(uint64_t count) {
+    uint64_t deadline = TimeUtils::getCurrentNanos() + WAIT_TIMEOUT_NANOS;
+    while (routedCount.load(std::memory_order_acquire) == count) {
+      if (TimeUtils::getCurrentNanos() > deadline) {
+        return {};
+      }
+    }
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return m_lastRouted;
+  }
+
+  OrderRouter router;
+  std::atomic<uint64_t> routedCount{0};
+  std::atomic<uint64_t> routerCompletions{0};
+
+private:
+  EndToEndEnvironment() {
+    spdlog::set_level(spdlog::level::warn);
+
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      MockVenueConfig config;
+      config.name = VENUES[i].name;
+      config.symbols = {SYMBOL};
+      config.initialMid = 50000.0 + VENUES[i].midOffset;
+      config.tickInterval = std::chrono::microseconds(1000);
+      config.latency = std::chrono::microseconds(VENUES[i].latencyMicros);
+      config.jitter = std::chrono::microseconds(20);
+      config.rejectRate = 0.01;
+      config.partialFillRate = 0.1;
+      config.seed = 42 + i;
+
+      auto venue = std::make_unique<MockVenue>(config);
+      if (!venue->start()) {
+        return;
+      }
+      m_venues.push_back(std::move(venue));
+      router.addVenue(config.name, "fix");
+    }
+
+    router.setExecutionCallback([this](const ExecutionResult&) {
+      routerCompletions.fetch_add(1, std::memory_order_release);
+    });
+
+    // Router children go out as "R<handle>" so reports map straight back
+    router.setOrderSender([this](const ExecutionRequest& request) {
+      size_t venue = venueIndex(request.targetVenue);
+      if (venue == VENUE_COUNT) {
+        return false;
+      }
+      std::string clOrdId = "R" + std::to_string(request.orderHandle);
+      bool sent = send(venue, clOrdId, request.order.getSide(),
+                       request.order.getPrice(),
+                       request.order.getQuantity()) != 0;
+      {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_lastRouted = std::move(clOrdId);
+      }
+      routedCount.fetch_add(1, std::memory_order_release);
+      return sent;
+    });
+
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      auto client = std::make_unique<MockVenueClient>(VENUES[i].name);
+      std::string name = VENUES[i].name;
+
+      client->setTickCallback([this, i, name](const MockVenueTick& tick) {
+        MarketData data;
+        data.venue = name;
+        data.bidPrice = tick.bidPrice;
+        data.askPrice = tick.askPrice;
+        data.bidSize = tick.bidSize;
+        data.askSize = tick.askSize;
+        data.timestamp = tick.exchangeTimestamp;
+        data.cumulativeVolume = tick.volume;
+        router.updateMarketData(name, tick.symbol, data);
+
+        {
+          std::lock_guard<std::mutex> lock(m_quoteMutex);
+          m_quotes[i] = {tick.bidPrice, tick.askPrice};
+        }
+        m_lastTickAt.store(tick.receivedAt, std::memory_order_relaxed);
+        m_tickSequence.fetch_add(1, std::memory_order_release);
+      });
+
+      client->setDepthCallback([this, name](const MockVenueDepth& depth) {
+        router.updateMarketDepth(name, depth.symbol, depth.bidPrices,
+                                 depth.bidSizes, depth.askPrices,
+                                 depth.askSizes);
+      });
+
+      client->setExecutionReportCallback(
+          [this](const MockExecutionReport& report) {
+            onReport(report);
+          });
+
+      const MockVenueConfig& config = m_venues[i]->config();
+      if (!client->connectMarketData(config.host, m_venues[i]->wsPort(),
+                                     {SYMBOL}) ||
+          !client->connectOrderEntry(config.host, m_venues[i]->fixPort())) {
+        return;
+      }
+      m_clients.push_back(std::move(client));
+    }
+
+    router.start();
+
+    // Let every venue publish before the first measurement
+    while (tickSequence() < VENUE_COUNT * 10) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    m_ready = true;
+  }
+
+  void onReport(const MockExecutionReport& report) {
+    bool terminal = report.status == OrderStatus::FILLED ||
+                    report.status == OrderStatus::CANCELED ||
+                    report.status == OrderStatus::REJECTED ||
+                    report.status == OrderStatus::EXPIRED;
+
+    if (report.clOrdId.size() > 1 && report.clOrdId[0] == 'R') {
+      router.onExecutionReport(std::stoull(report.clOrdId.substr(1)),
+                               report.status, report.cumQty, report.avgPx,
+                               report.receivedAt);
+    }
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    auto it = m_pending.find(report.clOrdId);
+    if (it == m_pending.end()) {
+      return;
+    }
+    PendingOrder& pending = it->second;
+    if (pending.ackAt == 0) {
+      pending.ackAt = report.receivedAt;
+    }
+    pending.cumQty = report.cumQty;
+    pending.avgPx = report.avgPx;
+    pending.status = report.status;
+    if (terminal) {
+      pending.doneAt = report.receivedAt;
+    }
+  }
+
+  std::vector<std::unique_ptr<MockVenue>> m_venues;
+  std::vector<std::unique_ptr<MockVenueClient>> m_clients;
+  bool m_ready{false};
+
+  std::atomic<uint64_t> m_tickSequence{0};
+  std::atomic<uint64_t> m_lastTickAt{0};
+  std::mutex m_quoteMutex;
+  Quote m_quotes[VENUE_COUNT];
+
+  std::mutex m_pendingMutex;
+  std::unordered_map<std::string, PendingOrder> m_pending;
+  std::string m_lastRouted;
+};
+
+void reportPercentiles(benchmark::State& state, const char* name,
+                       const LatencyHistogram& histogram) {
+  std::string prefix(name);
+  state.counters[prefix + "_p50_us"] = histogram.percentile(0.5) / 1000.0;
+  state.counters[prefix + "_p99_us"] = histogram.percentile(0.99) / 1000.0;
+}
+
+} // namespace
+
+// =============================================================================
+// OrderRouter against mock venues
+// =============================================================================
+
+// Per iteration: wait for the next tick from any venue, route a marketable
+// IOC through BEST_PRICE and wait until the router completes it.
+//   tick_to_trade: tick received -> child order written to the venue socket
+//   routing:       submitOrder -> child written (the router's pipeline)
+//   venue_rtt:     child written -> first execution report received
+// Iteration time is tick received -> router completion.
+static void BM_EndToEnd_RouterTickToTrade(benchmark::State& state) {
+  auto& env = EndToEndEnvironment::get();
+  if (!env.ready()) {
+    state.SkipWithError("Mock venues failed to start");
+    return;
+  }
+  env.router.setRoutingStrategy("BEST_PRICE");
+
+  LatencyHistogram tickToTrade, routing, venueRtt;
+  uint64_t orderId = 0;
+
+  for (auto _ : state) {
+    uint64_t tickAt = env.waitForTick(env.tickSequence());
+    if (tickAt == 0) {
+      state.SkipWithError("No market data");
+      return;
+    }
+
+    double bestAsk = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      double ask = env.quote(i).ask;
+      if (ask > 0.0) {
+        bestAsk = std::min(bestAsk, ask);
+      }
+    }
+
+    ExecutionRequest request;
+    request.order = Order("E2E_" + std::to_string(++orderId), SYMBOL,
+                          OrderSide::BUY, OrderType::IOC, bestAsk + 5.0,
+                          ORDER_QUANTITY, TimeUtils::getCurrentNanos());
+    request.routingStrategy = "BEST_PRICE";
+
+    uint64_t routed = env.routedCount.load(std::memory_order_acquire);
+    uint64_t completions =
+        env.routerCompletions.load(std::memory_order_acquire);
+    uint64_t submitAt = TimeUtils::getCurrentNanos();
+    if (env.router.submitOrder(request).empty()) {
+      state.SkipWithError("Router rejected the request");
+      return;
+    }
+
+    PendingOrder child;
+    std::string clOrdId = env.waitForRoutedOrder(routed);
+    if (clOrdId.empty() || !env.waitForOrder(clOrdId, child)) {
+      state.SkipWithError("Timed out waiting for the venue");
+      return;
+    }
+    uint64_t deadline = submitAt + WAIT_TIMEOUT_NANOS;
+    while (env.routerCompletions.load(std::memory_order_acquire) ==
+           completions) {
+      if (TimeUtils::getCurrentNanos() > deadline) {
+        state.SkipWithError("Timed out waiting for the router");
+        return;
+      }
+    }
+    uint64_t doneAt = TimeUtils::getCurrentNanos();
+
+    state.SetIterationTime((doneAt - tickAt) / 1e9);
+    tickToTrade.record(child.sentAt - tickAt);
+    routing.record(child.sentAt - submitAt);
+    venueRtt.record(child.ackAt - child.sentAt);
+  }
+
+  reportPercentiles(state, "tick_to_trade", tickToTrade);
+  reportPercentiles(state, "routing", routing);
+  reportPercentiles(state, "venue_rtt", venueRtt);
+}
+BENCHMARK(BM_EndToEnd_RouterTickToTrade)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond)
+    ->Iterations(2000);
+
+// =============================================================================
+// ArbitrageExecutor against mock venues
+// =============================================================================
+
+// Per iteration: wait for the next tick, buy on the venue with the lowest
+// ask and sell on the one with the highest bid through a live executor. The
+// executor fires both legs at once as marketable IOCs, and each submit
+// callback blocks until its venue reports the order terminal. Partial fills
+// and rejects exercise the executor's hedge and unwind path.
+//   tick_to_trade: tick received -> first leg written to a venue socket
+//   leg_rtt:       leg written -> terminal report received
+//   leg_skew:      gap between the two legs' submissions
+// Iteration time is the executor's own execution time.
+static void BM_EndToEnd_ArbitrageExecutor(benchmark::State& state) {
+  auto& env = EndToEndEnvironment::get();
+  if (!env.ready()) {
+    state.SkipWithError("Mock venues failed to start");
+    return;
+  }
+
+  // Random rejects can leave residuals; keep measuring instead of halting
+  arbitrage::LegRiskConfig legRisk;
+  legRisk.maxOpenExposure = std::numeric_limits<double>::max();
+  arbitrage::ArbitrageExecutor executor(false, legRisk);
+  LatencyHistogram tickToTrade, legRtt;
+  std::atomic<uint64_t> legId{0};
+  uint64_t bothFilled = 0;
+
+  executor.setLegSubmitCallback([&](const std::string& venue,
+                                    const std::string&, OrderSide side,
+                                    double price, double quantity) {
+    std::string clOrdId = "A" + std::to_string(++legId);
+    if (env.send(env.venueIndex(venue), clOrdId, side, price, quantity) ==
+        0) {
+      return arbitrage::LegFill{};
+    }
+
+    PendingOrder leg;
+    if (!env.waitForOrder(clOrdId, leg)) {
+      return arbitrage::LegFill{};
+    }
+    legRtt.record(leg.doneAt - leg.sentAt);
+    return arbitrage::LegFill{leg.cumQty, leg.avgPx};
+  });
+
+  for (auto _ : state) {
+    uint64_t tickAt = env.waitForTick(env.tickSequence());
+    if (tickAt == 0) {
+      state.SkipWithError("No market data");
+      return;
+    }
+
+    size_t buyVenue = 0, sellVenue = 1;
+    Quote quotes[VENUE_COUNT];
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      quotes[i] = env.quote(i);
+    }
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      if (quotes[i].ask < quotes[buyVenue].ask) {
+        buyVenue = i;
+      }
+    }
+    sellVenue = buyVenue == 0 ? 1 : 0;
+    for (size_t i = 0; i < VENUE_COUNT; ++i) {
+      if (i != buyVenue && quotes[i].bid > quotes[sellVenue].bid) {
+        sellVenue = i;
+      }
+    }
+
+    arbitrage::ArbitrageOpportunity opportunity;
+    opportunity.symbol = SYMBOL;
+    opportunity.buyVenue = VENUES[buyVenue].name;
+    opportunity.sellVenue = VENUES[sellVenue].name;
+    opportunity.buyPrice = quotes[buyVenue].ask;
+    opportunity.sellPrice = quotes[sellVenue].bid;
+    opportunity.spread = opportunity.sellPrice - opportunity.buyPrice;
+    opportunity.maxQuantity = ORDER_QUANTITY;
+    opportunity.estimatedProfit = opportunity.spread * ORDER_QUANTITY;
+    opportunity.detectedAt = tickAt;
+
+    auto result = executor.execute(opportunity);
+    state.SetIterationTime(result.executionTimeNs / 1e9);
+    uint64_t firstLegAt =
+        std::min(result.buyLeg.submittedAt, result.sellLeg.submittedAt);
+    if (firstLegAt > tickAt) {
+      tickToTrade.record(firstLegAt - tickAt);
+    }
+    if (result.buyFilled && result.sellFilled) {
+      ++bothFilled;
+    }
+  }
+
+  reportPercentiles(state, "tick_to_trade", tickToTrade);
+  reportPercentiles(state, "leg_rtt", legRtt);
+  reportPercentiles(state, "leg_skew", executor.getLegSkewHistogram());
+  state.counters["both_legs_filled"] = benchmark::Counter(
+      static_cast<double>(bothFilled), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_EndToEnd_ArbitrageExecutor)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond)
+    ->Iterations(1000);
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
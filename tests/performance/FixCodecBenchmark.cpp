@@ -0,0 +1,153 @@
+#include "../../exchange/fix/FixStreamReader.h"
+#include "../../exchange/fix/FixTemplate.h"
+#include "../../exchange/fix/FixWire.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace pinnacle::exchange::fix;
+
+// Encode and decode cost of FIX messages, one message per iteration, so the
+// reported time is nanoseconds per message. Encoding patches a preallocated
+// template and is compared with serializing the same message field by field
+// through FixMessageBuilder. Decoding frames execution reports out of a
+// receive buffer fed in socket-sized reads and indexes their fields.
+
+namespace {
+
+constexpr uint64_t NOW = 1'760'000'000'000'000'000ULL;
+const FixHeaderFields HEADER{"FIX.4.4", "PINNACLEMM", "VENUE"};
+
+double priceFor(uint64_t i) { return 50000.0 + static_cast<double>(i % 997); }
+
+double quantityFor(uint64_t i) { return 0.001 * static_cast<double>(i % 500); }
+
+std::string executionReports(size_t count) {
+  FixMessageBuilder builder;
+  std::string stream;
+  for (size_t i = 1; i <= count; ++i) {
+    builder.begin("8", "VENUE", "PINNACLEMM", i, NOW + i * 1000)
+        .field(tag::OrderID, std::string_view("V-1234567"))
+        .field(tag::ClOrdID, static_cast<int64_t>(1'000'000 + i))
+        .field(tag::ExecID, static_cast<int64_t>(i))
+        .field(tag::ExecType, 'F')
+        .field(tag::OrdStatus, i % 4 == 0 ? '2' : '1')
+        .field(tag::Symbol, std::string_view("BTC-USD"))
+        .field(tag::Side, '1')
+        .field(tag::OrderQty, 1.0)
+        .field(tag::Price, priceFor(i))
+        .field(tag::LastQty, 0.25)
+        .field(tag::LastPx, priceFor(i))
+        .field(tag::LeavesQty, 0.75)
+        .field(tag::CumQty, 0.25)
+        .field(tag::AvgPx, priceFor(i))
+        .timestampField(tag::TransactTime, NOW + i * 1000);
+    stream += builder.finish();
+  }
+  return stream;
+}
+
+} // namespace
+
+static void BM_EncodeNewOrderSingleTemplate(benchmark::State& state) {
+  NewOrderSingleTemplate order(HEADER, "BTC-USD", '1', '2', '1');
+  uint64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    benchmark::DoNotOptimize(
+        order.encode(i, NOW + i * 1000, i, priceFor(i), quantityFor(i)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeNewOrderSingleTemplate);
+
+static void BM_EncodeNewOrderSingleBuilder(benchmark::State& state) {
+  FixMessageBuilder builder;
+  uint64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    builder.begin("D", HEADER.senderCompId, HEADER.targetCompId, i,
+                  NOW + i * 1000)
+        .field(tag::ClOrdID, static_cast<int64_t>(i))
+        .field(tag::Symbol, std::string_view("BTC-USD"))
+        .field(tag::Side, '1')
+        .timestampField(tag::TransactTime, NOW + i * 1000)
+        .field(tag::OrderQty, quantityFor(i))
+        .field(tag::OrdType, '2')
+        .field(tag::Price, priceFor(i))
+        .field(tag::TimeInForce, '1');
+    benchmark::DoNotOptimize(builder.finish());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeNewOrderSingleBuilder);
+
+static void BM_EncodeCancelTemplate(benchmark::State& state) {
+  OrderCancelTemplate cancel(HEADER, "BTC-USD", '1');
+  uint64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    benchmark::DoNotOptimize(
+        cancel.encode(i, NOW + i * 1000, i + 1, i, quantityFor(i)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeCancelTemplate);
+
+static void BM_EncodeCancelBuilder(benchmark::State& state) {
+  FixMessageBuilder builder;
+  uint64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    builder.begin("F", HEADER.senderCompId, HEADER.targetCompId, i,
+                  NOW + i * 1000)
+        .field(tag::OrigClOrdID, static_cast<int64_t>(i))
+        .field(tag::ClOrdID, static_cast<int64_t>(i + 1))
+        .field(tag::Symbol, std::string_view("BTC-USD"))
+        .field(tag::Side, '1')
+        .timestampField(tag::TransactTime, NOW + i * 1000)
+        .field(tag::OrderQty, quantityFor(i));
+    benchmark::DoNotOptimize(builder.finish());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeCancelBuilder);
+
+// Arg: bytes per simulated socket read
+static void BM_DecodeExecutionReport(benchmark::State& state) {
+  const std::string stream = executionReports(4096);
+  const size_t readSize = static_cast<size_t>(state.range(0));
+  FixStreamReader reader;
+  FixMessageView view;
+  size_t offset = 0;
+  double filled = 0.0;
+
+  for (auto _ : state) {
+    std::string_view message;
+    while (!reader.next(message)) {
+      if (offset == stream.size()) {
+        offset = 0;
+      }
+      std::span<char> space = reader.writable();
+      size_t bytes = std::min({readSize, space.size(), stream.size() - offset});
+      std::memcpy(space.data(), stream.data() + offset, bytes);
+      reader.commit(bytes);
+      offset += bytes;
+    }
+    if (view.parse(message) && view.msgType() == "8") {
+      filled += view.getDouble(tag::LastQty);
+      benchmark::DoNotOptimize(view.get(tag::ClOrdID));
+      benchmark::DoNotOptimize(view.getChar(tag::OrdStatus));
+    }
+  }
+  benchmark::DoNotOptimize(filled);
+  state.SetItemsProcessed(state.iterations());
+  state.counters["bytes_skipped"] =
+      static_cast<double>(reader.getBytesSkipped());
+}
+BENCHMARK(BM_DecodeExecutionReport)->Arg(256)->Arg(4096)->Arg(65536);
+
+BENCHMARK_MAIN();
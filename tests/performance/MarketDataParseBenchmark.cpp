@@ -0,0 +1,419 @@
+#include "../../core/utils/LockFreeQueue.h"
+#include "../../core/utils/SlabRing.h"
+#include "../../exchange/capture/CaptureRecorder.h"
+#include "../../exchange/capture/ReplayMarketDataFeed.h"
+#include "../../exchange/connector/CoinbaseMessageScanner.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle::exchange;
+
+// Parse throughput for Coinbase market data frames: the on-demand scanner
+// against a full nlohmann::json DOM parse extracting the same fields.
+// Frames come from a capture file when --frames=<path> is given (one JSON
+// frame per line, as written by websocat or wscat), otherwise from a
+// generated session shaped like Advanced Trade traffic: tickers, small
+// level2 updates, periodic snapshots and heartbeats. The handoff benchmarks
+// add a reader thread passing frames to the parsing thread; the capture
+// benchmarks record frames to disk and replay them back.
+
+namespace {
+
+std::vector<std::string> g_capturedFrames;
+
+enum Corpus { MIXED = 0, TICKER = 1, LEVEL2 = 2 };
+
+std::string price(double value, int decimals) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  return buffer;
+}
+
+class FrameGenerator {
+public:
+  FrameGenerator() : m_rng(7) {}
+
+  std::string ticker(const std::string& symbol, double mid) {
+    return header("ticker") +
+           R"({"type":"update","tickers":[{"type":"ticker","product_id":")" +
+           symbol + R"(","price":")" + price(mid, 2) +
+           R"(","volume_24_h":"4554.12345678","low_24_h":")" +
+           price(mid * 0.98, 2) + R"(","high_24_h":")" +
+           price(mid * 1.02, 2) +
+           R"(","low_52_w":"15460","high_52_w":"110000",)"
+           R"("price_percent_chg_24_h":"-1.23456789","best_bid":")" +
+           price(mid - 0.01, 2) + R"(","best_bid_quantity":")" +
+           price(size(), 8) + R"(","best_ask":")" + price(mid + 0.01, 2) +
+           R"(","best_ask_quantity":")" + price(size(), 8) + R"("}]}]})";
+  }
+
+  std::string level2(const std::string& symbol, double mid, int levels,
+                      bool snapshot) {
+    std::string frame = header("l2_data") + R"({"type":")" +
+                        (snapshot ? "snapshot" : "update") +
+                        R"(","product_id":")" + symbol + R"(","updates":[)";
+    for (int i = 0; i < levels; ++i) {
+      bool bid = i % 2 == 0;
+      double level = bid ? mid - 0.01 * (i / 2 + 1) : mid + 0.01 * (i / 2 + 1);
+      if (i > 0) {
+        frame += ',';
+      }
+      frame += R"({"side":")" + std::string(bid ? "bid" : "offer") +
+               R"(","event_time":")" + timestamp() +
+               R"(","price_level":")" + price(level, 2) +
+               R"(","new_quantity":")" +
+               (m_uniform(m_rng) < 0.2 ? std::string("0") : price(size(), 8)) +
+               R"("})";
+    }
+    return frame + "]}]}";
+  }
+
+  std::string heartbeat() {
+    return header("heartbeats") +
+           R"({"current_time":"2025-09-01 20:17:57.483 +0000 UTC",)"
+           R"("heartbeat_counter":)" +
+           std::to_string(m_seq) + "}]}";
+  }
+
+  std::vector<std::string> session(Corpus corpus, size_t count) {
+    const std::pair<const char*, double> symbols[] = {
+        {"BTC-USD", 109231.23}, {"ETH-USD", 3000.12}, {"SOL-USD", 150.45}};
+    std::vector<std::string> frames;
+    frames.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      const auto& [symbol, mid] = symbols[i % 3];
+      double drift = mid * (1.0 + 1e-4 * m_normal(m_rng));
+      double roll = m_uniform(m_rng);
+      if (corpus == TICKER || (corpus == MIXED && roll < 0.35)) {
+        frames.push_back(ticker(symbol, drift));
+      } else if (corpus == MIXED && roll > 0.99) {
+        frames.push_back(heartbeat());
+      } else if (roll > 0.985) {
+        frames.push_back(level2(symbol, drift, 100, true));
+      } else {
+        frames.push_back(level2(symbol, drift, 1 + static_cast<int>(roll * 8),
+                                false));
+      }
+    }
+    return frames;
+  }
+
+private:
+  std::mt19937_64 m_rng;
+  std::uniform_real_distribution<double> m_uniform{0.0, 1.0};
+  std::normal_distribution<double> m_normal{0.0, 1.0};
+  uint64_t m_seq{1};
+
+  double size() { return 0.001 + m_uniform(m_rng) * 2.5; }
+
+  std::string header(const char* channel) {
+    ++m_seq;
+    return R"({"channel":")" + std::string(channel) +
+           R"(","client_id":"","timestamp":")" + timestamp() +
+           R"(","sequence_num":)" + std::to_string(m_seq) + R"(,"events":[)";
+  }
+
+  std::string timestamp() {
+    return "2025-09-01T20:17:57." + std::to_string(100000 + m_seq % 900000) +
+           "Z";
+  }
+};
+
+const std::vector<std::string>& corpus(Corpus kind) {
+  static std::vector<std::string> generated[3];
+  if (!g_capturedFrames.empty()) {
+    return g_capturedFrames;
+  }
+  if (generated[kind].empty()) {
+    generated[kind] = FrameGenerator().session(kind, 10'000);
+  }
+  return generated[kind];
+}
+
+size_t totalBytes(const std::vector<std::string>& frames) {
+  size_t bytes = 0;
+  for (const auto& frame : frames) {
+    bytes += frame.size();
+  }
+  return bytes;
+}
+
+class ChecksumHandler : public CoinbaseScanHandler {
+public:
+  int64_t checksum{0};
+
+  void onTicker(const FixedPointTicker& ticker) override {
+    checksum += ticker.price + ticker.bidPrice + ticker.askPrice;
+  }
+
+  void onBookDelta(const BookDelta& delta) override {
+    checksum += delta.price + delta.quantity;
+  }
+};
+
+double number(const nlohmann::json& object, const char* key) {
+  auto it = object.find(key);
+  return it != object.end() && it->is_string()
+             ? std::stod(it->get<std::string>())
+             : 0.0;
+}
+
+} // namespace
+
+// On-demand scan into fixed-point records
+static void BM_ParseScanner(benchmark::State& state) {
+  const auto& frames = corpus(static_cast<Corpus>(state.range(0)));
+  CoinbaseMessageScanner scanner;
+  ChecksumHandler handler;
+
+  for (auto _ : state) {
+    for (const auto& frame : frames) {
+      benchmark::DoNotOptimize(scanner.scan(frame, handler));
+    }
+  }
+
+  benchmark::DoNotOptimize(handler.checksum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  state.counters["malformed"] =
+      static_cast<double>(scanner.getMalformedMessages());
+}
+BENCHMARK(BM_ParseScanner)->Arg(MIXED)->Arg(TICKER)->Arg(LEVEL2);
+
+// DOM parse of the same frames, extracting the same fields with std::stod
+static void BM_ParseNlohmannDom(benchmark::State& state) {
+  const auto& frames = corpus(static_cast<Corpus>(state.range(0)));
+  double checksum = 0.0;
+
+  for (auto _ : state) {
+    for (const auto& frame : frames) {
+      auto message = nlohmann::json::parse(frame, nullptr, false);
+      if (message.is_discarded() || !message.contains("events")) {
+        continue;
+      }
+      std::string channel = message.value("channel", "");
+      for (const auto& event : message["events"]) {
+        if (channel == "ticker" && event.contains("tickers")) {
+          for (const auto& ticker : event["tickers"]) {
+            checksum += number(ticker, "price") + number(ticker, "best_bid") +
+                        number(ticker, "best_ask");
+          }
+        } else if (channel == "l2_data" && event.contains("updates")) {
+          for (const auto& update : event["updates"]) {
+            checksum += number(update, "price_level") +
+                        number(update, "new_quantity");
+          }
+        }
+      }
+    }
+  }
+
+  benchmark::DoNotOptimize(checksum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+}
+BENCHMARK(BM_ParseNlohmannDom)->Arg(MIXED)->Arg(TICKER)->Arg(LEVEL2);
+
+// Reader thread copies each frame into a recycled slab, as the WebSocket
+// read does, and the benchmark thread scans and releases it
+static void BM_SlabRingHandoff(benchmark::State& state) {
+  const auto& frames = corpus(MIXED);
+  using Ring = pinnacle::utils::SlabRing<boost::beast::flat_buffer>;
+  Ring ring(256);
+  for (uint32_t i = 0; i < ring.slabCount(); ++i) {
+    ring.slab(i).reserve(16 * 1024);
+  }
+  CoinbaseMessageScanner scanner;
+  ChecksumHandler handler;
+  auto never = []() { return false; };
+
+  for (auto _ : state) {
+    std::thread reader([&]() {
+      for (const auto& frame : frames) {
+        uint32_t slab = ring.acquire(never);
+        auto& buffer = ring.slab(slab);
+        buffer.clear();
+        std::memcpy(buffer.prepare(frame.size()).data(), frame.data(),
+                    frame.size());
+        buffer.commit(frame.size());
+        ring.publish(slab);
+      }
+    });
+    for (size_t i = 0; i < frames.size(); ++i) {
+      uint32_t slab = ring.consume(never);
+      auto data = ring.slab(slab).data();
+      scanner.scan(std::string_view(static_cast<const char*>(data.data()),
+                                    data.size()),
+                   handler);
+      ring.release(slab);
+    }
+    reader.join();
+  }
+
+  benchmark::DoNotOptimize(handler.checksum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  state.counters["stalls"] = static_cast<double>(ring.getBackpressureStalls());
+}
+BENCHMARK(BM_SlabRingHandoff)->UseRealTime();
+
+// Previous handoff: a std::string per frame through an MPMC queue
+static void BM_StringQueueHandoff(benchmark::State& state) {
+  const auto& frames = corpus(MIXED);
+  auto queue =
+      std::make_unique<pinnacle::utils::LockFreeMPMCQueue<std::string, 1024>>();
+  CoinbaseMessageScanner scanner;
+  ChecksumHandler handler;
+
+  for (auto _ : state) {
+    std::thread reader([&]() {
+      for (const auto& frame : frames) {
+        std::string message(frame);
+        while (!queue->tryEnqueue(std::move(message))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    std::string message;
+    for (size_t i = 0; i < frames.size();) {
+      if (!queue->tryDequeue(message)) {
+        std::this_thread::yield();
+        continue;
+      }
+      scanner.scan(message, handler);
+      ++i;
+    }
+    reader.join();
+  }
+
+  benchmark::DoNotOptimize(handler.checksum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+}
+BENCHMARK(BM_StringQueueHandoff)->UseRealTime();
+
+// Record a session and drain it to disk, at zlib level state.range(0)
+static void BM_CaptureRecord(benchmark::State& state) {
+  namespace capture = pinnacle::exchange::capture;
+  const auto& frames = corpus(MIXED);
+  auto dir = std::filesystem::temp_directory_path() / "pinnaclemm_capture_bm";
+  std::filesystem::remove_all(dir);
+
+  capture::CaptureConfig config;
+  config.directory = dir.string();
+  config.compressionLevel = static_cast<int>(state.range(0));
+  uint64_t dropped = 0;
+  uint64_t written = 0;
+
+  for (auto _ : state) {
+    capture::CaptureRecorder recorder(config);
+    recorder.start();
+    uint64_t timestamp = 0;
+    for (const auto& frame : frames) {
+      recorder.record(frame, timestamp += 1000);
+    }
+    recorder.stop();
+    dropped += recorder.getFramesDropped();
+    written += recorder.getBytesWritten();
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  state.counters["dropped"] = static_cast<double>(dropped);
+  state.counters["ratio"] =
+      static_cast<double>(written) /
+      static_cast<double>(state.iterations() * totalBytes(frames));
+  std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_CaptureRecord)->Arg(0)->Arg(1)->UseRealTime();
+
+// Replay of a recorded session at maximum speed, decoded into updates
+static void BM_CaptureReplay(benchmark::State& state) {
+  namespace capture = pinnacle::exchange::capture;
+  const auto& frames = corpus(MIXED);
+  auto dir = std::filesystem::temp_directory_path() / "pinnaclemm_replay_bm";
+  std::filesystem::remove_all(dir);
+
+  capture::CaptureConfig config;
+  config.directory = dir.string();
+  config.chunkBuffers = 64;
+  capture::CaptureRecorder recorder(config);
+  recorder.start();
+  uint64_t timestamp = 0;
+  for (const auto& frame : frames) {
+    recorder.record(frame, timestamp += 1000);
+  }
+  recorder.stop();
+
+  capture::ReplayMarketDataFeed feed(recorder.getFilesWritten(),
+                                     capture::ReplayMarketDataFeed::MAX_SPEED);
+  double checksum = 0.0;
+  feed.subscribeToMarketUpdates(
+      "BTC-USD", [&](const MarketUpdate& update) { checksum += update.price; });
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(feed.replayAll());
+  }
+
+  benchmark::DoNotOptimize(checksum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_CaptureReplay);
+
+int main(int argc, char** argv) {
+  // Strip --frames=<path> before benchmark sees it
+  const std::string_view flag = "--frames=";
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg.substr(0, flag.size()) != flag) {
+      argv[kept++] = argv[i];
+      continue;
+    }
+    std::ifstream file(std::string(arg.substr(flag.size())));
+    if (!file) {
+      std::cerr << "Cannot open " << arg.substr(flag.size()) << std::endl;
+      return 1;
+    }
+    for (std::string line; std::getline(file, line);) {
+      if (!line.empty()) {
+        g_capturedFrames.push_back(std::move(line));
+      }
+    }
+    std::cout << "Loaded " << g_capturedFrames.size() << " frames"
+              << std::endl;
+  }
+  argc = kept;
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "../../core/orderbook/OrderBook.h"
+#include "../../exchange/simulator/OrderFlowGenerator.h"
+#include "../../exchange/simulator/OrderFlowSinks.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::exchange;
+
+// Cost of synthetic order flow per event, for the generator alone and with
+// each consumer, so a stress test can tell how fast it can be fed. Events
+// are generated in batches of 4096.
+
+namespace {
+
+constexpr size_t BATCH = 4096;
+
+OrderFlowConfig configFor(int64_t symbols) {
+  OrderFlowConfig config;
+  config.symbols.clear();
+  for (int64_t i = 0; i < symbols; ++i) {
+    config.symbols.push_back(
+        {"SYM" + std::to_string(i) + "-USD", 1000.0 + 100.0 * i, 0.01, 0.01});
+  }
+  return config;
+}
+
+} // namespace
+
+// Arg: symbols
+static void BM_GenerateOrderFlow(benchmark::State& state) {
+  OrderFlowGenerator generator(configFor(state.range(0)));
+  std::vector<OrderFlowEvent> events;
+  generator.generate(BATCH, events);
+
+  for (auto _ : state) {
+    generator.generate(BATCH, events);
+    benchmark::DoNotOptimize(events.data());
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH);
+  state.counters["market_seconds"] =
+      static_cast<double>(generator.getTime()) / 1e9;
+}
+BENCHMARK(BM_GenerateOrderFlow)->Arg(1)->Arg(8);
+
+static void BM_GenerateMarketEvents(benchmark::State& state) {
+  OrderFlowConfig config = configFor(4);
+  OrderFlowGenerator generator(config);
+  SymbolTable symbols;
+  MarketEventBuffer out(symbols);
+  std::vector<OrderFlowEvent> events;
+
+  for (auto _ : state) {
+    generator.generate(BATCH, events);
+    out.reset(Venue::COINBASE, generator.getTime());
+    appendMarketEvents(config, events, out);
+    benchmark::DoNotOptimize(out.events().data());
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_GenerateMarketEvents);
+
+static void BM_GenerateIntoOrderBook(benchmark::State& state) {
+  OrderFlowConfig config = configFor(1);
+  OrderFlowGenerator generator(config);
+  auto book = std::make_shared<OrderBook>(config.symbols[0].symbol, false);
+  OrderFlowBookWriter writer(config, {book});
+  std::vector<OrderFlowEvent> events;
+
+  size_t rejected = 0;
+  for (auto _ : state) {
+    generator.generate(BATCH, events);
+    rejected += writer.apply(events);
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH);
+  state.counters["rejected"] = static_cast<double>(rejected);
+}
+BENCHMARK(BM_GenerateIntoOrderBook);
+
+BENCHMARK_MAIN();
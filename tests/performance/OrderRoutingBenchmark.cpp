@@ -1,6 +1,8 @@
+#include "../../core/routing/DepthSplitter.h"
 #include "../../core/routing/OrderRouter.h"
 #include "../../core/utils/TimeUtils.h"
 
+#include <atomic>
 #include <benchmark/benchmark.h>
 #include <memory>
 #include <random>
@@ -87,6 +89,114 @@ static void BM_MarketImpactStrategy_Planning(benchmark::State& state) {
   }
 }
 
+static void BM_BestPriceStrategy_QuoteTablePlanning(benchmark::State& state) {
+  // Read path used by the router: seqlock snapshot of every venue, then a
+  // vectorized ranking over the contiguous price columns
+  BestPriceStrategy strategy;
+  VenueQuoteTable table;
+  auto marketData = createTestMarketData();
+  size_t numVenues = static_cast<size_t>(state.range(0));
+  std::vector<std::string> names;
+  for (size_t i = 0; i < numVenues; ++i) {
+    auto data = marketData[i % marketData.size()];
+    data.askPrice += static_cast<double>(i);
+    names.push_back(data.venue + "_" + std::to_string(i));
+    table.publish(i, data, utils::TimeUtils::getCurrentNanos());
+  }
+  auto request = createTestExecutionRequest("BEST_PRICE", 1.0);
+
+  VenueQuoteSnapshot snapshot;
+  for (auto _ : state) {
+    snapshot.clear();
+    for (size_t i = 0; i < numVenues; ++i) {
+      if (table.read(i, snapshot, snapshot.count)) {
+        snapshot.venue[snapshot.count++] = names[i];
+      }
+    }
+    auto results = strategy.planExecution(request, snapshot.view());
+    benchmark::DoNotOptimize(results);
+  }
+}
+
+static void BM_DepthAwareStrategy_Split(benchmark::State& state) {
+  // Split across V venues x L levels via the k-way heap merge
+  size_t numVenues = static_cast<size_t>(state.range(0));
+  size_t numLevels = static_cast<size_t>(state.range(1));
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> tick(0.01, 0.5);
+  std::uniform_real_distribution<double> size(0.1, 5.0);
+
+  VenueQuoteSnapshot quotes;
+  VenueDepthSnapshot depth;
+  for (size_t v = 0; v < numVenues; ++v) {
+    MarketData data;
+    data.venue = "Venue" + std::to_string(v);
+    data.bidPrice = 49995.0;
+    data.askPrice = 50000.0 + tick(rng);
+    data.fees = 0.001 + 0.0001 * static_cast<double>(v % 3);
+    data.latencyMicros = 100.0 * static_cast<double>(v);
+    quotes.append(data.venue, data);
+
+    auto& asks = depth.asks[v];
+    asks.levels = numLevels;
+    double price = data.askPrice;
+    for (size_t l = 0; l < numLevels; ++l) {
+      asks.price[l] = price;
+      asks.size[l] = size(rng);
+      price += tick(rng);
+    }
+    depth.bids[v].levels = 0;
+  }
+
+  VenueQuoteView view = quotes.view();
+  view.depth = &depth;
+
+  DepthCostModel model;
+  model.latencyPenaltyPerMicro = 1e-7;
+  // Ask for about 60% of the displayed liquidity
+  double quantity = 0.6 * 2.55 * static_cast<double>(numVenues * numLevels);
+
+  for (auto _ : state) {
+    DepthSplit split = splitByDepth(OrderSide::BUY, quantity, view, model);
+    benchmark::DoNotOptimize(split);
+  }
+}
+
+static void BM_ExecutionScheduler_ScheduleAndRelease(benchmark::State& state) {
+  // Many concurrent TWAP parents: cost per slice to schedule and release
+  constexpr uint64_t MS = 1'000'000ULL;
+  constexpr int SLICES = 10;
+  size_t numParents = static_cast<size_t>(state.range(0));
+  TWAPStrategy strategy(SLICES, std::chrono::seconds(1));
+  auto marketData = createTestMarketData();
+  auto request = createTestExecutionRequest("TWAP", 100.0);
+  auto planned = strategy.planExecution(request, marketData);
+
+  uint64_t now = 0;
+  ExecutionScheduler scheduler(MS, now);
+  size_t released = 0;
+  auto onRelease = [&released](ExecutionRequest&&) { ++released; };
+  auto onDrop = [](const ExecutionRequest&) {};
+
+  for (auto _ : state) {
+    for (size_t p = 0; p < numParents; ++p) {
+      for (const auto& slice : planned) {
+        ExecutionRequest child;
+        child.requestId = slice.requestId;
+        child.parentRequestId = "PARENT";
+        child.targetVenue = slice.targetVenue;
+        child.releaseDelay = slice.releaseDelay + std::chrono::seconds(1);
+        scheduler.schedule(std::move(child), now);
+      }
+    }
+    now += (SLICES + 1) * 1000 * MS;
+    scheduler.advance(now, onRelease, onDrop);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(released));
+}
+
 // =============================================================================
 // OrderRouter End-to-End Benchmarks
 // =============================================================================
@@ -320,6 +430,61 @@ static void BM_OrderRouter_ConcurrentSubmissions(benchmark::State& state) {
   router.stop();
 }
 
+// =============================================================================
+// Pipeline Latency Benchmarks
+// =============================================================================
+
+static void BM_OrderRouter_SubmitToFirstChild(benchmark::State& state) {
+  OrderRouter router;
+  router.initialize();
+  router.start();
+
+  auto marketData = createTestMarketData();
+  for (const auto& data : marketData) {
+    router.addVenue(data.venue, "websocket");
+  }
+
+  router.setRoutingStrategy("BEST_PRICE");
+
+  // Timestamp of the first child order reaching venue dispatch
+  std::atomic<uint64_t> firstChildTime{0};
+  router.setChildOrderCallback([&firstChildTime](const ExecutionRequest&) {
+    uint64_t expected = 0;
+    firstChildTime.compare_exchange_strong(expected,
+                                           utils::TimeUtils::getCurrentNanos(),
+                                           std::memory_order_release);
+  });
+
+  for (auto _ : state) {
+    // Keep quotes fresh so the planner always has venues to route to
+    for (const auto& data : marketData) {
+      router.updateMarketData(data.venue, data);
+    }
+    auto request = createTestExecutionRequest("BEST_PRICE", 1.0);
+    firstChildTime.store(0, std::memory_order_relaxed);
+
+    uint64_t submitTime = utils::TimeUtils::getCurrentNanos();
+    std::string requestId = router.submitOrder(request);
+    benchmark::DoNotOptimize(requestId);
+
+    uint64_t childTime;
+    while ((childTime = firstChildTime.load(std::memory_order_acquire)) ==
+           0) {
+      if (utils::TimeUtils::getCurrentNanos() - submitTime > 1000000000ULL) {
+        state.SkipWithError("No child order dispatched within 1s");
+        break;
+      }
+    }
+    if (childTime == 0) {
+      break;
+    }
+
+    state.SetIterationTime((childTime - submitTime) / 1e9);
+  }
+
+  router.stop();
+}
+
 // =============================================================================
 // Register Benchmarks
 // =============================================================================
@@ -329,12 +494,23 @@ BENCHMARK(BM_BestPriceStrategy_Planning);
 BENCHMARK(BM_TWAPStrategy_Planning)->Arg(5)->Arg(10)->Arg(20);
 BENCHMARK(BM_VWAPStrategy_Planning);
 BENCHMARK(BM_MarketImpactStrategy_Planning);
+BENCHMARK(BM_BestPriceStrategy_QuoteTablePlanning)->Arg(4)->Arg(16)->Arg(32);
+BENCHMARK(BM_DepthAwareStrategy_Split)
+    ->Args({4, 10})
+    ->Args({10, 50})
+    ->Args({32, 64});
+BENCHMARK(BM_ExecutionScheduler_ScheduleAndRelease)->Arg(100)->Arg(5000);
 
 // OrderRouter core benchmarks
 BENCHMARK(BM_OrderRouter_SubmitOrder);
 BENCHMARK(BM_OrderRouter_MultipleStrategies);
 BENCHMARK(BM_OrderRouter_MarketDataUpdate);
 
+// Pipeline latency benchmarks
+BENCHMARK(BM_OrderRouter_SubmitToFirstChild)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
 // Large order benchmarks
 BENCHMARK(BM_OrderRouter_LargeOrderTWAP)->Arg(10)->Arg(50)->Arg(100);
 BENCHMARK(BM_OrderRouter_MultiVenueVWAP);
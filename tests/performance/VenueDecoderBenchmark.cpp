@@ -0,0 +1,361 @@
+#include "../../exchange/capture/CaptureReader.h"
+#include "../../exchange/connector/NormalizedFeedHandler.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace pinnacle::exchange;
+
+// Decode throughput for every venue into the normalized event stream.
+// Frames are generated in each venue's wire format with the same mix of
+// book deltas, trades and quote updates, so the venues can be compared
+// with each other. With --capture=<file.pmcap> the recorded frames are
+// decoded instead, with the decoder for the venue named in the capture
+// header; the generated corpora are then skipped.
+
+namespace {
+
+std::vector<std::string> g_capturedFrames;
+Venue g_capturedVenue = Venue::COINBASE;
+
+std::string decimal(double value, int decimals) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  return buffer;
+}
+
+class VenueFrameGenerator {
+public:
+  explicit VenueFrameGenerator(Venue venue) : m_venue(venue), m_rng(11) {}
+
+  std::vector<std::string> session(size_t count) {
+    std::vector<std::string> frames;
+    frames.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      double mid = 109231.23 * (1.0 + 1e-4 * m_normal(m_rng));
+      double roll = m_uniform(m_rng);
+      if (roll < 0.6) {
+        frames.push_back(book(mid, 1 + static_cast<int>(roll * 10)));
+      } else if (roll < 0.85) {
+        frames.push_back(trade(mid));
+      } else {
+        frames.push_back(quote(mid));
+      }
+    }
+    return frames;
+  }
+
+private:
+  Venue m_venue;
+  std::mt19937_64 m_rng;
+  std::uniform_real_distribution<double> m_uniform{0.0, 1.0};
+  std::normal_distribution<double> m_normal{0.0, 1.0};
+  uint64_t m_seq{1};
+  uint64_t m_updateId{1}; // Binance numbers book updates separately
+
+  std::string size() { return decimal(0.001 + m_uniform(m_rng) * 2.5, 8); }
+
+  // [["price","qty"],...] for one side
+  std::string levelArray(double mid, int levels, bool bid) {
+    std::string out = "[";
+    for (int i = 0; i < levels; ++i) {
+      double offset = 0.01 * (i + 1);
+      out += (i > 0 ? ",[\"" : "[\"") +
+             decimal(bid ? mid - offset : mid + offset, 2) + "\",\"" +
+             size() + "\"]";
+    }
+    return out + "]";
+  }
+
+  std::string book(double mid, int levels) {
+    int bids = (levels + 1) / 2;
+    int asks = levels / 2;
+    uint64_t first = m_updateId + 1;
+    m_updateId += static_cast<uint64_t>(levels);
+    ++m_seq;
+    switch (m_venue) {
+    case Venue::COINBASE: {
+      std::string frame =
+          R"({"channel":"l2_data","timestamp":"2025-09-01T20:17:57.1Z",)"
+          R"("sequence_num":)" +
+          std::to_string(m_seq) +
+          R"(,"events":[{"type":"update","product_id":"BTC-USD",)"
+          R"("updates":[)";
+      for (int i = 0; i < levels; ++i) {
+        bool bid = i % 2 == 0;
+        double offset = 0.01 * (i / 2 + 1);
+        frame += std::string(i > 0 ? "," : "") + R"({"side":")" +
+                 (bid ? "bid" : "offer") +
+                 R"(","event_time":"2025-09-01T20:17:57.1Z",)"
+                 R"("price_level":")" +
+                 decimal(bid ? mid - offset : mid + offset, 2) +
+                 R"(","new_quantity":")" + size() + R"("})";
+      }
+      return frame + "]}]}";
+    }
+    case Venue::BINANCE:
+      return R"({"stream":"btcusdt@depth@100ms","data":{"e":"depthUpdate",)"
+             R"("E":1756757877100,"s":"BTCUSDT","U":)" +
+             std::to_string(first) + R"(,"u":)" + std::to_string(m_updateId) +
+             R"(,"b":)" + levelArray(mid, bids, true) + R"(,"a":)" +
+             levelArray(mid, asks, false) + "}}";
+    case Venue::KRAKEN: {
+      auto objects = [&](int count, bool bid) {
+        std::string out = "[";
+        for (int i = 0; i < count; ++i) {
+          double offset = 0.1 * (i + 1);
+          out += std::string(i > 0 ? "," : "") + R"({"price":)" +
+                 decimal(bid ? mid - offset : mid + offset, 1) +
+                 R"(,"qty":)" + size() + "}";
+        }
+        return out + "]";
+      };
+      return R"({"channel":"book","type":"update","data":[{)"
+             R"("symbol":"BTC/USD","bids":)" +
+             objects(bids, true) + R"(,"asks":)" + objects(asks, false) +
+             R"(,"checksum":2439117997,)"
+             R"("timestamp":"2025-09-01T20:17:57.100000Z"}]})";
+    }
+    case Venue::BITSTAMP:
+      return R"({"data":{"timestamp":"1756757877",)"
+             R"("microtimestamp":"1756757877100000","bids":)" +
+             levelArray(mid, bids, true) + R"(,"asks":)" +
+             levelArray(mid, asks, false) +
+             R"(},"channel":"diff_order_book_btcusd","event":"data"})";
+    case Venue::GEMINI: {
+      std::string frame =
+          R"({"type":"l2_updates","symbol":"BTCUSD","changes":[)";
+      for (int i = 0; i < levels; ++i) {
+        bool bid = i % 2 == 0;
+        double offset = 0.01 * (i / 2 + 1);
+        frame += std::string(i > 0 ? "," : "") + R"([")" +
+                 (bid ? "buy" : "sell") + R"(",")" +
+                 decimal(bid ? mid - offset : mid + offset, 2) + R"(",")" +
+                 size() + R"("])";
+      }
+      return frame + "]}";
+    }
+    }
+    return {};
+  }
+
+  std::string trade(double mid) {
+    bool buy = m_uniform(m_rng) < 0.5;
+    std::string price = decimal(mid, 2);
+    switch (m_venue) {
+    case Venue::COINBASE:
+      // Trades arrive on the ticker channel
+      return quote(mid);
+    case Venue::BINANCE:
+      return R"({"stream":"btcusdt@trade","data":{"e":"trade",)"
+             R"("E":1756757877100,"s":"BTCUSDT","t":)" +
+             std::to_string(m_seq) + R"(,"p":")" + price + R"(","q":")" +
+             size() + R"(","T":1756757877100,"m":)" +
+             (buy ? "false" : "true") + "}}";
+    case Venue::KRAKEN:
+      return R"({"channel":"trade","type":"update","data":[{)"
+             R"("symbol":"BTC/USD","side":")" +
+             std::string(buy ? "buy" : "sell") + R"(","price":)" + price +
+             R"(,"qty":)" + size() +
+             R"(,"ord_type":"market","trade_id":)" + std::to_string(m_seq) +
+             R"(,"timestamp":"2025-09-01T20:17:57.100000Z"}]})";
+    case Venue::BITSTAMP:
+      return R"({"data":{"id":)" + std::to_string(m_seq) +
+             R"(,"amount_str":")" + size() + R"(","price_str":")" + price +
+             R"(","type":)" + (buy ? "0" : "1") +
+             R"(,"microtimestamp":"1756757877100000"},)"
+             R"("channel":"live_trades_btcusd","event":"trade"})";
+    case Venue::GEMINI:
+      return R"({"type":"trade","symbol":"BTCUSD","event_id":)" +
+             std::to_string(m_seq) + R"(,"timestamp":1756757877100,)"
+                                     R"("price":")" +
+             price + R"(","quantity":")" + size() + R"(","side":")" +
+             (buy ? "buy" : "sell") + R"("})";
+    }
+    return {};
+  }
+
+  std::string quote(double mid) {
+    std::string bid = decimal(mid - 0.01, 2);
+    std::string ask = decimal(mid + 0.01, 2);
+    ++m_seq;
+    switch (m_venue) {
+    case Venue::COINBASE:
+      return R"({"channel":"ticker","timestamp":"2025-09-01T20:17:57.1Z",)"
+             R"("sequence_num":)" +
+             std::to_string(m_seq) +
+             R"(,"events":[{"type":"update","tickers":[{"type":"ticker",)"
+             R"("product_id":"BTC-USD","price":")" +
+             decimal(mid, 2) + R"(","volume_24_h":"4554.12345678",)" +
+             R"("best_bid":")" + bid + R"(","best_bid_quantity":")" + size() +
+             R"(","best_ask":")" + ask + R"(","best_ask_quantity":")" +
+             size() + R"("}]}]})";
+    case Venue::BINANCE:
+      return R"({"stream":"btcusdt@bookTicker","data":{"u":)" +
+             std::to_string(m_seq) + R"(,"s":"BTCUSDT","b":")" + bid +
+             R"(","B":")" + size() + R"(","a":")" + ask + R"(","A":")" +
+             size() + R"("}})";
+    case Venue::KRAKEN:
+      return R"({"channel":"ticker","type":"update","data":[{)"
+             R"("symbol":"BTC/USD","bid":)" +
+             bid + R"(,"bid_qty":)" + size() + R"(,"ask":)" + ask +
+             R"(,"ask_qty":)" + size() + R"(,"last":)" + decimal(mid, 2) +
+             R"(,"volume":1234.5}]})";
+    case Venue::BITSTAMP:
+    case Venue::GEMINI:
+      // No top-of-book channel; quotes come from the book
+      return book(mid, 2);
+    }
+    return {};
+  }
+};
+
+const std::vector<std::string>& corpus(Venue venue) {
+  static std::vector<std::string> generated[5];
+  if (!g_capturedFrames.empty()) {
+    return g_capturedFrames;
+  }
+  auto& frames = generated[static_cast<size_t>(venue)];
+  if (frames.empty()) {
+    frames = VenueFrameGenerator(venue).session(10'000);
+  }
+  return frames;
+}
+
+Venue benchmarkVenue(const benchmark::State& state) {
+  return g_capturedFrames.empty() ? static_cast<Venue>(state.range(0))
+                                  : g_capturedVenue;
+}
+
+size_t totalBytes(const std::vector<std::string>& frames) {
+  size_t bytes = 0;
+  for (const auto& frame : frames) {
+    bytes += frame.size();
+  }
+  return bytes;
+}
+
+void setVenueArgs(benchmark::internal::Benchmark* benchmark) {
+  if (!g_capturedFrames.empty()) {
+    benchmark->Arg(static_cast<int>(g_capturedVenue));
+    return;
+  }
+  for (Venue venue : {Venue::COINBASE, Venue::KRAKEN, Venue::GEMINI,
+                      Venue::BINANCE, Venue::BITSTAMP}) {
+    benchmark->Arg(static_cast<int>(venue));
+  }
+}
+
+} // namespace
+
+// Decoder alone, into a reused event buffer
+static void BM_Decode(benchmark::State& state) {
+  Venue venue = benchmarkVenue(state);
+  const auto& frames = corpus(venue);
+  auto decoder = createVenueDecoder(venue);
+  SymbolTable symbols;
+  MarketEventBuffer buffer(symbols);
+  uint64_t events = 0;
+  uint64_t malformed = 0;
+
+  for (auto _ : state) {
+    for (const auto& frame : frames) {
+      buffer.reset(venue, 0);
+      DecodedFrame decoded = decoder->decode(frame, 0, buffer);
+      malformed += decoded.kind == FrameKind::MALFORMED;
+      events += buffer.size();
+    }
+  }
+
+  benchmark::DoNotOptimize(events);
+  state.SetLabel(venueName(venue));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  state.counters["events"] = benchmark::Counter(
+      static_cast<double>(events), benchmark::Counter::kIsRate);
+  state.counters["malformed"] = static_cast<double>(malformed);
+}
+
+// Full handler: decode, sequence checks and legacy update assembly. A new
+// handler per pass, so the replayed sequence numbers are not duplicates
+static void BM_NormalizedFeed(benchmark::State& state) {
+  Venue venue = benchmarkVenue(state);
+  const auto& frames = corpus(venue);
+  double checksum = 0.0;
+  uint64_t events = 0;
+  uint64_t gaps = 0;
+
+  for (auto _ : state) {
+    NormalizedFeedHandler handler(createVenueDecoder(venue));
+    handler.addSymbol("BTC-USD");
+    handler.setEventSink(
+        [&](std::span<const MarketEvent> batch) { events += batch.size(); });
+    handler.setMarketUpdateSink(
+        [&](const MarketUpdate& update) { checksum += update.price; });
+    handler.setOrderBookUpdateSink([&](const OrderBookUpdate& update) {
+      checksum += static_cast<double>(update.bids.size());
+    });
+    uint64_t receivedAt = 0;
+    for (const auto& frame : frames) {
+      handler.process(frame, receivedAt += 1000);
+    }
+    gaps += handler.getSequenceGaps();
+  }
+
+  benchmark::DoNotOptimize(checksum);
+  state.SetLabel(venueName(venue));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(frames.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(totalBytes(frames)));
+  state.counters["events"] = benchmark::Counter(
+      static_cast<double>(events), benchmark::Counter::kIsRate);
+  state.counters["gaps"] = static_cast<double>(gaps);
+}
+
+int main(int argc, char** argv) {
+  // Strip --capture=<file.pmcap> before benchmark sees it
+  const std::string_view flag = "--capture=";
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg.substr(0, flag.size()) != flag) {
+      argv[kept++] = argv[i];
+      continue;
+    }
+    capture::CaptureReader reader;
+    if (!reader.open(std::string(arg.substr(flag.size())))) {
+      std::cerr << "Cannot open " << arg.substr(flag.size()) << std::endl;
+      return 1;
+    }
+    const auto& source = reader.getHeader().source;
+    g_capturedVenue =
+        venueFromName(std::string_view(source, strnlen(source, sizeof(source))))
+            .value_or(Venue::COINBASE);
+    capture::CapturedFrame frame;
+    while (reader.next(frame)) {
+      g_capturedFrames.emplace_back(frame.data);
+    }
+    std::cout << "Loaded " << g_capturedFrames.size() << " "
+              << venueName(g_capturedVenue) << " frames" << std::endl;
+  }
+  argc = kept;
+
+  // Registered here so the venue list can depend on --capture
+  benchmark::RegisterBenchmark("BM_Decode", BM_Decode)->Apply(setVenueArgs);
+  benchmark::RegisterBenchmark("BM_NormalizedFeed", BM_NormalizedFeed)
+      ->Apply(setVenueArgs);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
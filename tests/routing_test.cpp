@@ -1,9 +1,19 @@
+#include "../core/routing/DepthSplitter.h"
 #include "../core/routing/OrderRouter.h"
+#include "../core/routing/QuoteRanking.h"
+#include "../core/routing/VenueLatencyModel.h"
+#include "../core/routing/VenueQuoteTable.h"
 #include "../core/utils/TimeUtils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -108,6 +118,63 @@ void testVWAPStrategy() {
             << std::endl;
 }
 
+void testSlicesWithinDeadline() {
+  std::cout << "Testing slice schedules within the parent deadline..."
+            << std::endl;
+
+  auto check = [](bool condition, const char* what) {
+    if (!condition) {
+      throw std::runtime_error(std::string("Slice deadline: ") + what);
+    }
+  };
+
+  std::vector<MarketData> marketData = {
+      {"Venue1", 50000.0, 50100.0, 10.0, 8.0,
+       utils::TimeUtils::getCurrentNanos(), 1000.0, 500.0, 0.001, 0.003},
+      {"Venue2", 50010.0, 50110.0, 12.0, 10.0,
+       utils::TimeUtils::getCurrentNanos(), 2000.0, 1000.0, 0.0015, 0.004}};
+
+  // 20 slices 30s apart would run to 570s, past a 60s deadline
+  TWAPStrategy twap(20, std::chrono::seconds(30));
+  Order twapOrder("TEST_DEADLINE_1", "BTC-USD", OrderSide::BUY,
+                  OrderType::LIMIT, 50000.0, 20.0,
+                  utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest twapRequest;
+  twapRequest.requestId = "REQ_DEADLINE_1";
+  twapRequest.order = std::move(twapOrder);
+  twapRequest.maxExecutionTime = std::chrono::seconds(60);
+
+  auto slices = twap.planExecution(twapRequest, marketData);
+  check(slices.size() == 20, "TWAP slice count");
+  for (size_t i = 1; i < slices.size(); ++i) {
+    check(slices[i].releaseDelay > slices[i - 1].releaseDelay,
+          "TWAP slices spaced");
+  }
+  check(slices.back().releaseDelay < twapRequest.maxExecutionTime,
+        "TWAP within deadline");
+
+  // Participation so low that VWAP needs hundreds of 30s slices
+  VWAPStrategy vwap(0.01, std::chrono::seconds(30));
+  Order vwapOrder("TEST_DEADLINE_2", "BTC-USD", OrderSide::BUY,
+                  OrderType::LIMIT, 50000.0, 5000.0,
+                  utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest vwapRequest;
+  vwapRequest.requestId = "REQ_DEADLINE_2";
+  vwapRequest.order = std::move(vwapOrder);
+  vwapRequest.maxExecutionTime = std::chrono::seconds(300);
+
+  auto children = vwap.planExecution(vwapRequest, marketData);
+  check(children.size() > 10, "VWAP slice count");
+  for (const auto& child : children) {
+    check(child.releaseDelay.count() > 0 &&
+              child.releaseDelay < vwapRequest.maxExecutionTime,
+          "VWAP within deadline");
+  }
+
+  std::cout << "✓ " << slices.size() << " TWAP and " << children.size()
+            << " VWAP children released before the deadline" << std::endl;
+}
+
 void testMarketImpactStrategy() {
   std::cout << "Testing MarketImpactStrategy..." << std::endl;
 
@@ -144,6 +211,403 @@ void testMarketImpactStrategy() {
             << std::endl;
 }
 
+void testVenueQuoteTable() {
+  std::cout << "Testing VenueQuoteTable..." << std::endl;
+
+  VenueQuoteTable table;
+  VenueQuoteSnapshot snapshot;
+
+  // Unpublished venues are not readable
+  assert(!table.read(0, snapshot, 0));
+
+  MarketData data;
+  data.bidPrice = 50000.0;
+  data.askPrice = 50100.0;
+  data.bidSize = 2.0;
+  data.askSize = 3.0;
+  data.fees = 0.001;
+  table.publish(3, data, 12345);
+
+  assert(table.read(3, snapshot, 0));
+  assert(snapshot.bidPrice[0] == 50000.0);
+  assert(snapshot.askPrice[0] == 50100.0);
+  assert(snapshot.askSize[0] == 3.0);
+  assert(snapshot.timestamp[0] == 12345);
+  assert(table.version(3) == 1);
+
+  // Concurrent publishers and a reader never observe a torn row
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+  std::thread reader([&]() {
+    VenueQuoteSnapshot local;
+    while (!done.load()) {
+      if (table.read(3, local, 0) &&
+          local.askPrice[0] != local.bidPrice[0] + 100.0) {
+        torn.store(true);
+      }
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < 2; ++w) {
+    writers.emplace_back([&table, w]() {
+      MarketData update;
+      for (int i = 0; i < 100000; ++i) {
+        update.bidPrice = 50000.0 + w * 1000000 + i;
+        update.askPrice = update.bidPrice + 100.0;
+        table.publish(3, update, i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done.store(true);
+  reader.join();
+
+  if (torn.load()) {
+    throw std::runtime_error("VenueQuoteTable reader observed a torn row");
+  }
+  assert(table.version(3) == 200001);
+
+  std::cout << "✓ VenueQuoteTable publish/read consistent" << std::endl;
+}
+
+void testQuoteRanking() {
+  std::cout << "Testing venue ranking..." << std::endl;
+
+  constexpr double INF = std::numeric_limits<double>::infinity();
+
+  // Compare vectorized reductions with a sequential scan for every length
+  // up to the venue limit, including the scalar tail
+  for (size_t n = 1; n <= MAX_ROUTING_VENUES; ++n) {
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+      values[i] = static_cast<double>((i * 7919) % 13);
+    }
+
+    size_t expectedMin = 0;
+    size_t expectedMax = 0;
+    for (size_t i = 1; i < n; ++i) {
+      if (values[i] < values[expectedMin])
+        expectedMin = i;
+      if (values[i] > values[expectedMax])
+        expectedMax = i;
+    }
+
+    if (argMinVenue(values) != expectedMin ||
+        argMaxVenue(values) != expectedMax) {
+      throw std::runtime_error("Venue ranking mismatch at n=" +
+                               std::to_string(n));
+    }
+  }
+
+  // Excluded entries never win, and an all-excluded column has no venue
+  std::vector<double> excluded = {INF, INF, 5.0, INF, INF, 4.0};
+  assert(argMinVenue(excluded) == 5);
+  std::vector<double> none = {INF, INF, INF, INF, INF};
+  assert(argMinVenue(none) == NO_VENUE);
+  std::vector<double> noneMax = {-INF, -INF};
+  assert(argMaxVenue(noneMax) == NO_VENUE);
+
+  std::cout << "✓ Venue ranking matches sequential scan" << std::endl;
+}
+
+void testExecutionScheduler() {
+  std::cout << "Testing ExecutionScheduler..." << std::endl;
+
+  constexpr uint64_t MS = 1'000'000ULL;
+  ExecutionScheduler scheduler(MS, 0);
+
+  double tradedVolume = 0.0;
+  scheduler.setVolumeSource(
+      [&tradedVolume](const std::string&, const std::string&) {
+        return tradedVolume;
+      });
+
+  // TWAP: 4 slices 10ms apart are released on schedule
+  TWAPStrategy twap(4, std::chrono::seconds(1));
+  Order twapOrder("TEST_SCHED_TWAP", "BTC-USD", OrderSide::BUY,
+                  OrderType::LIMIT, 50000.0, 4.0, 0);
+  ExecutionRequest twapRequest;
+  twapRequest.requestId = "REQ_SCHED_TWAP";
+  twapRequest.order = std::move(twapOrder);
+
+  std::vector<MarketData> marketData = {
+      {"Coinbase", 49990.0, 50010.0, 20.0, 15.0, 0, 500.0, 250.0, 0.001,
+       0.005}};
+  auto slices = twap.planExecution(twapRequest, marketData);
+  assert(slices.size() == 4);
+
+  std::vector<ExecutionRequest> released;
+  auto onRelease = [&released](ExecutionRequest&& child) {
+    released.push_back(std::move(child));
+  };
+  size_t drops = 0;
+  auto onDrop = [&drops](const ExecutionRequest&) { ++drops; };
+
+  for (auto& slice : slices) {
+    slice.parentRequestId = twapRequest.requestId;
+    slice.releaseDelay = slice.releaseDelay / 100; // 1s spacing -> 10ms
+    if (slice.releaseDelay.count() > 0) {
+      scheduler.schedule(std::move(slice), 0);
+    }
+  }
+  assert(scheduler.pendingCount() == 3);
+
+  for (uint64_t t = 1; t <= 35; ++t) {
+    scheduler.advance(t * MS, onRelease, onDrop);
+    size_t expected = t < 10 ? 0 : t < 20 ? 1 : t < 30 ? 2 : 3;
+    if (released.size() != expected) {
+      throw std::runtime_error("TWAP slice released off schedule at " +
+                               std::to_string(t) + "ms");
+    }
+  }
+
+  // VWAP: slices take 20% of the volume traded since the previous slice,
+  // carrying the shortfall, and the last slice sends the remainder
+  released.clear();
+  for (int i = 0; i < 3; ++i) {
+    ExecutionRequest slice;
+    slice.requestId = "REQ_SCHED_VWAP_" + std::to_string(i);
+    slice.parentRequestId = "REQ_SCHED_VWAP";
+    slice.targetVenue = "Coinbase";
+    slice.order = Order(slice.requestId, "BTC-USD", OrderSide::BUY,
+                        OrderType::LIMIT, 50000.0, 10.0, 0);
+    slice.releaseDelay = std::chrono::milliseconds(100 * (i + 1));
+    slice.participationRate = 0.2;
+    scheduler.schedule(std::move(slice), 100 * MS);
+  }
+
+  tradedVolume = 25.0; // 5 units of participation
+  scheduler.advance(200 * MS, onRelease, onDrop);
+  tradedVolume = 25.5; // Too little to place a slice
+  scheduler.advance(300 * MS, onRelease, onDrop);
+  tradedVolume = 30.0;
+  scheduler.advance(400 * MS, onRelease, onDrop);
+
+  if (released.size() != 2 || drops != 1 ||
+      std::abs(released[0].order.getQuantity() - 5.0) > 1e-9 ||
+      std::abs(released[1].order.getQuantity() - 25.0) > 1e-9) {
+    throw std::runtime_error("VWAP participation sizing mismatch");
+  }
+  assert(scheduler.empty());
+
+  std::cout << "✓ ExecutionScheduler released TWAP on schedule and sized "
+               "VWAP from volume"
+            << std::endl;
+}
+
+void testDepthAwareStrategy() {
+  std::cout << "Testing DepthAwareStrategy..." << std::endl;
+
+  // Three venues with different books, fees and latency
+  std::vector<MarketData> marketData = {
+      {"Deep", 99.0, 100.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0, 0.001},
+      {"Cheap", 99.0, 100.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0, 0.0},
+      {"Thin", 99.0, 99.5, 0.0, 2.0, 0, 0.0, 0.0, 0.0, 0.002}};
+  marketData[1].latencyMicros = 500.0;
+
+  VenueQuoteSnapshot quotes;
+  quotes.assign(marketData);
+
+  VenueDepthSnapshot depth;
+  auto setAsks = [&depth](size_t row, std::vector<double> prices,
+                          std::vector<double> sizes) {
+    depth.asks[row].levels = prices.size();
+    std::copy(prices.begin(), prices.end(), depth.asks[row].price.begin());
+    std::copy(sizes.begin(), sizes.end(), depth.asks[row].size.begin());
+    depth.bids[row].levels = 0;
+  };
+  setAsks(0, {100.0, 100.1, 100.2, 100.5}, {5.0, 5.0, 10.0, 50.0});
+  setAsks(1, {100.0, 100.05, 100.3}, {3.0, 3.0, 3.0});
+  depth.bids[2].levels = 0;
+  depth.asks[2].levels = 0; // Thin venue falls back to top of book
+
+  VenueQuoteView view = quotes.view();
+  view.depth = &depth;
+
+  DepthCostModel model;
+  model.latencyPenaltyPerMicro = 1e-6;
+
+  // Reference: sort every level by effective cost and fill greedily
+  struct Level {
+    double cost;
+    size_t venue;
+    double size;
+  };
+  std::vector<Level> levels;
+  for (size_t v = 0; v < 3; ++v) {
+    double factor = 1.0 + marketData[v].fees +
+                    model.latencyPenaltyPerMicro * marketData[v].latencyMicros;
+    if (depth.asks[v].levels == 0) {
+      levels.push_back({marketData[v].askPrice * factor, v,
+                        marketData[v].askSize});
+      continue;
+    }
+    for (size_t l = 0; l < depth.asks[v].levels; ++l) {
+      levels.push_back(
+          {depth.asks[v].price[l] * factor, v, depth.asks[v].size[l]});
+    }
+  }
+  std::stable_sort(levels.begin(), levels.end(),
+                   [](const Level& a, const Level& b) {
+                     return a.cost < b.cost;
+                   });
+
+  double quantity = 25.0;
+  std::array<double, 3> expected{};
+  double remaining = quantity;
+  for (const auto& level : levels) {
+    double take = std::min(remaining, level.size);
+    expected[level.venue] += take;
+    remaining -= take;
+  }
+
+  DepthSplit split = splitByDepth(OrderSide::BUY, quantity, view, model);
+  for (size_t v = 0; v < 3; ++v) {
+    if (std::abs(split.quantity[v] - expected[v]) > 1e-9) {
+      throw std::runtime_error("Depth split mismatch for venue " +
+                               marketData[v].venue);
+    }
+  }
+  assert(std::abs(split.filledQuantity - quantity) < 1e-9);
+
+  // A limit below the second level of every book caps the fill
+  model.limitPrice = 100.0;
+  DepthSplit limited = splitByDepth(OrderSide::BUY, quantity, view, model);
+  if (std::abs(limited.filledQuantity - 10.0) > 1e-9 || // 5 + 3 + 2
+      limited.worstPrice[0] != 100.0) {
+    throw std::runtime_error("Depth split ignored the limit price");
+  }
+
+  // The strategy emits one limit child per venue used
+  DepthAwareStrategy strategy(1e-6);
+  Order testOrder("TEST_DEPTH", "BTC-USD", OrderSide::BUY, OrderType::MARKET,
+                  0.0, quantity, utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest request;
+  request.requestId = "REQ_DEPTH";
+  request.order = std::move(testOrder);
+
+  auto results = strategy.planExecution(request, view);
+  double total = 0.0;
+  for (const auto& result : results) {
+    total += result.order.getQuantity();
+    std::cout << "  Venue: " << result.targetVenue
+              << ", Quantity: " << result.order.getQuantity()
+              << ", Limit: " << result.order.getPrice() << std::endl;
+  }
+  if (results.size() != 3 || std::abs(total - quantity) > 1e-9) {
+    throw std::runtime_error("DepthAwareStrategy child orders mismatch");
+  }
+
+  std::cout << "✓ DepthAwareStrategy matches greedy reference allocation"
+            << std::endl;
+}
+
+void testVenueLatencyModel() {
+  std::cout << "Testing VenueLatencyModel..." << std::endl;
+
+  auto check = [](bool condition, const char* what) {
+    if (!condition) {
+      throw std::runtime_error(std::string("VenueLatencyModel: ") + what);
+    }
+  };
+
+  VenueLatencyModel model;
+  check(model.latencyMicros(0, 42.0) == 42.0, "fallback before samples");
+
+  // Round trips uniform over 100..199us: p90 should settle near 190us
+  for (int i = 0; i < 20000; ++i) {
+    model.recordRoundTrip(0, 100'000 + static_cast<uint64_t>(i * 37 % 100) *
+                                           1000);
+  }
+  VenueLatencyEstimate estimate = model.estimate(0);
+  check(estimate.roundTripSamples == 20000, "round trip count");
+  check(std::abs(estimate.roundTripMeanMicros - 150.0) < 25.0,
+        "round trip mean");
+  double p90 = model.latencyMicros(0, 0.0);
+  check(p90 > 170.0 && p90 < 205.0, "round trip p90");
+
+  // Feed delay from exchange timestamps; mismatched clocks are ignored
+  uint64_t wall = utils::TimeUtils::getWallClockNanos();
+  model.recordQuote(1, wall - 2'000'000, wall);
+  model.recordQuote(1, 5'000, wall); // Steady-clock stamp, not epoch
+  model.recordQuote(1, 0, wall);     // No exchange timestamp
+  check(model.estimate(1).feedDelaySamples == 1, "feed delay samples");
+
+  // Staleness is feed delay plus age beyond the usual update gap
+  check(std::abs(model.stalenessMicros(1, 10'000'000, 4000.0) - 8000.0) < 1e-6,
+        "staleness with excess age");
+  check(std::abs(model.stalenessMicros(1, 1'000'000, 4000.0) - 2000.0) < 1e-6,
+        "staleness within update gap");
+
+  // The quote table learns each row's update interval
+  VenueQuoteTable table;
+  MarketData data;
+  data.bidPrice = 99.0;
+  data.askPrice = 101.0;
+  for (uint64_t t = 1; t <= 50; ++t) {
+    table.publish(0, data, t * 3'000'000);
+  }
+  VenueQuoteSnapshot snapshot;
+  check(table.read(0, snapshot, 0), "table read");
+  check(std::abs(snapshot.updateIntervalMicros[0] - 3000.0) < 1e-6,
+        "update interval");
+
+  // A cheaper but stale venue loses to a fresh one
+  std::vector<MarketData> quotes(2);
+  quotes[0].venue = "Stale";
+  quotes[0].bidPrice = 99.9;
+  quotes[0].askPrice = 100.0;
+  quotes[1].venue = "Fresh";
+  quotes[1].bidPrice = 99.9;
+  quotes[1].askPrice = 100.02;
+  snapshot.assign(quotes);
+  snapshot.stalenessMicros[0] = 50'000.0; // 50ms behind the venue
+
+  Order order("ORDER_LAT", "BTC-USD", OrderSide::BUY, OrderType::LIMIT, 100.1,
+              1.0, utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest request;
+  request.requestId = "REQ_LAT";
+  request.order = std::move(order);
+
+  BestPriceStrategy strategy;
+  auto results = strategy.planExecution(request, snapshot.view());
+  check(results.size() == 1 && results[0].targetVenue == "Fresh",
+        "stale venue discounted");
+
+  snapshot.stalenessMicros[0] = 0.0;
+  results = strategy.planExecution(request, snapshot.view());
+  check(results.size() == 1 && results[0].targetVenue == "Stale",
+        "fresh cheaper venue wins");
+
+  // Dispatched children feed the router's round-trip estimator
+  OrderRouter router;
+  check(router.initialize() && router.start(), "router start");
+  router.addVenue("LatencyVenue");
+  MarketData venueQuote = quotes[1];
+  venueQuote.venue = "LatencyVenue";
+  router.updateMarketData("LatencyVenue", venueQuote);
+
+  Order routed("ORDER_LAT_2", "BTC-USD", OrderSide::BUY, OrderType::LIMIT,
+               100.1, 1.0, utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest routedRequest;
+  routedRequest.order = std::move(routed);
+  check(!router.submitOrder(routedRequest).empty(), "submit");
+
+  for (int i = 0; i < 100 && router.getVenueLatency("LatencyVenue")
+                                     .roundTripSamples == 0;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  router.stop();
+  check(router.getVenueLatency("LatencyVenue").roundTripSamples == 1,
+        "router round trip recorded");
+
+  std::cout << "✓ VenueLatencyModel p90 " << p90 << "us" << std::endl;
+}
+
 void testOrderRouterBasicFunctionality() {
   std::cout << "Testing OrderRouter basic functionality..." << std::endl;
 
@@ -268,6 +732,110 @@ void testOrderRouterMultipleStrategies() {
   std::cout << "✓ Multiple strategies test passed" << std::endl;
 }
 
+void testOrderRouterReentrantCallbacks() {
+  std::cout << "Testing OrderRouter reentrant callbacks..." << std::endl;
+
+  auto check = [](bool condition, const char* what) {
+    if (!condition) {
+      throw std::runtime_error(std::string("Reentrant callbacks: ") + what);
+    }
+  };
+
+  OrderRouter router;
+  check(router.initialize() && router.start(), "router start");
+  router.addVenue("SyncVenue");
+  MarketData quote;
+  quote.venue = "SyncVenue";
+  quote.bidPrice = 99.9;
+  quote.askPrice = 100.0;
+  quote.bidSize = 10.0;
+  quote.askSize = 10.0;
+  quote.timestamp = utils::TimeUtils::getCurrentNanos();
+  router.updateMarketData("SyncVenue", quote);
+
+  // A sender that reports the fill before returning, and a callback that
+  // reconfigures the router from inside the callout
+  router.setOrderSender([&router](const ExecutionRequest& child) {
+    router.onExecutionReport(child.orderHandle, OrderStatus::FILLED,
+                             child.order.getQuantity(), 100.0,
+                             utils::TimeUtils::getCurrentNanos());
+    return true;
+  });
+  std::atomic<int> results{0};
+  router.setExecutionCallback([&router, &results](const ExecutionResult&) {
+    router.setChildOrderCallback([](const ExecutionRequest&) {});
+    results.fetch_add(1);
+  });
+
+  Order order("ORDER_SYNC", "BTC-USD", OrderSide::BUY, OrderType::LIMIT,
+              100.0, 1.0, utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest request;
+  request.order = std::move(order);
+  request.routingStrategy = "BEST_PRICE";
+  check(!router.submitOrder(request).empty(), "submit");
+
+  for (int i = 0; i < 100 && results.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  check(results.load() > 0, "reentrant sender completes");
+  router.stop();
+
+  std::cout << "✓ Reentrant callbacks test passed" << std::endl;
+}
+
+void testOrderRouterDelayedFirstChild() {
+  std::cout << "Testing first-child latency of time-sliced parents..."
+            << std::endl;
+
+  auto check = [](bool condition, const char* what) {
+    if (!condition) {
+      throw std::runtime_error(std::string("Delayed first child: ") + what);
+    }
+  };
+  auto maxFirstChildMicros = [](const OrderRouter& router) {
+    std::string stats = router.getStatistics();
+    size_t line = stats.find("Submit-to-First-Child");
+    size_t max = stats.find("(max ", line);
+    return line == std::string::npos || max == std::string::npos
+               ? -1.0
+               : std::stod(stats.substr(max + 5));
+  };
+
+  OrderRouter router;
+  check(router.initialize() && router.start(), "router start");
+  router.addVenue("SliceVenue");
+  MarketData quote;
+  quote.venue = "SliceVenue";
+  quote.bidPrice = 99.9;
+  quote.askPrice = 100.0;
+  quote.bidSize = 10.0;
+  quote.askSize = 10.0;
+  quote.timestamp = utils::TimeUtils::getCurrentNanos();
+  quote.recentVolume = 1000.0;
+  router.updateMarketData("SliceVenue", quote);
+
+  // Five VWAP slices compressed into a second, the first a sixth of it in
+  Order order("ORDER_SLICED", "BTC-USD", OrderSide::BUY, OrderType::LIMIT,
+              100.0, 500.0, utils::TimeUtils::getCurrentNanos());
+  ExecutionRequest request;
+  request.order = std::move(order);
+  request.routingStrategy = "VWAP";
+  request.maxExecutionTime = std::chrono::seconds(1);
+  router.setRoutingStrategy("VWAP");
+  check(!router.submitOrder(request).empty(), "submit");
+
+  double maxMicros = 0.0;
+  for (int i = 0; i < 100 && maxMicros <= 0.0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    maxMicros = maxFirstChildMicros(router);
+  }
+  router.stop();
+  check(maxMicros >= 100000.0, "released child measured from submit");
+
+  std::cout << "✓ Delayed first child recorded after " << maxMicros << "us"
+            << std::endl;
+}
+
 int main() {
   std::cout << "=== OrderRouter Test Suite ===" << std::endl;
 
@@ -276,11 +844,21 @@ int main() {
     testBestPriceStrategy();
     testTWAPStrategy();
     testVWAPStrategy();
+    testSlicesWithinDeadline();
     testMarketImpactStrategy();
+    testDepthAwareStrategy();
+
+    // Test quote storage and ranking
+    testVenueQuoteTable();
+    testQuoteRanking();
+    testExecutionScheduler();
+    testVenueLatencyModel();
 
     // Test router functionality
     testOrderRouterBasicFunctionality();
     testOrderRouterMultipleStrategies();
+    testOrderRouterReentrantCallbacks();
+    testOrderRouterDelayedFirstChild();
 
     std::cout << "\n All OrderRouter tests passed successfully!" << std::endl;
     return 0;
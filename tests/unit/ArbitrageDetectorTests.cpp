@@ -1,9 +1,15 @@
 #include "../../core/utils/TimeUtils.h"
 #include "../../strategies/arbitrage/ArbitrageDetector.h"
 #include "../../strategies/arbitrage/ArbitrageExecutor.h"
+#include "../../strategies/arbitrage/CycleArbitrageDetector.h"
 
+#include <atomic>
+#include <chrono>
 #include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 using namespace pinnacle;
 using namespace pinnacle::arbitrage;
@@ -135,6 +141,185 @@ TEST_F(ArbitrageDetectorTest, DryRunExecution) {
   EXPECT_GT(result.executionTimeNs, 0u);
 }
 
+namespace {
+ArbitrageOpportunity makeOpportunity() {
+  ArbitrageOpportunity opp;
+  opp.symbol = "BTC-USD";
+  opp.buyVenue = "coinbase";
+  opp.sellVenue = "kraken";
+  opp.buyPrice = 100.00;
+  opp.sellPrice = 100.50;
+  opp.spread = 0.50;
+  opp.spreadBps = 50.0;
+  opp.maxQuantity = 1.0;
+  opp.estimatedProfit = 0.50;
+  return opp;
+}
+} // namespace
+
+TEST_F(ArbitrageDetectorTest, LiveLegsSubmittedConcurrently) {
+  ArbitrageExecutor executor(false);
+
+  // Each leg waits for the other, so sequential submission would time out
+  std::atomic<int> arrived{0};
+  std::mutex threadsMutex;
+  std::vector<std::thread::id> threads;
+  executor.setOrderSubmitCallback(
+      [&](const std::string&, const std::string&, OrderSide, double,
+          double) {
+        {
+          std::lock_guard<std::mutex> lock(threadsMutex);
+          threads.push_back(std::this_thread::get_id());
+        }
+        arrived.fetch_add(1);
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (arrived.load() < 2) {
+          if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+          }
+          std::this_thread::yield();
+        }
+        return true;
+      });
+
+  auto result = executor.execute(makeOpportunity());
+  EXPECT_TRUE(result.buyFilled);
+  EXPECT_TRUE(result.sellFilled);
+  EXPECT_TRUE(result.error.empty());
+  EXPECT_NEAR(result.realizedProfit, 0.50, 1e-9);
+  ASSERT_EQ(threads.size(), 2u);
+  EXPECT_NE(threads[0], threads[1]);
+  EXPECT_EQ(executor.getLegSkewHistogram().count(), 1u);
+}
+
+TEST_F(ArbitrageDetectorTest, HedgesPartiallyFilledLeg) {
+  ArbitrageExecutor executor(false);
+
+  std::atomic<int> sellOrders{0};
+  executor.setLegSubmitCallback([&](const std::string&, const std::string&,
+                                    OrderSide side, double price,
+                                    double quantity) {
+    if (side == OrderSide::SELL && sellOrders.fetch_add(1) == 0) {
+      return LegFill{quantity / 2.0, price};
+    }
+    return LegFill{quantity, price};
+  });
+
+  auto result = executor.execute(makeOpportunity());
+  EXPECT_TRUE(result.buyFilled);
+  EXPECT_TRUE(result.sellFilled);
+  EXPECT_TRUE(result.error.empty());
+  EXPECT_NEAR(result.hedgedQuantity, 0.5, 1e-9);
+  EXPECT_NEAR(result.fillQuantity, 1.0, 1e-9);
+  // Half the sell leg went out 10 bps below the quoted bid
+  EXPECT_NEAR(result.sellLeg.avgPrice, 100.50 - 0.5 * 0.1005, 1e-9);
+  EXPECT_GT(result.slippage, 0.0);
+  EXPECT_LT(result.realizedProfit, 0.50);
+  EXPECT_EQ(result.residualQuantity, 0.0);
+}
+
+TEST_F(ArbitrageDetectorTest, UnwindsWhenHedgeFails) {
+  ArbitrageExecutor executor(false);
+
+  // kraken rejects everything; coinbase fills both the buy and the unwind
+  executor.setLegSubmitCallback([](const std::string& venue,
+                                   const std::string&, OrderSide,
+                                   double price, double quantity) {
+    return venue == "coinbase" ? LegFill{quantity, price} : LegFill{};
+  });
+
+  auto result = executor.execute(makeOpportunity());
+  EXPECT_TRUE(result.buyFilled);
+  EXPECT_FALSE(result.sellFilled);
+  EXPECT_EQ(result.sellLeg.state, LegState::FAILED);
+  EXPECT_NEAR(result.unwoundQuantity, 1.0, 1e-9);
+  EXPECT_EQ(result.residualQuantity, 0.0);
+  EXPECT_FALSE(result.error.empty());
+  // Sold back 25 bps below the purchase price
+  EXPECT_NEAR(result.realizedProfit, -0.25, 1e-9);
+  EXPECT_EQ(executor.getOpenExposure("BTC-USD"), 0.0);
+}
+
+TEST_F(ArbitrageDetectorTest, ResidualExposureBlocksExecution) {
+  LegRiskConfig legRisk;
+  legRisk.maxOpenExposure = 50.0;
+  ArbitrageExecutor executor(false, legRisk);
+
+  std::atomic<int> calls{0};
+  executor.setLegSubmitCallback([&](const std::string&, const std::string&,
+                                    OrderSide side, double price,
+                                    double quantity) {
+    calls.fetch_add(1);
+    return side == OrderSide::BUY && calls.load() <= 2
+               ? LegFill{quantity, price}
+               : LegFill{};
+  });
+
+  auto result = executor.execute(makeOpportunity());
+  EXPECT_NEAR(result.residualQuantity, 1.0, 1e-9);
+  EXPECT_NEAR(executor.getOpenExposure("BTC-USD"), 1.0, 1e-9);
+
+  int callsBefore = calls.load();
+  auto blocked = executor.execute(makeOpportunity());
+  EXPECT_NE(blocked.error.find("exposure"), std::string::npos);
+  EXPECT_EQ(calls.load(), callsBefore);
+
+  // Flattening half keeps the symbol over the limit, the rest reopens it
+  executor.reduceOpenExposure("BTC-USD", 0.5);
+  EXPECT_NEAR(executor.getOpenExposure("BTC-USD"), 0.5, 1e-9);
+  blocked = executor.execute(makeOpportunity());
+  EXPECT_NE(blocked.error.find("exposure"), std::string::npos);
+
+  executor.reduceOpenExposure("BTC-USD", 2.0);
+  EXPECT_EQ(executor.getOpenExposure("BTC-USD"), 0.0);
+  auto resumed = executor.execute(makeOpportunity());
+  EXPECT_EQ(resumed.error.find("exposure"), std::string::npos);
+  EXPECT_GT(calls.load(), callsBefore);
+
+  executor.clearOpenExposure("BTC-USD");
+  EXPECT_EQ(executor.getOpenExposure("BTC-USD"), 0.0);
+}
+
+TEST_F(ArbitrageDetectorTest, UnlimitedExposureByDefault) {
+  ArbitrageExecutor executor(false);
+
+  // Buys fill and sells never do, leaving a residual each time
+  executor.setLegSubmitCallback([](const std::string&, const std::string&,
+                                   OrderSide side, double price,
+                                   double quantity) {
+    return side == OrderSide::BUY ? LegFill{quantity, price} : LegFill{};
+  });
+
+  executor.execute(makeOpportunity());
+  auto second = executor.execute(makeOpportunity());
+  EXPECT_EQ(second.error.find("exposure limit"), std::string::npos);
+  EXPECT_NEAR(executor.getOpenExposure("BTC-USD"), 2.0, 1e-9);
+}
+
+TEST_F(ArbitrageDetectorTest, ThrowingUnwindIsRecordedAsExposure) {
+  ArbitrageExecutor executor(false);
+
+  // kraken rejects the sell; coinbase fills the buy then throws on unwind
+  executor.setLegSubmitCallback([](const std::string& venue,
+                                   const std::string&, OrderSide side,
+                                   double price, double quantity) {
+    if (venue != "coinbase") {
+      return LegFill{};
+    }
+    if (side == OrderSide::SELL) {
+      throw std::runtime_error("venue disconnected");
+    }
+    return LegFill{quantity, price};
+  });
+
+  ExecutionResult result;
+  EXPECT_NO_THROW(result = executor.execute(makeOpportunity()));
+  EXPECT_TRUE(result.buyFilled);
+  EXPECT_NEAR(result.residualQuantity, 1.0, 1e-9);
+  EXPECT_NEAR(executor.getOpenExposure("BTC-USD"), 1.0, 1e-9);
+}
+
 TEST_F(ArbitrageDetectorTest, OpportunityCallback) {
   auto cfg = makeConfig();
   ArbitrageDetector detector(cfg);
@@ -185,6 +370,194 @@ TEST_F(ArbitrageDetectorTest, NoOpportunityWhenSameVenue) {
   detector.stop();
 }
 
+TEST_F(ArbitrageDetectorTest, EmitsOnUpdatingThread) {
+  auto cfg = makeConfig();
+  ArbitrageDetector detector(cfg);
+
+  std::vector<ArbitrageOpportunity> received;
+  std::thread::id callbackThread;
+  detector.setOpportunityCallback([&](const ArbitrageOpportunity& opp) {
+    received.push_back(opp);
+    callbackThread = std::this_thread::get_id();
+  });
+  detector.start();
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  detector.updateVenueQuote("coinbase", "BTC-USD", 99.90, 1.0, 100.00, 1.0,
+                            now);
+  EXPECT_TRUE(received.empty());
+
+  // The crossing quote is evaluated before updateVenueQuote returns
+  detector.updateVenueQuote("kraken", "BTC-USD", 100.50, 1.0, 100.60, 1.0, now);
+  ASSERT_EQ(received.size(), 1u);
+  EXPECT_EQ(callbackThread, std::this_thread::get_id());
+  EXPECT_EQ(received[0].buyVenue, "coinbase");
+  EXPECT_EQ(received[0].sellVenue, "kraken");
+
+  // Once kraken stops crossing the opportunity is gone without a rescan
+  detector.updateVenueQuote("kraken", "BTC-USD", 99.95, 1.0, 100.05, 1.0, now);
+  EXPECT_EQ(received.size(), 1u);
+  EXPECT_TRUE(detector.getCurrentOpportunities().empty());
+
+  detector.stop();
+}
+
+TEST_F(ArbitrageDetectorTest, RanksVenuesAfterRepricing) {
+  auto cfg = makeConfig();
+  cfg.venues = {"coinbase", "kraken", "binance"};
+  cfg.venueFees.clear();
+  ArbitrageDetector detector(cfg);
+  detector.start();
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  detector.updateVenueQuote("coinbase", "BTC-USD", 99.90, 1.0, 100.00, 1.0,
+                            now);
+  detector.updateVenueQuote("kraken", "BTC-USD", 100.50, 1.0, 100.60, 1.0, now);
+  detector.updateVenueQuote("binance", "BTC-USD", 100.20, 1.0, 100.55, 1.0,
+                            now);
+
+  // coinbase's ask is crossed by both other venues' bids
+  auto opps = detector.getCurrentOpportunities();
+  ASSERT_EQ(opps.size(), 2u);
+  for (const auto& opp : opps) {
+    EXPECT_EQ(opp.buyVenue, "coinbase");
+  }
+
+  // binance becomes the cheapest ask and the only crossed one
+  detector.updateVenueQuote("binance", "BTC-USD", 99.70, 1.0, 99.80, 1.0, now);
+  detector.updateVenueQuote("coinbase", "BTC-USD", 99.90, 1.0, 100.60, 1.0,
+                            now);
+  opps = detector.getCurrentOpportunities();
+  ASSERT_EQ(opps.size(), 2u);
+  for (const auto& opp : opps) {
+    EXPECT_EQ(opp.buyVenue, "binance");
+  }
+
+  detector.stop();
+}
+
+namespace {
+ArbitrageConfig makeCycleConfig() {
+  ArbitrageConfig cfg;
+  cfg.minSpreadBps = 5.0;
+  cfg.maxStalenessNs = 5000000000ULL;
+  cfg.symbols = {"BTC-USD", "ETH-USD", "ETH-BTC"};
+  cfg.venues = {"coinbase", "kraken"};
+  return cfg;
+}
+
+// Consistent prices on coinbase: ETH-BTC = 3000 / 50000
+void quoteTriangle(CycleArbitrageDetector& detector, uint64_t now) {
+  detector.updateVenueQuote("coinbase", "BTC-USD", 50000.0, 2.0, 50001.0, 2.0,
+                            now);
+  detector.updateVenueQuote("coinbase", "ETH-USD", 3000.0, 20.0, 3000.5, 20.0,
+                            now);
+  detector.updateVenueQuote("coinbase", "ETH-BTC", 0.06, 20.0, 0.06001, 20.0,
+                            now);
+}
+} // namespace
+
+TEST_F(ArbitrageDetectorTest, FindsTriangularCycle) {
+  CycleArbitrageDetector detector(makeCycleConfig());
+  EXPECT_EQ(detector.getCurrencyCount(), 3u);
+  EXPECT_EQ(detector.getEdgeCount(), 12u);
+
+  std::vector<CycleOpportunity> received;
+  detector.setOpportunityCallback(
+      [&](const CycleOpportunity& opp) { received.push_back(opp); });
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  quoteTriangle(detector, now);
+  EXPECT_TRUE(received.empty());
+
+  // kraken pays too much BTC for ETH: USD -> ETH -> BTC -> USD returns
+  // 50000 * 0.0603 / 3000.5 - 1, about 48 bps
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0,
+                            now);
+  ASSERT_EQ(received.size(), 1u);
+  const auto& opp = received[0];
+  ASSERT_EQ(opp.legs.size(), 3u);
+  EXPECT_NEAR(opp.profitBps, (50000.0 * 0.0603 / 3000.5 - 1.0) * 10000.0,
+              1e-6);
+
+  bool sawKraken = false;
+  for (const auto& leg : opp.legs) {
+    if (leg.symbol == "ETH-BTC") {
+      EXPECT_EQ(leg.venue, "kraken");
+      EXPECT_EQ(leg.side, OrderSide::SELL);
+      sawKraken = true;
+    }
+  }
+  EXPECT_TRUE(sawKraken);
+
+  // kraken's 5 ETH bid is the binding size
+  double start = opp.maxStartQuantity;
+  double scale = 1.0;
+  for (const auto& leg : opp.legs) {
+    if (leg.symbol == "ETH-BTC") {
+      EXPECT_NEAR(start * scale, 5.0, 1e-6);
+    }
+    scale *= leg.rate;
+  }
+
+  EXPECT_EQ(detector.getCurrentOpportunities().size(), 1u);
+
+  // Back in line, the cycle is dropped
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.05999, 5.0, 0.06001, 5.0,
+                            now);
+  EXPECT_TRUE(detector.getCurrentOpportunities().empty());
+  EXPECT_EQ(received.size(), 1u);
+}
+
+TEST_F(ArbitrageDetectorTest, KnownCycleIsNotReported) {
+  CycleArbitrageDetector detector(makeCycleConfig());
+  std::vector<CycleOpportunity> received;
+  detector.setOpportunityCallback(
+      [&](const CycleOpportunity& opp) { received.push_back(opp); });
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  quoteTriangle(detector, now);
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0,
+                            now);
+  ASSERT_EQ(received.size(), 1u);
+
+  // Requoting the cycle's legs unchanged re-prices it without a report
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0,
+                            now);
+  quoteTriangle(detector, now);
+  EXPECT_EQ(received.size(), 1u);
+  EXPECT_EQ(detector.getTotalOpportunitiesDetected(), 1u);
+  EXPECT_EQ(detector.getCurrentOpportunities().size(), 1u);
+
+  // Once dropped, the same cycle paying again is new
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.05999, 5.0, 0.06001, 5.0,
+                            now);
+  detector.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0,
+                            now);
+  EXPECT_EQ(received.size(), 2u);
+  EXPECT_EQ(detector.getTotalOpportunitiesDetected(), 2u);
+}
+
+TEST_F(ArbitrageDetectorTest, CycleFeesAndStaleness) {
+  auto cfg = makeCycleConfig();
+  cfg.venueFees = {{"coinbase", 0.002}, {"kraken", 0.002}};
+  CycleArbitrageDetector withFees(cfg);
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  quoteTriangle(withFees, now);
+  withFees.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0,
+                            now);
+  // Three legs at 20 bps each cost more than the 48 bps edge
+  EXPECT_TRUE(withFees.getCurrentOpportunities().empty());
+
+  CycleArbitrageDetector stale(makeCycleConfig());
+  uint64_t old = now - 10000000000ULL;
+  quoteTriangle(stale, old);
+  stale.updateVenueQuote("kraken", "ETH-BTC", 0.0603, 5.0, 0.0604, 5.0, now);
+  EXPECT_TRUE(stale.getCurrentOpportunities().empty());
+  EXPECT_EQ(stale.getTotalOpportunitiesDetected(), 0u);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -1,10 +1,12 @@
 #include "../../core/utils/TimeUtils.h"
 #include "../../strategies/backtesting/BacktestEngine.h"
 
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
+#include <stdexcept>
 
 using namespace pinnacle::backtesting;
 using namespace pinnacle::utils;
@@ -162,6 +164,75 @@ TEST_F(HistoricalDataManagerTest, SyntheticDataGenerationTest) {
   EXPECT_TRUE(dataManager_->validateDataIntegrity());
 }
 
+TEST_F(HistoricalDataManagerTest, SharedDataRangeTest) {
+  createTestCSV("TESTCOIN", 10);
+
+  uint64_t baseTime = 1000000000000ULL;
+  ASSERT_TRUE(dataManager_->loadData("TESTCOIN", baseTime,
+                                     baseTime + 9000000000ULL));
+  auto data = dataManager_->getData();
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(data->size(), 10);
+
+  // A second manager replays seconds 3 to 6 of the same buffer
+  HistoricalDataManager other(testDataDir_ + "/unused");
+  ASSERT_TRUE(other.useData(data, baseTime + 3000000000ULL,
+                            baseTime + 6000000000ULL));
+  EXPECT_EQ(other.getDataPointCount(), 4);
+  EXPECT_EQ(other.getStartTime(), baseTime + 3000000000ULL);
+  EXPECT_EQ(other.getEndTime(), baseTime + 6000000000ULL);
+  EXPECT_EQ(other.getData(), data);
+
+  size_t count = 0;
+  while (other.hasMoreData()) {
+    auto point = other.getNextDataPoint();
+    EXPECT_EQ(point.timestamp, baseTime + (3 + count) * 1000000000ULL);
+    EXPECT_NEAR(point.spread, 0.1, 1e-9);
+    count++;
+  }
+  EXPECT_EQ(count, 4);
+
+  EXPECT_FALSE(other.useData(data, baseTime + 20000000000ULL,
+                             baseTime + 30000000000ULL));
+  EXPECT_FALSE(other.hasMoreData());
+}
+
+TEST(MarketDataBufferTest, SortsIntoColumns) {
+  std::vector<MarketDataPoint> points(3);
+  for (size_t i = 0; i < points.size(); ++i) {
+    points[i].timestamp = 300 - i * 100;
+    points[i].price = 10.0 + i;
+    points[i].bid = points[i].price - 0.5;
+    points[i].ask = points[i].price + 0.5;
+    points[i].volume = 1.0 + i;
+  }
+
+  auto buffer = MarketDataBuffer::create(points);
+  ASSERT_NE(buffer, nullptr);
+  ASSERT_EQ(buffer->size(), 3);
+  EXPECT_EQ(buffer->timestamps()[0], 100);
+  EXPECT_EQ(buffer->timestamps()[2], 300);
+  EXPECT_DOUBLE_EQ(buffer->prices()[0], 12.0);
+  EXPECT_DOUBLE_EQ(buffer->volumes()[2], 1.0);
+
+  auto point = buffer->at(1);
+  EXPECT_EQ(point.timestamp, 200);
+  EXPECT_DOUBLE_EQ(point.bid, 10.5);
+  EXPECT_DOUBLE_EQ(point.spread, 1.0);
+
+  EXPECT_EQ(buffer->lowerBound(150), 1);
+  EXPECT_EQ(buffer->lowerBound(200), 1);
+  EXPECT_EQ(buffer->upperBound(200), 2);
+  EXPECT_EQ(buffer->upperBound(50), 0);
+  EXPECT_EQ(buffer->lowerBound(400), 3);
+  EXPECT_GE(buffer->mappedSize(), 3 * 5 * sizeof(double));
+
+  auto empty = MarketDataBuffer::create({});
+  ASSERT_NE(empty, nullptr);
+  EXPECT_TRUE(empty->empty());
+  EXPECT_EQ(empty->lowerBound(100), 0);
+}
+
 // PerformanceAnalyzer Tests
 class PerformanceAnalyzerTest : public ::testing::Test {
 protected:
@@ -239,6 +310,65 @@ TEST_F(PerformanceAnalyzerTest, RiskMetricsTest) {
   EXPECT_GE(stats.valueAtRisk99, 0.0);
 }
 
+TEST_F(PerformanceAnalyzerTest, RunningStatisticsMatchHistoryTest) {
+  // A window of 50 returns, slid through many times over
+  PerformanceAnalyzer analyzer(50);
+  std::vector<double> balances;
+  double balance = 100000.0;
+  for (size_t i = 0; i < 5003; ++i) {
+    double pnl = std::sin(i * 0.7) * 40.0 + (i % 9 == 0 ? -60.0 : 5.0);
+    balance += pnl;
+    balances.push_back(balance);
+    analyzer.recordTrade(createTestTrade(1000 + i, pnl, 10.0, balance));
+  }
+
+  auto ratios = [&balances](size_t first, double& sharpe, double& sortino) {
+    std::vector<double> returns;
+    for (size_t i = first + 1; i < balances.size(); ++i) {
+      returns.push_back((balances[i] - balances[i - 1]) / balances[i - 1]);
+    }
+    double mean = 0.0;
+    for (double r : returns) {
+      mean += r;
+    }
+    mean /= returns.size();
+    double variance = 0.0;
+    double downside = 0.0;
+    for (double r : returns) {
+      variance += (r - mean) * (r - mean);
+      downside += r < 0.0 ? r * r : 0.0;
+    }
+    sharpe = mean / std::sqrt(variance / (returns.size() - 1));
+    sortino = mean / std::sqrt(downside / returns.size());
+  };
+
+  double sharpe = 0.0;
+  double sortino = 0.0;
+  ratios(0, sharpe, sortino);
+  auto stats = analyzer.calculateStatistics();
+  EXPECT_NEAR(stats.sharpeRatio, sharpe, 1e-9);
+  EXPECT_NEAR(stats.sortinoRatio, sortino, 1e-9);
+
+  ratios(balances.size() - 51, sharpe, sortino);
+  EXPECT_NEAR(stats.rollingSharpeRatio, sharpe, 1e-9);
+  EXPECT_NEAR(stats.rollingSortinoRatio, sortino, 1e-9);
+
+  double peak = balances[0];
+  double maxDrawdown = 0.0;
+  for (double b : balances) {
+    peak = std::max(peak, b);
+    maxDrawdown = std::max(maxDrawdown, (peak - b) / peak);
+  }
+  EXPECT_DOUBLE_EQ(stats.maxDrawdown, maxDrawdown);
+  EXPECT_EQ(stats.totalTrades, 5003);
+  EXPECT_EQ(stats.startTime, 1000);
+  EXPECT_EQ(stats.endTime, 1000 + 5002);
+
+  analyzer.reset();
+  EXPECT_EQ(analyzer.calculateStatistics().totalTrades, 0);
+  EXPECT_DOUBLE_EQ(analyzer.calculateRollingSharpeRatio(), 0.0);
+}
+
 TEST_F(PerformanceAnalyzerTest, EmptyDataTest) {
   auto stats = analyzer_->calculateStatistics();
 
@@ -450,6 +580,101 @@ TEST_F(BacktestRunnerTest, MonteCarloAnalysisTest) {
   }
 }
 
+TEST_F(BacktestRunnerTest, ParallelBatchKeepsOrderTest) {
+  BacktestRunner runner(4);
+  EXPECT_EQ(runner.getThreadCount(), 4);
+
+  std::vector<std::pair<std::string, BacktestConfiguration>> configs;
+  for (int i = 0; i < 12; ++i) {
+    BacktestConfiguration config = baseConfig_;
+    config.tradingFee = 0.001 * (i + 1);
+    configs.emplace_back("run/" + std::to_string(i), config);
+  }
+
+  std::vector<size_t> completions;
+  runner.setResultCallback(
+      [&](const BacktestRunner::BatchResult& result, size_t completed,
+          size_t total) {
+        EXPECT_FALSE(result.configName.empty());
+        EXPECT_EQ(total, configs.size());
+        completions.push_back(completed);
+      });
+
+  auto results = runner.runBatchBacktests(configs, "TESTCOIN");
+
+  ASSERT_EQ(results.size(), configs.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].configName, configs[i].first);
+    EXPECT_DOUBLE_EQ(results[i].config.tradingFee,
+                     configs[i].second.tradingFee);
+    EXPECT_EQ(results[i].config.outputDirectory, baseConfig_.outputDirectory);
+    EXPECT_TRUE(results[i].successful) << results[i].error;
+  }
+
+  // Every result was reported once, one at a time
+  ASSERT_EQ(completions.size(), configs.size());
+  for (size_t i = 0; i < completions.size(); ++i) {
+    EXPECT_EQ(completions[i], i + 1);
+  }
+
+  // Each run wrote its results to its own directory
+  for (size_t i = 0; i < configs.size(); ++i) {
+    std::string path = baseConfig_.outputDirectory + "/runs/" +
+                       std::to_string(i) + "_run_" + std::to_string(i) +
+                       "/backtest_results.json";
+    EXPECT_TRUE(std::filesystem::exists(path)) << path;
+  }
+}
+
+TEST_F(BacktestRunnerTest, ThrowingResultCallbackTest) {
+  BacktestRunner runner(2);
+
+  std::vector<std::pair<std::string, BacktestConfiguration>> configs;
+  for (int i = 0; i < 3; ++i) {
+    configs.emplace_back("throw/" + std::to_string(i), baseConfig_);
+  }
+
+  // Throwing on the last result too must not leave the batch waiting
+  size_t calls = 0;
+  runner.setResultCallback([&](const BacktestRunner::BatchResult&, size_t,
+                               size_t) {
+    ++calls;
+    throw std::runtime_error("callback failure");
+  });
+
+  auto results = runner.runBatchBacktests(configs, "TESTCOIN");
+  ASSERT_EQ(results.size(), configs.size());
+  EXPECT_EQ(calls, configs.size());
+  for (const auto& result : results) {
+    EXPECT_TRUE(result.successful) << result.error;
+  }
+}
+
+TEST_F(BacktestEngineTest, SharedMarketDataTest) {
+  // Shared data replaces the data directory, which would otherwise have
+  // synthetic data generated for this symbol
+  std::vector<MarketDataPoint> points(5);
+  for (size_t i = 0; i < points.size(); ++i) {
+    points[i].timestamp = config_.endTimestamp + (i + 1) * 1000000000ULL;
+    points[i].price = 100.0;
+    points[i].bid = 99.9;
+    points[i].ask = 100.1;
+  }
+  auto outOfRange = MarketDataBuffer::create(points);
+  engine_->setMarketData(outOfRange);
+  ASSERT_TRUE(engine_->initialize());
+  EXPECT_FALSE(engine_->runBacktest("NODATA"));
+
+  auto data = BacktestRunner::loadMarketData(config_.outputDirectory + "/data",
+                                             "NODATA", config_.startTimestamp,
+                                             config_.endTimestamp);
+  ASSERT_NE(data, nullptr);
+  EXPECT_GT(data->size(), 0);
+  engine_->setMarketData(data);
+  EXPECT_TRUE(engine_->runBacktest("NODATA"));
+  EXPECT_DOUBLE_EQ(engine_->getProgress(), 1.0);
+}
+
 // Integration Tests
 TEST_F(BacktestEngineTest, StrategyComparisonTest) {
   createTestDataFile("TESTCOIN", 50);
@@ -501,6 +726,24 @@ TEST_F(BacktestEngineTest, StopBacktestTest) {
   EXPECT_LT(engine_->getProgress(), 1.0);
 }
 
+TEST_F(BacktestEngineTest, CheckpointStopsBacktestTest) {
+  createTestDataFile("TESTCOIN", 3000);
+  EXPECT_TRUE(engine_->initialize());
+
+  std::vector<double> checkpoints;
+  engine_->setCheckpointCallback(
+      [&checkpoints](double progress, const PerformanceSnapshot&) {
+        checkpoints.push_back(progress);
+        return false;
+      });
+  EXPECT_TRUE(engine_->runBacktest("TESTCOIN"));
+
+  ASSERT_EQ(checkpoints.size(), 1u);
+  EXPECT_GT(checkpoints[0], 0.0);
+  EXPECT_LT(checkpoints[0], 1.0);
+  EXPECT_LT(engine_->getProgress(), 1.0);
+}
+
 // Edge Cases and Error Handling
 TEST_F(BacktestEngineTest, InvalidDataTest) {
   // Don't create any data file
@@ -0,0 +1,342 @@
+#include "../../exchange/capture/CaptureReader.h"
+#include "../../exchange/capture/CaptureRecorder.h"
+#include "../../exchange/capture/ReplayMarketDataFeed.h"
+#include "../../strategies/backtesting/BacktestEngine.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle::exchange;
+using namespace pinnacle::exchange::capture;
+
+namespace {
+
+constexpr uint64_t MS = 1'000'000;
+
+// Legacy Coinbase ticker, small enough to build per test
+std::string ticker(const std::string& symbol, int price) {
+  return R"({"type":"ticker","product_id":")" + symbol +
+         R"(","price":")" + std::to_string(price) + R"(","best_bid":")" +
+         std::to_string(price - 1) + R"(","best_ask":")" +
+         std::to_string(price + 1) + R"(","last_size":"0.5"})";
+}
+
+std::string l2update(const std::string& symbol) {
+  return R"({"type":"l2update","product_id":")" + symbol +
+         R"(","changes":[["buy","99.5","2"],["sell","100.5","0"]]})";
+}
+
+class CaptureReplayTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    m_dir = std::filesystem::temp_directory_path() /
+            ("pinnaclemm_capture_test_" +
+             std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+             "_" + ::testing::UnitTest::GetInstance()
+                       ->current_test_info()
+                       ->name());
+    std::filesystem::remove_all(m_dir);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(m_dir); }
+
+  CaptureConfig config() const {
+    CaptureConfig config;
+    config.directory = m_dir.string();
+    config.prefix = "test";
+    config.source = "coinbase";
+    // Frames are recorded far faster than their timestamps advance, so
+    // leave the writer enough chunks to keep up
+    config.chunkBuffers = 64;
+    config.flushIntervalNs = 3600'000 * MS;
+    return config;
+  }
+
+  // Record frames at 10ms intervals starting at baseTime
+  std::vector<std::string> record(const std::vector<std::string>& frames,
+                                  CaptureConfig cfg, uint64_t baseTime) {
+    CaptureRecorder recorder(cfg);
+    EXPECT_TRUE(recorder.start());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      EXPECT_TRUE(recorder.record(frames[i], baseTime + i * 10 * MS));
+    }
+    recorder.stop();
+    EXPECT_EQ(recorder.getFramesDropped(), 0u);
+    return recorder.getFilesWritten();
+  }
+
+  std::filesystem::path m_dir;
+};
+
+} // namespace
+
+TEST_F(CaptureReplayTest, RoundTripsFramesAndTimestamps) {
+  std::vector<std::string> frames;
+  for (int i = 0; i < 1000; ++i) {
+    frames.push_back(i % 3 == 0 ? l2update("ETH-USD")
+                                : ticker("BTC-USD", 50000 + i));
+  }
+  frames.push_back(""); // Empty frames survive too
+
+  auto files = record(frames, config(), 1'700'000'000'000'000'000ULL);
+  ASSERT_EQ(files.size(), 1u);
+  EXPECT_EQ(CaptureReader::listCaptures(m_dir.string()), files);
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(files[0]));
+  EXPECT_STREQ(reader.getHeader().source, "coinbase");
+
+  CapturedFrame frame;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_TRUE(reader.next(frame)) << "frame " << i;
+    EXPECT_EQ(frame.data, frames[i]);
+    EXPECT_EQ(frame.receivedAt, 1'700'000'000'000'000'000ULL + i * 10 * MS);
+  }
+  EXPECT_FALSE(reader.next(frame));
+  EXPECT_FALSE(reader.isTruncated());
+
+  reader.rewind();
+  ASSERT_TRUE(reader.next(frame));
+  EXPECT_EQ(frame.data, frames[0]);
+}
+
+TEST_F(CaptureReplayTest, SealsChunksByIntervalAndRotatesFiles) {
+  std::vector<std::string> frames(500, ticker("BTC-USD", 50000));
+
+  auto cfg = config();
+  cfg.chunkBytes = 4096;
+  cfg.flushIntervalNs = 100 * MS; // Every 11 frames at 10ms apart
+  cfg.maxFileBytes = 8192;
+  cfg.compressionLevel = 0;
+  auto files = record(frames, cfg, 1'000 * MS);
+  ASSERT_GT(files.size(), 1u);
+
+  size_t total = 0;
+  CaptureReader reader;
+  CapturedFrame frame;
+  for (const auto& file : files) {
+    EXPECT_LE(std::filesystem::file_size(file), cfg.maxFileBytes);
+    ASSERT_TRUE(reader.open(file));
+    while (reader.next(frame)) {
+      EXPECT_EQ(frame.data, frames[total]);
+      ++total;
+    }
+  }
+  EXPECT_EQ(total, frames.size());
+}
+
+TEST_F(CaptureReplayTest, CountsFramesLostToFailedWrites) {
+  auto cfg = config();
+  CaptureRecorder recorder(cfg);
+  ASSERT_TRUE(recorder.start());
+
+  // A file where the directory was leaves nowhere to open a capture
+  std::filesystem::remove_all(m_dir);
+  { std::ofstream blocker(m_dir); }
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(recorder.record(ticker("BTC-USD", 50000), i * MS));
+  }
+  recorder.flush();
+  EXPECT_TRUE(recorder.record(ticker("BTC-USD", 50000), 100 * MS));
+  recorder.stop();
+
+  EXPECT_EQ(recorder.getFramesRecorded(), 0u);
+  EXPECT_EQ(recorder.getFramesDropped(), 101u);
+  EXPECT_TRUE(recorder.getFilesWritten().empty());
+}
+
+TEST_F(CaptureReplayTest, StopsWhileTheFeedIsRecording) {
+  CaptureRecorder recorder(config());
+  ASSERT_TRUE(recorder.start());
+
+  std::atomic<uint64_t> accepted{0};
+  std::atomic<bool> started{false};
+  std::thread feed([&] {
+    std::string frame = ticker("BTC-USD", 50000);
+    for (uint64_t i = 0;; ++i) {
+      if (recorder.record(frame, i * MS)) {
+        accepted.fetch_add(1);
+      } else if (!recorder.isRunning()) {
+        return;
+      }
+      if (i % 64 == 0) {
+        recorder.flush(); // From the feed thread and the test thread alike
+      }
+      started.store(true);
+    }
+  });
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  recorder.flush();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  recorder.stop();
+  feed.join();
+
+  EXPECT_GT(accepted.load(), 0u);
+  EXPECT_EQ(recorder.getFramesRecorded(), accepted.load());
+
+  uint64_t read = 0;
+  CaptureReader reader;
+  CapturedFrame frame;
+  for (const auto& file : recorder.getFilesWritten()) {
+    ASSERT_TRUE(reader.open(file));
+    while (reader.next(frame)) {
+      ++read;
+    }
+  }
+  EXPECT_EQ(read, accepted.load());
+}
+
+TEST_F(CaptureReplayTest, CompressesRepetitiveFrames) {
+  std::vector<std::string> frames(2000, ticker("BTC-USD", 50000));
+  size_t rawBytes = 0;
+  for (const auto& frame : frames) {
+    rawBytes += frame.size();
+  }
+
+  auto files = record(frames, config(), 0);
+  ASSERT_EQ(files.size(), 1u);
+#ifdef HAVE_ZLIB
+  EXPECT_LT(std::filesystem::file_size(files[0]), rawBytes / 4);
+#else
+  EXPECT_GT(std::filesystem::file_size(files[0]), rawBytes);
+#endif
+}
+
+TEST_F(CaptureReplayTest, StopsAtTruncatedTail) {
+  auto cfg = config();
+  cfg.chunkBytes = 1024;
+  std::vector<std::string> frames(300, ticker("BTC-USD", 50000));
+  auto files = record(frames, cfg, 0);
+  ASSERT_EQ(files.size(), 1u);
+
+  // Simulate a recorder killed mid-write
+  auto size = std::filesystem::file_size(files[0]);
+  std::filesystem::resize_file(files[0], size - 100);
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(files[0]));
+  CapturedFrame frame;
+  size_t read = 0;
+  while (reader.next(frame)) {
+    EXPECT_EQ(frame.data, frames[read]);
+    ++read;
+  }
+  EXPECT_TRUE(reader.isTruncated());
+  EXPECT_GT(read, 0u);
+  EXPECT_LT(read, frames.size());
+}
+
+TEST_F(CaptureReplayTest, RejectsFilesThatAreNotCaptures) {
+  std::filesystem::create_directories(m_dir);
+  auto path = (m_dir / "bogus.pmcap").string();
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fputs("this is not a capture file, just some text long enough", file);
+  std::fclose(file);
+
+  CaptureReader reader;
+  EXPECT_FALSE(reader.open(path));
+  EXPECT_FALSE(reader.open((m_dir / "missing.pmcap").string()));
+}
+
+TEST_F(CaptureReplayTest, ReplayDecodesIntoSubscribers) {
+  std::vector<std::string> frames = {ticker("BTC-USD", 50000),
+                                     l2update("BTC-USD"),
+                                     ticker("ETH-USD", 3000),
+                                     ticker("BTC-USD", 50010)};
+  auto files = record(frames, config(), 5'000 * MS);
+
+  ReplayMarketDataFeed feed(files, ReplayMarketDataFeed::MAX_SPEED);
+  std::vector<MarketUpdate> updates;
+  std::vector<OrderBookUpdate> books;
+  feed.subscribeToMarketUpdates(
+      "BTC-USD", [&](const MarketUpdate& u) { updates.push_back(u); });
+  feed.subscribeToOrderBookUpdates(
+      "BTC-USD", [&](const OrderBookUpdate& u) { books.push_back(u); });
+
+  EXPECT_EQ(feed.replayAll(), frames.size());
+  ASSERT_EQ(updates.size(), 2u);
+  EXPECT_DOUBLE_EQ(updates[0].price, 50000.0);
+  EXPECT_DOUBLE_EQ(updates[0].bidPrice, 49999.0);
+  EXPECT_EQ(updates[0].timestamp, 5'000 * MS);
+  EXPECT_DOUBLE_EQ(updates[1].price, 50010.0);
+  EXPECT_EQ(updates[1].timestamp, 5'030 * MS);
+
+  ASSERT_EQ(books.size(), 1u);
+  ASSERT_EQ(books[0].bids.size(), 1u);
+  EXPECT_DOUBLE_EQ(books[0].bids[0].first, 99.5);
+  EXPECT_EQ(books[0].timestamp, 5'010 * MS);
+}
+
+TEST_F(CaptureReplayTest, PacesReplayBySpeed) {
+  // 20 frames spanning 190ms of receive time
+  std::vector<std::string> frames(20, ticker("BTC-USD", 50000));
+  auto files = record(frames, config(), 0);
+
+  auto replayFor = [&](double speed) {
+    ReplayMarketDataFeed feed(files, speed);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(feed.start());
+    while (!feed.isFinished() &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(feed.isFinished());
+    EXPECT_EQ(feed.getFramesReplayed(), frames.size());
+    feed.stop();
+    return elapsed;
+  };
+
+  EXPECT_GE(replayFor(1.0), std::chrono::milliseconds(190));
+  EXPECT_GE(replayFor(4.0), std::chrono::milliseconds(47));
+  EXPECT_LT(replayFor(ReplayMarketDataFeed::MAX_SPEED),
+            std::chrono::milliseconds(190));
+}
+
+TEST_F(CaptureReplayTest, StopInterruptsPacedReplay) {
+  std::vector<std::string> frames = {ticker("BTC-USD", 1),
+                                     ticker("BTC-USD", 2)};
+  CaptureRecorder recorder(config());
+  ASSERT_TRUE(recorder.start());
+  recorder.record(frames[0], 0);
+  recorder.record(frames[1], 3600'000 * MS); // An hour later
+  recorder.stop();
+
+  ReplayMarketDataFeed feed(recorder.getFilesWritten(), 1.0);
+  ASSERT_TRUE(feed.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(feed.stop());
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::seconds(1));
+  EXPECT_EQ(feed.getFramesReplayed(), 1u);
+  EXPECT_FALSE(feed.isFinished());
+}
+
+TEST_F(CaptureReplayTest, BacktesterLoadsCaptures) {
+  std::vector<std::string> frames;
+  for (int i = 0; i < 50; ++i) {
+    frames.push_back(ticker("BTC-USD", 50000 + i));
+    frames.push_back(ticker("ETH-USD", 3000 + i));
+  }
+  record(frames, config(), 1'000 * MS);
+
+  pinnacle::backtesting::HistoricalDataManager data(m_dir.string());
+  // Frames 20..79 by receive time, of which every other is BTC-USD
+  ASSERT_TRUE(data.loadData("BTC-USD", 1'200 * MS, 1'790 * MS));
+  EXPECT_EQ(data.getDataPointCount(), 30u);
+  auto first = data.getNextDataPoint();
+  EXPECT_DOUBLE_EQ(first.price, 50010.0);
+  EXPECT_DOUBLE_EQ(first.spread, 2.0);
+  EXPECT_EQ(first.timestamp, 1'200 * MS);
+}
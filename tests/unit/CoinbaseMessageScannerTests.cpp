@@ -0,0 +1,254 @@
+#include "../../exchange/connector/CoinbaseMessageScanner.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pinnacle::exchange;
+
+namespace {
+
+struct RecordedTicker {
+  std::string symbol;
+  int64_t price, size, bidPrice, bidSize, askPrice, askSize;
+};
+
+struct RecordedDelta {
+  std::string symbol;
+  bool isBid;
+  int64_t price, quantity;
+};
+
+class RecordingHandler : public CoinbaseScanHandler {
+public:
+  std::vector<RecordedTicker> tickers;
+  std::vector<RecordedDelta> deltas;
+  std::vector<std::string> events; // "begin:<symbol>:<type>" / "end:..."
+
+  void onTicker(const FixedPointTicker& t) override {
+    tickers.push_back({std::string(t.symbol), t.price, t.size, t.bidPrice,
+                       t.bidSize, t.askPrice, t.askSize});
+  }
+
+  void onBookEventBegin(std::string_view symbol, BookEventType type) override {
+    events.push_back("begin:" + std::string(symbol) + ":" + name(type));
+  }
+
+  void onBookDelta(const BookDelta& d) override {
+    deltas.push_back({std::string(d.symbol), d.isBid, d.price, d.quantity});
+  }
+
+  void onBookEventEnd(std::string_view symbol, BookEventType type) override {
+    events.push_back("end:" + std::string(symbol) + ":" + name(type));
+  }
+
+private:
+  static std::string name(BookEventType type) {
+    return type == BookEventType::SNAPSHOT ? "snapshot" : "update";
+  }
+};
+
+constexpr int64_t fp(double v) {
+  return static_cast<int64_t>(v * FIXED_POINT_SCALE + (v < 0 ? -0.5 : 0.5));
+}
+
+} // namespace
+
+TEST(CoinbaseMessageScannerTest, ParsesFixedPoint) {
+  int64_t v = 0;
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("109231.23", v));
+  EXPECT_EQ(v, 10923123000000);
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("0.00000001", v));
+  EXPECT_EQ(v, 1);
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("-2.5", v));
+  EXPECT_EQ(v, -250000000);
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("42", v));
+  EXPECT_EQ(v, 4200000000);
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint(".5", v));
+  EXPECT_EQ(v, 50000000);
+  // Digits past 1e-8 are truncated
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("1.123456789", v));
+  EXPECT_EQ(v, 112345678);
+  EXPECT_TRUE(CoinbaseMessageScanner::parseFixedPoint("1.5e-3", v));
+  EXPECT_EQ(v, 150000);
+
+  EXPECT_FALSE(CoinbaseMessageScanner::parseFixedPoint("", v));
+  EXPECT_FALSE(CoinbaseMessageScanner::parseFixedPoint("-", v));
+  EXPECT_FALSE(CoinbaseMessageScanner::parseFixedPoint("1.2.3", v));
+  EXPECT_FALSE(CoinbaseMessageScanner::parseFixedPoint("abc", v));
+  EXPECT_FALSE(
+      CoinbaseMessageScanner::parseFixedPoint("99999999999999999999", v));
+}
+
+TEST(CoinbaseMessageScannerTest, ScansAdvancedTradeTicker) {
+  const std::string frame =
+      R"({"channel":"ticker","client_id":"",)"
+      R"("timestamp":"2025-09-01T20:17:57Z",)"
+      R"("sequence_num":7,"events":[{"type":"update","tickers":[)"
+      R"({"type":"ticker","product_id":"BTC-USD","price":"109231.23",)"
+      R"("volume_24_h":"4554.12345678","low_24_h":"107800",)"
+      R"("high_24_h":"110000",)"
+      R"("price_percent_chg_24_h":"-1.2","best_bid":"109230.50",)"
+      R"("best_bid_quantity":"0.5","best_ask":"109231.75",)"
+      R"("best_ask_quantity":"0.25"},)"
+      R"({"type":"ticker","product_id":"ETH-USD","price":"3000.1",)"
+      R"("best_bid":"3000","best_ask":"3000.2"}]}]})";
+
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+  EXPECT_EQ(scanner.scan(frame, handler), CoinbaseMessageKind::TICKER);
+
+  ASSERT_EQ(handler.tickers.size(), 2u);
+  const auto& btc = handler.tickers[0];
+  EXPECT_EQ(btc.symbol, "BTC-USD");
+  EXPECT_EQ(btc.price, fp(109231.23));
+  EXPECT_EQ(btc.size, 455412345678); // volume_24_h without last_size
+  EXPECT_EQ(btc.bidPrice, fp(109230.50));
+  EXPECT_EQ(btc.bidSize, fp(0.5));
+  EXPECT_EQ(btc.askPrice, fp(109231.75));
+  EXPECT_EQ(btc.askSize, fp(0.25));
+  EXPECT_EQ(handler.tickers[1].symbol, "ETH-USD");
+  EXPECT_EQ(handler.tickers[1].askPrice, fp(3000.2));
+  EXPECT_EQ(handler.tickers[1].size, 0);
+  EXPECT_EQ(scanner.getBytesScanned(), frame.size());
+}
+
+TEST(CoinbaseMessageScannerTest, ScansLevel2Events) {
+  const std::string frame =
+      R"({"channel":"l2_data","client_id":"",)"
+      R"("timestamp":"2025-09-01T20:17:57Z",)"
+      R"("sequence_num":3,"events":[)"
+      R"({"type":"snapshot","product_id":"BTC-USD","updates":[)"
+      R"({"side":"bid","event_time":"1970-01-01T00:00:00Z",)"
+      R"("price_level":"100.5","new_quantity":"2"}]},)"
+      R"({"type":"update","product_id":"BTC-USD","updates":[)"
+      R"({"side":"bid","event_time":"2025-09-01T20:17:57Z",)"
+      R"("price_level":"100.25","new_quantity":"0"},)"
+      R"({"side":"offer","event_time":"2025-09-01T20:17:57Z",)"
+      R"("price_level":"101","new_quantity":"1.75"}]}]})";
+
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+  EXPECT_EQ(scanner.scan(frame, handler), CoinbaseMessageKind::LEVEL2);
+
+  std::vector<std::string> expectedEvents = {
+      "begin:BTC-USD:snapshot", "end:BTC-USD:snapshot", "begin:BTC-USD:update",
+      "end:BTC-USD:update"};
+  EXPECT_EQ(handler.events, expectedEvents);
+
+  ASSERT_EQ(handler.deltas.size(), 3u);
+  EXPECT_TRUE(handler.deltas[0].isBid);
+  EXPECT_EQ(handler.deltas[0].price, fp(100.5));
+  EXPECT_EQ(handler.deltas[0].quantity, fp(2.0));
+  EXPECT_TRUE(handler.deltas[1].isBid);
+  EXPECT_EQ(handler.deltas[1].quantity, 0);
+  EXPECT_FALSE(handler.deltas[2].isBid);
+  EXPECT_EQ(handler.deltas[2].price, fp(101.0));
+  EXPECT_EQ(handler.deltas[2].quantity, fp(1.75));
+}
+
+TEST(CoinbaseMessageScannerTest, HandlesMembersInAnyOrder) {
+  // Events before channel, and updates before product_id and type
+  const std::string frame =
+      R"({"events":[{"updates":[{"new_quantity":"3","price_level":"99",)"
+      R"("side":"offer"}],"product_id":"SOL-USD","type":"update"}],)"
+      R"( "sequence_num" : 1 , "channel" : "level2" })";
+
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+  EXPECT_EQ(scanner.scan(frame, handler), CoinbaseMessageKind::LEVEL2);
+  ASSERT_EQ(handler.deltas.size(), 1u);
+  EXPECT_EQ(handler.deltas[0].symbol, "SOL-USD");
+  EXPECT_FALSE(handler.deltas[0].isBid);
+  EXPECT_EQ(handler.deltas[0].price, fp(99.0));
+  EXPECT_EQ(handler.deltas[0].quantity, fp(3.0));
+}
+
+TEST(CoinbaseMessageScannerTest, ScansLegacyMessages) {
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+
+  EXPECT_EQ(
+      scanner.scan(
+          R"({"type":"ticker","sequence":1,"product_id":"BTC-USD",)"
+          R"("price":"50000.5","best_bid":"50000","best_ask":"50001",)"
+          R"("side":"buy","trade_id":987654321,"last_size":"0.02345678"})",
+          handler),
+      CoinbaseMessageKind::TICKER);
+  ASSERT_EQ(handler.tickers.size(), 1u);
+  EXPECT_EQ(handler.tickers[0].price, fp(50000.5));
+  EXPECT_EQ(handler.tickers[0].size, 2345678);
+
+  EXPECT_EQ(scanner.scan(R"({"type":"l2update","product_id":"ETH-USD",)"
+                         R"("changes":[["buy","3000.10","1.5"],)"
+                         R"(["sell","3000.20","0"]],"time":"x"})",
+                         handler),
+            CoinbaseMessageKind::LEVEL2);
+  ASSERT_EQ(handler.deltas.size(), 2u);
+  EXPECT_TRUE(handler.deltas[0].isBid);
+  EXPECT_EQ(handler.deltas[0].price, fp(3000.10));
+  EXPECT_FALSE(handler.deltas[1].isBid);
+  EXPECT_EQ(handler.deltas[1].quantity, 0);
+}
+
+TEST(CoinbaseMessageScannerTest, ClassifiesControlMessages) {
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+
+  EXPECT_EQ(scanner.scan(R"({"channel":"heartbeats","events":[)"
+                         R"({"current_time":"t","heartbeat_counter":3}]})",
+                         handler),
+            CoinbaseMessageKind::HEARTBEAT);
+  EXPECT_EQ(scanner.scan(R"({"channel":"subscriptions","events":[)"
+                         R"({"subscriptions":{"ticker":["BTC-USD"]}}]})",
+                         handler),
+            CoinbaseMessageKind::SUBSCRIPTIONS);
+  EXPECT_EQ(scanner.scan(R"({"type":"error","message":"bad \"auth\""})",
+                         handler),
+            CoinbaseMessageKind::ERROR);
+  EXPECT_EQ(scanner.scan(R"({"channel":"market_trades","events":[]})",
+                         handler),
+            CoinbaseMessageKind::OTHER);
+  EXPECT_TRUE(handler.tickers.empty());
+  EXPECT_TRUE(handler.deltas.empty());
+}
+
+TEST(CoinbaseMessageScannerTest, RejectsMalformedFrames) {
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+
+  const std::vector<std::string> frames = {
+      "",
+      "not json",
+      R"({"channel":"ticker","events":[{"tickers":[{"product_id":"BTC-USD")",
+      R"({"channel":"l2_data","events":[{"type":"update","product_id":"X",)"
+      R"("updates":[{"side":"bid","price_level":"1","new_quantity":"1"},]}]})",
+      R"({"type":"ticker","product_id":"BTC-USD"} trailing)",
+      R"({"type":"ticker","product_id":"BTC-USD)"};
+
+  for (const auto& frame : frames) {
+    EXPECT_EQ(scanner.scan(frame, handler), CoinbaseMessageKind::MALFORMED)
+        << frame;
+  }
+  EXPECT_EQ(scanner.getMalformedMessages(), frames.size());
+  EXPECT_TRUE(handler.tickers.empty());
+  // The event whose array broke was never closed
+  for (const auto& event : handler.events) {
+    EXPECT_NE(event.rfind("end:", 0), 0u) << event;
+  }
+}
+
+TEST(CoinbaseMessageScannerTest, NonNumericFieldsAreAbsent) {
+  CoinbaseMessageScanner scanner;
+  RecordingHandler handler;
+  EXPECT_EQ(scanner.scan(R"({"channel":"ticker","events":[{"tickers":[)"
+                         R"({"product_id":"BTC-USD","price":"",)"
+                         R"("best_bid":null,)"
+                         R"("best_ask":"10.5"}]}]})",
+                         handler),
+            CoinbaseMessageKind::TICKER);
+  ASSERT_EQ(handler.tickers.size(), 1u);
+  EXPECT_EQ(handler.tickers[0].price, 0);
+  EXPECT_EQ(handler.tickers[0].bidPrice, 0);
+  EXPECT_EQ(handler.tickers[0].askPrice, fp(10.5));
+}
@@ -0,0 +1,212 @@
+#include "../../exchange/connector/ConflationStage.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace pinnacle::exchange;
+
+namespace {
+
+OrderBookUpdate bookUpdate(const std::string& symbol,
+                           std::vector<std::pair<double, double>> bids,
+                           std::vector<std::pair<double, double>> asks) {
+  OrderBookUpdate update;
+  update.symbol = symbol;
+  update.bids = std::move(bids);
+  update.asks = std::move(asks);
+  update.timestamp = 0;
+  return update;
+}
+
+MarketUpdate marketUpdate(double price, double volume, double bid,
+                          double ask, uint64_t timestamp) {
+  MarketUpdate update;
+  update.symbol = "BTC-USD";
+  update.price = price;
+  update.volume = volume;
+  update.timestamp = timestamp;
+  update.isBuy = true;
+  update.bidPrice = bid;
+  update.askPrice = ask;
+  return update;
+}
+
+} // namespace
+
+TEST(ConflationStageTest, MergesLevelsSinceLastRead) {
+  ConflationStage stage;
+  size_t btc = stage.addSymbol("BTC-USD");
+  auto consumer = stage.addConsumer();
+  ConflatedBook book;
+
+  EXPECT_FALSE(stage.isDirty(consumer, btc));
+  EXPECT_FALSE(stage.read(consumer, btc, book));
+
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{100.0, 1.0}}, {}));
+  stage.onOrderBookUpdate(
+      bookUpdate("BTC-USD", {{100.0, 2.0}, {99.0, 1.0}}, {{101.0, 3.0}}));
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{99.0, 0.0}}, {}));
+  EXPECT_TRUE(stage.isDirty(consumer, btc));
+
+  ASSERT_TRUE(stage.read(consumer, btc, book));
+  EXPECT_EQ(book.updates, 3u);
+  EXPECT_FALSE(book.reset);
+  // Latest quantity per level, best first, removals kept as zero
+  ASSERT_EQ(book.bids.size(), 2u);
+  EXPECT_EQ(book.bids[0], std::make_pair(100.0, 2.0));
+  EXPECT_EQ(book.bids[1], std::make_pair(99.0, 0.0));
+  ASSERT_EQ(book.asks.size(), 1u);
+  EXPECT_EQ(book.asks[0], std::make_pair(101.0, 3.0));
+  EXPECT_FALSE(stage.isDirty(consumer, btc));
+  EXPECT_EQ(stage.getUpdatesConflated(consumer), 2u);
+
+  // Only levels changed after the read come back next time
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {}, {{102.0, 1.0}}));
+  ASSERT_TRUE(stage.read(consumer, btc, book));
+  EXPECT_TRUE(book.bids.empty());
+  ASSERT_EQ(book.asks.size(), 1u);
+  EXPECT_EQ(book.asks[0].first, 102.0);
+}
+
+TEST(ConflationStageTest, CursorsAreIndependent) {
+  ConflationStage stage;
+  size_t btc = stage.addSymbol("BTC-USD");
+  auto fast = stage.addConsumer();
+  auto slow = stage.addConsumer();
+  ConflatedBook book;
+
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{100.0, 1.0}}, {}));
+  ASSERT_TRUE(stage.read(fast, btc, book));
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {}, {{101.0, 1.0}}));
+  ASSERT_TRUE(stage.read(fast, btc, book));
+  EXPECT_TRUE(book.bids.empty());
+
+  // The slow consumer still sees both changes in one read
+  ASSERT_TRUE(stage.read(slow, btc, book));
+  EXPECT_EQ(book.updates, 2u);
+  EXPECT_EQ(book.bids.size(), 1u);
+  EXPECT_EQ(book.asks.size(), 1u);
+  EXPECT_EQ(stage.getReads(fast), 2u);
+  EXPECT_EQ(stage.getReads(slow), 1u);
+}
+
+TEST(ConflationStageTest, TopOfBookAndTradedVolume) {
+  ConflationStage stage;
+  size_t btc = stage.addSymbol("BTC-USD");
+  auto consumer = stage.addConsumer();
+  ConflatedTopOfBook top;
+  ConflatedBook book;
+
+  EXPECT_FALSE(stage.readTopOfBook(btc, top));
+  stage.onMarketUpdate(marketUpdate(100.0, 0.5, 99.0, 101.0, 1));
+  stage.onMarketUpdate(marketUpdate(100.5, 0.25, 0.0, 0.0, 2));
+  stage.onMarketUpdate(marketUpdate(100.2, 0.0, 100.0, 100.4, 3));
+
+  ASSERT_TRUE(stage.readTopOfBook(btc, top));
+  EXPECT_DOUBLE_EQ(top.bidPrice, 100.0);
+  EXPECT_DOUBLE_EQ(top.askPrice, 100.4);
+  EXPECT_DOUBLE_EQ(top.lastPrice, 100.5); // Quote-only updates keep it
+  EXPECT_DOUBLE_EQ(top.cumulativeVolume, 0.75);
+  EXPECT_EQ(top.timestamp, 3u);
+
+  ASSERT_TRUE(stage.read(consumer, btc, book));
+  EXPECT_DOUBLE_EQ(book.tradedVolume, 0.75);
+  EXPECT_EQ(book.updates, 3u);
+  stage.onMarketUpdate(marketUpdate(100.3, 1.0, 100.0, 100.4, 4));
+  ASSERT_TRUE(stage.read(consumer, btc, book));
+  EXPECT_DOUBLE_EQ(book.tradedVolume, 1.0);
+}
+
+TEST(ConflationStageTest, NotifiesOncePerRead) {
+  ConflationStage stage;
+  size_t btc = stage.addSymbol("BTC-USD");
+  int notifications = 0;
+  auto consumer = stage.addConsumer([&]() { ++notifications; });
+  ConflatedBook book;
+
+  for (int i = 0; i < 10; ++i) {
+    stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{100.0 + i, 1.0}}, {}));
+  }
+  EXPECT_EQ(notifications, 1);
+
+  stage.read(consumer, btc, book);
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{90.0, 1.0}}, {}));
+  EXPECT_EQ(notifications, 2);
+
+  // Unknown symbols are ignored
+  stage.onOrderBookUpdate(bookUpdate("ETH-USD", {{1.0, 1.0}}, {}));
+  EXPECT_EQ(notifications, 2);
+  EXPECT_EQ(stage.getUpdatesPublished(), 11u);
+}
+
+TEST(ConflationStageTest, ResetAndOverflowTellLaggingConsumers) {
+  ConflationStage stage(100);
+  size_t btc = stage.addSymbol("BTC-USD");
+  auto fast = stage.addConsumer();
+  auto slow = stage.addConsumer();
+  ConflatedBook book;
+
+  // The fast consumer keeps the log pruned; the slow one lets it grow
+  for (int i = 0; i < 500; ++i) {
+    stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{1000.0 - i, 1.0}}, {}));
+    stage.read(fast, btc, book);
+    EXPECT_FALSE(book.reset);
+  }
+  EXPECT_GE(stage.getLogOverflows(), 1u);
+
+  ASSERT_TRUE(stage.read(slow, btc, book));
+  EXPECT_TRUE(book.reset);
+  EXPECT_LE(book.bids.size(), 100u);
+
+  stage.resetBook(btc);
+  ASSERT_TRUE(stage.read(fast, btc, book));
+  EXPECT_TRUE(book.reset);
+  EXPECT_TRUE(book.bids.empty());
+  stage.onOrderBookUpdate(bookUpdate("BTC-USD", {{10.0, 1.0}}, {}));
+  ASSERT_TRUE(stage.read(fast, btc, book));
+  EXPECT_FALSE(book.reset);
+}
+
+TEST(ConflationStageTest, SlowConsumerThreadSeesLatestState) {
+  ConflationStage stage;
+  size_t btc = stage.addSymbol("BTC-USD");
+  auto consumer = stage.addConsumer();
+  constexpr int UPDATES = 20000;
+  std::atomic<bool> done{false};
+
+  std::thread feed([&]() {
+    for (int i = 1; i <= UPDATES; ++i) {
+      stage.onMarketUpdate(marketUpdate(100.0, 1.0, i, i + 1.0, i));
+      stage.onOrderBookUpdate(
+          bookUpdate("BTC-USD", {{100.0, static_cast<double>(i)}}, {}));
+    }
+    done.store(true);
+  });
+
+  ConflatedBook book;
+  double volume = 0.0;
+  double lastQuantity = 0.0;
+  uint64_t reads = 0;
+  while (!done.load() || stage.isDirty(consumer, btc)) {
+    if (!stage.read(consumer, btc, book)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ++reads;
+    volume += book.tradedVolume;
+    EXPECT_LE(book.top.bidPrice + 1.0, book.top.askPrice + 1e-9);
+    if (!book.bids.empty()) {
+      EXPECT_GT(book.bids[0].second, lastQuantity);
+      lastQuantity = book.bids[0].second;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  feed.join();
+
+  // Nothing is lost: the final state and total volume are all there
+  EXPECT_DOUBLE_EQ(lastQuantity, UPDATES);
+  EXPECT_DOUBLE_EQ(volume, UPDATES);
+  EXPECT_EQ(reads + stage.getUpdatesConflated(consumer),
+            2u * static_cast<uint64_t>(UPDATES));
+}
@@ -0,0 +1,361 @@
+#include "../../exchange/connector/JsonCursor.h"
+#include "../../strategies/backtesting/DepthReplayBacktest.h"
+#include "../../strategies/backtesting/ReplayBook.h"
+
+#include <functional>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::backtesting;
+using exchange::EventSide;
+using exchange::LatencyDistribution;
+using exchange::MarketEvent;
+using exchange::MarketEventType;
+using exchange::SimulatedExecution;
+
+namespace {
+
+constexpr uint64_t MICROS = 1'000;
+constexpr uint64_t MILLIS = 1'000'000;
+
+int64_t fixed(double value) {
+  return static_cast<int64_t>(value * exchange::FIXED_POINT_SCALE);
+}
+
+MarketEvent delta(uint64_t time, EventSide side, double price,
+                  double quantity) {
+  MarketEvent event{};
+  event.receivedAt = time;
+  event.type = MarketEventType::BOOK_DELTA;
+  event.side = side;
+  event.price = fixed(price);
+  event.quantity = fixed(quantity);
+  return event;
+}
+
+MarketEvent trade(uint64_t time, EventSide aggressor, double price,
+                  double quantity) {
+  MarketEvent event = delta(time, aggressor, price, quantity);
+  event.type = MarketEventType::TRADE;
+  return event;
+}
+
+// Book of 100.00 bid for 5 and 100.10 offered for 5, at time 0
+std::vector<MarketEvent> openingBook() {
+  return {delta(0, EventSide::BID, 100.0, 5.0),
+          delta(0, EventSide::BID, 99.9, 8.0),
+          delta(0, EventSide::ASK, 100.1, 5.0),
+          delta(0, EventSide::ASK, 100.2, 8.0)};
+}
+
+// Runs a function on each batch and keeps every report
+class ScriptedStrategy : public DepthReplayStrategy {
+public:
+  std::function<void(DepthReplayBacktest&)> onCall;
+  std::vector<SimulatedExecution> reports;
+  std::vector<uint64_t> callTimes;
+
+  void onBatch(DepthReplayBacktest& backtest,
+               std::span<const SimulatedExecution> batch) override {
+    reports.insert(reports.end(), batch.begin(), batch.end());
+    callTimes.push_back(backtest.now());
+    if (onCall) {
+      onCall(backtest);
+    }
+  }
+
+  std::vector<SimulatedExecution> of(SimulatedExecution::Type type) const {
+    std::vector<SimulatedExecution> matching;
+    for (const auto& report : reports) {
+      if (report.type == type) {
+        matching.push_back(report);
+      }
+    }
+    return matching;
+  }
+};
+
+} // namespace
+
+// ============================================================================
+// ReplayBook
+// ============================================================================
+
+TEST(ReplayBookTest, KeepsLevelsInPriceOrder) {
+  ReplayBook book;
+  EXPECT_EQ(book.bestBid(), 0);
+  EXPECT_EQ(book.apply(EventSide::BID, 100, 5), 0);
+  book.apply(EventSide::BID, 102, 1);
+  book.apply(EventSide::BID, 101, 3);
+  book.apply(EventSide::ASK, 105, 2);
+  book.apply(EventSide::ASK, 103, 4);
+
+  EXPECT_EQ(book.bestBid(), 102);
+  EXPECT_EQ(book.bestAsk(), 103);
+  ASSERT_EQ(book.depth(EventSide::BID), 3u);
+  EXPECT_EQ(book.level(EventSide::BID, 1).price, 101);
+  EXPECT_EQ(book.level(EventSide::BID, 2).price, 100);
+  EXPECT_EQ(book.level(EventSide::ASK, 1).price, 105);
+
+  EXPECT_EQ(book.apply(EventSide::BID, 101, 7), 3);
+  EXPECT_EQ(book.quantityAt(EventSide::BID, 101), 7);
+  EXPECT_EQ(book.apply(EventSide::BID, 102, 0), 1);
+  EXPECT_EQ(book.bestBid(), 101);
+  EXPECT_EQ(book.apply(EventSide::ASK, 104, 0), 0); // Absent: no-op
+  EXPECT_EQ(book.depth(EventSide::ASK), 2u);
+
+  book.clear();
+  EXPECT_TRUE(book.empty());
+}
+
+// ============================================================================
+// DepthReplayBacktest
+// ============================================================================
+
+TEST(DepthReplayBacktestTest, FillsOnlyOnceTheQueueAheadHasTraded) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+  backtest.process(openingBook());
+
+  std::string orderId = backtest.submitOrder(OrderSide::BUY, 100.0, 2.0);
+  std::vector<MarketEvent> events = {
+      // Behind 5: 3 trade and leave the level, then 2 more
+      trade(1 * MILLIS, EventSide::ASK, 100.0, 3.0),
+      delta(1 * MILLIS, EventSide::BID, 100.0, 2.0),
+      trade(2 * MILLIS, EventSide::ASK, 100.0, 3.0),
+      delta(2 * MILLIS, EventSide::BID, 100.0, 0.0),
+      // Lifting the offer does not touch the bid
+      trade(3 * MILLIS, EventSide::BID, 100.1, 5.0),
+      delta(4 * MILLIS, EventSide::ASK, 100.1, 1.0)};
+  backtest.process(events);
+  backtest.finish();
+
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_EQ(fills[0].orderId, orderId);
+  EXPECT_DOUBLE_EQ(fills[0].price, 100.0);
+  EXPECT_NEAR(fills[0].quantity, 1.0, 1e-9);
+  EXPECT_NEAR(fills[0].remaining, 1.0, 1e-9);
+  EXPECT_EQ(fills[0].exchangeTime, 2 * MILLIS);
+  EXPECT_NEAR(backtest.getPosition(), 1.0, 1e-9);
+  EXPECT_NEAR(backtest.getCash(), -100.0, 1e-9);
+}
+
+TEST(DepthReplayBacktestTest, CancelsAheadMoveTheOrderUp) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+  backtest.process(openingBook());
+  backtest.submitOrder(OrderSide::SELL, 100.1, 1.0);
+
+  // Half the level cancels with no trade, taking half of what was ahead
+  // of us; 2.5 then trade, and only the next 0.5 reaches us
+  backtest.process(std::vector<MarketEvent>{
+      delta(1 * MILLIS, EventSide::ASK, 100.1, 2.5),
+      trade(2 * MILLIS, EventSide::BID, 100.1, 2.5),
+      trade(3 * MILLIS, EventSide::BID, 100.1, 0.5)});
+  backtest.finish();
+
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_NEAR(fills[0].quantity, 0.5, 1e-9);
+  EXPECT_EQ(fills[0].exchangeTime, 3 * MILLIS);
+  EXPECT_NEAR(backtest.getPosition(), -0.5, 1e-9);
+}
+
+TEST(DepthReplayBacktestTest, CrossingOrdersTakeTheLevelsTheyReach) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+  backtest.process(openingBook());
+  backtest.submitOrder(OrderSide::BUY, 100.2, 10.0);
+  backtest.process(std::vector<MarketEvent>{
+      delta(1 * MILLIS, EventSide::BID, 99.8, 1.0)});
+  backtest.finish();
+
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 2u);
+  EXPECT_DOUBLE_EQ(fills[0].price, 100.1);
+  EXPECT_NEAR(fills[0].quantity, 5.0, 1e-9);
+  EXPECT_DOUBLE_EQ(fills[1].price, 100.2);
+  EXPECT_NEAR(fills[1].quantity, 5.0, 1e-9);
+  EXPECT_NEAR(fills[1].remaining, 0.0, 1e-9);
+  EXPECT_NEAR(backtest.getCash(), -(5.0 * 100.1 + 5.0 * 100.2), 1e-6);
+}
+
+TEST(DepthReplayBacktestTest, SweepsShareTheLevelsUntilTheyUpdate) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+  backtest.process(openingBook());
+  backtest.submitOrder(OrderSide::BUY, 100.2, 8.0);
+  backtest.submitOrder(OrderSide::BUY, 100.2, 5.0);
+  backtest.process(std::vector<MarketEvent>{
+      delta(1 * MILLIS, EventSide::BID, 99.8, 1.0)});
+
+  // The second order finds only what the first left at 100.2
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 3u);
+  EXPECT_DOUBLE_EQ(fills[0].price, 100.1);
+  EXPECT_NEAR(fills[0].quantity, 5.0, 1e-9);
+  EXPECT_DOUBLE_EQ(fills[1].price, 100.2);
+  EXPECT_NEAR(fills[1].quantity, 3.0, 1e-9);
+  EXPECT_DOUBLE_EQ(fills[2].price, 100.2);
+  EXPECT_NEAR(fills[2].quantity, 5.0, 1e-9);
+  EXPECT_NEAR(fills[2].remaining, 0.0, 1e-9);
+
+  // An update to 100.1 shows its volume again; 100.2 stays taken
+  backtest.process(std::vector<MarketEvent>{
+      delta(2 * MILLIS, EventSide::ASK, 100.1, 2.0)});
+  backtest.submitOrder(OrderSide::BUY, 100.2, 3.0);
+  backtest.finish();
+
+  fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 4u);
+  EXPECT_DOUBLE_EQ(fills[3].price, 100.1);
+  EXPECT_NEAR(fills[3].quantity, 2.0, 1e-9);
+  EXPECT_NEAR(fills[3].remaining, 1.0, 1e-9);
+  EXPECT_NEAR(backtest.getPosition(), 15.0, 1e-9);
+}
+
+TEST(DepthReplayBacktestTest, OffersThroughOurBidFillIt) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+  backtest.process(openingBook());
+  backtest.submitOrder(OrderSide::BUY, 100.0, 1.0);
+
+  // The offer drops below our bid without a trade being reported
+  backtest.process(std::vector<MarketEvent>{
+      delta(1 * MILLIS, EventSide::ASK, 99.95, 3.0)});
+  backtest.finish();
+
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_DOUBLE_EQ(fills[0].price, 100.0);
+  EXPECT_NEAR(fills[0].remaining, 0.0, 1e-9);
+}
+
+TEST(DepthReplayBacktestTest, OrdersAndReportsTakeTheirLatency) {
+  DepthReplayConfig config;
+  config.decisionInterval = 10 * MILLIS;
+  config.latency.orderEntry = LatencyDistribution::fixed(5 * MILLIS);
+  config.latency.acknowledgement = LatencyDistribution::fixed(3 * MILLIS);
+
+  ScriptedStrategy strategy;
+  bool sent = false;
+  strategy.onCall = [&](DepthReplayBacktest& backtest) {
+    if (!sent) {
+      backtest.submitOrder(OrderSide::SELL, 100.1, 1.0);
+      sent = true;
+    }
+  };
+
+  DepthReplayBacktest backtest(strategy, config);
+  backtest.process(openingBook());
+  // The first decision is at 10ms: the order reaches the venue at 15ms,
+  // too late for the 12ms trade, behind 5 again and filled at 20ms
+  std::vector<MarketEvent> events = {
+      trade(12 * MILLIS, EventSide::BID, 100.1, 5.0),
+      delta(12 * MILLIS, EventSide::ASK, 100.1, 5.0),
+      trade(20 * MILLIS, EventSide::BID, 100.1, 6.0),
+      delta(21 * MILLIS, EventSide::ASK, 100.1, 0.0),
+      delta(22 * MILLIS, EventSide::ASK, 100.2, 7.0),
+      delta(35 * MILLIS, EventSide::ASK, 100.2, 6.0)};
+  backtest.process(events);
+
+  ASSERT_GE(strategy.callTimes.size(), 3u);
+  EXPECT_EQ(strategy.callTimes[0], 10 * MILLIS);
+  EXPECT_EQ(strategy.callTimes[1], 20 * MILLIS);
+  EXPECT_EQ(strategy.callTimes[2], 30 * MILLIS);
+
+  auto acks = strategy.of(SimulatedExecution::Type::ACK);
+  ASSERT_EQ(acks.size(), 1u);
+  EXPECT_EQ(acks[0].exchangeTime, 15 * MILLIS);
+  EXPECT_EQ(acks[0].receivedAt, 18 * MILLIS);
+
+  // Filled at 20ms, reported at 23ms, seen by the 30ms call
+  auto fills = strategy.of(SimulatedExecution::Type::FILL);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_EQ(fills[0].exchangeTime, 20 * MILLIS);
+  EXPECT_EQ(fills[0].receivedAt, 23 * MILLIS);
+  EXPECT_NEAR(backtest.getPosition(), -1.0, 1e-9);
+}
+
+TEST(DepthReplayBacktestTest, CancelsRaceFills) {
+  DepthReplayConfig config;
+  config.decisionInterval = 0;
+  config.latency.orderEntry = LatencyDistribution::fixed(100 * MICROS);
+
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy, config);
+  backtest.process(openingBook());
+  std::string resting = backtest.submitOrder(OrderSide::BUY, 99.9, 1.0);
+  std::string filled = backtest.submitOrder(OrderSide::SELL, 100.1, 1.0);
+  backtest.process(std::vector<MarketEvent>{
+      trade(1 * MILLIS, EventSide::BID, 100.2, 1.0)});
+
+  backtest.cancelOrder(resting);
+  backtest.cancelOrder(filled);
+  backtest.process(std::vector<MarketEvent>{
+      delta(2 * MILLIS, EventSide::BID, 99.9, 9.0)});
+  backtest.finish();
+
+  auto canceled = strategy.of(SimulatedExecution::Type::CANCELED);
+  ASSERT_EQ(canceled.size(), 1u);
+  EXPECT_EQ(canceled[0].orderId, resting);
+  EXPECT_NEAR(canceled[0].quantity, 1.0, 1e-9);
+  auto rejected = strategy.of(SimulatedExecution::Type::CANCEL_REJECTED);
+  ASSERT_EQ(rejected.size(), 1u);
+  EXPECT_EQ(rejected[0].orderId, filled);
+  EXPECT_EQ(backtest.getStats().cancelsSent, 2u);
+}
+
+TEST(DepthReplayBacktestTest, BatchesStrategyCalls) {
+  DepthReplayConfig config;
+  config.decisionInterval = 1 * MILLIS;
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy, config);
+
+  // 10,000 updates over 10ms, and then a second's gap
+  std::vector<MarketEvent> events;
+  for (uint64_t i = 0; i < 10'000; ++i) {
+    double price = 100.0 - static_cast<double>(i % 50) * 0.01;
+    events.push_back(delta(i * MICROS, EventSide::BID, price,
+                           static_cast<double>(i % 7)));
+  }
+  events.push_back(delta(1010 * MILLIS, EventSide::BID, 100.0, 1.0));
+  backtest.process(events);
+
+  EXPECT_EQ(backtest.getStats().events, 10'001u);
+  EXPECT_EQ(strategy.callTimes.size(), 10u);
+  EXPECT_EQ(backtest.getStats().batches, 10u);
+}
+
+TEST(DepthReplayBacktestTest, BboStandsInOnlyWithoutDepth) {
+  ScriptedStrategy strategy;
+  DepthReplayBacktest backtest(strategy);
+
+  MarketEvent bbo{};
+  bbo.receivedAt = 1;
+  bbo.type = MarketEventType::BBO;
+  bbo.price = fixed(100.0);
+  bbo.quantity = fixed(2.0);
+  bbo.askPrice = fixed(100.2);
+  bbo.askQuantity = fixed(3.0);
+  backtest.process(std::span<const MarketEvent>(&bbo, 1));
+  EXPECT_EQ(backtest.getBook().bestBid(), fixed(100.0));
+  EXPECT_EQ(backtest.getBook().bestAsk(), fixed(100.2));
+
+  // A lower bid replaces the one above it
+  bbo.price = fixed(99.9);
+  backtest.process(std::span<const MarketEvent>(&bbo, 1));
+  EXPECT_EQ(backtest.getBook().bestBid(), fixed(99.9));
+  EXPECT_EQ(backtest.getBook().depth(EventSide::BID), 1u);
+
+  // Once level updates arrive, BBO events are left out
+  backtest.process(std::vector<MarketEvent>{
+      delta(2, EventSide::BID, 99.8, 1.0)});
+  bbo.price = fixed(99.5);
+  backtest.process(std::span<const MarketEvent>(&bbo, 1));
+  EXPECT_EQ(backtest.getBook().bestBid(), fixed(99.9));
+  EXPECT_NEAR(backtest.getPnL(), 0.0, 1e-12);
+}
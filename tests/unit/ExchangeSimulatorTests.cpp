@@ -0,0 +1,362 @@
+#include "../../core/orderbook/OrderBook.h"
+#include "../../exchange/simulator/EventScheduler.h"
+#include "../../exchange/simulator/ExchangeSimulator.h"
+#include "../../exchange/simulator/LatencyModel.h"
+#include "../../exchange/simulator/QueuePositionModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::exchange;
+
+namespace {
+
+constexpr uint64_t MILLIS = 1'000'000;
+constexpr uint64_t SECONDS = 1'000'000'000;
+
+std::shared_ptr<OrderBook> bookWith(
+    const std::vector<std::pair<double, double>>& bids,
+    const std::vector<std::pair<double, double>>& asks) {
+  auto book = std::make_shared<OrderBook>("BTC-USD", false);
+  int id = 0;
+  for (const auto& [price, quantity] : bids) {
+    book->addOrder(std::make_shared<Order>("b" + std::to_string(id++),
+                                           "BTC-USD", OrderSide::BUY,
+                                           OrderType::LIMIT, price, quantity,
+                                           0));
+  }
+  for (const auto& [price, quantity] : asks) {
+    book->addOrder(std::make_shared<Order>("a" + std::to_string(id++),
+                                           "BTC-USD", OrderSide::SELL,
+                                           OrderType::LIMIT, price, quantity,
+                                           0));
+  }
+  return book;
+}
+
+} // namespace
+
+// ============================================================================
+// EventScheduler
+// ============================================================================
+
+TEST(EventSchedulerTest, RunsEventsInTimeThenScheduleOrder) {
+  EventScheduler<int> scheduler(1000);
+  scheduler.schedule(3000, 1);
+  scheduler.schedule(2000, 2);
+  scheduler.schedule(3000, 3);
+  scheduler.schedule(500, 4); // In the past: runs now
+
+  std::vector<std::pair<uint64_t, int>> ran;
+  size_t count = scheduler.runUntil(
+      2500, [&](int&& value) { ran.emplace_back(scheduler.now(), value); });
+  EXPECT_EQ(count, 2u);
+  EXPECT_EQ(scheduler.now(), 2500u);
+
+  scheduler.runUntil(10000, [&](int&& value) {
+    ran.emplace_back(scheduler.now(), value);
+  });
+  std::vector<std::pair<uint64_t, int>> expected = {
+      {1000, 4}, {2000, 2}, {3000, 1}, {3000, 3}};
+  EXPECT_EQ(ran, expected);
+  EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(EventSchedulerTest, RunsEventsScheduledByHandlers) {
+  EventScheduler<int> scheduler;
+  scheduler.schedule(10, 0);
+
+  std::vector<uint64_t> times;
+  scheduler.runUntil(100, [&](int&& depth) {
+    times.push_back(scheduler.now());
+    if (depth < 3) {
+      scheduler.schedule(scheduler.now() + 20, depth + 1);
+    }
+  });
+  EXPECT_EQ(times, (std::vector<uint64_t>{10, 30, 50, 70}));
+}
+
+// ============================================================================
+// LatencyModel
+// ============================================================================
+
+TEST(LatencyModelTest, SamplesEachShape) {
+  std::mt19937 rng(7);
+  EXPECT_EQ(LatencyDistribution().sample(rng), 0u);
+  EXPECT_EQ(LatencyDistribution::fixed(250).sample(rng), 250u);
+
+  auto uniform = LatencyDistribution::uniform(100, 200);
+  auto normal = LatencyDistribution::normal(50, 100);
+  auto logNormal = LatencyDistribution::logNormal(1000, 0.5);
+  std::vector<uint64_t> samples;
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t u = uniform.sample(rng);
+    EXPECT_GE(u, 100u);
+    EXPECT_LE(u, 200u);
+    normal.sample(rng); // Clamped at 0 rather than wrapping
+    samples.push_back(logNormal.sample(rng));
+  }
+  std::nth_element(samples.begin(), samples.begin() + 5000, samples.end());
+  EXPECT_NEAR(static_cast<double>(samples[5000]), 1000.0, 50.0);
+}
+
+TEST(LatencyModelTest, ChannelKeepsMessagesInOrder) {
+  std::mt19937 rng(3);
+  LatencyChannel channel(LatencyDistribution::uniform(0, 1000));
+  uint64_t last = 0;
+  for (uint64_t sent = 0; sent < 10000; sent += 10) {
+    uint64_t arrival = channel.deliveryTime(sent, rng);
+    EXPECT_GE(arrival, sent);
+    EXPECT_GE(arrival, last);
+    last = arrival;
+  }
+}
+
+// ============================================================================
+// QueuePositionModel
+// ============================================================================
+
+TEST(QueuePositionModelTest, TradesConsumeVolumeAheadFirst) {
+  QueuePositionModel queue;
+  queue.addOrder("ours", OrderSide::BUY, 100.0, 2.0, 5.0);
+
+  std::vector<QueueFill> fills;
+  queue.onTrade(OrderSide::BUY, 100.0, 3.0, fills);
+  EXPECT_TRUE(fills.empty());
+  EXPECT_DOUBLE_EQ(queue.find("ours")->ahead, 2.0);
+
+  // Trades on the other side or at other prices leave us alone
+  queue.onTrade(OrderSide::SELL, 100.0, 10.0, fills);
+  queue.onTrade(OrderSide::BUY, 100.5, 10.0, fills);
+  EXPECT_TRUE(fills.empty());
+
+  queue.onTrade(OrderSide::BUY, 100.0, 3.0, fills);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_EQ(fills[0].orderId, "ours");
+  EXPECT_DOUBLE_EQ(fills[0].quantity, 1.0);
+  EXPECT_DOUBLE_EQ(fills[0].remaining, 1.0);
+  EXPECT_DOUBLE_EQ(queue.find("ours")->ahead, 0.0);
+
+  fills.clear();
+  queue.onTrade(OrderSide::BUY, 100.0, 5.0, fills);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_DOUBLE_EQ(fills[0].quantity, 1.0);
+  EXPECT_DOUBLE_EQ(fills[0].remaining, 0.0);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(QueuePositionModelTest, CancelsRemoveAheadInProportion) {
+  QueuePositionModel queue;
+  queue.addOrder("ours", OrderSide::SELL, 101.0, 1.0, 6.0);
+
+  // 6 of the level's 8 are ahead, so 3 of a 4 lot cancel are
+  queue.onCancel(OrderSide::SELL, 101.0, 4.0, 8.0);
+  EXPECT_DOUBLE_EQ(queue.find("ours")->ahead, 3.0);
+
+  queue.onCancel(OrderSide::SELL, 101.0, 4.0, 4.0);
+  EXPECT_DOUBLE_EQ(queue.find("ours")->ahead, 0.0);
+}
+
+TEST(QueuePositionModelTest, TradeThroughFillsOutright) {
+  QueuePositionModel queue;
+  queue.addOrder("ours", OrderSide::SELL, 101.0, 2.0, 50.0);
+
+  std::vector<QueueFill> fills;
+  queue.onTrade(OrderSide::SELL, 101.5, 0.1, fills);
+  ASSERT_EQ(fills.size(), 1u);
+  EXPECT_DOUBLE_EQ(fills[0].price, 101.0);
+  EXPECT_DOUBLE_EQ(fills[0].quantity, 2.0);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(QueuePositionModelTest, OwnOrdersShareTradesInQueueOrder) {
+  QueuePositionModel queue;
+  queue.addOrder("first", OrderSide::BUY, 100.0, 2.0, 3.0);
+  queue.addOrder("second", OrderSide::BUY, 100.0, 2.0, 5.0);
+
+  // 3 ahead of the first, 2 of it, 2 more ahead of the second, 1 of it
+  std::vector<QueueFill> fills;
+  queue.onTrade(OrderSide::BUY, 100.0, 8.0, fills);
+  ASSERT_EQ(fills.size(), 2u);
+  EXPECT_EQ(fills[0].orderId, "first");
+  EXPECT_DOUBLE_EQ(fills[0].quantity, 2.0);
+  EXPECT_EQ(fills[1].orderId, "second");
+  EXPECT_DOUBLE_EQ(fills[1].quantity, 1.0);
+  EXPECT_DOUBLE_EQ(queue.find("second")->remaining, 1.0);
+
+  EXPECT_TRUE(queue.removeOrder("second"));
+  EXPECT_FALSE(queue.removeOrder("second"));
+}
+
+// ============================================================================
+// ExchangeSimulator
+// ============================================================================
+
+class ExchangeSimulatorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    book = bookWith({{99.0, 1.0}, {99.5, 4.0}}, {{100.5, 2.0}, {101.0, 3.0}});
+    simulator = std::make_unique<ExchangeSimulator>(book);
+    simulator->setSeed(42);
+    simulator->setLatency({LatencyDistribution::fixed(1 * MILLIS),
+                           LatencyDistribution::fixed(2 * MILLIS),
+                           LatencyDistribution::fixed(5 * MILLIS)});
+    simulator->setExecutionCallback(
+        [this](const SimulatedExecution& execution) {
+          reports.push_back(execution);
+        });
+  }
+
+  std::shared_ptr<OrderBook> book;
+  std::unique_ptr<ExchangeSimulator> simulator;
+  std::vector<SimulatedExecution> reports;
+};
+
+TEST_F(ExchangeSimulatorTest, AcksAfterEntryAndAckLatency) {
+  uint64_t sentAt = simulator->getSimulatedTime();
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::BUY, 99.5, 1.0));
+  EXPECT_FALSE(simulator->submitOrder("o1", OrderSide::BUY, 99.5, 1.0));
+
+  simulator->runFor(2 * MILLIS);
+  EXPECT_TRUE(reports.empty());
+  simulator->runFor(1 * MILLIS);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].type, SimulatedExecution::Type::ACK);
+  EXPECT_EQ(reports[0].exchangeTime, sentAt + 1 * MILLIS);
+  EXPECT_EQ(reports[0].receivedAt, sentAt + 3 * MILLIS);
+
+  // Behind the 4 lots already resting at the price
+  auto queued = simulator->getQueuedOrders();
+  ASSERT_EQ(queued.size(), 1u);
+  EXPECT_DOUBLE_EQ(queued[0].ahead, 4.0);
+}
+
+TEST_F(ExchangeSimulatorTest, MarketableOrderTakesVisibleLiquidity) {
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::BUY, 100.7, 3.0));
+  simulator->runFor(5 * MILLIS);
+
+  ASSERT_EQ(reports.size(), 2u);
+  EXPECT_EQ(reports[1].type, SimulatedExecution::Type::FILL);
+  EXPECT_DOUBLE_EQ(reports[1].price, 100.5);
+  EXPECT_DOUBLE_EQ(reports[1].quantity, 2.0);
+  EXPECT_DOUBLE_EQ(reports[1].remaining, 1.0);
+
+  // The rest rests at the front of a new level
+  auto queued = simulator->getQueuedOrders();
+  ASSERT_EQ(queued.size(), 1u);
+  EXPECT_DOUBLE_EQ(queued[0].remaining, 1.0);
+  EXPECT_DOUBLE_EQ(queued[0].ahead, 0.0);
+  EXPECT_DOUBLE_EQ(book->getVolumeAtPrice(100.5), 2.0);
+}
+
+TEST_F(ExchangeSimulatorTest, SweepsDoNotTakeTheSameLiquidityTwice) {
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::BUY, 101.0, 3.0));
+  ASSERT_TRUE(simulator->submitOrder("o2", OrderSide::BUY, 101.0, 3.0));
+  simulator->runFor(5 * MILLIS);
+
+  std::vector<SimulatedExecution> fills;
+  for (const auto& report : reports) {
+    if (report.type == SimulatedExecution::Type::FILL) {
+      fills.push_back(report);
+    }
+  }
+  // o1 takes 100.5 and one lot at 101.0, leaving o2 the other two
+  ASSERT_EQ(fills.size(), 3u);
+  EXPECT_EQ(fills[0].orderId, "o1");
+  EXPECT_DOUBLE_EQ(fills[0].price, 100.5);
+  EXPECT_DOUBLE_EQ(fills[0].quantity, 2.0);
+  EXPECT_EQ(fills[1].orderId, "o1");
+  EXPECT_DOUBLE_EQ(fills[1].price, 101.0);
+  EXPECT_DOUBLE_EQ(fills[1].quantity, 1.0);
+  EXPECT_EQ(fills[2].orderId, "o2");
+  EXPECT_DOUBLE_EQ(fills[2].price, 101.0);
+  EXPECT_DOUBLE_EQ(fills[2].quantity, 2.0);
+  EXPECT_DOUBLE_EQ(fills[2].remaining, 1.0);
+
+  auto queued = simulator->getQueuedOrders();
+  ASSERT_EQ(queued.size(), 1u);
+  EXPECT_EQ(queued[0].orderId, "o2");
+
+  // Once the book changes, its levels show what they hold again
+  book->addOrder(std::make_shared<Order>("a9", "BTC-USD", OrderSide::SELL,
+                                         OrderType::LIMIT, 102.0, 1.0, 0));
+  reports.clear();
+  ASSERT_TRUE(simulator->submitOrder("o3", OrderSide::BUY, 100.5, 1.0));
+  simulator->runFor(5 * MILLIS);
+  ASSERT_EQ(reports.size(), 2u);
+  EXPECT_EQ(reports[1].type, SimulatedExecution::Type::FILL);
+  EXPECT_DOUBLE_EQ(reports[1].price, 100.5);
+  EXPECT_DOUBLE_EQ(reports[1].quantity, 1.0);
+}
+
+TEST_F(ExchangeSimulatorTest, CancelsRoundTrip) {
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::SELL, 102.0, 1.0));
+  ASSERT_TRUE(simulator->cancelOrder("o1"));
+  EXPECT_FALSE(simulator->cancelOrder("o2"));
+  simulator->runFor(5 * MILLIS);
+
+  ASSERT_EQ(reports.size(), 2u);
+  EXPECT_EQ(reports[1].type, SimulatedExecution::Type::CANCELED);
+  EXPECT_DOUBLE_EQ(reports[1].quantity, 1.0);
+  EXPECT_TRUE(simulator->getQueuedOrders().empty());
+  EXPECT_FALSE(simulator->cancelOrder("o1"));
+}
+
+TEST_F(ExchangeSimulatorTest, RunsFasterThanRealTime) {
+  auto feed = std::make_shared<SimulatedMarketDataFeed>();
+  uint64_t trades = 0;
+  uint64_t minDelay = UINT64_MAX;
+  feed->subscribeToMarketUpdates("BTC-USD", [&](const MarketUpdate& update) {
+    ++trades;
+    minDelay =
+        std::min(minDelay, simulator->getSimulatedTime() - update.timestamp);
+  });
+  simulator->setMarketDataFeed(feed);
+
+  // A resting bid, eventually filled by sellers once the queue ahead trades
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::BUY, 99.5, 0.5));
+
+  auto started = std::chrono::steady_clock::now();
+  size_t events = simulator->runFor(3600 * SECONDS);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - started)
+                       .count();
+
+  EXPECT_GT(events, 3600u * 10);
+  EXPECT_LT(seconds, 60.0);
+  EXPECT_GT(trades, 0u);
+  EXPECT_EQ(minDelay, 5 * MILLIS);
+
+  double filled = 0.0;
+  for (const auto& report : reports) {
+    if (report.type == SimulatedExecution::Type::FILL) {
+      EXPECT_DOUBLE_EQ(report.price, 99.5);
+      filled += report.quantity;
+    }
+  }
+  EXPECT_DOUBLE_EQ(filled, 0.5);
+}
+
+TEST_F(ExchangeSimulatorTest, PacesToWallClockWhenStarted) {
+  simulator->setSpeed(100.0);
+  ASSERT_TRUE(simulator->start());
+  EXPECT_EQ(simulator->runFor(SECONDS), 0u);
+
+  uint64_t from = simulator->getSimulatedTime();
+  ASSERT_TRUE(simulator->submitOrder("o1", OrderSide::BUY, 99.0, 1.0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  uint64_t elapsed = simulator->getSimulatedTime() - from;
+  simulator->stop();
+
+  // 200ms of wall time is about 20s simulated
+  EXPECT_GT(elapsed, 10 * SECONDS);
+  EXPECT_LT(elapsed, 60 * SECONDS);
+  ASSERT_FALSE(reports.empty());
+  EXPECT_EQ(reports[0].type, SimulatedExecution::Type::ACK);
+}
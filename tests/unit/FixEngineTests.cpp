@@ -0,0 +1,556 @@
+#include "../../core/utils/TimeUtils.h"
+#include "../../exchange/fix/FixConnector.h"
+#include "../../exchange/fix/FixMessageStore.h"
+#include "../../exchange/fix/FixSequenceStore.h"
+#include "../../exchange/fix/FixStreamReader.h"
+#include "../../exchange/fix/FixTemplate.h"
+#include "../../exchange/mock/MockVenue.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::exchange;
+using namespace pinnacle::exchange::fix;
+
+namespace {
+
+constexpr uint64_t SECOND = 1'000'000'000;
+constexpr uint64_t NOW = 1'760'000'000 * SECOND + 123'456'789;
+
+const FixHeaderFields HEADER{"FIX.4.4", "CLIENT", "VENUE"};
+
+std::string builtMessage(std::string_view type, uint64_t seqNum) {
+  FixMessageBuilder builder;
+  builder.begin(type, "VENUE", "CLIENT", seqNum, NOW)
+      .field(tag::ClOrdID, std::string_view("1"));
+  return std::string(builder.finish());
+}
+
+template <typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout =
+                                      std::chrono::milliseconds(5000)) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(FixTemplateTest, NewOrderSingleIsValidAfterEveryPatch) {
+  NewOrderSingleTemplate order(HEADER, "BTC-USD", '1', '2', '1');
+  FixMessageView view;
+
+  std::string_view message = order.encode(7, NOW, 42, 50123.25, 0.5);
+  ASSERT_TRUE(view.parse(message));
+  EXPECT_EQ(fixFrameLength(message), message.size());
+  EXPECT_EQ(view.msgType(), "D");
+  EXPECT_EQ(view.getInt(tag::MsgSeqNum), 7);
+  EXPECT_EQ(view.get(tag::ClOrdID), "0000000000000042");
+  EXPECT_EQ(view.get(tag::Symbol), "BTC-USD");
+  EXPECT_EQ(view.getChar(tag::Side), '1');
+  EXPECT_DOUBLE_EQ(view.getDouble(tag::Price), 50123.25);
+  EXPECT_DOUBLE_EQ(view.getDouble(tag::OrderQty), 0.5);
+  EXPECT_EQ(view.get(tag::SendingTime), formatFixTimestamp(NOW));
+  EXPECT_EQ(view.get(tag::TransactTime), formatFixTimestamp(NOW));
+
+  // Patched fields keep the length and the checksum stays right
+  size_t length = message.size();
+  for (uint64_t i = 1; i <= 200; ++i) {
+    message = order.encode(7 + i, NOW + i * 7'777'777, 42 + i,
+                           100.0 + i * 0.01, i * 0.001);
+    ASSERT_EQ(message.size(), length);
+    ASSERT_TRUE(view.parse(message)) << message;
+    EXPECT_EQ(view.getInt(tag::MsgSeqNum), static_cast<int64_t>(7 + i));
+    EXPECT_NEAR(view.getDouble(tag::Price), 100.0 + i * 0.01, 1e-9);
+    EXPECT_EQ(view.get(tag::SendingTime),
+              formatFixTimestamp(NOW + i * 7'777'777));
+  }
+}
+
+TEST(FixTemplateTest, RejectsValuesThatDoNotFit) {
+  NewOrderSingleTemplate order(HEADER, "BTC-USD", '2', '2', '1', 2, 4);
+  EXPECT_FALSE(order.encode(1, NOW, 1, 1.0, 1.0).empty());
+  EXPECT_TRUE(order.encode(1, NOW, 1, -1.0, 1.0).empty());
+  EXPECT_TRUE(order.encode(1, NOW, 1, 1e12, 1.0).empty());
+  EXPECT_TRUE(order.encode(1, NOW, 10'000'000'000'000'000ULL, 1.0, 1.0)
+                  .empty());
+
+  FixMessageView view;
+  ASSERT_TRUE(view.parse(order.encode(1, NOW, 1, 99.999, 1.23456)));
+  EXPECT_EQ(view.get(tag::Price), "000000100.00");
+  EXPECT_EQ(view.get(tag::OrderQty), "000000001.2346");
+
+  // Market orders carry no price
+  NewOrderSingleTemplate market(HEADER, "BTC-USD", '1', '1', '3');
+  ASSERT_TRUE(view.parse(market.encode(1, NOW, 1, 0.0, 2.0)));
+  EXPECT_FALSE(view.has(tag::Price));
+  EXPECT_EQ(view.getChar(tag::OrdType), '1');
+}
+
+TEST(FixTemplateTest, CancelReferencesOriginalOrder) {
+  OrderCancelTemplate cancel(HEADER, "ETH-USD", '2');
+  FixMessageView view;
+  ASSERT_TRUE(view.parse(cancel.encode(9, NOW + SECOND, 11, 10, 1.5)));
+  EXPECT_EQ(view.msgType(), "F");
+  EXPECT_EQ(view.getInt(tag::ClOrdID), 11);
+  EXPECT_EQ(view.getInt(tag::OrigClOrdID), 10);
+  EXPECT_EQ(view.get(tag::Symbol), "ETH-USD");
+  EXPECT_EQ(view.get(tag::OrderQty), "000000001.50000000");
+  EXPECT_EQ(view.get(tag::SendingTime), formatFixTimestamp(NOW + SECOND));
+
+  // A quantity too large for its slot is refused rather than cut
+  EXPECT_TRUE(cancel.encode(10, NOW + SECOND, 12, 10, 1e12).empty());
+}
+
+TEST(FixStreamReaderTest, ReassemblesMessagesSplitAcrossReads) {
+  std::string stream;
+  for (uint64_t i = 1; i <= 50; ++i) {
+    stream += builtMessage("8", i);
+  }
+
+  // A small buffer wraps many times
+  FixStreamReader reader(512);
+  FixMessageView view;
+  std::vector<int64_t> seqNums;
+  size_t offset = 0;
+  size_t chunk = 1;
+  while (offset < stream.size()) {
+    std::span<char> space = reader.writable();
+    ASSERT_FALSE(space.empty());
+    size_t bytes = std::min({chunk, space.size(), stream.size() - offset});
+    std::memcpy(space.data(), stream.data() + offset, bytes);
+    reader.commit(bytes);
+    offset += bytes;
+    chunk = chunk % 97 + 13;
+
+    std::string_view message;
+    while (reader.next(message)) {
+      ASSERT_TRUE(view.parse(message));
+      seqNums.push_back(view.getInt(tag::MsgSeqNum));
+    }
+  }
+
+  ASSERT_EQ(seqNums.size(), 50u);
+  for (size_t i = 0; i < seqNums.size(); ++i) {
+    EXPECT_EQ(seqNums[i], static_cast<int64_t>(i + 1));
+  }
+  EXPECT_EQ(reader.buffered(), 0u);
+  EXPECT_GT(reader.getCompactions(), 0u);
+}
+
+TEST(FixStreamReaderTest, SkipsBytesThatCannotStartAMessage) {
+  std::string stream = "garbage" + builtMessage("0", 1) + "xx8=F";
+  FixStreamReader reader;
+  auto space = reader.writable();
+  std::memcpy(space.data(), stream.data(), stream.size());
+  reader.commit(stream.size());
+
+  std::string_view message;
+  ASSERT_TRUE(reader.next(message));
+  EXPECT_EQ(message, builtMessage("0", 1));
+  EXPECT_FALSE(reader.next(message));
+  EXPECT_EQ(reader.getBytesSkipped(), 9u);
+  EXPECT_EQ(reader.buffered(), 3u); // "8=F" may start the next message
+}
+
+TEST(FixSequenceStoreTest, PersistsAcrossRestarts) {
+  auto path = std::filesystem::temp_directory_path() /
+              ("pinnaclemm_fix_seq_" + std::to_string(::getpid()));
+  std::filesystem::remove(path);
+
+  {
+    FixSequenceStore store;
+    ASSERT_TRUE(store.open(path.string(), "CLIENT->VENUE"));
+    EXPECT_TRUE(store.isPersistent());
+    EXPECT_EQ(store.takeSenderSeqNum(), 1u);
+    EXPECT_EQ(store.takeSenderSeqNum(), 2u);
+    store.setNextTargetSeqNum(17);
+  }
+  {
+    FixSequenceStore store;
+    ASSERT_TRUE(store.open(path.string(), "CLIENT->VENUE"));
+    EXPECT_EQ(store.nextSenderSeqNum(), 3u);
+    EXPECT_EQ(store.nextTargetSeqNum(), 17u);
+    store.reset();
+    EXPECT_EQ(store.nextSenderSeqNum(), 1u);
+  }
+  {
+    // Another session's numbers are never picked up by mistake
+    FixSequenceStore store;
+    EXPECT_FALSE(store.open(path.string(), "OTHER->VENUE"));
+    EXPECT_FALSE(store.isPersistent());
+    EXPECT_EQ(store.takeSenderSeqNum(), 1u); // Memory only
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(FixMessageStoreTest, ServesMessagesUntilOverwritten) {
+  FixMessageStore store;
+  ASSERT_TRUE(store.open("", "CLIENT->VENUE", 4));
+  EXPECT_FALSE(store.isPersistent());
+  EXPECT_EQ(store.lastSeqNum(), 0u);
+
+  store.store(1, NOW, builtMessage("A", 1), true);
+  for (uint64_t seqNum = 2; seqNum <= 5; ++seqNum) {
+    store.store(seqNum, NOW + seqNum, builtMessage("D", seqNum), false);
+  }
+  EXPECT_EQ(store.lastSeqNum(), 5u);
+
+  FixMessageStore::StoredMessage stored{};
+  EXPECT_FALSE(store.lookup(1, stored)); // Slot reused by 5
+  ASSERT_TRUE(store.lookup(2, stored));
+  EXPECT_FALSE(stored.isAdmin);
+  EXPECT_EQ(stored.sendingTime, NOW + 2);
+  EXPECT_EQ(stored.message, builtMessage("D", 2));
+  EXPECT_FALSE(store.lookup(6, stored));
+
+  // Too long to keep: the number is known but the message is gap filled
+  store.store(6, NOW, std::string(FixMessageStore::maxMessageLength() + 1,
+                                  'x'),
+              false);
+  ASSERT_TRUE(store.lookup(6, stored));
+  EXPECT_TRUE(stored.isAdmin);
+
+  store.reset();
+  EXPECT_FALSE(store.lookup(5, stored));
+  EXPECT_EQ(store.lastSeqNum(), 0u);
+}
+
+TEST(FixMessageStoreTest, PersistsAcrossRestarts) {
+  auto path = std::filesystem::temp_directory_path() /
+              ("pinnaclemm_fix_msg_" + std::to_string(::getpid()));
+  std::filesystem::remove(path);
+
+  {
+    FixMessageStore store;
+    ASSERT_TRUE(store.open(path.string(), "CLIENT->VENUE", 8));
+    EXPECT_TRUE(store.isPersistent());
+    store.store(1, NOW, builtMessage("A", 1), true);
+    store.store(2, NOW, builtMessage("D", 2), false);
+  }
+  {
+    // The file keeps the capacity it was created with
+    FixMessageStore store;
+    ASSERT_TRUE(store.open(path.string(), "CLIENT->VENUE", 1024));
+    EXPECT_EQ(store.capacity(), 8u);
+    EXPECT_EQ(store.lastSeqNum(), 2u);
+    FixMessageStore::StoredMessage stored{};
+    ASSERT_TRUE(store.lookup(2, stored));
+    EXPECT_EQ(stored.message, builtMessage("D", 2));
+  }
+  {
+    FixMessageStore store;
+    EXPECT_FALSE(store.open(path.string(), "OTHER->VENUE"));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(FixMessageStoreTest, ResendCopyKeepsEveryField) {
+  NewOrderSingleTemplate order(HEADER, "BTC-USD", '1', '2', '1');
+  std::string original(order.encode(7, NOW, 42, 50123.25, 0.5));
+
+  std::string resend;
+  ASSERT_TRUE(writePossDupResend(original, NOW + SECOND, resend));
+  FixMessageView view;
+  ASSERT_TRUE(view.parse(resend)) << resend;
+  EXPECT_EQ(fixFrameLength(resend), resend.size());
+  EXPECT_EQ(view.msgType(), "D");
+  EXPECT_EQ(view.getInt(tag::MsgSeqNum), 7);
+  EXPECT_EQ(view.getChar(tag::PossDupFlag), 'Y');
+  EXPECT_EQ(view.get(tag::SendingTime), formatFixTimestamp(NOW + SECOND));
+  EXPECT_EQ(view.get(tag::OrigSendingTime), formatFixTimestamp(NOW));
+  EXPECT_EQ(view.get(tag::ClOrdID), "0000000000000042");
+  EXPECT_DOUBLE_EQ(view.getDouble(tag::Price), 50123.25);
+
+  EXPECT_FALSE(writePossDupResend(original.substr(1), NOW, resend));
+}
+
+namespace {
+
+class TestFixConnector : public FixConnector {
+public:
+  using FixConnector::FixConnector;
+  ~TestFixConnector() override { stop(); }
+
+  bool sendNewOrderSingle(const Order& order) override {
+    return submitNewOrderSingle(order);
+  }
+  bool cancelOrder(const std::string& orderId) override {
+    return submitOrderCancel(orderId);
+  }
+  bool replaceOrder(const std::string&, const Order&) override {
+    return false;
+  }
+
+  std::vector<std::pair<std::string, char>> reports() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_reports;
+  }
+
+protected:
+  void onLogon() override {}
+  void onLogout() override {}
+  void onMarketDataMessage(const FixMessageView&) override {}
+  void onExecutionReport(const FixMessageView& msg) override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_reports.emplace_back(orderIdForClOrdId(msg.get(tag::ClOrdID)),
+                           msg.getChar(tag::OrdStatus));
+  }
+  void onOrderCancelReject(const FixMessageView&) override {}
+
+private:
+  std::mutex m_mutex;
+  std::vector<std::pair<std::string, char>> m_reports;
+};
+
+// A FIX counterparty on a raw socket, so tests control every message
+class RawCounterparty {
+public:
+  RawCounterparty() {
+    m_listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ::bind(m_listener, reinterpret_cast<sockaddr*>(&address), length);
+    ::listen(m_listener, 1);
+    ::getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &length);
+    m_port = ntohs(address.sin_port);
+  }
+
+  ~RawCounterparty() {
+    disconnect();
+    ::close(m_listener);
+  }
+
+  int port() const { return m_port; }
+
+  bool accept() {
+    disconnect();
+    pollfd in{m_listener, POLLIN, 0};
+    if (poll(&in, 1, 5000) <= 0) {
+      return false;
+    }
+    m_client = ::accept(m_listener, nullptr, nullptr);
+    m_reader.clear();
+    return m_client >= 0;
+  }
+
+  void disconnect() {
+    if (m_client >= 0) {
+      ::close(m_client);
+      m_client = -1;
+    }
+  }
+
+  // The view refers to the returned message
+  bool read(std::string& message, FixMessageView& view) {
+    std::string_view next;
+    while (!m_reader.next(next)) {
+      pollfd in{m_client, POLLIN, 0};
+      if (poll(&in, 1, 5000) <= 0) {
+        return false;
+      }
+      std::span<char> space = m_reader.writable();
+      ssize_t bytes = ::recv(m_client, space.data(), space.size(), 0);
+      if (bytes <= 0) {
+        return false;
+      }
+      m_reader.commit(static_cast<size_t>(bytes));
+    }
+    message.assign(next);
+    return view.parse(message);
+  }
+
+  void send(std::string_view message) {
+    ::send(m_client, message.data(), message.size(), 0);
+  }
+
+  FixMessageBuilder& begin(std::string_view type) {
+    return m_builder.begin(type, "VENUE", "CLIENT", m_nextSeqNum++,
+                           utils::TimeUtils::getWallClockNanos());
+  }
+
+  void setNextSeqNum(uint64_t seqNum) { m_nextSeqNum = seqNum; }
+
+private:
+  int m_listener{-1};
+  int m_client{-1};
+  int m_port{0};
+  uint64_t m_nextSeqNum{1};
+  FixStreamReader m_reader;
+  FixMessageBuilder m_builder;
+};
+
+} // namespace
+
+TEST(FixConnectorTest, TradesAgainstLoopbackVenue) {
+  mock::MockVenueConfig venueConfig;
+  venueConfig.name = "VENUE";
+  mock::MockVenue venue(venueConfig);
+  ASSERT_TRUE(venue.start());
+
+  FixConnector::FixConfig config;
+  config.senderCompId = "CLIENT";
+  config.targetCompId = "VENUE";
+  config.host = "127.0.0.1";
+  config.port = venue.fixPort();
+  config.useSSL = false;
+  TestFixConnector connector(config, nullptr);
+  connector.prepareOrderTemplates("BTC-USD");
+  ASSERT_TRUE(connector.start());
+  ASSERT_TRUE(waitFor([&]() { return connector.isLoggedOn(); }));
+
+  uint64_t now = utils::TimeUtils::getCurrentNanos();
+  Order aggressive("aggressive-1", "BTC-USD", OrderSide::BUY, OrderType::IOC,
+                   60000.0, 0.5, now);
+  Order resting("resting-1", "BTC-USD", OrderSide::BUY, OrderType::LIMIT,
+                40000.0, 1.0, now);
+  ASSERT_TRUE(connector.sendNewOrderSingle(aggressive));
+  ASSERT_TRUE(connector.sendNewOrderSingle(resting));
+  ASSERT_TRUE(waitFor([&]() { return connector.reports().size() >= 2; }));
+  ASSERT_TRUE(connector.cancelOrder("resting-1"));
+  EXPECT_FALSE(connector.cancelOrder("never-sent"));
+
+  ASSERT_TRUE(waitFor([&]() {
+    for (const auto& [orderId, status] : connector.reports()) {
+      if (orderId == "resting-1" && status == '4') {
+        return true;
+      }
+    }
+    return false;
+  }));
+
+  bool filled = false;
+  for (const auto& [orderId, status] : connector.reports()) {
+    filled |= orderId == "aggressive-1" && (status == '1' || status == '2');
+  }
+  EXPECT_TRUE(filled);
+
+  // Logon and three orders went out in sequence; every reply was in order
+  EXPECT_EQ(connector.getNextSenderSeqNum(), 5u);
+  EXPECT_EQ(connector.getSequenceGaps(), 0u);
+  EXPECT_EQ(connector.getMalformedMessages(), 0u);
+  EXPECT_EQ(connector.getNextTargetSeqNum(),
+            connector.getMessagesReceived() + 1);
+
+  connector.stop();
+  venue.stop();
+}
+
+TEST(FixConnectorTest, ResendsFromStoreAcrossRestarts) {
+  auto directory = std::filesystem::temp_directory_path();
+  std::string suffix = std::to_string(::getpid());
+  FixConnector::FixConfig config;
+  config.senderCompId = "CLIENT";
+  config.targetCompId = "VENUE";
+  config.host = "127.0.0.1";
+  config.useSSL = false;
+  config.resetSeqNumsOnLogon = "N";
+  config.sequenceStorePath =
+      (directory / ("pinnaclemm_fix_session_seq_" + suffix)).string();
+  config.messageStorePath =
+      (directory / ("pinnaclemm_fix_session_msg_" + suffix)).string();
+  std::filesystem::remove(config.sequenceStorePath);
+  std::filesystem::remove(config.messageStorePath);
+
+  RawCounterparty venue;
+  config.port = venue.port();
+  std::string message;
+  FixMessageView view;
+  std::vector<std::string> clOrdIds;
+
+  {
+    TestFixConnector connector(config, nullptr);
+    ASSERT_TRUE(connector.start());
+    ASSERT_TRUE(venue.accept());
+    ASSERT_TRUE(venue.read(message, view));
+    EXPECT_EQ(view.msgType(), "A");
+    EXPECT_EQ(view.getInt(tag::MsgSeqNum), 1);
+    venue.send(venue.begin("A")
+                   .field(tag::EncryptMethod, '0')
+                   .field(tag::HeartBtInt, static_cast<int64_t>(30))
+                   .finish());
+    ASSERT_TRUE(waitFor([&]() { return connector.isLoggedOn(); }));
+
+    uint64_t now = utils::TimeUtils::getCurrentNanos();
+    for (const char* orderId : {"order-1", "order-2"}) {
+      ASSERT_TRUE(connector.sendNewOrderSingle(
+          Order(orderId, "BTC-USD", OrderSide::BUY, OrderType::LIMIT, 40000.0,
+                1.0, now)));
+      ASSERT_TRUE(venue.read(message, view));
+      clOrdIds.emplace_back(view.get(tag::ClOrdID));
+    }
+
+    // The logon is gap filled and both orders come back as duplicates
+    venue.send(venue.begin("2")
+                   .field(tag::BeginSeqNo, static_cast<int64_t>(1))
+                   .field(tag::EndSeqNo, static_cast<int64_t>(0))
+                   .finish());
+    ASSERT_TRUE(venue.read(message, view));
+    EXPECT_EQ(view.msgType(), "4");
+    EXPECT_EQ(view.getInt(tag::MsgSeqNum), 1);
+    EXPECT_EQ(view.getChar(tag::GapFillFlag), 'Y');
+    EXPECT_EQ(view.getInt(tag::NewSeqNo), 2);
+    for (size_t i = 0; i < clOrdIds.size(); ++i) {
+      ASSERT_TRUE(venue.read(message, view));
+      EXPECT_EQ(view.msgType(), "D");
+      EXPECT_EQ(view.getInt(tag::MsgSeqNum), static_cast<int64_t>(i + 2));
+      EXPECT_EQ(view.getChar(tag::PossDupFlag), 'Y');
+      EXPECT_TRUE(view.has(tag::OrigSendingTime));
+      EXPECT_EQ(view.get(tag::ClOrdID), clOrdIds[i]);
+    }
+    EXPECT_TRUE(
+        waitFor([&]() { return connector.getMessagesResent() == 2; }));
+    connector.stop();
+  }
+
+  {
+    // A new process continues both directions and can still resend the
+    // orders of the previous one
+    TestFixConnector connector(config, nullptr);
+    ASSERT_TRUE(connector.start());
+    ASSERT_TRUE(venue.accept());
+    ASSERT_TRUE(venue.read(message, view));
+    EXPECT_EQ(view.msgType(), "A");
+    EXPECT_EQ(view.getInt(tag::MsgSeqNum), 5); // After the logout
+    venue.send(venue.begin("A")
+                   .field(tag::EncryptMethod, '0')
+                   .field(tag::HeartBtInt, static_cast<int64_t>(30))
+                   .finish());
+    ASSERT_TRUE(waitFor([&]() { return connector.isLoggedOn(); }));
+    EXPECT_EQ(connector.getNextTargetSeqNum(), 4u);
+
+    venue.send(venue.begin("2")
+                   .field(tag::BeginSeqNo, static_cast<int64_t>(2))
+                   .field(tag::EndSeqNo, static_cast<int64_t>(3))
+                   .finish());
+    for (const auto& clOrdId : clOrdIds) {
+      ASSERT_TRUE(venue.read(message, view));
+      EXPECT_EQ(view.getChar(tag::PossDupFlag), 'Y');
+      EXPECT_EQ(view.get(tag::ClOrdID), clOrdId);
+    }
+    connector.stop();
+  }
+
+  std::filesystem::remove(config.sequenceStorePath);
+  std::filesystem::remove(config.messageStorePath);
+}
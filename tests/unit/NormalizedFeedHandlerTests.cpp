@@ -0,0 +1,241 @@
+#include "../../exchange/connector/NormalizedFeedHandler.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pinnacle::exchange;
+
+namespace {
+
+class NormalizedFeedHandlerTest : public ::testing::Test {
+protected:
+  std::vector<MarketEvent> m_events;
+  std::vector<MarketUpdate> m_updates;
+  std::vector<OrderBookUpdate> m_books;
+  std::vector<std::string> m_sent;
+
+  std::unique_ptr<NormalizedFeedHandler> makeHandler(Venue venue) {
+    auto handler =
+        std::make_unique<NormalizedFeedHandler>(createVenueDecoder(venue));
+    handler->setEventSink([this](std::span<const MarketEvent> events) {
+      m_events.insert(m_events.end(), events.begin(), events.end());
+    });
+    handler->setMarketUpdateSink(
+        [this](const MarketUpdate& update) { m_updates.push_back(update); });
+    handler->setOrderBookUpdateSink(
+        [this](const OrderBookUpdate& update) { m_books.push_back(update); });
+    handler->setMessageSender(
+        [this](const std::string& message) { m_sent.push_back(message); });
+    return handler;
+  }
+
+  void clear() {
+    m_events.clear();
+    m_updates.clear();
+    m_books.clear();
+    m_sent.clear();
+  }
+
+  size_t count(MarketEventType type) const {
+    size_t n = 0;
+    for (const auto& event : m_events) {
+      n += event.type == type;
+    }
+    return n;
+  }
+};
+
+std::string coinbaseLevel2(uint64_t sequence, const std::string& type,
+                           const std::string& symbol = "BTC-USD") {
+  return R"({"channel":"l2_data","sequence_num":)" + std::to_string(sequence) +
+         R"(,"events":[{"type":")" + type + R"(","product_id":")" + symbol +
+         R"(","updates":[{"side":"bid","price_level":"100",)"
+         R"("new_quantity":"1"}]}]})";
+}
+
+std::string binanceDepth(uint64_t first, uint64_t last) {
+  return R"({"stream":"btcusdt@depth@100ms","data":{"e":"depthUpdate",)"
+         R"("s":"BTCUSDT","U":)" +
+         std::to_string(first) + R"(,"u":)" + std::to_string(last) +
+         R"(,"b":[["100","1"]],"a":[]}})";
+}
+
+std::string binanceSnapshot(uint64_t lastUpdateId) {
+  return R"({"stream":"btcusdt@depth20@100ms","data":{"lastUpdateId":)" +
+         std::to_string(lastUpdateId) +
+         R"(,"bids":[["100","2"]],"asks":[["101","3"]]}})";
+}
+
+} // namespace
+
+TEST_F(NormalizedFeedHandlerTest, ConnectionGapResyncsEveryBook) {
+  auto handler = makeHandler(Venue::COINBASE);
+  uint32_t btc = handler->addSymbol("BTC-USD");
+
+  handler->process(coinbaseLevel2(1, "snapshot"), 1);
+  handler->process(coinbaseLevel2(2, "update"), 2);
+  EXPECT_EQ(m_books.size(), 1u); // Snapshots are not forwarded as updates
+  EXPECT_EQ(count(MarketEventType::BOOK_DELTA), 2u);
+  clear();
+
+  // Sequence 3 is lost
+  handler->process(coinbaseLevel2(4, "update"), 4);
+  EXPECT_EQ(handler->getSequenceGaps(), 1u);
+  EXPECT_TRUE(handler->isStale(btc));
+  ASSERT_EQ(m_events.size(), 1u);
+  EXPECT_EQ(m_events[0].type, MarketEventType::BOOK_RESET);
+  EXPECT_EQ(m_events[0].flags, 0);
+  EXPECT_EQ(m_events[0].symbolId, btc);
+  ASSERT_EQ(m_sent.size(), 2u);
+  EXPECT_NE(m_sent[1].find("level2"), std::string::npos);
+
+  // Deltas are dropped until the snapshot arrives
+  handler->process(coinbaseLevel2(5, "update"), 5);
+  EXPECT_EQ(count(MarketEventType::BOOK_DELTA), 0u);
+  EXPECT_TRUE(m_books.empty());
+  EXPECT_EQ(handler->getDeltasDropped(), 2u);
+
+  handler->process(coinbaseLevel2(6, "snapshot"), 6);
+  EXPECT_FALSE(handler->isStale(btc));
+  EXPECT_EQ(handler->getResyncsCompleted(), 1u);
+  handler->process(coinbaseLevel2(7, "update"), 7);
+  EXPECT_EQ(m_books.size(), 1u);
+
+  // A repeated frame is dropped
+  clear();
+  handler->process(coinbaseLevel2(7, "update"), 8);
+  EXPECT_TRUE(m_events.empty());
+  EXPECT_EQ(handler->getFramesOutOfOrder(), 1u);
+}
+
+TEST_F(NormalizedFeedHandlerTest, ConnectionGapLeavesTickerOnlySymbolsAlone) {
+  auto handler = makeHandler(Venue::COINBASE);
+  uint32_t btc = handler->addSymbol("BTC-USD");
+  uint32_t eth = handler->addSymbol("ETH-USD");
+  handler->process(coinbaseLevel2(1, "snapshot", "ETH-USD"), 1);
+  handler->process(
+      R"({"channel":"ticker","sequence_num":5,"events":[{"tickers":[{)"
+      R"("product_id":"BTC-USD","price":"10","best_bid":"9",)"
+      R"("best_ask":"11"}]}]})",
+      5);
+  EXPECT_EQ(handler->getResyncsRequested(), 1u);
+  EXPECT_TRUE(handler->isStale(eth));
+  EXPECT_FALSE(handler->isStale(btc));
+  ASSERT_EQ(m_updates.size(), 1u); // The ticker itself still goes through
+  EXPECT_DOUBLE_EQ(m_updates[0].price, 10.0);
+}
+
+TEST_F(NormalizedFeedHandlerTest, PerBookSequenceGapAndSnapshotRecovery) {
+  auto handler = makeHandler(Venue::BINANCE);
+  uint32_t btc = handler->addSymbol("BTC-USDT");
+
+  handler->process(binanceDepth(1, 5), 1);
+  handler->process(binanceDepth(6, 8), 2);
+  ASSERT_EQ(m_books.size(), 2u);
+  EXPECT_EQ(m_books[0].symbol, "BTC-USDT"); // Canonical, not BTCUSDT
+  clear();
+
+  handler->process(binanceDepth(10, 12), 3);
+  EXPECT_TRUE(handler->isStale(btc));
+  ASSERT_EQ(m_sent.size(), 1u);
+  EXPECT_NE(m_sent[0].find("btcusdt@depth20@100ms"), std::string::npos);
+  EXPECT_EQ(count(MarketEventType::BOOK_RESET), 1u);
+
+  handler->process(binanceDepth(13, 14), 4);
+  EXPECT_EQ(count(MarketEventType::BOOK_DELTA), 0u);
+
+  // The snapshot ends the resync and unsubscribes the partial stream
+  handler->process(binanceSnapshot(15), 5);
+  EXPECT_FALSE(handler->isStale(btc));
+  ASSERT_EQ(m_sent.size(), 2u);
+  EXPECT_NE(m_sent[1].find("UNSUBSCRIBE"), std::string::npos);
+  EXPECT_EQ(count(MarketEventType::BOOK_DELTA), 2u);
+  EXPECT_TRUE(m_books.empty());
+  clear();
+
+  // Diffs already in the snapshot are dropped, the overlapping one applies
+  handler->process(binanceDepth(14, 15), 6);
+  handler->process(binanceDepth(15, 17), 7);
+  EXPECT_EQ(m_books.size(), 1u);
+
+  // A late snapshot from before the applied diffs is ignored
+  clear();
+  handler->process(binanceSnapshot(16), 8);
+  EXPECT_TRUE(m_events.empty());
+  handler->process(binanceDepth(18, 19), 9);
+  EXPECT_EQ(m_books.size(), 1u);
+  EXPECT_EQ(handler->getSequenceGaps(), 1u);
+}
+
+TEST_F(NormalizedFeedHandlerTest, AssemblesLegacyMarketUpdates) {
+  auto handler = makeHandler(Venue::BINANCE);
+  handler->addSymbol("BTC-USDT");
+
+  handler->process(R"({"stream":"btcusdt@bookTicker","data":{"u":1,)"
+                   R"("s":"BTCUSDT","b":"99","B":"1","a":"101","A":"2"}})",
+                   10);
+  ASSERT_EQ(m_updates.size(), 1u);
+  EXPECT_EQ(m_updates[0].symbol, "BTC-USDT");
+  EXPECT_DOUBLE_EQ(m_updates[0].price, 100.0); // Mid, no trade yet
+  EXPECT_DOUBLE_EQ(m_updates[0].volume, 0.0);
+  EXPECT_EQ(m_updates[0].timestamp, 10u);
+
+  handler->process(R"({"stream":"btcusdt@trade","data":{"e":"trade",)"
+                   R"("s":"BTCUSDT","p":"100.5","q":"0.25","m":false}})",
+                   11);
+  ASSERT_EQ(m_updates.size(), 2u);
+  EXPECT_DOUBLE_EQ(m_updates[1].price, 100.5);
+  EXPECT_DOUBLE_EQ(m_updates[1].volume, 0.25);
+  EXPECT_TRUE(m_updates[1].isBuy);
+  EXPECT_DOUBLE_EQ(m_updates[1].bidPrice, 99.0);
+  EXPECT_DOUBLE_EQ(m_updates[1].askPrice, 101.0);
+
+  // A later quote change carries the last trade price
+  handler->process(R"({"stream":"btcusdt@bookTicker","data":{"u":2,)"
+                   R"("s":"BTCUSDT","b":"100","B":"1","a":"102","A":"2"}})",
+                   12);
+  ASSERT_EQ(m_updates.size(), 3u);
+  EXPECT_DOUBLE_EQ(m_updates[2].price, 100.5);
+  EXPECT_DOUBLE_EQ(m_updates[2].bidPrice, 100.0);
+}
+
+TEST_F(NormalizedFeedHandlerTest, RequestedResyncForVenueWithoutSequences) {
+  auto handler = makeHandler(Venue::KRAKEN);
+  uint32_t btc = handler->addSymbol("BTC-USD");
+  std::string update =
+      R"({"channel":"book","type":"update","data":[{"symbol":"BTC/USD",)"
+      R"("bids":[{"price":1,"qty":1}],"asks":[]}]})";
+  std::string snapshot =
+      R"({"channel":"book","type":"snapshot","data":[{"symbol":"BTC/USD",)"
+      R"("bids":[{"price":1,"qty":2}],"asks":[]}]})";
+
+  handler->process(update, 1);
+  EXPECT_EQ(m_books.size(), 1u);
+  EXPECT_EQ(m_books[0].symbol, "BTC-USD");
+  clear();
+
+  handler->requestResync(btc);
+  ASSERT_EQ(m_events.size(), 1u);
+  EXPECT_EQ(m_events[0].type, MarketEventType::BOOK_RESET);
+  EXPECT_EQ(m_sent.size(), 2u);
+  handler->requestResync(btc); // Already pending
+  EXPECT_EQ(m_sent.size(), 2u);
+
+  handler->process(update, 2);
+  EXPECT_TRUE(m_books.empty());
+  handler->process(snapshot, 3);
+  EXPECT_FALSE(handler->isStale(btc));
+  handler->process(update, 4);
+  EXPECT_EQ(m_books.size(), 1u);
+}
+
+TEST_F(NormalizedFeedHandlerTest, CountsMalformedFrames) {
+  auto handler = makeHandler(Venue::GEMINI);
+  EXPECT_EQ(handler->process("{\"type\":", 1), FrameKind::MALFORMED);
+  EXPECT_EQ(handler->process(R"({"type":"heartbeat"})", 2),
+            FrameKind::HEARTBEAT);
+  EXPECT_EQ(handler->getMalformedFrames(), 1u);
+  EXPECT_EQ(handler->getFramesDecoded(), 2u);
+  EXPECT_TRUE(m_events.empty());
+}
@@ -0,0 +1,390 @@
+#include "../../exchange/capture/CaptureRecorder.h"
+#include "../../exchange/capture/ReplayMarketDataFeed.h"
+#include "../../exchange/connector/JsonCursor.h"
+#include "../../exchange/simulator/OrderFlowGenerator.h"
+#include "../../exchange/simulator/OrderFlowSinks.h"
+
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::exchange;
+
+namespace {
+
+constexpr uint64_t MS = 1'000'000;
+
+int64_t toFixedPoint(double value) {
+  return std::llround(value * static_cast<double>(FIXED_POINT_SCALE));
+}
+
+OrderFlowConfig twoSymbols() {
+  OrderFlowConfig config;
+  config.symbols = {{"BTC-USD", 50000.0, 0.01, 0.001},
+                    {"ETH-USD", 3000.0, 0.01, 0.01}};
+  config.seed = 42;
+  return config;
+}
+
+// Flow events only, skipping the initial book
+std::vector<OrderFlowEvent> flow(OrderFlowGenerator& generator,
+                                 size_t count) {
+  std::vector<OrderFlowEvent> events;
+  generator.generate(count, events);
+  std::erase_if(events, [](const OrderFlowEvent& event) {
+    return (event.flags & EVENT_FLAG_SNAPSHOT) != 0;
+  });
+  return events;
+}
+
+// Event counts per bucket of simulated time, per symbol
+std::vector<std::vector<double>>
+bucketCounts(const std::vector<OrderFlowEvent>& events, size_t symbols,
+             uint64_t bucket) {
+  uint64_t start = events.front().timestamp;
+  size_t buckets = (events.back().timestamp - start) / bucket;
+  std::vector<std::vector<double>> counts(symbols,
+                                          std::vector<double>(buckets, 0.0));
+  for (const auto& event : events) {
+    size_t b = (event.timestamp - start) / bucket;
+    if (b < buckets) {
+      counts[event.symbolId][b] += 1.0;
+    }
+  }
+  return counts;
+}
+
+double mean(const std::vector<double>& values) {
+  double sum = 0.0;
+  for (double v : values) {
+    sum += v;
+  }
+  return sum / static_cast<double>(values.size());
+}
+
+double covariance(const std::vector<double>& x, const std::vector<double>& y) {
+  double mx = mean(x);
+  double my = mean(y);
+  double sum = 0.0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    sum += (x[i] - mx) * (y[i] - my);
+  }
+  return sum / static_cast<double>(x.size());
+}
+
+double correlation(const std::vector<double>& x, const std::vector<double>& y) {
+  return covariance(x, y) / std::sqrt(covariance(x, x) * covariance(y, y));
+}
+
+// Price levels rebuilt from normalized events: (symbol, side, price) to
+// quantity, as a consumer of the feed would keep them
+using Levels = std::map<std::tuple<uint32_t, EventSide, int64_t>, int64_t>;
+
+void applyEvents(std::span<const MarketEvent> events, Levels& levels) {
+  for (const auto& event : events) {
+    if (event.type == MarketEventType::BOOK_RESET) {
+      std::erase_if(levels, [&](const auto& level) {
+        return std::get<0>(level.first) == event.symbolId;
+      });
+    } else if (event.type == MarketEventType::BOOK_DELTA) {
+      auto key = std::make_tuple(event.symbolId, event.side, event.price);
+      if (event.quantity == 0) {
+        levels.erase(key);
+      } else {
+        levels[key] = event.quantity;
+      }
+    }
+  }
+}
+
+Levels generatorLevels(const OrderFlowGenerator& generator) {
+  Levels levels;
+  for (uint32_t s = 0; s < generator.getConfig().symbols.size(); ++s) {
+    for (EventSide side : {EventSide::BID, EventSide::ASK}) {
+      for (const auto& [price, quantity] : generator.getLevels(s, side)) {
+        levels[std::make_tuple(s, side, price)] = quantity;
+      }
+    }
+  }
+  return levels;
+}
+
+} // namespace
+
+TEST(OrderFlowGeneratorTest, SameSeedGivesSameFlow) {
+  OrderFlowGenerator first(twoSymbols());
+  OrderFlowGenerator second(twoSymbols());
+  auto config = twoSymbols();
+  config.seed = 43;
+  OrderFlowGenerator other(config);
+
+  std::vector<OrderFlowEvent> a;
+  std::vector<OrderFlowEvent> b;
+  std::vector<OrderFlowEvent> c;
+  bool differs = false;
+  for (int batch = 0; batch < 5; ++batch) {
+    first.generate(10000, a);
+    second.generate(10000, b);
+    other.generate(10000, c);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      ASSERT_EQ(a[i].timestamp, b[i].timestamp) << i;
+      ASSERT_EQ(a[i].orderId, b[i].orderId) << i;
+      ASSERT_EQ(a[i].price, b[i].price) << i;
+      ASSERT_EQ(a[i].quantity, b[i].quantity) << i;
+      ASSERT_EQ(a[i].action, b[i].action) << i;
+      differs |= i < c.size() && a[i].timestamp != c[i].timestamp;
+    }
+  }
+  EXPECT_TRUE(differs);
+}
+
+TEST(OrderFlowGeneratorTest, GeneratesExactlyTheCountAskedFor) {
+  OrderFlowGenerator generator(twoSymbols());
+  std::vector<OrderFlowEvent> events;
+
+  generator.generate(1000, events);
+  size_t initialBook = 0;
+  for (const auto& event : events) {
+    initialBook += (event.flags & EVENT_FLAG_SNAPSHOT) != 0 ? 1 : 0;
+  }
+  EXPECT_GT(initialBook, 0u);
+  EXPECT_EQ(events.size(), initialBook + 1000);
+
+  uint64_t last = 0;
+  for (int batch = 0; batch < 20; ++batch) {
+    generator.generate(777, events);
+    ASSERT_EQ(events.size(), 777u);
+    for (const auto& event : events) {
+      ASSERT_GE(event.timestamp, last);
+      ASSERT_EQ(event.flags, 0);
+      last = event.timestamp;
+    }
+  }
+}
+
+TEST(OrderFlowGeneratorTest, ArrivalsCluster) {
+  // Poisson arrivals have equal mean and variance per window; a Hawkes
+  // process with branching ratio n has variance about 1/(1-n)^2 times more
+  auto config = twoSymbols();
+  config.symbols.resize(1);
+  OrderFlowGenerator generator(config);
+  auto events = flow(generator, 500000);
+
+  auto counts = bucketCounts(events, 1, 10 * MS)[0];
+  double dispersion = covariance(counts, counts) / mean(counts);
+  EXPECT_GT(dispersion, 2.0);
+
+  // The long-run rate is the base rate over 1 - n
+  double seconds =
+      static_cast<double>(events.back().timestamp - events.front().timestamp) /
+      1e9;
+  double rate = static_cast<double>(events.size()) / seconds;
+  EXPECT_NEAR(rate, config.baseRate / (1.0 - config.selfExcitation),
+              0.2 * config.baseRate / (1.0 - config.selfExcitation));
+}
+
+TEST(OrderFlowGeneratorTest, OrderSizesHavePowerLawTail) {
+  auto config = twoSymbols();
+  OrderFlowGenerator generator(config);
+  auto events = flow(generator, 500000);
+
+  double adds = 0.0;
+  double atLeast10 = 0.0;
+  double atLeast100 = 0.0;
+  for (const auto& event : events) {
+    if (event.action != OrderFlowAction::ADD) {
+      continue;
+    }
+    int64_t lotFixed = toFixedPoint(config.symbols[event.symbolId].lotSize);
+    int64_t lots = event.quantity / lotFixed;
+    adds += 1.0;
+    atLeast10 += lots >= 10 ? 1.0 : 0.0;
+    atLeast100 += lots >= 100 ? 1.0 : 0.0;
+  }
+
+  // P(size >= x) = x^-1.5
+  EXPECT_NEAR(atLeast10 / adds, std::pow(10.0, -1.5), 0.005);
+  EXPECT_NEAR(atLeast100 / adds, std::pow(100.0, -1.5), 0.0005);
+}
+
+TEST(OrderFlowGeneratorTest, BooksStayTwoSidedAndNearTargetDepth) {
+  auto config = twoSymbols();
+  OrderFlowGenerator generator(config);
+  std::vector<OrderFlowEvent> events;
+  double target = config.targetLevelLots * static_cast<double>(config.levels);
+
+  size_t trades = 0;
+  for (int batch = 0; batch < 100; ++batch) {
+    generator.generate(10000, events);
+    for (const auto& event : events) {
+      trades += event.action == OrderFlowAction::TRADE ? 1 : 0;
+    }
+    for (uint32_t s = 0; s < 2; ++s) {
+      ASSERT_LT(generator.getBestBid(s), generator.getBestAsk(s));
+      int64_t lotFixed = toFixedPoint(config.symbols[s].lotSize);
+      for (EventSide side : {EventSide::BID, EventSide::ASK}) {
+        auto levels = generator.getLevels(s, side);
+        ASSERT_FALSE(levels.empty());
+        double lots = 0.0;
+        for (const auto& level : levels) {
+          lots += static_cast<double>(level.second / lotFixed);
+        }
+        EXPECT_GT(lots, 0.5 * target);
+        EXPECT_LT(lots, 2.0 * target);
+      }
+    }
+  }
+  EXPECT_GT(trades, 10000u);
+}
+
+TEST(OrderFlowGeneratorTest, SymbolsMoveTogether) {
+  // Activity is correlated through cross-excitation, and trade direction
+  // through the shared order flow; without either the symbols are
+  // independent
+  auto independent = twoSymbols();
+  independent.crossExcitation = 0.0;
+  independent.flowCorrelation = 0.0;
+
+  auto correlations = [](const OrderFlowConfig& config) {
+    OrderFlowGenerator generator(config);
+    auto events = flow(generator, 500000);
+    auto counts = bucketCounts(events, 2, 10 * MS);
+
+    uint64_t start = events.front().timestamp;
+    size_t buckets = counts[0].size();
+    std::vector<std::vector<double>> signedTrades(
+        2, std::vector<double>(buckets, 0.0));
+    for (const auto& event : events) {
+      size_t b = (event.timestamp - start) / (10 * MS);
+      if (event.action == OrderFlowAction::TRADE && b < buckets) {
+        signedTrades[event.symbolId][b] +=
+            event.side == EventSide::BID ? 1.0 : -1.0;
+      }
+    }
+    return std::make_pair(correlation(counts[0], counts[1]),
+                          correlation(signedTrades[0], signedTrades[1]));
+  };
+
+  auto [activity, direction] = correlations(twoSymbols());
+  auto [baseActivity, baseDirection] = correlations(independent);
+  EXPECT_GT(activity, 0.1);
+  EXPECT_GT(direction, 0.1);
+  EXPECT_LT(std::abs(baseActivity), 0.05);
+  EXPECT_LT(std::abs(baseDirection), 0.05);
+}
+
+TEST(OrderFlowGeneratorTest, RejectsExplosiveExcitation) {
+  auto config = twoSymbols();
+  config.selfExcitation = 0.7;
+  config.crossExcitation = 0.3;
+  EXPECT_THROW(OrderFlowGenerator{config}, std::invalid_argument);
+
+  config.symbols.resize(1);
+  EXPECT_NO_THROW(OrderFlowGenerator{config});
+
+  config.symbols.clear();
+  EXPECT_THROW(OrderFlowGenerator{config}, std::invalid_argument);
+}
+
+TEST(OrderFlowGeneratorTest, BookWriterBuildsTheSameBooks) {
+  auto config = twoSymbols();
+  OrderFlowGenerator generator(config);
+  auto btc = std::make_shared<OrderBook>("BTC-USD", false);
+  auto eth = std::make_shared<OrderBook>("ETH-USD", false);
+  OrderFlowBookWriter writer(config, {btc, eth});
+
+  std::vector<OrderFlowEvent> events;
+  for (int batch = 0; batch < 5; ++batch) {
+    generator.generate(5000, events);
+    ASSERT_EQ(writer.apply(events), 0u);
+  }
+
+  Levels expected = generatorLevels(generator);
+  const std::shared_ptr<OrderBook> books[] = {btc, eth};
+  for (uint32_t s = 0; s < 2; ++s) {
+    EXPECT_EQ(toFixedPoint(books[s]->getBestBidPrice()),
+              generator.getBestBid(s));
+    EXPECT_EQ(toFixedPoint(books[s]->getBestAskPrice()),
+              generator.getBestAsk(s));
+
+    auto bids = books[s]->getBidLevels(config.levels);
+    auto asks = books[s]->getAskLevels(config.levels);
+    EXPECT_EQ(bids.size(), generator.getLevels(s, EventSide::BID).size());
+    EXPECT_EQ(asks.size(), generator.getLevels(s, EventSide::ASK).size());
+    for (const auto& level : bids) {
+      auto key = std::make_tuple(s, EventSide::BID,
+                                 toFixedPoint(level.price));
+      EXPECT_EQ(toFixedPoint(level.totalQuantity), expected[key]);
+    }
+    for (const auto& level : asks) {
+      auto key = std::make_tuple(s, EventSide::ASK,
+                                 toFixedPoint(level.price));
+      EXPECT_EQ(toFixedPoint(level.totalQuantity), expected[key]);
+    }
+  }
+}
+
+TEST(OrderFlowGeneratorTest, CaptureReplaysToTheSameBooks) {
+  auto dir = std::filesystem::temp_directory_path() /
+             ("pinnaclemm_order_flow_test_" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+
+  auto config = twoSymbols();
+  config.startTime = 1'760'000'000'000'000'000ULL;
+  OrderFlowGenerator generator(config);
+
+  capture::CaptureConfig captureConfig;
+  captureConfig.directory = dir.string();
+  captureConfig.source = "coinbase";
+  captureConfig.chunkBuffers = 64;
+  capture::CaptureRecorder recorder(captureConfig);
+  ASSERT_TRUE(recorder.start());
+  OrderFlowCaptureWriter writer(config, recorder);
+
+  // The same flow converted directly, for comparison
+  SymbolTable symbols;
+  MarketEventBuffer direct(symbols);
+  Levels directLevels;
+
+  std::vector<OrderFlowEvent> events;
+  size_t trades = 0;
+  for (int batch = 0; batch < 10; ++batch) {
+    generator.generate(5000, events);
+    ASSERT_TRUE(writer.write(events));
+    direct.reset(Venue::COINBASE, 0);
+    appendMarketEvents(config, events, direct);
+    applyEvents(direct.view(), directLevels);
+    for (const auto& event : events) {
+      trades += event.action == OrderFlowAction::TRADE ? 1 : 0;
+    }
+  }
+  recorder.stop();
+  ASSERT_EQ(recorder.getFramesDropped(), 0u);
+
+  // Symbols are interned as their snapshots arrive, in config order
+  capture::ReplayMarketDataFeed feed(recorder.getFilesWritten(),
+                                     capture::ReplayMarketDataFeed::MAX_SPEED);
+  Levels replayed;
+  size_t replayedTrades = 0;
+  feed.subscribeToEvents([&](std::span<const MarketEvent> batch) {
+    applyEvents(batch, replayed);
+    for (const auto& event : batch) {
+      replayedTrades += event.type == MarketEventType::TRADE ? 1 : 0;
+    }
+  });
+  EXPECT_EQ(feed.replayAll(), writer.getFramesWritten());
+
+  Levels expected = generatorLevels(generator);
+  EXPECT_EQ(replayed, expected);
+  EXPECT_EQ(directLevels, expected);
+  EXPECT_EQ(replayedTrades, trades);
+
+  std::filesystem::remove_all(dir);
+}
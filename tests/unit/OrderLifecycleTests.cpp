@@ -0,0 +1,240 @@
+#include "../../core/execution/OrderLifecycleManager.h"
+#include "../../core/utils/LatencyHistogram.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle;
+using namespace pinnacle::execution;
+using pinnacle::utils::LatencyHistogram;
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------
+
+TEST(LatencyHistogramTest, BucketBoundsContainValue) {
+  for (uint64_t v : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull,
+                     ~0ull}) {
+    size_t bucket = LatencyHistogram::bucketFor(v);
+    ASSERT_LT(bucket, LatencyHistogram::BUCKET_COUNT);
+    EXPECT_GE(LatencyHistogram::bucketUpperBound(bucket), v);
+    if (bucket > 0) {
+      EXPECT_LT(LatencyHistogram::bucketUpperBound(bucket - 1), v);
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+  LatencyHistogram histogram;
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    histogram.record(v * 1000);
+  }
+
+  EXPECT_EQ(histogram.count(), 10000u);
+  EXPECT_EQ(histogram.max(), 10000000u);
+  EXPECT_NEAR(histogram.mean(), 5000500.0, 1.0);
+
+  double p50 = static_cast<double>(histogram.percentile(0.5));
+  double p99 = static_cast<double>(histogram.percentile(0.99));
+  EXPECT_NEAR(p50, 5000000.0, 5000000.0 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_NEAR(p99, 9900000.0, 9900000.0 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_EQ(histogram.percentile(1.0), 10000000u);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.percentile(0.5), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// OrderLifecycleManager
+// ---------------------------------------------------------------------------
+
+TEST(OrderLifecycleTest, NewAckFillRecordsLatencies) {
+  OrderLifecycleManager manager(64);
+  VenueId venue = manager.registerVenue("coinbase");
+  EXPECT_EQ(manager.registerVenue("coinbase"), venue);
+
+  OrderHandle handle = manager.onNew(venue, OrderSide::BUY, 100.0, 2.0, 1000);
+  ASSERT_NE(handle, INVALID_ORDER_HANDLE);
+  EXPECT_EQ(manager.openOrderCount(), 1u);
+
+  EXPECT_TRUE(manager.onAck(handle, 1500));
+  EXPECT_FALSE(manager.onAck(handle, 1600)); // Already acknowledged
+  EXPECT_TRUE(manager.onFill(handle, 0.5, 100.0, 3000));
+  EXPECT_TRUE(manager.onFill(handle, 1.5, 101.0, 4000));
+
+  OrderRecord record;
+  ASSERT_TRUE(manager.get(handle, record));
+  EXPECT_EQ(record.state, OrderState::FILLED);
+  EXPECT_DOUBLE_EQ(record.filledQuantity, 2.0);
+  EXPECT_DOUBLE_EQ(record.avgFillPrice, 100.75);
+  EXPECT_EQ(record.ackedAt, 1500u);
+  EXPECT_EQ(record.firstFillAt, 3000u);
+  EXPECT_EQ(record.closedAt, 4000u);
+  EXPECT_EQ(manager.openOrderCount(), 0u);
+
+  EXPECT_EQ(manager.ackLatency(venue).count(), 1u);
+  EXPECT_EQ(manager.ackLatency(venue).max(), 500u);
+  EXPECT_EQ(manager.fillLatency(venue).count(), 1u); // First fill only
+  EXPECT_EQ(manager.fillLatency(venue).max(), 2000u);
+
+  auto report = manager.getLatencyReport();
+  ASSERT_EQ(report.size(), 1u);
+  EXPECT_EQ(report[0].venue, "coinbase");
+  EXPECT_EQ(report[0].ackMax, 500u);
+}
+
+TEST(OrderLifecycleTest, InvalidTransitionsAreRejected) {
+  OrderLifecycleManager manager(64);
+  VenueId venue = manager.registerVenue("kraken");
+
+  OrderHandle rejected = manager.onNew(venue, OrderSide::SELL, 10.0, 1.0, 0);
+  EXPECT_TRUE(manager.onReject(rejected, 10));
+  EXPECT_FALSE(manager.onAck(rejected, 20));
+  EXPECT_FALSE(manager.onFill(rejected, 1.0, 10.0, 30));
+  EXPECT_FALSE(manager.onCancelRequest(rejected, 40));
+
+  OrderHandle live = manager.onNew(venue, OrderSide::SELL, 10.0, 1.0, 0);
+  EXPECT_TRUE(manager.onAck(live, 10));
+  EXPECT_FALSE(manager.onReject(live, 20)); // Only before the ack
+  EXPECT_FALSE(manager.onCancelRejected(live, 20));
+
+  EXPECT_FALSE(manager.onAck(INVALID_ORDER_HANDLE, 0));
+  EXPECT_FALSE(manager.onAck(live + 1000, 0));
+}
+
+TEST(OrderLifecycleTest, CancelFlow) {
+  OrderLifecycleManager manager(64);
+  VenueId venue = manager.registerVenue("binance");
+
+  OrderHandle handle = manager.onNew(venue, OrderSide::BUY, 50.0, 1.0, 0);
+  ASSERT_TRUE(manager.onCancelRequest(handle, 5));
+
+  // An ack racing the cancel is recorded but leaves the cancel pending
+  ASSERT_TRUE(manager.onAck(handle, 10));
+  OrderRecord record;
+  ASSERT_TRUE(manager.get(handle, record));
+  EXPECT_EQ(record.state, OrderState::PENDING_CANCEL);
+
+  // A rejected cancel returns to LIVE since the order was acknowledged
+  ASSERT_TRUE(manager.onCancelRejected(handle, 15));
+  ASSERT_TRUE(manager.get(handle, record));
+  EXPECT_EQ(record.state, OrderState::LIVE);
+
+  ASSERT_TRUE(manager.onCancelRequest(handle, 20));
+  ASSERT_TRUE(manager.onCanceled(handle, 25));
+  ASSERT_TRUE(manager.get(handle, record));
+  EXPECT_EQ(record.state, OrderState::CANCELED);
+  EXPECT_EQ(record.cancelRequestedAt, 20u);
+  EXPECT_EQ(manager.openOrderCount(), 0u);
+}
+
+TEST(OrderLifecycleTest, ApplyStatusReportsFillDelta) {
+  OrderLifecycleManager manager(64);
+  OrderHandle handle = manager.onNew(0, OrderSide::BUY, 20.0, 3.0, 0);
+
+  OrderRecord record;
+  ASSERT_TRUE(manager.applyStatus(handle, OrderStatus::NEW, 0.0, 5, &record));
+  EXPECT_EQ(record.state, OrderState::LIVE);
+  EXPECT_DOUBLE_EQ(record.lastFillQuantity, 0.0);
+
+  ASSERT_TRUE(manager.applyStatus(handle, OrderStatus::PARTIALLY_FILLED, 1.0,
+                                  10, &record));
+  EXPECT_DOUBLE_EQ(record.lastFillQuantity, 1.0);
+
+  // A repeated report carries no new fill
+  ASSERT_TRUE(manager.applyStatus(handle, OrderStatus::PARTIALLY_FILLED, 1.0,
+                                  12, &record));
+  EXPECT_DOUBLE_EQ(record.lastFillQuantity, 0.0);
+
+  ASSERT_TRUE(
+      manager.applyStatus(handle, OrderStatus::CANCELED, 2.5, 20, &record));
+  EXPECT_DOUBLE_EQ(record.lastFillQuantity, 1.5);
+  EXPECT_DOUBLE_EQ(record.filledQuantity, 2.5);
+  EXPECT_EQ(record.state, OrderState::CANCELED);
+
+  EXPECT_FALSE(
+      manager.applyStatus(handle, OrderStatus::FILLED, 3.0, 30, &record));
+}
+
+TEST(OrderLifecycleTest, ApplyStatusRejectsOnlyBeforeTheAck) {
+  OrderLifecycleManager manager(64);
+  OrderRecord record;
+
+  OrderHandle pending = manager.onNew(0, OrderSide::BUY, 20.0, 1.0, 0);
+  ASSERT_TRUE(
+      manager.applyStatus(pending, OrderStatus::REJECTED, 0.0, 5, &record));
+  EXPECT_EQ(record.state, OrderState::REJECTED);
+
+  // A late reject leaves an acknowledged order open
+  OrderHandle live = manager.onNew(0, OrderSide::BUY, 20.0, 1.0, 0);
+  ASSERT_TRUE(manager.applyStatus(live, OrderStatus::NEW, 0.0, 5));
+  EXPECT_FALSE(
+      manager.applyStatus(live, OrderStatus::REJECTED, 0.0, 10, &record));
+  EXPECT_EQ(record.state, OrderState::LIVE);
+  EXPECT_EQ(record.closedAt, 0u);
+  EXPECT_EQ(manager.openOrderCount(), 1u);
+}
+
+TEST(OrderLifecycleTest, ClosedSlotsAreReclaimed) {
+  OrderLifecycleManager manager(8);
+  ASSERT_EQ(manager.capacity(), 8u);
+
+  // Fill every slot with open orders; the next insert has nowhere to go
+  std::vector<OrderHandle> handles;
+  for (int i = 0; i < 8; ++i) {
+    handles.push_back(manager.onNew(0, OrderSide::BUY, 1.0, 1.0, 0));
+    ASSERT_NE(handles.back(), INVALID_ORDER_HANDLE);
+  }
+  EXPECT_EQ(manager.onNew(0, OrderSide::BUY, 1.0, 1.0, 0),
+            INVALID_ORDER_HANDLE);
+
+  // Closing one frees its slot; the evicted record is no longer found
+  ASSERT_TRUE(manager.onCanceled(handles[3], 1));
+  OrderHandle reused = manager.onNew(0, OrderSide::SELL, 2.0, 1.0, 2);
+  ASSERT_NE(reused, INVALID_ORDER_HANDLE);
+
+  OrderRecord record;
+  EXPECT_FALSE(manager.get(handles[3], record));
+  ASSERT_TRUE(manager.get(reused, record));
+  EXPECT_EQ(record.side, OrderSide::SELL);
+  for (int i = 0; i < 8; ++i) {
+    if (i != 3) {
+      EXPECT_TRUE(manager.get(handles[i], record));
+    }
+  }
+  EXPECT_EQ(manager.openOrders().size(), 8u);
+}
+
+TEST(OrderLifecycleTest, ConcurrentLifecycles) {
+  OrderLifecycleManager manager(1 << 12);
+  constexpr int THREADS = 4;
+  constexpr int ORDERS = 2000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t]() {
+      VenueId venue = manager.registerVenue("venue" + std::to_string(t));
+      for (int i = 0; i < ORDERS; ++i) {
+        OrderHandle handle =
+            manager.onNew(venue, OrderSide::BUY, 1.0, 1.0, i * 10);
+        ASSERT_NE(handle, INVALID_ORDER_HANDLE);
+        ASSERT_TRUE(manager.onAck(handle, i * 10 + 1));
+        ASSERT_TRUE(manager.onFill(handle, 1.0, 1.0, i * 10 + 2));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(manager.openOrderCount(), 0u);
+  auto report = manager.getLatencyReport();
+  ASSERT_EQ(report.size(), static_cast<size_t>(THREADS));
+  for (const auto& entry : report) {
+    EXPECT_EQ(entry.ackCount, static_cast<uint64_t>(ORDERS));
+    EXPECT_EQ(entry.ackMax, 1u);
+    EXPECT_EQ(entry.fillMax, 2u);
+  }
+}
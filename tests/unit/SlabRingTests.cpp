@@ -0,0 +1,138 @@
+#include "../../core/utils/SlabRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle::utils;
+
+namespace {
+using Ring = SlabRing<std::string>;
+auto never = []() { return false; };
+} // namespace
+
+TEST(SlabRingTest, PassesSlabsInOrder) {
+  Ring ring(4);
+  EXPECT_EQ(ring.tryConsume(), Ring::NO_SLAB);
+
+  for (int i = 0; i < 3; ++i) {
+    uint32_t slab = ring.tryAcquire();
+    ASSERT_NE(slab, Ring::NO_SLAB);
+    ring.slab(slab) = "frame" + std::to_string(i);
+    ring.publish(slab);
+  }
+  EXPECT_EQ(ring.readyCount(), 3u);
+
+  for (int i = 0; i < 3; ++i) {
+    uint32_t slab = ring.tryConsume();
+    ASSERT_NE(slab, Ring::NO_SLAB);
+    EXPECT_EQ(ring.slab(slab), "frame" + std::to_string(i));
+    ring.release(slab);
+  }
+  EXPECT_EQ(ring.tryConsume(), Ring::NO_SLAB);
+}
+
+TEST(SlabRingTest, RecyclesSlabStorage) {
+  Ring ring(2);
+  for (uint32_t i = 0; i < 2; ++i) {
+    ring.slab(i).reserve(1024);
+  }
+
+  for (int round = 0; round < 100; ++round) {
+    uint32_t slab = ring.acquire(never);
+    const char* storage = ring.slab(slab).data();
+    ring.slab(slab).assign(512, 'x');
+    EXPECT_EQ(ring.slab(slab).data(), storage);
+    ring.publish(slab);
+    ring.release(ring.consume(never));
+  }
+  EXPECT_EQ(ring.getBackpressureStalls(), 0u);
+}
+
+TEST(SlabRingTest, ExhaustedRingHasNoFreeSlab) {
+  Ring ring(3);
+  std::vector<uint32_t> held;
+  for (int i = 0; i < 3; ++i) {
+    held.push_back(ring.tryAcquire());
+    ASSERT_NE(held.back(), Ring::NO_SLAB);
+  }
+  EXPECT_EQ(ring.tryAcquire(), Ring::NO_SLAB);
+
+  ring.publish(held[0]);
+  EXPECT_EQ(ring.tryAcquire(), Ring::NO_SLAB);
+  ring.release(ring.tryConsume());
+  EXPECT_EQ(ring.tryAcquire(), held[0]);
+}
+
+TEST(SlabRingTest, ProducerWaitsForConsumer) {
+  Ring ring(2);
+  ring.publish(ring.tryAcquire());
+  ring.publish(ring.tryAcquire());
+
+  std::atomic<bool> acquired{false};
+  std::thread producer([&]() {
+    uint32_t slab = ring.acquire(never);
+    EXPECT_NE(slab, Ring::NO_SLAB);
+    acquired.store(true);
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(acquired.load());
+
+  ring.release(ring.tryConsume());
+  producer.join();
+  EXPECT_TRUE(acquired.load());
+  EXPECT_EQ(ring.getBackpressureStalls(), 1u);
+  EXPECT_GT(ring.getStallNanos(), 0u);
+}
+
+TEST(SlabRingTest, StopReleasesWaiters) {
+  Ring ring(1);
+  ring.publish(ring.tryAcquire());
+
+  std::atomic<bool> stop{false};
+  auto stopping = [&]() { return stop.load(); };
+  uint32_t acquired = 0;
+  std::thread producer([&]() { acquired = ring.acquire(stopping); });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  stop.store(true);
+  producer.join();
+  EXPECT_EQ(acquired, Ring::NO_SLAB);
+
+  // Published slabs are drained before consume() reports the stop
+  uint32_t slab = ring.consume(stopping);
+  EXPECT_NE(slab, Ring::NO_SLAB);
+  ring.release(slab);
+  EXPECT_EQ(ring.consume(stopping), Ring::NO_SLAB);
+}
+
+TEST(SlabRingTest, ConcurrentHandoffLosesNothing) {
+  constexpr uint64_t COUNT = 200'000;
+  SlabRing<uint64_t> ring(8);
+
+  std::thread producer([&]() {
+    for (uint64_t i = 1; i <= COUNT; ++i) {
+      uint32_t slab = ring.acquire(never);
+      ring.slab(slab) = i;
+      ring.publish(slab);
+    }
+  });
+
+  uint64_t expected = 1;
+  uint64_t sum = 0;
+  for (uint64_t received = 0; received < COUNT; ++received) {
+    uint32_t slab = ring.consume(never);
+    EXPECT_EQ(ring.slab(slab), expected);
+    sum += ring.slab(slab);
+    ++expected;
+    ring.release(slab);
+  }
+  producer.join();
+
+  EXPECT_EQ(sum, COUNT * (COUNT + 1) / 2);
+  EXPECT_EQ(ring.tryConsume(), SlabRing<uint64_t>::NO_SLAB);
+}
@@ -0,0 +1,211 @@
+#include "../../core/utils/SocketTuning.h"
+#include "../../core/utils/TimeUtils.h"
+#include "../../exchange/connector/TimestampedSocket.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <boost/asio/io_context.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using namespace pinnacle;
+using namespace pinnacle::utils;
+
+namespace {
+
+// Connected loopback TCP pair, closed on destruction
+struct TcpPair {
+  int client{-1};
+  int server{-1};
+
+  TcpPair() {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    bind(listener, reinterpret_cast<sockaddr*>(&address), length);
+    listen(listener, 1);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+
+    client = socket(AF_INET, SOCK_STREAM, 0);
+    connect(client, reinterpret_cast<sockaddr*>(&address), length);
+    server = accept(listener, nullptr, nullptr);
+    close(listener);
+  }
+
+  ~TcpPair() {
+    if (client >= 0) {
+      close(client);
+    }
+    if (server >= 0) {
+      close(server);
+    }
+  }
+};
+
+// Unconnected UDP socket bound to a loopback port
+int boundUdp(sockaddr_in& address) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  bind(fd, reinterpret_cast<sockaddr*>(&address), length);
+  getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+  return fd;
+}
+
+} // namespace
+
+TEST(SocketTuningTest, AppliesStreamOptions) {
+  TcpPair pair;
+  ASSERT_GE(pair.client, 0);
+  ASSERT_GE(pair.server, 0);
+
+  SocketTuningConfig config;
+  config.receiveBufferBytes = 64 * 1024;
+  SocketTuningReport report = SocketTuning::apply(pair.server, config);
+
+  EXPECT_TRUE(report.noDelay);
+  EXPECT_GE(report.receiveBufferBytes, 64 * 1024);
+  EXPECT_GT(report.sendBufferBytes, 0);
+  EXPECT_FALSE(report.busyPoll);
+  EXPECT_FALSE(report.timestamps);
+}
+
+TEST(SocketTuningTest, SkipsNoDelayOnDatagramSockets) {
+  sockaddr_in address;
+  int fd = boundUdp(address);
+  ASSERT_GE(fd, 0);
+
+  SocketTuningReport report = SocketTuning::apply(fd, SocketTuningConfig{});
+  EXPECT_FALSE(report.noDelay);
+  EXPECT_GT(report.receiveBufferBytes, 0);
+  close(fd);
+}
+
+#ifdef __linux__
+
+TEST(SocketTuningTest, StampsStreamReceives) {
+  TcpPair pair;
+  SocketTuningReport report =
+      SocketTuning::apply(pair.server, {.kernelTimestamps = true});
+  ASSERT_TRUE(report.timestamps);
+
+  uint64_t before = TimeUtils::getWallClockNanos();
+  ASSERT_EQ(write(pair.client, "hello", 5), 5);
+
+  char buffer[16];
+  uint64_t kernelTime = 0;
+  ssize_t received =
+      SocketTuning::receive(pair.server, buffer, sizeof(buffer), 0, kernelTime);
+  uint64_t after = TimeUtils::getWallClockNanos();
+
+  ASSERT_EQ(received, 5);
+  EXPECT_EQ(std::string_view(buffer, 5), "hello");
+  EXPECT_GE(kernelTime, before);
+  EXPECT_LE(kernelTime, after);
+}
+
+TEST(SocketTuningTest, LeavesTimeUnchangedWithoutTimestamps) {
+  TcpPair pair;
+  ASSERT_EQ(write(pair.client, "x", 1), 1);
+
+  char buffer[4];
+  uint64_t kernelTime = 42;
+  ASSERT_EQ(
+      SocketTuning::receive(pair.server, buffer, sizeof(buffer), 0, kernelTime),
+      1);
+  EXPECT_EQ(kernelTime, 42u);
+}
+
+TEST(SocketTuningTest, ReportsIncomingCpuAfterTraffic) {
+  TcpPair pair;
+  ASSERT_EQ(write(pair.client, "x", 1), 1);
+  char buffer[4];
+  uint64_t kernelTime = 0;
+  ASSERT_EQ(
+      SocketTuning::receive(pair.server, buffer, sizeof(buffer), 0, kernelTime),
+      1);
+
+  SocketPlacement placement = SocketTuning::placement(pair.server);
+  EXPECT_GE(placement.incomingCpu, 0);
+}
+
+TEST(DatagramBatchReceiverTest, ReceivesBurstInOneCall) {
+  sockaddr_in address;
+  int receiver = boundUdp(address);
+  ASSERT_TRUE(
+      SocketTuning::apply(receiver, {.kernelTimestamps = true}).timestamps);
+
+  int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  uint64_t before = TimeUtils::getWallClockNanos();
+  for (int i = 0; i < 5; ++i) {
+    std::string datagram = "packet" + std::to_string(i);
+    sendto(sender, datagram.data(), datagram.size(), 0,
+           reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  }
+
+  DatagramBatchReceiver batch(8, 64);
+  ASSERT_EQ(batch.receive(receiver), 5);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(batch.message(i), "packet" + std::to_string(i));
+    EXPECT_GE(batch.kernelTime(i), before);
+    if (i > 0) {
+      EXPECT_GE(batch.kernelTime(i), batch.kernelTime(i - 1));
+    }
+  }
+  EXPECT_EQ(batch.receive(receiver), 0);
+
+  close(sender);
+  close(receiver);
+}
+
+TEST(DatagramBatchReceiverTest, TruncatesLongDatagrams) {
+  sockaddr_in address;
+  int receiver = boundUdp(address);
+  int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  std::string datagram(100, 'a');
+  sendto(sender, datagram.data(), datagram.size(), 0,
+         reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+  DatagramBatchReceiver batch(4, 16);
+  ASSERT_EQ(batch.receive(receiver), 1);
+  EXPECT_EQ(batch.message(0), std::string(16, 'a'));
+  EXPECT_EQ(batch.kernelTime(0), 0u);
+
+  close(sender);
+  close(receiver);
+}
+
+TEST(TimestampedSocketTest, ReadsStampWithKernelTime) {
+  TcpPair pair;
+  boost::asio::io_context ioContext;
+  exchange::TimestampedSocket socket(ioContext);
+  socket.next_layer().assign(boost::asio::ip::tcp::v4(), pair.server);
+  pair.server = -1; // Now owned by the socket
+  SocketTuning::apply(socket.lowest_layer().native_handle(),
+                      {.kernelTimestamps = true});
+  EXPECT_EQ(socket.lastKernelTime(), 0u);
+
+  uint64_t before = TimeUtils::getWallClockNanos();
+  ASSERT_EQ(write(pair.client, "frame", 5), 5);
+
+  char buffer[16];
+  boost::system::error_code ec;
+  size_t bytes = socket.read_some(boost::asio::buffer(buffer), ec);
+  ASSERT_FALSE(ec);
+  EXPECT_EQ(std::string_view(buffer, bytes), "frame");
+  EXPECT_GE(socket.lastKernelTime(), before);
+
+  close(pair.client);
+  pair.client = -1;
+  socket.read_some(boost::asio::buffer(buffer), ec);
+  EXPECT_EQ(ec, boost::asio::error::eof);
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include "../../strategies/backtesting/BacktestEngine.h"
+#include "../../strategies/backtesting/TickStore.h"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace pinnacle::backtesting;
+
+namespace {
+
+constexpr uint64_t SECOND = 1000000000ULL;
+constexpr uint64_t DAY = 86400 * SECOND;
+// 2024-01-02T00:00:00Z
+constexpr uint64_t DAY_START = 19724 * DAY;
+
+Tick makeTick(uint64_t timestamp, double price) {
+  Tick tick;
+  tick.timestamp = timestamp;
+  tick.price = price;
+  tick.size = 0.125;
+  tick.side = price > 100.0 ? TickSide::BUY : TickSide::SELL;
+  tick.bid = price - 0.01;
+  tick.ask = price + 0.01;
+  return tick;
+}
+
+} // namespace
+
+class TickStoreTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    root_ = "test_tick_store";
+    std::filesystem::remove_all(root_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(root_); }
+
+  // count ticks a second apart from start, prices oscillating around 100
+  void writeTicks(uint64_t start, size_t count, size_t blockSize = 64) {
+    TickStoreConfig config;
+    config.blockSize = blockSize;
+    TickStoreWriter writer(root_, "BTC-USD", config);
+    for (size_t i = 0; i < count; ++i) {
+      double price = 100.0 + static_cast<double>(i % 7) * 0.01 - 0.03;
+      ASSERT_TRUE(writer.append(makeTick(start + i * SECOND, price)));
+    }
+    ASSERT_TRUE(writer.close());
+  }
+
+  std::string root_;
+};
+
+TEST_F(TickStoreTest, RoundTripsEveryColumn) {
+  writeTicks(DAY_START, 1000);
+
+  TickStore store(root_);
+  ASSERT_TRUE(store.hasSymbol("BTC-USD"));
+  EXPECT_FALSE(store.hasSymbol("ETH-USD"));
+
+  std::vector<Tick> ticks;
+  auto stats = store.query("BTC-USD", 0, UINT64_MAX, ticks);
+  ASSERT_EQ(ticks.size(), 1000);
+  EXPECT_EQ(stats.ticks, 1000);
+  EXPECT_EQ(stats.files, 1);
+
+  for (size_t i = 0; i < ticks.size(); ++i) {
+    double price = 100.0 + static_cast<double>(i % 7) * 0.01 - 0.03;
+    Tick expected = makeTick(DAY_START + i * SECOND, price);
+    EXPECT_EQ(ticks[i].timestamp, expected.timestamp);
+    EXPECT_NEAR(ticks[i].price, expected.price, 1e-9);
+    EXPECT_NEAR(ticks[i].bid, expected.bid, 1e-9);
+    EXPECT_NEAR(ticks[i].ask, expected.ask, 1e-9);
+    EXPECT_DOUBLE_EQ(ticks[i].size, 0.125);
+    EXPECT_EQ(ticks[i].side, expected.side);
+  }
+}
+
+TEST_F(TickStoreTest, CompressesBelowRawSize) {
+  writeTicks(DAY_START, 10000, 4096);
+
+  auto path = root_ + "/BTC-USD/2024-01-02.ticks";
+  ASSERT_TRUE(std::filesystem::exists(path));
+  // Raw, a tick takes 41 bytes; here the second between ticks and the
+  // cent price moves take most of what is left
+  EXPECT_LT(std::filesystem::file_size(path), 10000 * 41 / 3);
+}
+
+TEST_F(TickStoreTest, SplitsFilesByUtcDay) {
+  // From an hour before midnight to an hour after
+  TickStoreWriter writer(root_, "BTC-USD");
+  for (uint64_t t = DAY_START - 3600 * SECOND; t < DAY_START + 3600 * SECOND;
+       t += 60 * SECOND) {
+    ASSERT_TRUE(writer.append(makeTick(t, 100.0)));
+  }
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(writer.getFilesWritten(), 2);
+  EXPECT_EQ(writer.getTicksWritten(), 120);
+
+  TickStore store(root_);
+  auto days = store.listDays("BTC-USD");
+  ASSERT_EQ(days.size(), 2);
+  EXPECT_EQ(days[0], "2024-01-01");
+  EXPECT_EQ(days[1], "2024-01-02");
+  EXPECT_EQ(TickStore::dayName(DAY_START + 5), "2024-01-02");
+
+  // Only the second day is opened for a range within it
+  std::vector<Tick> ticks;
+  auto stats =
+      store.query("BTC-USD", DAY_START, DAY_START + 600 * SECOND, ticks);
+  EXPECT_EQ(stats.files, 1);
+  EXPECT_EQ(ticks.size(), 11);
+  EXPECT_EQ(ticks.front().timestamp, DAY_START);
+}
+
+TEST_F(TickStoreTest, SkipsBlocksOutsideTheRange) {
+  writeTicks(DAY_START, 6400, 64); // 100 blocks of 64 seconds
+
+  TickStore store(root_);
+  std::vector<Tick> ticks;
+  uint64_t start = DAY_START + 3200 * SECOND;
+  auto stats = store.query("BTC-USD", start, start + 63 * SECOND, ticks);
+
+  ASSERT_EQ(ticks.size(), 64);
+  EXPECT_EQ(ticks.front().timestamp, start);
+  EXPECT_EQ(ticks.back().timestamp, start + 63 * SECOND);
+  EXPECT_EQ(stats.blocksRead, 1);
+  EXPECT_EQ(stats.blocksSkipped, 99);
+
+  // A range straddling a block boundary reads both blocks and trims them
+  ticks.clear();
+  stats = store.query("BTC-USD", start - 2 * SECOND, start + SECOND, ticks);
+  EXPECT_EQ(ticks.size(), 4);
+  EXPECT_EQ(stats.blocksRead, 2);
+
+  ticks.clear();
+  stats = store.query("BTC-USD", start + 10, start + 20, ticks);
+  EXPECT_TRUE(ticks.empty());
+  EXPECT_TRUE(store.query("BTC-USD", start, start - 1, ticks).files == 0);
+}
+
+TEST_F(TickStoreTest, RejectsTicksOutOfOrder) {
+  TickStoreWriter writer(root_, "BTC-USD");
+  ASSERT_TRUE(writer.append(makeTick(DAY_START + 10 * SECOND, 100.0)));
+  EXPECT_TRUE(writer.append(makeTick(DAY_START + 10 * SECOND, 100.0)));
+  EXPECT_FALSE(writer.append(makeTick(DAY_START + 5 * SECOND, 100.0)));
+  EXPECT_FALSE(writer.append(makeTick(DAY_START - DAY, 100.0)));
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(writer.getTicksWritten(), 2);
+}
+
+TEST_F(TickStoreTest, IgnoresUnfinishedAndDamagedFiles) {
+  writeTicks(DAY_START, 100);
+  {
+    // A writer that died before close() leaves its header zeroed
+    std::filesystem::create_directories(root_ + "/BTC-USD");
+    std::ofstream unfinished(root_ + "/BTC-USD/2024-01-03.ticks",
+                             std::ios::binary);
+    std::string zeros(4096, '\0');
+    unfinished.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+  }
+  {
+    // Truncated in the middle of the blocks
+    writeTicks(DAY_START + DAY * 2 + DAY, 100);
+    auto path = root_ + "/BTC-USD/2024-01-05.ticks";
+    std::filesystem::resize_file(path, 200);
+  }
+
+  TickStore store(root_);
+  std::vector<Tick> ticks;
+  auto stats = store.query("BTC-USD", 0, UINT64_MAX, ticks);
+  EXPECT_EQ(ticks.size(), 100);
+  EXPECT_EQ(stats.files, 1);
+}
+
+TEST_F(TickStoreTest, SkipsADamagedBlockAndReadsTheRest) {
+  writeTicks(DAY_START, 640, 64); // 10 blocks of 64 seconds
+
+  // Overwrite the tick count in the fifth block's header
+  auto path = root_ + "/BTC-USD/2024-01-02.ticks";
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    TickFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    ASSERT_EQ(header.blockCount, 10);
+    TickBlockIndex entry;
+    file.seekg(static_cast<std::streamoff>(header.indexOffset +
+                                           4 * sizeof(TickBlockIndex)));
+    file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+    uint32_t tickCount = entry.tickCount + 1;
+    file.seekp(static_cast<std::streamoff>(entry.offset));
+    file.write(reinterpret_cast<const char*>(&tickCount), sizeof(tickCount));
+    ASSERT_TRUE(file.good());
+  }
+
+  TickStore store(root_);
+  std::vector<Tick> ticks;
+  auto stats = store.query("BTC-USD", 0, UINT64_MAX, ticks);
+  EXPECT_EQ(stats.blocksRead, 9);
+  EXPECT_EQ(stats.blocksDamaged, 1);
+  ASSERT_EQ(ticks.size(), 576);
+  EXPECT_EQ(ticks[255].timestamp, DAY_START + 255 * SECOND);
+  EXPECT_EQ(ticks[256].timestamp, DAY_START + 320 * SECOND);
+  EXPECT_EQ(ticks.back().timestamp, DAY_START + 639 * SECOND);
+}
+
+TEST_F(TickStoreTest, FeedsHistoricalDataManager) {
+  std::string dataDirectory = root_ + "/data";
+  {
+    TickStoreWriter writer(dataDirectory + "/ticks", "BTC-USD");
+    for (size_t i = 0; i < 500; ++i) {
+      ASSERT_TRUE(writer.append(makeTick(DAY_START + i * SECOND, 100.0)));
+    }
+  }
+
+  HistoricalDataManager manager(dataDirectory);
+  ASSERT_TRUE(manager.loadData("BTC-USD", DAY_START + 100 * SECOND,
+                               DAY_START + 199 * SECOND));
+  EXPECT_EQ(manager.getDataPointCount(), 100);
+  EXPECT_EQ(manager.getStartTime(), DAY_START + 100 * SECOND);
+  EXPECT_TRUE(manager.validateDataIntegrity());
+
+  auto point = manager.getNextDataPoint();
+  EXPECT_NEAR(point.spread, 0.02, 1e-9);
+  EXPECT_DOUBLE_EQ(point.volume, 0.125);
+}
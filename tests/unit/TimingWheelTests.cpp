@@ -0,0 +1,181 @@
+#include "../../core/utils/LockFreeQueue.h"
+#include "../../core/utils/TimingWheel.h"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace pinnacle::utils;
+
+namespace {
+constexpr uint64_t TICK = 1000; // 1us ticks keep the arithmetic readable
+} // namespace
+
+// ---------------------------------------------------------------------------
+// HierarchicalTimingWheel
+// ---------------------------------------------------------------------------
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+  HierarchicalTimingWheel<int> wheel(TICK, 0);
+  wheel.schedule(5 * TICK, 42);
+
+  std::vector<int> fired;
+  wheel.advance(4 * TICK, [&](int&& v) { fired.push_back(v); });
+  EXPECT_TRUE(fired.empty());
+
+  wheel.advance(5 * TICK, [&](int&& v) { fired.push_back(v); });
+  ASSERT_EQ(fired.size(), 1u);
+  EXPECT_EQ(fired[0], 42);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, PastDeadlineFiresOnNextTick) {
+  HierarchicalTimingWheel<int> wheel(TICK, 100 * TICK);
+  wheel.schedule(10 * TICK, 1);
+
+  size_t fired = wheel.advance(101 * TICK, [](int&&) {});
+  EXPECT_EQ(fired, 1u);
+}
+
+TEST(TimingWheelTest, CancelPreventsFiring) {
+  HierarchicalTimingWheel<int> wheel(TICK, 0);
+  auto keep = wheel.schedule(10 * TICK, 1);
+  auto drop = wheel.schedule(10 * TICK, 2);
+
+  EXPECT_TRUE(wheel.cancel(drop));
+  EXPECT_FALSE(wheel.cancel(drop)); // Already canceled
+  EXPECT_EQ(wheel.size(), 1u);
+
+  std::vector<int> fired;
+  wheel.advance(20 * TICK, [&](int&& v) { fired.push_back(v); });
+  ASSERT_EQ(fired.size(), 1u);
+  EXPECT_EQ(fired[0], 1);
+
+  // Handle of a fired timer is stale even after its node is reused
+  wheel.schedule(30 * TICK, 3);
+  EXPECT_FALSE(wheel.cancel(keep));
+  EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST(TimingWheelTest, CascadesFromHigherLevels) {
+  HierarchicalTimingWheel<uint64_t> wheel(TICK, 0);
+
+  // Deadlines spanning level 0, 1 and 2 of a 256-slot wheel
+  std::vector<uint64_t> deadlines = {3, 255, 256, 1000, 65535, 65536, 300000};
+  for (auto d : deadlines) {
+    wheel.schedule(d * TICK, d);
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> fired; // (deadline, fire tick)
+  for (uint64_t t = 1; t <= 300000; ++t) {
+    wheel.advance(t * TICK,
+                  [&](uint64_t&& d) { fired.emplace_back(d, t); });
+  }
+
+  ASSERT_EQ(fired.size(), deadlines.size());
+  for (const auto& [deadline, tick] : fired) {
+    EXPECT_EQ(deadline, tick);
+  }
+}
+
+TEST(TimingWheelTest, RandomizedOrderingMatchesDeadlines) {
+  HierarchicalTimingWheel<uint64_t> wheel(TICK, 0, 16);
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<uint64_t> dist(1, 200000);
+
+  for (int i = 0; i < 5000; ++i) {
+    uint64_t d = dist(rng);
+    wheel.schedule(d * TICK, d);
+  }
+
+  uint64_t lastDeadline = 0;
+  size_t count = 0;
+  bool ordered = true;
+  wheel.advance(200000 * TICK, [&](uint64_t&& d) {
+    ordered = ordered && d >= lastDeadline;
+    lastDeadline = d;
+    ++count;
+  });
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(count, 5000u);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, CallbackMayRescheduleAndCancel) {
+  HierarchicalTimingWheel<int> wheel(TICK, 0);
+  auto first = wheel.schedule(5 * TICK, 1);
+  auto second = wheel.schedule(5 * TICK, 2);
+
+  int fired = 0;
+  wheel.advance(5 * TICK, [&](int&& v) {
+    ++fired;
+    // Whichever fires first cancels the other and re-arms itself
+    wheel.cancel(v == 1 ? second : first);
+    wheel.schedule(8 * TICK, v + 10);
+  });
+  EXPECT_EQ(fired, 1);
+  EXPECT_EQ(wheel.size(), 1u);
+
+  wheel.advance(8 * TICK, [&](int&&) { ++fired; });
+  EXPECT_EQ(fired, 2);
+  EXPECT_TRUE(wheel.empty());
+}
+
+// ---------------------------------------------------------------------------
+// BlockingMPMCQueue
+// ---------------------------------------------------------------------------
+
+TEST(BlockingQueueTest, WaitDequeueTimesOutWhenEmpty) {
+  BlockingMPMCQueue<int, 16> queue;
+  int value = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(queue.waitDequeue(value, std::chrono::milliseconds(20)));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(15));
+}
+
+TEST(BlockingQueueTest, ProducerWakesParkedConsumer) {
+  BlockingMPMCQueue<int, 1024> queue;
+  constexpr int COUNT = 10000;
+
+  std::thread consumer([&] {
+    int expected = 0;
+    int value = 0;
+    while (expected < COUNT) {
+      if (queue.waitDequeue(value, std::chrono::seconds(5))) {
+        EXPECT_EQ(value, expected);
+        ++expected;
+      } else {
+        ADD_FAILURE() << "consumer missed a wakeup";
+        return;
+      }
+    }
+  });
+
+  for (int i = 0; i < COUNT; ++i) {
+    while (!queue.tryEnqueue(i)) {
+      std::this_thread::yield();
+    }
+  }
+
+  consumer.join();
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(BlockingQueueTest, WakeAllReleasesWaiters) {
+  BlockingMPMCQueue<int, 16> queue;
+  std::thread waiter([&] {
+    int value = 0;
+    EXPECT_FALSE(queue.waitDequeue(value, std::chrono::seconds(30)));
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto start = std::chrono::steady_clock::now();
+  queue.wakeAll();
+  waiter.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
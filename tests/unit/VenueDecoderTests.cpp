@@ -0,0 +1,355 @@
+#include "../../exchange/connector/VenueDecoder.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pinnacle::exchange;
+
+namespace {
+
+constexpr int64_t fp(double v) {
+  return static_cast<int64_t>(v * FIXED_POINT_SCALE + (v < 0 ? -0.5 : 0.5));
+}
+
+class VenueDecoderTest : public ::testing::Test {
+protected:
+  SymbolTable m_symbols;
+  MarketEventBuffer m_out{m_symbols};
+  std::unique_ptr<VenueDecoder> m_decoder;
+
+  DecodedFrame decode(Venue venue, const std::string& frame) {
+    if (!m_decoder || m_decoder->venue() != venue) {
+      m_decoder = createVenueDecoder(venue);
+    }
+    m_out.reset(venue, 42);
+    return m_decoder->decode(frame, 42, m_out);
+  }
+
+  const MarketEvent& event(size_t i) { return m_out.events().at(i); }
+
+  std::string symbolOf(size_t i) { return m_symbols.name(event(i).symbolId); }
+
+  void expectDelta(size_t i, EventSide side, double price, double quantity,
+                   uint8_t flags = 0) {
+    SCOPED_TRACE("event " + std::to_string(i));
+    EXPECT_EQ(event(i).type, MarketEventType::BOOK_DELTA);
+    EXPECT_EQ(event(i).side, side);
+    EXPECT_EQ(event(i).price, fp(price));
+    EXPECT_EQ(event(i).quantity, fp(quantity));
+    EXPECT_EQ(event(i).flags, flags);
+  }
+};
+
+} // namespace
+
+TEST_F(VenueDecoderTest, CoinbaseTickerBecomesBboAndTrade) {
+  auto decoded = decode(
+      Venue::COINBASE,
+      R"({"channel":"ticker","timestamp":"2024-01-01T00:00:00Z",)"
+      R"("sequence_num":7,"events":[{"type":"update","tickers":[{)"
+      R"("product_id":"BTC-USD","price":"50000.5","best_bid":"50000",)"
+      R"("best_bid_quantity":"1.5","best_ask":"50001",)"
+      R"("best_ask_quantity":"2","last_size":"0.1"}]}]})");
+
+  EXPECT_EQ(decoded.kind, FrameKind::DATA);
+  EXPECT_EQ(decoded.sequenceStream, DecodedFrame::CONNECTION_SEQUENCE);
+  EXPECT_EQ(decoded.firstSequence, 7u);
+  ASSERT_EQ(m_out.size(), 2u);
+  EXPECT_EQ(event(0).type, MarketEventType::BBO);
+  EXPECT_EQ(event(0).price, fp(50000));
+  EXPECT_EQ(event(0).quantity, fp(1.5));
+  EXPECT_EQ(event(0).askPrice, fp(50001));
+  EXPECT_EQ(event(0).askQuantity, fp(2));
+  EXPECT_EQ(event(1).type, MarketEventType::TRADE);
+  EXPECT_EQ(event(1).price, fp(50000.5));
+  EXPECT_EQ(event(1).quantity, fp(0.1));
+  EXPECT_EQ(event(1).sequence, 7u);
+  EXPECT_EQ(event(1).receivedAt, 42u);
+  EXPECT_EQ(event(1).venue, Venue::COINBASE);
+  EXPECT_EQ(symbolOf(1), "BTC-USD");
+}
+
+TEST_F(VenueDecoderTest, CoinbaseSnapshotResetsTheBook) {
+  auto decoded = decode(
+      Venue::COINBASE,
+      R"({"channel":"l2_data","events":[{"type":"snapshot",)"
+      R"("product_id":"ETH-USD","updates":[)"
+      R"({"side":"bid","price_level":"3000","new_quantity":"4"},)"
+      R"({"side":"offer","price_level":"3001","new_quantity":"5"}]}],)"
+      R"("sequence_num":1})");
+
+  EXPECT_EQ(decoded.kind, FrameKind::SNAPSHOT);
+  EXPECT_EQ(decoded.lastSequence, 1u);
+  ASSERT_EQ(m_out.size(), 3u);
+  EXPECT_EQ(event(0).type, MarketEventType::BOOK_RESET);
+  EXPECT_EQ(event(0).flags, EVENT_FLAG_SNAPSHOT);
+  expectDelta(1, EventSide::BID, 3000, 4, EVENT_FLAG_SNAPSHOT);
+  expectDelta(2, EventSide::ASK, 3001, 5, EVENT_FLAG_SNAPSHOT);
+  // The sequence number came after the events but still stamps them
+  EXPECT_EQ(event(2).sequence, 1u);
+}
+
+TEST_F(VenueDecoderTest, CoinbaseResyncResubscribesToLevel2) {
+  auto decoder = createVenueDecoder(Venue::COINBASE);
+  auto messages = decoder->resyncRequest("BTC-USD");
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_NE(messages[0].find("\"unsubscribe\""), std::string::npos);
+  EXPECT_NE(messages[1].find("\"subscribe\""), std::string::npos);
+  EXPECT_NE(messages[1].find("level2"), std::string::npos);
+}
+
+TEST_F(VenueDecoderTest, BinanceDepthUpdateCarriesUpdateIds) {
+  auto decoded = decode(
+      Venue::BINANCE,
+      R"({"stream":"btcusdt@depth@100ms","data":{"e":"depthUpdate",)"
+      R"("E":1700000000123,"s":"BTCUSDT","U":157,"u":160,)"
+      R"("b":[["0.0024","10"]],"a":[["0.0026","100"],["0.0027","0"]]}})");
+
+  EXPECT_EQ(decoded.kind, FrameKind::DATA);
+  EXPECT_EQ(decoded.sequenceStream, m_symbols.intern("BTCUSDT"));
+  EXPECT_EQ(decoded.firstSequence, 157u);
+  EXPECT_EQ(decoded.lastSequence, 160u);
+  ASSERT_EQ(m_out.size(), 3u);
+  expectDelta(0, EventSide::BID, 0.0024, 10);
+  expectDelta(1, EventSide::ASK, 0.0026, 100);
+  expectDelta(2, EventSide::ASK, 0.0027, 0);
+  EXPECT_EQ(event(0).venueTimestamp, 1700000000123'000'000ULL);
+  EXPECT_EQ(event(0).sequence, 160u);
+}
+
+TEST_F(VenueDecoderTest, BinanceTradeSideIsTheAggressor) {
+  decode(Venue::BINANCE,
+         R"({"stream":"btcusdt@trade","data":{"e":"trade","E":1,)"
+         R"("s":"BTCUSDT","t":12345,"p":"0.001","q":"100","T":2,)"
+         R"("m":true,"M":true}})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::TRADE);
+  EXPECT_EQ(event(0).side, EventSide::ASK); // Buyer was the maker
+  EXPECT_EQ(event(0).price, fp(0.001));
+  EXPECT_EQ(event(0).quantity, fp(100));
+  EXPECT_EQ(event(0).venueTimestamp, 2'000'000u);
+
+  decode(Venue::BINANCE, R"({"stream":"btcusdt@trade","data":{"e":"trade",)"
+                         R"("s":"BTCUSDT","p":"1","q":"1","m":false}})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).side, EventSide::BID);
+}
+
+TEST_F(VenueDecoderTest, BinanceBookTickerAndPartialDepth) {
+  decode(Venue::BINANCE,
+         R"({"stream":"bnbusdt@bookTicker","data":{"u":400900217,)"
+         R"("s":"BNBUSDT","b":"25.35","B":"31.21","a":"25.36","A":"40.66"}})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::BBO);
+  EXPECT_EQ(event(0).price, fp(25.35));
+  EXPECT_EQ(event(0).quantity, fp(31.21));
+  EXPECT_EQ(event(0).askPrice, fp(25.36));
+  EXPECT_EQ(event(0).askQuantity, fp(40.66));
+
+  // Partial depth frames name the symbol only in the stream
+  auto decoded = decode(
+      Venue::BINANCE,
+      R"({"stream":"bnbusdt@depth20@100ms","data":{"lastUpdateId":160,)"
+      R"("bids":[["25.35","31.21"]],"asks":[["25.36","40.66"]]}})");
+  EXPECT_EQ(decoded.kind, FrameKind::SNAPSHOT);
+  EXPECT_EQ(decoded.sequenceStream, m_symbols.intern("BNBUSDT"));
+  EXPECT_EQ(decoded.lastSequence, 160u);
+  ASSERT_EQ(m_out.size(), 3u);
+  EXPECT_EQ(event(0).type, MarketEventType::BOOK_RESET);
+  EXPECT_EQ(symbolOf(0), "BNBUSDT");
+  expectDelta(1, EventSide::BID, 25.35, 31.21, EVENT_FLAG_SNAPSHOT);
+}
+
+TEST_F(VenueDecoderTest, BinanceControlFramesAndSubscriptions) {
+  EXPECT_EQ(decode(Venue::BINANCE, R"({"result":null,"id":1})").kind,
+            FrameKind::CONTROL);
+  EXPECT_EQ(decode(Venue::BINANCE,
+                   R"({"error":{"code":2,"msg":"Invalid request"},"id":2})")
+                .kind,
+            FrameKind::ERROR);
+
+  // Raw single-stream payloads decode as well
+  decode(Venue::BINANCE, R"({"e":"trade","s":"BTCUSDT","p":"1","q":"2"})");
+  EXPECT_EQ(m_out.size(), 1u);
+
+  auto decoder = createVenueDecoder(Venue::BINANCE);
+  EXPECT_EQ(decoder->venueSymbol("BTC-USDT"), "BTCUSDT");
+  auto messages = decoder->subscriptionMessages("BTC-USDT");
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_NE(messages[0].find("btcusdt@depth@100ms"), std::string::npos);
+  EXPECT_NE(messages[0].find("btcusdt@bookTicker"), std::string::npos);
+  EXPECT_NE(decoder->resyncRequest("BTC-USDT")[0].find("depth20"),
+            std::string::npos);
+  EXPECT_NE(decoder->resyncComplete("BTC-USDT")[0].find("UNSUBSCRIBE"),
+            std::string::npos);
+}
+
+TEST_F(VenueDecoderTest, KrakenBookTradeAndTicker) {
+  auto decoded = decode(
+      Venue::KRAKEN,
+      R"({"channel":"book","type":"snapshot","data":[{"symbol":"BTC/USD",)"
+      R"("bids":[{"price":45283.5,"qty":0.1}],"asks":[{"price":45285.2,)"
+      R"("qty":0.00100000}],"checksum":3310070434}]})");
+  EXPECT_EQ(decoded.kind, FrameKind::SNAPSHOT);
+  EXPECT_EQ(decoded.sequenceStream, DecodedFrame::NO_SEQUENCE);
+  ASSERT_EQ(m_out.size(), 3u);
+  EXPECT_EQ(event(0).type, MarketEventType::BOOK_RESET);
+  expectDelta(1, EventSide::BID, 45283.5, 0.1, EVENT_FLAG_SNAPSHOT);
+  expectDelta(2, EventSide::ASK, 45285.2, 0.001, EVENT_FLAG_SNAPSHOT);
+
+  decoded = decode(
+      Venue::KRAKEN,
+      R"({"channel":"book","type":"update","data":[{"symbol":"BTC/USD",)"
+      R"("bids":[],"asks":[{"price":45285.2,"qty":0}],"checksum":1,)"
+      R"("timestamp":"2023-10-06T17:35:55.440295Z"}]})");
+  EXPECT_EQ(decoded.kind, FrameKind::DATA);
+  ASSERT_EQ(m_out.size(), 1u);
+  expectDelta(0, EventSide::ASK, 45285.2, 0);
+  EXPECT_EQ(event(0).venueTimestamp, 1696613755440295000ULL);
+
+  decode(Venue::KRAKEN,
+         R"({"channel":"trade","type":"update","data":[{"symbol":"BTC/USD",)"
+         R"("side":"sell","price":45284,"qty":0.5,"ord_type":"market",)"
+         R"("trade_id":1,"timestamp":"2023-10-06T17:35:55.440295Z"}]})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::TRADE);
+  EXPECT_EQ(event(0).side, EventSide::ASK);
+  EXPECT_EQ(event(0).price, fp(45284));
+
+  // Trade snapshots are history and are skipped
+  decode(Venue::KRAKEN,
+         R"({"channel":"trade","type":"snapshot","data":[{"symbol":"BTC/USD",)"
+         R"("side":"buy","price":1,"qty":1}]})");
+  EXPECT_EQ(m_out.size(), 0u);
+
+  decode(Venue::KRAKEN,
+         R"({"channel":"ticker","type":"update","data":[{"symbol":"BTC/USD",)"
+         R"("bid":45283.5,"bid_qty":1.2,"ask":45285.2,"ask_qty":0.3,)"
+         R"("last":45284}]})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::BBO);
+  EXPECT_EQ(event(0).askQuantity, fp(0.3));
+}
+
+TEST_F(VenueDecoderTest, KrakenControlFrames) {
+  EXPECT_EQ(decode(Venue::KRAKEN, R"({"channel":"heartbeat"})").kind,
+            FrameKind::HEARTBEAT);
+  EXPECT_EQ(decode(Venue::KRAKEN,
+                   R"({"method":"subscribe","result":{"channel":"book"},)"
+                   R"("success":true,"time_in":"x","time_out":"y"})")
+                .kind,
+            FrameKind::CONTROL);
+  EXPECT_EQ(decode(Venue::KRAKEN,
+                   R"({"method":"subscribe","error":"Currency pair not )"
+                   R"(supported","success":false})")
+                .kind,
+            FrameKind::ERROR);
+  EXPECT_EQ(createVenueDecoder(Venue::KRAKEN)->venueSymbol("BTC-USD"),
+            "BTC/USD");
+}
+
+TEST_F(VenueDecoderTest, BitstampBookAndTrades) {
+  auto decoded =
+      decode(Venue::BITSTAMP,
+             R"({"data":{"timestamp":"1643649599",)"
+             R"("microtimestamp":"1643649599863530","bids":[["36822",)"
+             R"("0.1"]],"asks":[["36830","0"]]},)"
+             R"("channel":"diff_order_book_btcusd","event":"data"})");
+  EXPECT_EQ(decoded.kind, FrameKind::DATA);
+  ASSERT_EQ(m_out.size(), 2u);
+  expectDelta(0, EventSide::BID, 36822, 0.1);
+  expectDelta(1, EventSide::ASK, 36830, 0);
+  EXPECT_EQ(event(0).venueTimestamp, 1643649599863530000ULL);
+  EXPECT_EQ(symbolOf(0), "btcusd");
+
+  decode(Venue::BITSTAMP,
+         R"({"data":{"id":1,"amount":0.01,"amount_str":"0.01",)"
+         R"("price":36820,"price_str":"36820","type":1,)"
+         R"("microtimestamp":"1643649599863530"},)"
+         R"("channel":"live_trades_btcusd","event":"trade"})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::TRADE);
+  EXPECT_EQ(event(0).side, EventSide::ASK);
+  EXPECT_EQ(event(0).quantity, fp(0.01));
+
+  decoded = decode(Venue::BITSTAMP,
+                   R"({"data":{"bids":[["1","2"]],"asks":[]},)"
+                   R"("channel":"order_book_btcusd","event":"data"})");
+  EXPECT_EQ(decoded.kind, FrameKind::SNAPSHOT);
+  ASSERT_EQ(m_out.size(), 2u);
+  EXPECT_EQ(event(0).type, MarketEventType::BOOK_RESET);
+
+  EXPECT_EQ(decode(Venue::BITSTAMP, R"({"event":"bts:heartbeat"})").kind,
+            FrameKind::HEARTBEAT);
+  EXPECT_EQ(decode(Venue::BITSTAMP,
+                   R"({"event":"bts:subscription_succeeded",)"
+                   R"("channel":"live_trades_btcusd","data":{}})")
+                .kind,
+            FrameKind::CONTROL);
+}
+
+TEST_F(VenueDecoderTest, GeminiFirstUpdateIsASnapshot) {
+  auto decoded = decode(
+      Venue::GEMINI,
+      R"({"type":"l2_updates","symbol":"BTCUSD","changes":[)"
+      R"(["buy","9122.04","0.00121425"],["sell","9122.07","0.98942286"]],)"
+      R"("trades":[{"type":"trade","symbol":"BTCUSD","price":"9122.04",)"
+      R"("quantity":"0.0073173","side":"sell"}],"auction_events":[]})");
+  EXPECT_EQ(decoded.kind, FrameKind::SNAPSHOT);
+  ASSERT_EQ(m_out.size(), 3u); // The trade history is skipped
+  EXPECT_EQ(event(0).type, MarketEventType::BOOK_RESET);
+  expectDelta(1, EventSide::BID, 9122.04, 0.00121425, EVENT_FLAG_SNAPSHOT);
+
+  decoded = decode(Venue::GEMINI,
+                   R"({"type":"l2_updates","symbol":"BTCUSD",)"
+                   R"("changes":[["sell","9122.07","0"]]})");
+  EXPECT_EQ(decoded.kind, FrameKind::DATA);
+  ASSERT_EQ(m_out.size(), 1u);
+  expectDelta(0, EventSide::ASK, 9122.07, 0);
+
+  decode(Venue::GEMINI,
+         R"({"type":"trade","symbol":"BTCUSD","event_id":1,)"
+         R"("timestamp":1601617445123,"price":"9122.04",)"
+         R"("quantity":"0.0073173","side":"buy"})");
+  ASSERT_EQ(m_out.size(), 1u);
+  EXPECT_EQ(event(0).type, MarketEventType::TRADE);
+  EXPECT_EQ(event(0).side, EventSide::BID);
+  EXPECT_EQ(event(0).venueTimestamp, 1601617445123'000'000ULL);
+
+  EXPECT_EQ(decode(Venue::GEMINI, R"({"type":"heartbeat","timestamp":1})").kind,
+            FrameKind::HEARTBEAT);
+  EXPECT_EQ(
+      decode(Venue::GEMINI, R"({"result":"error","reason":"InvalidJson"})")
+          .kind,
+      FrameKind::ERROR);
+}
+
+TEST_F(VenueDecoderTest, EveryVenueRejectsMalformedFrames) {
+  for (Venue venue : {Venue::COINBASE, Venue::KRAKEN, Venue::GEMINI,
+                      Venue::BINANCE, Venue::BITSTAMP}) {
+    SCOPED_TRACE(venueName(venue));
+    EXPECT_EQ(decode(venue, R"({"channel":"book","data":[)").kind,
+              FrameKind::MALFORMED);
+    EXPECT_EQ(decode(venue, "not json").kind, FrameKind::MALFORMED);
+    EXPECT_EQ(decode(venue, R"({"a":1} trailing)").kind,
+              FrameKind::MALFORMED);
+    EXPECT_FALSE(createVenueDecoder(venue)->endpoint().empty());
+  }
+}
+
+TEST(VenueNamesTest, RoundTripsNames) {
+  EXPECT_EQ(venueFromName("Binance"), Venue::BINANCE);
+  EXPECT_EQ(venueFromName("bitstamp"), Venue::BITSTAMP);
+  EXPECT_FALSE(venueFromName("nasdaq").has_value());
+  EXPECT_STREQ(venueName(Venue::GEMINI), "gemini");
+}
+
+TEST(IsoTimestampTest, ParsesRfc3339) {
+  EXPECT_EQ(parseIsoTimestamp("1970-01-01T00:00:00Z"), 0u);
+  EXPECT_EQ(parseIsoTimestamp("2024-02-29T12:00:00.5Z"),
+            1709208000'500'000'000ULL);
+  EXPECT_EQ(parseIsoTimestamp("2024-02-29"), 0u);
+  EXPECT_EQ(parseIsoTimestamp(""), 0u);
+}
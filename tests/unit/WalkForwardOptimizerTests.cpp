@@ -0,0 +1,257 @@
+#include "../../strategies/backtesting/WalkForwardOptimizer.h"
+
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pinnacle::backtesting;
+
+namespace {
+
+constexpr uint64_t SECOND = 1'000'000'000ULL;
+constexpr uint64_t HOUR = 3600 * SECOND;
+constexpr uint64_t START = 1'700'000'000ULL * SECOND;
+
+double quality(double x) { return -(x - 3.0) * (x - 3.0); }
+
+} // namespace
+
+class WalkForwardOptimizerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    config_.studyName = "test";
+    config_.symbol = "TESTCOIN";
+    config_.baseConfig.outputDirectory = "test_walk_forward";
+    config_.baseConfig.startTimestamp = START;
+    config_.baseConfig.endTimestamp = START + 10 * HOUR;
+    config_.inSampleNanos = 4 * HOUR;
+    config_.outOfSampleNanos = 2 * HOUR;
+    config_.parameters["x"] = {0.0, 10.0, false, {}};
+    config_.parameters["trading_fee"] = {1e-4, 1e-2, true, {}};
+    config_.parameters["max_position"].choices = {500.0, 1000.0};
+    std::filesystem::remove_all(config_.baseConfig.outputDirectory);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(config_.baseConfig.outputDirectory);
+  }
+
+  // Scores a trial by how close x is to 3, reporting the same score at
+  // every tenth of the run so that rungs see the final ranking
+  void useSyntheticBacktest(WalkForwardOptimizer& optimizer) {
+    optimizer.setEvaluator(
+        [this](const BacktestConfiguration& config,
+               const ParameterSet& parameters,
+               const BacktestEngine::CheckpointCallback& checkpoint,
+               TradingStatistics& results) {
+          ++evaluations_;
+          if (config.tradingFee != parameters.at("trading_fee") ||
+              config.maxPosition != parameters.at("max_position")) {
+            ++misconfigured_;
+          }
+          double value = quality(parameters.at("x"));
+          if (!checkpoint) {
+            value -= 0.5; // Out of sample
+          }
+          PerformanceSnapshot snapshot{};
+          snapshot.statistics.sharpeRatio = value;
+          for (int step = 1; step < 10 && checkpoint; ++step) {
+            if (!checkpoint(step / 10.0, snapshot)) {
+              break;
+            }
+          }
+          results.sharpeRatio = value;
+          return true;
+        });
+  }
+
+  std::vector<std::string> journalLines() const {
+    std::ifstream in(config_.baseConfig.outputDirectory +
+                     "/studies/test/journal.jsonl");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  WalkForwardConfig config_;
+  std::atomic<size_t> evaluations_{0};
+  std::atomic<size_t> misconfigured_{0};
+};
+
+TEST_F(WalkForwardOptimizerTest, MakesRollingAndAnchoredWindows) {
+  auto windows = WalkForwardOptimizer::makeWindows(config_);
+  ASSERT_EQ(windows.size(), 3u);
+  EXPECT_EQ(windows[0].inSampleStart, START);
+  EXPECT_EQ(windows[0].inSampleEnd, START + 4 * HOUR - 1);
+  EXPECT_EQ(windows[0].outOfSampleStart, START + 4 * HOUR);
+  EXPECT_EQ(windows[0].outOfSampleEnd, START + 6 * HOUR - 1);
+  EXPECT_EQ(windows[2].inSampleStart, START + 4 * HOUR);
+  EXPECT_EQ(windows[2].outOfSampleEnd, START + 10 * HOUR - 1);
+
+  config_.anchored = true;
+  config_.stepNanos = HOUR;
+  windows = WalkForwardOptimizer::makeWindows(config_);
+  ASSERT_EQ(windows.size(), 5u);
+  EXPECT_EQ(windows[4].inSampleStart, START);
+  EXPECT_EQ(windows[4].outOfSampleStart, START + 8 * HOUR);
+
+  config_.inSampleNanos = 9 * HOUR;
+  EXPECT_TRUE(WalkForwardOptimizer::makeWindows(config_).empty());
+}
+
+TEST_F(WalkForwardOptimizerTest, HalvingStopsWeakTrialsAndKeepsTheBest) {
+  WalkForwardOptimizer optimizer(config_, 4);
+  useSyntheticBacktest(optimizer);
+
+  WalkForwardResult result;
+  ASSERT_TRUE(optimizer.run(result));
+  ASSERT_EQ(result.windows.size(), 3u);
+  ASSERT_EQ(result.trials.size(), 3u * 27u);
+  EXPECT_EQ(misconfigured_.load(), 0u);
+
+  size_t stopped = 0;
+  for (const auto& window : result.windows) {
+    ASSERT_TRUE(window.successful);
+    EXPECT_EQ(window.trialsCompleted + window.trialsStopped, 27u);
+    stopped += window.trialsStopped;
+
+    // The best trial leads at every rung, so it is never stopped
+    double best = -1e9;
+    for (const auto& trial : result.trials) {
+      if (trial.window == static_cast<size_t>(&window - &result.windows[0])) {
+        best = std::max(best, quality(trial.parameters.at("x")));
+      }
+    }
+    EXPECT_DOUBLE_EQ(window.inSampleScore, best);
+    EXPECT_DOUBLE_EQ(window.outOfSampleScore, best - 0.5);
+  }
+  EXPECT_GT(stopped, 27u);
+
+  for (const auto& trial : result.trials) {
+    EXPECT_GE(trial.parameters.at("x"), 0.0);
+    EXPECT_LE(trial.parameters.at("x"), 10.0);
+    EXPECT_GE(trial.parameters.at("trading_fee"), 1e-4);
+    EXPECT_LE(trial.parameters.at("trading_fee"), 1e-2);
+    double maxPosition = trial.parameters.at("max_position");
+    EXPECT_TRUE(maxPosition == 500.0 || maxPosition == 1000.0);
+  }
+  EXPECT_EQ(result.recommended, result.windows.back().parameters);
+  EXPECT_NEAR(result.meanOutOfSampleScore, result.meanInSampleScore - 0.5,
+              1e-9);
+}
+
+TEST_F(WalkForwardOptimizerTest, ResumesFromTheJournal) {
+  {
+    WalkForwardOptimizer optimizer(config_, 2);
+    useSyntheticBacktest(optimizer);
+    WalkForwardResult result;
+    ASSERT_TRUE(optimizer.run(result));
+  }
+  EXPECT_EQ(evaluations_.load(), 3u * 27u + 3u);
+
+  // Interrupted after 40 records, partway through writing the next
+  auto lines = journalLines();
+  ASSERT_EQ(lines.size(), 3u * 27u + 3u);
+  size_t keptTrials = 0;
+  size_t keptWindows = 0;
+  {
+    std::ofstream out(config_.baseConfig.outputDirectory +
+                      "/studies/test/journal.jsonl");
+    for (size_t i = 0; i < 40; ++i) {
+      out << lines[i] << '\n';
+      bool window = lines[i].find("\"type\":\"window\"") != std::string::npos;
+      keptWindows += window ? 1 : 0;
+      keptTrials += window ? 0 : 1;
+    }
+    out << lines[40].substr(0, lines[40].size() / 2);
+  }
+
+  evaluations_ = 0;
+  WalkForwardResult resumed;
+  {
+    WalkForwardOptimizer optimizer(config_, 2);
+    useSyntheticBacktest(optimizer);
+    ASSERT_TRUE(optimizer.run(resumed));
+  }
+  EXPECT_EQ(resumed.resumedTrials, keptTrials);
+  EXPECT_EQ(resumed.resumedWindows, keptWindows);
+  EXPECT_EQ(evaluations_.load(),
+            (3u * 27u - keptTrials) + (3u - keptWindows));
+  EXPECT_EQ(resumed.trials.size(), 3u * 27u);
+  for (const auto& window : resumed.windows) {
+    EXPECT_TRUE(window.successful);
+  }
+
+  // A finished study only reads its journal back
+  evaluations_ = 0;
+  WalkForwardResult finished;
+  {
+    WalkForwardOptimizer optimizer(config_, 2);
+    useSyntheticBacktest(optimizer);
+    ASSERT_TRUE(optimizer.run(finished));
+  }
+  EXPECT_EQ(evaluations_.load(), 0u);
+  EXPECT_EQ(finished.resumedWindows, 3u);
+  EXPECT_EQ(finished.recommended, resumed.recommended);
+  EXPECT_DOUBLE_EQ(finished.meanOutOfSampleScore,
+                   resumed.meanOutOfSampleScore);
+}
+
+TEST_F(WalkForwardOptimizerTest, RefusesToResumeUnderOtherSettings) {
+  config_.trialsPerWindow = 3;
+  {
+    WalkForwardOptimizer optimizer(config_, 2);
+    useSyntheticBacktest(optimizer);
+    WalkForwardResult result;
+    ASSERT_TRUE(optimizer.run(result));
+  }
+
+  config_.seed = 7;
+  WalkForwardOptimizer optimizer(config_, 2);
+  useSyntheticBacktest(optimizer);
+  WalkForwardResult result;
+  EXPECT_FALSE(optimizer.run(result));
+}
+
+TEST_F(WalkForwardOptimizerTest, RunsBacktestEnginesOnSharedData) {
+  // 3000 points a second apart
+  std::string dataDirectory = config_.baseConfig.outputDirectory + "/data";
+  std::filesystem::create_directories(dataDirectory);
+  {
+    std::ofstream file(dataDirectory + "/TESTCOIN.csv");
+    file << "timestamp,symbol,price,bid,ask,volume\n";
+    double price = 10000.0;
+    for (uint64_t i = 0; i < 3000; ++i) {
+      price += (i % 2 == 0 ? 1.0 : -0.5);
+      file << START + i * SECOND << ",TESTCOIN," << price << ","
+           << (price - 0.1) << "," << (price + 0.1) << ",100.0\n";
+    }
+  }
+
+  config_.baseConfig.endTimestamp = START + 3000 * SECOND;
+  config_.inSampleNanos = 1000 * SECOND;
+  config_.outOfSampleNanos = 500 * SECOND;
+  config_.parameters.erase("x");
+  config_.trialsPerWindow = 3;
+
+  WalkForwardOptimizer optimizer(config_, 2);
+  WalkForwardResult result;
+  ASSERT_TRUE(optimizer.run(result));
+  ASSERT_NE(optimizer.getMarketData(), nullptr);
+  EXPECT_EQ(optimizer.getMarketData()->size(), 3000u);
+
+  ASSERT_EQ(result.windows.size(), 4u);
+  for (const auto& window : result.windows) {
+    EXPECT_TRUE(window.successful);
+    EXPECT_EQ(window.trialsFailed, 0u);
+  }
+  EXPECT_TRUE(std::filesystem::exists(optimizer.getStudyDirectory() +
+                                      "/runs/w3_oos/backtest_results.json"));
+}
@@ -0,0 +1,91 @@
+#include "../../core/utils/WorkStealingPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace pinnacle::utils;
+
+TEST(WorkStealingPoolTest, RunsEveryTaskBeforeDestruction) {
+  std::atomic<int> ran{0};
+  {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    for (int i = 0; i < 1000; ++i) {
+      pool.submit([&ran]() { ran.fetch_add(1); });
+    }
+  }
+  EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(WorkStealingPoolTest, DefaultsToHardwareThreads) {
+  WorkStealingPool pool;
+  EXPECT_EQ(pool.size(), WorkStealingPool::defaultThreadCount());
+  EXPECT_GE(pool.size(), 1);
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersStealFromBusyOnes) {
+  // One task blocks its worker; work queued behind it is stolen by the
+  // other workers rather than waiting
+  std::atomic<bool> release{false};
+  std::atomic<int> ran{0};
+  std::thread::id blocked;
+  std::thread::id thief;
+  {
+    WorkStealingPool pool(2);
+    pool.submit([&]() {
+      blocked = std::this_thread::get_id();
+      pool.submit([&]() {
+        thief = std::this_thread::get_id();
+        ran.fetch_add(1);
+      });
+      while (!release.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ran.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(ran.load(), 1);
+    release.store(true);
+  }
+  EXPECT_NE(thief, blocked);
+}
+
+TEST(WorkStealingPoolTest, SurvivesThrowingTask) {
+  std::atomic<int> ran{0};
+  {
+    WorkStealingPool pool(1);
+    pool.submit([]() { throw std::runtime_error("task failure"); });
+    pool.submit([&ran]() { ran.fetch_add(1); });
+  }
+  EXPECT_EQ(ran.load(), 1);
+}
+
+TEST(WorkStealingPoolTest, PendingNeverCountsBelowZero) {
+  // Tasks taken the moment they are queued must not be counted down before
+  // they were counted up
+  constexpr size_t TASKS = 20000;
+  std::atomic<size_t> ran{0};
+  std::atomic<size_t> maxPending{0};
+  {
+    WorkStealingPool pool(4);
+    for (size_t i = 0; i < TASKS; ++i) {
+      pool.submit([&]() {
+        size_t pending = pool.pending();
+        size_t seen = maxPending.load();
+        while (pending > seen && !maxPending.compare_exchange_weak(seen,
+                                                                   pending)) {
+        }
+        ran.fetch_add(1);
+      });
+    }
+  }
+  EXPECT_EQ(ran.load(), TASKS);
+  EXPECT_LE(maxPending.load(), TASKS);
+}
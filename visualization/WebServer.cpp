@@ -1091,7 +1091,8 @@ http::response<http::string_body> RestAPIServer::handleGetRiskLimits() {
                      {"max_order_size", limits.maxOrderSize},
                      {"max_order_value", limits.maxOrderValue},
                      {"max_daily_volume", limits.maxDailyVolume},
-                     {"max_orders_per_second", limits.maxOrdersPerSecond}};
+                     {"max_orders_per_second", limits.maxOrdersPerSecond},
+                     {"max_open_orders", limits.maxOpenOrders}};
 
   auto response = createSuccessResponse(limitsJson);
   http::response<http::string_body> res{http::status::ok, 11};